@@ -5,6 +5,11 @@
     'company_name%': 'GitHub, Inc',
     'company_abbr%': 'github',
     'version%': '0.34.2',
+    # Put V8 code caches of the built-in modules into atom.asar, this runs the
+    # built binary so it does not work when cross compiling.
+    'generate_code_cache%': 0,
+    # Build the native benchmarks, see docs/development/asar-benchmarks.md.
+    'build_benchmarks%': 0,
   },
   'includes': [
     'filenames.gypi',
@@ -282,6 +287,7 @@
               '-lcomctl32.lib',
               '-lcomdlg32.lib',
               '-lwininet.lib',
+              '-lpsapi.lib',
             ],
           },
           'dependencies': [
@@ -328,6 +334,10 @@
               # Make native module dynamic loading work.
               '-rdynamic',
             ],
+            'libraries': [
+              # Used to query the idle time of the user.
+              '-lXss',
+            ],
           },
           # Required settings of using breakpad.
           'cflags_cc': [
@@ -563,5 +573,69 @@
         },
       ],
     }],  # OS!="mac"
+    ['generate_code_cache==1', {
+      'targets': [
+        {
+          'target_name': 'generate_code_cache',
+          'type': 'none',
+          'dependencies': [
+            '<(project_name)',
+          ],
+          'actions': [
+            {
+              'action_name': 'generate_code_cache',
+              'variables': {
+                'conditions': [
+                  ['OS=="mac"', {
+                    'resources_path': '<(PRODUCT_DIR)/<(product_name).app/Contents/Resources',
+                    'electron_binary': '<(PRODUCT_DIR)/<(product_name).app/Contents/MacOS/<(product_name)',
+                  }],
+                  ['OS=="win"', {
+                    'resources_path': '<(PRODUCT_DIR)/resources',
+                    'electron_binary': '<(PRODUCT_DIR)/<(project_name).exe',
+                  }],
+                  ['OS=="linux"', {
+                    'resources_path': '<(PRODUCT_DIR)/resources',
+                    'electron_binary': '<(PRODUCT_DIR)/<(project_name)',
+                  }],
+                ],
+              },
+              'inputs': [
+                'tools/generate-code-cache.js',
+                '<@(coffee_sources)',
+              ],
+              'outputs': [
+                '<(INTERMEDIATE_DIR)/code_cache.stamp',
+              ],
+              'action': [
+                'python',
+                'tools/generate-code-cache.py',
+                '<(electron_binary)',
+                '<(resources_path)/atom.asar',
+                '<@(_outputs)',
+                '<@(coffee_sources)',
+              ],
+            }
+          ],
+        },  # target generate_code_cache
+      ],
+    }],  # generate_code_cache==1
+    ['build_benchmarks==1', {
+      'targets': [
+        {
+          'target_name': 'asar_benchmark',
+          'type': 'executable',
+          'dependencies': [
+            '<(project_name)_lib',
+          ],
+          'sources': [
+            '<@(asar_benchmark_sources)',
+          ],
+          'include_dirs': [
+            '.',
+          ],
+        },  # target asar_benchmark
+      ],
+    }],  # build_benchmarks==1
   ],
 }
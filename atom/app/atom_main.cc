@@ -26,6 +26,7 @@
 #include "ui/gfx/win/dpi.h"
 #elif defined(OS_LINUX)  // defined(OS_WIN)
 #include "atom/app/atom_main_delegate.h"  // NOLINT
+#include "atom/app/singleton_handoff_linux.h"
 #include "content/public/app/content_main.h"
 #else  // defined(OS_LINUX)
 #include "atom/app/atom_library_main.h"
@@ -171,6 +172,15 @@ int main(int argc, const char* argv[]) {
     return atom::NodeMain(argc, const_cast<char**>(argv));
   }
 
+  // A second instance of a single instance app exits before initializing
+  // anything, child processes always have the "--type" switch.
+  bool is_child_process = false;
+  for (int i = 1; i < argc; ++i)
+    if (strncmp(argv[i], "--type=", 7) == 0)
+      is_child_process = true;
+  if (!is_child_process && atom::HandOffToPrimaryInstance(argc, argv))
+    return 0;
+
   atom::AtomMainDelegate delegate;
   content::ContentMainParams params(&delegate);
   params.argc = argc;
@@ -10,6 +10,8 @@
 #include "atom/app/atom_content_client.h"
 #include "atom/browser/atom_browser_client.h"
 #include "atom/common/google_api_key.h"
+#include "atom/common/resource_file_usage.h"
+#include "atom/common/startup_timeline.h"
 #include "atom/renderer/atom_renderer_client.h"
 #include "atom/utility/atom_content_utility_client.h"
 #include "base/command_line.h"
@@ -37,6 +39,7 @@ AtomMainDelegate::~AtomMainDelegate() {
 }
 
 bool AtomMainDelegate::BasicStartupComplete(int* exit_code) {
+  StartupTimeline::GetInstance()->Mark("basicStartupComplete");
   auto command_line = base::CommandLine::ForCurrentProcess();
 
   logging::LoggingSettings settings;
@@ -83,6 +86,7 @@ bool AtomMainDelegate::BasicStartupComplete(int* exit_code) {
 }
 
 void AtomMainDelegate::PreSandboxStartup() {
+  StartupTimeline::GetInstance()->Mark("preSandboxStartup");
   brightray::MainDelegate::PreSandboxStartup();
 
   // Set google API key.
@@ -137,12 +141,21 @@ content::ContentUtilityClient* AtomMainDelegate::CreateContentUtilityClient() {
   return utility_client_.get();
 }
 
+#if defined(OS_LINUX)
+void AtomMainDelegate::ZygoteStarting(
+    ScopedVector<content::ZygoteForkDelegate>* delegates) {
+  brightray::MainDelegate::ZygoteStarting(delegates);
+  AtomRendererClient::ZygoteStarting();
+}
+#endif
+
 scoped_ptr<brightray::ContentClient> AtomMainDelegate::CreateContentClient() {
   return scoped_ptr<brightray::ContentClient>(new AtomContentClient).Pass();
 }
 
 void AtomMainDelegate::AddDataPackFromPath(
     ui::ResourceBundle* bundle, const base::FilePath& pak_dir) {
+  SetResourcePackDir(pak_dir);
 #if defined(OS_WIN)
   bundle->AddDataPackFromPath(
       pak_dir.Append(FILE_PATH_LITERAL("ui_resources_200_percent.pak")),
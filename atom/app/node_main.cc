@@ -7,6 +7,7 @@
 #include "atom/app/uv_task_runner.h"
 #include "atom/browser/javascript_environment.h"
 #include "atom/browser/node_debugger.h"
+#include "atom/common/asar/asar_util.h"
 #include "base/command_line.h"
 #include "atom/common/node_includes.h"
 #include "base/thread_task_runner_handle.h"
@@ -16,6 +17,19 @@
 
 namespace atom {
 
+namespace {
+
+// Helpers usually exit as soon as their script is done, without freeing the
+// archives that save their readahead manifests when destroyed. This runs on
+// normal exits and on process.exit(), which does not return to NodeMain.
+void FlushAsarCaches(void* arg) {
+  asar::FinishReadaheadRecordings();
+}
+
+}  // namespace
+
+// Nothing of content is initialized here, only what node itself needs: V8
+// through gin, and the UvTaskRunner that gin posts its tasks to.
 int NodeMain(int argc, char *argv[]) {
   base::CommandLine::Init(argc, argv);
 
@@ -29,7 +43,7 @@ int NodeMain(int argc, char *argv[]) {
 
     gin::V8Initializer::LoadV8Snapshot();
     gin::V8Initializer::LoadV8Natives();
-    JavascriptEnvironment gin_env;
+    JavascriptEnvironment gin_env(false);
 
     int exec_argc;
     const char** exec_argv;
@@ -44,6 +58,7 @@ int NodeMain(int argc, char *argv[]) {
     if (node_debugger.IsRunning())
       env->AssignToContext(v8::Debug::GetDebugContext());
 
+    node::AtExit(&FlushAsarCaches);
     node::LoadEnvironment(env);
 
     bool more;
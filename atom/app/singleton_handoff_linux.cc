@@ -0,0 +1,171 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/app/singleton_handoff_linux.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "atom/common/asar/archive.h"
+#include "base/environment.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_file.h"
+#include "base/hash.h"
+#include "base/json/json_reader.h"
+#include "base/macros.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/nix/xdg_util.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/stringprintf.h"
+#include "base/values.h"
+
+namespace atom {
+
+namespace {
+
+// Same with the protocol of process_singleton_posix.cc.
+const char kStartToken[] = "START";
+const char kACKToken[] = "ACK";
+const char kTokenDelimiter = '\0';
+
+// A primary instance that is not hung answers right away, the ones that are
+// hung are dealt with by app.makeSingleInstance.
+const int kTimeoutInSeconds = 2;
+
+// Larger package.json files are not read before initializing.
+const uint32 kMaxPackageJsonSize = 1024 * 1024;
+
+// Reads the package.json of the app packaged with |exe|, in the same order
+// as the browser's init.coffee. Returns false when the app is not fixed,
+// since then instances of the same executable can run different apps.
+bool ReadPackageJson(const base::FilePath& exe, std::string* content) {
+  base::FilePath resources = exe.DirName().Append("resources");
+  base::FilePath app = resources.Append("app");
+  if (base::DirectoryExists(app))
+    return base::ReadFileToString(app.Append("package.json"), content);
+
+  asar::Archive archive(resources.Append("app.asar"));
+  asar::Archive::FileInfo info;
+  if (!archive.Init() ||
+      !archive.GetFileInfo(base::FilePath("package.json"), &info) ||
+      info.unpacked || info.size > kMaxPackageJsonSize)
+    return false;
+  content->resize(info.size);
+  return archive.ReadFile(info, 0, info.size, &(*content)[0]) ==
+         static_cast<int>(info.size);
+}
+
+// Returns the user data directory the app packaged with |exe| gets when it
+// does not change it, which is named after the app in the config directory.
+base::FilePath GetDefaultUserDataDir(const base::FilePath& exe) {
+  std::string content;
+  if (!ReadPackageJson(exe, &content))
+    return base::FilePath();
+
+  scoped_ptr<base::Value> value(base::JSONReader::Read(content));
+  base::DictionaryValue* package = nullptr;
+  std::string name;
+  if (!value || !value->GetAsDictionary(&package) ||
+      !(package->GetString("productName", &name) ||
+        package->GetString("name", &name)) ||
+      name.empty())
+    return base::FilePath();
+
+  scoped_ptr<base::Environment> env(base::Environment::Create());
+  return base::nix::GetXDGDirectory(env.get(), base::nix::kXdgConfigHomeEnvVar,
+                                    base::nix::kDotConfigDir).Append(name);
+}
+
+// Whether |path| belongs to current user and only it can access it.
+bool IsPrivateToUser(const base::FilePath& path, bool is_link) {
+  struct stat info;
+  int result = is_link ? lstat(path.value().c_str(), &info) :
+                         stat(path.value().c_str(), &info);
+  return result == 0 && info.st_uid == getuid() &&
+         (is_link ? S_ISLNK(info.st_mode) : (info.st_mode & 077) == 0);
+}
+
+}  // namespace
+
+base::FilePath GetSingletonHandoffPath(const base::FilePath& user_data_dir) {
+  // The runtime directory is private to the user, /tmp is not so the uid is
+  // part of the name.
+  const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+  base::FilePath dir(runtime_dir && *runtime_dir ? runtime_dir : "/tmp");
+  return dir.Append(base::StringPrintf(
+      ".electron-singleton-%u-%08x", getuid(),
+      base::Hash(user_data_dir.StripTrailingSeparators().value())));
+}
+
+bool HandOffToPrimaryInstance(int argc, const char* argv[]) {
+  base::FilePath exe;
+  if (!base::ReadSymbolicLink(base::FilePath("/proc/self/exe"), &exe))
+    return false;
+  base::FilePath user_data_dir = GetDefaultUserDataDir(exe);
+  if (user_data_dir.empty())
+    return false;
+
+  base::FilePath link = GetSingletonHandoffPath(user_data_dir);
+  if (!IsPrivateToUser(link, true))
+    return false;
+
+  // The socket lives in the private directory created by the primary
+  // instance, which also keeps others from pointing the link elsewhere.
+  base::FilePath socket_path;
+  if (!base::ReadSymbolicLink(link, &socket_path) ||
+      !IsPrivateToUser(socket_path.DirName(), false))
+    return false;
+
+  struct sockaddr_un addr;
+  if (socket_path.value().size() >= sizeof(addr.sun_path))
+    return false;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket_path.value().c_str(),
+          sizeof(addr.sun_path) - 1);
+
+  base::ScopedFD fd(socket(AF_UNIX, SOCK_STREAM, 0));
+  if (!fd.is_valid())
+    return false;
+  struct timeval timeout = { kTimeoutInSeconds, 0 };
+  setsockopt(fd.get(), SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd.get(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  // A stale link of a primary instance that has crashed.
+  if (HANDLE_EINTR(connect(fd.get(), reinterpret_cast<sockaddr*>(&addr),
+                           sizeof(addr))) < 0)
+    return false;
+
+  // The format is "START\0<current dir>\0<argv[0]>\0...\0<argv[n]>".
+  char current_dir[PATH_MAX];
+  if (!getcwd(current_dir, sizeof(current_dir)))
+    return false;
+  std::string message(kStartToken);
+  message.push_back(kTokenDelimiter);
+  message.append(current_dir);
+  for (int i = 0; i < argc; ++i) {
+    message.push_back(kTokenDelimiter);
+    message.append(argv[i]);
+  }
+  if (!base::WriteFileDescriptor(fd.get(), message.data(),
+                                 static_cast<int>(message.size())))
+    return false;
+  shutdown(fd.get(), SHUT_WR);
+
+  // The primary instance answers "SHUTDOWN" when it is quitting, and then
+  // this one starts normally.
+  char reply[arraysize(kACKToken)] = { 0 };
+  ssize_t length = HANDLE_EINTR(read(fd.get(), reply, sizeof(reply) - 1));
+  return length == static_cast<ssize_t>(arraysize(kACKToken) - 1) &&
+         strncmp(reply, kACKToken, length) == 0;
+}
+
+}  // namespace atom
@@ -0,0 +1,31 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_APP_SINGLETON_HANDOFF_LINUX_H_
+#define ATOM_APP_SINGLETON_HANDOFF_LINUX_H_
+
+#include "base/files/file_path.h"
+
+namespace atom {
+
+// The primary instance of an app that has called app.makeSingleInstance
+// links its singleton socket to a path derived from its user data directory,
+// so a second instance can hand its command line over from main(), before
+// Chromium and Node are initialized.
+//
+// A second instance can only guess the default user data directory of a
+// packaged app from its package.json. The instances of apps that move it with
+// app.setPath find no link and hand off later from app.makeSingleInstance.
+
+// Returns the path of the link for |user_data_dir|.
+base::FilePath GetSingletonHandoffPath(const base::FilePath& user_data_dir);
+
+// Sends the command line to the primary instance, returns true when it has
+// been taken and the current process can exit. Only uses POSIX calls, since
+// nothing has been initialized yet.
+bool HandOffToPrimaryInstance(int argc, const char* argv[]);
+
+}  // namespace atom
+
+#endif  // ATOM_APP_SINGLETON_HANDOFF_LINUX_H_
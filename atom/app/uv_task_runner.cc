@@ -4,28 +4,78 @@
 
 #include "atom/app/uv_task_runner.h"
 
-#include "base/stl_util.h"
+#include <algorithm>
 
 namespace atom {
 
-UvTaskRunner::UvTaskRunner(uv_loop_t* loop) : loop_(loop) {
+UvTaskRunner::PendingTask::PendingTask(const base::Closure& task,
+                                       base::TimeTicks run_time,
+                                       uint64 sequence_num)
+    : task(task), run_time(run_time), sequence_num(sequence_num) {
+}
+
+UvTaskRunner::PendingTask::~PendingTask() {
+}
+
+bool UvTaskRunner::PendingTask::operator<(const PendingTask& other) const {
+  // std::priority_queue puts the largest element at the top, so the order is
+  // reversed.
+  if (run_time != other.run_time)
+    return run_time > other.run_time;
+  return sequence_num > other.sequence_num;
+}
+
+UvTaskRunner::UvTaskRunner(uv_loop_t* loop)
+    : loop_(loop),
+      async_(new uv_async_t),
+      timer_(new uv_timer_t),
+      loop_thread_id_(base::PlatformThread::CurrentId()),
+      async_referenced_(false),
+      next_sequence_num_(0) {
+  uv_async_init(loop_, async_, UvTaskRunner::OnAsync);
+  async_->data = this;
+  // Waiting for tasks from other threads should not keep the loop alive, the
+  // handle is only referenced while tasks posted on the loop's thread are
+  // pending, and the timer only while it is armed.
+  uv_unref(reinterpret_cast<uv_handle_t*>(async_));
+
+  uv_timer_init(loop_, timer_);
+  timer_->data = this;
 }
 
 UvTaskRunner::~UvTaskRunner() {
-  for (auto& iter : tasks_) {
-    uv_unref(reinterpret_cast<uv_handle_t*>(iter.first));
-    delete iter.first;
-  }
+  // The loop has usually finished when the last reference goes away, in which
+  // case the handles are freed together with the process.
+  uv_close(reinterpret_cast<uv_handle_t*>(async_), UvTaskRunner::OnClose);
+  uv_close(reinterpret_cast<uv_handle_t*>(timer_), UvTaskRunner::OnClose);
 }
 
 bool UvTaskRunner::PostDelayedTask(const tracked_objects::Location& from_here,
                                    const base::Closure& task,
                                    base::TimeDelta delay) {
-  uv_timer_t* timer = new uv_timer_t;
-  timer->data = this;
-  uv_timer_init(loop_, timer);
-  uv_timer_start(timer, UvTaskRunner::OnTimeout, delay.InMilliseconds(), 0);
-  tasks_[timer] = task;
+  base::TimeTicks run_time;
+  if (delay > base::TimeDelta())
+    run_time = base::TimeTicks::Now() + delay;
+
+  bool wake_up;
+  {
+    base::AutoLock auto_lock(incoming_lock_);
+    incoming_tasks_.push_back(
+        PendingTask(task, run_time, next_sequence_num_++));
+    // Only the first task needs to wake up the loop, the others are picked up
+    // together with it.
+    wake_up = incoming_tasks_.size() == 1;
+  }
+
+  // Keep the loop alive until the task has run. Handles can only be referenced
+  // on the loop's thread.
+  if (base::PlatformThread::CurrentId() == loop_thread_id_ &&
+      !async_referenced_) {
+    async_referenced_ = true;
+    uv_ref(reinterpret_cast<uv_handle_t*>(async_));
+  }
+  if (wake_up)
+    uv_async_send(async_);
   return true;
 }
 
@@ -37,24 +87,79 @@ bool UvTaskRunner::PostNonNestableDelayedTask(
     const tracked_objects::Location& from_here,
     const base::Closure& task,
     base::TimeDelta delay) {
-  return PostDelayedTask(from_here, task, delay);;
+  return PostDelayedTask(from_here, task, delay);
+}
+
+void UvTaskRunner::ReloadIncomingTasks() {
+  std::vector<PendingTask> tasks;
+  {
+    base::AutoLock auto_lock(incoming_lock_);
+    tasks.swap(incoming_tasks_);
+  }
+
+  for (const PendingTask& pending_task : tasks) {
+    if (pending_task.run_time.is_null())
+      pending_task.task.Run();
+    else
+      delayed_tasks_.push(pending_task);
+  }
+}
+
+void UvTaskRunner::RunDueTasks() {
+  base::TimeTicks now = base::TimeTicks::Now();
+  while (!delayed_tasks_.empty() && delayed_tasks_.top().run_time <= now) {
+    base::Closure task = delayed_tasks_.top().task;
+    delayed_tasks_.pop();
+    task.Run();
+  }
+}
+
+void UvTaskRunner::ScheduleTimer() {
+  if (delayed_tasks_.empty()) {
+    uv_timer_stop(timer_);
+    return;
+  }
+
+  // Round up so the timer never fires before the task is due.
+  base::TimeDelta delay = delayed_tasks_.top().run_time -
+                          base::TimeTicks::Now();
+  int64 timeout = std::max<int64>(
+      (delay.InMicroseconds() + base::Time::kMicrosecondsPerMillisecond - 1) /
+          base::Time::kMicrosecondsPerMillisecond,
+      0);
+  uv_timer_start(timer_, UvTaskRunner::OnTimeout, timeout, 0);
+}
+
+// static
+void UvTaskRunner::OnAsync(uv_async_t* handle) {
+  UvTaskRunner* self = static_cast<UvTaskRunner*>(handle->data);
+  self->ReloadIncomingTasks();
+  self->ScheduleTimer();
+
+  // The tasks posted while running the others are picked up by the next
+  // callback, so the handle stays referenced for them.
+  if (self->async_referenced_) {
+    base::AutoLock auto_lock(self->incoming_lock_);
+    if (self->incoming_tasks_.empty()) {
+      self->async_referenced_ = false;
+      uv_unref(reinterpret_cast<uv_handle_t*>(handle));
+    }
+  }
 }
 
 // static
 void UvTaskRunner::OnTimeout(uv_timer_t* timer) {
   UvTaskRunner* self = static_cast<UvTaskRunner*>(timer->data);
-  if (!ContainsKey(self->tasks_, timer))
-    return;
-
-  self->tasks_[timer].Run();
-  self->tasks_.erase(timer);
-  uv_timer_stop(timer);
-  uv_close(reinterpret_cast<uv_handle_t*>(timer), UvTaskRunner::OnClose);
+  self->RunDueTasks();
+  self->ScheduleTimer();
 }
 
 // static
 void UvTaskRunner::OnClose(uv_handle_t* handle) {
-  delete reinterpret_cast<uv_timer_t*>(handle);
+  if (handle->type == UV_ASYNC)
+    delete reinterpret_cast<uv_async_t*>(handle);
+  else
+    delete reinterpret_cast<uv_timer_t*>(handle);
 }
 
 }  // namespace atom
@@ -5,15 +5,25 @@
 #ifndef ATOM_APP_UV_TASK_RUNNER_H_
 #define ATOM_APP_UV_TASK_RUNNER_H_
 
-#include <map>
+#include <queue>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/single_thread_task_runner.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
 #include "vendor/node/deps/uv/include/uv.h"
 
 namespace atom {
 
 // TaskRunner implementation that posts tasks into libuv's default loop.
+//
+// Posted tasks are queued under a lock and picked up by an uv_async_t, so
+// tasks can be posted from any thread. Immediate tasks posted on the loop's
+// thread keep the loop alive until they have run. Delayed tasks are then kept
+// in a heap ordered by their run time, with a single uv_timer_t armed for the
+// earliest one.
 class UvTaskRunner : public base::SingleThreadTaskRunner {
  public:
   explicit UvTaskRunner(uv_loop_t* loop);
@@ -30,12 +40,54 @@ class UvTaskRunner : public base::SingleThreadTaskRunner {
       base::TimeDelta delay) override;
 
  private:
+  struct PendingTask {
+    PendingTask(const base::Closure& task,
+                base::TimeTicks run_time,
+                uint64 sequence_num);
+    ~PendingTask();
+
+    // Orders the heap so the earliest task is at the top, tasks with the same
+    // run time keep the order they were posted.
+    bool operator<(const PendingTask& other) const;
+
+    base::Closure task;
+    base::TimeTicks run_time;  // Null for immediate tasks.
+    uint64 sequence_num;
+  };
+
+  static void OnAsync(uv_async_t* handle);
   static void OnTimeout(uv_timer_t* timer);
   static void OnClose(uv_handle_t* handle);
 
+  // Moves the tasks posted since last time into the loop's thread, runs the
+  // immediate ones and queues the delayed ones.
+  void ReloadIncomingTasks();
+
+  // Runs the delayed tasks that are due.
+  void RunDueTasks();
+
+  // Arms |timer_| for the earliest delayed task.
+  void ScheduleTimer();
+
   uv_loop_t* loop_;
 
-  std::map<uv_timer_t*, base::Closure> tasks_;
+  // The handles are allocated separately since they are only freed after the
+  // loop has closed them.
+  uv_async_t* async_;
+  uv_timer_t* timer_;
+
+  // Whether |async_| is referenced for tasks posted on the loop's thread, only
+  // accessed on that thread.
+  base::PlatformThreadId loop_thread_id_;
+  bool async_referenced_;
+
+  // Guards |incoming_tasks_| and |next_sequence_num_|.
+  base::Lock incoming_lock_;
+  std::vector<PendingTask> incoming_tasks_;
+  uint64 next_sequence_num_;
+
+  // Only accessed on the loop's thread.
+  std::priority_queue<PendingTask> delayed_tasks_;
 
   DISALLOW_COPY_AND_ASSIGN(UvTaskRunner);
 };
@@ -4,6 +4,7 @@
 
 #include "atom/browser/api/atom_api_app.h"
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -18,19 +19,36 @@
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/browser.h"
 #include "atom/browser/login_handler.h"
+#include "atom/browser/spare_render_process_pool.h"
+#include "atom/browser/v8_heap_settings.h"
+#include "atom/browser/web_contents_preferences.h"
+#include "atom/common/event_loop_stats.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/content_converter.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
 #include "atom/common/options_switches.h"
+#include "atom/common/resource_file_usage.h"
+#include "atom/common/startup_timeline.h"
 #include "base/command_line.h"
 #include "base/environment.h"
 #include "base/files/file_path.h"
 #include "base/path_service.h"
+#include "base/process/process_metrics.h"
+#include "base/values.h"
 #include "brightray/browser/brightray_paths.h"
+#include "content/public/browser/browser_child_process_host_iterator.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/child_process_data.h"
 #include "content/public/browser/client_certificate_delegate.h"
 #include "content/public/browser/gpu_data_manager.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/browser/render_widget_host_iterator.h"
+#include "content/public/browser/web_contents.h"
 #include "content/public/common/content_switches.h"
+#include "content/public/common/process_type.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "net/ssl/ssl_cert_request_info.h"
@@ -40,6 +58,12 @@
 #include "base/strings/utf_string_conversions.h"
 #endif
 
+#if defined(OS_MACOSX)
+#include "content/public/browser/browser_child_process_host.h"
+#endif
+
+using content::BrowserThread;
+
 using atom::Browser;
 
 namespace mate {
@@ -159,14 +183,80 @@ void PassLoginInformation(scoped_refptr<LoginHandler> login_handler,
     login_handler->CancelAuth();
 }
 
+// Called on the IO thread, where the child processes other than renderers
+// are tracked.
+std::vector<content::ChildProcessData> GetChildProcessesOnIO() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  std::vector<content::ChildProcessData> child_processes;
+  for (content::BrowserChildProcessHostIterator iter; !iter.Done(); ++iter)
+    child_processes.push_back(iter.GetData());
+  return child_processes;
+}
+
+std::string GetProcessTypeName(int process_type) {
+  switch (process_type) {
+    case content::PROCESS_TYPE_GPU:
+      return "gpu";
+    case content::PROCESS_TYPE_UTILITY:
+      return "utility";
+    case content::PROCESS_TYPE_PLUGIN:
+    case content::PROCESS_TYPE_PPAPI_PLUGIN:
+      return "plugin";
+    case content::PROCESS_TYPE_PPAPI_BROKER:
+      return "broker";
+    default:
+      return "unknown";
+  }
+}
+
+// Returns the pages whose main frames live in |process|.
+std::vector<mate::Handle<api::WebContents>> GetWebContentsInProcess(
+    v8::Isolate* isolate, content::RenderProcessHost* process) {
+  std::vector<mate::Handle<api::WebContents>> result;
+  std::set<content::WebContents*> found;
+  scoped_ptr<content::RenderWidgetHostIterator> widgets(
+      content::RenderWidgetHost::GetRenderWidgetHosts());
+  while (content::RenderWidgetHost* widget = widgets->GetNextHost()) {
+    if (!widget->IsRenderView() || widget->GetProcess() != process)
+      continue;
+    content::WebContents* web_contents =
+        content::WebContents::FromRenderViewHost(
+            content::RenderViewHost::From(widget));
+    if (web_contents && found.insert(web_contents).second)
+      result.push_back(api::WebContents::CreateFrom(isolate, web_contents));
+  }
+  return result;
+}
+
+// Returns the V8 flags |process| was started with, which come from the
+// preferences of its pages.
+std::string GetV8FlagsOfProcess(content::RenderProcessHost* process) {
+  scoped_ptr<content::RenderWidgetHostIterator> widgets(
+      content::RenderWidgetHost::GetRenderWidgetHosts());
+  while (content::RenderWidgetHost* widget = widgets->GetNextHost()) {
+    if (!widget->IsRenderView() || widget->GetProcess() != process)
+      continue;
+    content::WebContents* web_contents =
+        content::WebContents::FromRenderViewHost(
+            content::RenderViewHost::From(widget));
+    WebContentsPreferences* preferences =
+        web_contents ? WebContentsPreferences::FromWebContents(web_contents) :
+                       nullptr;
+    if (preferences)
+      return GetRendererV8Flags(*preferences->web_preferences());
+  }
+  return GetRendererV8Flags(base::DictionaryValue());
+}
+
 }  // namespace
 
-App::App() {
+App::App() : weak_factory_(this) {
   Browser::Get()->AddObserver(this);
   content::GpuDataManager::GetInstance()->AddObserver(this);
 }
 
 App::~App() {
+  StopHangMonitor();
   Browser::Get()->RemoveObserver(this);
   content::GpuDataManager::GetInstance()->RemoveObserver(this);
 }
@@ -312,6 +402,11 @@ void App::AllowNTLMCredentialsForAllDomains(bool should_allow) {
   browser_context->AllowNTLMCredentialsForAllDomains(should_allow);
 }
 
+void App::SetSpareRendererProcessCount(int count) {
+  SpareRenderProcessPool::GetInstance()->SetCount(
+      AtomBrowserMainParts::Get()->browser_context(), count);
+}
+
 std::string App::GetLocale() {
   return l10n_util::GetApplicationLocale("");
 }
@@ -345,6 +440,192 @@ bool App::MakeSingleInstance(
   }
 }
 
+void App::OnMainThreadHang(base::TimeDelta duration,
+                           const std::string& js_stack,
+                           bool minidump_written) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  mate::Dictionary details = mate::Dictionary::CreateEmpty(isolate());
+  details.Set("duration", duration.InMillisecondsF());
+  details.Set("jsStack", js_stack);
+  details.Set("minidumpWritten", minidump_written);
+  Emit("main-thread-hang", details);
+}
+
+void App::StartHangMonitor(mate::Arguments* args) {
+  int interval = 1000;
+  int threshold = 5000;
+  bool minidump = false;
+  mate::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("interval", &interval);
+    options.Get("threshold", &threshold);
+    options.Get("minidump", &minidump);
+  }
+  if (interval <= 0 || threshold <= 0) {
+    args->ThrowError("interval and threshold must be positive");
+    return;
+  }
+
+  StopHangMonitor();
+  hang_monitor_ = new HangMonitor(
+      isolate(), base::TimeDelta::FromMilliseconds(interval),
+      base::TimeDelta::FromMilliseconds(threshold), minidump, this);
+  if (!hang_monitor_->Start()) {
+    StopHangMonitor();
+    args->ThrowError("Unable to start the hang monitor");
+  }
+}
+
+void App::StopHangMonitor() {
+  if (hang_monitor_.get()) {
+    hang_monitor_->Stop();
+    hang_monitor_ = nullptr;
+  }
+}
+
+v8::Local<v8::Value> App::GetStartupTimeline(v8::Isolate* isolate) {
+  return mate::ConvertToV8(isolate,
+                           *StartupTimeline::GetInstance()->ToValue());
+}
+
+void App::GetResourceFileUsage(mate::Arguments* args) {
+  base::FilePath resources_path;
+  base::Callback<void(v8::Local<v8::Value>)> callback;
+  if (!args->GetNext(&resources_path) || !args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+  BrowserThread::PostTaskAndReplyWithResult(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&atom::GetResourceFileUsage, resources_path),
+      base::Bind(&App::OnResourceFileUsageCollected,
+                 weak_factory_.GetWeakPtr(), args->isolate(), callback));
+}
+
+void App::OnResourceFileUsageCollected(
+    v8::Isolate* isolate,
+    const base::Callback<void(v8::Local<v8::Value>)>& callback,
+    scoped_ptr<base::ListValue> usage) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(mate::ConvertToV8(isolate, *usage));
+}
+
+void App::GetAppMetrics(mate::Arguments* args) {
+  base::Callback<void(v8::Local<v8::Value>)> callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+  BrowserThread::PostTaskAndReplyWithResult(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&GetChildProcessesOnIO),
+      base::Bind(&App::OnChildProcessesCollected, weak_factory_.GetWeakPtr(),
+                 args->isolate(), callback));
+}
+
+void App::OnChildProcessesCollected(
+    v8::Isolate* isolate,
+    const base::Callback<void(v8::Local<v8::Value>)>& callback,
+    const std::vector<content::ChildProcessData>& child_processes) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+
+  // Processes that are gone since the last call are dropped with the old map.
+  std::map<base::ProcessId, linked_ptr<base::ProcessMetrics>> metrics;
+  std::vector<mate::Dictionary> rows;
+
+  mate::Dictionary browser = GetProcessMetrics(
+      isolate, base::GetCurrentProcessHandle(), "browser", 0, &metrics);
+  browser.Set("eventLoop", *EventLoopStats::GetInstance()->ToValue());
+  browser.Set("v8Flags", GetBrowserV8Flags());
+  v8::HeapStatistics heap_statistics;
+  isolate->GetHeapStatistics(&heap_statistics);
+  mate::Dictionary heap = mate::Dictionary::CreateEmpty(isolate);
+  heap.Set("totalHeapSize",
+           static_cast<double>(heap_statistics.total_heap_size() >> 10));
+  heap.Set("usedHeapSize",
+           static_cast<double>(heap_statistics.used_heap_size() >> 10));
+  heap.Set("heapSizeLimit",
+           static_cast<double>(heap_statistics.heap_size_limit() >> 10));
+  browser.Set("heap", heap);
+  rows.push_back(browser);
+
+  for (auto it = content::RenderProcessHost::AllHostsIterator();
+       !it.IsAtEnd(); it.Advance()) {
+    content::RenderProcessHost* host = it.GetCurrentValue();
+    if (!host->HasConnection() ||
+        host->GetHandle() == base::kNullProcessHandle)
+      continue;
+    mate::Dictionary row = GetProcessMetrics(
+        isolate, host->GetHandle(), "renderer", host->GetID(), &metrics);
+    row.Set("webContents", GetWebContentsInProcess(isolate, host));
+    row.Set("v8Flags", GetV8FlagsOfProcess(host));
+    rows.push_back(row);
+  }
+
+  for (const content::ChildProcessData& data : child_processes) {
+    if (data.handle == base::kNullProcessHandle)
+      continue;
+    rows.push_back(GetProcessMetrics(
+        isolate, data.handle, GetProcessTypeName(data.process_type), data.id,
+        &metrics));
+  }
+
+  process_metrics_.swap(metrics);
+  callback.Run(mate::ConvertToV8(isolate, rows));
+}
+
+mate::Dictionary App::GetProcessMetrics(
+    v8::Isolate* isolate,
+    base::ProcessHandle handle,
+    const std::string& type,
+    int id,
+    std::map<base::ProcessId, linked_ptr<base::ProcessMetrics>>* metrics) {
+  base::ProcessId pid = base::GetProcId(handle);
+  linked_ptr<base::ProcessMetrics> process_metrics = process_metrics_[pid];
+  if (!process_metrics.get()) {
+#if defined(OS_MACOSX)
+    process_metrics.reset(base::ProcessMetrics::CreateProcessMetrics(
+        handle, content::BrowserChildProcessHost::GetPortProvider()));
+#else
+    process_metrics.reset(base::ProcessMetrics::CreateProcessMetrics(handle));
+#endif
+  }
+  (*metrics)[pid] = process_metrics;
+
+  mate::Dictionary cpu = mate::Dictionary::CreateEmpty(isolate);
+  cpu.Set("percentCPUUsage", process_metrics->GetCPUUsage());
+
+  size_t private_bytes = 0;
+  size_t shared_bytes = 0;
+  process_metrics->GetMemoryBytes(&private_bytes, &shared_bytes);
+  mate::Dictionary memory = mate::Dictionary::CreateEmpty(isolate);
+  memory.Set("workingSetSize",
+             static_cast<double>(process_metrics->GetWorkingSetSize() >> 10));
+  memory.Set("peakWorkingSetSize",
+             static_cast<double>(
+                 process_metrics->GetPeakWorkingSetSize() >> 10));
+  memory.Set("privateBytes", static_cast<double>(private_bytes >> 10));
+  memory.Set("sharedBytes", static_cast<double>(shared_bytes >> 10));
+
+  mate::Dictionary row = mate::Dictionary::CreateEmpty(isolate);
+  row.Set("pid", static_cast<int>(pid));
+  row.Set("type", type);
+  row.Set("id", id);
+  row.Set("cpu", cpu);
+  row.Set("memory", memory);
+#if defined(OS_WIN)
+  DWORD handle_count = 0;
+  if (::GetProcessHandleCount(handle, &handle_count))
+    row.Set("handles", static_cast<int>(handle_count));
+#elif defined(OS_LINUX)
+  row.Set("handles", process_metrics->GetOpenFdCount());
+#endif
+  return row;
+}
+
 mate::ObjectTemplateBuilder App::GetObjectTemplateBuilder(
     v8::Isolate* isolate) {
   auto browser = base::Unretained(Browser::Get());
@@ -370,7 +651,14 @@ mate::ObjectTemplateBuilder App::GetObjectTemplateBuilder(
       .SetMethod("setAppUserModelId", &App::SetAppUserModelId)
       .SetMethod("allowNTLMCredentialsForAllDomains",
                  &App::AllowNTLMCredentialsForAllDomains)
+      .SetMethod("setSpareRendererProcessCount",
+                 &App::SetSpareRendererProcessCount)
       .SetMethod("getLocale", &App::GetLocale)
+      .SetMethod("getStartupTimeline", &App::GetStartupTimeline)
+      .SetMethod("_getResourceFileUsage", &App::GetResourceFileUsage)
+      .SetMethod("getAppMetrics", &App::GetAppMetrics)
+      .SetMethod("startHangMonitor", &App::StartHangMonitor)
+      .SetMethod("stopHangMonitor", &App::StopHangMonitor)
       .SetMethod("makeSingleInstance", &App::MakeSingleInstance)
       .SetProperty("defaultSession", &App::DefaultSession);
 }
@@ -5,17 +5,31 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_APP_H_
 #define ATOM_BROWSER_API_ATOM_API_APP_H_
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/event_emitter.h"
 #include "atom/browser/browser_observer.h"
+#include "atom/browser/hang_monitor.h"
 #include "atom/common/native_mate_converters/callback.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/process/process_handle.h"
 #include "chrome/browser/process_singleton.h"
 #include "content/public/browser/gpu_data_manager_observer.h"
+#include "native_mate/dictionary.h"
 #include "native_mate/handle.h"
 
 namespace base {
 class FilePath;
+class ListValue;
+class ProcessMetrics;
+}
+
+namespace content {
+struct ChildProcessData;
 }
 
 namespace mate {
@@ -28,7 +42,8 @@ namespace api {
 
 class App : public mate::EventEmitter,
             public BrowserObserver,
-            public content::GpuDataManagerObserver {
+            public content::GpuDataManagerObserver,
+            public HangMonitor::Delegate {
  public:
   static mate::Handle<App> Create(v8::Isolate* isolate);
 
@@ -55,6 +70,11 @@ class App : public mate::EventEmitter,
   // content::GpuDataManagerObserver:
   void OnGpuProcessCrashed(base::TerminationStatus exit_code) override;
 
+  // HangMonitor::Delegate:
+  void OnMainThreadHang(base::TimeDelta duration,
+                        const std::string& js_stack,
+                        bool minidump_written) override;
+
   // mate::Wrappable:
   mate::ObjectTemplateBuilder GetObjectTemplateBuilder(
       v8::Isolate* isolate) override;
@@ -69,15 +89,50 @@ class App : public mate::EventEmitter,
   void SetDesktopName(const std::string& desktop_name);
   void SetAppUserModelId(const std::string& app_id);
   void AllowNTLMCredentialsForAllDomains(bool should_allow);
+  void SetSpareRendererProcessCount(int count);
   bool MakeSingleInstance(
       const ProcessSingleton::NotificationCallback& callback);
   std::string GetLocale();
   v8::Local<v8::Value> DefaultSession(v8::Isolate* isolate);
 
+  void StartHangMonitor(mate::Arguments* args);
+  void StopHangMonitor();
+
+  // The milestones of the browser's startup, see StartupTimeline.
+  v8::Local<v8::Value> GetStartupTimeline(v8::Isolate* isolate);
+
+  // Reports how much of the resource packs and archives is in memory.
+  void GetResourceFileUsage(mate::Arguments* args);
+  void OnResourceFileUsageCollected(
+      v8::Isolate* isolate,
+      const base::Callback<void(v8::Local<v8::Value>)>& callback,
+      scoped_ptr<base::ListValue> usage);
+
+  // Reports the metrics of the browser and all child processes.
+  void GetAppMetrics(mate::Arguments* args);
+  void OnChildProcessesCollected(
+      v8::Isolate* isolate,
+      const base::Callback<void(v8::Local<v8::Value>)>& callback,
+      const std::vector<content::ChildProcessData>& child_processes);
+  mate::Dictionary GetProcessMetrics(
+      v8::Isolate* isolate,
+      base::ProcessHandle handle,
+      const std::string& type,
+      int id,
+      std::map<base::ProcessId, linked_ptr<base::ProcessMetrics>>* metrics);
+
   v8::Global<v8::Value> default_session_;
 
   scoped_ptr<ProcessSingleton> process_singleton_;
 
+  scoped_refptr<HangMonitor> hang_monitor_;
+
+  // The metrics of the processes reported last time, so the CPU usage covers
+  // the time since then.
+  std::map<base::ProcessId, linked_ptr<base::ProcessMetrics>> process_metrics_;
+
+  base::WeakPtrFactory<App> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(App);
 };
 
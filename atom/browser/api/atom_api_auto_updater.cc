@@ -8,11 +8,20 @@
 #include "atom/browser/browser.h"
 #include "atom/browser/native_window.h"
 #include "atom/browser/window_list.h"
+#include "atom/common/asar/archive_delta.h"
 #include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/node_includes.h"
+#include "base/task_runner_util.h"
+#include "base/threading/thread.h"
+#include "base/threading/thread_restrictions.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 
+#if defined(OS_MACOSX)
+#include <sys/resource.h>
+#endif
+
 namespace mate {
 
 template<>
@@ -34,12 +43,34 @@ namespace atom {
 
 namespace api {
 
+namespace {
+
+// Returns the error of applying the delta, empty when it succeeded.
+std::string ApplyAppDeltaOnThread(const base::FilePath& base_path,
+                                  const base::FilePath& delta_path,
+                                  const base::FilePath& output_path) {
+#if defined(OS_MACOSX)
+  // Keep the disk to the user while the archive is rewritten.
+  setiopolicy_np(IOPOL_TYPE_DISK, IOPOL_SCOPE_THREAD, IOPOL_THROTTLE);
+#endif
+  std::string error;
+  asar::ApplyArchiveDelta(base_path, delta_path, output_path, &error);
+  return error;
+}
+
+}  // namespace
+
 AutoUpdater::AutoUpdater() {
   auto_updater::AutoUpdater::SetDelegate(this);
 }
 
 AutoUpdater::~AutoUpdater() {
   auto_updater::AutoUpdater::SetDelegate(nullptr);
+  if (delta_thread_) {
+    // A delta being applied is finished first, it is never left half written.
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    delta_thread_.reset();
+  }
 }
 
 void AutoUpdater::OnError(const std::string& message) {
@@ -74,6 +105,28 @@ void AutoUpdater::OnUpdateDownloaded(const std::string& release_notes,
        base::Bind(&AutoUpdater::QuitAndInstall, base::Unretained(this)));
 }
 
+void AutoUpdater::ApplyAppDelta(
+    const base::FilePath& base_path,
+    const base::FilePath& delta_path,
+    const base::FilePath& output_path,
+    const base::Callback<void(const std::string&)>& callback) {
+  if (!delta_thread_) {
+    delta_thread_.reset(new base::Thread("AppDeltaThread"));
+    base::Thread::Options options;
+    options.priority = base::ThreadPriority::BACKGROUND;
+    if (!delta_thread_->StartWithOptions(options)) {
+      delta_thread_.reset();
+      callback.Run("Unable to start the thread applying the delta");
+      return;
+    }
+  }
+
+  base::PostTaskAndReplyWithResult(
+      delta_thread_->task_runner().get(), FROM_HERE,
+      base::Bind(&ApplyAppDeltaOnThread, base_path, delta_path, output_path),
+      callback);
+}
+
 void AutoUpdater::OnWindowAllClosed() {
   QuitAndInstall();
 }
@@ -83,7 +136,8 @@ mate::ObjectTemplateBuilder AutoUpdater::GetObjectTemplateBuilder(
   return mate::ObjectTemplateBuilder(isolate)
       .SetMethod("setFeedUrl", &auto_updater::AutoUpdater::SetFeedURL)
       .SetMethod("checkForUpdates", &auto_updater::AutoUpdater::CheckForUpdates)
-      .SetMethod("quitAndInstall", &AutoUpdater::QuitAndInstall);
+      .SetMethod("quitAndInstall", &AutoUpdater::QuitAndInstall)
+      .SetMethod("_applyAppDelta", &AutoUpdater::ApplyAppDelta);
 }
 
 void AutoUpdater::QuitAndInstall() {
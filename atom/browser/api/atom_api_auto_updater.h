@@ -10,8 +10,15 @@
 #include "atom/browser/api/event_emitter.h"
 #include "atom/browser/auto_updater.h"
 #include "atom/browser/window_list_observer.h"
+#include "base/callback.h"
+#include "base/memory/scoped_ptr.h"
 #include "native_mate/handle.h"
 
+namespace base {
+class FilePath;
+class Thread;
+}
+
 namespace atom {
 
 namespace api {
@@ -46,6 +53,16 @@ class AutoUpdater : public mate::EventEmitter,
  private:
   void QuitAndInstall();
 
+  // Writes the archive made from |base_path| and the delta at |delta_path| to
+  // |output_path| on a background thread, and calls |callback| with the error
+  // or an empty string.
+  void ApplyAppDelta(const base::FilePath& base_path,
+                     const base::FilePath& delta_path,
+                     const base::FilePath& output_path,
+                     const base::Callback<void(const std::string&)>& callback);
+
+  scoped_ptr<base::Thread> delta_thread_;
+
   DISALLOW_COPY_AND_ASSIGN(AutoUpdater);
 };
 
@@ -2,17 +2,26 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/node_includes.h"
 #include "base/bind.h"
 #include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/tracing_controller.h"
 #include "native_mate/dictionary.h"
+#include "vendor/node/deps/zlib/zlib.h"
 
+using content::BrowserThread;
 using content::TracingController;
 
 namespace mate {
@@ -63,6 +72,121 @@ void CaptureMonitoringSnapshot(const base::FilePath& path,
       GetTraceDataSink(path, callback));
 }
 
+using DumpCallback = base::Callback<void(bool)>;
+
+bool GzipString(const std::string& input, std::string* output) {
+  z_stream stream = {};
+  // Adding 16 to the window bits writes a gzip header.
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16,
+                   8, Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+  output->resize(deflateBound(&stream, input.size()));
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = input.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&(*output)[0]);
+  stream.avail_out = output->size();
+  int result = deflate(&stream, Z_FINISH);
+  output->resize(stream.total_out);
+  deflateEnd(&stream);
+  return result == Z_STREAM_END;
+}
+
+// Writes the events of the last |seconds| in |chunks| to |path| as gzipped
+// JSON, all of them when |seconds| is not positive.
+bool WriteTraceDump(scoped_ptr<std::vector<std::string>> chunks,
+                    const base::FilePath& path,
+                    double seconds) {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  // The events are keyed by their timestamps in microseconds, the metadata
+  // events are always kept.
+  std::vector<std::pair<double, std::string>> events;
+  double last_timestamp = 0;
+  for (const std::string& chunk : *chunks) {
+    scoped_ptr<base::Value> value(base::JSONReader::Read("[" + chunk + "]"));
+    base::ListValue* list;
+    if (!value || !value->GetAsList(&list))
+      continue;
+    for (base::Value* item : *list) {
+      base::DictionaryValue* event;
+      if (!item->GetAsDictionary(&event))
+        continue;
+      std::string phase;
+      double timestamp = 0;
+      event->GetString("ph", &phase);
+      event->GetDouble("ts", &timestamp);
+      if (phase == "M")
+        timestamp = -1;
+      else
+        last_timestamp = std::max(last_timestamp, timestamp);
+      std::string json;
+      base::JSONWriter::Write(*event, &json);
+      events.push_back(std::make_pair(timestamp, json));
+    }
+  }
+
+  double since = seconds > 0 ? last_timestamp - seconds * 1000000 : 0;
+  std::string trace = "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& event : events) {
+    if (event.first >= 0 && event.first < since)
+      continue;
+    if (!first)
+      trace += ",";
+    trace += event.second;
+    first = false;
+  }
+  trace += "]}";
+
+  std::string compressed;
+  if (!GzipString(trace, &compressed))
+    return false;
+  return base::WriteFile(path, compressed.data(), compressed.size()) ==
+      static_cast<int>(compressed.size());
+}
+
+// Keeps the chunks of a monitoring snapshot, and writes the dump on the FILE
+// thread once all processes have sent theirs.
+class TraceDumpSink : public TracingController::TraceDataSink {
+ public:
+  TraceDumpSink(const base::FilePath& path,
+                double seconds,
+                const DumpCallback& callback)
+      : path_(path),
+        seconds_(seconds),
+        callback_(callback),
+        chunks_(new std::vector<std::string>) {}
+
+  void AddTraceChunk(const std::string& chunk) override {
+    chunks_->push_back(chunk);
+  }
+
+  void Close() override {
+    BrowserThread::PostTaskAndReplyWithResult(
+        BrowserThread::FILE, FROM_HERE,
+        base::Bind(&WriteTraceDump, base::Passed(&chunks_), path_, seconds_),
+        callback_);
+  }
+
+ private:
+  ~TraceDumpSink() override {}
+
+  base::FilePath path_;
+  double seconds_;
+  DumpCallback callback_;
+  scoped_ptr<std::vector<std::string>> chunks_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceDumpSink);
+};
+
+void DumpTrace(const base::FilePath& path,
+               double seconds,
+               const DumpCallback& callback) {
+  if (!TracingController::GetInstance()->CaptureMonitoringSnapshot(
+          new TraceDumpSink(path, seconds, callback)))
+    callback.Run(false);
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   auto controller = base::Unretained(TracingController::GetInstance());
@@ -77,6 +201,7 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("stopMonitoring", base::Bind(
       &TracingController::DisableMonitoring, controller));
   dict.SetMethod("captureMonitoringSnapshot", &CaptureMonitoringSnapshot);
+  dict.SetMethod("dumpTrace", &DumpTrace);
   dict.SetMethod("getTraceBufferUsage", base::Bind(
       &TracingController::GetTraceBufferUsage, controller));
   dict.SetMethod("setWatchEvent", base::Bind(
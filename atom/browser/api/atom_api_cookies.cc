@@ -8,6 +8,7 @@
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/browser_context.h"
@@ -149,6 +150,99 @@ bool MatchesCookie(const base::DictionaryValue* filter,
   return true;
 }
 
+// Returns an error message when |value| is not the details of a cookie.
+std::string CheckCookieDetails(const base::Value* value, bool need_name) {
+  const base::DictionaryValue* details = nullptr;
+  std::string url, name;
+  if (!value->GetAsDictionary(&details) || !details->GetString("url", &url) ||
+      (need_name && !details->GetString("name", &name)))
+    return need_name ? "Details(url, name) of the cookie are required." :
+                       "The url field is required.";
+  if (!GURL(url).is_valid())
+    return "Url is not valid.";
+  return std::string();
+}
+
+void SetCookieWithDetails(
+    net::CookieStore* cookie_store,
+    const base::DictionaryValue& details,
+    const GURL& url,
+    const net::CookieMonster::SetCookiesCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+
+  std::string name, value, domain, path;
+  bool secure = false;
+  bool http_only = false;
+  double expiration_date;
+
+  details.GetString("name", &name);
+  details.GetString("value", &value);
+  details.GetString("domain", &domain);
+  details.GetString("path", &path);
+  details.GetBoolean("secure", &secure);
+  details.GetBoolean("http_only", &http_only);
+
+  base::Time expiration_time;
+  if (details.GetDouble("expirationDate", &expiration_date)) {
+    expiration_time = (expiration_date == 0) ?
+        base::Time::UnixEpoch() :
+        base::Time::FromDoubleT(expiration_date);
+  }
+
+  cookie_store->GetCookieMonster()->SetCookieWithDetailsAsync(
+      url,
+      name,
+      value,
+      domain,
+      path,
+      expiration_time,
+      secure,
+      http_only,
+      false,
+      net::COOKIE_PRIORITY_DEFAULT,
+      callback);
+}
+
+// Counts the cookies of a batch that are still being set or removed, the
+// callback is called with the number of failures after the last one.
+class BatchResult : public base::RefCounted<BatchResult> {
+ public:
+  BatchResult(size_t pending, const base::Callback<void(int)>& callback)
+      : pending_(pending), failed_(0), callback_(callback) {}
+
+  void OnSet(bool success) {
+    if (!success)
+      ++failed_;
+    OnDone();
+  }
+
+  void OnDone() {
+    if (--pending_ == 0)
+      callback_.Run(failed_);
+  }
+
+ private:
+  friend class base::RefCounted<BatchResult>;
+
+  ~BatchResult() {}
+
+  size_t pending_;
+  int failed_;
+  base::Callback<void(int)> callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(BatchResult);
+};
+
+// Called by the cookie store on the IO thread, runs |callback| on the UI
+// thread.
+void PostCookieChanged(
+    const net::CookieStore::CookieChangedCallback& callback,
+    const net::CanonicalCookie& cookie,
+    bool removed) {
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                          base::Bind(callback, cookie, removed));
+}
+
 }  // namespace
 
 namespace mate {
@@ -179,10 +273,14 @@ namespace atom {
 namespace api {
 
 Cookies::Cookies(content::BrowserContext* browser_context)
-    : request_context_getter_(browser_context->GetRequestContext()) {
+    : request_context_getter_(browser_context->GetRequestContext()),
+      next_watch_id_(0),
+      subscriptions_(new Subscriptions),
+      weak_factory_(this) {
 }
 
 Cookies::~Cookies() {
+  BrowserThread::DeleteSoon(BrowserThread::IO, FROM_HERE, subscriptions_);
 }
 
 void Cookies::Get(const base::DictionaryValue& options,
@@ -280,38 +378,7 @@ void Cookies::Set(const base::DictionaryValue& options,
 void Cookies::SetCookiesOnIOThread(scoped_ptr<base::DictionaryValue> details,
                                    const GURL& url,
                                    const CookiesCallback& callback) {
-  DCHECK_CURRENTLY_ON(BrowserThread::IO);
-
-  std::string name, value, domain, path;
-  bool secure = false;
-  bool http_only = false;
-  double expiration_date;
-
-  details->GetString("name", &name);
-  details->GetString("value", &value);
-  details->GetString("domain", &domain);
-  details->GetString("path", &path);
-  details->GetBoolean("secure", &secure);
-  details->GetBoolean("http_only", &http_only);
-
-  base::Time expiration_time;
-  if (details->GetDouble("expirationDate", &expiration_date)) {
-    expiration_time = (expiration_date == 0) ?
-        base::Time::UnixEpoch() :
-        base::Time::FromDoubleT(expiration_date);
-  }
-
-  GetCookieStore()->GetCookieMonster()->SetCookieWithDetailsAsync(
-      url,
-      name,
-      value,
-      domain,
-      path,
-      expiration_time,
-      secure,
-      http_only,
-      false,
-      net::COOKIE_PRIORITY_DEFAULT,
+  SetCookieWithDetails(GetCookieStore(), *details, url,
       base::Bind(&Cookies::OnSetCookies, base::Unretained(this), callback));
 }
 
@@ -322,12 +389,179 @@ void Cookies::OnSetCookies(const CookiesCallback& callback,
                  callback));
 }
 
+void Cookies::SetMany(const base::ListValue& list,
+                      const CookiesCallback& callback) {
+  for (const base::Value* value : list) {
+    std::string error_message = CheckCookieDetails(value, false);
+    if (!error_message.empty()) {
+      RunSetCookiesCallbackOnUIThread(isolate(), error_message, false,
+                                      callback);
+      return;
+    }
+  }
+
+  if (list.empty()) {
+    RunSetCookiesCallbackOnUIThread(isolate(), "", true, callback);
+    return;
+  }
+
+  scoped_ptr<base::ListValue> cookies(list.DeepCopy());
+  content::BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&Cookies::SetManyOnIOThread, base::Unretained(this),
+          Passed(&cookies), callback));
+}
+
+void Cookies::SetManyOnIOThread(scoped_ptr<base::ListValue> list,
+                                const CookiesCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+
+  scoped_refptr<BatchResult> result(new BatchResult(
+      list->GetSize(),
+      base::Bind(&Cookies::OnSetManyCookies, base::Unretained(this),
+                 callback)));
+  net::CookieStore* cookie_store = GetCookieStore();
+  for (const base::Value* value : *list) {
+    const base::DictionaryValue* details = nullptr;
+    std::string url;
+    value->GetAsDictionary(&details);
+    details->GetString("url", &url);
+    SetCookieWithDetails(cookie_store, *details, GURL(url),
+                         base::Bind(&BatchResult::OnSet, result));
+  }
+}
+
+void Cookies::OnSetManyCookies(const CookiesCallback& callback, int failed) {
+  std::string error_message;
+  if (failed > 0)
+    error_message = "Failed to set " + base::IntToString(failed) + " cookies";
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(&RunSetCookiesCallbackOnUIThread, isolate(), error_message,
+                 true, callback));
+}
+
+void Cookies::RemoveMany(const base::ListValue& list,
+                         const CookiesCallback& callback) {
+  for (const base::Value* value : list) {
+    std::string error_message = CheckCookieDetails(value, true);
+    if (!error_message.empty()) {
+      RunRemoveCookiesCallbackOnUIThread(isolate(), error_message, callback);
+      return;
+    }
+  }
+
+  if (list.empty()) {
+    RunRemoveCookiesCallbackOnUIThread(isolate(), "", callback);
+    return;
+  }
+
+  scoped_ptr<base::ListValue> cookies(list.DeepCopy());
+  content::BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&Cookies::RemoveManyOnIOThread, base::Unretained(this),
+          Passed(&cookies), callback));
+}
+
+void Cookies::RemoveManyOnIOThread(scoped_ptr<base::ListValue> list,
+                                   const CookiesCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+
+  scoped_refptr<BatchResult> result(new BatchResult(
+      list->GetSize(),
+      base::Bind(&Cookies::OnRemoveManyCookies, base::Unretained(this),
+                 callback)));
+  net::CookieStore* cookie_store = GetCookieStore();
+  for (const base::Value* value : *list) {
+    const base::DictionaryValue* details = nullptr;
+    std::string url, name;
+    value->GetAsDictionary(&details);
+    details->GetString("url", &url);
+    details->GetString("name", &name);
+    cookie_store->DeleteCookieAsync(GURL(url), name,
+                                    base::Bind(&BatchResult::OnDone, result));
+  }
+}
+
+void Cookies::OnRemoveManyCookies(const CookiesCallback& callback,
+                                  int failed) {
+  OnRemoveCookies(callback);
+}
+
+int Cookies::Watch(const mate::Dictionary& details,
+                   const ChangedCallback& callback,
+                   mate::Arguments* args) {
+  GURL url;
+  std::string name;
+  if (!details.Get("url", &url) || !details.Get("name", &name)) {
+    args->ThrowError("Details(url, name) of the cookie are required.");
+    return 0;
+  }
+  if (!url.is_valid()) {
+    args->ThrowError("Url is not valid.");
+    return 0;
+  }
+
+  int id = ++next_watch_id_;
+  watchers_[id] = callback;
+  net::CookieStore::CookieChangedCallback on_changed = base::Bind(
+      &Cookies::OnCookieChanged, weak_factory_.GetWeakPtr(), id);
+  content::BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&Cookies::WatchOnIOThread,
+                 make_scoped_refptr(request_context_getter_),
+                 base::Unretained(subscriptions_), id, url, name,
+                 base::Bind(&PostCookieChanged, on_changed)));
+  return id;
+}
+
+void Cookies::Unwatch(int id) {
+  if (watchers_.erase(id) == 0)
+    return;
+  content::BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&Cookies::UnwatchOnIOThread,
+                 base::Unretained(subscriptions_), id));
+}
+
+// static
+void Cookies::WatchOnIOThread(
+    scoped_refptr<net::URLRequestContextGetter> request_context_getter,
+    Subscriptions* subscriptions,
+    int id,
+    const GURL& url,
+    const std::string& name,
+    const net::CookieStore::CookieChangedCallback& callback) {
+  net::CookieStore* cookie_store =
+      request_context_getter->GetURLRequestContext()->cookie_store();
+  (*subscriptions)[id] = make_linked_ptr(
+      cookie_store->AddCallbackForCookie(url, name, callback).release());
+}
+
+// static
+void Cookies::UnwatchOnIOThread(Subscriptions* subscriptions, int id) {
+  subscriptions->erase(id);
+}
+
+void Cookies::OnCookieChanged(int id,
+                              const net::CanonicalCookie& cookie,
+                              bool removed) {
+  auto it = watchers_.find(id);
+  if (it == watchers_.end())
+    return;
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  // Copy the callback in case Unwatch is called in it.
+  ChangedCallback callback = it->second;
+  callback.Run(mate::ConvertToV8(isolate(), cookie), removed);
+}
+
 mate::ObjectTemplateBuilder Cookies::GetObjectTemplateBuilder(
     v8::Isolate* isolate) {
   return mate::ObjectTemplateBuilder(isolate)
       .SetMethod("get", &Cookies::Get)
       .SetMethod("remove", &Cookies::Remove)
-      .SetMethod("set", &Cookies::Set);
+      .SetMethod("set", &Cookies::Set)
+      .SetMethod("setMany", &Cookies::SetMany)
+      .SetMethod("removeMany", &Cookies::RemoveMany)
+      .SetMethod("watch", &Cookies::Watch)
+      .SetMethod("unwatch", &Cookies::Unwatch);
 }
 
 net::CookieStore* Cookies::GetCookieStore() {
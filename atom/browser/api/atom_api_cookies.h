@@ -5,15 +5,20 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_COOKIES_H_
 #define ATOM_BROWSER_API_ATOM_API_COOKIES_H_
 
+#include <map>
 #include <string>
 
 #include "base/callback.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "native_mate/wrappable.h"
 #include "native_mate/handle.h"
 #include "net/cookies/canonical_cookie.h"
+#include "net/cookies/cookie_store.h"
 
 namespace base {
 class DictionaryValue;
+class ListValue;
 }
 
 namespace content {
@@ -25,7 +30,6 @@ class Dictionary;
 }
 
 namespace net {
-class CookieStore;
 class URLRequestContextGetter;
 }
 
@@ -38,6 +42,8 @@ class Cookies : public mate::Wrappable {
   // node.js style callback function(error, result)
   typedef base::Callback<void(v8::Local<v8::Value>, v8::Local<v8::Value>)>
       CookiesCallback;
+  // function(cookie, removed)
+  typedef base::Callback<void(v8::Local<v8::Value>, bool)> ChangedCallback;
 
   static mate::Handle<Cookies> Create(v8::Isolate* isolate,
                                       content::BrowserContext* browser_context);
@@ -53,6 +59,17 @@ class Cookies : public mate::Wrappable {
   void Set(const base::DictionaryValue& details,
            const CookiesCallback& callback);
 
+  // Set or remove a list of cookies in one task on the IO thread.
+  void SetMany(const base::ListValue& list, const CookiesCallback& callback);
+  void RemoveMany(const base::ListValue& list,
+                  const CookiesCallback& callback);
+
+  // Call |callback| whenever the cookie of |details| changes, returns the id
+  // to pass to Unwatch.
+  int Watch(const mate::Dictionary& details, const ChangedCallback& callback,
+            mate::Arguments* args);
+  void Unwatch(int id);
+
   void GetCookiesOnIOThread(scoped_ptr<base::DictionaryValue> filter,
                             const CookiesCallback& callback);
   void OnGetCookies(scoped_ptr<base::DictionaryValue> filter,
@@ -70,6 +87,31 @@ class Cookies : public mate::Wrappable {
   void OnSetCookies(const CookiesCallback& callback,
                     bool set_success);
 
+  void SetManyOnIOThread(scoped_ptr<base::ListValue> list,
+                         const CookiesCallback& callback);
+  void OnSetManyCookies(const CookiesCallback& callback, int failed);
+
+  void RemoveManyOnIOThread(scoped_ptr<base::ListValue> list,
+                            const CookiesCallback& callback);
+  void OnRemoveManyCookies(const CookiesCallback& callback, int failed);
+
+  // The subscriptions of the watchers, they are created, used and deleted on
+  // the IO thread.
+  using Subscriptions =
+      std::map<int, linked_ptr<net::CookieStore::CookieChangedSubscription>>;
+  static void WatchOnIOThread(
+      scoped_refptr<net::URLRequestContextGetter> request_context_getter,
+      Subscriptions* subscriptions,
+      int id,
+      const GURL& url,
+      const std::string& name,
+      const net::CookieStore::CookieChangedCallback& callback);
+  static void UnwatchOnIOThread(Subscriptions* subscriptions, int id);
+
+  void OnCookieChanged(int id,
+                       const net::CanonicalCookie& cookie,
+                       bool removed);
+
   // mate::Wrappable:
   mate::ObjectTemplateBuilder GetObjectTemplateBuilder(
       v8::Isolate* isolate) override;
@@ -80,6 +122,15 @@ class Cookies : public mate::Wrappable {
 
   net::URLRequestContextGetter* request_context_getter_;
 
+  // The listeners of Watch, only accessed on the UI thread.
+  std::map<int, ChangedCallback> watchers_;
+  int next_watch_id_;
+
+  // Owned, deleted on the IO thread.
+  Subscriptions* subscriptions_;
+
+  base::WeakPtrFactory<Cookies> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(Cookies);
 };
 
@@ -48,6 +48,19 @@ bool GlobalShortcut::Register(const ui::Accelerator& accelerator,
   return true;
 }
 
+std::vector<bool> GlobalShortcut::RegisterAll(
+    const std::vector<ui::Accelerator>& accelerators,
+    const std::vector<base::Closure>& callbacks) {
+  std::vector<bool> registered =
+      GlobalShortcutListener::GetInstance()->RegisterAccelerators(
+          accelerators, this);
+  for (size_t i = 0; i < accelerators.size() && i < callbacks.size(); ++i) {
+    if (registered[i])
+      accelerator_callback_map_[accelerators[i]] = callbacks[i];
+  }
+  return registered;
+}
+
 void GlobalShortcut::Unregister(const ui::Accelerator& accelerator) {
   if (!ContainsKey(accelerator_callback_map_, accelerator))
     return;
@@ -66,13 +79,19 @@ void GlobalShortcut::UnregisterAll() {
   GlobalShortcutListener::GetInstance()->UnregisterAccelerators(this);
 }
 
+void GlobalShortcut::SetGrabLockModifiers(bool grab) {
+  GlobalShortcutListener::GetInstance()->SetGrabLockModifiers(grab);
+}
+
 mate::ObjectTemplateBuilder GlobalShortcut::GetObjectTemplateBuilder(
     v8::Isolate* isolate) {
   return mate::ObjectTemplateBuilder(isolate)
       .SetMethod("register", &GlobalShortcut::Register)
+      .SetMethod("_registerAll", &GlobalShortcut::RegisterAll)
       .SetMethod("isRegistered", &GlobalShortcut::IsRegistered)
       .SetMethod("unregister", &GlobalShortcut::Unregister)
-      .SetMethod("unregisterAll", &GlobalShortcut::UnregisterAll);
+      .SetMethod("unregisterAll", &GlobalShortcut::UnregisterAll)
+      .SetMethod("setGrabLockModifiers", &GlobalShortcut::SetGrabLockModifiers);
 }
 
 // static
@@ -7,6 +7,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "base/callback.h"
 #include "chrome/browser/extensions/global_shortcut_listener.h"
@@ -36,9 +37,13 @@ class GlobalShortcut : public extensions::GlobalShortcutListener::Observer,
 
   bool Register(const ui::Accelerator& accelerator,
                 const base::Closure& callback);
+  std::vector<bool> RegisterAll(
+      const std::vector<ui::Accelerator>& accelerators,
+      const std::vector<base::Closure>& callbacks);
   bool IsRegistered(const ui::Accelerator& accelerator);
   void Unregister(const ui::Accelerator& accelerator);
   void UnregisterAll();
+  void SetGrabLockModifiers(bool grab);
 
   // GlobalShortcutListener::Observer implementation.
   void OnKeyPressed(const ui::Accelerator& accelerator) override;
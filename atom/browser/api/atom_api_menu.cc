@@ -9,6 +9,7 @@
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/image_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "native_mate/arguments.h"
 #include "native_mate/constructor.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
@@ -36,6 +37,9 @@ void Menu::AfterInit(v8::Isolate* isolate) {
   delegate.Get("isCommandIdChecked", &is_checked_);
   delegate.Get("isCommandIdEnabled", &is_enabled_);
   delegate.Get("isCommandIdVisible", &is_visible_);
+  delegate.Get("isItemForCommandIdDynamic", &is_dynamic_);
+  delegate.Get("getLabelForCommandId", &get_label_);
+  delegate.Get("getIconForCommandId", &get_icon_);
   delegate.Get("getAcceleratorForCommandId", &get_accelerator_);
   delegate.Get("executeCommand", &execute_command_);
   delegate.Get("menuWillShow", &menu_will_show_);
@@ -53,6 +57,21 @@ bool Menu::IsCommandIdVisible(int command_id) const {
   return is_visible_.Run(command_id);
 }
 
+bool Menu::IsItemForCommandIdDynamic(int command_id) const {
+  return !is_dynamic_.is_null() && is_dynamic_.Run(command_id);
+}
+
+base::string16 Menu::GetLabelForCommandId(int command_id) const {
+  return get_label_.Run(command_id);
+}
+
+bool Menu::GetIconForCommandId(int command_id, gfx::Image* icon) const {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Value> val = get_icon_.Run(command_id);
+  return mate::ConvertFromV8(isolate(), val, icon) && !icon->IsEmpty();
+}
+
 bool Menu::GetAcceleratorForCommandId(int command_id,
                                       ui::Accelerator* accelerator) {
   v8::Locker locker(isolate());
@@ -99,6 +118,63 @@ void Menu::InsertSubMenuAt(int index,
   model_->InsertSubMenuAt(index, command_id, label, menu->model_.get());
 }
 
+void Menu::InsertItemsAt(mate::Arguments* args,
+                         int index,
+                         const std::vector<mate::Dictionary>& items) {
+  if (index < 0 || index > model_->GetItemCount()) {
+    args->ThrowError("Invalid index");
+    return;
+  }
+
+  for (const mate::Dictionary& item : items) {
+    std::string type;
+    int command_id = 0;
+    base::string16 label;
+    if (!item.Get("type", &type) ||
+        (type != "separator" && !item.Get("commandId", &command_id))) {
+      args->ThrowError("Invalid menu item");
+      return;
+    }
+    item.Get("label", &label);
+
+    if (type == "separator") {
+      model_->InsertSeparatorAt(index, ui::NORMAL_SEPARATOR);
+    } else if (type == "checkbox") {
+      model_->InsertCheckItemAt(index, command_id, label);
+    } else if (type == "radio") {
+      int group_id = 0;
+      item.Get("groupId", &group_id);
+      model_->InsertRadioItemAt(index, command_id, label, group_id);
+    } else if (type == "submenu") {
+      Menu* submenu;
+      if (!item.Get("submenu", &submenu)) {
+        args->ThrowError("Invalid submenu");
+        return;
+      }
+      submenu->parent_ = this;
+      model_->InsertSubMenuAt(index, command_id, label,
+                              submenu->model_.get());
+    } else {
+      model_->InsertItemAt(index, command_id, label);
+    }
+
+    base::string16 sublabel, role;
+    gfx::Image icon;
+    if (item.Get("sublabel", &sublabel) && !sublabel.empty())
+      model_->SetSublabel(index, sublabel);
+    if (item.Get("icon", &icon) && !icon.IsEmpty())
+      model_->SetIcon(index, icon);
+    if (item.Get("role", &role) && !role.empty())
+      model_->SetRole(index, role);
+    ++index;
+  }
+}
+
+void Menu::RemoveItemAt(int index) {
+  if (index >= 0 && index < model_->GetItemCount())
+    model_->RemoveItemAt(index);
+}
+
 void Menu::SetIcon(int index, const gfx::Image& image) {
   model_->SetIcon(index, image);
 }
@@ -156,6 +232,8 @@ void Menu::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("insertRadioItem", &Menu::InsertRadioItemAt)
       .SetMethod("insertSeparator", &Menu::InsertSeparatorAt)
       .SetMethod("insertSubMenu", &Menu::InsertSubMenuAt)
+      .SetMethod("_insertItems", &Menu::InsertItemsAt)
+      .SetMethod("removeItemAt", &Menu::RemoveItemAt)
       .SetMethod("setIcon", &Menu::SetIcon)
       .SetMethod("setSublabel", &Menu::SetSublabel)
       .SetMethod("setRole", &Menu::SetRole)
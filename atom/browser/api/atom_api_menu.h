@@ -6,6 +6,7 @@
 #define ATOM_BROWSER_API_ATOM_API_MENU_H_
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/atom_api_window.h"
 #include "atom/browser/ui/atom_menu_model.h"
@@ -13,6 +14,11 @@
 #include "base/memory/scoped_ptr.h"
 #include "native_mate/wrappable.h"
 
+namespace mate {
+class Arguments;
+class Dictionary;
+}
+
 namespace atom {
 
 namespace api {
@@ -46,6 +52,9 @@ class Menu : public mate::Wrappable,
   bool IsCommandIdChecked(int command_id) const override;
   bool IsCommandIdEnabled(int command_id) const override;
   bool IsCommandIdVisible(int command_id) const override;
+  bool IsItemForCommandIdDynamic(int command_id) const override;
+  base::string16 GetLabelForCommandId(int command_id) const override;
+  bool GetIconForCommandId(int command_id, gfx::Image* icon) const override;
   bool GetAcceleratorForCommandId(int command_id,
                                   ui::Accelerator* accelerator) override;
   void ExecuteCommand(int command_id, int event_flags) override;
@@ -71,6 +80,12 @@ class Menu : public mate::Wrappable,
                        int command_id,
                        const base::string16& label,
                        Menu* menu);
+  // Inserts the items described by |items| at |index|, so a whole menu can
+  // be built with one call.
+  void InsertItemsAt(mate::Arguments* args,
+                     int index,
+                     const std::vector<mate::Dictionary>& items);
+  void RemoveItemAt(int index);
   void SetIcon(int index, const gfx::Image& image);
   void SetSublabel(int index, const base::string16& sublabel);
   void SetRole(int index, const base::string16& role);
@@ -88,6 +103,9 @@ class Menu : public mate::Wrappable,
   base::Callback<bool(int)> is_checked_;
   base::Callback<bool(int)> is_enabled_;
   base::Callback<bool(int)> is_visible_;
+  base::Callback<bool(int)> is_dynamic_;
+  base::Callback<base::string16(int)> get_label_;
+  base::Callback<v8::Local<v8::Value>(int)> get_icon_;
   base::Callback<v8::Local<v8::Value>(int)> get_accelerator_;
   base::Callback<void(int)> execute_command_;
   base::Callback<void()> menu_will_show_;
@@ -0,0 +1,110 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_net_log.h"
+
+#include <string>
+
+#include "atom/browser/net/net_log_file_writer.h"
+#include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "base/files/file_path.h"
+#include "content/public/browser/browser_context.h"
+#include "native_mate/dictionary.h"
+#include "native_mate/object_template_builder.h"
+#include "net/url_request/url_request_context_getter.h"
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+// The file is rotated after 100MB by default.
+const int64 kDefaultMaxFileSize = 100 * 1024 * 1024;
+
+bool ParseCaptureMode(const std::string& name,
+                      net::NetLogCaptureMode* capture_mode) {
+  if (name == "default")
+    *capture_mode = net::NetLogCaptureMode::Default();
+  else if (name == "includeCookiesAndCredentials")
+    *capture_mode = net::NetLogCaptureMode::IncludeCookiesAndCredentials();
+  else if (name == "includeSocketBytes")
+    *capture_mode = net::NetLogCaptureMode::IncludeSocketBytes();
+  else
+    return false;
+  return true;
+}
+
+}  // namespace
+
+NetLog::NetLog(content::BrowserContext* browser_context)
+    : request_context_getter_(browser_context->GetRequestContext()) {
+}
+
+NetLog::~NetLog() {
+  // The writer is kept alive by the stopping tasks until the file is done.
+  if (writer_)
+    writer_->Stop(base::Closure());
+}
+
+void NetLog::Start(const base::FilePath& path, mate::Arguments* args) {
+  if (writer_) {
+    args->ThrowError("The net log is already being written");
+    return;
+  }
+
+  net::NetLogCaptureMode capture_mode = net::NetLogCaptureMode::Default();
+  double max_file_size = kDefaultMaxFileSize;
+  mate::Dictionary options;
+  if (args->GetNext(&options)) {
+    std::string name;
+    if (options.Get("captureMode", &name) &&
+        !ParseCaptureMode(name, &capture_mode)) {
+      args->ThrowError("Invalid captureMode: " + name);
+      return;
+    }
+    options.Get("maxFileSize", &max_file_size);
+  }
+
+  writer_ = new NetLogFileWriter(path, capture_mode,
+                                 static_cast<int64>(max_file_size));
+  writer_->Start(request_context_getter_.get());
+}
+
+void NetLog::Stop(mate::Arguments* args) {
+  base::Closure callback;
+  args->GetNext(&callback);
+  if (!writer_) {
+    if (!callback.is_null())
+      callback.Run();
+    return;
+  }
+
+  writer_->Stop(callback);
+  writer_ = nullptr;
+}
+
+bool NetLog::IsLogging() const {
+  return writer_.get() != nullptr;
+}
+
+mate::ObjectTemplateBuilder NetLog::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return mate::ObjectTemplateBuilder(isolate)
+      .SetMethod("start", &NetLog::Start)
+      .SetMethod("stop", &NetLog::Stop)
+      .SetMethod("isLogging", &NetLog::IsLogging);
+}
+
+// static
+mate::Handle<NetLog> NetLog::Create(
+    v8::Isolate* isolate,
+    content::BrowserContext* browser_context) {
+  return mate::CreateHandle(isolate, new NetLog(browser_context));
+}
+
+}  // namespace api
+
+}  // namespace atom
@@ -0,0 +1,65 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_ATOM_API_NET_LOG_H_
+#define ATOM_BROWSER_API_ATOM_API_NET_LOG_H_
+
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "native_mate/handle.h"
+#include "native_mate/wrappable.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace content {
+class BrowserContext;
+}
+
+namespace mate {
+class Arguments;
+}
+
+namespace net {
+class URLRequestContextGetter;
+}
+
+namespace atom {
+
+class NetLogFileWriter;
+
+namespace api {
+
+class NetLog : public mate::Wrappable {
+ public:
+  static mate::Handle<NetLog> Create(v8::Isolate* isolate,
+                                     content::BrowserContext* browser_context);
+
+ protected:
+  explicit NetLog(content::BrowserContext* browser_context);
+  ~NetLog();
+
+  void Start(const base::FilePath& path, mate::Arguments* args);
+  void Stop(mate::Arguments* args);
+  bool IsLogging() const;
+
+  // mate::Wrappable:
+  mate::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+
+ private:
+  scoped_refptr<net::URLRequestContextGetter> request_context_getter_;
+
+  // The writer of the running log, null when not logging.
+  scoped_refptr<NetLogFileWriter> writer_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetLog);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_ATOM_API_NET_LOG_H_
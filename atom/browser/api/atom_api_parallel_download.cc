@@ -0,0 +1,117 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_parallel_download.h"
+
+#include <string>
+
+#include "atom/browser/atom_browser_context.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/native_mate_converters/gurl_converter.h"
+#include "native_mate/object_template_builder.h"
+
+namespace atom {
+
+namespace api {
+
+ParallelDownload::ParallelDownload(AtomBrowserContext* browser_context,
+                                   const GURL& url,
+                                   const base::FilePath& path,
+                                   int segments)
+    : url_(url),
+      path_(path),
+      state_(ParallelDownloadJob::STATE_IN_PROGRESS),
+      received_bytes_(0),
+      total_bytes_(-1),
+      weak_factory_(this) {
+  job_ = new ParallelDownloadJob(browser_context->GetRequestContext(), url,
+                                 path, segments, weak_factory_.GetWeakPtr());
+  job_->Start();
+}
+
+ParallelDownload::~ParallelDownload() {
+}
+
+void ParallelDownload::OnDownloadUpdated(ParallelDownloadJob::State state,
+                                         int64 received_bytes,
+                                         int64 total_bytes) {
+  state_ = state;
+  received_bytes_ = received_bytes;
+  total_bytes_ = total_bytes;
+  std::string done_state;
+  switch (state) {
+    case ParallelDownloadJob::STATE_COMPLETED:
+      done_state = "completed";
+      break;
+    case ParallelDownloadJob::STATE_CANCELLED:
+      done_state = "cancelled";
+      break;
+    case ParallelDownloadJob::STATE_INTERRUPTED:
+      done_state = "interrupted";
+      break;
+    default:
+      break;
+  }
+  done_state.empty() ? Emit("updated") : Emit("done", done_state);
+}
+
+void ParallelDownload::Pause() {
+  job_->Pause();
+}
+
+void ParallelDownload::Resume() {
+  job_->Resume();
+}
+
+void ParallelDownload::Cancel() {
+  job_->Cancel();
+}
+
+bool ParallelDownload::IsPaused() const {
+  return state_ == ParallelDownloadJob::STATE_PAUSED;
+}
+
+int64 ParallelDownload::GetReceivedBytes() const {
+  return received_bytes_;
+}
+
+int64 ParallelDownload::GetTotalBytes() const {
+  return total_bytes_;
+}
+
+const GURL& ParallelDownload::GetUrl() const {
+  return url_;
+}
+
+const base::FilePath& ParallelDownload::GetSavePath() const {
+  return path_;
+}
+
+mate::ObjectTemplateBuilder ParallelDownload::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return mate::ObjectTemplateBuilder(isolate)
+      .SetMethod("pause", &ParallelDownload::Pause)
+      .SetMethod("resume", &ParallelDownload::Resume)
+      .SetMethod("cancel", &ParallelDownload::Cancel)
+      .SetMethod("isPaused", &ParallelDownload::IsPaused)
+      .SetMethod("getReceivedBytes", &ParallelDownload::GetReceivedBytes)
+      .SetMethod("getTotalBytes", &ParallelDownload::GetTotalBytes)
+      .SetMethod("getUrl", &ParallelDownload::GetUrl)
+      .SetMethod("getSavePath", &ParallelDownload::GetSavePath);
+}
+
+// static
+mate::Handle<ParallelDownload> ParallelDownload::Create(
+    v8::Isolate* isolate,
+    AtomBrowserContext* browser_context,
+    const GURL& url,
+    const base::FilePath& path,
+    int segments) {
+  return mate::CreateHandle(
+      isolate, new ParallelDownload(browser_context, url, path, segments));
+}
+
+}  // namespace api
+
+}  // namespace atom
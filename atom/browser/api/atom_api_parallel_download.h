@@ -0,0 +1,76 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_ATOM_API_PARALLEL_DOWNLOAD_H_
+#define ATOM_BROWSER_API_ATOM_API_PARALLEL_DOWNLOAD_H_
+
+#include "atom/browser/api/event_emitter.h"
+#include "atom/browser/net/parallel_download_job.h"
+#include "base/files/file_path.h"
+#include "base/memory/weak_ptr.h"
+#include "native_mate/handle.h"
+#include "url/gurl.h"
+
+namespace atom {
+
+class AtomBrowserContext;
+
+namespace api {
+
+// A download that is split across several connections, it has the methods
+// and events of DownloadItem that make sense without a page.
+class ParallelDownload : public mate::EventEmitter,
+                         public ParallelDownloadJob::Delegate {
+ public:
+  static mate::Handle<ParallelDownload> Create(
+      v8::Isolate* isolate,
+      AtomBrowserContext* browser_context,
+      const GURL& url,
+      const base::FilePath& path,
+      int segments);
+
+ protected:
+  ParallelDownload(AtomBrowserContext* browser_context,
+                   const GURL& url,
+                   const base::FilePath& path,
+                   int segments);
+  ~ParallelDownload();
+
+  // ParallelDownloadJob::Delegate:
+  void OnDownloadUpdated(ParallelDownloadJob::State state,
+                         int64 received_bytes,
+                         int64 total_bytes) override;
+
+  void Pause();
+  void Resume();
+  void Cancel();
+  bool IsPaused() const;
+  int64 GetReceivedBytes() const;
+  int64 GetTotalBytes() const;
+  const GURL& GetUrl() const;
+  const base::FilePath& GetSavePath() const;
+
+ private:
+  // mate::Wrappable:
+  mate::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+
+  GURL url_;
+  base::FilePath path_;
+  scoped_refptr<ParallelDownloadJob> job_;
+
+  ParallelDownloadJob::State state_;
+  int64 received_bytes_;
+  int64 total_bytes_;
+
+  base::WeakPtrFactory<ParallelDownload> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelDownload);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_ATOM_API_PARALLEL_DOWNLOAD_H_
@@ -8,7 +8,9 @@
 #include "atom/common/node_includes.h"
 #include "base/power_monitor/power_monitor.h"
 #include "base/power_monitor/power_monitor_device_source.h"
+#include "chrome/browser/idle.h"
 #include "native_mate/dictionary.h"
+#include "native_mate/object_template_builder.h"
 
 namespace atom {
 
@@ -16,12 +18,43 @@ namespace api {
 
 PowerMonitor::PowerMonitor() {
   base::PowerMonitor::Get()->AddObserver(this);
+  StartObserving();
 }
 
 PowerMonitor::~PowerMonitor() {
+  StopObserving();
   base::PowerMonitor::Get()->RemoveObserver(this);
 }
 
+bool PowerMonitor::IsOnBatteryPower() {
+  return base::PowerMonitor::Get()->IsOnBatteryPower();
+}
+
+int PowerMonitor::GetSystemIdleTime() {
+  return CalculateIdleTime();
+}
+
+std::string PowerMonitor::GetSystemIdleState(int idle_threshold) {
+  switch (CalculateIdleState(idle_threshold)) {
+    case IDLE_STATE_ACTIVE: return "active";
+    case IDLE_STATE_IDLE: return "idle";
+    case IDLE_STATE_LOCKED: return "locked";
+    default: return "unknown";
+  }
+}
+
+#if !defined(OS_MACOSX)
+std::string PowerMonitor::GetThermalState() {
+  return "unknown";
+}
+
+void PowerMonitor::StartObserving() {
+}
+
+void PowerMonitor::StopObserving() {
+}
+#endif
+
 void PowerMonitor::OnPowerStateChange(bool on_battery_power) {
   if (on_battery_power)
     Emit("on-battery");
@@ -37,6 +70,27 @@ void PowerMonitor::OnResume() {
   Emit("resume");
 }
 
+void PowerMonitor::OnLockScreen() {
+  Emit("lock-screen");
+}
+
+void PowerMonitor::OnUnlockScreen() {
+  Emit("unlock-screen");
+}
+
+void PowerMonitor::OnThermalStateChange() {
+  Emit("thermal-state-change", GetThermalState());
+}
+
+mate::ObjectTemplateBuilder PowerMonitor::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return mate::ObjectTemplateBuilder(isolate)
+      .SetMethod("isOnBatteryPower", &PowerMonitor::IsOnBatteryPower)
+      .SetMethod("getSystemIdleTime", &PowerMonitor::GetSystemIdleTime)
+      .SetMethod("getSystemIdleState", &PowerMonitor::GetSystemIdleState)
+      .SetMethod("getThermalState", &PowerMonitor::GetThermalState);
+}
+
 // static
 v8::Local<v8::Value> PowerMonitor::Create(v8::Isolate* isolate) {
   if (!Browser::Get()->is_ready()) {
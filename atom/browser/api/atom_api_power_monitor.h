@@ -5,11 +5,23 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_POWER_MONITOR_H_
 #define ATOM_BROWSER_API_ATOM_API_POWER_MONITOR_H_
 
+#include <string>
+
 #include "atom/browser/api/event_emitter.h"
 #include "base/compiler_specific.h"
 #include "base/power_monitor/power_observer.h"
 #include "native_mate/handle.h"
 
+#if defined(OS_MACOSX)
+#include "base/mac/scoped_nsobject.h"
+
+#if defined(__OBJC__)
+@class AtomPowerMonitorObserver;
+#else
+class AtomPowerMonitorObserver;
+#endif
+#endif
+
 namespace atom {
 
 namespace api {
@@ -23,12 +35,35 @@ class PowerMonitor : public mate::EventEmitter,
   PowerMonitor();
   virtual ~PowerMonitor();
 
+  bool IsOnBatteryPower();
+  int GetSystemIdleTime();
+  std::string GetSystemIdleState(int idle_threshold);
+  std::string GetThermalState();
+
   // base::PowerObserver implementations:
   void OnPowerStateChange(bool on_battery_power) override;
   void OnSuspend() override;
   void OnResume() override;
 
+  // Called by the platform when the screen is locked or unlocked, and when
+  // the thermal state changes.
+  void OnLockScreen();
+  void OnUnlockScreen();
+  void OnThermalStateChange();
+
+  // mate::Wrappable implementations:
+  mate::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+
  private:
+  // Subscribes to the notifications of the system.
+  void StartObserving();
+  void StopObserving();
+
+#if defined(OS_MACOSX)
+  base::scoped_nsobject<AtomPowerMonitorObserver> observer_;
+#endif
+
   DISALLOW_COPY_AND_ASSIGN(PowerMonitor);
 };
 
@@ -0,0 +1,122 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_power_monitor.h"
+
+#import <Cocoa/Cocoa.h>
+
+#include "chrome/browser/idle.h"
+
+#if !defined(MAC_OS_X_VERSION_10_10_3) || \
+    MAC_OS_X_VERSION_MAX_ALLOWED < MAC_OS_X_VERSION_10_10_3
+@interface NSProcessInfo (ThermalState)
+- (NSInteger)thermalState;
+@end
+#endif
+
+namespace {
+
+// The NSProcessInfoThermalStateDidChangeNotification of OS X 10.10.3.
+NSString* const kThermalStateDidChangeNotification =
+    @"NSProcessInfoThermalStateDidChangeNotification";
+
+}  // namespace
+
+// Forwards the notifications of the system to the PowerMonitor, the thermal
+// state notification can be posted on any thread so it is always handled on
+// the main thread.
+@interface AtomPowerMonitorObserver : NSObject {
+ @private
+  atom::api::PowerMonitor* monitor_;  // weak
+}
+- (id)initWithMonitor:(atom::api::PowerMonitor*)monitor;
+- (void)invalidate;
+@end
+
+@implementation AtomPowerMonitorObserver
+
+- (id)initWithMonitor:(atom::api::PowerMonitor*)monitor {
+  if ((self = [super init])) {
+    monitor_ = monitor;
+
+    NSDistributedNotificationCenter* distCenter =
+        [NSDistributedNotificationCenter defaultCenter];
+    [distCenter addObserver:self
+                   selector:@selector(onScreenLocked:)
+                       name:@"com.apple.screenIsLocked"
+                     object:nil];
+    [distCenter addObserver:self
+                   selector:@selector(onScreenUnlocked:)
+                       name:@"com.apple.screenIsUnlocked"
+                     object:nil];
+
+    [[NSNotificationCenter defaultCenter]
+        addObserver:self
+           selector:@selector(onThermalStateChanged:)
+               name:kThermalStateDidChangeNotification
+             object:nil];
+  }
+  return self;
+}
+
+- (void)invalidate {
+  [[NSDistributedNotificationCenter defaultCenter] removeObserver:self];
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
+  monitor_ = nullptr;
+}
+
+- (void)onScreenLocked:(NSNotification*)notification {
+  if (monitor_)
+    monitor_->OnLockScreen();
+}
+
+- (void)onScreenUnlocked:(NSNotification*)notification {
+  if (monitor_)
+    monitor_->OnUnlockScreen();
+}
+
+- (void)onThermalStateChanged:(NSNotification*)notification {
+  [self performSelectorOnMainThread:@selector(thermalStateChanged)
+                         withObject:nil
+                      waitUntilDone:NO];
+}
+
+- (void)thermalStateChanged {
+  if (monitor_)
+    monitor_->OnThermalStateChange();
+}
+
+@end
+
+namespace atom {
+
+namespace api {
+
+std::string PowerMonitor::GetThermalState() {
+  NSProcessInfo* process_info = [NSProcessInfo processInfo];
+  if (![process_info respondsToSelector:@selector(thermalState)])
+    return "unknown";
+
+  switch ([process_info thermalState]) {
+    case 0: return "nominal";
+    case 1: return "fair";
+    case 2: return "serious";
+    case 3: return "critical";
+    default: return "unknown";
+  }
+}
+
+void PowerMonitor::StartObserving() {
+  InitIdleMonitor();
+  observer_.reset([[AtomPowerMonitorObserver alloc] initWithMonitor:this]);
+}
+
+void PowerMonitor::StopObserving() {
+  [observer_ invalidate];
+  observer_.reset();
+}
+
+}  // namespace api
+
+}  // namespace atom
@@ -7,12 +7,15 @@
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/atom_browser_main_parts.h"
+#include "atom/browser/net/protocol_stats.h"
 #include "atom/browser/net/url_request_async_asar_job.h"
 #include "atom/browser/net/url_request_buffer_job.h"
 #include "atom/browser/net/url_request_fetch_job.h"
+#include "atom/browser/net/url_request_stream_job.h"
 #include "atom/browser/net/url_request_string_job.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/content_converter.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/node_includes.h"
 #include "native_mate/dictionary.h"
 
@@ -40,8 +43,12 @@ mate::ObjectTemplateBuilder Protocol::GetObjectTemplateBuilder(
                  &Protocol::RegisterProtocol<UrlRequestAsyncAsarJob>)
       .SetMethod("registerHttpProtocol",
                  &Protocol::RegisterProtocol<URLRequestFetchJob>)
+      .SetMethod("_registerStreamProtocol",
+                 &Protocol::RegisterProtocol<URLRequestStreamJob>)
       .SetMethod("unregisterProtocol", &Protocol::UnregisterProtocol)
       .SetMethod("isProtocolHandled", &Protocol::IsProtocolHandled)
+      .SetMethod("setRoutes", &Protocol::SetRoutes)
+      .SetMethod("getStats", &Protocol::GetStats)
       .SetMethod("interceptStringProtocol",
                  &Protocol::InterceptProtocol<URLRequestStringJob>)
       .SetMethod("interceptBufferProtocol",
@@ -50,6 +57,8 @@ mate::ObjectTemplateBuilder Protocol::GetObjectTemplateBuilder(
                  &Protocol::InterceptProtocol<UrlRequestAsyncAsarJob>)
       .SetMethod("interceptHttpProtocol",
                  &Protocol::InterceptProtocol<URLRequestFetchJob>)
+      .SetMethod("_interceptStreamProtocol",
+                 &Protocol::InterceptProtocol<URLRequestStreamJob>)
       .SetMethod("uninterceptProtocol", &Protocol::UninterceptProtocol);
 }
 
@@ -91,6 +100,72 @@ bool Protocol::IsProtocolHandledInIO(const std::string& scheme) {
   return job_factory_->IsHandledProtocol(scheme);
 }
 
+void Protocol::SetRoutes(const std::string& scheme, mate::Arguments* args) {
+  std::vector<mate::Dictionary> dicts;
+  if (!args->GetNext(&dicts)) {
+    args->ThrowError("Must pass an array of routes");
+    return;
+  }
+
+  AtomURLRequestJobFactory::Routes routes;
+  for (const mate::Dictionary& dict : dicts) {
+    AtomURLRequestJobFactory::Route route;
+    v8::Local<v8::Value> data;
+    if (!dict.Get("prefix", &route.prefix) || route.prefix.empty()) {
+      args->ThrowError("Route must have a prefix");
+      return;
+    }
+    if (dict.Get("data", &data)) {
+      std::string string;
+      if (node::Buffer::HasInstance(data)) {
+        route.data = new base::RefCountedBytes(
+            reinterpret_cast<unsigned char*>(node::Buffer::Data(data)),
+            node::Buffer::Length(data));
+      } else if (mate::ConvertFromV8(isolate(), data, &string)) {
+        route.data = base::RefCountedString::TakeString(&string);
+      } else {
+        args->ThrowError("Route data must be a String or Buffer");
+        return;
+      }
+      dict.Get("mimeType", &route.mime_type);
+      dict.Get("charset", &route.charset);
+    } else if (!dict.Get("directory", &route.directory)) {
+      args->ThrowError("Route must have a directory or data");
+      return;
+    }
+    routes.push_back(route);
+  }
+
+  CompletionCallback callback;
+  args->GetNext(&callback);
+  content::BrowserThread::PostTaskAndReplyWithResult(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&Protocol::SetRoutesInIO,
+                 base::Unretained(this), scheme, routes),
+      base::Bind(&Protocol::OnIOCompleted,
+                 base::Unretained(this), callback));
+}
+
+Protocol::ProtocolError Protocol::SetRoutesInIO(
+    const std::string& scheme,
+    const AtomURLRequestJobFactory::Routes& routes) {
+  if (!job_factory_->HasProtocolHandler(scheme))
+    return PROTOCOL_NOT_REGISTERED;
+  job_factory_->SetRoutes(scheme, routes);
+  return PROTOCOL_OK;
+}
+
+v8::Local<v8::Value> Protocol::GetStats(mate::Arguments* args) {
+  bool reset = false;
+  args->GetNext(&reset);
+
+  ProtocolStats* stats = ProtocolStats::GetInstance();
+  scoped_ptr<base::DictionaryValue> value = stats->ToValue();
+  if (reset)
+    stats->Reset();
+  return mate::ConvertToV8(args->isolate(), *value);
+}
+
 void Protocol::UninterceptProtocol(
     const std::string& scheme, mate::Arguments* args) {
   CompletionCallback callback;
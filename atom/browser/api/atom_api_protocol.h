@@ -67,9 +67,11 @@ class Protocol : public mate::Wrappable {
     CustomProtocolHandler(
         v8::Isolate* isolate,
         net::URLRequestContextGetter* request_context,
+        ProtocolResponseCache* response_cache,
         const Handler& handler)
         : isolate_(isolate),
           request_context_(request_context),
+          response_cache_(response_cache),
           handler_(handler) {}
     ~CustomProtocolHandler() override {}
 
@@ -77,13 +79,15 @@ class Protocol : public mate::Wrappable {
         net::URLRequest* request,
         net::NetworkDelegate* network_delegate) const override {
       RequestJob* request_job = new RequestJob(request, network_delegate);
-      request_job->SetHandlerInfo(isolate_, request_context_, handler_);
+      request_job->SetHandlerInfo(
+          isolate_, request_context_, response_cache_, handler_);
       return request_job;
     }
 
    private:
     v8::Isolate* isolate_;
     net::URLRequestContextGetter* request_context_;
+    ProtocolResponseCache* response_cache_;
     Protocol::Handler handler_;
 
     DISALLOW_COPY_AND_ASSIGN(CustomProtocolHandler);
@@ -113,7 +117,8 @@ class Protocol : public mate::Wrappable {
       return PROTOCOL_REGISTERED;
     scoped_ptr<CustomProtocolHandler<RequestJob>> protocol_handler(
         new CustomProtocolHandler<RequestJob>(
-            isolate(), request_context_getter_, handler));
+            isolate(), request_context_getter_,
+            job_factory_->response_cache(), handler));
     if (job_factory_->SetProtocolHandler(scheme, protocol_handler.Pass()))
       return PROTOCOL_OK;
     else
@@ -129,6 +134,14 @@ class Protocol : public mate::Wrappable {
                          const BooleanCallback& callback);
   bool IsProtocolHandledInIO(const std::string& scheme);
 
+  // Serve the URLs matching the routes without calling the handler.
+  void SetRoutes(const std::string& scheme, mate::Arguments* args);
+  ProtocolError SetRoutesInIO(const std::string& scheme,
+                              const AtomURLRequestJobFactory::Routes& routes);
+
+  // Returns the counters of the requests of each scheme.
+  v8::Local<v8::Value> GetStats(mate::Arguments* args);
+
   // Replace the protocol handler with a new one.
   template<typename RequestJob>
   void InterceptProtocol(const std::string& scheme,
@@ -155,7 +168,8 @@ class Protocol : public mate::Wrappable {
       return PROTOCOL_INTERCEPTED;
     scoped_ptr<CustomProtocolHandler<RequestJob>> protocol_handler(
         new CustomProtocolHandler<RequestJob>(
-            isolate(), request_context_getter_, handler));
+            isolate(), request_context_getter_,
+            job_factory_->response_cache(), handler));
     original_protocols_.set(
         scheme,
         job_factory_->ReplaceProtocol(scheme, protocol_handler.Pass()));
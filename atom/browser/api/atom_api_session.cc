@@ -4,11 +4,14 @@
 
 #include "atom/browser/api/atom_api_session.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
 #include "atom/browser/api/atom_api_cookies.h"
 #include "atom/browser/api/atom_api_download_item.h"
+#include "atom/browser/api/atom_api_net_log.h"
+#include "atom/browser/api/atom_api_parallel_download.h"
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/api/atom_api_web_contents.h"
 #include "atom/browser/api/save_page_handler.h"
@@ -18,6 +21,7 @@
 #include "atom/common/node_includes.h"
 #include "base/files/file_path.h"
 #include "base/prefs/pref_service.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/thread_task_runner_handle.h"
 #include "brightray/browser/net/devtools_network_conditions.h"
@@ -27,10 +31,17 @@
 #include "content/public/browser/storage_partition.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
+#include "net/base/address_list.h"
 #include "net/base/load_flags.h"
 #include "net/disk_cache/disk_cache.h"
+#include "net/dns/host_resolver.h"
+#include "net/http/http_network_session.h"
+#include "net/http/http_request_info.h"
+#include "net/http/http_stream_factory.h"
+#include "net/http/http_transaction_factory.h"
 #include "net/proxy/proxy_service.h"
 #include "net/proxy/proxy_config_service_fixed.h"
+#include "net/ssl/ssl_config_service.h"
 #include "net/url_request/url_request_context.h"
 #include "net/url_request/url_request_context_getter.h"
 
@@ -39,32 +50,41 @@ using content::StoragePartition;
 
 namespace {
 
+// Called with the name of the storage that has been cleared, and how many of
+// the storages have been cleared out of all of them.
+using ClearStorageDataProgress = base::Callback<void(std::string, int, int)>;
+
 struct ClearStorageDataOptions {
   GURL origin;
   uint32 storage_types = StoragePartition::REMOVE_DATA_MASK_ALL;
   uint32 quota_types = StoragePartition::QUOTA_MANAGED_STORAGE_MASK_ALL;
+  ClearStorageDataProgress progress;
+};
+
+// The storages in the order they are cleared, the cheap ones come first.
+const struct {
+  const char* name;
+  uint32 mask;
+} kStorageTypes[] = {
+  { "cookies", StoragePartition::REMOVE_DATA_MASK_COOKIES },
+  { "localstorage", StoragePartition::REMOVE_DATA_MASK_LOCAL_STORAGE },
+  { "websql", StoragePartition::REMOVE_DATA_MASK_WEBSQL },
+  { "appcache", StoragePartition::REMOVE_DATA_MASK_APPCACHE },
+  { "serviceworkers", StoragePartition::REMOVE_DATA_MASK_SERVICE_WORKERS },
+  { "shadercache", StoragePartition::REMOVE_DATA_MASK_SHADER_CACHE },
+  { "filesystem", StoragePartition::REMOVE_DATA_MASK_FILE_SYSTEMS },
+  { "indexdb", StoragePartition::REMOVE_DATA_MASK_INDEXEDDB },
+  { "webrtcidentity", StoragePartition::REMOVE_DATA_MASK_WEBRTC_IDENTITY },
 };
 
 uint32 GetStorageMask(const std::vector<std::string>& storage_types) {
   uint32 storage_mask = 0;
   for (const auto& it : storage_types) {
     auto type = base::StringToLowerASCII(it);
-    if (type == "appcache")
-      storage_mask |= StoragePartition::REMOVE_DATA_MASK_APPCACHE;
-    else if (type == "cookies")
-      storage_mask |= StoragePartition::REMOVE_DATA_MASK_COOKIES;
-    else if (type == "filesystem")
-      storage_mask |= StoragePartition::REMOVE_DATA_MASK_FILE_SYSTEMS;
-    else if (type == "indexdb")
-      storage_mask |= StoragePartition::REMOVE_DATA_MASK_INDEXEDDB;
-    else if (type == "localstorage")
-      storage_mask |= StoragePartition::REMOVE_DATA_MASK_LOCAL_STORAGE;
-    else if (type == "shadercache")
-      storage_mask |= StoragePartition::REMOVE_DATA_MASK_SHADER_CACHE;
-    else if (type == "websql")
-      storage_mask |= StoragePartition::REMOVE_DATA_MASK_WEBSQL;
-    else if (type == "serviceworkers")
-      storage_mask |= StoragePartition::REMOVE_DATA_MASK_SERVICE_WORKERS;
+    for (const auto& storage : kStorageTypes) {
+      if (type == storage.name)
+        storage_mask |= storage.mask;
+    }
   }
   return storage_mask;
 }
@@ -101,6 +121,27 @@ struct Converter<ClearStorageDataOptions> {
       out->storage_types = GetStorageMask(types);
     if (options.Get("quotas", &types))
       out->quota_types = GetQuotaMask(types);
+    options.Get("progress", &out->progress);
+    return true;
+  }
+};
+
+template<>
+struct Converter<atom::AuthCache::Scope> {
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     atom::AuthCache::Scope* out) {
+    std::string scope;
+    if (!ConvertFromV8(isolate, val, &scope))
+      return false;
+    if (scope == "none")
+      *out = atom::AuthCache::SCOPE_NONE;
+    else if (scope == "realm")
+      *out = atom::AuthCache::SCOPE_REALM;
+    else if (scope == "host")
+      *out = atom::AuthCache::SCOPE_HOST;
+    else
+      return false;
     return true;
   }
 };
@@ -135,59 +176,107 @@ namespace {
 using WrapSessionCallback = base::Callback<void(v8::Local<v8::Value>)>;
 WrapSessionCallback g_wrap_session;
 
+// Resolves the proxies of a list of URLs in one task on the IO thread, the
+// results that are still fresh in the session's cache are reused.
 class ResolveProxyHelper {
  public:
   ResolveProxyHelper(AtomBrowserContext* browser_context,
-                     const GURL& url,
-                     Session::ResolveProxyCallback callback)
+                     const std::vector<GURL>& urls,
+                     const Session::ResolveProxiesCallback& callback)
       : callback_(callback),
+        cache_(browser_context->proxy_result_cache()),
+        requests_(urls.size()),
+        pending_(urls.size()),
         original_thread_(base::ThreadTaskRunnerHandle::Get()) {
+    for (size_t i = 0; i < urls.size(); ++i)
+      requests_[i].url = urls[i];
     scoped_refptr<net::URLRequestContextGetter> context_getter =
         browser_context->GetRequestContext();
     context_getter->GetNetworkTaskRunner()->PostTask(
         FROM_HERE,
-        base::Bind(&ResolveProxyHelper::ResolveProxy,
-                   base::Unretained(this), context_getter, url));
+        base::Bind(&ResolveProxyHelper::ResolveProxies,
+                   base::Unretained(this), context_getter));
   }
 
-  void OnResolveProxyCompleted(int result) {
+  void OnResolveProxyCompleted(size_t index, int result) {
+    Request& request = requests_[index];
+    if (result == net::OK) {
+      request.proxy = request.proxy_info.ToPacString();
+      cache_->Put(request.url, request.proxy);
+    }
+    OnRequestDone();
+  }
+
+ private:
+  struct Request {
+    GURL url;
     std::string proxy;
-    if (result == net::OK)
-      proxy = proxy_info_.ToPacString();
+    net::ProxyInfo proxy_info;
+    net::ProxyService::PacRequest* pac_req;
+  };
+
+  void OnRequestDone() {
+    if (pending_ > 0 && --pending_ > 0)
+      return;
+
+    std::vector<std::string> proxies;
+    for (const Request& request : requests_)
+      proxies.push_back(request.proxy);
     original_thread_->PostTask(FROM_HERE,
-                               base::Bind(callback_, proxy));
+                               base::Bind(callback_, proxies));
     delete this;
   }
 
- private:
-  void ResolveProxy(scoped_refptr<net::URLRequestContextGetter> context_getter,
-                    const GURL& url) {
+  void ResolveProxies(
+      scoped_refptr<net::URLRequestContextGetter> context_getter) {
     DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
 
+    if (requests_.empty()) {
+      OnRequestDone();
+      return;
+    }
+
     net::ProxyService* proxy_service =
         context_getter->GetURLRequestContext()->proxy_service();
-    net::CompletionCallback completion_callback =
-        base::Bind(&ResolveProxyHelper::OnResolveProxyCompleted,
-                   base::Unretained(this));
-
-    // Start the request.
-    int result = proxy_service->ResolveProxy(
-        url, net::LOAD_NORMAL, &proxy_info_, completion_callback,
-        &pac_req_, nullptr, net::BoundNetLog());
-
-    // Completed synchronously.
-    if (result != net::ERR_IO_PENDING)
-      completion_callback.Run(result);
+    // The last completion deletes |this|, so the size is read up front.
+    size_t size = requests_.size();
+    for (size_t i = 0; i < size; ++i) {
+      Request& request = requests_[i];
+      if (cache_->Get(request.url, &request.proxy)) {
+        OnRequestDone();
+        continue;
+      }
+
+      net::CompletionCallback completion_callback =
+          base::Bind(&ResolveProxyHelper::OnResolveProxyCompleted,
+                     base::Unretained(this), i);
+
+      // Start the request.
+      int result = proxy_service->ResolveProxy(
+          request.url, net::LOAD_NORMAL, &request.proxy_info,
+          completion_callback, &request.pac_req, nullptr, net::BoundNetLog());
+
+      // Completed synchronously.
+      if (result != net::ERR_IO_PENDING)
+        completion_callback.Run(result);
+    }
   }
 
-  Session::ResolveProxyCallback callback_;
-  net::ProxyInfo proxy_info_;
-  net::ProxyService::PacRequest* pac_req_;
+  Session::ResolveProxiesCallback callback_;
+  scoped_refptr<ProxyResultCache> cache_;
+  std::vector<Request> requests_;
+  size_t pending_;
   scoped_refptr<base::SingleThreadTaskRunner> original_thread_;
 
   DISALLOW_COPY_AND_ASSIGN(ResolveProxyHelper);
 };
 
+// Passes the only result of a ResolveProxyHelper to |callback|.
+void OnResolveSingleProxy(const Session::ResolveProxyCallback& callback,
+                          const std::vector<std::string>& proxies) {
+  callback.Run(proxies.empty() ? std::string() : proxies[0]);
+}
+
 // Runs the callback in UI thread.
 template <typename ...T>
 void RunCallbackInUI(const base::Callback<void(T...)>& callback, T... result) {
@@ -226,9 +315,76 @@ void ClearHttpCacheInIO(
     on_get_backend.Run(net::OK);
 }
 
+// Clears the storages one after another instead of all of them at once, so
+// the disk is not saturated by all the backends deleting at the same time and
+// the main thread gets to run between the storages.
+class StorageDataClearer {
+ public:
+  StorageDataClearer(AtomBrowserContext* browser_context,
+                     const ClearStorageDataOptions& options,
+                     const base::Closure& callback)
+      : browser_context_(browser_context),
+        options_(options),
+        callback_(callback),
+        next_(0),
+        cleared_(0),
+        total_(0) {
+    for (const auto& storage : kStorageTypes) {
+      if (options_.storage_types & storage.mask)
+        ++total_;
+    }
+    ClearNext();
+  }
+
+ private:
+  void ClearNext() {
+    while (next_ < arraysize(kStorageTypes) &&
+           !(options_.storage_types & kStorageTypes[next_].mask))
+      ++next_;
+
+    if (next_ == arraysize(kStorageTypes)) {
+      callback_.Run();
+      delete this;
+      return;
+    }
+
+    auto storage_partition = content::BrowserContext::GetStoragePartition(
+        browser_context_.get(), nullptr);
+    storage_partition->ClearData(
+        kStorageTypes[next_].mask, options_.quota_types, options_.origin,
+        StoragePartition::OriginMatcherFunction(),
+        base::Time(), base::Time::Max(),
+        base::Bind(&StorageDataClearer::OnCleared, base::Unretained(this)));
+  }
+
+  void OnCleared() {
+    ++cleared_;
+    if (!options_.progress.is_null())
+      options_.progress.Run(kStorageTypes[next_].name, cleared_, total_);
+    ++next_;
+
+    // Let the pending tasks of the main thread run before the next storage.
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE,
+        base::Bind(&StorageDataClearer::ClearNext, base::Unretained(this)));
+  }
+
+  scoped_refptr<AtomBrowserContext> browser_context_;
+  ClearStorageDataOptions options_;
+  base::Closure callback_;
+
+  size_t next_;
+  int cleared_;
+  int total_;
+
+  DISALLOW_COPY_AND_ASSIGN(StorageDataClearer);
+};
+
 void SetProxyInIO(net::URLRequestContextGetter* getter,
+                  scoped_refptr<ProxyResultCache> proxy_result_cache,
                   const net::ProxyConfig& config,
                   const base::Closure& callback) {
+  proxy_result_cache->Clear();
   auto proxy_service = getter->GetURLRequestContext()->proxy_service();
   proxy_service->ResetConfigService(new net::ProxyConfigServiceFixed(config));
   // Refetches and applies the new pac script if provided.
@@ -236,6 +392,58 @@ void SetProxyInIO(net::URLRequestContextGetter* getter,
   RunCallbackInUI(callback);
 }
 
+void ClearAuthCacheInIO(scoped_refptr<AuthCache> auth_cache,
+                        const base::Closure& callback) {
+  auth_cache->Clear();
+  if (!callback.is_null())
+    RunCallbackInUI(callback);
+}
+
+void PreconnectInIO(
+    const scoped_refptr<net::URLRequestContextGetter>& context_getter,
+    const GURL& url,
+    const std::string& user_agent,
+    int num_sockets) {
+  auto request_context = context_getter->GetURLRequestContext();
+  auto session = request_context->http_transaction_factory()->GetSession();
+  if (!session)
+    return;
+
+  net::HttpRequestInfo request_info;
+  request_info.url = url;
+  request_info.method = "GET";
+  request_info.extra_headers.SetHeader(net::HttpRequestHeaders::kUserAgent,
+                                       user_agent);
+  request_info.motivation = net::HttpRequestInfo::PRECONNECT_MOTIVATED;
+
+  net::SSLConfig ssl_config;
+  request_context->ssl_config_service()->GetSSLConfig(&ssl_config);
+  session->http_stream_factory()->PreconnectStreams(
+      num_sockets, request_info, ssl_config, ssl_config);
+}
+
+void OnDNSPrefetched(net::AddressList* addresses, int result) {
+}
+
+void PrefetchDNSInIO(
+    const scoped_refptr<net::URLRequestContextGetter>& context_getter,
+    const std::vector<std::string>& hosts) {
+  auto host_resolver = context_getter->GetURLRequestContext()->host_resolver();
+  for (const std::string& host : hosts) {
+    net::HostResolver::RequestInfo request_info(net::HostPortPair(host, 80));
+    request_info.set_is_speculative(true);
+
+    // The results are only wanted in the host cache, the list is kept alive
+    // by the callback until the resolution finishes.
+    net::AddressList* addresses = new net::AddressList;
+    net::HostResolver::RequestHandle request;
+    host_resolver->Resolve(
+        request_info, net::IDLE, addresses,
+        base::Bind(&OnDNSPrefetched, base::Owned(addresses)), &request,
+        net::BoundNetLog());
+  }
+}
+
 }  // namespace
 
 Session::Session(AtomBrowserContext* browser_context)
@@ -277,7 +485,13 @@ void Session::Destroy() {
 }
 
 void Session::ResolveProxy(const GURL& url, ResolveProxyCallback callback) {
-  new ResolveProxyHelper(browser_context(), url, callback);
+  new ResolveProxyHelper(browser_context(), std::vector<GURL>(1, url),
+                         base::Bind(&OnResolveSingleProxy, callback));
+}
+
+void Session::ResolveProxies(const std::vector<GURL>& urls,
+                             const ResolveProxiesCallback& callback) {
+  new ResolveProxyHelper(browser_context(), urls, callback);
 }
 
 void Session::ClearCache(const net::CompletionCallback& callback) {
@@ -297,19 +511,31 @@ void Session::ClearStorageData(mate::Arguments* args) {
     return;
   }
 
-  auto storage_partition =
-      content::BrowserContext::GetStoragePartition(browser_context(), nullptr);
-  storage_partition->ClearData(
-      options.storage_types, options.quota_types, options.origin,
-      content::StoragePartition::OriginMatcherFunction(),
-      base::Time(), base::Time::Max(), callback);
+  new StorageDataClearer(browser_context(), options, callback);
 }
 
 void Session::SetProxy(const net::ProxyConfig& config,
                        const base::Closure& callback) {
   auto getter = browser_context_->GetRequestContext();
   BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
-      base::Bind(&SetProxyInIO, base::Unretained(getter), config, callback));
+      base::Bind(&SetProxyInIO, base::Unretained(getter),
+                 make_scoped_refptr(browser_context_->proxy_result_cache()),
+                 config, callback));
+}
+
+void Session::SetAuthCacheScope(AuthCache::Scope scope) {
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&AuthCache::SetScope,
+                 make_scoped_refptr(browser_context_->auth_cache()), scope));
+}
+
+void Session::ClearAuthCache(mate::Arguments* args) {
+  base::Closure callback;
+  args->GetNext(&callback);
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&ClearAuthCacheInIO,
+                 make_scoped_refptr(browser_context_->auth_cache()),
+                 callback));
 }
 
 void Session::SetDownloadPath(const base::FilePath& path) {
@@ -320,7 +546,7 @@ void Session::SetDownloadPath(const base::FilePath& path) {
 void Session::EnableNetworkEmulation(const mate::Dictionary& options) {
   scoped_ptr<brightray::DevToolsNetworkConditions> conditions;
   bool offline = false;
-  double latency, download_throughput, upload_throughput;
+  double latency = 0, download_throughput = 0, upload_throughput = 0;
   if (options.Get("offline", &offline) && offline) {
     conditions.reset(new brightray::DevToolsNetworkConditions(offline));
   } else {
@@ -333,25 +559,140 @@ void Session::EnableNetworkEmulation(const mate::Dictionary& options) {
                                                  download_throughput,
                                                  upload_throughput));
   }
-  auto controller = browser_context_->GetDevToolsNetworkController();
 
+  NetworkEmulationRules::Rule rule;
+  double jitter = 0;
+  options.Get("hosts", &rule.hosts);
+  options.Get("packetLoss", &rule.packet_loss);
+  if (options.Get("jitter", &jitter))
+    rule.jitter = base::TimeDelta::FromMillisecondsD(jitter);
+
+  // The conditions for all hosts of the session use the empty client id, so
+  // the DevToolsNetworkController applies them to the requests no other rule
+  // matches.
+  WebContents* web_contents = nullptr;
+  std::string client_id;
+  if (options.Get("webContents", &web_contents) && web_contents)
+    client_id = "webcontents-" +
+                base::IntToString(web_contents->weak_map_id());
+  else if (!rule.hosts.empty())
+    client_id = "hosts-" + JoinString(rule.hosts, ',');
+
+  auto rules = browser_context_->network_emulation_rules();
+  rules->SetRule(client_id, rule, web_contents != nullptr);
+  if (web_contents)
+    web_contents->SetNetworkEmulationClientId(client_id);
+
+  SetNetworkConditions(client_id, conditions.Pass());
+}
+
+void Session::DisableNetworkEmulation(mate::Arguments* args) {
+  // disableNetworkEmulation([webContents])
+  auto rules = browser_context_->network_emulation_rules();
+  WebContents* web_contents = nullptr;
+  if (args->GetNext(&web_contents) && web_contents) {
+    std::string client_id = web_contents->network_emulation_client_id();
+    if (client_id.empty())
+      return;
+    web_contents->SetNetworkEmulationClientId(std::string());
+    rules->RemoveRule(client_id);
+    SetNetworkConditions(client_id, make_scoped_ptr(
+        new brightray::DevToolsNetworkConditions(false)));
+    return;
+  }
+
+  // The rules pinned to webContents are only removed with their webContents.
+  // The conditions for all hosts are always reset.
+  std::vector<std::string> client_ids = rules->RemoveUnpinnedRules();
+  if (std::find(client_ids.begin(), client_ids.end(), std::string()) ==
+          client_ids.end())
+    client_ids.push_back(std::string());
+  for (const auto& client_id : client_ids)
+    SetNetworkConditions(client_id, make_scoped_ptr(
+        new brightray::DevToolsNetworkConditions(false)));
+}
+
+void Session::SetNetworkConditions(
+    const std::string& client_id,
+    scoped_ptr<brightray::DevToolsNetworkConditions> conditions) {
+  auto controller = browser_context_->GetDevToolsNetworkController();
   BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
       base::Bind(&brightray::DevToolsNetworkController::SetNetworkState,
                  base::Unretained(controller),
-                 std::string(),
+                 client_id,
                  base::Passed(&conditions)));
 }
 
-void Session::DisableNetworkEmulation() {
-  scoped_ptr<brightray::DevToolsNetworkConditions> conditions(
-      new brightray::DevToolsNetworkConditions(false));
-  auto controller = browser_context_->GetDevToolsNetworkController();
+v8::Local<v8::Value> Session::GetNetworkEmulationStats(mate::Arguments* args) {
+  bool reset = false;
+  args->GetNext(&reset);
+
+  auto rules = browser_context_->network_emulation_rules();
+  int64 throttled, dropped;
+  rules->GetStats(&throttled, &dropped);
+  if (reset)
+    rules->ResetStats();
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(args->isolate());
+  dict.Set("throttledRequests", static_cast<double>(throttled));
+  dict.Set("droppedRequests", static_cast<double>(dropped));
+  return dict.GetHandle();
+}
+
+void Session::Preconnect(const GURL& url, mate::Arguments* args) {
+  if (!url.is_valid()) {
+    args->ThrowError("Url is not valid");
+    return;
+  }
+
+  int num_sockets = 1;
+  mate::Dictionary options;
+  if (args->GetNext(&options))
+    options.Get("numSockets", &num_sockets);
+  if (num_sockets < 1)
+    return;
 
   BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
-      base::Bind(&brightray::DevToolsNetworkController::SetNetworkState,
-                 base::Unretained(controller),
-                 std::string(),
-                 base::Passed(&conditions)));
+      base::Bind(&PreconnectInIO,
+                 make_scoped_refptr(browser_context_->GetRequestContext()),
+                 url, browser_context_->GetUserAgent(), num_sockets));
+}
+
+mate::Handle<ParallelDownload> Session::DownloadURL(
+    const GURL& url, const mate::Dictionary& options, mate::Arguments* args) {
+  base::FilePath path;
+  if (!url.is_valid() || !options.Get("savePath", &path)) {
+    args->ThrowError("A valid url and the savePath are required");
+    return mate::Handle<ParallelDownload>();
+  }
+
+  int segments = 4;
+  options.Get("segments", &segments);
+  return ParallelDownload::Create(args->isolate(), browser_context(), url,
+                                  path, segments);
+}
+
+void Session::PrefetchDNS(const std::vector<std::string>& hosts) {
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&PrefetchDNSInIO,
+                 make_scoped_refptr(browser_context_->GetRequestContext()),
+                 hosts));
+}
+
+v8::Local<v8::Value> Session::GetCacheStats(mate::Arguments* args) {
+  bool reset = false;
+  args->GetNext(&reset);
+
+  HttpCacheStats* stats = browser_context_->http_cache_stats();
+  int64 hits, misses;
+  stats->Get(&hits, &misses);
+  if (reset)
+    stats->Reset();
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(args->isolate());
+  dict.Set("hits", static_cast<double>(hits));
+  dict.Set("misses", static_cast<double>(misses));
+  return dict.GetHandle();
 }
 
 v8::Local<v8::Value> Session::Cookies(v8::Isolate* isolate) {
@@ -362,17 +703,35 @@ v8::Local<v8::Value> Session::Cookies(v8::Isolate* isolate) {
   return v8::Local<v8::Value>::New(isolate, cookies_);
 }
 
+v8::Local<v8::Value> Session::NetLog(v8::Isolate* isolate) {
+  if (net_log_.IsEmpty()) {
+    auto handle = atom::api::NetLog::Create(isolate, browser_context());
+    net_log_.Reset(isolate, handle.ToV8());
+  }
+  return v8::Local<v8::Value>::New(isolate, net_log_);
+}
+
 mate::ObjectTemplateBuilder Session::GetObjectTemplateBuilder(
     v8::Isolate* isolate) {
   return mate::ObjectTemplateBuilder(isolate)
       .SetMethod("resolveProxy", &Session::ResolveProxy)
+      .SetMethod("resolveProxies", &Session::ResolveProxies)
       .SetMethod("clearCache", &Session::ClearCache)
       .SetMethod("clearStorageData", &Session::ClearStorageData)
       .SetMethod("setProxy", &Session::SetProxy)
+      .SetMethod("setAuthCacheScope", &Session::SetAuthCacheScope)
+      .SetMethod("clearAuthCache", &Session::ClearAuthCache)
       .SetMethod("setDownloadPath", &Session::SetDownloadPath)
       .SetMethod("enableNetworkEmulation", &Session::EnableNetworkEmulation)
       .SetMethod("disableNetworkEmulation", &Session::DisableNetworkEmulation)
-      .SetProperty("cookies", &Session::Cookies);
+      .SetMethod("getNetworkEmulationStats",
+                 &Session::GetNetworkEmulationStats)
+      .SetMethod("getCacheStats", &Session::GetCacheStats)
+      .SetMethod("preconnect", &Session::Preconnect)
+      .SetMethod("prefetchDNS", &Session::PrefetchDNS)
+      .SetMethod("_downloadURL", &Session::DownloadURL)
+      .SetProperty("cookies", &Session::Cookies)
+      .SetProperty("netLog", &Session::NetLog);
 }
 
 // static
@@ -395,6 +754,51 @@ mate::Handle<Session> Session::FromPartition(
                     static_cast<AtomBrowserContext*>(browser_context.get()));
 }
 
+// static
+mate::Handle<Session> Session::FromPartitionWithOptions(
+    const std::string& partition, bool in_memory, mate::Arguments* args) {
+  scoped_refptr<AtomBrowserContext> browser_context =
+      static_cast<AtomBrowserContext*>(
+          brightray::BrowserContext::From(partition, in_memory).get());
+
+  mate::Dictionary options, cache;
+  if (!args->GetNext(&options))
+    return CreateFrom(args->isolate(), browser_context.get());
+
+  Session* base = nullptr;
+  if (options.Get("base", &base) &&
+      base->browser_context() != browser_context->base_context()) {
+    if (!browser_context->SetBaseContext(base->browser_context())) {
+      args->ThrowError("The base of a session that has been used can not be "
+                       "changed");
+      return mate::Handle<Session>();
+    }
+  }
+
+  if (options.Get("cache", &cache)) {
+    AtomBrowserContext::HttpCacheOptions cache_options;
+    std::string type;
+    if (cache.Get("type", &type)) {
+      if (type == "memory") {
+        cache_options.type = AtomBrowserContext::HttpCacheOptions::TYPE_MEMORY;
+      } else if (type == "none") {
+        cache_options.type = AtomBrowserContext::HttpCacheOptions::TYPE_NONE;
+      } else if (type != "disk") {
+        args->ThrowError("Unknown cache type " + type);
+        return mate::Handle<Session>();
+      }
+    }
+    cache.Get("maxSize", &cache_options.max_size);
+    if (!browser_context->SetHttpCacheOptions(cache_options)) {
+      args->ThrowError("The cache of a session that has been used can not be "
+                       "changed");
+      return mate::Handle<Session>();
+    }
+  }
+
+  return CreateFrom(args->isolate(), browser_context.get());
+}
+
 void SetWrapSession(const WrapSessionCallback& callback) {
   g_wrap_session = callback;
 }
@@ -413,7 +817,8 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   v8::Isolate* isolate = context->GetIsolate();
   mate::Dictionary dict(isolate, exports);
-  dict.SetMethod("fromPartition", &atom::api::Session::FromPartition);
+  dict.SetMethod("fromPartition",
+                 &atom::api::Session::FromPartitionWithOptions);
   dict.SetMethod("_setWrapSession", &atom::api::SetWrapSession);
   dict.SetMethod("_clearWrapSession", &atom::api::ClearWrapSession);
 }
@@ -6,8 +6,11 @@
 #define ATOM_BROWSER_API_ATOM_API_SESSION_H_
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
+#include "atom/browser/net/auth_cache.h"
+#include "base/memory/scoped_ptr.h"
 #include "content/public/browser/download_manager.h"
 #include "native_mate/handle.h"
 #include "net/base/completion_callback.h"
@@ -18,6 +21,10 @@ namespace base {
 class FilePath;
 }
 
+namespace brightray {
+class DevToolsNetworkConditions;
+}
+
 namespace mate {
 class Arguments;
 class Dictionary;
@@ -33,10 +40,14 @@ class AtomBrowserContext;
 
 namespace api {
 
+class ParallelDownload;
+
 class Session: public mate::TrackableObject<Session>,
                public content::DownloadManager::Observer {
  public:
   using ResolveProxyCallback = base::Callback<void(std::string)>;
+  using ResolveProxiesCallback =
+      base::Callback<void(std::vector<std::string>)>;
 
   // Gets or creates Session from the |browser_context|.
   static mate::Handle<Session> CreateFrom(
@@ -46,6 +57,10 @@ class Session: public mate::TrackableObject<Session>,
   static mate::Handle<Session> FromPartition(
       v8::Isolate* isolate, const std::string& partition, bool in_memory);
 
+  // Like FromPartition, but applies the |options| of the new session.
+  static mate::Handle<Session> FromPartitionWithOptions(
+      const std::string& partition, bool in_memory, mate::Arguments* args);
+
   AtomBrowserContext* browser_context() const { return browser_context_.get(); }
 
  protected:
@@ -66,17 +81,35 @@ class Session: public mate::TrackableObject<Session>,
   void Destroy() override;
 
   void ResolveProxy(const GURL& url, ResolveProxyCallback callback);
+  void ResolveProxies(const std::vector<GURL>& urls,
+                      const ResolveProxiesCallback& callback);
   void ClearCache(const net::CompletionCallback& callback);
   void ClearStorageData(mate::Arguments* args);
   void SetProxy(const net::ProxyConfig& config, const base::Closure& callback);
+  void SetAuthCacheScope(AuthCache::Scope scope);
+  void ClearAuthCache(mate::Arguments* args);
   void SetDownloadPath(const base::FilePath& path);
   void EnableNetworkEmulation(const mate::Dictionary& options);
-  void DisableNetworkEmulation();
+  void DisableNetworkEmulation(mate::Arguments* args);
+  void SetNetworkConditions(
+      const std::string& client_id,
+      scoped_ptr<brightray::DevToolsNetworkConditions> conditions);
+  v8::Local<v8::Value> GetNetworkEmulationStats(mate::Arguments* args);
+  v8::Local<v8::Value> GetCacheStats(mate::Arguments* args);
+  void Preconnect(const GURL& url, mate::Arguments* args);
+  void PrefetchDNS(const std::vector<std::string>& hosts);
+  mate::Handle<ParallelDownload> DownloadURL(const GURL& url,
+                                             const mate::Dictionary& options,
+                                             mate::Arguments* args);
   v8::Local<v8::Value> Cookies(v8::Isolate* isolate);
+  v8::Local<v8::Value> NetLog(v8::Isolate* isolate);
 
   // Cached object for cookies API.
   v8::Global<v8::Value> cookies_;
 
+  // Cached object for netLog API.
+  v8::Global<v8::Value> net_log_;
+
   scoped_refptr<AtomBrowserContext> browser_context_;
 
   DISALLOW_COPY_AND_ASSIGN(Session);
@@ -0,0 +1,97 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_shared_memory.h"
+
+#include "atom/browser/api/atom_api_web_contents.h"
+#include "atom/common/api/api_messages.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+#include "atom/common/node_includes.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/web_contents.h"
+#include "native_mate/arguments.h"
+#include "native_mate/dictionary.h"
+#include "native_mate/object_template_builder.h"
+
+namespace atom {
+
+namespace api {
+
+SharedMemoryRegion::SharedMemoryRegion(
+    const std::string& name, scoped_refptr<SharedBufferRegion> region)
+    : name_(name),
+      region_(region) {
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+}
+
+v8::Local<v8::Object> SharedMemoryRegion::GetBuffer(v8::Isolate* isolate) {
+  return region_->NewBuffer(isolate);
+}
+
+bool SharedMemoryRegion::ShareWith(WebContents* web_contents) {
+  if (!web_contents || web_contents->IsDestroyed())
+    return false;
+
+  content::RenderProcessHost* process =
+      web_contents->web_contents()->GetRenderProcessHost();
+  base::SharedMemoryHandle handle;
+  if (!region_->ShareToProcess(process->GetHandle(), &handle))
+    return false;
+  return web_contents->Send(new AtomViewMsg_SharedMemoryRegion(
+      web_contents->routing_id(), name_, handle,
+      static_cast<uint32>(region_->size())));
+}
+
+void SharedMemoryRegion::ReleaseFrom(WebContents* web_contents) {
+  if (!web_contents || web_contents->IsDestroyed())
+    return;
+  web_contents->Send(new AtomViewMsg_SharedMemoryReleased(
+      web_contents->routing_id(), name_));
+}
+
+mate::ObjectTemplateBuilder SharedMemoryRegion::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return mate::ObjectTemplateBuilder(isolate)
+      .SetMethod("getBuffer", &SharedMemoryRegion::GetBuffer)
+      .SetMethod("shareWith", &SharedMemoryRegion::ShareWith)
+      .SetMethod("releaseFrom", &SharedMemoryRegion::ReleaseFrom);
+}
+
+// static
+mate::Handle<SharedMemoryRegion> SharedMemoryRegion::Create(
+    mate::Arguments* args, const std::string& name, size_t size) {
+  // The size is sent as uint32 and each renderer maps the whole region.
+  if (size == 0 || size > kuint32max) {
+    args->ThrowError("Invalid size of the shared memory region");
+    return mate::Handle<SharedMemoryRegion>();
+  }
+
+  scoped_refptr<SharedBufferRegion> region =
+      SharedBufferRegion::CreateAnonymous(size);
+  if (!region) {
+    args->ThrowError("Unable to create the shared memory region");
+    return mate::Handle<SharedMemoryRegion>();
+  }
+  return mate::CreateHandle(args->isolate(),
+                            new SharedMemoryRegion(name, region));
+}
+
+}  // namespace api
+
+}  // namespace atom
+
+namespace {
+
+void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
+                v8::Local<v8::Context> context, void* priv) {
+  v8::Isolate* isolate = context->GetIsolate();
+  mate::Dictionary dict(isolate, exports);
+  dict.SetMethod("createRegion", &atom::api::SharedMemoryRegion::Create);
+}
+
+}  // namespace
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(atom_browser_shared_memory, Initialize);
@@ -0,0 +1,62 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_ATOM_API_SHARED_MEMORY_H_
+#define ATOM_BROWSER_API_ATOM_API_SHARED_MEMORY_H_
+
+#include <string>
+
+#include "base/memory/ref_counted.h"
+#include "native_mate/handle.h"
+#include "native_mate/wrappable.h"
+
+namespace mate {
+class Arguments;
+}
+
+namespace atom {
+
+class SharedBufferRegion;
+
+namespace api {
+
+class WebContents;
+
+// A named region of shared memory that the main process can map into
+// renderers, the memory is freed when the region and all the Buffers of it
+// are gone.
+class SharedMemoryRegion : public mate::Wrappable {
+ public:
+  static mate::Handle<SharedMemoryRegion> Create(mate::Arguments* args,
+                                                 const std::string& name,
+                                                 size_t size);
+
+ protected:
+  SharedMemoryRegion(const std::string& name,
+                     scoped_refptr<SharedBufferRegion> region);
+  ~SharedMemoryRegion();
+
+  v8::Local<v8::Object> GetBuffer(v8::Isolate* isolate);
+
+  // Maps the region into the renderer of |web_contents|, and drops it from
+  // the renderer.
+  bool ShareWith(WebContents* web_contents);
+  void ReleaseFrom(WebContents* web_contents);
+
+ private:
+  // mate::Wrappable:
+  mate::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+
+  std::string name_;
+  scoped_refptr<SharedBufferRegion> region_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryRegion);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_ATOM_API_SHARED_MEMORY_H_
@@ -22,6 +22,13 @@ namespace atom {
 
 namespace api {
 
+namespace {
+
+// Faster animations are not visible in the status area anyway.
+const double kMaxImageSequenceFps = 60;
+
+}  // namespace
+
 Tray::Tray(const gfx::Image& image)
     : tray_icon_(TrayIcon::Create()) {
   tray_icon_->SetImage(image);
@@ -87,9 +94,26 @@ void Tray::Destroy() {
 }
 
 void Tray::SetImage(mate::Arguments* args, const gfx::Image& image) {
+  tray_icon_->StopImageSequence();
   tray_icon_->SetImage(image);
 }
 
+void Tray::SetImageSequence(mate::Arguments* args,
+                            const std::vector<gfx::Image>& frames,
+                            double fps) {
+  if (frames.empty()) {
+    args->ThrowError("frames must not be empty");
+    return;
+  }
+  if (fps <= 0 || fps > kMaxImageSequenceFps) {
+    args->ThrowError("fps must be between 0 and 60");
+    return;
+  }
+  tray_icon_->SetImageSequence(
+      frames, base::TimeDelta::FromMicroseconds(
+          static_cast<int64>(base::Time::kMicrosecondsPerSecond / fps)));
+}
+
 void Tray::SetPressedImage(mate::Arguments* args, const gfx::Image& image) {
   tray_icon_->SetPressedImage(image);
 }
@@ -146,6 +170,7 @@ void Tray::BuildPrototype(v8::Isolate* isolate,
   mate::ObjectTemplateBuilder(isolate, prototype)
       .SetMethod("destroy", &Tray::Destroy, true)
       .SetMethod("setImage", &Tray::SetImage)
+      .SetMethod("setImageSequence", &Tray::SetImageSequence)
       .SetMethod("setPressedImage", &Tray::SetPressedImage)
       .SetMethod("setToolTip", &Tray::SetToolTip)
       .SetMethod("setTitle", &Tray::SetTitle)
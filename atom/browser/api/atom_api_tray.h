@@ -55,6 +55,9 @@ class Tray : public mate::EventEmitter,
 
   void Destroy();
   void SetImage(mate::Arguments* args, const gfx::Image& image);
+  void SetImageSequence(mate::Arguments* args,
+                        const std::vector<gfx::Image>& frames,
+                        double fps);
   void SetPressedImage(mate::Arguments* args, const gfx::Image& image);
   void SetToolTip(mate::Arguments* args, const std::string& tool_tip);
   void SetTitle(mate::Arguments* args, const std::string& title);
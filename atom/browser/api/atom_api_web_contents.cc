@@ -4,6 +4,7 @@
 
 #include "atom/browser/api/atom_api_web_contents.h"
 
+#include <algorithm>
 #include <set>
 
 #include "atom/browser/api/atom_api_session.h"
@@ -11,7 +12,10 @@
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/atom_browser_main_parts.h"
+#include "atom/browser/input_event_stream.h"
+#include "atom/browser/message_port_filter.h"
 #include "atom/browser/native_window.h"
+#include "atom/browser/style_sheet_registry.h"
 #include "atom/browser/web_contents_preferences.h"
 #include "atom/browser/web_view_guest_delegate.h"
 #include "atom/common/api/api_messages.h"
@@ -23,9 +27,13 @@
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/image_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/startup_timeline.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/trace_event/trace_event.h"
 #include "brightray/browser/inspectable_web_contents.h"
 #include "brightray/browser/inspectable_web_contents_view.h"
 #include "chrome/browser/printing/print_view_manager_basic.h"
@@ -40,6 +48,7 @@
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_view_host.h"
+#include "content/public/browser/render_widget_host_iterator.h"
 #include "content/public/browser/render_widget_host_view.h"
 #include "content/public/browser/resource_request_details.h"
 #include "content/public/browser/service_worker_context.h"
@@ -72,15 +81,6 @@ void SetUserAgentInIO(scoped_refptr<net::URLRequestContextGetter> getter,
           user_agent));
 }
 
-bool NotifyZoomLevelChanged(
-    double level, content::WebContents* guest_web_contents) {
-  guest_web_contents->SendToAllFrames(
-      new AtomViewMsg_SetZoomLevel(MSG_ROUTING_NONE, level));
-
-  // Return false to iterate over all guests.
-  return false;
-}
-
 }  // namespace
 
 namespace mate {
@@ -182,6 +182,21 @@ struct Converter<content::SavePageType> {
   }
 };
 
+template<>
+struct Converter<content::JavaScriptMessageType> {
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   content::JavaScriptMessageType val) {
+    switch (val) {
+      case content::JAVASCRIPT_MESSAGE_TYPE_CONFIRM:
+        return StringToV8(isolate, "confirm");
+      case content::JAVASCRIPT_MESSAGE_TYPE_PROMPT:
+        return StringToV8(isolate, "prompt");
+      default:
+        return StringToV8(isolate, "alert");
+    }
+  }
+};
+
 }  // namespace mate
 
 
@@ -193,10 +208,33 @@ namespace {
 
 v8::Persistent<v8::ObjectTemplate> template_;
 
+// The frames per second of the "paint" event when it is not set.
+const int kDefaultFrameRate = 60;
+
+// The extra data of a navigation entry naming the document it was committed
+// in, the entries of in-page navigations share the document of the entry they
+// were made from.
+const char kDocumentIdKey[] = "atom-document-id";
+int g_next_document_id = 0;
+
+// Whether navigating from |current| to |target| stays in the same document,
+// which the renderer does without loading the page again.
+bool IsSameDocument(content::NavigationEntry* current,
+                    content::NavigationEntry* target) {
+  base::string16 current_id, target_id;
+  return current && target &&
+         current->GetExtraData(kDocumentIdKey, &current_id) &&
+         target->GetExtraData(kDocumentIdKey, &target_id) &&
+         current_id == target_id;
+}
+
 // The wrapWebContents function which is implemented in JavaScript
 using WrapWebContentsCallback = base::Callback<void(v8::Local<v8::Value>)>;
 WrapWebContentsCallback g_wrap_web_contents;
 
+// The ipc module, which gets the messages of ipc.send directly.
+v8::Global<v8::Object> g_ipc_emitter;
+
 content::ServiceWorkerContext* GetServiceWorkerContext(
     const content::WebContents* web_contents) {
   auto context = web_contents->GetBrowserContext();
@@ -212,17 +250,55 @@ content::ServiceWorkerContext* GetServiceWorkerContext(
   return storage_partition->GetServiceWorkerContext();
 }
 
+// Closes a dialog of the page with the arguments of the JS callback:
+// callback(accepted[, userInput]). Calling it without arguments cancels it.
+void PassDialogResult(
+    const content::JavaScriptDialogManager::DialogClosedCallback& callback,
+    mate::Arguments* args) {
+  bool success = false;
+  base::string16 user_input;
+  args->GetNext(&success);
+  args->GetNext(&user_input);
+  callback.Run(success, user_input);
+}
+
+// Whether pages other than |render_view_host| live in its renderer process,
+// which happens when the "share-renderer-process" preference is set.
+bool HasOtherRenderViews(content::RenderViewHost* render_view_host) {
+  auto process = render_view_host->GetProcess();
+  scoped_ptr<content::RenderWidgetHostIterator> widgets(
+      content::RenderWidgetHost::GetRenderWidgetHosts());
+  while (content::RenderWidgetHost* widget = widgets->GetNextHost()) {
+    if (widget->IsRenderView() && widget->GetProcess() == process &&
+        content::RenderViewHost::From(widget) != render_view_host)
+      return true;
+  }
+  return false;
+}
+
 }  // namespace
 
 WebContents::WebContents(content::WebContents* web_contents)
     : content::WebContentsObserver(web_contents),
-      type_(REMOTE) {
+      type_(REMOTE),
+      frame_rate_(kDefaultFrameRate),
+      painting_(false),
+      zoom_level_(0),
+      jank_report_interval_(0),
+      javascript_dialog_timeout_(0),
+      weak_factory_(this) {
   AttachAsUserData(web_contents);
   web_contents->SetUserAgentOverride(GetBrowserContext()->GetUserAgent());
 }
 
 WebContents::WebContents(v8::Isolate* isolate,
-                         const mate::Dictionary& options) {
+                         const mate::Dictionary& options)
+    : frame_rate_(kDefaultFrameRate),
+      painting_(false),
+      zoom_level_(0),
+      jank_report_interval_(0),
+      javascript_dialog_timeout_(0),
+      weak_factory_(this) {
   // Whether it is a guest WebContents.
   bool is_guest = false;
   options.Get("isGuest", &is_guest);
@@ -339,6 +415,13 @@ content::WebContents* WebContents::OpenURLFromTab(
   return CommonWebContentsDelegate::OpenURLFromTab(source, params);
 }
 
+bool WebContents::OnGoToEntryOffset(int offset) {
+  // The history.back() and friends of the page, they restart the renderer
+  // process like the ones of the API do.
+  GoToOffset(offset);
+  return false;
+}
+
 void WebContents::BeforeUnloadFired(content::WebContents* tab,
                                     bool proceed,
                                     bool* proceed_to_fire_unload) {
@@ -409,10 +492,51 @@ void WebContents::BeforeUnloadFired(const base::TimeTicks& proceed_time) {
   // there are two virtual functions named BeforeUnloadFired.
 }
 
+void WebContents::RenderViewCreated(
+    content::RenderViewHost* render_view_host) {
+  if (!network_emulation_client_id_.empty())
+    GetBrowserContext()->network_emulation_rules()->AddRenderView(
+        network_emulation_client_id_,
+        render_view_host->GetProcess()->GetID(),
+        render_view_host->GetRoutingID());
+
+  // The reports belong to the view, so a new view has to be asked again.
+  if (jank_report_interval_ > 0)
+    render_view_host->Send(new AtomViewMsg_SetJankReportInterval(
+        render_view_host->GetRoutingID(), jank_report_interval_));
+
+  // So are the style sheets, which are then inserted without waiting for the
+  // browser in every navigation.
+  if (!style_sheets_.empty())
+    render_view_host->Send(new AtomViewMsg_SetStyleSheets(
+        render_view_host->GetRoutingID(), style_sheets_));
+}
+
+void WebContents::RenderViewReady() {
+  // The frame subscription belongs to the view, so a new view has to be
+  // subscribed again.
+  if (painting_)
+    SubscribePaint();
+
+  // A new renderer starts with the default zoom level.
+  zoom_level_ = 0;
+}
+
 void WebContents::RenderViewDeleted(content::RenderViewHost* render_view_host) {
   int process_id = render_view_host->GetProcess()->GetID();
+  if (!network_emulation_client_id_.empty())
+    GetBrowserContext()->network_emulation_rules()->RemoveRenderView(
+        network_emulation_client_id_, process_id,
+        render_view_host->GetRoutingID());
+  MessagePortFilter::CloseViewPorts(process_id,
+                                    render_view_host->GetRoutingID());
   Emit("render-view-deleted", process_id);
 
+  // The objects are owned by the process, they can only be released when no
+  // other page that shares the process is using them.
+  if (HasOtherRenderViews(render_view_host))
+    return;
+
   // process.emit('ATOM_BROWSER_RELEASE_RENDER_VIEW', processId);
   // Tell the rpc server that a render view has been deleted and we need to
   // release all objects owned by it.
@@ -424,6 +548,7 @@ void WebContents::RenderViewDeleted(content::RenderViewHost* render_view_host) {
 }
 
 void WebContents::RenderProcessGone(base::TerminationStatus status) {
+  ResetRegisteredChannels();
   Emit("crashed");
 }
 
@@ -457,7 +582,9 @@ void WebContents::DidFailProvisionalLoad(
     int error_code,
     const base::string16& error_description,
     bool was_ignored_by_handler) {
-  Emit("did-fail-load", error_code, error_description, validated_url);
+  bool is_main_frame = !render_frame_host->GetParent();
+  Emit("did-fail-load", error_code, error_description, validated_url,
+       is_main_frame);
 }
 
 void WebContents::DidFailLoad(content::RenderFrameHost* render_frame_host,
@@ -465,7 +592,9 @@ void WebContents::DidFailLoad(content::RenderFrameHost* render_frame_host,
                               int error_code,
                               const base::string16& error_description,
                               bool was_ignored_by_handler) {
-  Emit("did-fail-load", error_code, error_description, validated_url);
+  bool is_main_frame = !render_frame_host->GetParent();
+  Emit("did-fail-load", error_code, error_description, validated_url,
+       is_main_frame);
 }
 
 void WebContents::DidStartLoading() {
@@ -476,6 +605,10 @@ void WebContents::DidStopLoading() {
   Emit("did-stop-loading");
 }
 
+void WebContents::DidFirstVisuallyNonEmptyPaint() {
+  StartupTimeline::GetInstance()->Mark("firstPaint");
+}
+
 void WebContents::DidGetResourceResponseStart(
     const content::ResourceRequestDetails& details) {
   Emit("did-get-response-details",
@@ -504,8 +637,13 @@ void WebContents::DidGetRedirectForResourceRequest(
 void WebContents::DidNavigateMainFrame(
     const content::LoadCommittedDetails& details,
     const content::FrameNavigateParams& params) {
-  if (details.is_navigation_to_different_page())
+  if (details.is_navigation_to_different_page()) {
+    // The pages register their channels again, and start with the default
+    // zoom level.
+    ResetRegisteredChannels();
+    zoom_level_ = 0;
     Emit("did-navigate-to-different-page");
+  }
 }
 
 void WebContents::TitleWasSet(content::NavigationEntry* entry,
@@ -517,6 +655,9 @@ void WebContents::TitleWasSet(content::NavigationEntry* entry,
 
 void WebContents::DidUpdateFaviconURL(
     const std::vector<content::FaviconURL>& urls) {
+  if (!HasListeners("page-favicon-updated"))
+    return;
+
   std::set<GURL> unique_urls;
   for (auto iter = urls.begin(); iter != urls.end(); ++iter) {
     if (iter->icon_type != content::FaviconURL::FAVICON)
@@ -559,9 +700,16 @@ bool WebContents::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(WebContents, message)
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message, OnRendererMessage)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_RegisterChannel, OnRegisterChannel)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_MessageById, OnRendererMessageById)
     IPC_MESSAGE_HANDLER_DELAY_REPLY(AtomViewHostMsg_Message_Sync,
                                     OnRendererMessageSync)
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_ZoomLevelChanged, OnZoomLevelChanged)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_GuestElementResized,
+                        OnGuestElementResized)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_NodeEnvironmentLoaded,
+                        OnNodeEnvironmentLoaded)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_JankReport, OnJankReport)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
@@ -571,14 +719,31 @@ bool WebContents::OnMessageReceived(const IPC::Message& message) {
 void WebContents::WebContentsDestroyed() {
   // The RenderViewDeleted was not called when the WebContents is destroyed.
   RenderViewDeleted(web_contents()->GetRenderViewHost());
+  if (!network_emulation_client_id_.empty())
+    GetBrowserContext()->network_emulation_rules()->RemoveRule(
+        network_emulation_client_id_);
   Emit("destroyed");
   RemoveFromWeakMap();
 }
 
 void WebContents::NavigationEntryCommitted(
     const content::LoadCommittedDetails& details) {
-  Emit("navigation-entry-commited", details.entry->GetURL(),
-       details.is_in_page, details.did_replace_entry);
+  base::string16 document_id;
+  if (!details.entry->GetExtraData(kDocumentIdKey, &document_id)) {
+    content::NavigationEntry* previous_entry =
+        details.previous_entry_index >= 0 ?
+        web_contents()->GetController().GetEntryAtIndex(
+            details.previous_entry_index) :
+        nullptr;
+    if (!details.is_in_page || !previous_entry ||
+        !previous_entry->GetExtraData(kDocumentIdKey, &document_id))
+      document_id = base::IntToString16(++g_next_document_id);
+    details.entry->SetExtraData(kDocumentIdKey, document_id);
+  }
+
+  if (HasListeners("navigation-entry-commited"))
+    Emit("navigation-entry-commited", details.entry->GetURL(),
+         details.is_in_page, details.did_replace_entry);
 }
 
 void WebContents::Destroy() {
@@ -623,7 +788,6 @@ void WebContents::LoadURL(const GURL& url, const mate::Dictionary& options) {
     params.extra_headers = extra_headers;
 
   params.transition_type = ui::PAGE_TRANSITION_TYPED;
-  params.should_clear_history_list = true;
   params.override_user_agent = content::NavigationController::UA_OVERRIDE_TRUE;
   web_contents()->GetController().LoadURLWithParams(params);
 }
@@ -648,23 +812,68 @@ void WebContents::Stop() {
   web_contents()->Stop();
 }
 
+void WebContents::Reload() {
+  web_contents()->GetController().Reload(false);
+}
+
 void WebContents::ReloadIgnoringCache() {
   web_contents()->GetController().ReloadIgnoringCache(false);
 }
 
+bool WebContents::CanGoBack() const {
+  return web_contents()->GetController().CanGoBack();
+}
+
+bool WebContents::CanGoForward() const {
+  return web_contents()->GetController().CanGoForward();
+}
+
+bool WebContents::CanGoToOffset(int offset) const {
+  return web_contents()->GetController().CanGoToOffset(offset);
+}
+
+bool WebContents::CanGoToIndex(int index) const {
+  return index >= 0 && index < GetEntryCount();
+}
+
+void WebContents::ClearHistory() {
+  // There is nothing to prune while the first page is still loading.
+  auto& controller = web_contents()->GetController();
+  if (controller.CanPruneAllButLastCommitted())
+    controller.PruneAllButLastCommitted();
+}
+
 void WebContents::GoBack() {
-  atom::AtomBrowserClient::SuppressRendererProcessRestartForOnce();
-  web_contents()->GetController().GoBack();
+  GoToOffset(-1);
 }
 
 void WebContents::GoForward() {
-  atom::AtomBrowserClient::SuppressRendererProcessRestartForOnce();
-  web_contents()->GetController().GoForward();
+  GoToOffset(1);
 }
 
 void WebContents::GoToOffset(int offset) {
-  atom::AtomBrowserClient::SuppressRendererProcessRestartForOnce();
-  web_contents()->GetController().GoToOffset(offset);
+  if (CanGoToOffset(offset))
+    GoToIndex(GetActiveIndex() + offset);
+}
+
+void WebContents::GoToIndex(int index) {
+  if (!CanGoToIndex(index))
+    return;
+
+  // Only the entries of another document get a new renderer process.
+  auto& controller = web_contents()->GetController();
+  if (IsSameDocument(controller.GetLastCommittedEntry(),
+                     controller.GetEntryAtIndex(index)))
+    atom::AtomBrowserClient::SuppressRendererProcessRestartForOnce();
+  controller.GoToIndex(index);
+}
+
+int WebContents::GetActiveIndex() const {
+  return web_contents()->GetController().GetCurrentEntryIndex();
+}
+
+int WebContents::GetEntryCount() const {
+  return web_contents()->GetController().GetEntryCount();
 }
 
 bool WebContents::IsCrashed() const {
@@ -689,10 +898,42 @@ void WebContents::InsertCSS(const std::string& css) {
   web_contents()->InsertCSS(css);
 }
 
+void WebContents::InsertStyleSheet(const std::string& id,
+                                   mate::Arguments* args) {
+  if (!StyleSheetRegistry::GetInstance()->IsRegistered(id)) {
+    args->ThrowError("Style sheet " + id + " is not registered");
+    return;
+  }
+  Send(new AtomViewMsg_InsertStyleSheet(routing_id(), id));
+}
+
+void WebContents::SetStyleSheets(const std::vector<std::string>& ids,
+                                 mate::Arguments* args) {
+  for (const std::string& id : ids) {
+    if (!StyleSheetRegistry::GetInstance()->IsRegistered(id)) {
+      args->ThrowError("Style sheet " + id + " is not registered");
+      return;
+    }
+  }
+  style_sheets_ = ids;
+  Send(new AtomViewMsg_SetStyleSheets(routing_id(), style_sheets_));
+}
+
 bool WebContents::SavePage(const base::FilePath& full_file_path,
                            const content::SavePageType& save_type,
-                           const SavePageHandler::SavePageCallback& callback) {
-  auto handler = new SavePageHandler(web_contents(), callback);
+                           mate::Arguments* args) {
+  // savePage(fullPath, saveType[, options], callback)
+  mate::Dictionary options;
+  SavePageHandler::SavePageProgressCallback progress;
+  if (args->GetNext(&options))
+    options.Get("progress", &progress);
+  SavePageHandler::SavePageCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError();
+    return false;
+  }
+
+  auto handler = new SavePageHandler(web_contents(), progress, callback);
   return handler->Handle(full_file_path, save_type);
 }
 
@@ -745,6 +986,21 @@ void WebContents::DisableDeviceEmulation() {
   Send(new ViewMsg_DisableDeviceEmulation(routing_id()));
 }
 
+void WebContents::SetNetworkEmulationClientId(const std::string& client_id) {
+  auto rules = GetBrowserContext()->network_emulation_rules();
+  auto render_view_host = web_contents()->GetRenderViewHost();
+  if (!network_emulation_client_id_.empty() && render_view_host)
+    rules->RemoveRenderView(network_emulation_client_id_,
+                            render_view_host->GetProcess()->GetID(),
+                            render_view_host->GetRoutingID());
+
+  network_emulation_client_id_ = client_id;
+  if (!client_id.empty() && render_view_host)
+    rules->AddRenderView(client_id,
+                         render_view_host->GetProcess()->GetID(),
+                         render_view_host->GetRoutingID());
+}
+
 void WebContents::ToggleDevTools() {
   if (IsDevToolsOpened())
     CloseDevTools();
@@ -816,10 +1072,12 @@ void WebContents::Print(mate::Arguments* args) {
       PrintNow(settings.silent, settings.print_background);
 }
 
-void WebContents::PrintToPDF(const base::DictionaryValue& setting,
-                             const PrintToPDFCallback& callback) {
+void WebContents::PrintToPDF(
+    const base::DictionaryValue& setting,
+    const PrintToPDFCallback& callback,
+    const PrintToPDFProgressCallback& progress_callback) {
   printing::PrintPreviewMessageHandler::FromWebContents(web_contents())->
-      PrintToPDF(setting, callback);
+      PrintToPDF(setting, callback, progress_callback);
 }
 
 void WebContents::AddWorkSpace(mate::Arguments* args,
@@ -892,9 +1150,101 @@ void WebContents::TabTraverse(bool reverse) {
   web_contents()->FocusThroughTabTraversal(reverse);
 }
 
-bool WebContents::SendIPCMessage(const base::string16& channel,
-                                 const base::ListValue& args) {
-  return Send(new AtomViewMsg_Message(routing_id(), channel, args));
+bool WebContents::SendIPCMessage(v8::Isolate* isolate,
+                                 const base::string16& channel,
+                                 v8::Local<v8::Value> args) {
+  std::string data;
+  V8ValueSerializer::BufferList buffers;
+  if (!V8ValueSerializer::Serialize(isolate, args, &data, &buffers))
+    return false;
+
+  // Large Buffers are copied once into shared memory, and the renderer reads
+  // them from there without copying.
+  base::SharedMemory memory;
+  base::SharedMemoryHandle handle = base::SharedMemory::NULLHandle();
+  size_t buffers_size = V8ValueSerializer::GetBuffersSize(buffers);
+  if (!buffers.empty()) {
+    if (buffers_size > kuint32max ||
+        !memory.CreateAndMapAnonymous(buffers_size))
+      return false;
+    V8ValueSerializer::CopyBuffers(buffers,
+                                   static_cast<char*>(memory.memory()));
+    if (!memory.ShareToProcess(
+            web_contents()->GetRenderProcessHost()->GetHandle(), &handle))
+      return false;
+  }
+
+  return Send(new AtomViewMsg_Message(routing_id(), channel, data, handle,
+                                      static_cast<uint32>(buffers_size)));
+}
+
+void WebContents::SetChannelHandler(int32 channel_id,
+                                    v8::Local<v8::Function> handler) {
+  channel_handlers_[channel_id] = make_linked_ptr(
+      new v8::Global<v8::Function>(isolate(), handler));
+}
+
+v8::Local<v8::Value> WebContents::GetIPCStats(mate::Arguments* args) {
+  bool reset = false;
+  args->GetNext(&reset);
+
+  scoped_ptr<base::DictionaryValue> value = ipc_stats_.ToValue();
+  if (reset)
+    ipc_stats_.Reset();
+  return mate::ConvertToV8(args->isolate(), *value);
+}
+
+std::vector<int32> WebContents::CreateMessageChannel(
+    mate::Arguments* args, WebContents* peer) {
+  std::vector<int32> port_ids;
+  if (peer->IsDestroyed()) {
+    args->ThrowError("The peer WebContents has been destroyed");
+    return port_ids;
+  }
+
+  int32 port_id1, port_id2;
+  MessagePortFilter::CreateChannel(
+      web_contents()->GetRenderProcessHost()->GetID(), routing_id(),
+      peer->web_contents()->GetRenderProcessHost()->GetID(),
+      peer->routing_id(),
+      &port_id1, &port_id2);
+  port_ids.push_back(port_id1);
+  port_ids.push_back(port_id2);
+  return port_ids;
+}
+
+// static
+void WebContents::RegisterStyleSheet(const std::string& id,
+                                     const std::string& css) {
+  StyleSheetRegistry::GetInstance()->Register(id, css);
+}
+
+// static
+int WebContents::Broadcast(mate::Arguments* args,
+                           const std::vector<WebContents*>& targets,
+                           const base::string16& channel,
+                           v8::Local<v8::Value> arguments) {
+  // Buffers are kept inline, sharing one writable region between renderers
+  // would let them see each other's changes.
+  std::string data;
+  if (!V8ValueSerializer::Serialize(args->isolate(), arguments, &data)) {
+    args->ThrowError("Unable to serialize the arguments");
+    return 0;
+  }
+
+  // Pickle the message once and copy it for each target.
+  AtomViewMsg_Message message(MSG_ROUTING_NONE, channel, data,
+                              base::SharedMemory::NULLHandle(), 0);
+  int count = 0;
+  for (WebContents* target : targets) {
+    if (!target || target->IsDestroyed())
+      continue;
+    IPC::Message* copy = new IPC::Message(message);
+    copy->set_routing_id(target->routing_id());
+    if (target->Send(copy))
+      ++count;
+  }
+  return count;
 }
 
 void WebContents::SendInputEvent(v8::Isolate* isolate,
@@ -931,12 +1281,80 @@ void WebContents::SendInputEvent(v8::Isolate* isolate,
       isolate, "Invalid event object")));
 }
 
-void WebContents::BeginFrameSubscription(
-    const FrameSubscriber::FrameCaptureCallback& callback) {
+int WebContents::SendInputEvents(v8::Isolate* isolate,
+                                 v8::Local<v8::Value> stream) {
+  // The events are read in place, without converting them to JS objects.
+  ScopedVector<blink::WebMouseEvent> events;
+  bool valid = stream->IsFloat64Array();
+  if (valid) {
+    v8::Local<v8::Float64Array> array = stream.As<v8::Float64Array>();
+    const char* data = static_cast<const char*>(
+        array->Buffer()->GetContents().Data()) + array->ByteOffset();
+    valid = DecodeInputEvents(reinterpret_cast<const double*>(data),
+                              array->Length(), &events);
+  }
+  if (!valid) {
+    isolate->ThrowException(v8::Exception::Error(mate::StringToV8(
+        isolate, "Invalid event stream")));
+    return 0;
+  }
+
+  const auto view = web_contents()->GetRenderWidgetHostView();
+  if (!view)
+    return 0;
+  const auto host = view->GetRenderWidgetHost();
+  if (!host)
+    return 0;
+
+  for (const blink::WebMouseEvent* event : events) {
+    if (event->type == blink::WebInputEvent::MouseWheel)
+      host->ForwardWheelEvent(
+          *static_cast<const blink::WebMouseWheelEvent*>(event));
+    else
+      host->ForwardMouseEvent(*event);
+  }
+  return static_cast<int>(events.size());
+}
+
+void WebContents::BeginFrameSubscription(mate::Arguments* args) {
+  FrameSubscriber::Options subscriber_options;
+  mate::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("ringSize", &subscriber_options.ring_size);
+    options.Get("onlyDirty", &subscriber_options.only_dirty);
+    options.Get("size", &subscriber_options.size);
+    options.Get("maxPendingFrames", &subscriber_options.max_pending_frames);
+    double min_interval = 0;
+    options.Get("minInterval", &min_interval);
+    double max_fps = 0;
+    if (options.Get("maxFps", &max_fps) && max_fps > 0)
+      min_interval = std::max(min_interval, 1000 / max_fps);
+    subscriber_options.min_interval =
+        base::TimeDelta::FromMicroseconds(min_interval * 1000);
+    std::string format;
+    if (options.Get("format", &format)) {
+      if (format == "i420") {
+        subscriber_options.format = FrameSubscriber::FORMAT_I420;
+      } else if (format == "nv12") {
+        subscriber_options.format = FrameSubscriber::FORMAT_NV12;
+      } else if (format != "rgb") {
+        args->ThrowError("Unknown frame format: " + format);
+        return;
+      }
+    }
+  }
+
+  FrameSubscriber::FrameCaptureCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+
   const auto view = web_contents()->GetRenderWidgetHostView();
   if (view) {
     scoped_ptr<FrameSubscriber> frame_subscriber(new FrameSubscriber(
-        isolate(), view->GetVisibleViewportSize(), callback));
+        isolate(), view->GetVisibleViewportSize(), subscriber_options,
+        callback));
     view->BeginFrameSubscription(frame_subscriber.Pass());
   }
 }
@@ -947,6 +1365,44 @@ void WebContents::EndFrameSubscription() {
     view->EndFrameSubscription();
 }
 
+void WebContents::StartPainting() {
+  if (painting_)
+    return;
+  painting_ = true;
+  SubscribePaint();
+}
+
+void WebContents::StopPainting() {
+  if (!painting_)
+    return;
+  painting_ = false;
+  EndFrameSubscription();
+}
+
+bool WebContents::IsPainting() const {
+  return painting_;
+}
+
+void WebContents::SetFrameRate(int frame_rate) {
+  frame_rate_ = std::max(1, frame_rate);
+  if (painting_)
+    SubscribePaint();
+}
+
+int WebContents::GetFrameRate() const {
+  return frame_rate_;
+}
+
+void WebContents::SetJankReportInterval(int interval) {
+  jank_report_interval_ = std::max(0, interval);
+  Send(new AtomViewMsg_SetJankReportInterval(routing_id(),
+                                             jank_report_interval_));
+}
+
+void WebContents::SetJavaScriptDialogTimeout(int timeout) {
+  javascript_dialog_timeout_ = std::max(0, timeout);
+}
+
 void WebContents::SetSize(const SetSizeParams& params) {
   if (guest_delegate_)
     guest_delegate_->SetSize(params);
@@ -994,19 +1450,30 @@ mate::ObjectTemplateBuilder WebContents::GetObjectTemplateBuilder(
         .SetMethod("getId", &WebContents::GetID)
         .SetMethod("equal", &WebContents::Equal)
         .SetMethod("_loadUrl", &WebContents::LoadURL)
-        .SetMethod("_getUrl", &WebContents::GetURL)
+        .SetMethod("getUrl", &WebContents::GetURL)
         .SetMethod("getTitle", &WebContents::GetTitle)
         .SetMethod("isLoading", &WebContents::IsLoading)
         .SetMethod("isWaitingForResponse", &WebContents::IsWaitingForResponse)
-        .SetMethod("_stop", &WebContents::Stop)
-        .SetMethod("_reloadIgnoringCache", &WebContents::ReloadIgnoringCache)
-        .SetMethod("_goBack", &WebContents::GoBack)
-        .SetMethod("_goForward", &WebContents::GoForward)
-        .SetMethod("_goToOffset", &WebContents::GoToOffset)
+        .SetMethod("stop", &WebContents::Stop)
+        .SetMethod("reload", &WebContents::Reload)
+        .SetMethod("reloadIgnoringCache", &WebContents::ReloadIgnoringCache)
+        .SetMethod("canGoBack", &WebContents::CanGoBack)
+        .SetMethod("canGoForward", &WebContents::CanGoForward)
+        .SetMethod("canGoToOffset", &WebContents::CanGoToOffset)
+        .SetMethod("canGoToIndex", &WebContents::CanGoToIndex)
+        .SetMethod("clearHistory", &WebContents::ClearHistory)
+        .SetMethod("goBack", &WebContents::GoBack)
+        .SetMethod("goForward", &WebContents::GoForward)
+        .SetMethod("goToOffset", &WebContents::GoToOffset)
+        .SetMethod("goToIndex", &WebContents::GoToIndex)
+        .SetMethod("getActiveIndex", &WebContents::GetActiveIndex)
+        .SetMethod("length", &WebContents::GetEntryCount)
         .SetMethod("isCrashed", &WebContents::IsCrashed)
         .SetMethod("setUserAgent", &WebContents::SetUserAgent)
         .SetMethod("getUserAgent", &WebContents::GetUserAgent)
         .SetMethod("insertCSS", &WebContents::InsertCSS)
+        .SetMethod("insertStyleSheet", &WebContents::InsertStyleSheet)
+        .SetMethod("setStyleSheets", &WebContents::SetStyleSheets)
         .SetMethod("savePage", &WebContents::SavePage)
         .SetMethod("_executeJavaScript", &WebContents::ExecuteJavaScript)
         .SetMethod("openDevTools", &WebContents::OpenDevTools)
@@ -1034,10 +1501,24 @@ mate::ObjectTemplateBuilder WebContents::GetObjectTemplateBuilder(
         .SetMethod("focus", &WebContents::Focus)
         .SetMethod("tabTraverse", &WebContents::TabTraverse)
         .SetMethod("_send", &WebContents::SendIPCMessage, true)
+        .SetMethod("_setChannelHandler", &WebContents::SetChannelHandler)
+        .SetMethod("_createMessageChannel",
+                   &WebContents::CreateMessageChannel, true)
+        .SetMethod("getIPCStats", &WebContents::GetIPCStats)
         .SetMethod("sendInputEvent", &WebContents::SendInputEvent)
+        .SetMethod("sendInputEvents", &WebContents::SendInputEvents)
         .SetMethod("beginFrameSubscription",
                    &WebContents::BeginFrameSubscription)
         .SetMethod("endFrameSubscription", &WebContents::EndFrameSubscription)
+        .SetMethod("startPainting", &WebContents::StartPainting)
+        .SetMethod("stopPainting", &WebContents::StopPainting)
+        .SetMethod("isPainting", &WebContents::IsPainting)
+        .SetMethod("setFrameRate", &WebContents::SetFrameRate)
+        .SetMethod("getFrameRate", &WebContents::GetFrameRate)
+        .SetMethod("setJankReportInterval",
+                   &WebContents::SetJankReportInterval)
+        .SetMethod("setJavaScriptDialogTimeout",
+                   &WebContents::SetJavaScriptDialogTimeout)
         .SetMethod("setSize", &WebContents::SetSize)
         .SetMethod("setAllowTransparency", &WebContents::SetAllowTransparency)
         .SetMethod("isGuest", &WebContents::IsGuest)
@@ -1064,30 +1545,304 @@ bool WebContents::IsDestroyed() const {
   return !IsAlive();
 }
 
+AtomJavaScriptDialogManager::Delegate*
+WebContents::GetJavaScriptDialogDelegate() {
+  return this;
+}
+
+bool WebContents::OnJavaScriptDialog(
+    content::JavaScriptMessageType type,
+    const base::string16& message_text,
+    const base::string16& default_prompt_text,
+    const GURL& origin_url,
+    const DialogClosedCallback& callback) {
+  return Emit("javascript-dialog", type, message_text, default_prompt_text,
+              origin_url, base::Bind(&PassDialogResult, callback));
+}
+
+bool WebContents::OnBeforeUnloadDialog(
+    const base::string16& message_text,
+    bool is_reload,
+    const DialogClosedCallback& callback) {
+  return Emit("before-unload-dialog", message_text, is_reload,
+              base::Bind(&PassDialogResult, callback));
+}
+
+base::TimeDelta WebContents::GetJavaScriptDialogTimeout() {
+  return base::TimeDelta::FromMilliseconds(javascript_dialog_timeout_);
+}
+
 AtomBrowserContext* WebContents::GetBrowserContext() const {
   return static_cast<AtomBrowserContext*>(web_contents()->GetBrowserContext());
 }
 
+bool WebContents::MapSharedBuffers(const base::SharedMemoryHandle& buffers,
+                                   uint32 buffers_size,
+                                   scoped_refptr<SharedBufferRegion>* region) {
+  if (!base::SharedMemory::IsHandleValid(buffers))
+    return true;
+
+#if defined(OS_WIN)
+  // The handle belongs to the renderer process. Mapping more than the section
+  // holds fails on Windows, so the size needs no check.
+  base::SharedMemory memory(
+      buffers, true, web_contents()->GetRenderProcessHost()->GetHandle());
+#else
+  base::SharedMemory memory(buffers, true);
+  // Reading past the end of a shorter region would raise SIGBUS.
+  size_t region_size = 0;
+  if (!base::SharedMemory::GetSizeFromSharedMemoryHandle(buffers,
+                                                         &region_size) ||
+      region_size != buffers_size)
+    return false;
+#endif
+  if (!memory.Map(buffers_size))
+    return false;
+
+  // The renderer can still write to the region, so the Buffers are copied out
+  // before they are deserialized.
+  *region = SharedBufferRegion::CreateAnonymous(buffers_size);
+  if (!region->get())
+    return false;
+  memcpy((*region)->data(), memory.memory(), buffers_size);
+  return true;
+}
+
 void WebContents::OnRendererMessage(const base::string16& channel,
-                                    const base::ListValue& args) {
-  // webContents.emit(channel, new Event(), args...);
-  Emit(base::UTF16ToUTF8(channel), args);
+                                    const std::string& args,
+                                    const base::SharedMemoryHandle& buffers,
+                                    uint32 buffers_size) {
+  scoped_refptr<SharedBufferRegion> region;
+  if (!MapSharedBuffers(buffers, buffers_size, &region)) {
+    LOG(ERROR) << "Unable to map the Buffers of ipc message " << channel;
+    return;
+  }
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  IPCChannelStats::Sample sample;
+  sample.bytes = args.size() + buffers_size;
+  base::TimeTicks start = base::TimeTicks::Now();
+  v8::Local<v8::Value> arguments =
+      V8ValueSerializer::Deserialize(isolate(), args, region.get());
+  if (arguments.IsEmpty()) {
+    LOG(ERROR) << "Received malformed ipc message " << channel;
+    return;
+  }
+  base::TimeTicks deserialized = base::TimeTicks::Now();
+  sample.serialize_time = deserialized - start;
+
+  std::string name = IPCChannelStats::GetChannelName(channel, arguments);
+  TRACE_EVENT2("electron.ipc", "WebContents::OnRendererMessage",
+               "channel", TRACE_STR_COPY(name.c_str()),
+               "bytes", sample.bytes);
+
+  if (channel == base::ASCIIToUTF16("ipc-message") && !g_ipc_emitter.IsEmpty())
+    EmitIpcMessage(arguments);
+  else  // webContents.emit(channel, new Event(), args...);
+    Emit(base::UTF16ToUTF8(channel), arguments);
+
+  sample.handler_time = base::TimeTicks::Now() - deserialized;
+  ipc_stats_.Record(name, sample);
+}
+
+void WebContents::EmitIpcMessage(v8::Local<v8::Value> packed) {
+  std::vector<v8::Local<v8::Value>> args;
+  std::string channel;
+  if (!mate::ConvertFromV8(isolate(), packed, &args) || args.empty() ||
+      !mate::ConvertFromV8(isolate(), args[0], &channel)) {
+    LOG(ERROR) << "Received malformed ipc message";
+    return;
+  }
+
+  // Skipping webContents.emit saves a dispatch and the unpacking in
+  // JavaScript, and no event is created when the channel has no listener.
+  v8::Local<v8::Object> ipc =
+      v8::Local<v8::Object>::New(isolate(), g_ipc_emitter);
+  if (!mate::HasListeners(isolate(), ipc, channel))
+    return;
+  args.insert(args.begin() + 1, CreateJSEvent(isolate(), nullptr, nullptr));
+  mate::internal::CallEmitWithArgs(isolate(), ipc, &args);
+}
+
+void WebContents::ResetRegisteredChannels() {
+  channel_handlers_.clear();
+  channel_names_.clear();
+}
+
+void WebContents::OnRegisterChannel(int32 channel_id,
+                                    const base::string16& channel) {
+  // The JavaScript side resolves the handler with _setChannelHandler.
+  channel_names_[channel_id] = base::UTF16ToUTF8(channel);
+  Emit("ipc-register-channel", channel_id, channel);
+}
+
+void WebContents::OnRendererMessageById(
+    int32 channel_id,
+    const std::string& args,
+    const base::SharedMemoryHandle& buffers,
+    uint32 buffers_size) {
+  // Map the buffers first so the handle is always closed.
+  scoped_refptr<SharedBufferRegion> region;
+  bool mapped = MapSharedBuffers(buffers, buffers_size, &region);
+
+  auto it = channel_handlers_.find(channel_id);
+  if (it == channel_handlers_.end()) {
+    LOG(ERROR) << "Received ipc message on unknown channel " << channel_id;
+    return;
+  }
+  if (!mapped) {
+    LOG(ERROR) << "Unable to map the Buffers of ipc channel " << channel_id;
+    return;
+  }
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  IPCChannelStats::Sample sample;
+  sample.bytes = args.size() + buffers_size;
+  base::TimeTicks start = base::TimeTicks::Now();
+  v8::Local<v8::Value> array =
+      V8ValueSerializer::Deserialize(isolate(), args, region.get());
+  std::vector<v8::Local<v8::Value>> arguments;
+  if (array.IsEmpty() ||
+      !mate::ConvertFromV8(isolate(), array, &arguments)) {
+    LOG(ERROR) << "Received malformed ipc message on channel " << channel_id;
+    return;
+  }
+  base::TimeTicks deserialized = base::TimeTicks::Now();
+  sample.serialize_time = deserialized - start;
+
+  std::string name;
+  auto name_it = channel_names_.find(channel_id);
+  if (name_it != channel_names_.end())
+    name = name_it->second;
+  TRACE_EVENT2("electron.ipc", "WebContents::OnRendererMessageById",
+               "channel", TRACE_STR_COPY(name.c_str()),
+               "bytes", sample.bytes);
+
+  std::vector<v8::Local<v8::Value>> argv = {
+      CreateJSEvent(isolate(), nullptr, nullptr) };
+  argv.insert(argv.end(), arguments.begin(), arguments.end());
+
+  // handler(new Event(), args...), without going through webContents.emit.
+  v8::Local<v8::Function> handler =
+      v8::Local<v8::Function>::New(isolate(), *it->second);
+  node::MakeCallback(isolate(), GetWrapper(isolate()), handler,
+                     argv.size(), &argv.front());
+
+  sample.handler_time = base::TimeTicks::Now() - deserialized;
+  ipc_stats_.Record(name, sample);
 }
 
 void WebContents::OnRendererMessageSync(const base::string16& channel,
-                                        const base::ListValue& args,
+                                        const std::string& args,
                                         IPC::Message* message) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  IPCChannelStats::Sample sample;
+  sample.sync = true;
+  sample.bytes = args.size();
+  base::TimeTicks start = base::TimeTicks::Now();
+  v8::Local<v8::Value> arguments =
+      V8ValueSerializer::Deserialize(isolate(), args);
+  if (arguments.IsEmpty()) {
+    LOG(ERROR) << "Received malformed ipc message " << channel;
+    // Reply so the renderer is not blocked forever.
+    AtomViewHostMsg_Message_Sync::WriteReplyParams(message, base::string16());
+    Send(message);
+    return;
+  }
+  base::TimeTicks deserialized = base::TimeTicks::Now();
+  sample.serialize_time = deserialized - start;
+
+  std::string name = IPCChannelStats::GetChannelName(channel, arguments);
+  TRACE_EVENT2("electron.ipc", "WebContents::OnRendererMessageSync",
+               "channel", TRACE_STR_COPY(name.c_str()),
+               "bytes", sample.bytes);
+
   // webContents.emit(channel, new Event(sender, message), args...);
-  EmitWithSender(base::UTF16ToUTF8(channel), web_contents(), message, args);
+  EmitWithSender(base::UTF16ToUTF8(channel), web_contents(), message,
+                 arguments);
+
+  // The renderer stays blocked for at least this long when the handler sets
+  // event.returnValue synchronously.
+  sample.handler_time = base::TimeTicks::Now() - deserialized;
+  ipc_stats_.Record(name, sample);
+}
+
+void WebContents::SubscribePaint() {
+  const auto view = web_contents()->GetRenderWidgetHostView();
+  if (!view)
+    return;
+
+  FrameSubscriber::Options options;
+  options.min_interval = base::TimeDelta::FromSeconds(1) / frame_rate_;
+  scoped_ptr<FrameSubscriber> frame_subscriber(new FrameSubscriber(
+      isolate(), view->GetVisibleViewportSize(), options,
+      base::Bind(&WebContents::OnPaint, weak_factory_.GetWeakPtr())));
+  view->BeginFrameSubscription(frame_subscriber.Pass());
+}
+
+void WebContents::OnPaint(v8::Local<v8::Value> buffer,
+                          v8::Local<v8::Value> info) {
+  Emit("paint", buffer, info);
+}
+
+void WebContents::OnNodeEnvironmentLoaded(int64 time) {
+  // The ticks of both processes come from the same system clock.
+  StartupTimeline::GetInstance()->MarkAt(
+      "firstRendererNodeReady", base::TimeTicks::FromInternalValue(time));
+}
+
+void WebContents::OnJankReport(const base::DictionaryValue& report) {
+  Emit("jank-report", report);
+}
+
+void WebContents::OnGuestElementResized(int element_instance_id,
+                                        const gfx::Size& size) {
+  auto manager = web_contents()->GetBrowserContext()->GetGuestManager();
+  if (!manager)
+    return;
+  content::WebContents* guest = manager->GetGuestByInstanceID(
+      web_contents()->GetRenderProcessHost()->GetID(), element_instance_id);
+  if (!guest)
+    return;
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  WebContents* api_guest = FromWrappedClass(isolate(), guest);
+  if (!api_guest || !api_guest->guest_delegate_)
+    return;
+
+  SetSizeParams params;
+  params.normal_size.reset(new gfx::Size(size));
+  api_guest->guest_delegate_->SetSize(params);
 }
 
 void WebContents::OnZoomLevelChanged(double level) {
+  // The guests attached later start with the level.
+  zoom_level_ = level;
+
+  // A guest that zooms itself no longer has the level it was sent.
+  if (guest_delegate_)
+    guest_delegate_->OnZoomLevelChanged(level);
+
   auto manager = web_contents()->GetBrowserContext()->GetGuestManager();
   if (!manager)
     return;
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
   manager->ForEachGuest(web_contents(),
-                        base::Bind(&NotifyZoomLevelChanged,
-                                   level));
+                        base::Bind(&WebContents::SetGuestZoomLevel,
+                                   base::Unretained(this), level));
+}
+
+bool WebContents::SetGuestZoomLevel(double level,
+                                    content::WebContents* guest) {
+  WebContents* api_guest = FromWrappedClass(isolate(), guest);
+  if (api_guest && api_guest->guest_delegate_)
+    api_guest->guest_delegate_->SetZoomLevel(level);
+  return false;
 }
 
 // static
@@ -1120,6 +1875,14 @@ void ClearWrapWebContents() {
   g_wrap_web_contents.Reset();
 }
 
+void SetIpcEmitter(v8::Isolate* isolate, v8::Local<v8::Object> ipc) {
+  g_ipc_emitter.Reset(isolate, ipc);
+}
+
+void ClearIpcEmitter() {
+  g_ipc_emitter.Reset();
+}
+
 }  // namespace api
 
 }  // namespace atom
@@ -1132,8 +1895,13 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   v8::Isolate* isolate = context->GetIsolate();
   mate::Dictionary dict(isolate, exports);
   dict.SetMethod("create", &atom::api::WebContents::Create);
+  dict.SetMethod("_broadcast", &atom::api::WebContents::Broadcast);
+  dict.SetMethod("registerStyleSheet",
+                 &atom::api::WebContents::RegisterStyleSheet);
   dict.SetMethod("_setWrapWebContents", &atom::api::SetWrapWebContents);
   dict.SetMethod("_clearWrapWebContents", &atom::api::ClearWrapWebContents);
+  dict.SetMethod("_setIpcEmitter", &atom::api::SetIpcEmitter);
+  dict.SetMethod("_clearIpcEmitter", &atom::api::ClearIpcEmitter);
 }
 
 }  // namespace
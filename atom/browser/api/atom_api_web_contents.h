@@ -5,6 +5,7 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_WEB_CONTENTS_H_
 #define ATOM_BROWSER_API_ATOM_API_WEB_CONTENTS_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -12,6 +13,10 @@
 #include "atom/browser/api/save_page_handler.h"
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/common_web_contents_delegate.h"
+#include "atom/common/ipc_channel_stats.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/shared_memory.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/common/favicon_url.h"
 #include "native_mate/handle.h"
@@ -34,17 +39,21 @@ namespace atom {
 
 struct SetSizeParams;
 class AtomBrowserContext;
+class SharedBufferRegion;
 class WebViewGuestDelegate;
 
 namespace api {
 
 class WebContents : public mate::TrackableObject<WebContents>,
                     public CommonWebContentsDelegate,
+                    public AtomJavaScriptDialogManager::Delegate,
                     public content::WebContentsObserver {
  public:
   // For node.js callback function type: function(error, buffer)
   using PrintToPDFCallback =
       base::Callback<void(v8::Local<v8::Value>, v8::Local<v8::Value>)>;
+  // function(renderedPages, totalPages)
+  using PrintToPDFProgressCallback = base::Callback<void(int, int)>;
 
   // Create from an existing WebContents.
   static mate::Handle<WebContents> CreateFrom(
@@ -54,6 +63,18 @@ class WebContents : public mate::TrackableObject<WebContents>,
   static mate::Handle<WebContents> Create(
       v8::Isolate* isolate, const mate::Dictionary& options);
 
+  // Send the message to all |targets|, the arguments are only serialized
+  // once. Returns the number of WebContents the message was sent to.
+  static int Broadcast(mate::Arguments* args,
+                       const std::vector<WebContents*>& targets,
+                       const base::string16& channel,
+                       v8::Local<v8::Value> arguments);
+
+  // Sends the style sheet to every renderer once, for insertStyleSheet and
+  // setStyleSheets to refer to by |id|.
+  static void RegisterStyleSheet(const std::string& id,
+                                 const std::string& css);
+
   // mate::TrackableObject:
   void Destroy() override;
 
@@ -66,17 +87,29 @@ class WebContents : public mate::TrackableObject<WebContents>,
   bool IsLoading() const;
   bool IsWaitingForResponse() const;
   void Stop();
+  void Reload();
   void ReloadIgnoringCache();
+  bool CanGoBack() const;
+  bool CanGoForward() const;
+  bool CanGoToOffset(int offset) const;
+  bool CanGoToIndex(int index) const;
+  void ClearHistory();
   void GoBack();
   void GoForward();
   void GoToOffset(int offset);
+  void GoToIndex(int index);
+  int GetActiveIndex() const;
+  int GetEntryCount() const;
   bool IsCrashed() const;
   void SetUserAgent(const std::string& user_agent);
   std::string GetUserAgent();
   void InsertCSS(const std::string& css);
+  void InsertStyleSheet(const std::string& id, mate::Arguments* args);
+  void SetStyleSheets(const std::vector<std::string>& ids,
+                      mate::Arguments* args);
   bool SavePage(const base::FilePath& full_file_path,
                 const content::SavePageType& save_type,
-                const SavePageHandler::SavePageCallback& callback);
+                mate::Arguments* args);
   void ExecuteJavaScript(const base::string16& code,
                          bool has_user_gesture);
   void OpenDevTools(mate::Arguments* args);
@@ -85,6 +118,13 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void ToggleDevTools();
   void EnableDeviceEmulation(const blink::WebDeviceEmulationParams& params);
   void DisableDeviceEmulation();
+
+  // Pins the network emulation rule of |client_id| to the render views of
+  // this WebContents, an empty id unpins it.
+  void SetNetworkEmulationClientId(const std::string& client_id);
+  const std::string& network_emulation_client_id() const {
+    return network_emulation_client_id_;
+  }
   void InspectElement(int x, int y);
   void InspectServiceWorker();
   void HasServiceWorker(const base::Callback<void(bool)>&);
@@ -95,7 +135,8 @@ class WebContents : public mate::TrackableObject<WebContents>,
 
   // Print current page as PDF.
   void PrintToPDF(const base::DictionaryValue& setting,
-                  const PrintToPDFCallback& callback);
+                  const PrintToPDFCallback& callback,
+                  const PrintToPDFProgressCallback& progress_callback);
 
   // DevTools workspace api.
   void AddWorkSpace(mate::Arguments* args, const base::FilePath& path);
@@ -119,22 +160,52 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void TabTraverse(bool reverse);
 
   // Send messages to browser.
-  bool SendIPCMessage(const base::string16& channel,
-                      const base::ListValue& args);
+  bool SendIPCMessage(v8::Isolate* isolate,
+                      const base::string16& channel,
+                      v8::Local<v8::Value> args);
+  void SetChannelHandler(int32 channel_id, v8::Local<v8::Function> handler);
+  std::vector<int32> CreateMessageChannel(mate::Arguments* args,
+                                          WebContents* peer);
+
+  // Returns the counters of the messages received from renderer, and
+  // optionally resets them.
+  v8::Local<v8::Value> GetIPCStats(mate::Arguments* args);
 
   // Send WebInputEvent to the page.
   void SendInputEvent(v8::Isolate* isolate, v8::Local<v8::Value> input_event);
 
+  // Send the mouse events packed in a Float64Array, see input_event_stream.h.
+  // Returns the number of events forwarded after coalescing.
+  int SendInputEvents(v8::Isolate* isolate, v8::Local<v8::Value> stream);
+
   // Subscribe to the frame updates.
-  void BeginFrameSubscription(
-      const FrameSubscriber::FrameCaptureCallback& callback);
+  void BeginFrameSubscription(mate::Arguments* args);
   void EndFrameSubscription();
 
+  // Emits the "paint" event with the frames of the page.
+  void StartPainting();
+  void StopPainting();
+  bool IsPainting() const;
+  void SetFrameRate(int frame_rate);
+  int GetFrameRate() const;
+
+  // Emits the "jank-report" event with the renderer's summaries every
+  // |interval| milliseconds, 0 stops them.
+  void SetJankReportInterval(int interval);
+
+  // The dialogs of the page that the "javascript-dialog" and
+  // "before-unload-dialog" listeners have not closed after |timeout|
+  // milliseconds get their default result, 0 waits forever.
+  void SetJavaScriptDialogTimeout(int timeout);
+
   // Methods for creating <webview>.
   void SetSize(const SetSizeParams& params);
   void SetAllowTransparency(bool allow);
   bool IsGuest() const;
 
+  // The zoom level the guests attached to this page start with.
+  double zoom_level() const { return zoom_level_; }
+
   // Returns the web preferences of current WebContents.
   v8::Local<v8::Value> GetWebPreferences(v8::Isolate* isolate);
 
@@ -155,6 +226,22 @@ class WebContents : public mate::TrackableObject<WebContents>,
       v8::Isolate* isolate) override;
   bool IsDestroyed() const override;
 
+  // CommonWebContentsDelegate:
+  AtomJavaScriptDialogManager::Delegate* GetJavaScriptDialogDelegate() override;
+
+  // AtomJavaScriptDialogManager::Delegate:
+  bool OnJavaScriptDialog(
+      content::JavaScriptMessageType type,
+      const base::string16& message_text,
+      const base::string16& default_prompt_text,
+      const GURL& origin_url,
+      const DialogClosedCallback& callback) override;
+  bool OnBeforeUnloadDialog(
+      const base::string16& message_text,
+      bool is_reload,
+      const DialogClosedCallback& callback) override;
+  base::TimeDelta GetJavaScriptDialogTimeout() override;
+
   // content::WebContentsDelegate:
   bool AddMessageToConsole(content::WebContents* source,
                            int32 level,
@@ -173,6 +260,7 @@ class WebContents : public mate::TrackableObject<WebContents>,
   content::WebContents* OpenURLFromTab(
       content::WebContents* source,
       const content::OpenURLParams& params) override;
+  bool OnGoToEntryOffset(int offset) override;
   void BeforeUnloadFired(content::WebContents* tab,
                          bool proceed,
                          bool* proceed_to_fire_unload) override;
@@ -192,6 +280,8 @@ class WebContents : public mate::TrackableObject<WebContents>,
 
   // content::WebContentsObserver:
   void BeforeUnloadFired(const base::TimeTicks& proceed_time) override;
+  void RenderViewCreated(content::RenderViewHost* render_view_host) override;
+  void RenderViewReady() override;
   void RenderViewDeleted(content::RenderViewHost*) override;
   void RenderProcessGone(base::TerminationStatus status) override;
   void DocumentLoadedInFrame(
@@ -210,6 +300,7 @@ class WebContents : public mate::TrackableObject<WebContents>,
                               bool was_ignored_by_handler) override;
   void DidStartLoading() override;
   void DidStopLoading() override;
+  void DidFirstVisuallyNonEmptyPaint() override;
   void DidGetResourceResponseStart(
       const content::ResourceRequestDetails& details) override;
   void DidGetRedirectForResourceRequest(
@@ -242,27 +333,94 @@ class WebContents : public mate::TrackableObject<WebContents>,
 
   AtomBrowserContext* GetBrowserContext() const;
 
+  // Copies the large Buffers of a message out of the shared memory sent by
+  // the renderer, after checking the region has |buffers_size| bytes. Does
+  // nothing when |buffers| is not valid.
+  bool MapSharedBuffers(const base::SharedMemoryHandle& buffers,
+                        uint32 buffers_size,
+                        scoped_refptr<SharedBufferRegion>* region);
+
   // Called when received a message from renderer.
   void OnRendererMessage(const base::string16& channel,
-                         const base::ListValue& args);
+                         const std::string& args,
+                         const base::SharedMemoryHandle& buffers,
+                         uint32 buffers_size);
+
+  // ipc.emit(channel, new Event(), args...) for a message of ipc.send, which
+  // is packed as [channel, args...].
+  void EmitIpcMessage(v8::Local<v8::Value> packed);
+
+  // Forgets the channels registered by the pages, when they have been replaced
+  // or their renderer has gone. The ids are only unique in one renderer
+  // process, so a new one would reuse them for different channels.
+  void ResetRegisteredChannels();
+
+  // Called when received a message sent by ipc.sendById.
+  void OnRegisterChannel(int32 channel_id, const base::string16& channel);
+  void OnRendererMessageById(int32 channel_id,
+                             const std::string& args,
+                             const base::SharedMemoryHandle& buffers,
+                             uint32 buffers_size);
 
   // Called when received a synchronous message from renderer.
   void OnRendererMessageSync(const base::string16& channel,
-                             const base::ListValue& args,
+                             const std::string& args,
                              IPC::Message* message);
 
-  // Called when guests need to be notified of
-  // embedders' zoom level change.
+  // Subscribes to the frames of current view for the "paint" event.
+  void SubscribePaint();
+  void OnPaint(v8::Local<v8::Value> buffer, v8::Local<v8::Value> info);
+
+  // Gives the guest attached to the element the new size of the element.
+  void OnGuestElementResized(int element_instance_id, const gfx::Size& size);
+
+  // Called when the page has changed its zoom level, which its guests follow.
   void OnZoomLevelChanged(double level);
+  // Returns false to iterate over all the guests.
+  bool SetGuestZoomLevel(double level, content::WebContents* guest);
+
+  // Records the first renderer loading Node in the startup timeline.
+  void OnNodeEnvironmentLoaded(int64 time);
+
+  void OnJankReport(const base::DictionaryValue& report);
 
   v8::Global<v8::Value> session_;
   v8::Global<v8::Value> devtools_web_contents_;
 
+  // The handlers of the channels registered by ipc.registerChannel.
+  std::map<int32, linked_ptr<v8::Global<v8::Function>>> channel_handlers_;
+  std::map<int32, std::string> channel_names_;
+
+  // The counters of the messages received from renderer.
+  IPCChannelStats ipc_stats_;
+
   scoped_ptr<WebViewGuestDelegate> guest_delegate_;
 
   // The type of current WebContents.
   Type type_;
 
+  // The frames per second of the "paint" event, and whether it is emitted.
+  int frame_rate_;
+  bool painting_;
+
+  // The zoom level the page last reported, which the guests attached to it
+  // start with. A new document or renderer has the default level.
+  double zoom_level_;
+
+  // The interval of the renderer's jank reports, 0 when they are off.
+  int jank_report_interval_;
+
+  // How long the page's dialogs wait for the listeners, 0 for no limit.
+  int javascript_dialog_timeout_;
+
+  // The registered style sheets the renderer inserts in each new document.
+  std::vector<std::string> style_sheets_;
+
+  // The client id of the network emulation rule pinned to this WebContents.
+  std::string network_emulation_client_id_;
+
+  base::WeakPtrFactory<WebContents> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(WebContents);
 };
 
@@ -4,10 +4,16 @@
 
 #include "atom/browser/api/atom_api_window.h"
 
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "atom/browser/api/atom_api_menu.h"
 #include "atom/browser/api/atom_api_web_contents.h"
 #include "atom/browser/browser.h"
 #include "atom/browser/native_window.h"
+#include "atom/common/image_encoder.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
@@ -15,6 +21,7 @@
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/node_includes.h"
 #include "atom/common/options_switches.h"
+#include "atom/common/startup_timeline.h"
 #include "content/public/browser/render_process_host.h"
 #include "native_mate/constructor.h"
 #include "native_mate/dictionary.h"
@@ -60,6 +67,30 @@ void OnCapturePageDone(
   callback.Run(gfx::Image::CreateFrom1xBitmap(bitmap));
 }
 
+void OnCapturePageEncoded(
+    v8::Isolate* isolate,
+    const base::Callback<void(v8::Local<v8::Value>)>& callback,
+    scoped_refptr<base::RefCountedBytes> data) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  if (!data.get()) {
+    callback.Run(v8::Null(isolate));
+    return;
+  }
+  callback.Run(node::Buffer::Copy(isolate, data->front_as<char>(),
+                                  data->size()).ToLocalChecked());
+}
+
+// Encodes the captured page on a worker thread.
+void OnCapturePageEncode(
+    v8::Isolate* isolate,
+    const ImageEncodeOptions& options,
+    const base::Callback<void(v8::Local<v8::Value>)>& callback,
+    const SkBitmap& bitmap) {
+  EncodeBitmapAsync(bitmap, options,
+                    base::Bind(&OnCapturePageEncoded, isolate, callback));
+}
+
 #if defined(OS_WIN)
 v8::Local<v8::Value> ToBuffer(v8::Isolate* isolate, void* val, int size) {
   auto buffer = node::Buffer::New(isolate, static_cast<char*>(val), size);
@@ -70,10 +101,25 @@ v8::Local<v8::Value> ToBuffer(v8::Isolate* isolate, void* val, int size) {
 }
 #endif
 
+// The interval of a display frame.
+const int kFrameIntervalMs = 16;
+
+#if defined(OS_WIN)
+// The most messages a batching hook holds for an interval.
+const size_t kMaxBatchedMessages = 1000;
+#endif
+
 }  // namespace
 
 
-Window::Window(v8::Isolate* isolate, const mate::Dictionary& options) {
+Window::Window(v8::Isolate* isolate, const mate::Dictionary& options)
+    : coalesce_bounds_events_(false),
+      resize_pending_(false),
+      move_pending_(false) {
+  options.Get(switches::kCoalesceBoundsEvents, &coalesce_bounds_events_);
+
+  StartupTimeline::GetInstance()->Mark("firstWindowCreated");
+
   // Use options['web-preferences'] to create WebContents.
   mate::Dictionary web_preferences = mate::Dictionary::CreateEmpty(isolate);
   options.Get(switches::kWebPreferences, &web_preferences);
@@ -102,6 +148,14 @@ Window::Window(v8::Isolate* isolate, const mate::Dictionary& options) {
   web_contents->SetOwnerWindow(window_.get());
   window_->InitFromOptions(options);
   window_->AddObserver(this);
+
+  // The offscreen window delivers its page through the "paint" event.
+  if (window_->offscreen()) {
+    int frame_rate;
+    if (options.Get(switches::kFrameRate, &frame_rate))
+      web_contents->SetFrameRate(frame_rate);
+    web_contents->StartPainting();
+  }
   AttachAsUserData(window_.get());
 }
 
@@ -128,6 +182,7 @@ void Window::OnWindowClosed() {
 
   RemoveFromWeakMap();
   window_->RemoveObserver(this);
+  bounds_events_timer_.Stop();
 
   Emit("closed");
 
@@ -160,17 +215,49 @@ void Window::OnWindowRestore() {
 }
 
 void Window::OnWindowResize() {
-  Emit("resize");
+  if (!coalesce_bounds_events_) {
+    Emit("resize");
+    return;
+  }
+  resize_pending_ = true;
+  ScheduleBoundsEvents();
 }
 
 void Window::OnWindowMove() {
-  Emit("move");
+  if (!coalesce_bounds_events_) {
+    Emit("move");
+    return;
+  }
+  move_pending_ = true;
+  ScheduleBoundsEvents();
 }
 
 void Window::OnWindowMoved() {
   Emit("moved");
 }
 
+void Window::ScheduleBoundsEvents() {
+  if (bounds_events_timer_.IsRunning())
+    return;
+  bounds_events_timer_.Start(
+      FROM_HERE, base::TimeDelta::FromMilliseconds(kFrameIntervalMs),
+      this, &Window::EmitBoundsEvents);
+}
+
+void Window::EmitBoundsEvents() {
+  // The bounds are read when the events are emitted, so the events after the
+  // last change carry the settled bounds.
+  gfx::Rect bounds = window_->GetBounds();
+  if (resize_pending_) {
+    resize_pending_ = false;
+    Emit("resize", bounds);
+  }
+  if (move_pending_) {
+    move_pending_ = false;
+    Emit("move", bounds);
+  }
+}
+
 void Window::OnWindowEnterFullScreen() {
   Emit("enter-full-screen");
 }
@@ -201,12 +288,80 @@ void Window::OnExecuteWindowsCommand(const std::string& command_name) {
 
 #if defined(OS_WIN)
 void Window::OnWindowMessage(UINT message, WPARAM w_param, LPARAM l_param) {
-  if (IsWindowMessageHooked(message)) {
-    messages_callback_map_[message].Run(
+  auto it = messages_callback_map_.find(message);
+  if (it == messages_callback_map_.end() || !it->second.Matches(w_param))
+    return;
+
+  MessageHook& hook = it->second;
+  if (!hook.batch && hook.interval == base::TimeDelta()) {
+    hook.callback.Run(
         ToBuffer(isolate(), static_cast<void*>(&w_param), sizeof(WPARAM)),
         ToBuffer(isolate(), static_cast<void*>(&l_param), sizeof(LPARAM)));
+    return;
+  }
+
+  if (!hook.batch)
+    hook.pending.clear();
+  if (hook.pending.size() < kMaxBatchedMessages)
+    hook.pending.push_back(std::make_pair(w_param, l_param));
+  if (!hook.timer->IsRunning()) {
+    hook.timer->Start(FROM_HERE, hook.interval,
+                      base::Bind(&Window::FlushWindowMessages,
+                                 base::Unretained(this), message));
   }
 }
+
+void Window::FlushWindowMessages(UINT message) {
+  auto it = messages_callback_map_.find(message);
+  if (it == messages_callback_map_.end())
+    return;
+
+  std::vector<std::pair<WPARAM, LPARAM>> messages;
+  messages.swap(it->second.pending);
+  if (messages.empty())
+    return;
+
+  // The callback can unhook the message, so it is copied before running.
+  MessageCallback callback = it->second.callback;
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  if (!it->second.batch) {
+    callback.Run(
+        ToBuffer(isolate(), &messages[0].first, sizeof(WPARAM)),
+        ToBuffer(isolate(), &messages[0].second, sizeof(LPARAM)));
+    return;
+  }
+
+  // The batch is an array of [wParam, lParam] pairs.
+  v8::Local<v8::Array> batch = v8::Array::New(isolate(), messages.size());
+  for (size_t i = 0; i < messages.size(); ++i) {
+    v8::Local<v8::Array> pair = v8::Array::New(isolate(), 2);
+    pair->Set(0, ToBuffer(isolate(), &messages[i].first, sizeof(WPARAM)));
+    pair->Set(1, ToBuffer(isolate(), &messages[i].second, sizeof(LPARAM)));
+    batch->Set(static_cast<uint32_t>(i), pair);
+  }
+  callback.Run(batch, v8::Undefined(isolate()));
+}
+
+Window::MessageHook::MessageHook()
+    : has_w_param_range(false),
+      w_param_min(0),
+      w_param_max(0),
+      batch(false),
+      timer(new base::Timer(false, false)) {
+}
+
+Window::MessageHook::~MessageHook() {
+}
+
+bool Window::MessageHook::Matches(WPARAM w_param) const {
+  if (w_params.empty() && !has_w_param_range)
+    return true;
+  if (std::find(w_params.begin(), w_params.end(), w_param) != w_params.end())
+    return true;
+  return has_w_param_range && w_param >= w_param_min &&
+         w_param <= w_param_max;
+}
 #endif
 
 // static
@@ -293,12 +448,41 @@ bool Window::IsFullscreen() {
   return window_->IsFullscreen();
 }
 
+// static
+void Window::SetStates(const std::vector<Window*>& windows,
+                       const std::vector<mate::Dictionary>& states) {
+  std::vector<NativeWindow*> native_windows;
+  for (Window* window : windows)
+    if (window && !window->IsDestroyed())
+      native_windows.push_back(window->window_.get());
+
+  for (NativeWindow* window : native_windows)
+    window->BeginStateUpdate();
+  for (size_t i = 0; i < windows.size() && i < states.size(); ++i)
+    if (windows[i] && !windows[i]->IsDestroyed())
+      windows[i]->window_->SetState(states[i]);
+  for (NativeWindow* window : native_windows)
+    window->EndStateUpdate();
+}
+
+void Window::SetState(const mate::Dictionary& state) {
+  window_->BeginStateUpdate();
+  window_->SetState(state);
+  window_->EndStateUpdate();
+}
+
 void Window::SetBounds(const gfx::Rect& bounds) {
   window_->SetBounds(bounds);
 }
 
-gfx::Rect Window::GetBounds() {
-  return window_->GetBounds();
+v8::Local<v8::Value> Window::GetBounds(mate::Arguments* args) {
+  gfx::Rect bounds = window_->GetBounds();
+  // The bounds can be written into an Int32Array the caller reuses, which is
+  // cheaper than creating an object on every call.
+  v8::Local<v8::Value> array;
+  if (args->GetNext(&array) && mate::RectToInt32Array(bounds, array))
+    return array;
+  return mate::ConvertToV8(isolate(), bounds);
 }
 
 void Window::SetSize(int width, int height) {
@@ -442,18 +626,46 @@ bool Window::IsDocumentEdited() {
 }
 
 void Window::CapturePage(mate::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
   gfx::Rect rect;
-  base::Callback<void(const gfx::Image&)> callback;
-
-  if (!(args->Length() == 1 && args->GetNext(&callback)) &&
-      !(args->Length() == 2 && args->GetNext(&rect)
-                            && args->GetNext(&callback))) {
-    args->ThrowError();
-    return;
+  ImageEncodeOptions options;
+  bool encode = false;
+  bool valid = args->Length() == 1;
+  if (args->Length() == 3) {
+    valid = args->GetNext(&rect) && args->GetNext(&options);
+    encode = true;
+  } else if (args->Length() == 2) {
+    // A single object is taken as the options when it has a format.
+    v8::Local<v8::Value> first;
+    mate::Dictionary dict;
+    std::string format;
+    args->GetNext(&first);
+    if (mate::ConvertFromV8(isolate, first, &dict) &&
+        dict.Get("format", &format)) {
+      valid = mate::ConvertFromV8(isolate, first, &options);
+      encode = true;
+    } else {
+      valid = mate::ConvertFromV8(isolate, first, &rect);
+    }
   }
 
-  window_->CapturePage(
-      rect, base::Bind(&OnCapturePageDone, args->isolate(), callback));
+  if (encode) {
+    base::Callback<void(v8::Local<v8::Value>)> callback;
+    if (!valid || !args->GetNext(&callback)) {
+      args->ThrowError();
+      return;
+    }
+    window_->CapturePage(
+        rect, base::Bind(&OnCapturePageEncode, isolate, options, callback));
+  } else {
+    base::Callback<void(const gfx::Image&)> callback;
+    if (!valid || !args->GetNext(&callback)) {
+      args->ThrowError();
+      return;
+    }
+    window_->CapturePage(
+        rect, base::Bind(&OnCapturePageDone, isolate, callback));
+  }
 }
 
 void Window::SetProgressBar(double progress) {
@@ -513,9 +725,39 @@ bool Window::IsMenuBarVisible() {
 }
 
 #if defined(OS_WIN)
-bool Window::HookWindowMessage(UINT message,
-                               const MessageCallback& callback) {
-  messages_callback_map_[message] = callback;
+bool Window::HookWindowMessage(UINT message, mate::Arguments* args) {
+  // hookWindowMessage(message[, options], callback)
+  MessageHook hook;
+  mate::Dictionary options;
+  if (args->GetNext(&options)) {
+    int64_t w_param;
+    std::vector<int64_t> w_params;
+    if (options.Get("wParam", &w_params)) {
+      for (int64_t value : w_params)
+        hook.w_params.push_back(static_cast<WPARAM>(value));
+    } else if (options.Get("wParam", &w_param)) {
+      hook.w_params.push_back(static_cast<WPARAM>(w_param));
+    }
+    std::vector<int64_t> range;
+    if (options.Get("wParamRange", &range) && range.size() == 2) {
+      hook.has_w_param_range = true;
+      hook.w_param_min = static_cast<WPARAM>(range[0]);
+      hook.w_param_max = static_cast<WPARAM>(range[1]);
+    }
+    int interval = 0;
+    if (options.Get("interval", &interval) && interval > 0)
+      hook.interval = base::TimeDelta::FromMilliseconds(interval);
+    options.Get("batch", &hook.batch);
+    if (hook.batch && hook.interval == base::TimeDelta())
+      hook.interval =
+          base::TimeDelta::FromMilliseconds(kFrameIntervalMs);
+  }
+  if (!args->GetNext(&hook.callback)) {
+    args->ThrowError();
+    return false;
+  }
+
+  messages_callback_map_[message] = hook;
   return true;
 }
 
@@ -589,6 +831,7 @@ void Window::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("isFullScreen", &Window::IsFullscreen)
       .SetMethod("setAspectRatio", &Window::SetAspectRatio)
       .SetMethod("getBounds", &Window::GetBounds)
+      .SetMethod("setState", &Window::SetState)
       .SetMethod("setBounds", &Window::SetBounds)
       .SetMethod("getSize", &Window::GetSize)
       .SetMethod("setSize", &Window::SetSize)
@@ -676,6 +919,7 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                            &mate::TrackableObject<Window>::FromWeakMapID);
   browser_window.SetMethod("getAllWindows",
                            &mate::TrackableObject<Window>::GetAll);
+  browser_window.SetMethod("_setStates", &Window::SetStates);
 
   mate::Dictionary dict(isolate, exports);
   dict.Set("BrowserWindow", browser_window);
@@ -9,7 +9,9 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/linked_ptr.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/timer/timer.h"
 #include "ui/gfx/image/image.h"
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/native_window.h"
@@ -44,6 +46,11 @@ class Window : public mate::TrackableObject<Window>,
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::ObjectTemplate> prototype);
 
+  // Applies |states| to |windows|, and shows the changes of all of them
+  // together.
+  static void SetStates(const std::vector<Window*>& windows,
+                        const std::vector<mate::Dictionary>& states);
+
   // Returns the BrowserWindow object from |native_window|.
   static v8::Local<v8::Value> From(v8::Isolate* isolate,
                                    NativeWindow* native_window);
@@ -87,6 +94,10 @@ class Window : public mate::TrackableObject<Window>,
   // mate::TrackableObject:
   void Destroy() override;
 
+  // Emits the resize and move events that happened since the last frame.
+  void ScheduleBoundsEvents();
+  void EmitBoundsEvents();
+
   // APIs for NativeWindow.
   void Close();
   bool IsClosed();
@@ -104,8 +115,9 @@ class Window : public mate::TrackableObject<Window>,
   bool IsMinimized();
   void SetFullScreen(bool fullscreen);
   bool IsFullscreen();
+  void SetState(const mate::Dictionary& state);
   void SetBounds(const gfx::Rect& bounds);
-  gfx::Rect GetBounds();
+  v8::Local<v8::Value> GetBounds(mate::Arguments* args);
   void SetSize(int width, int height);
   std::vector<int> GetSize();
   void SetContentSize(int width, int height);
@@ -152,7 +164,7 @@ class Window : public mate::TrackableObject<Window>,
   typedef base::Callback<void(v8::Local<v8::Value>,
                               v8::Local<v8::Value>)> MessageCallback;
 
-  bool HookWindowMessage(UINT message, const MessageCallback& callback);
+  bool HookWindowMessage(UINT message, mate::Arguments* args);
   bool IsWindowMessageHooked(UINT message);
   void UnhookWindowMessage(UINT message);
   void UnhookAllWindowMessages();
@@ -169,7 +181,34 @@ class Window : public mate::TrackableObject<Window>,
   v8::Local<v8::Value> WebContents(v8::Isolate* isolate);
 
 #if defined(OS_WIN)
-  typedef std::map<UINT, MessageCallback> MessageCallbackMap;
+  // Delivers the messages a hook held back for its interval.
+  void FlushWindowMessages(UINT message);
+
+  struct MessageHook {
+    MessageHook();
+    ~MessageHook();
+
+    bool Matches(WPARAM w_param) const;
+
+    MessageCallback callback;
+
+    // When set, only the messages whose wParam is one of |w_params| or is in
+    // the range match.
+    std::vector<WPARAM> w_params;
+    bool has_w_param_range;
+    WPARAM w_param_min;
+    WPARAM w_param_max;
+
+    // Without an interval nor batching the messages are delivered as they
+    // come, otherwise the latest message, or all of them when batching, is
+    // delivered at the end of the interval.
+    base::TimeDelta interval;
+    bool batch;
+    std::vector<std::pair<WPARAM, LPARAM>> pending;
+    linked_ptr<base::Timer> timer;
+  };
+
+  typedef std::map<UINT, MessageHook> MessageCallbackMap;
   MessageCallbackMap messages_callback_map_;
 #endif
 
@@ -178,6 +217,13 @@ class Window : public mate::TrackableObject<Window>,
 
   api::WebContents* api_web_contents_;
 
+  // The resize and move events are coalesced into one per frame, which
+  // carries the bounds of the window when it is emitted.
+  bool coalesce_bounds_events_;
+  bool resize_pending_;
+  bool move_pending_;
+  base::OneShotTimer<Window> bounds_events_timer_;
+
   scoped_ptr<NativeWindow> window_;
 
   DISALLOW_COPY_AND_ASSIGN(Window);
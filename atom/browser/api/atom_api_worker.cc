@@ -0,0 +1,80 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_worker.h"
+
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+#include "atom/common/node_includes.h"
+#include "native_mate/dictionary.h"
+
+namespace atom {
+
+namespace api {
+
+Worker::Worker(const base::FilePath& init_script,
+               const base::FilePath& module_path)
+    : worker_(new JavaScriptWorker(this, init_script, module_path)) {
+  worker_->Start();
+}
+
+Worker::~Worker() {
+}
+
+void Worker::OnWorkerMessage(const std::string& data,
+                             SharedBufferRegion* region) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Value> message =
+      V8ValueSerializer::Deserialize(isolate(), data, region);
+  if (!message.IsEmpty())
+    Emit("message", message);
+}
+
+void Worker::OnWorkerError(const std::string& stack) {
+  Emit("error", stack);
+}
+
+void Worker::OnWorkerExit() {
+  Emit("exit");
+}
+
+bool Worker::PostMessage(v8::Local<v8::Value> message) {
+  return worker_->PostMessage(isolate(), message);
+}
+
+void Worker::Terminate() {
+  worker_->Terminate();
+}
+
+mate::ObjectTemplateBuilder Worker::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return mate::ObjectTemplateBuilder(isolate)
+      .SetMethod("postMessage", &Worker::PostMessage)
+      .SetMethod("terminate", &Worker::Terminate);
+}
+
+// static
+mate::Handle<Worker> Worker::Create(v8::Isolate* isolate,
+                                    const base::FilePath& init_script,
+                                    const base::FilePath& module_path) {
+  return mate::CreateHandle(isolate, new Worker(init_script, module_path));
+}
+
+}  // namespace api
+
+}  // namespace atom
+
+namespace {
+
+void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
+                v8::Local<v8::Context> context, void* priv) {
+  v8::Isolate* isolate = context->GetIsolate();
+  mate::Dictionary dict(isolate, exports);
+  dict.SetMethod("createWorker", &atom::api::Worker::Create);
+}
+
+}  // namespace
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(atom_browser_worker, Initialize);
@@ -0,0 +1,56 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_ATOM_API_WORKER_H_
+#define ATOM_BROWSER_API_ATOM_API_WORKER_H_
+
+#include <string>
+
+#include "atom/browser/api/event_emitter.h"
+#include "atom/browser/javascript_worker.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_ptr.h"
+#include "native_mate/handle.h"
+
+namespace atom {
+
+namespace api {
+
+// The main process' side of a JavaScriptWorker, the worker is terminated when
+// this is destroyed.
+class Worker : public mate::EventEmitter,
+               public JavaScriptWorker::Delegate {
+ public:
+  static mate::Handle<Worker> Create(v8::Isolate* isolate,
+                                     const base::FilePath& init_script,
+                                     const base::FilePath& module_path);
+
+ protected:
+  Worker(const base::FilePath& init_script, const base::FilePath& module_path);
+  ~Worker();
+
+  // JavaScriptWorker::Delegate:
+  void OnWorkerMessage(const std::string& data,
+                       SharedBufferRegion* region) override;
+  void OnWorkerError(const std::string& stack) override;
+  void OnWorkerExit() override;
+
+  bool PostMessage(v8::Local<v8::Value> message);
+  void Terminate();
+
+ private:
+  // mate::Wrappable:
+  mate::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+
+  scoped_ptr<JavaScriptWorker> worker_;
+
+  DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_ATOM_API_WORKER_H_
@@ -53,6 +53,19 @@ v8::Local<v8::Object> EventEmitter::CreateJSEvent(
   return event;
 }
 
+v8::Local<v8::Function> EventEmitter::GetEmitFunction(
+    v8::Local<v8::Object> wrapper) {
+  if (emit_.IsEmpty()) {
+    // The emitters get EventEmitter.prototype right after they are wrapped
+    // and never replace their emit, so it does not change once found.
+    v8::Local<v8::Value> emit = wrapper->Get(StringToV8(isolate(), "emit"));
+    if (!emit->IsFunction())
+      return v8::Local<v8::Function>();
+    emit_.Reset(isolate(), v8::Local<v8::Function>::Cast(emit));
+  }
+  return v8::Local<v8::Function>::New(isolate(), emit_);
+}
+
 v8::Local<v8::Object> EventEmitter::CreateCustomEvent(
     v8::Isolate* isolate, v8::Local<v8::Object> custom_event) {
   v8::Local<v8::Object> event = CreateEventObject(isolate);
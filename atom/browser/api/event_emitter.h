@@ -30,6 +30,10 @@ class EventEmitter : public Wrappable {
   bool EmitCustomEvent(const base::StringPiece& name,
                        v8::Local<v8::Object> event,
                        const Args&... args) {
+    v8::Locker locker(isolate());
+    v8::HandleScope handle_scope(isolate());
+    if (!HasListeners(name))
+      return false;
     return EmitWithEvent(name, CreateCustomEvent(isolate(), event), args...);
   }
 
@@ -47,13 +51,31 @@ class EventEmitter : public Wrappable {
                       const Args&... args) {
     v8::Locker locker(isolate());
     v8::HandleScope handle_scope(isolate());
+    // Nothing is created or converted when nobody listens, unless there is a
+    // message which has to be replied by a listener.
+    if (!message && !HasListeners(name))
+      return false;
     v8::Local<v8::Object> event = CreateJSEvent(isolate(), sender, message);
     return EmitWithEvent(name, event, args...);
   }
 
+  // Whether this.emit(name) would call any listener. The arguments of Emit
+  // are only converted when it does, callers that do more work to prepare
+  // them can check this first.
+  bool HasListeners(const base::StringPiece& name) {
+    v8::Locker locker(isolate());
+    v8::HandleScope handle_scope(isolate());
+    return mate::HasListeners(isolate(), GetWrapper(isolate()), name);
+  }
+
  protected:
   EventEmitter();
 
+  // new Event(sender, message), or a plain event when |message| is null.
+  v8::Local<v8::Object> CreateJSEvent(v8::Isolate* isolate,
+                                      content::WebContents* sender,
+                                      IPC::Message* message);
+
  private:
   // this.emit(name, event, args...);
   template<typename... Args>
@@ -62,17 +84,31 @@ class EventEmitter : public Wrappable {
                      const Args&... args) {
     v8::Locker locker(isolate());
     v8::HandleScope handle_scope(isolate());
-    EmitEvent(isolate(), GetWrapper(isolate()), name, event, args...);
+    internal::ValueVector converted_args = {
+        StringToV8(isolate(), name),
+        event,
+        ConvertToV8(isolate(), args)...,
+    };
+    v8::Local<v8::Object> wrapper = GetWrapper(isolate());
+    v8::Local<v8::Function> emit = GetEmitFunction(wrapper);
+    if (emit.IsEmpty())
+      internal::CallEmitWithArgs(isolate(), wrapper, &converted_args);
+    else
+      internal::CallEmitWithArgs(isolate(), wrapper, emit, &converted_args);
     return event->Get(
         StringToV8(isolate(), "defaultPrevented"))->BooleanValue();
   }
 
-  v8::Local<v8::Object> CreateJSEvent(v8::Isolate* isolate,
-                                      content::WebContents* sender,
-                                      IPC::Message* message);
+  // Returns this.emit, which is looked up once and then reused, or an empty
+  // handle when it is not a function yet.
+  v8::Local<v8::Function> GetEmitFunction(v8::Local<v8::Object> wrapper);
+
   v8::Local<v8::Object> CreateCustomEvent(
       v8::Isolate* isolate, v8::Local<v8::Object> event);
 
+  // The cached this.emit.
+  v8::Global<v8::Function> emit_;
+
   DISALLOW_COPY_AND_ASSIGN(EventEmitter);
 };
 
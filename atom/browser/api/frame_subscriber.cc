@@ -4,19 +4,237 @@
 
 #include "atom/browser/api/frame_subscriber.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
 #include "atom/common/node_includes.h"
 #include "base/bind.h"
+#include "base/task_runner.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "base/trace_event/trace_event.h"
+#include "content/public/browser/browser_thread.h"
 #include "media/base/video_frame.h"
 #include "media/base/yuv_convert.h"
+#include "native_mate/dictionary.h"
+#include "ui/gfx/geometry/rect_conversions.h"
+
+using content::BrowserThread;
 
 namespace atom {
 
 namespace api {
 
+namespace {
+
+// The default of Options::max_pending_frames.
+const int kMaxPendingFrames = 3;
+
+// The memory of collected Buffers that is kept for the next frames.
+const size_t kMaxFreeBuffers = 4;
+
+// Called when a Buffer created from a FrameBuffer is collected.
+void ReleaseFrameBuffer(char* data, void* hint) {
+  static_cast<FrameBuffer*>(hint)->Release();
+}
+
+// The size of the U and V planes in each direction.
+int GetChromaSize(int size) {
+  return (size + 1) / 2;
+}
+
+// Returns the strides of the planes of a |width| wide area, the planes are
+// stored one after another without padding.
+std::vector<int> GetStrides(FrameSubscriber::Format format, int width) {
+  std::vector<int> strides;
+  switch (format) {
+    case FrameSubscriber::FORMAT_RGB:
+      strides.push_back(width * 4);
+      break;
+    case FrameSubscriber::FORMAT_I420:
+      strides.push_back(width);
+      strides.push_back(GetChromaSize(width));
+      strides.push_back(GetChromaSize(width));
+      break;
+    case FrameSubscriber::FORMAT_NV12:
+      strides.push_back(width);
+      strides.push_back(GetChromaSize(width) * 2);
+      break;
+  }
+  return strides;
+}
+
+size_t GetLength(FrameSubscriber::Format format, const gfx::Size& size) {
+  if (format == FrameSubscriber::FORMAT_RGB)
+    return size.GetArea() * 4;
+  return size.GetArea() +
+         GetChromaSize(size.width()) * GetChromaSize(size.height()) * 2;
+}
+
+const char* GetFormatName(FrameSubscriber::Format format) {
+  switch (format) {
+    case FrameSubscriber::FORMAT_I420: return "i420";
+    case FrameSubscriber::FORMAT_NV12: return "nv12";
+    default: return "rgb";
+  }
+}
+
+// Grows |rect| to even coordinates so it starts at a pixel of the U and V
+// planes.
+gfx::Rect AlignToChroma(const gfx::Rect& rect) {
+  int x = rect.x() & ~1;
+  int y = rect.y() & ~1;
+  int right = (rect.right() + 1) & ~1;
+  int bottom = (rect.bottom() + 1) & ~1;
+  return gfx::Rect(x, y, right - x, bottom - y);
+}
+
+const uint8* GetPlaneData(media::VideoFrame* frame, size_t plane,
+                          const gfx::Rect& rect) {
+  int shift = plane == media::VideoFrame::kYPlane ? 0 : 1;
+  return frame->data(plane) + (rect.y() >> shift) * frame->stride(plane) +
+         (rect.x() >> shift);
+}
+
+void CopyPlane(const uint8* source, int source_stride,
+               uint8* dest, int dest_stride, int width, int rows) {
+  for (int i = 0; i < rows; ++i)
+    memcpy(dest + i * dest_stride, source + i * source_stride, width);
+}
+
+// Writes the |rect| area of |frame| in |format| into |frame_buffer|, runs on
+// the blocking pool.
+void ConvertFrame(scoped_refptr<media::VideoFrame> frame,
+                  scoped_refptr<FrameBuffer> frame_buffer,
+                  FrameSubscriber::Format format,
+                  const gfx::Rect& rect) {
+  TRACE_EVENT2("electron.capture", "FrameSubscriber::ConvertFrame",
+               "width", rect.width(), "height", rect.height());
+  const uint8* y = GetPlaneData(frame.get(), media::VideoFrame::kYPlane, rect);
+  const uint8* u = GetPlaneData(frame.get(), media::VideoFrame::kUPlane, rect);
+  const uint8* v = GetPlaneData(frame.get(), media::VideoFrame::kVPlane, rect);
+  int y_stride = frame->stride(media::VideoFrame::kYPlane);
+  int u_stride = frame->stride(media::VideoFrame::kUPlane);
+  int v_stride = frame->stride(media::VideoFrame::kVPlane);
+  uint8* dest = reinterpret_cast<uint8*>(frame_buffer->data());
+  int width = rect.width();
+  int height = rect.height();
+  int chroma_width = GetChromaSize(width);
+  int chroma_height = GetChromaSize(height);
+
+  switch (format) {
+    case FrameSubscriber::FORMAT_RGB:
+      media::ConvertYUVToRGB32(y, u, v, dest, width, height,
+                               y_stride, u_stride, width * 4,
+                               media::YV12);
+      break;
+    case FrameSubscriber::FORMAT_I420:
+      CopyPlane(y, y_stride, dest, width, width, height);
+      dest += width * height;
+      CopyPlane(u, u_stride, dest, chroma_width, chroma_width, chroma_height);
+      dest += chroma_width * chroma_height;
+      CopyPlane(v, v_stride, dest, chroma_width, chroma_width, chroma_height);
+      break;
+    case FrameSubscriber::FORMAT_NV12:
+      CopyPlane(y, y_stride, dest, width, width, height);
+      dest += width * height;
+      for (int row = 0; row < chroma_height; ++row) {
+        const uint8* u_row = u + row * u_stride;
+        const uint8* v_row = v + row * v_stride;
+        for (int i = 0; i < chroma_width; ++i) {
+          *dest++ = u_row[i];
+          *dest++ = v_row[i];
+        }
+      }
+      break;
+  }
+}
+
+}  // namespace
+
+FrameBufferPool::FrameBufferPool(size_t buffer_size)
+    : buffer_size_(buffer_size) {
+}
+
+FrameBufferPool::~FrameBufferPool() {
+  for (char* data : free_buffers_)
+    delete[] data;
+}
+
+char* FrameBufferPool::Acquire() {
+  {
+    base::AutoLock auto_lock(lock_);
+    if (!free_buffers_.empty()) {
+      char* data = free_buffers_.back();
+      free_buffers_.pop_back();
+      return data;
+    }
+  }
+  return new char[buffer_size_];
+}
+
+void FrameBufferPool::Recycle(char* data) {
+  {
+    base::AutoLock auto_lock(lock_);
+    if (free_buffers_.size() < kMaxFreeBuffers) {
+      free_buffers_.push_back(data);
+      return;
+    }
+  }
+  delete[] data;
+}
+
+FrameBuffer::FrameBuffer(FrameBufferPool* pool)
+    : pool_(pool), data_(pool->Acquire()) {
+}
+
+FrameBuffer::~FrameBuffer() {
+  pool_->Recycle(data_);
+}
+
+v8::MaybeLocal<v8::Object> FrameBuffer::CreateBuffer(v8::Isolate* isolate,
+                                                     size_t length) {
+  AddRef();
+  v8::MaybeLocal<v8::Object> buffer = node::Buffer::New(
+      isolate, data_, length, &ReleaseFrameBuffer, this);
+  if (buffer.IsEmpty())
+    Release();
+  return buffer;
+}
+
+FrameSubscriber::Options::Options()
+    : ring_size(0),
+      format(FORMAT_RGB),
+      only_dirty(false),
+      max_pending_frames(kMaxPendingFrames) {
+}
+
 FrameSubscriber::FrameSubscriber(v8::Isolate* isolate,
-                                 const gfx::Size& size,
+                                 const gfx::Size& view_size,
+                                 const Options& options,
                                  const FrameCaptureCallback& callback)
-    : isolate_(isolate), size_(size), callback_(callback) {
+    : isolate_(isolate),
+      view_size_(view_size),
+      size_(options.size.IsEmpty() ? view_size : options.size),
+      format_(options.format),
+      only_dirty_(options.only_dirty),
+      min_interval_(options.min_interval),
+      max_pending_frames_(std::max(options.max_pending_frames, 1)),
+      callback_(callback),
+      buffer_pool_(new FrameBufferPool(GetLength(format_, size_))),
+      ring_(options.ring_size > 0 ? options.ring_size : 0),
+      ring_memory_(ring_.size()),
+      ring_index_(0),
+      task_runner_(
+          BrowserThread::GetBlockingPool()->GetTaskRunnerWithShutdownBehavior(
+              base::SequencedWorkerPool::SKIP_ON_SHUTDOWN)),
+      converting_(false),
+      pending_frames_(0),
+      weak_factory_(this) {
+}
+
+FrameSubscriber::~FrameSubscriber() {
 }
 
 bool FrameSubscriber::ShouldCaptureFrame(
@@ -24,41 +242,128 @@ bool FrameSubscriber::ShouldCaptureFrame(
     base::TimeTicks present_time,
     scoped_refptr<media::VideoFrame>* storage,
     DeliverFrameCallback* callback) {
-  *storage = media::VideoFrame::CreateFrame(media::VideoFrame::YV12, size_,
-                                            gfx::Rect(size_), size_,
-                                            base::TimeDelta());
+  gfx::Rect rect(size_);
+  if (only_dirty_) {
+    // The damage is in the coordinates of the view.
+    gfx::Rect damage = damage_rect;
+    if (size_ != view_size_ && !view_size_.IsEmpty()) {
+      damage = gfx::ToEnclosingRect(gfx::ScaleRect(
+          gfx::RectF(damage_rect),
+          static_cast<float>(size_.width()) / view_size_.width(),
+          static_cast<float>(size_.height()) / view_size_.height()));
+    }
+    // The damage of the frames that were skipped has not been delivered yet.
+    pending_damage_.Union(damage);
+    rect.Intersect(pending_damage_);
+    if (rect.IsEmpty())
+      return false;
+    rect = AlignToChroma(rect);
+    rect.Intersect(gfx::Rect(size_));
+  }
+
+  // Skip the frame before it is read back when it comes too early, or when
+  // the frames before it have not reached the callback yet.
+  if (!last_capture_time_.is_null() &&
+      present_time - last_capture_time_ < min_interval_)
+    return false;
+  if (pending_frames_ >= max_pending_frames_)
+    return false;
+
+  // Reuse a frame that is no longer referenced by a pending delivery.
+  scoped_refptr<media::VideoFrame> frame;
+  for (const auto& pending : frames_) {
+    if (pending->HasOneRef()) {
+      frame = pending;
+      break;
+    }
+  }
+  if (!frame.get()) {
+    if (frames_.size() >= max_pending_frames_)
+      return false;
+    frame = media::VideoFrame::CreateFrame(media::VideoFrame::YV12, size_,
+                                           gfx::Rect(size_), size_,
+                                           base::TimeDelta());
+    frames_.push_back(frame);
+  }
+
+  *storage = frame;
   *callback = base::Bind(&FrameSubscriber::OnFrameDelivered,
                          base::Unretained(this),
-                         *storage);
+                         frame, rect);
+  last_capture_time_ = present_time;
+  ++pending_frames_;
+  pending_damage_ = gfx::Rect();
   return true;
 }
 
-void FrameSubscriber::OnFrameDelivered(
-    scoped_refptr<media::VideoFrame> frame, base::TimeTicks, bool result) {
-  if (!result)
+void FrameSubscriber::OnFrameDelivered(scoped_refptr<media::VideoFrame> frame,
+                                       const gfx::Rect& rect,
+                                       base::TimeTicks timestamp,
+                                       bool result) {
+  // Drop the frame instead of queueing it when the conversion or the
+  // callback can not keep up with the view.
+  if (!result || converting_) {
+    --pending_frames_;
+    if (only_dirty_)
+      pending_damage_.Union(rect);
     return;
+  }
 
-  gfx::Rect rect = frame->visible_rect();
-  size_t rgb_arr_size = rect.width() * rect.height() * 4;
-  v8::MaybeLocal<v8::Object> buffer = node::Buffer::New(isolate_, rgb_arr_size);
-  if (buffer.IsEmpty())
-    return;
+  size_t ring_index = ring_index_;
+  scoped_refptr<FrameBuffer> frame_buffer;
+  if (ring_.empty()) {
+    frame_buffer = new FrameBuffer(buffer_pool_.get());
+  } else {
+    ring_index_ = (ring_index_ + 1) % ring_.size();
+    if (!ring_memory_[ring_index].get())
+      ring_memory_[ring_index] = new FrameBuffer(buffer_pool_.get());
+    frame_buffer = ring_memory_[ring_index];
+  }
 
-  // Convert a frame of YUV to 32 bit ARGB.
-  media::ConvertYUVToRGB32(frame->data(media::VideoFrame::kYPlane),
-                           frame->data(media::VideoFrame::kUPlane),
-                           frame->data(media::VideoFrame::kVPlane),
-                           reinterpret_cast<uint8*>(
-                              node::Buffer::Data(buffer.ToLocalChecked())),
-                           rect.width(), rect.height(),
-                           frame->stride(media::VideoFrame::kYPlane),
-                           frame->stride(media::VideoFrame::kUVPlane),
-                           rect.width() * 4,
-                           media::YV12);
+  converting_ = true;
+  task_runner_->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&ConvertFrame, frame, frame_buffer, format_, rect),
+      base::Bind(&FrameSubscriber::OnFrameConverted,
+                 weak_factory_.GetWeakPtr(), frame_buffer, ring_index, rect,
+                 timestamp));
+}
+
+void FrameSubscriber::OnFrameConverted(
+    scoped_refptr<FrameBuffer> frame_buffer,
+    size_t ring_index,
+    const gfx::Rect& rect,
+    base::TimeTicks timestamp) {
+  TRACE_EVENT0("electron.capture", "FrameSubscriber::OnFrameConverted");
+  converting_ = false;
+  --pending_frames_;
 
   v8::Locker locker(isolate_);
   v8::HandleScope handle_scope(isolate_);
-  callback_.Run(buffer.ToLocalChecked());
+  v8::Local<v8::Object> buffer;
+  if (ring_.empty()) {
+    size_t length = GetLength(format_, rect.size());
+    if (!frame_buffer->CreateBuffer(isolate_, length).ToLocal(&buffer))
+      return;
+  } else if (ring_[ring_index].IsEmpty()) {
+    // The Buffers of the ring can hold a whole frame.
+    size_t length = frame_buffer->size();
+    if (!frame_buffer->CreateBuffer(isolate_, length).ToLocal(&buffer))
+      return;
+    ring_[ring_index].Reset(isolate_, buffer);
+  } else {
+    buffer = v8::Local<v8::Object>::New(isolate_, ring_[ring_index]);
+  }
+
+  mate::Dictionary info = mate::Dictionary::CreateEmpty(isolate_);
+  info.Set("format", GetFormatName(format_));
+  info.Set("x", rect.x());
+  info.Set("y", rect.y());
+  info.Set("width", rect.width());
+  info.Set("height", rect.height());
+  info.Set("strides", GetStrides(format_, rect.width()));
+  info.Set("timestamp", (timestamp - base::TimeTicks()).InMillisecondsF());
+  callback_.Run(buffer, info.GetHandle());
 }
 
 }  // namespace api
@@ -5,22 +5,121 @@
 #ifndef ATOM_BROWSER_API_FRAME_SUBSCRIBER_H_
 #define ATOM_BROWSER_API_FRAME_SUBSCRIBER_H_
 
+#include <vector>
+
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "content/public/browser/render_widget_host_view_frame_subscriber.h"
+#include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/geometry/size.h"
 #include "v8/include/v8.h"
 
+namespace base {
+class TaskRunner;
+}
+
 namespace atom {
 
 namespace api {
 
+// Keeps the memory of the collected frame Buffers so the next frames can be
+// written into it instead of allocating new memory.
+class FrameBufferPool : public base::RefCountedThreadSafe<FrameBufferPool> {
+ public:
+  explicit FrameBufferPool(size_t buffer_size);
+
+  size_t buffer_size() const { return buffer_size_; }
+
+  // Returns a free buffer of buffer_size() bytes, or allocates a new one.
+  char* Acquire();
+
+  // Puts |data| back to the pool, or frees it when the pool is full.
+  void Recycle(char* data);
+
+ private:
+  friend class base::RefCountedThreadSafe<FrameBufferPool>;
+
+  ~FrameBufferPool();
+
+  size_t buffer_size_;
+
+  base::Lock lock_;
+  std::vector<char*> free_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameBufferPool);
+};
+
+// The memory a frame is converted into, it goes back to its pool when the
+// last reference is gone. It is referenced by the conversion task and by the
+// Buffer created from it.
+class FrameBuffer : public base::RefCountedThreadSafe<FrameBuffer> {
+ public:
+  explicit FrameBuffer(FrameBufferPool* pool);
+
+  char* data() const { return data_; }
+  size_t size() const { return pool_->buffer_size(); }
+
+  // Returns a Buffer of the first |length| bytes of the memory, which keeps
+  // it alive.
+  v8::MaybeLocal<v8::Object> CreateBuffer(v8::Isolate* isolate,
+                                          size_t length);
+
+ private:
+  friend class base::RefCountedThreadSafe<FrameBuffer>;
+
+  ~FrameBuffer();
+
+  scoped_refptr<FrameBufferPool> pool_;
+  char* data_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameBuffer);
+};
+
+// The frames are converted on the blocking pool, only the finished Buffer is
+// passed to the callback on the UI thread. A delivered frame is dropped while
+// the previous one is still being converted.
 class FrameSubscriber : public content::RenderWidgetHostViewFrameSubscriber {
  public:
-  using FrameCaptureCallback = base::Callback<void(v8::Local<v8::Value>)>;
+  using FrameCaptureCallback =
+      base::Callback<void(v8::Local<v8::Value>, v8::Local<v8::Value>)>;
+
+  enum Format {
+    // 32 bit ARGB pixels.
+    FORMAT_RGB,
+    // The Y, U and V planes one after another.
+    FORMAT_I420,
+    // The Y plane followed by the interleaved U and V plane.
+    FORMAT_NV12,
+  };
+
+  struct Options {
+    Options();
+
+    // When positive the frames are written into a ring of |ring_size|
+    // Buffers that are reused, otherwise every frame gets a new Buffer whose
+    // memory is recycled after it is collected.
+    int ring_size;
+    Format format;
+    // Only deliver the damaged area of the frames.
+    bool only_dirty;
+    // The size the frames are scaled to by the compositor, the size of the
+    // view when empty.
+    gfx::Size size;
+    // The shortest time between two captured frames.
+    base::TimeDelta min_interval;
+    // The frames that can be captured or converted at the same time, new
+    // frames are skipped before they are read back while there are more.
+    int max_pending_frames;
+  };
 
   FrameSubscriber(v8::Isolate* isolate,
-                  const gfx::Size& size,
+                  const gfx::Size& view_size,
+                  const Options& options,
                   const FrameCaptureCallback& callback);
+  ~FrameSubscriber() override;
 
   bool ShouldCaptureFrame(const gfx::Rect& damage_rect,
                           base::TimeTicks present_time,
@@ -28,13 +127,50 @@ class FrameSubscriber : public content::RenderWidgetHostViewFrameSubscriber {
                           DeliverFrameCallback* callback) override;
 
  private:
-  void OnFrameDelivered(
-      scoped_refptr<media::VideoFrame> frame, base::TimeTicks, bool);
+  void OnFrameDelivered(scoped_refptr<media::VideoFrame> frame,
+                        const gfx::Rect& rect,
+                        base::TimeTicks timestamp,
+                        bool result);
+
+  void OnFrameConverted(scoped_refptr<FrameBuffer> frame_buffer,
+                        size_t ring_index,
+                        const gfx::Rect& rect,
+                        base::TimeTicks timestamp);
 
   v8::Isolate* isolate_;
+  gfx::Size view_size_;
   gfx::Size size_;
+  Format format_;
+  bool only_dirty_;
+  base::TimeDelta min_interval_;
+  size_t max_pending_frames_;
   FrameCaptureCallback callback_;
 
+  // The frames passed to the view, a frame can be reused once it has been
+  // delivered and converted.
+  std::vector<scoped_refptr<media::VideoFrame>> frames_;
+
+  scoped_refptr<FrameBufferPool> buffer_pool_;
+
+  // The Buffers of the ring and their memory, a slot's Buffer is created
+  // after the first frame has been converted into its memory.
+  std::vector<v8::Global<v8::Object>> ring_;
+  std::vector<scoped_refptr<FrameBuffer>> ring_memory_;
+  size_t ring_index_;
+
+  scoped_refptr<base::TaskRunner> task_runner_;
+  bool converting_;
+
+  // The frames that have been requested but not passed to the callback yet.
+  size_t pending_frames_;
+  base::TimeTicks last_capture_time_;
+
+  // With |only_dirty_|, the damage of the frames that were skipped or dropped
+  // since the last captured frame, it is added to the next one.
+  gfx::Rect pending_damage_;
+
+  base::WeakPtrFactory<FrameSubscriber> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(FrameSubscriber);
 };
 
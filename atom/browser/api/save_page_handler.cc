@@ -16,9 +16,13 @@ namespace atom {
 namespace api {
 
 SavePageHandler::SavePageHandler(content::WebContents* web_contents,
+                                 const SavePageProgressCallback& progress,
                                  const SavePageCallback& callback)
     : web_contents_(web_contents),
-      callback_(callback) {
+      progress_(progress),
+      callback_(callback),
+      saved_(0),
+      total_(0) {
 }
 
 SavePageHandler::~SavePageHandler() {
@@ -53,11 +57,28 @@ bool SavePageHandler::Handle(const base::FilePath& full_path,
 }
 
 void SavePageHandler::OnDownloadUpdated(content::DownloadItem* item) {
-  if (item->IsDone()) {
+  // The item of a saved page counts the saved resources in its bytes, except
+  // for MHTML, whose size is only known when the file is written.
+  bool complete = item->GetState() == content::DownloadItem::COMPLETE;
+  int64 saved = item->GetReceivedBytes();
+  int64 total = complete ? saved : item->GetTotalBytes();
+  bool progressed = (item->IsInProgress() || complete) &&
+                    (saved != saved_ || total != total_);
+
+  if (progressed || item->IsDone()) {
     v8::Isolate* isolate = v8::Isolate::GetCurrent();
     v8::Locker locker(isolate);
     v8::HandleScope handle_scope(isolate);
-    if (item->GetState() == content::DownloadItem::COMPLETE) {
+    if (progressed) {
+      saved_ = saved;
+      total_ = total;
+      if (!progress_.is_null())
+        progress_.Run(saved, total);
+    }
+    if (!item->IsDone())
+      return;
+
+    if (complete) {
       callback_.Run(v8::Null(isolate));
     } else {
       v8::Local<v8::String> error_message = v8::String::NewFromUtf8(
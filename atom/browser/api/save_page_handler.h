@@ -29,8 +29,13 @@ class SavePageHandler : public content::DownloadManager::Observer,
                         public content::DownloadItem::Observer {
  public:
   using SavePageCallback = base::Callback<void(v8::Local<v8::Value>)>;
+  // Gets the saved and the total resources of the page, or the bytes written
+  // for MHTML, which is reported once the file is written.
+  using SavePageProgressCallback = base::Callback<void(int64, int64)>;
 
+  // |progress| can be null.
   SavePageHandler(content::WebContents* web_contents,
+                  const SavePageProgressCallback& progress,
                   const SavePageCallback& callback);
   ~SavePageHandler();
 
@@ -50,7 +55,13 @@ class SavePageHandler : public content::DownloadManager::Observer,
   void OnDownloadUpdated(content::DownloadItem* item) override;
 
   content::WebContents* web_contents_;  // weak
+  SavePageProgressCallback progress_;
   SavePageCallback callback_;
+
+  // The last progress reported, the item is updated more often than it
+  // makes progress.
+  int64 saved_;
+  int64 total_;
 };
 
 }  // namespace api
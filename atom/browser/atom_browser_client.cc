@@ -15,7 +15,10 @@
 #include "atom/browser/atom_resource_dispatcher_host_delegate.h"
 #include "atom/browser/atom_speech_recognition_manager_delegate.h"
 #include "atom/browser/browser.h"
+#include "atom/browser/message_port_filter.h"
 #include "atom/browser/native_window.h"
+#include "atom/browser/spare_render_process_pool.h"
+#include "atom/browser/style_sheet_registry.h"
 #include "atom/browser/web_contents_preferences.h"
 #include "atom/browser/window_list.h"
 #include "atom/common/options_switches.h"
@@ -31,6 +34,7 @@
 #include "content/public/browser/client_certificate_delegate.h"
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_view_host.h"
+#include "content/public/browser/render_widget_host_iterator.h"
 #include "content/public/browser/resource_dispatcher_host.h"
 #include "content/public/browser/site_instance.h"
 #include "content/public/browser/web_contents.h"
@@ -76,6 +80,23 @@ scoped_refptr<net::X509Certificate> ImportCertFromFile(
   return certs[0];
 }
 
+// Returns a WebContents that has a RenderViewHost in |site_instance|. The
+// WebContents that share a SiteInstance have the same preferences, so any of
+// them can be used.
+content::WebContents* GetWebContentsOfSiteInstance(
+    content::SiteInstance* site_instance) {
+  scoped_ptr<content::RenderWidgetHostIterator> widgets(
+      content::RenderWidgetHost::GetRenderWidgetHosts());
+  while (content::RenderWidgetHost* widget = widgets->GetNextHost()) {
+    if (!widget->IsRenderView())
+      continue;
+    auto render_view_host = content::RenderViewHost::From(widget);
+    if (render_view_host->GetSiteInstance() == site_instance)
+      return content::WebContents::FromRenderViewHost(render_view_host);
+  }
+  return nullptr;
+}
+
 }  // namespace
 
 // static
@@ -86,6 +107,8 @@ void AtomBrowserClient::SuppressRendererProcessRestartForOnce() {
 void AtomBrowserClient::SetCustomSchemes(
     const std::vector<std::string>& schemes) {
   g_custom_schemes = JoinString(schemes, ',');
+  // The spare processes were launched without the new schemes.
+  SpareRenderProcessPool::GetInstance()->Relaunch();
 }
 
 AtomBrowserClient::AtomBrowserClient() {
@@ -99,6 +122,8 @@ void AtomBrowserClient::RenderProcessWillLaunch(
   int process_id = host->GetID();
   host->AddFilter(new printing::PrintingMessageFilter(process_id));
   host->AddFilter(new TtsMessageFilter(process_id, host->GetBrowserContext()));
+  host->AddFilter(new MessagePortFilter(process_id));
+  StyleSheetRegistry::GetInstance()->RenderProcessWillLaunch(host);
 }
 
 content::SpeechRecognitionManagerDelegate*
@@ -152,14 +177,65 @@ void AtomBrowserClient::OverrideSiteInstanceForNavigation(
   if (url.SchemeIs(url::kJavaScriptScheme))
     return;
 
-  *new_instance = content::SiteInstance::CreateForURL(browser_context, url);
+  auto current_process = current_instance->GetProcess();
+  content::WebContents* web_contents = GetWebContentsOfSiteInstance(
+      current_instance);
+  if (WebContentsPreferences::ShouldShareRendererProcess(web_contents)) {
+    *new_instance = GetSharedSiteInstance(browser_context, url, web_contents);
+    // Already in the process of the site.
+    if (*new_instance == current_instance)
+      return;
+  } else {
+    // Use a spare renderer process that has already been launched, when the
+    // preferences of the WebContents match the ones of the spare processes.
+    *new_instance = SpareRenderProcessPool::GetInstance()->Take(
+        browser_context, web_contents);
+  }
+  if (!*new_instance)
+    *new_instance = content::SiteInstance::CreateForURL(browser_context, url);
 
   // Remember the original renderer process of the pending renderer process.
-  auto current_process = current_instance->GetProcess();
   auto pending_process = (*new_instance)->GetProcess();
   pending_processes_[pending_process->GetID()] = current_process->GetID();
-  // Clear the entry in map when process ends.
-  current_process->AddObserver(this);
+  // Clear the entry in map when process ends, the shared processes are
+  // already observed.
+  if (!IsSharedProcess(current_process))
+    current_process->AddObserver(this);
+}
+
+content::SiteInstance* AtomBrowserClient::GetSharedSiteInstance(
+    content::BrowserContext* browser_context,
+    const GURL& url,
+    content::WebContents* web_contents) {
+  base::CommandLine switches(base::CommandLine::NO_PROGRAM);
+  WebContentsPreferences::AppendExtraCommandLineSwitches(web_contents,
+                                                         &switches);
+  SharedSiteInstanceKey key(
+      std::make_pair(browser_context,
+                     content::SiteInstance::GetSiteForURL(browser_context,
+                                                          url)),
+      switches.GetSwitches());
+
+  auto it = shared_site_instances_.find(key);
+  if (it != shared_site_instances_.end())
+    return it->second.instance.get();
+
+  SharedSiteInstance shared;
+  shared.instance = content::SiteInstance::CreateForURL(browser_context, url);
+  shared.host = shared.instance->GetProcess();
+  // Forget the SiteInstance when its process ends.
+  shared.host->AddObserver(this);
+  shared_site_instances_[key] = shared;
+  return shared.instance.get();
+}
+
+bool AtomBrowserClient::IsSharedProcess(
+    content::RenderProcessHost* host) const {
+  for (const auto& entry : shared_site_instances_) {
+    if (entry.second.host == host)
+      return true;
+  }
+  return false;
 }
 
 void AtomBrowserClient::AppendExtraCommandLineSwitches(
@@ -190,8 +266,12 @@ void AtomBrowserClient::AppendExtraCommandLineSwitches(
   // Get the WebContents of the render process.
   content::WebContents* web_contents = content::WebContents::FromRenderViewHost(
       content::RenderViewHost::FromID(process_id, kDefaultRoutingID));
-  if (!web_contents)
+  if (!web_contents) {
+    // The spare processes have no WebContents yet.
+    SpareRenderProcessPool::GetInstance()->AppendExtraCommandLineSwitches(
+        process_id, command_line);
     return;
+  }
 
   WebContentsPreferences::AppendExtraCommandLineSwitches(
       web_contents, command_line);
@@ -243,6 +323,14 @@ brightray::BrowserMainParts* AtomBrowserClient::OverrideCreateBrowserMainParts(
 
 void AtomBrowserClient::RenderProcessHostDestroyed(
     content::RenderProcessHost* host) {
+  for (auto it = shared_site_instances_.begin();
+       it != shared_site_instances_.end();) {
+    if (it->second.host == host)
+      shared_site_instances_.erase(it++);
+    else
+      ++it;
+  }
+
   int process_id = host->GetID();
   for (const auto& entry : pending_processes_) {
     if (entry.first == process_id || entry.second == process_id) {
@@ -9,12 +9,17 @@
 #include <string>
 #include <vector>
 
+#include "base/command_line.h"
+#include "base/memory/ref_counted.h"
 #include "brightray/browser/browser_client.h"
 #include "content/public/browser/render_process_host_observer.h"
+#include "url/gurl.h"
 
 namespace content {
 class QuotaPermissionContext;
 class ClientCertificateDelegate;
+class SiteInstance;
+class WebContents;
 }
 
 namespace net {
@@ -68,9 +73,31 @@ class AtomBrowserClient : public brightray::BrowserClient,
   void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
 
  private:
+  // Returns the SiteInstance of |url| that is shared by the WebContents with
+  // the "share-renderer-process" preference and the same preferences as
+  // |web_contents|.
+  content::SiteInstance* GetSharedSiteInstance(
+      content::BrowserContext* browser_context,
+      const GURL& url,
+      content::WebContents* web_contents);
+
+  // Whether |host| is the process of a shared SiteInstance.
+  bool IsSharedProcess(content::RenderProcessHost* host) const;
+
   // pending_render_process => current_render_process.
   std::map<int, int> pending_processes_;
 
+  // The SiteInstances shared by the WebContents of the same site, keyed by
+  // the browser context, the site and the switches of the preferences.
+  struct SharedSiteInstance {
+    scoped_refptr<content::SiteInstance> instance;
+    content::RenderProcessHost* host;
+  };
+  using SharedSiteInstanceKey =
+      std::pair<std::pair<content::BrowserContext*, GURL>,
+                base::CommandLine::SwitchMap>;
+  std::map<SharedSiteInstanceKey, SharedSiteInstance> shared_site_instances_;
+
   scoped_ptr<AtomResourceDispatcherHostDelegate>
       resource_dispatcher_host_delegate_;
 
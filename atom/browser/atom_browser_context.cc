@@ -15,6 +15,7 @@
 #include "atom/common/atom_version.h"
 #include "atom/common/chrome_version.h"
 #include "atom/common/options_switches.h"
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/files/file_path.h"
 #include "base/prefs/pref_registry_simple.h"
@@ -57,11 +58,24 @@ std::string RemoveWhitespace(const std::string& str) {
 
 }  // namespace
 
+AtomBrowserContext::HttpCacheOptions::HttpCacheOptions()
+    : type(TYPE_DEFAULT), max_size(0) {
+}
+
 AtomBrowserContext::AtomBrowserContext(const std::string& partition,
                                        bool in_memory)
     : brightray::BrowserContext(partition, in_memory),
       job_factory_(new AtomURLRequestJobFactory),
-      allow_ntlm_everywhere_(false) {
+      allow_ntlm_everywhere_(false),
+      http_cache_stats_(new HttpCacheStats),
+      auth_cache_(new AuthCache),
+      proxy_result_cache_(new ProxyResultCache),
+      network_emulation_rules_(new NetworkEmulationRules) {
+  // The login handlers find the cache from the requests on the IO thread.
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&AuthCache::AttachToResourceContext, auth_cache_,
+                 GetResourceContext()));
 }
 
 AtomBrowserContext::~AtomBrowserContext() {
@@ -103,16 +117,20 @@ net::URLRequestJobFactory* AtomBrowserContext::CreateURLRequestJobFactory(
               base::SequencedWorkerPool::SKIP_ON_SHUTDOWN))));
   job_factory->SetProtocolHandler(
       url::kHttpScheme,
-      make_scoped_ptr(new HttpProtocolHandler(url::kHttpScheme)));
+      make_scoped_ptr(new HttpProtocolHandler(
+          url::kHttpScheme, network_emulation_rules_.get())));
   job_factory->SetProtocolHandler(
       url::kHttpsScheme,
-      make_scoped_ptr(new HttpProtocolHandler(url::kHttpsScheme)));
+      make_scoped_ptr(new HttpProtocolHandler(
+          url::kHttpsScheme, network_emulation_rules_.get())));
   job_factory->SetProtocolHandler(
       url::kWsScheme,
-      make_scoped_ptr(new HttpProtocolHandler(url::kWsScheme)));
+      make_scoped_ptr(new HttpProtocolHandler(
+          url::kWsScheme, network_emulation_rules_.get())));
   job_factory->SetProtocolHandler(
       url::kWssScheme,
-      make_scoped_ptr(new HttpProtocolHandler(url::kWssScheme)));
+      make_scoped_ptr(new HttpProtocolHandler(
+          url::kWssScheme, network_emulation_rules_.get())));
 
   auto host_resolver =
       url_request_context_getter()->GetURLRequestContext()->host_resolver();
@@ -136,10 +154,27 @@ net::HttpCache::BackendFactory*
 AtomBrowserContext::CreateHttpCacheBackendFactory(
     const base::FilePath& base_path) {
   base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
-  if (command_line->HasSwitch(switches::kDisableHttpCache))
+  if (command_line->HasSwitch(switches::kDisableHttpCache) ||
+      http_cache_options_.type == HttpCacheOptions::TYPE_NONE)
     return new NoCacheBackend;
-  else
-    return brightray::BrowserContext::CreateHttpCacheBackendFactory(base_path);
+
+  net::HttpCache::BackendFactory* factory;
+  int max_size = http_cache_options_.max_size;
+  if (http_cache_options_.type == HttpCacheOptions::TYPE_MEMORY ||
+      (IsOffTheRecord() && max_size > 0)) {
+    factory = new net::HttpCache::DefaultBackend(
+        net::MEMORY_CACHE, net::CACHE_BACKEND_DEFAULT, base::FilePath(),
+        max_size, nullptr);
+  } else if (max_size > 0) {
+    factory = new net::HttpCache::DefaultBackend(
+        net::DISK_CACHE, net::CACHE_BACKEND_DEFAULT,
+        base_path.Append(FILE_PATH_LITERAL("Cache")), max_size,
+        BrowserThread::GetMessageLoopProxyForThread(BrowserThread::CACHE));
+  } else {
+    factory = brightray::BrowserContext::CreateHttpCacheBackendFactory(
+        base_path);
+  }
+  return new CountingBackendFactory(factory, http_cache_stats_.get());
 }
 
 content::DownloadManagerDelegate*
@@ -175,6 +210,24 @@ bool AtomBrowserContext::AllowNTLMCredentialsForDomain(const GURL& origin) {
   return Delegate::AllowNTLMCredentialsForDomain(origin);
 }
 
+bool AtomBrowserContext::SetHttpCacheOptions(
+    const HttpCacheOptions& options) {
+  if (url_request_context_getter())
+    return false;
+  http_cache_options_ = options;
+  return true;
+}
+
+bool AtomBrowserContext::SetBaseContext(AtomBrowserContext* base) {
+  if (url_request_context_getter() || base == this)
+    return false;
+  // The job factory is not used by the IO thread until the request context
+  // is created.
+  base_context_ = base;
+  job_factory_->set_base(base->job_factory());
+  return true;
+}
+
 void AtomBrowserContext::AllowNTLMCredentialsForAllDomains(bool should_allow) {
   allow_ntlm_everywhere_ = should_allow;
 }
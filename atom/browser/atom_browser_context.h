@@ -7,6 +7,10 @@
 
 #include <string>
 
+#include "atom/browser/net/auth_cache.h"
+#include "atom/browser/net/http_cache_backend.h"
+#include "atom/browser/net/network_emulation_rules.h"
+#include "atom/browser/net/proxy_result_cache.h"
 #include "brightray/browser/browser_context.h"
 
 namespace atom {
@@ -17,6 +21,21 @@ class WebViewManager;
 
 class AtomBrowserContext : public brightray::BrowserContext {
  public:
+  struct HttpCacheOptions {
+    enum Type {
+      // The disk cache, or the memory cache for in-memory sessions.
+      TYPE_DEFAULT,
+      TYPE_MEMORY,
+      TYPE_NONE,
+    };
+
+    HttpCacheOptions();
+
+    Type type;
+    // The size the cache is evicted to, 0 lets the backend choose.
+    int max_size;
+  };
+
   AtomBrowserContext(const std::string& partition, bool in_memory);
   ~AtomBrowserContext() override;
 
@@ -39,6 +58,28 @@ class AtomBrowserContext : public brightray::BrowserContext {
 
   void AllowNTLMCredentialsForAllDomains(bool should_allow);
 
+  // Returns false when the HTTP cache may have been created already, the
+  // options only apply to sessions that have not been used.
+  bool SetHttpCacheOptions(const HttpCacheOptions& options);
+
+  // Serves the schemes registered in |base| by the protocol module for this
+  // session too. Like SetHttpCacheOptions it only works before the session is
+  // used.
+  bool SetBaseContext(AtomBrowserContext* base);
+  AtomBrowserContext* base_context() const { return base_context_.get(); }
+
+  AuthCache* auth_cache() const { return auth_cache_.get(); }
+
+  HttpCacheStats* http_cache_stats() const { return http_cache_stats_.get(); }
+
+  ProxyResultCache* proxy_result_cache() const {
+    return proxy_result_cache_.get();
+  }
+
+  NetworkEmulationRules* network_emulation_rules() const {
+    return network_emulation_rules_.get();
+  }
+
   AtomURLRequestJobFactory* job_factory() const { return job_factory_; }
 
  private:
@@ -48,8 +89,21 @@ class AtomBrowserContext : public brightray::BrowserContext {
   // Managed by brightray::BrowserContext.
   AtomURLRequestJobFactory* job_factory_;
 
+  // Kept alive for the job factory, which uses the base's job factory.
+  scoped_refptr<AtomBrowserContext> base_context_;
+
   bool allow_ntlm_everywhere_;
 
+  // Read on the IO thread when the URLRequestContext is created.
+  HttpCacheOptions http_cache_options_;
+  scoped_refptr<HttpCacheStats> http_cache_stats_;
+
+  scoped_refptr<AuthCache> auth_cache_;
+
+  scoped_refptr<ProxyResultCache> proxy_result_cache_;
+
+  scoped_refptr<NetworkEmulationRules> network_emulation_rules_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomBrowserContext);
 };
 
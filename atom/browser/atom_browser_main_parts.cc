@@ -9,14 +9,20 @@
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/bridge_task_runner.h"
 #include "atom/browser/browser.h"
+#include "atom/browser/idle_gc_scheduler.h"
 #include "atom/browser/javascript_environment.h"
 #include "atom/browser/node_debugger.h"
+#include "atom/browser/spare_render_process_pool.h"
+#include "atom/common/api/api_messages.h"
 #include "atom/common/api/atom_bindings.h"
+#include "atom/common/asar/asar_util.h"
 #include "atom/common/node_bindings.h"
 #include "atom/common/node_includes.h"
+#include "atom/common/startup_timeline.h"
 #include "base/command_line.h"
 #include "base/thread_task_runner_handle.h"
 #include "chrome/browser/browser_process.h"
+#include "content/public/browser/render_process_host.h"
 #include "v8/include/v8-debug.h"
 
 #if defined(USE_X11)
@@ -32,8 +38,7 @@ AtomBrowserMainParts::AtomBrowserMainParts()
     : fake_browser_process_(new BrowserProcess),
       browser_(new Browser),
       node_bindings_(NodeBindings::Create(true)),
-      atom_bindings_(new AtomBindings),
-      gc_timer_(true, true) {
+      atom_bindings_(new AtomBindings) {
   DCHECK(!self_) << "Cannot have two AtomBrowserMainParts";
   self_ = this;
 }
@@ -53,6 +58,7 @@ void AtomBrowserMainParts::RegisterDestructionCallback(
 }
 
 void AtomBrowserMainParts::PreEarlyInitialization() {
+  StartupTimeline::GetInstance()->Mark("browserMainPartsStart");
   brightray::BrowserMainParts::PreEarlyInitialization();
 #if defined(OS_POSIX)
   HandleSIGCHLD();
@@ -98,14 +104,15 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
   node_bindings_->RunMessageLoop();
 
   // Start idle gc.
-  gc_timer_.Start(
-      FROM_HERE, base::TimeDelta::FromMinutes(1),
-      base::Bind(base::IgnoreResult(&v8::Isolate::IdleNotification),
-                 base::Unretained(js_env_->isolate()),
-                 1000));
+  idle_gc_scheduler_.reset(new IdleGCScheduler(js_env_->isolate()));
+
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&AtomBrowserMainParts::OnMemoryPressure,
+                 base::Unretained(this))));
 
   brightray::BrowserMainParts::PreMainMessageLoopRun();
   BridgeTaskRunner::MessageLoopIsReady();
+  StartupTimeline::GetInstance()->Mark("browserMainPartsInitialized");
 
 #if defined(USE_X11)
   libgtk2ui::GtkInitFromCommandLine(*base::CommandLine::ForCurrentProcess());
@@ -125,7 +132,23 @@ void AtomBrowserMainParts::PostMainMessageLoopStart() {
 #endif
 }
 
+void AtomBrowserMainParts::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  for (auto it = content::RenderProcessHost::AllHostsIterator();
+       !it.IsAtEnd(); it.Advance())
+    it.GetCurrentValue()->Send(new AtomMsg_MemoryPressure(level));
+
+  js_env_->isolate()->LowMemoryNotification();
+  asar::ClearCachedArchives();
+}
+
 void AtomBrowserMainParts::PostMainMessageLoopRun() {
+  memory_pressure_listener_.reset();
+  idle_gc_scheduler_.reset();
+
+  // The spare processes belong to the browser context.
+  SpareRenderProcessPool::GetInstance()->Clear();
+
   brightray::BrowserMainParts::PostMainMessageLoopRun();
 
   // Make sure destruction callbacks are called before message loop is
@@ -9,7 +9,7 @@
 #include <string>
 
 #include "base/callback.h"
-#include "base/timer/timer.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "brightray/browser/browser_main_parts.h"
 #include "content/public/browser/browser_context.h"
 
@@ -19,6 +19,7 @@ namespace atom {
 
 class AtomBindings;
 class Browser;
+class IdleGCScheduler;
 class JavascriptEnvironment;
 class NodeBindings;
 class NodeDebugger;
@@ -56,6 +57,11 @@ class AtomBrowserMainParts : public brightray::BrowserMainParts {
   void HandleShutdownSignals();
 #endif
 
+  // Forwards the memory pressure to the renderers and releases the memory of
+  // the browser process.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
   // A fake BrowserProcess object that used to feed the source code from chrome.
   scoped_ptr<BrowserProcess> fake_browser_process_;
 
@@ -69,7 +75,9 @@ class AtomBrowserMainParts : public brightray::BrowserMainParts {
   scoped_ptr<AtomBindings> atom_bindings_;
   scoped_ptr<NodeDebugger> node_debugger_;
 
-  base::Timer gc_timer_;
+  scoped_ptr<IdleGCScheduler> idle_gc_scheduler_;
+
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 
   // List of callbacks should be executed before destroying JS env.
   std::list<base::Closure> destruction_callbacks_;
@@ -6,10 +6,21 @@
 
 #include <string>
 
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
 #include "base/strings/utf_string_conversions.h"
 
 namespace atom {
 
+AtomJavaScriptDialogManager::AtomJavaScriptDialogManager(Delegate* delegate)
+    : delegate_(delegate),
+      next_id_(0),
+      weak_factory_(this) {
+}
+
+AtomJavaScriptDialogManager::~AtomJavaScriptDialogManager() {
+}
+
 void AtomJavaScriptDialogManager::RunJavaScriptDialog(
     content::WebContents* web_contents,
     const GURL& origin_url,
@@ -19,7 +30,12 @@ void AtomJavaScriptDialogManager::RunJavaScriptDialog(
     const base::string16& default_prompt_text,
     const DialogClosedCallback& callback,
     bool* did_suppress_message) {
-  callback.Run(false, base::string16());
+  int id = ++next_id_;
+  PendingDialog dialog = { callback, false, base::string16() };
+  DialogClosedCallback close = AddDialog(id, dialog);
+  Settle(id, delegate_ && delegate_->OnJavaScriptDialog(
+      javascript_message_type, message_text, default_prompt_text, origin_url,
+      close));
 }
 
 void AtomJavaScriptDialogManager::RunBeforeUnloadDialog(
@@ -29,7 +45,72 @@ void AtomJavaScriptDialogManager::RunBeforeUnloadDialog(
     const DialogClosedCallback& callback) {
   bool prevent_reload = message_text.empty() ||
                         message_text == base::ASCIIToUTF16("false");
-  callback.Run(!prevent_reload, message_text);
+  int id = ++next_id_;
+  PendingDialog dialog = { callback, !prevent_reload, message_text };
+  DialogClosedCallback close = AddDialog(id, dialog);
+  Settle(id, delegate_ && delegate_->OnBeforeUnloadDialog(
+      message_text, is_reload, close));
+}
+
+void AtomJavaScriptDialogManager::CancelActiveAndPendingDialogs(
+    content::WebContents* web_contents) {
+  std::map<int, PendingDialog> dialogs;
+  dialogs.swap(pending_dialogs_);
+  for (const auto& pair : dialogs)
+    pair.second.callback.Run(false, base::string16());
+}
+
+void AtomJavaScriptDialogManager::ResetDialogState(
+    content::WebContents* web_contents) {
+  // The page still waits for the dialogs, so they get their default results.
+  std::map<int, PendingDialog> dialogs;
+  dialogs.swap(pending_dialogs_);
+  for (const auto& pair : dialogs)
+    pair.second.callback.Run(pair.second.default_success,
+                             pair.second.default_user_input);
+}
+
+AtomJavaScriptDialogManager::DialogClosedCallback
+AtomJavaScriptDialogManager::AddDialog(int id, const PendingDialog& dialog) {
+  pending_dialogs_[id] = dialog;
+  return base::Bind(&AtomJavaScriptDialogManager::CloseDialog,
+                    weak_factory_.GetWeakPtr(), id);
+}
+
+void AtomJavaScriptDialogManager::Settle(int id, bool handled) {
+  if (!handled) {
+    CloseDialogWithDefault(id);
+    return;
+  }
+
+  // The delegate may have closed it already.
+  if (!pending_dialogs_.count(id))
+    return;
+  base::TimeDelta timeout = delegate_->GetJavaScriptDialogTimeout();
+  if (timeout > base::TimeDelta())
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&AtomJavaScriptDialogManager::CloseDialogWithDefault,
+                   weak_factory_.GetWeakPtr(), id),
+        timeout);
+}
+
+void AtomJavaScriptDialogManager::CloseDialog(
+    int id, bool success, const base::string16& user_input) {
+  auto iter = pending_dialogs_.find(id);
+  if (iter == pending_dialogs_.end())
+    return;
+  DialogClosedCallback callback = iter->second.callback;
+  pending_dialogs_.erase(iter);
+  callback.Run(success, user_input);
+}
+
+void AtomJavaScriptDialogManager::CloseDialogWithDefault(int id) {
+  auto iter = pending_dialogs_.find(id);
+  if (iter == pending_dialogs_.end())
+    return;
+  CloseDialog(id, iter->second.default_success,
+              iter->second.default_user_input);
 }
 
 }  // namespace atom
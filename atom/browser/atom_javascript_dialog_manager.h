@@ -5,14 +5,50 @@
 #ifndef ATOM_BROWSER_ATOM_JAVASCRIPT_DIALOG_MANAGER_H_
 #define ATOM_BROWSER_ATOM_JAVASCRIPT_DIALOG_MANAGER_H_
 
+#include <map>
 #include <string>
 
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "content/public/browser/javascript_dialog_manager.h"
 
 namespace atom {
 
+// The dialogs of a page are closed asynchronously, so the main process keeps
+// running while a page waits for one. Each dialog gets the default result
+// when its delegate leaves it alone, or does not close it in time.
 class AtomJavaScriptDialogManager : public content::JavaScriptDialogManager {
  public:
+  class Delegate {
+   public:
+    typedef content::JavaScriptDialogManager::DialogClosedCallback
+        DialogClosedCallback;
+
+    // Gives a dialog to the delegate, which closes it later with |callback|
+    // when it returns true. Returning false leaves it to the default
+    // handling.
+    virtual bool OnJavaScriptDialog(
+        content::JavaScriptMessageType type,
+        const base::string16& message_text,
+        const base::string16& default_prompt_text,
+        const GURL& origin_url,
+        const DialogClosedCallback& callback) = 0;
+    virtual bool OnBeforeUnloadDialog(
+        const base::string16& message_text,
+        bool is_reload,
+        const DialogClosedCallback& callback) = 0;
+
+    // Returns how long a dialog given to the delegate may stay open before
+    // it gets the default result, zero means no limit.
+    virtual base::TimeDelta GetJavaScriptDialogTimeout() = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
+  explicit AtomJavaScriptDialogManager(Delegate* delegate);
+  ~AtomJavaScriptDialogManager() override;
+
   // content::JavaScriptDialogManager implementations.
   void RunJavaScriptDialog(
       content::WebContents* web_contents,
@@ -29,8 +65,35 @@ class AtomJavaScriptDialogManager : public content::JavaScriptDialogManager {
       bool is_reload,
       const DialogClosedCallback& callback) override;
   void CancelActiveAndPendingDialogs(
-      content::WebContents* web_contents) override {}
-  void ResetDialogState(content::WebContents* web_contents) override {};
+      content::WebContents* web_contents) override;
+  void ResetDialogState(content::WebContents* web_contents) override;
+
+ private:
+  struct PendingDialog {
+    DialogClosedCallback callback;
+    // The result used when the delegate does not close the dialog.
+    bool default_success;
+    base::string16 default_user_input;
+  };
+
+  // Adds a dialog and returns the callback that closes it.
+  DialogClosedCallback AddDialog(int id, const PendingDialog& dialog);
+
+  // Gives the dialog its default result when the delegate has not taken it,
+  // or limits how long it can stay open otherwise.
+  void Settle(int id, bool handled);
+
+  void CloseDialog(int id, bool success, const base::string16& user_input);
+  void CloseDialogWithDefault(int id);
+
+  Delegate* delegate_;  // weak ref.
+
+  std::map<int, PendingDialog> pending_dialogs_;
+  int next_id_;
+
+  base::WeakPtrFactory<AtomJavaScriptDialogManager> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(AtomJavaScriptDialogManager);
 };
 
 }  // namespace atom
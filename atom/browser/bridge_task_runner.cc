@@ -4,26 +4,89 @@
 
 #include "atom/browser/bridge_task_runner.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "atom/common/event_loop_stats.h"
+#include "base/lazy_instance.h"
 #include "base/message_loop/message_loop.h"
+#include "base/synchronization/lock.h"
+#include "base/trace_event/trace_event.h"
 
 namespace atom {
 
-// static
-std::vector<BridgeTaskRunner::TaskPair> BridgeTaskRunner::tasks_;
-std::vector<BridgeTaskRunner::TaskPair> BridgeTaskRunner::non_nestable_tasks_;
+namespace {
+
+struct PendingTask {
+  tracked_objects::Location from_here;
+  base::Closure task;
+  base::TimeTicks posted_time;
+  base::TimeDelta delay;
+  bool nestable;
+};
+
+struct PendingTasks {
+  // Guards the following members.
+  base::Lock lock;
+  std::vector<PendingTask> tasks;
+
+  // The main message loop's task runner, set once it is ready.
+  scoped_refptr<base::SingleThreadTaskRunner> task_runner;
+};
+
+base::LazyInstance<PendingTasks>::Leaky g_pending_tasks =
+    LAZY_INSTANCE_INITIALIZER;
+
+bool PostToTaskRunner(base::SingleThreadTaskRunner* task_runner,
+                      const tracked_objects::Location& from_here,
+                      const base::Closure& task,
+                      base::TimeDelta delay,
+                      bool nestable) {
+  if (nestable)
+    return task_runner->PostDelayedTask(from_here, task, delay);
+  else
+    return task_runner->PostNonNestableDelayedTask(from_here, task, delay);
+}
+
+}  // namespace
 
 // static
 void BridgeTaskRunner::MessageLoopIsReady() {
   auto message_loop = base::MessageLoop::current();
   CHECK(message_loop);
-  for (const TaskPair& task : tasks_) {
-    message_loop->task_runner()->PostDelayedTask(
-        base::get<0>(task), base::get<1>(task), base::get<2>(task));
-  }
-  for (const TaskPair& task : non_nestable_tasks_) {
-    message_loop->task_runner()->PostNonNestableDelayedTask(
-        base::get<0>(task), base::get<1>(task), base::get<2>(task));
+  scoped_refptr<base::SingleThreadTaskRunner> task_runner =
+      message_loop->task_runner();
+
+  // The queued tasks are posted while holding the lock, so a thread that
+  // finds |task_runner| set can not post ahead of them. Keep the delays
+  // relative to the time the tasks were posted, tasks that are already due
+  // keep their order.
+  size_t task_count;
+  base::TimeDelta max_wait_time;
+  {
+    PendingTasks& pending = g_pending_tasks.Get();
+    base::AutoLock auto_lock(pending.lock);
+    DCHECK(!pending.task_runner);
+    base::TimeTicks now = base::TimeTicks::Now();
+    for (const PendingTask& task : pending.tasks) {
+      base::TimeDelta waited = now - task.posted_time;
+      max_wait_time = std::max(max_wait_time, waited);
+      PostToTaskRunner(task_runner.get(), task.from_here, task.task,
+                       std::max(task.delay - waited, base::TimeDelta()),
+                       task.nestable);
+    }
+    task_count = pending.tasks.size();
+    pending.tasks.clear();
+    pending.task_runner = task_runner;
   }
+
+  EventLoopStats::GetInstance()->RecordPreLoopTasks(task_count,
+                                                    max_wait_time);
+  TRACE_EVENT_INSTANT2("electron.node",
+                       "BridgeTaskRunner::MessageLoopIsReady",
+                       TRACE_EVENT_SCOPE_THREAD,
+                       "tasks", task_count,
+                       "max_wait_time_us", max_wait_time.InMicroseconds());
 }
 
 bool BridgeTaskRunner::PostDelayedTask(
@@ -31,10 +94,8 @@ bool BridgeTaskRunner::PostDelayedTask(
     const base::Closure& task,
     base::TimeDelta delay) {
   auto message_loop = base::MessageLoop::current();
-  if (!message_loop) {
-    tasks_.push_back(base::MakeTuple(from_here, task, delay));
-    return true;
-  }
+  if (!message_loop)
+    return PostTaskWithoutMessageLoop(from_here, task, delay, true);
 
   return message_loop->task_runner()->PostDelayedTask(from_here, task, delay);
 }
@@ -52,13 +113,33 @@ bool BridgeTaskRunner::PostNonNestableDelayedTask(
     const base::Closure& task,
     base::TimeDelta delay) {
   auto message_loop = base::MessageLoop::current();
-  if (!message_loop) {
-    non_nestable_tasks_.push_back(base::MakeTuple(from_here, task, delay));
-    return true;
-  }
+  if (!message_loop)
+    return PostTaskWithoutMessageLoop(from_here, task, delay, false);
 
   return message_loop->task_runner()->PostNonNestableDelayedTask(
       from_here, task, delay);
 }
 
+// static
+bool BridgeTaskRunner::PostTaskWithoutMessageLoop(
+    const tracked_objects::Location& from_here,
+    const base::Closure& task,
+    base::TimeDelta delay,
+    bool nestable) {
+  scoped_refptr<base::SingleThreadTaskRunner> task_runner;
+  {
+    PendingTasks& pending = g_pending_tasks.Get();
+    base::AutoLock auto_lock(pending.lock);
+    if (!pending.task_runner) {
+      PendingTask pending_task = {
+          from_here, task, base::TimeTicks::Now(), delay, nestable };
+      pending.tasks.push_back(pending_task);
+      return true;
+    }
+    task_runner = pending.task_runner;
+  }
+
+  return PostToTaskRunner(task_runner.get(), from_here, task, delay, nestable);
+}
+
 }  // namespace atom
@@ -5,15 +5,16 @@
 #ifndef ATOM_BROWSER_BRIDGE_TASK_RUNNER_H_
 #define ATOM_BROWSER_BRIDGE_TASK_RUNNER_H_
 
-#include <vector>
-
 #include "base/single_thread_task_runner.h"
-#include "base/tuple.h"
 
 namespace atom {
 
 // Post all tasks to the current message loop's task runner if available,
 // otherwise delay the work until message loop is ready.
+//
+// The delayed tasks can be posted from any thread, they are kept in one queue
+// in the order they were posted and are handed to the main message loop in a
+// single batch, each with the delay that is left since it was posted.
 class BridgeTaskRunner : public base::SingleThreadTaskRunner {
  public:
   BridgeTaskRunner() {}
@@ -33,10 +34,13 @@ class BridgeTaskRunner : public base::SingleThreadTaskRunner {
       base::TimeDelta delay) override;
 
  private:
-  using TaskPair = base::Tuple<
-      tracked_objects::Location, base::Closure, base::TimeDelta>;
-  static std::vector<TaskPair> tasks_;
-  static std::vector<TaskPair> non_nestable_tasks_;
+  // Queues the task when there is no message loop in current thread, or
+  // posts it to the main message loop once it is ready.
+  static bool PostTaskWithoutMessageLoop(
+      const tracked_objects::Location& from_here,
+      const base::Closure& task,
+      base::TimeDelta delay,
+      bool nestable);
 
   DISALLOW_COPY_AND_ASSIGN(BridgeTaskRunner);
 };
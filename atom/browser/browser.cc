@@ -8,6 +8,7 @@
 
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/window_list.h"
+#include "atom/common/startup_timeline.h"
 #include "base/message_loop/message_loop.h"
 #include "content/public/browser/client_certificate_delegate.h"
 #include "net/ssl/ssl_cert_request_info.h"
@@ -120,6 +121,7 @@ void Browser::WillFinishLaunching() {
 
 void Browser::DidFinishLaunching() {
   is_ready_ = true;
+  StartupTimeline::GetInstance()->Mark("ready");
   FOR_EACH_OBSERVER(BrowserObserver, observers_, OnFinishLaunching());
 }
 
@@ -35,6 +35,10 @@ namespace atom {
 
 namespace {
 
+// The most bytes of DevToolsAppendToFile buffered before DevTools has to wait
+// for them to be written.
+const size_t kMaxBufferedDevToolsAppendSize = 8 * 1024 * 1024;
+
 struct FileSystem {
   FileSystem() {
   }
@@ -117,10 +121,17 @@ void AppendToFile(const base::FilePath& path,
 
 CommonWebContentsDelegate::CommonWebContentsDelegate()
     : html_fullscreen_(false),
-      native_fullscreen_(false) {
+      native_fullscreen_(false),
+      weak_factory_(this) {
 }
 
 CommonWebContentsDelegate::~CommonWebContentsDelegate() {
+  for (const auto& it : devtools_indexing_jobs_)
+    it.second->Stop();
+}
+
+CommonWebContentsDelegate::AppendingFile::AppendingFile()
+    : writing(false), deferred_acks(0) {
 }
 
 void CommonWebContentsDelegate::InitWithWebContents(
@@ -175,7 +186,6 @@ content::WebContents* CommonWebContentsDelegate::OpenURLFromTab(
   load_url_params.is_renderer_initiated = params.is_renderer_initiated;
   load_url_params.transferred_global_request_id =
       params.transferred_global_request_id;
-  load_url_params.should_clear_history_list = true;
 
   source->GetController().LoadURLWithParams(load_url_params);
   return source;
@@ -192,11 +202,17 @@ bool CommonWebContentsDelegate::CanOverscrollContent() const {
   return false;
 }
 
+AtomJavaScriptDialogManager::Delegate*
+CommonWebContentsDelegate::GetJavaScriptDialogDelegate() {
+  return nullptr;
+}
+
 content::JavaScriptDialogManager*
 CommonWebContentsDelegate::GetJavaScriptDialogManager(
     content::WebContents* source) {
   if (!dialog_manager_)
-    dialog_manager_.reset(new AtomJavaScriptDialogManager);
+    dialog_manager_.reset(
+        new AtomJavaScriptDialogManager(GetJavaScriptDialogDelegate()));
 
   return dialog_manager_.get();
 }
@@ -266,6 +282,14 @@ void CommonWebContentsDelegate::DevToolsSaveToFile(
   }
 
   saved_files_[url] = path;
+
+  // The chunks that are not written yet belong to the last save. A write
+  // that is running finishes before the save on the FILE thread, and the
+  // acknowledgements it holds are still sent once it is done.
+  auto appending = appending_files_.find(url);
+  if (appending != appending_files_.end())
+    appending->second.buffer.clear();
+
   BrowserThread::PostTaskAndReply(
       BrowserThread::FILE, FROM_HERE,
       base::Bind(&WriteToFile, path, content),
@@ -275,15 +299,46 @@ void CommonWebContentsDelegate::DevToolsSaveToFile(
 
 void CommonWebContentsDelegate::DevToolsAppendToFile(
     const std::string& url, const std::string& content) {
-  PathsMap::iterator it = saved_files_.find(url);
-  if (it == saved_files_.end())
+  if (saved_files_.find(url) == saved_files_.end())
     return;
 
+  // DevTools sends the next chunk after the last one is acknowledged, so the
+  // chunks are acknowledged as soon as they are buffered, and are written
+  // together while a write is running. Only when writing falls behind the
+  // acknowledgements wait for the buffer to be written. The file is opened
+  // for each write only, so it is not locked between them.
+  AppendingFile& appending = appending_files_[url];
+  appending.buffer.append(content);
+  if (appending.buffer.size() <= kMaxBufferedDevToolsAppendSize)
+    OnDevToolsAppendToFile(url);
+  else
+    ++appending.deferred_acks;
+
+  if (!appending.writing)
+    WriteDevToolsAppendBuffer(url);
+}
+
+void CommonWebContentsDelegate::WriteDevToolsAppendBuffer(
+    const std::string& url) {
+  AppendingFile& appending = appending_files_[url];
+  std::string content;
+  content.swap(appending.buffer);
+  appending.writing = true;
   BrowserThread::PostTaskAndReply(
       BrowserThread::FILE, FROM_HERE,
-      base::Bind(&AppendToFile, it->second, content),
-      base::Bind(&CommonWebContentsDelegate::OnDevToolsAppendToFile,
-                 base::Unretained(this), url));
+      base::Bind(&AppendToFile, saved_files_[url], content),
+      base::Bind(&CommonWebContentsDelegate::OnDevToolsAppendBufferWritten,
+                 weak_factory_.GetWeakPtr(), url));
+}
+
+void CommonWebContentsDelegate::OnDevToolsAppendBufferWritten(
+    const std::string& url) {
+  AppendingFile& appending = appending_files_[url];
+  appending.writing = false;
+  for (; appending.deferred_acks > 0; --appending.deferred_acks)
+    OnDevToolsAppendToFile(url);
+  if (!appending.buffer.empty())
+    WriteDevToolsAppendBuffer(url);
 }
 
 void CommonWebContentsDelegate::DevToolsAddFileSystem(
@@ -351,6 +406,58 @@ void CommonWebContentsDelegate::DevToolsRemoveFileSystem(
        nullptr);
 }
 
+void CommonWebContentsDelegate::DevToolsIndexPath(
+    int request_id,
+    const std::string& file_system_path) {
+  if (!IsDevToolsFileSystemAdded(file_system_path)) {
+    OnDevToolsIndexingDone(request_id, file_system_path);
+    return;
+  }
+  if (devtools_indexing_jobs_.count(request_id) != 0)
+    return;
+
+  if (!devtools_file_system_indexer_)
+    devtools_file_system_indexer_ = new DevToolsFileSystemIndexer;
+  devtools_indexing_jobs_[request_id] =
+      devtools_file_system_indexer_->IndexPath(
+          file_system_path,
+          base::Bind(
+              &CommonWebContentsDelegate::OnDevToolsIndexingWorkCalculated,
+              weak_factory_.GetWeakPtr(), request_id, file_system_path),
+          base::Bind(&CommonWebContentsDelegate::OnDevToolsIndexingWorked,
+                     weak_factory_.GetWeakPtr(), request_id, file_system_path),
+          base::Bind(&CommonWebContentsDelegate::OnDevToolsIndexingDone,
+                     weak_factory_.GetWeakPtr(), request_id,
+                     file_system_path));
+}
+
+void CommonWebContentsDelegate::DevToolsStopIndexing(int request_id) {
+  auto it = devtools_indexing_jobs_.find(request_id);
+  if (it == devtools_indexing_jobs_.end())
+    return;
+  it->second->Stop();
+  devtools_indexing_jobs_.erase(it);
+}
+
+void CommonWebContentsDelegate::DevToolsSearchInPath(
+    int request_id,
+    const std::string& file_system_path,
+    const std::string& query) {
+  if (!IsDevToolsFileSystemAdded(file_system_path)) {
+    OnDevToolsSearchCompleted(request_id, file_system_path,
+                              std::vector<std::string>());
+    return;
+  }
+
+  if (!devtools_file_system_indexer_)
+    devtools_file_system_indexer_ = new DevToolsFileSystemIndexer;
+  devtools_file_system_indexer_->SearchInPath(
+      file_system_path,
+      query,
+      base::Bind(&CommonWebContentsDelegate::OnDevToolsSearchCompleted,
+                 weak_factory_.GetWeakPtr(), request_id, file_system_path));
+}
+
 void CommonWebContentsDelegate::OnDevToolsSaveToFile(
     const std::string& url) {
   // Notify DevTools.
@@ -367,6 +474,68 @@ void CommonWebContentsDelegate::OnDevToolsAppendToFile(
       "DevToolsAPI.appendedToURL", &url_value, nullptr, nullptr);
 }
 
+void CommonWebContentsDelegate::OnDevToolsIndexingWorkCalculated(
+    int request_id,
+    const std::string& file_system_path,
+    int total_work) {
+  base::FundamentalValue request_id_value(request_id);
+  base::StringValue file_system_path_value(file_system_path);
+  base::FundamentalValue total_work_value(total_work);
+  web_contents_->CallClientFunction("DevToolsAPI.indexingTotalWorkCalculated",
+                                    &request_id_value,
+                                    &file_system_path_value,
+                                    &total_work_value);
+}
+
+void CommonWebContentsDelegate::OnDevToolsIndexingWorked(
+    int request_id,
+    const std::string& file_system_path,
+    int worked) {
+  base::FundamentalValue request_id_value(request_id);
+  base::StringValue file_system_path_value(file_system_path);
+  base::FundamentalValue worked_value(worked);
+  web_contents_->CallClientFunction("DevToolsAPI.indexingWorked",
+                                    &request_id_value,
+                                    &file_system_path_value,
+                                    &worked_value);
+}
+
+void CommonWebContentsDelegate::OnDevToolsIndexingDone(
+    int request_id,
+    const std::string& file_system_path) {
+  devtools_indexing_jobs_.erase(request_id);
+  base::FundamentalValue request_id_value(request_id);
+  base::StringValue file_system_path_value(file_system_path);
+  web_contents_->CallClientFunction("DevToolsAPI.indexingDone",
+                                    &request_id_value,
+                                    &file_system_path_value,
+                                    nullptr);
+}
+
+void CommonWebContentsDelegate::OnDevToolsSearchCompleted(
+    int request_id,
+    const std::string& file_system_path,
+    const std::vector<std::string>& file_paths) {
+  base::ListValue file_paths_value;
+  for (const std::string& file_path : file_paths)
+    file_paths_value.AppendString(file_path);
+  base::FundamentalValue request_id_value(request_id);
+  base::StringValue file_system_path_value(file_system_path);
+  web_contents_->CallClientFunction("DevToolsAPI.searchCompleted",
+                                    &request_id_value,
+                                    &file_system_path_value,
+                                    &file_paths_value);
+}
+
+bool CommonWebContentsDelegate::IsDevToolsFileSystemAdded(
+    const std::string& file_system_path) {
+  base::FilePath path = base::FilePath::FromUTF8Unsafe(file_system_path);
+  for (const auto& it : saved_paths_)
+    if (it.second == path)
+      return true;
+  return false;
+}
+
 #if defined(TOOLKIT_VIEWS)
 gfx::ImageSkia CommonWebContentsDelegate::GetDevToolsWindowIcon() {
   if (!owner_window())
@@ -9,14 +9,16 @@
 #include <string>
 #include <vector>
 
+#include "atom/browser/atom_javascript_dialog_manager.h"
+#include "base/memory/weak_ptr.h"
 #include "brightray/browser/default_web_contents_delegate.h"
 #include "brightray/browser/inspectable_web_contents_impl.h"
 #include "brightray/browser/inspectable_web_contents_delegate.h"
 #include "brightray/browser/inspectable_web_contents_view_delegate.h"
+#include "chrome/browser/devtools/devtools_file_system_indexer.h"
 
 namespace atom {
 
-class AtomJavaScriptDialogManager;
 class NativeWindow;
 class WebDialogHelper;
 
@@ -55,6 +57,10 @@ class CommonWebContentsDelegate
   bool is_html_fullscreen() const { return html_fullscreen_; }
 
  protected:
+  // Returns the delegate the page's dialogs are given to, they get the default
+  // handling when there is none.
+  virtual AtomJavaScriptDialogManager::Delegate* GetJavaScriptDialogDelegate();
+
   // content::WebContentsDelegate:
   content::WebContents* OpenURLFromTab(
       content::WebContents* source,
@@ -89,6 +95,12 @@ class CommonWebContentsDelegate
   void DevToolsAddFileSystem(const base::FilePath& path) override;
   void DevToolsRemoveFileSystem(
       const base::FilePath& file_system_path) override;
+  void DevToolsIndexPath(int request_id,
+                         const std::string& file_system_path) override;
+  void DevToolsStopIndexing(int request_id) override;
+  void DevToolsSearchInPath(int request_id,
+                            const std::string& file_system_path,
+                            const std::string& query) override;
 
   // brightray::InspectableWebContentsViewDelegate:
 #if defined(TOOLKIT_VIEWS)
@@ -106,6 +118,26 @@ class CommonWebContentsDelegate
   // Callback for when DevToolsAppendToFile has completed.
   void OnDevToolsAppendToFile(const std::string& url);
 
+  // Writes the chunks buffered for |url| on the FILE thread.
+  void WriteDevToolsAppendBuffer(const std::string& url);
+  void OnDevToolsAppendBufferWritten(const std::string& url);
+
+  // Callbacks of the indexing and search of DevTools file systems.
+  void OnDevToolsIndexingWorkCalculated(int request_id,
+                                        const std::string& file_system_path,
+                                        int total_work);
+  void OnDevToolsIndexingWorked(int request_id,
+                                const std::string& file_system_path,
+                                int worked);
+  void OnDevToolsIndexingDone(int request_id,
+                              const std::string& file_system_path);
+  void OnDevToolsSearchCompleted(int request_id,
+                                 const std::string& file_system_path,
+                                 const std::vector<std::string>& file_paths);
+
+  // Whether |file_system_path| is one of the file systems added to DevTools.
+  bool IsDevToolsFileSystemAdded(const std::string& file_system_path);
+
   // Set fullscreen mode triggered by html api.
   void SetHtmlApiFullscreen(bool enter_fullscreen);
 
@@ -131,11 +163,35 @@ class CommonWebContentsDelegate
   typedef std::map<std::string, base::FilePath> PathsMap;
   PathsMap saved_files_;
 
+  // The files DevTools appends to, keyed by url.
+  struct AppendingFile {
+    AppendingFile();
+
+    // The chunks received while a write is running.
+    std::string buffer;
+    bool writing;
+    // The chunks acknowledged once the buffer is written.
+    int deferred_acks;
+  };
+  std::map<std::string, AppendingFile> appending_files_;
+
   // Maps file system id to file path, used by the file system requests
   // sent from devtools.
   typedef std::map<std::string, base::FilePath> WorkspaceMap;
   WorkspaceMap saved_paths_;
 
+  // Indexes the file systems of devtools off the UI thread, created when
+  // devtools first asks for it.
+  scoped_refptr<DevToolsFileSystemIndexer> devtools_file_system_indexer_;
+
+  // The indexing jobs of devtools, keyed by the id of their request.
+  typedef scoped_refptr<DevToolsFileSystemIndexer::FileSystemIndexingJob>
+      DevToolsIndexingJob;
+  typedef std::map<int, DevToolsIndexingJob> DevToolsIndexingJobsMap;
+  DevToolsIndexingJobsMap devtools_indexing_jobs_;
+
+  base::WeakPtrFactory<CommonWebContentsDelegate> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(CommonWebContentsDelegate);
 };
 
@@ -0,0 +1,191 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/hang_monitor.h"
+
+#include <algorithm>
+
+#include "atom/common/crash_reporter/crash_reporter.h"
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/thread_restrictions.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+const int kMaxStackFrames = 32;
+
+}  // namespace
+
+HangMonitor::HangMonitor(v8::Isolate* isolate,
+                         base::TimeDelta interval,
+                         base::TimeDelta threshold,
+                         bool write_minidump,
+                         Delegate* delegate)
+    : isolate_(isolate),
+      interval_(interval),
+      threshold_(threshold),
+      write_minidump_(write_minidump),
+      delegate_(delegate),
+      thread_("HangMonitor"),
+      uv_heartbeat_(nullptr),
+      hanging_(false),
+      minidump_written_(false) {
+}
+
+HangMonitor::~HangMonitor() {
+  DCHECK(!thread_.IsRunning());
+  DCHECK(!uv_heartbeat_);
+}
+
+bool HangMonitor::Start() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  uv_heartbeat_ = new uv_async_t;
+  uv_async_init(uv_default_loop(), uv_heartbeat_, OnUvHeartbeat);
+  uv_heartbeat_->data = this;
+
+  if (!thread_.Start())
+    return false;
+  thread_.message_loop()->PostDelayedTask(
+      FROM_HERE, base::Bind(&HangMonitor::Check, this), interval_);
+  return true;
+}
+
+void HangMonitor::Stop() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  delegate_ = nullptr;
+  {
+    // The monitor thread only sleeps between checks, so joining it is quick.
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    thread_.Stop();
+  }
+  if (uv_heartbeat_) {
+    uv_close(reinterpret_cast<uv_handle_t*>(uv_heartbeat_), OnUvHandleClosed);
+    uv_heartbeat_ = nullptr;
+  }
+}
+
+void HangMonitor::Check() {
+  base::TimeTicks now = base::TimeTicks::Now();
+  bool send_ui_heartbeat = false;
+  bool send_uv_heartbeat = false;
+  bool hang_detected = false;
+  {
+    base::AutoLock auto_lock(lock_);
+    // A hung thread is not flooded with heartbeats.
+    if (ui_pending_since_.is_null()) {
+      ui_pending_since_ = now;
+      send_ui_heartbeat = true;
+    }
+    if (uv_pending_since_.is_null()) {
+      uv_pending_since_ = now;
+      send_uv_heartbeat = true;
+    }
+
+    base::TimeTicks oldest = std::min(ui_pending_since_, uv_pending_since_);
+    if (!hanging_ && now - oldest > threshold_) {
+      hanging_ = true;
+      hang_start_ = oldest;
+      js_stack_.clear();
+      minidump_written_ = false;
+      hang_detected = true;
+    }
+  }
+
+  if (send_ui_heartbeat)
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                            base::Bind(&HangMonitor::OnUIHeartbeat, this));
+  if (send_uv_heartbeat)
+    uv_async_send(uv_heartbeat_);
+
+  if (hang_detected) {
+    // The interrupt runs as soon as the main thread executes JavaScript, which
+    // is right away when a long script is what hangs it. It keeps this alive
+    // until then.
+    AddRef();
+    isolate_->RequestInterrupt(&HangMonitor::CaptureJsStack, this);
+
+    if (write_minidump_) {
+      bool written =
+          crash_reporter::CrashReporter::GetInstance()->WriteMinidump();
+      base::AutoLock auto_lock(lock_);
+      minidump_written_ = written;
+    }
+  }
+
+  thread_.message_loop()->PostDelayedTask(
+      FROM_HERE, base::Bind(&HangMonitor::Check, this), interval_);
+}
+
+void HangMonitor::OnUIHeartbeat() {
+  OnHeartbeat(&ui_pending_since_);
+}
+
+void HangMonitor::OnHeartbeat(base::TimeTicks* pending_since) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  base::TimeDelta duration;
+  std::string js_stack;
+  bool minidump_written;
+  {
+    base::AutoLock auto_lock(lock_);
+    *pending_since = base::TimeTicks();
+    // The hang is over once both heartbeats are answered.
+    if (!hanging_ || !ui_pending_since_.is_null() ||
+        !uv_pending_since_.is_null())
+      return;
+    hanging_ = false;
+    duration = base::TimeTicks::Now() - hang_start_;
+    js_stack.swap(js_stack_);
+    minidump_written = minidump_written_;
+  }
+
+  if (delegate_)
+    delegate_->OnMainThreadHang(duration, js_stack, minidump_written);
+}
+
+// static
+void HangMonitor::OnUvHeartbeat(uv_async_t* handle) {
+  HangMonitor* self = static_cast<HangMonitor*>(handle->data);
+  self->OnHeartbeat(&self->uv_pending_since_);
+}
+
+// static
+void HangMonitor::OnUvHandleClosed(uv_handle_t* handle) {
+  delete reinterpret_cast<uv_async_t*>(handle);
+}
+
+// static
+void HangMonitor::CaptureJsStack(v8::Isolate* isolate, void* data) {
+  HangMonitor* self = static_cast<HangMonitor*>(data);
+
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::StackTrace> trace =
+      v8::StackTrace::CurrentStackTrace(isolate, kMaxStackFrames);
+  std::string stack;
+  for (int i = 0; i < trace->GetFrameCount(); ++i) {
+    v8::Local<v8::StackFrame> frame = trace->GetFrame(i);
+    v8::String::Utf8Value function_name(frame->GetFunctionName());
+    v8::String::Utf8Value script_name(frame->GetScriptName());
+    stack += "    at ";
+    stack += function_name.length() ? *function_name : "<anonymous>";
+    stack += " (";
+    stack += script_name.length() ? *script_name : "<unknown>";
+    stack += ":" + base::IntToString(frame->GetLineNumber()) + ":" +
+             base::IntToString(frame->GetColumn()) + ")\n";
+  }
+
+  {
+    // A stack taken after the hang is over does not belong to it.
+    base::AutoLock auto_lock(self->lock_);
+    if (self->hanging_)
+      self->js_stack_ = stack;
+  }
+  self->Release();
+}
+
+}  // namespace atom
@@ -0,0 +1,86 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_HANG_MONITOR_H_
+#define ATOM_BROWSER_HANG_MONITOR_H_
+
+#include <string>
+
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "v8/include/v8.h"
+#include "vendor/node/deps/uv/include/uv.h"
+
+namespace atom {
+
+// Watches the UI thread and the uv loop of the browser process from a thread
+// of its own. Every |interval| it sends each of them a heartbeat, unless the
+// previous one is still waiting, and when a heartbeat has waited longer than
+// |threshold| the main thread is considered hung: the JavaScript stack is
+// requested through a V8 interrupt and a minidump is optionally written. The
+// delegate is told once both heartbeats are answered again.
+//
+// Start, Stop and the delegate run on the UI thread.
+class HangMonitor : public base::RefCountedThreadSafe<HangMonitor> {
+ public:
+  class Delegate {
+   public:
+    virtual void OnMainThreadHang(base::TimeDelta duration,
+                                  const std::string& js_stack,
+                                  bool minidump_written) = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
+  HangMonitor(v8::Isolate* isolate,
+              base::TimeDelta interval,
+              base::TimeDelta threshold,
+              bool write_minidump,
+              Delegate* delegate);
+
+  bool Start();
+  void Stop();
+
+ private:
+  friend class base::RefCountedThreadSafe<HangMonitor>;
+
+  ~HangMonitor();
+
+  // Monitor thread:
+  void Check();
+
+  // UI thread:
+  void OnUIHeartbeat();
+  void OnHeartbeat(base::TimeTicks* pending_since);
+  static void OnUvHeartbeat(uv_async_t* handle);
+  static void OnUvHandleClosed(uv_handle_t* handle);
+  static void CaptureJsStack(v8::Isolate* isolate, void* data);
+
+  v8::Isolate* isolate_;
+  base::TimeDelta interval_;
+  base::TimeDelta threshold_;
+  bool write_minidump_;
+  Delegate* delegate_;
+
+  base::Thread thread_;
+  uv_async_t* uv_heartbeat_;
+
+  base::Lock lock_;
+  // When the heartbeat waiting for an answer was sent, null when none is.
+  base::TimeTicks ui_pending_since_;
+  base::TimeTicks uv_pending_since_;
+  bool hanging_;
+  base::TimeTicks hang_start_;
+  std::string js_stack_;
+  bool minidump_written_;
+
+  DISALLOW_COPY_AND_ASSIGN(HangMonitor);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_HANG_MONITOR_H_
@@ -0,0 +1,86 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/idle_gc_scheduler.h"
+
+#include "base/time/time.h"
+#include "gin/public/v8_platform.h"
+
+namespace atom {
+
+namespace {
+
+// How long no task has to run before the loop counts as idle.
+const int kQuiescenceDelayMs = 200;
+
+// How long each idle notification may take. Native input events do not go
+// through the message loop's tasks, so the slices are kept short enough to
+// not be felt while a window is dragged.
+const int kIdleSliceMs = 10;
+
+// Under steady traffic the loop is never idle, V8 then still gets a slice
+// this often so incremental work does not wait for the next long pause.
+const int kFallbackDelayMs = 5000;
+
+}  // namespace
+
+IdleGCScheduler::IdleGCScheduler(v8::Isolate* isolate)
+    : isolate_(isolate),
+      tasks_since_check_(0),
+      in_idle_check_(false),
+      last_idle_notification_(base::TimeTicks::Now()) {
+  base::MessageLoop::current()->AddTaskObserver(this);
+}
+
+IdleGCScheduler::~IdleGCScheduler() {
+  base::MessageLoop::current()->RemoveTaskObserver(this);
+}
+
+void IdleGCScheduler::WillProcessTask(const base::PendingTask& pending_task) {
+}
+
+void IdleGCScheduler::DidProcessTask(const base::PendingTask& pending_task) {
+  if (in_idle_check_) {
+    in_idle_check_ = false;
+    return;
+  }
+
+  if (timer_.IsRunning()) {
+    ++tasks_since_check_;
+    return;
+  }
+
+  // The first task after sleeping.
+  tasks_since_check_ = 0;
+  timer_.Start(FROM_HERE,
+               base::TimeDelta::FromMilliseconds(kQuiescenceDelayMs),
+               this, &IdleGCScheduler::OnIdleCheck);
+}
+
+void IdleGCScheduler::OnIdleCheck() {
+  in_idle_check_ = true;
+
+  bool idle = tasks_since_check_ == 0;
+  tasks_since_check_ = 0;
+  base::TimeTicks now = base::TimeTicks::Now();
+  bool overdue = now - last_idle_notification_ >=
+                 base::TimeDelta::FromMilliseconds(kFallbackDelayMs);
+  if (idle || overdue) {
+    last_idle_notification_ = now;
+    // The deadline is in the time base of V8's platform.
+    double deadline =
+        gin::V8Platform::Get()->MonotonicallyIncreasingTime() +
+        kIdleSliceMs / static_cast<double>(base::Time::kMillisecondsPerSecond);
+    // Sleep until a task runs once V8 has no more idle work.
+    if (isolate_->IdleNotificationDeadline(deadline))
+      return;
+  }
+
+  timer_.Start(FROM_HERE,
+               base::TimeDelta::FromMilliseconds(
+                   idle ? kIdleSliceMs : kQuiescenceDelayMs),
+               this, &IdleGCScheduler::OnIdleCheck);
+}
+
+}  // namespace atom
@@ -0,0 +1,54 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_IDLE_GC_SCHEDULER_H_
+#define ATOM_BROWSER_IDLE_GC_SCHEDULER_H_
+
+#include "base/message_loop/message_loop.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+// Gives V8 the idle periods of the UI thread's message loop, so incremental
+// marking, finalization and compaction happen while nothing else wants the
+// thread instead of as long pauses in the middle of ipc or window events.
+//
+// The loop is considered idle when no task ran for a short while. V8 then
+// gets a few milliseconds at a time until it says it has nothing more to do,
+// after which the scheduler sleeps until a task runs again. When the loop
+// stays busy, V8 still gets a slice every few seconds.
+class IdleGCScheduler : public base::MessageLoop::TaskObserver {
+ public:
+  // Must be created and destroyed on the thread of |isolate|'s message loop.
+  explicit IdleGCScheduler(v8::Isolate* isolate);
+  ~IdleGCScheduler() override;
+
+ private:
+  // base::MessageLoop::TaskObserver:
+  void WillProcessTask(const base::PendingTask& pending_task) override;
+  void DidProcessTask(const base::PendingTask& pending_task) override;
+
+  void OnIdleCheck();
+
+  v8::Isolate* isolate_;
+
+  // The tasks that ran since the last idle check was scheduled.
+  int tasks_since_check_;
+
+  // Whether the task being run is the idle check itself.
+  bool in_idle_check_;
+
+  // When V8 was last given an idle slice.
+  base::TimeTicks last_idle_notification_;
+
+  base::OneShotTimer<IdleGCScheduler> timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(IdleGCScheduler);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_IDLE_GC_SCHEDULER_H_
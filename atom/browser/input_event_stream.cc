@@ -0,0 +1,180 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/input_event_stream.h"
+
+#include <limits>
+
+#include "base/time/time.h"
+
+namespace atom {
+
+namespace {
+
+enum {
+  kType = 0,
+  kX,
+  kY,
+  kButton,
+  kModifiers,
+  kClickCount,
+  kDeltaX,
+  kDeltaY,
+};
+
+// Coordinates are kept small enough for the movements between them not to
+// overflow.
+const double kMaxCoordinate = 1 << 24;
+
+// Converting a double that is NaN or out of the range of int is undefined.
+bool ToInt(double value, double max, int* out) {
+  if (!(value >= -max && value <= max))
+    return false;
+  *out = static_cast<int>(value);
+  return true;
+}
+
+bool ToInt(double value, int* out) {
+  return ToInt(value, std::numeric_limits<int>::max(), out);
+}
+
+bool ToFloat(double value, float* out) {
+  if (!(value >= -std::numeric_limits<float>::max() &&
+        value <= std::numeric_limits<float>::max()))
+    return false;
+  *out = static_cast<float>(value);
+  return true;
+}
+
+bool ToWebInputEventType(int type, blink::WebInputEvent::Type* out) {
+  switch (type) {
+    case PACKED_MOUSE_DOWN: *out = blink::WebInputEvent::MouseDown; break;
+    case PACKED_MOUSE_UP: *out = blink::WebInputEvent::MouseUp; break;
+    case PACKED_MOUSE_MOVE: *out = blink::WebInputEvent::MouseMove; break;
+    case PACKED_MOUSE_ENTER: *out = blink::WebInputEvent::MouseEnter; break;
+    case PACKED_MOUSE_LEAVE: *out = blink::WebInputEvent::MouseLeave; break;
+    case PACKED_CONTEXT_MENU: *out = blink::WebInputEvent::ContextMenu; break;
+    case PACKED_MOUSE_WHEEL: *out = blink::WebInputEvent::MouseWheel; break;
+    default: return false;
+  }
+  return true;
+}
+
+int ToWebInputEventModifiers(int modifiers) {
+  int result = 0;
+  if (modifiers & PACKED_SHIFT)
+    result |= blink::WebInputEvent::ShiftKey;
+  if (modifiers & PACKED_CONTROL)
+    result |= blink::WebInputEvent::ControlKey;
+  if (modifiers & PACKED_ALT)
+    result |= blink::WebInputEvent::AltKey;
+  if (modifiers & PACKED_META)
+    result |= blink::WebInputEvent::MetaKey;
+  return result;
+}
+
+int ButtonDownModifier(blink::WebMouseEvent::Button button) {
+  switch (button) {
+    case blink::WebMouseEvent::ButtonLeft:
+      return blink::WebInputEvent::LeftButtonDown;
+    case blink::WebMouseEvent::ButtonMiddle:
+      return blink::WebInputEvent::MiddleButtonDown;
+    case blink::WebMouseEvent::ButtonRight:
+      return blink::WebInputEvent::RightButtonDown;
+    default:
+      return 0;
+  }
+}
+
+bool CanCoalesce(const blink::WebMouseEvent& last,
+                 const blink::WebMouseEvent& event) {
+  return last.type == event.type &&
+         (event.type == blink::WebInputEvent::MouseMove ||
+          event.type == blink::WebInputEvent::MouseWheel) &&
+         last.modifiers == event.modifiers &&
+         last.button == event.button;
+}
+
+}  // namespace
+
+bool DecodeInputEvents(const double* data,
+                       size_t count,
+                       ScopedVector<blink::WebMouseEvent>* events) {
+  if (count % kInputEventStride != 0)
+    return false;
+
+  double now = base::Time::Now().ToDoubleT();
+  // The moves are relative to the last position of the stream.
+  bool has_position = false;
+  int last_x = 0, last_y = 0;
+  for (size_t i = 0; i < count; i += kInputEventStride) {
+    const double* packed = data + i;
+    int packed_type, button, x, y, modifiers, click_count;
+    if (!ToInt(packed[kType], &packed_type) ||
+        !ToInt(packed[kButton], &button) ||
+        !ToInt(packed[kX], kMaxCoordinate, &x) ||
+        !ToInt(packed[kY], kMaxCoordinate, &y) ||
+        !ToInt(packed[kModifiers], &modifiers) ||
+        !ToInt(packed[kClickCount], &click_count))
+      return false;
+    blink::WebInputEvent::Type type;
+    if (!ToWebInputEventType(packed_type, &type))
+      return false;
+    if (button < blink::WebMouseEvent::ButtonNone ||
+        button > blink::WebMouseEvent::ButtonRight)
+      return false;
+
+    scoped_ptr<blink::WebMouseEvent> event;
+    if (type == blink::WebInputEvent::MouseWheel) {
+      scoped_ptr<blink::WebMouseWheelEvent> wheel(
+          new blink::WebMouseWheelEvent);
+      if (!ToFloat(packed[kDeltaX], &wheel->deltaX) ||
+          !ToFloat(packed[kDeltaY], &wheel->deltaY))
+        return false;
+      wheel->hasPreciseScrollingDeltas = true;
+      event.reset(wheel.release());
+    } else {
+      event.reset(new blink::WebMouseEvent);
+    }
+    event->type = type;
+    event->timeStampSeconds = now;
+    event->x = event->globalX = x;
+    event->y = event->globalY = y;
+    event->button = static_cast<blink::WebMouseEvent::Button>(button);
+    event->modifiers =
+        ToWebInputEventModifiers(modifiers);
+    if (type == blink::WebInputEvent::MouseMove)
+      event->modifiers |= ButtonDownModifier(event->button);
+    event->clickCount = click_count;
+    if (has_position) {
+      event->movementX = event->x - last_x;
+      event->movementY = event->y - last_y;
+    }
+    has_position = true;
+    last_x = event->x;
+    last_y = event->y;
+
+    if (events->empty() || !CanCoalesce(*events->back(), *event)) {
+      events->push_back(event.release());
+      continue;
+    }
+
+    blink::WebMouseEvent* last = events->back();
+    last->movementX += event->movementX;
+    last->movementY += event->movementY;
+    last->x = event->x;
+    last->y = event->y;
+    last->globalX = event->globalX;
+    last->globalY = event->globalY;
+    if (type == blink::WebInputEvent::MouseWheel) {
+      auto last_wheel = static_cast<blink::WebMouseWheelEvent*>(last);
+      auto wheel = static_cast<blink::WebMouseWheelEvent*>(event.get());
+      last_wheel->deltaX += wheel->deltaX;
+      last_wheel->deltaY += wheel->deltaY;
+    }
+  }
+  return true;
+}
+
+}  // namespace atom
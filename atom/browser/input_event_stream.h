@@ -0,0 +1,50 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_INPUT_EVENT_STREAM_H_
+#define ATOM_BROWSER_INPUT_EVENT_STREAM_H_
+
+#include "base/memory/scoped_vector.h"
+#include "third_party/WebKit/public/web/WebInputEvent.h"
+
+namespace atom {
+
+// The mouse events of webContents.sendInputEvents, packed in a Float64Array
+// as kInputEventStride numbers each:
+//   type, x, y, button, modifiers, clickCount, deltaX, deltaY
+// The types are the ones of PackedInputEventType, the buttons are -1 for
+// none, 0 for left, 1 for middle and 2 for right, and the modifiers are a
+// mask of PackedInputEventModifier.
+enum PackedInputEventType {
+  PACKED_MOUSE_DOWN = 0,
+  PACKED_MOUSE_UP,
+  PACKED_MOUSE_MOVE,
+  PACKED_MOUSE_ENTER,
+  PACKED_MOUSE_LEAVE,
+  PACKED_CONTEXT_MENU,
+  PACKED_MOUSE_WHEEL,
+};
+
+enum PackedInputEventModifier {
+  PACKED_SHIFT = 1 << 0,
+  PACKED_CONTROL = 1 << 1,
+  PACKED_ALT = 1 << 2,
+  PACKED_META = 1 << 3,
+};
+
+const size_t kInputEventStride = 8;
+
+// Decodes the |count| numbers of |data| into |events|, the wheel events are
+// blink::WebMouseWheelEvent. Consecutive moves and consecutive wheels of the
+// same modifiers are coalesced into one event like Chromium's input router
+// does, the moves keep the last position and the wheels add up their deltas.
+// Returns false when the stream is malformed, or a number is NaN or out of
+// range.
+bool DecodeInputEvents(const double* data,
+                       size_t count,
+                       ScopedVector<blink::WebMouseEvent>* events);
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_INPUT_EVENT_STREAM_H_
@@ -4,14 +4,17 @@
 
 #include "atom/browser/javascript_environment.h"
 
+#include <string>
+
+#include "atom/browser/v8_heap_settings.h"
 #include "base/command_line.h"
 #include "gin/array_buffer.h"
 #include "gin/v8_initializer.h"
 
 namespace atom {
 
-JavascriptEnvironment::JavascriptEnvironment()
-    : initialized_(Initialize()),
+JavascriptEnvironment::JavascriptEnvironment(bool use_app_v8_flags)
+    : initialized_(Initialize(use_app_v8_flags)),
       isolate_(isolate_holder_.isolate()),
       isolate_scope_(isolate_),
       locker_(isolate_),
@@ -20,13 +23,20 @@ JavascriptEnvironment::JavascriptEnvironment()
       context_scope_(v8::Local<v8::Context>::New(isolate_, context_)) {
 }
 
-bool JavascriptEnvironment::Initialize() {
+bool JavascriptEnvironment::Initialize(bool use_app_v8_flags) {
   auto cmd = base::CommandLine::ForCurrentProcess();
   if (cmd->HasSwitch("debug-brk")) {
     // Need to be called before v8::Initialize().
     const char expose_debug_as[] = "--expose_debug_as=v8debug";
     v8::V8::SetFlagsFromString(expose_debug_as, sizeof(expose_debug_as) - 1);
   }
+  // The heap flags are read when the isolate is created, which happens right
+  // after this in the isolate holder.
+  if (use_app_v8_flags) {
+    const std::string& flags = GetBrowserV8Flags();
+    if (!flags.empty())
+      v8::V8::SetFlagsFromString(flags.data(), flags.size());
+  }
   gin::IsolateHolder::Initialize(gin::IsolateHolder::kNonStrictMode,
                                  gin::ArrayBufferAllocator::SharedInstance());
   return true;
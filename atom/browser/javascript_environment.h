@@ -12,7 +12,9 @@ namespace atom {
 
 class JavascriptEnvironment {
  public:
-  JavascriptEnvironment();
+  // The V8 flags of the app's package.json are only read for the browser
+  // process, the run-as-node mode takes node's own flags.
+  explicit JavascriptEnvironment(bool use_app_v8_flags = true);
 
   v8::Isolate* isolate() const { return isolate_; }
   v8::Local<v8::Context> context() const {
@@ -20,7 +22,7 @@ class JavascriptEnvironment {
   }
 
  private:
-  bool Initialize();
+  bool Initialize(bool use_app_v8_flags);
 
   bool initialized_;
   gin::IsolateHolder isolate_holder_;
@@ -0,0 +1,292 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/javascript_worker.h"
+
+#include "atom/common/api/event_emitter_caller.h"
+#include "atom/common/atom_command_line.h"
+#include "atom/common/node_includes.h"
+#include "base/bind.h"
+#include "content/public/browser/browser_thread.h"
+#include "gin/array_buffer.h"
+#include "native_mate/arguments.h"
+#include "native_mate/dictionary.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// Closes the handles of the module's JavaScript objects through their close
+// method, whose callback frees the HandleWrap.
+void CloseHandleWraps(node::Environment* env) {
+  v8::Isolate* isolate = env->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::String> close = mate::StringToV8(isolate, "close");
+  for (auto wrap : *env->handle_wrap_queue()) {
+    uv_handle_t* handle = wrap->GetHandle();
+    if (!handle || uv_is_closing(handle) || wrap->persistent().IsEmpty())
+      continue;
+    v8::Local<v8::Object> object = wrap->object();
+    v8::Local<v8::Value> method = object->Get(close);
+    if (method->IsFunction())
+      method.As<v8::Function>()->Call(object, 0, nullptr);
+  }
+}
+
+// The handles left are embedded in the environment and in the worker, so
+// they are closed without a callback.
+void CloseHandle(uv_handle_t* handle, void* arg) {
+  if (!uv_is_closing(handle))
+    uv_close(handle, nullptr);
+}
+
+}  // namespace
+
+JavaScriptWorker::JavaScriptWorker(Delegate* delegate,
+                                   const base::FilePath& init_script,
+                                   const base::FilePath& module_path)
+    : delegate_(delegate),
+      init_script_(init_script),
+      module_path_(module_path),
+      started_(false),
+      isolate_(nullptr),
+      terminated_(false),
+      weak_factory_(this) {
+  weak_this_ = weak_factory_.GetWeakPtr();
+}
+
+JavaScriptWorker::~JavaScriptWorker() {
+  if (!started_)
+    return;
+
+  // The JavaScript is stopped where it is, so this does not wait for the
+  // module to finish its work.
+  Terminate();
+  uv_thread_join(&thread_);
+  uv_loop_close(&loop_);
+}
+
+void JavaScriptWorker::Start() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  DCHECK(!started_);
+
+  // The wakeup handle must be ready before PostMessage can be called.
+  uv_loop_init(&loop_);
+  uv_async_init(&loop_, &wakeup_handle_, &JavaScriptWorker::OnWakeup);
+  wakeup_handle_.data = this;
+
+  started_ = true;
+  uv_thread_create(&thread_, &JavaScriptWorker::ThreadMain, this);
+}
+
+bool JavaScriptWorker::PostMessage(v8::Isolate* isolate,
+                                   v8::Local<v8::Value> value) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  DCHECK(started_);
+
+  Message message;
+  if (!SerializeMessage(isolate, value, &message))
+    return false;
+
+  base::AutoLock auto_lock(lock_);
+  if (terminated_)
+    return false;
+  incoming_messages_.push_back(message);
+  uv_async_send(&wakeup_handle_);
+  return true;
+}
+
+void JavaScriptWorker::Terminate() {
+  base::AutoLock auto_lock(lock_);
+  if (!started_ || terminated_)
+    return;
+
+  terminated_ = true;
+  if (isolate_)
+    isolate_->TerminateExecution();
+  uv_async_send(&wakeup_handle_);
+}
+
+// static
+void JavaScriptWorker::ThreadMain(void* arg) {
+  static_cast<JavaScriptWorker*>(arg)->Run();
+}
+
+// static
+void JavaScriptWorker::OnWakeup(uv_async_t* handle) {
+  JavaScriptWorker* self = static_cast<JavaScriptWorker*>(handle->data);
+
+  std::deque<Message> messages;
+  {
+    base::AutoLock auto_lock(self->lock_);
+    if (self->terminated_) {
+      uv_stop(handle->loop);
+      return;
+    }
+    messages.swap(self->incoming_messages_);
+  }
+
+  // Only the worker's thread changes the isolate.
+  v8::Isolate* isolate = self->isolate_;
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Object> port = v8::Local<v8::Object>::New(isolate,
+                                                          self->port_);
+  for (const Message& message : messages) {
+    v8::Local<v8::Value> value = V8ValueSerializer::Deserialize(
+        isolate, message.data, message.region.get());
+    if (!value.IsEmpty())
+      mate::EmitEvent(isolate, port, "message", value);
+  }
+}
+
+// static
+bool JavaScriptWorker::SerializeMessage(v8::Isolate* isolate,
+                                        v8::Local<v8::Value> value,
+                                        Message* message) {
+  V8ValueSerializer::BufferList buffers;
+  if (!V8ValueSerializer::Serialize(isolate, value, &message->data, &buffers))
+    return false;
+
+  // The large Buffers are copied once, the receiver's Buffers point into the
+  // region.
+  if (!buffers.empty()) {
+    message->region = SharedBufferRegion::CreateAnonymous(
+        V8ValueSerializer::GetBuffersSize(buffers));
+    if (!message->region)
+      return false;
+    V8ValueSerializer::CopyBuffers(buffers, message->region->data());
+  }
+  return true;
+}
+
+void JavaScriptWorker::Run() {
+  v8::Isolate::CreateParams params;
+  params.array_buffer_allocator = gin::ArrayBufferAllocator::SharedInstance();
+  v8::Isolate* isolate = v8::Isolate::New(params);
+
+  {
+    v8::Locker locker(isolate);
+    v8::Isolate::Scope isolate_scope(isolate);
+    RunEnvironment(isolate);
+
+    // Nothing references the worker's context any more. A full GC runs the
+    // weak callbacks of the external Buffers, which frees them and releases
+    // the SharedBufferRegions they point into; disposing the isolate would
+    // skip the callbacks.
+    isolate->LowMemoryNotification();
+  }
+
+  isolate->Dispose();
+
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&JavaScriptWorker::DeliverExit, weak_this_));
+}
+
+void JavaScriptWorker::RunEnvironment(v8::Isolate* isolate) {
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> context = v8::Context::New(isolate);
+  v8::Context::Scope context_scope(context);
+
+  bool terminated;
+  {
+    base::AutoLock auto_lock(lock_);
+    isolate_ = isolate;
+    terminated = terminated_;
+  }
+
+  std::string program = AtomCommandLine::argv()[0];
+  std::string init_script = init_script_.AsUTF8Unsafe();
+  std::string module_path = module_path_.AsUTF8Unsafe();
+  const char* argv[] = {
+    program.c_str(), init_script.c_str(), module_path.c_str()
+  };
+  node::Environment* env = node::CreateEnvironment(
+      isolate, &loop_, context, arraysize(argv), argv, 0, nullptr);
+  SetupPort(isolate, env->process_object());
+
+  // The loop runs until the worker is terminated, the wakeup handle keeps
+  // it alive while the module waits for messages.
+  if (!terminated) {
+    node::LoadEnvironment(env);
+    uv_run(&loop_, UV_RUN_DEFAULT);
+  }
+
+  // Give the module a chance to run its exit handlers.
+  isolate->CancelTerminateExecution();
+  node::EmitExit(env);
+
+  {
+    base::AutoLock auto_lock(lock_);
+    isolate_ = nullptr;
+  }
+
+  // The close callbacks free the handles' wrappers without calling back
+  // into the module.
+  CloseHandleWraps(env);
+  uv_walk(&loop_, &CloseHandle, nullptr);
+  uv_run(&loop_, UV_RUN_DEFAULT);
+
+  port_.Reset();
+  env->Dispose();
+}
+
+void JavaScriptWorker::SetupPort(v8::Isolate* isolate,
+                                 v8::Local<v8::Object> process) {
+  mate::Dictionary port = mate::Dictionary::CreateEmpty(isolate);
+  port.SetMethod("postMessage",
+                 base::Bind(&JavaScriptWorker::PostMessageToOwner,
+                            base::Unretained(this)));
+  port.SetMethod("reportError",
+                 base::Bind(&JavaScriptWorker::ReportError,
+                            base::Unretained(this)));
+  port.SetMethod("terminate",
+                 base::Bind(&JavaScriptWorker::Terminate,
+                            base::Unretained(this)));
+  port_.Reset(isolate, port.GetHandle());
+
+  mate::Dictionary dict(isolate, process);
+  dict.Set("type", "worker");
+  dict.Set("_workerPort", port);
+}
+
+void JavaScriptWorker::PostMessageToOwner(mate::Arguments* args) {
+  v8::Local<v8::Value> value;
+  if (!args->GetNext(&value)) {
+    args->ThrowError();
+    return;
+  }
+
+  Message message;
+  if (!SerializeMessage(args->isolate(), value, &message)) {
+    args->ThrowError("The message can not be serialized");
+    return;
+  }
+
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&JavaScriptWorker::DeliverMessage, weak_this_, message));
+}
+
+void JavaScriptWorker::ReportError(const std::string& stack) {
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&JavaScriptWorker::DeliverError, weak_this_, stack));
+}
+
+void JavaScriptWorker::DeliverMessage(const Message& message) {
+  delegate_->OnWorkerMessage(message.data, message.region.get());
+}
+
+void JavaScriptWorker::DeliverError(const std::string& stack) {
+  delegate_->OnWorkerError(stack);
+}
+
+void JavaScriptWorker::DeliverExit() {
+  delegate_->OnWorkerExit();
+}
+
+}  // namespace atom
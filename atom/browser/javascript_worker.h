@@ -0,0 +1,124 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_JAVASCRIPT_WORKER_H_
+#define ATOM_BROWSER_JAVASCRIPT_WORKER_H_
+
+#include <deque>
+#include <string>
+
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/synchronization/lock.h"
+#include "v8/include/v8.h"
+#include "vendor/node/deps/uv/include/uv.h"
+
+namespace mate {
+class Arguments;
+}
+
+namespace atom {
+
+// Runs a module in a Node environment of its own, with its own isolate and uv
+// loop, on a thread of its own, so it does not compete with the UI thread.
+//
+// Messages are serialized with V8ValueSerializer, the large Buffers are
+// copied once into a region that the Buffers of the receiver point into.
+// Only the module's Node environment is available in the worker, none of
+// Electron's modules are.
+class JavaScriptWorker {
+ public:
+  // The methods are called on the UI thread.
+  class Delegate {
+   public:
+    // The Buffers of the message that were left out of |data| are in
+    // |region|, which can be null.
+    virtual void OnWorkerMessage(const std::string& data,
+                                 SharedBufferRegion* region) = 0;
+    virtual void OnWorkerError(const std::string& stack) = 0;
+    virtual void OnWorkerExit() = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
+  // The worker loads |init_script|, which then loads |module_path|.
+  JavaScriptWorker(Delegate* delegate,
+                   const base::FilePath& init_script,
+                   const base::FilePath& module_path);
+  // Terminates the worker and waits for its thread.
+  ~JavaScriptWorker();
+
+  void Start();
+
+  // Sends |message| to the worker, returns false if it can not be serialized.
+  // Called on the UI thread.
+  bool PostMessage(v8::Isolate* isolate, v8::Local<v8::Value> message);
+
+  // Stops the JavaScript running in the worker and its uv loop, can be called
+  // on any thread.
+  void Terminate();
+
+ private:
+  struct Message {
+    std::string data;
+    scoped_refptr<SharedBufferRegion> region;
+  };
+
+  static void ThreadMain(void* arg);
+  static void OnWakeup(uv_async_t* handle);
+
+  // Serializes |message|, returns false on failure.
+  static bool SerializeMessage(v8::Isolate* isolate,
+                               v8::Local<v8::Value> value,
+                               Message* message);
+
+  // Run on the worker's thread.
+  void Run();
+  // Runs the module in a new context of |isolate| until the worker is
+  // terminated, and disposes of the context's environment.
+  void RunEnvironment(v8::Isolate* isolate);
+  void SetupPort(v8::Isolate* isolate, v8::Local<v8::Object> process);
+  void PostMessageToOwner(mate::Arguments* args);
+  void ReportError(const std::string& stack);
+
+  // Run on the UI thread.
+  void DeliverMessage(const Message& message);
+  void DeliverError(const std::string& stack);
+  void DeliverExit();
+
+  Delegate* delegate_;
+  base::FilePath init_script_;
+  base::FilePath module_path_;
+
+  uv_thread_t thread_;
+  uv_loop_t loop_;
+  uv_async_t wakeup_handle_;
+  bool started_;
+
+  // Only used on the worker's thread.
+  v8::Global<v8::Object> port_;
+
+  // Guards the fields below, which are shared by the threads. The isolate is
+  // only set while the worker's thread can run JavaScript in it.
+  base::Lock lock_;
+  std::deque<Message> incoming_messages_;
+  v8::Isolate* isolate_;
+  bool terminated_;
+
+  // Created on the UI thread, the worker's thread only copies it into the
+  // tasks it posts to the UI thread.
+  base::WeakPtr<JavaScriptWorker> weak_this_;
+
+  base::WeakPtrFactory<JavaScriptWorker> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(JavaScriptWorker);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_JAVASCRIPT_WORKER_H_
@@ -5,6 +5,7 @@
 #include "atom/browser/login_handler.h"
 
 #include "atom/browser/browser.h"
+#include "atom/browser/net/auth_cache.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/resource_dispatcher_host.h"
@@ -37,6 +38,20 @@ LoginHandler::LoginHandler(net::AuthChallengeInfo* auth_info,
       render_frame_id_(0) {
   content::ResourceRequestInfo::ForRequest(request_)->GetAssociatedRenderFrame(
       &render_process_host_id_,  &render_frame_id_);
+
+  // The credentials the session remembers are given without asking the
+  // handlers again.
+  AuthCache* auth_cache = AuthCache::ForRequest(request_);
+  net::AuthCredentials credentials;
+  if (auth_cache && auth_cache->Get(request_, *auth_info_, &credentials)) {
+    TestAndSetAuthHandled();
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&LoginHandler::DoLogin, this, credentials.username(),
+                   credentials.password()));
+    return;
+  }
+
   BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
                           base::Bind(&Browser::RequestLogin,
                                      base::Unretained(Browser::Get()),
@@ -101,7 +116,11 @@ void LoginHandler::DoLogin(const base::string16& username,
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
 
   if (request_) {
-    request_->SetAuth(net::AuthCredentials(username, password));
+    net::AuthCredentials credentials(username, password);
+    AuthCache* auth_cache = AuthCache::ForRequest(request_);
+    if (auth_cache)
+      auth_cache->Put(request_, *auth_info_, credentials);
+    request_->SetAuth(credentials);
     ResetLoginHandlerForRequest(request_);
   }
 }
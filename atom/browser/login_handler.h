@@ -20,7 +20,8 @@ class URLRequest;
 
 namespace atom {
 
-// Handles the HTTP basic auth, must be created on IO thread.
+// Handles the HTTP basic auth, must be created on IO thread. The challenges
+// the session's AuthCache has credentials for are answered on the IO thread.
 class LoginHandler : public content::ResourceDispatcherHostLoginDelegate {
  public:
   LoginHandler(net::AuthChallengeInfo* auth_info, net::URLRequest* request);
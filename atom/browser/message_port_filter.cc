@@ -0,0 +1,179 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/message_port_filter.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "atom/common/api/api_messages.h"
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+struct Port {
+  int process_id;
+  int routing_id;
+  int32 peer_id;
+};
+
+// The members below can only be accessed on the IO thread.
+typedef std::map<int32, Port> PortMap;
+base::LazyInstance<PortMap> g_ports = LAZY_INSTANCE_INITIALIZER;
+
+typedef std::map<int, MessagePortFilter*> FilterMap;
+base::LazyInstance<FilterMap> g_filters = LAZY_INSTANCE_INITIALIZER;
+
+// The processes whose channel has closed, the ports created for them after
+// that are dropped.
+base::LazyInstance<std::set<int>> g_closed_processes =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Only accessed on the UI thread.
+int32 g_next_port_id = 0;
+
+void AddPorts(int32 port_id1, const Port& port1,
+              int32 port_id2, const Port& port2) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  const std::set<int>& closed = g_closed_processes.Get();
+  if (closed.count(port1.process_id) || closed.count(port2.process_id))
+    return;
+  g_ports.Get()[port_id1] = port1;
+  g_ports.Get()[port_id2] = port2;
+}
+
+// Removes |port_id| and its peer, and tells the peer's renderer.
+void RemovePort(int32 port_id) {
+  PortMap& ports = g_ports.Get();
+  auto it = ports.find(port_id);
+  if (it == ports.end())
+    return;
+  int32 peer_id = it->second.peer_id;
+  ports.erase(it);
+
+  auto peer = ports.find(peer_id);
+  if (peer == ports.end())
+    return;
+  auto filter = g_filters.Get().find(peer->second.process_id);
+  if (filter != g_filters.Get().end())
+    filter->second->Send(
+        new AtomViewMsg_PortClosed(peer->second.routing_id, peer_id));
+  ports.erase(peer);
+}
+
+// Whether |port| belongs to the view of |routing_id| in |process_id|.
+bool IsOwnedBy(const Port& port, int process_id, int routing_id) {
+  return port.process_id == process_id && port.routing_id == routing_id;
+}
+
+// Removes the ports of the view of |routing_id| in |process_id|, or of all
+// its views when |routing_id| is MSG_ROUTING_NONE.
+void RemovePorts(int process_id, int routing_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  std::vector<int32> port_ids;
+  for (const auto& it : g_ports.Get())
+    if (it.second.process_id == process_id &&
+        (routing_id == MSG_ROUTING_NONE || it.second.routing_id == routing_id))
+      port_ids.push_back(it.first);
+  for (int32 port_id : port_ids)
+    RemovePort(port_id);
+}
+
+}  // namespace
+
+MessagePortFilter::MessagePortFilter(int render_process_id)
+    : BrowserMessageFilter(ShellMsgStart),
+      render_process_id_(render_process_id),
+      current_routing_id_(MSG_ROUTING_NONE) {
+}
+
+MessagePortFilter::~MessagePortFilter() {
+}
+
+// static
+void MessagePortFilter::CreateChannel(int process_id1, int routing_id1,
+                                      int process_id2, int routing_id2,
+                                      int32* port_id1, int32* port_id2) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  *port_id1 = ++g_next_port_id;
+  *port_id2 = ++g_next_port_id;
+
+  // The ports are added before the renderers can learn their ids, because
+  // the messages that carry the ids are also sent through the IO thread.
+  Port port1 = { process_id1, routing_id1, *port_id2 };
+  Port port2 = { process_id2, routing_id2, *port_id1 };
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&AddPorts, *port_id1, port1, *port_id2, port2));
+}
+
+// static
+void MessagePortFilter::CloseViewPorts(int process_id, int routing_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&RemovePorts, process_id, routing_id));
+}
+
+void MessagePortFilter::OnFilterAdded(IPC::Sender* sender) {
+  // The process host may be initialized again after its renderer crashed.
+  g_closed_processes.Get().erase(render_process_id_);
+  g_filters.Get()[render_process_id_] = this;
+}
+
+void MessagePortFilter::OnChannelClosing() {
+  g_filters.Get().erase(render_process_id_);
+  g_closed_processes.Get().insert(render_process_id_);
+
+  // Close the ports of the process.
+  RemovePorts(render_process_id_, MSG_ROUTING_NONE);
+}
+
+bool MessagePortFilter::OnMessageReceived(const IPC::Message& message) {
+  // The handlers check that the port belongs to the view that sent the
+  // message, not only to its process.
+  current_routing_id_ = message.routing_id();
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(MessagePortFilter, message)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_PortMessage, OnPortMessage)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_PortClose, OnPortClose)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void MessagePortFilter::OnPortMessage(int32 port_id, const std::string& args) {
+  PortMap& ports = g_ports.Get();
+  auto port = ports.find(port_id);
+  if (port == ports.end() ||
+      !IsOwnedBy(port->second, render_process_id_, current_routing_id_))
+    return;
+
+  auto peer = ports.find(port->second.peer_id);
+  if (peer == ports.end())
+    return;
+  auto filter = g_filters.Get().find(peer->second.process_id);
+  if (filter == g_filters.Get().end())
+    return;
+
+  filter->second->Send(new AtomViewMsg_PortMessage(
+      peer->second.routing_id, port->second.peer_id, args));
+}
+
+void MessagePortFilter::OnPortClose(int32 port_id) {
+  auto port = g_ports.Get().find(port_id);
+  if (port == g_ports.Get().end() ||
+      !IsOwnedBy(port->second, render_process_id_, current_routing_id_))
+    return;
+  RemovePort(port_id);
+}
+
+}  // namespace atom
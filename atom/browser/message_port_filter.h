@@ -0,0 +1,55 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_MESSAGE_PORT_FILTER_H_
+#define ATOM_BROWSER_MESSAGE_PORT_FILTER_H_
+
+#include <string>
+
+#include "content/public/browser/browser_message_filter.h"
+
+namespace atom {
+
+// Relays the messages of the ports created by ipc.createMessageChannel
+// between renderers on the IO thread, so they never reach the main process's
+// JavaScript or its UI thread.
+//
+// Each port belongs to a view, and has a peer port that receives the messages
+// posted to it. A port can only be used by the process it was given to.
+class MessagePortFilter : public content::BrowserMessageFilter {
+ public:
+  explicit MessagePortFilter(int render_process_id);
+
+  // Creates two entangled ports for the views, and returns their ids.
+  // Must be called on the UI thread.
+  static void CreateChannel(int process_id1, int routing_id1,
+                            int process_id2, int routing_id2,
+                            int32* port_id1, int32* port_id2);
+
+  // Closes the ports of a view that has been deleted, its process may keep
+  // running for other views. Must be called on the UI thread.
+  static void CloseViewPorts(int process_id, int routing_id);
+
+  // content::BrowserMessageFilter:
+  void OnFilterAdded(IPC::Sender* sender) override;
+  void OnChannelClosing() override;
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+ private:
+  ~MessagePortFilter() override;
+
+  void OnPortMessage(int32 port_id, const std::string& args);
+  void OnPortClose(int32 port_id);
+
+  int render_process_id_;
+
+  // The view that sent the message being handled.
+  int current_routing_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessagePortFilter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_MESSAGE_PORT_FILTER_H_
@@ -10,8 +10,10 @@
 
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/atom_browser_main_parts.h"
+#include "atom/browser/web_contents_preferences.h"
 #include "atom/browser/window_list.h"
 #include "atom/common/api/api_messages.h"
+#include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/image_converter.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/options_switches.h"
@@ -32,6 +34,7 @@
 #include "ipc/ipc_message_macros.h"
 #include "native_mate/dictionary.h"
 #include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/display.h"
 #include "ui/gfx/geometry/size_conversions.h"
 #include "ui/gfx/geometry/point.h"
 #include "ui/gfx/geometry/rect.h"
@@ -50,7 +53,14 @@ NativeWindow::NativeWindow(
       has_frame_(true),
       force_using_draggable_region_(false),
       transparent_(false),
+      draggable_regions_known_(false),
+      draggable_regions_generation_(0),
+      draggable_regions_sequence_(0),
+      draggable_regions_resync_requested_(false),
       enable_larger_than_screen_(false),
+      offscreen_(false),
+      background_throttling_(false),
+      page_visible_(true),
       is_closed_(false),
       has_dialog_attached_(false),
       aspect_ratio_(0.0),
@@ -60,6 +70,14 @@ NativeWindow::NativeWindow(
   options.Get(switches::kTransparent, &transparent_);
   options.Get(switches::kEnableLargerThanScreen, &enable_larger_than_screen_);
 
+  // The offscreen window has nothing but the page, and must not be moved back
+  // into the screen.
+  options.Get(switches::kOffscreen, &offscreen_);
+  if (offscreen_) {
+    has_frame_ = false;
+    enable_larger_than_screen_ = true;
+  }
+
   // Tell the content module to initialize renderer widget with transparent
   // mode.
   ui::GpuSwitchingManager::SetTransparent(transparent_);
@@ -67,6 +85,11 @@ NativeWindow::NativeWindow(
   // Read icon before window is created.
   options.Get(switches::kIcon, &icon_);
 
+  auto preferences = WebContentsPreferences::FromWebContents(web_contents());
+  if (preferences && !offscreen_)
+    preferences->web_preferences()->GetBoolean(
+        switches::kBackgroundThrottling, &background_throttling_);
+
   WindowList::AddWindow(this);
 }
 
@@ -150,10 +173,68 @@ void NativeWindow::InitFromOptions(const mate::Dictionary& options) {
   // Then show it.
   bool show = true;
   options.Get(switches::kShow, &show);
-  if (show)
+  if (offscreen_)
+    ShowOffscreen();
+  else if (show)
     Show();
 }
 
+void NativeWindow::SetState(const mate::Dictionary& state) {
+  extensions::SizeConstraints size_constraints(GetSizeConstraints());
+  gfx::Size minimum_size, maximum_size;
+  bool has_minimum_size = state.Get("minimumSize", &minimum_size);
+  bool has_maximum_size = state.Get("maximumSize", &maximum_size);
+  if ((has_minimum_size &&
+       minimum_size != size_constraints.GetMinimumSize()) ||
+      (has_maximum_size &&
+       maximum_size != size_constraints.GetMaximumSize())) {
+    if (has_minimum_size)
+      size_constraints.set_minimum_size(minimum_size);
+    if (has_maximum_size)
+      size_constraints.set_maximum_size(maximum_size);
+    SetSizeConstraints(size_constraints);
+  }
+
+  // The missing fields of the bounds are kept.
+  mate::Dictionary bounds_dict;
+  if (state.Get("bounds", &bounds_dict)) {
+    gfx::Rect current = GetBounds();
+    gfx::Rect bounds = current;
+    int value;
+    if (bounds_dict.Get("x", &value))
+      bounds.set_x(value);
+    if (bounds_dict.Get("y", &value))
+      bounds.set_y(value);
+    if (bounds_dict.Get("width", &value))
+      bounds.set_width(value);
+    if (bounds_dict.Get("height", &value))
+      bounds.set_height(value);
+    if (bounds != current)
+      SetBounds(bounds);
+  }
+
+  bool top;
+  if (state.Get("alwaysOnTop", &top) && top != IsAlwaysOnTop())
+    SetAlwaysOnTop(top);
+  std::string title;
+  if (state.Get("title", &title) && title != GetTitle())
+    SetTitle(title);
+
+  bool visible;
+  if (state.Get("visible", &visible) && visible != IsVisible()) {
+    if (visible)
+      Show();
+    else
+      Hide();
+  }
+}
+
+void NativeWindow::BeginStateUpdate() {
+}
+
+void NativeWindow::EndStateUpdate() {
+}
+
 void NativeWindow::SetSize(const gfx::Size& size) {
   SetBounds(gfx::Rect(GetPosition(), size));
 }
@@ -419,10 +500,12 @@ void NativeWindow::NotifyWindowUnmaximize() {
 }
 
 void NativeWindow::NotifyWindowMinimize() {
+  SetPageVisible(false);
   FOR_EACH_OBSERVER(NativeWindowObserver, observers_, OnWindowMinimize());
 }
 
 void NativeWindow::NotifyWindowRestore() {
+  SetPageVisible(IsVisible());
   FOR_EACH_OBSERVER(NativeWindowObserver, observers_, OnWindowRestore());
 }
 
@@ -488,6 +571,13 @@ scoped_ptr<SkRegion> NativeWindow::DraggableRegionsToSkRegion(
 
 void NativeWindow::RenderViewCreated(
     content::RenderViewHost* render_view_host) {
+  // The new page sends its draggable regions from scratch.
+  draggable_regions_.clear();
+  draggable_regions_known_ = false;
+  draggable_regions_resync_requested_ = false;
+  if (draggable_region_)
+    UpdateDraggableRegions(draggable_regions_);
+
   if (!transparent_)
     return;
 
@@ -520,13 +610,24 @@ bool NativeWindow::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(NativeWindow, message)
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_UpdateDraggableRegions,
-                        UpdateDraggableRegions)
+                        OnUpdateDraggableRegions)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
   return handled;
 }
 
+void NativeWindow::SetPageVisible(bool visible) {
+  if (!background_throttling_ || visible == page_visible_)
+    return;
+
+  page_visible_ = visible;
+  if (visible)
+    web_contents()->WasShown();
+  else
+    web_contents()->WasHidden();
+}
+
 void NativeWindow::UpdateDraggableRegions(
     const std::vector<DraggableRegion>& regions) {
   // Draggable region is not supported for non-frameless window.
@@ -557,6 +658,56 @@ void NativeWindow::NotifyWindowUnresponsive() {
                       OnRendererUnresponsive());
 }
 
+void NativeWindow::ShowOffscreen() {
+  // The compositor only draws while the window is shown, so it is shown right
+  // after the bottom right corner of all the displays.
+  gfx::Rect area;
+  gfx::Screen* screen = gfx::Screen::GetNativeScreen();
+  for (const gfx::Display& display : screen->GetAllDisplays())
+    area.Union(display.bounds());
+  SetSkipTaskbar(true);
+  SetPosition(area.bottom_right());
+  ShowInactive();
+}
+
+void NativeWindow::OnUpdateDraggableRegions(
+    uint32 generation,
+    uint32 sequence,
+    uint32 start,
+    uint32 removed,
+    const std::vector<DraggableRegion>& inserted) {
+  if (sequence == 0) {
+    // A full update replaces whatever is known.
+    draggable_regions_ = inserted;
+    draggable_regions_known_ = true;
+    draggable_regions_generation_ = generation;
+    draggable_regions_sequence_ = 0;
+    draggable_regions_resync_requested_ = false;
+    UpdateDraggableRegions(draggable_regions_);
+    return;
+  }
+
+  // The change is based on regions that are not the known ones, when the
+  // renderer was recreated or an update was missed.
+  if (!draggable_regions_known_ ||
+      generation != draggable_regions_generation_ ||
+      sequence != draggable_regions_sequence_ + 1 ||
+      start > draggable_regions_.size() ||
+      removed > draggable_regions_.size() - start) {
+    if (!draggable_regions_resync_requested_) {
+      draggable_regions_resync_requested_ = true;
+      Send(new AtomViewMsg_ResyncDraggableRegions(routing_id()));
+    }
+    return;
+  }
+
+  auto begin = draggable_regions_.begin() + start;
+  begin = draggable_regions_.erase(begin, begin + removed);
+  draggable_regions_.insert(begin, inserted.begin(), inserted.end());
+  draggable_regions_sequence_ = sequence;
+  UpdateDraggableRegions(draggable_regions_);
+}
+
 void NativeWindow::OnCapturePageDone(const CapturePageCallback& callback,
                                      const SkBitmap& bitmap,
                                      content::ReadbackResponse response) {
@@ -11,6 +11,7 @@
 
 #include "atom/browser/native_window_observer.h"
 #include "atom/browser/ui/accelerator_util.h"
+#include "atom/common/draggable_region.h"
 #include "base/cancelable_callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -49,8 +50,6 @@ class MenuModel;
 
 namespace atom {
 
-struct DraggableRegion;
-
 class NativeWindow : public base::SupportsUserData,
                      public content::WebContentsObserver {
  public:
@@ -88,6 +87,16 @@ class NativeWindow : public base::SupportsUserData,
 
   void InitFromOptions(const mate::Dictionary& options);
 
+  // Applies the properties of |state|, skipping the ones that would not
+  // change anything. The constraints are applied before the bounds, and the
+  // visibility last.
+  void SetState(const mate::Dictionary& state);
+
+  // Calls to SetState between them are shown together, the updates can be
+  // nested.
+  virtual void BeginStateUpdate();
+  virtual void EndStateUpdate();
+
   virtual void Close() = 0;
   virtual void CloseImmediately() = 0;
   virtual bool IsClosed() const { return is_closed_; }
@@ -227,7 +236,11 @@ class NativeWindow : public base::SupportsUserData,
 
   bool has_frame() const { return has_frame_; }
   bool transparent() const { return transparent_; }
+  bool offscreen() const { return offscreen_; }
   SkRegion* draggable_region() const { return draggable_region_.get(); }
+  const std::vector<DraggableRegion>& draggable_regions() const {
+    return draggable_regions_;
+  }
   bool enable_larger_than_screen() const { return enable_larger_than_screen_; }
   gfx::ImageSkia icon() const { return icon_; }
 
@@ -242,6 +255,10 @@ class NativeWindow : public base::SupportsUserData,
     has_dialog_attached_ = has_dialog_attached;
   }
 
+  // Tells the page whether the window can be seen, the page is hidden and so
+  // throttled while it can not when "background-throttling" is set.
+  void SetPageVisible(bool visible);
+
  protected:
   NativeWindow(brightray::InspectableWebContents* inspectable_web_contents,
                const mate::Dictionary& options);
@@ -272,6 +289,18 @@ class NativeWindow : public base::SupportsUserData,
   // Dispatch unresponsive event to observers.
   void NotifyWindowUnresponsive();
 
+  // Shows the window outside of all the displays, so its page keeps painting
+  // without being seen.
+  void ShowOffscreen();
+
+  // Applies the changes of the draggable regions sent by renderer, or asks
+  // for all the regions when the changes are not based on the known ones.
+  void OnUpdateDraggableRegions(uint32 generation,
+                                uint32 sequence,
+                                uint32 start,
+                                uint32 removed,
+                                const std::vector<DraggableRegion>& inserted);
+
   // Called when CapturePage has done.
   void OnCapturePageDone(const CapturePageCallback& callback,
                          const SkBitmap& bitmap,
@@ -290,6 +319,17 @@ class NativeWindow : public base::SupportsUserData,
   // has to been explicitly provided.
   scoped_ptr<SkRegion> draggable_region_;  // used in custom drag.
 
+  // The draggable regions of the page, in the order they are applied.
+  std::vector<DraggableRegion> draggable_regions_;
+
+  // The generation and sequence number of the last update that was applied
+  // to |draggable_regions_|, and whether a full update has been requested.
+  // The regions are unknown until the first full update of a renderer.
+  bool draggable_regions_known_;
+  uint32 draggable_regions_generation_;
+  uint32 draggable_regions_sequence_;
+  bool draggable_regions_resync_requested_;
+
   // Minimum and maximum size, stored as content size.
   extensions::SizeConstraints size_constraints_;
 
@@ -299,6 +339,15 @@ class NativeWindow : public base::SupportsUserData,
   // Window icon.
   gfx::ImageSkia icon_;
 
+  // Whether the window is kept outside of the displays to paint the page.
+  bool offscreen_;
+
+  // Whether the page is hidden when the window can not be seen.
+  bool background_throttling_;
+
+  // Whether the page has been told that the window can be seen.
+  bool page_visible_;
+
   // The windows has been closed.
   bool is_closed_;
 
@@ -69,12 +69,14 @@ class NativeWindowMac : public NativeWindow {
                       const std::string& description) override;
   void ShowDefinitionForSelection() override;
 
+  void BeginStateUpdate() override;
+  void EndStateUpdate() override;
   void SetVisibleOnAllWorkspaces(bool visible) override;
   bool IsVisibleOnAllWorkspaces() override;
 
   // Refresh the DraggableRegion views.
   void UpdateDraggableRegionViews() {
-    UpdateDraggableRegionViews(draggable_regions_);
+    UpdateDraggableRegionViews(draggable_regions());
   }
 
  protected:
@@ -108,8 +110,6 @@ class NativeWindowMac : public NativeWindow {
   // The view that will fill the whole frameless window.
   base::scoped_nsobject<FullSizeContentView> content_view_;
 
-  std::vector<DraggableRegion> draggable_regions_;
-
   bool is_kiosk_;
 
   NSInteger attention_request_id_;  // identifier from requestUserAttention
@@ -166,6 +166,15 @@ bool ScopedDisableResize::disable_resize_ = false;
   shell_->NotifyWindowRestore();
 }
 
+- (void)windowDidChangeOcclusionState:(NSNotification*)notification {
+  // The notification is only sent on OS X 10.9 and later.
+  NSWindow* window = shell_->GetNativeWindow();
+  if ([window respondsToSelector:@selector(occlusionState)])
+    shell_->SetPageVisible(
+        ([window occlusionState] & NSWindowOcclusionStateVisible) &&
+        !shell_->IsMinimized());
+}
+
 - (BOOL)windowShouldZoom:(NSWindow*)window toFrame:(NSRect)newFrame {
   // Cocoa doen't have concept of maximize/unmaximize, so wee need to emulate
   // them by calculating size change when zooming.
@@ -457,14 +466,17 @@ void NativeWindowMac::Show() {
   [NSApp activateIgnoringOtherApps:YES];
 
   [window_ makeKeyAndOrderFront:nil];
+  SetPageVisible(!IsMinimized());
 }
 
 void NativeWindowMac::ShowInactive() {
   [window_ orderFrontRegardless];
+  SetPageVisible(!IsMinimized());
 }
 
 void NativeWindowMac::Hide() {
   [window_ orderOut:nil];
+  SetPageVisible(false);
 }
 
 bool NativeWindowMac::IsVisible() {
@@ -711,6 +723,15 @@ void NativeWindowMac::ShowDefinitionForSelection() {
   rwhv->ShowDefinitionForSelection();
 }
 
+void NativeWindowMac::BeginStateUpdate() {
+  // Screen updates are disabled for all windows, and the calls nest.
+  NSDisableScreenUpdates();
+}
+
+void NativeWindowMac::EndStateUpdate() {
+  NSEnableScreenUpdates();
+}
+
 void NativeWindowMac::SetVisibleOnAllWorkspaces(bool visible) {
   NSUInteger collectionBehavior = [window_ collectionBehavior];
   if (visible) {
@@ -788,7 +809,6 @@ gfx::Size NativeWindowMac::WindowSizeToContentSize(const gfx::Size& size) {
 void NativeWindowMac::UpdateDraggableRegions(
     const std::vector<DraggableRegion>& regions) {
   NativeWindow::UpdateDraggableRegions(regions);
-  draggable_regions_ = regions;
   UpdateDraggableRegionViews(regions);
 }
 
@@ -308,14 +308,17 @@ bool NativeWindowViews::IsFocused() {
 
 void NativeWindowViews::Show() {
   window_->native_widget_private()->ShowWithWindowState(GetRestoredState());
+  SetPageVisible(!IsMinimized());
 }
 
 void NativeWindowViews::ShowInactive() {
   window_->ShowInactive();
+  SetPageVisible(!IsMinimized());
 }
 
 void NativeWindowViews::Hide() {
   window_->Hide();
+  SetPageVisible(false);
 }
 
 bool NativeWindowViews::IsVisible() {
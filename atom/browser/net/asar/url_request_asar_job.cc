@@ -4,6 +4,8 @@
 
 #include "atom/browser/net/asar/url_request_asar_job.h"
 
+#include <string.h>
+
 #include <string>
 #include <vector>
 
@@ -12,6 +14,7 @@
 #include "base/strings/string_util.h"
 #include "base/synchronization/lock.h"
 #include "base/task_runner.h"
+#include "base/task_runner_util.h"
 #include "atom/common/asar/archive.h"
 #include "atom/common/asar/asar_util.h"
 #include "net/base/file_stream.h"
@@ -30,6 +33,15 @@
 
 namespace asar {
 
+namespace {
+
+// Files up to this size are served straight from the mapping of archive,
+// larger ones are read on the file thread to keep page faults off the IO
+// thread.
+const uint32 kMaxMappedFileSize = 4 * 1024 * 1024;
+
+}  // namespace
+
 URLRequestAsarJob::FileMetaInfo::FileMetaInfo()
     : file_size(0),
       mime_type_result(false),
@@ -43,6 +55,7 @@ URLRequestAsarJob::URLRequestAsarJob(
     : net::URLRequestJob(request, network_delegate),
       type_(TYPE_ERROR),
       remaining_bytes_(0),
+      read_offset_(0),
       weak_ptr_factory_(this) {}
 
 URLRequestAsarJob::~URLRequestAsarJob() {}
@@ -81,7 +94,6 @@ void URLRequestAsarJob::InitializeAsarJob(
     const Archive::FileInfo& file_info) {
   type_ = TYPE_ASAR;
   file_task_runner_ = file_task_runner;
-  stream_.reset(new net::FileStream(file_task_runner_));
   archive_ = archive;
   file_path_ = file_path;
   file_info_ = file_info;
@@ -98,16 +110,17 @@ void URLRequestAsarJob::InitializeFileJob(
 
 void URLRequestAsarJob::Start() {
   if (type_ == TYPE_ASAR) {
-    remaining_bytes_ = static_cast<int64>(file_info_.size);
-
-    int flags = base::File::FLAG_OPEN |
-                base::File::FLAG_READ |
-                base::File::FLAG_ASYNC;
-    int rv = stream_->Open(archive_->path(), flags,
-                           base::Bind(&URLRequestAsarJob::DidOpen,
-                                      weak_ptr_factory_.GetWeakPtr()));
-    if (rv != net::ERR_IO_PENDING)
-      DidOpen(rv);
+    // The archive is already open, so there is no open or seek per request,
+    // only the mapping is verified and paged in on the file thread.
+    base::StringPiece* contents = new base::StringPiece;
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(),
+        FROM_HERE,
+        base::Bind(&URLRequestAsarJob::MapContents, archive_, file_info_,
+                   base::Unretained(contents)),
+        base::Bind(&URLRequestAsarJob::DidMapContents,
+                   weak_ptr_factory_.GetWeakPtr(),
+                   base::Owned(contents)));
   } else if (type_ == TYPE_FILE) {
     FileMetaInfo* meta_info = new FileMetaInfo();
     file_task_runner_->PostTaskAndReply(
@@ -143,6 +156,31 @@ bool URLRequestAsarJob::ReadRawData(net::IOBuffer* dest,
     return true;
   }
 
+  // Small files are copied straight from the mapping.
+  if (type_ == TYPE_ASAR && mapped_contents_.data()) {
+    memcpy(dest->data(), mapped_contents_.data() + read_offset_, dest_size);
+    *bytes_read = dest_size;
+    remaining_bytes_ -= dest_size;
+    read_offset_ += dest_size;
+    return true;
+  }
+
+  // Inflating and reading large files could be slow, so they are done on
+  // |file_task_runner_|.
+  if (type_ == TYPE_ASAR) {
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(),
+        FROM_HERE,
+        base::Bind(&URLRequestAsarJob::ReadFromArchive, archive_,
+                   file_info_, read_offset_, make_scoped_refptr(dest),
+                   dest_size),
+        base::Bind(&URLRequestAsarJob::DidRead,
+                   weak_ptr_factory_.GetWeakPtr(),
+                   make_scoped_refptr(dest)));
+    SetStatus(net::URLRequestStatus(net::URLRequestStatus::IO_PENDING, 0));
+    return false;
+  }
+
   int rv = stream_->Read(dest,
                          dest_size,
                          base::Bind(&URLRequestAsarJob::DidRead,
@@ -258,14 +296,72 @@ void URLRequestAsarJob::DidFetchMetaInfo(const FileMetaInfo* meta_info) {
     DidOpen(rv);
 }
 
+// static
+int URLRequestAsarJob::ReadFromArchive(std::shared_ptr<Archive> archive,
+                                       const Archive::FileInfo& file_info,
+                                       uint64 offset,
+                                       scoped_refptr<net::IOBuffer> buf,
+                                       int buf_size) {
+  int rv = archive->ReadFile(file_info, offset, buf_size, buf->data());
+  return rv < 0 ? net::ERR_FAILED : rv;
+}
+
+// static
+bool URLRequestAsarJob::MapContents(std::shared_ptr<Archive> archive,
+                                    const Archive::FileInfo& file_info,
+                                    base::StringPiece* contents) {
+  if (file_info.size > kMaxMappedFileSize ||
+      !archive->GetFileContents(file_info, contents))
+    return false;
+
+  // Touch each page so the IO thread does not wait for them.
+  const size_t kPageSize = 4096;
+  volatile char sink = 0;
+  for (size_t i = 0; i < contents->size(); i += kPageSize)
+    sink += (*contents)[i];
+  return true;
+}
+
+void URLRequestAsarJob::DidMapContents(base::StringPiece* contents,
+                                       bool mapped) {
+  if (mapped)
+    mapped_contents_ = *contents;
+
+  if (file_info_.size > 0 &&
+      !byte_range_.ComputeBounds(static_cast<int64>(file_info_.size))) {
+    NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED,
+               net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
+    return;
+  }
+
+  if (file_info_.size > 0) {
+    read_offset_ = byte_range_.first_byte_position();
+    remaining_bytes_ = byte_range_.last_byte_position() -
+                       byte_range_.first_byte_position() + 1;
+  } else {
+    remaining_bytes_ = 0;
+  }
+  set_expected_content_size(remaining_bytes_);
+  NotifyHeadersComplete();
+}
+
 void URLRequestAsarJob::DidOpen(int result) {
   if (result != net::OK) {
     NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED, result));
     return;
   }
 
-  if (type_ == TYPE_ASAR) {
-    int rv = stream_->Seek(file_info_.offset,
+  if (!byte_range_.ComputeBounds(meta_info_.file_size)) {
+    NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED,
+               net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
+    return;
+  }
+
+  remaining_bytes_ = byte_range_.last_byte_position() -
+                     byte_range_.first_byte_position() + 1;
+
+  if (remaining_bytes_ > 0 && byte_range_.first_byte_position() != 0) {
+    int rv = stream_->Seek(byte_range_.first_byte_position(),
                            base::Bind(&URLRequestAsarJob::DidSeek,
                                       weak_ptr_factory_.GetWeakPtr()));
     if (rv != net::ERR_IO_PENDING) {
@@ -274,46 +370,18 @@ void URLRequestAsarJob::DidOpen(int result) {
       DidSeek(-1);
     }
   } else {
-    if (!byte_range_.ComputeBounds(meta_info_.file_size)) {
-      NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED,
-                 net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
-      return;
-    }
-
-    remaining_bytes_ = byte_range_.last_byte_position() -
-                       byte_range_.first_byte_position() + 1;
-
-    if (remaining_bytes_ > 0 && byte_range_.first_byte_position() != 0) {
-      int rv = stream_->Seek(byte_range_.first_byte_position(),
-                             base::Bind(&URLRequestAsarJob::DidSeek,
-                                        weak_ptr_factory_.GetWeakPtr()));
-      if (rv != net::ERR_IO_PENDING) {
-        // stream_->Seek() failed, so pass an intentionally erroneous value
-        // into DidSeek().
-        DidSeek(-1);
-      }
-    } else {
-      // We didn't need to call stream_->Seek() at all, so we pass to DidSeek()
-      // the value that would mean seek success. This way we skip the code
-      // handling seek failure.
-      DidSeek(byte_range_.first_byte_position());
-    }
+    // We didn't need to call stream_->Seek() at all, so we pass to DidSeek()
+    // the value that would mean seek success. This way we skip the code
+    // handling seek failure.
+    DidSeek(byte_range_.first_byte_position());
   }
 }
 
 void URLRequestAsarJob::DidSeek(int64 result) {
-  if (type_ == TYPE_ASAR) {
-    if (result != static_cast<int64>(file_info_.offset)) {
-      NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED,
-                                       net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
-      return;
-    }
-  } else {
-    if (result != byte_range_.first_byte_position()) {
-      NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED,
-                                       net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
-      return;
-    }
+  if (result != byte_range_.first_byte_position()) {
+    NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                                     net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
+    return;
   }
   set_expected_content_size(remaining_bytes_);
   NotifyHeadersComplete();
@@ -323,6 +391,7 @@ void URLRequestAsarJob::DidRead(scoped_refptr<net::IOBuffer> buf, int result) {
   if (result > 0) {
     SetStatus(net::URLRequestStatus());  // Clear the IO_PENDING status
     remaining_bytes_ -= result;
+    read_offset_ += result;
     DCHECK_GE(remaining_bytes_, 0);
   }
 
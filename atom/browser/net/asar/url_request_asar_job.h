@@ -13,6 +13,7 @@
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
 #include "net/http/http_byte_range.h"
 #include "net/url_request/url_request_job.h"
 
@@ -89,6 +90,23 @@ class URLRequestAsarJob : public net::URLRequestJob {
   // Callback after fetching file info on a background thread.
   void DidFetchMetaInfo(const FileMetaInfo* meta_info);
 
+  // Reads from a file in archive on a background thread.
+  static int ReadFromArchive(std::shared_ptr<Archive> archive,
+                             const Archive::FileInfo& file_info,
+                             uint64 offset,
+                             scoped_refptr<net::IOBuffer> buf,
+                             int buf_size);
+
+  // Gets the view of small uncompressed file in the mapping of archive, and
+  // pages it in, on a background thread.
+  static bool MapContents(std::shared_ptr<Archive> archive,
+                          const Archive::FileInfo& file_info,
+                          base::StringPiece* contents);
+
+  // Starts the job for file in archive once its contents are mapped, files
+  // that can not be mapped are read through Archive::ReadFile.
+  void DidMapContents(base::StringPiece* contents, bool mapped);
+
 
   // Callback after opening file on a background thread.
   void DidOpen(int result);
@@ -118,6 +136,10 @@ class URLRequestAsarJob : public net::URLRequestJob {
 
   net::HttpByteRange byte_range_;
   int64 remaining_bytes_;
+  // Position of next read in file in archive.
+  uint64 read_offset_;
+  // View of the file in the mapping of |archive_|, which keeps it alive.
+  base::StringPiece mapped_contents_;
 
   base::WeakPtrFactory<URLRequestAsarJob> weak_ptr_factory_;
 
@@ -5,10 +5,19 @@
 
 #include "atom/browser/net/atom_url_request_job_factory.h"
 
+#include <algorithm>
+
+#include "atom/browser/net/asar/url_request_asar_job.h"
+#include "atom/browser/net/protocol_stats.h"
 #include "base/stl_util.h"
+#include "base/strings/string_util.h"
 #include "content/public/browser/browser_thread.h"
+#include "net/base/escape.h"
 #include "net/base/load_flags.h"
+#include "net/base/net_errors.h"
 #include "net/url_request/url_request.h"
+#include "net/url_request/url_request_error_job.h"
+#include "net/url_request/url_request_simple_job.h"
 
 using content::BrowserThread;
 
@@ -16,7 +25,56 @@ namespace atom {
 
 typedef net::URLRequestJobFactory::ProtocolHandler ProtocolHandler;
 
-AtomURLRequestJobFactory::AtomURLRequestJobFactory() {}
+namespace {
+
+// Serves the fixed response of a route.
+class URLRequestRouteDataJob : public net::URLRequestSimpleJob {
+ public:
+  URLRequestRouteDataJob(net::URLRequest* request,
+                         net::NetworkDelegate* network_delegate,
+                         const AtomURLRequestJobFactory::Route& route)
+      : net::URLRequestSimpleJob(request, network_delegate),
+        data_(route.data),
+        mime_type_(route.mime_type),
+        charset_(route.charset) {}
+
+  // URLRequestSimpleJob:
+  int GetRefCountedData(
+      std::string* mime_type,
+      std::string* charset,
+      scoped_refptr<base::RefCountedMemory>* data,
+      const net::CompletionCallback& callback) const override {
+    *mime_type = mime_type_;
+    *charset = charset_;
+    *data = data_;
+    return net::OK;
+  }
+
+ private:
+  ~URLRequestRouteDataJob() override {}
+
+  scoped_refptr<base::RefCountedMemory> data_;
+  std::string mime_type_;
+  std::string charset_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestRouteDataJob);
+};
+
+bool IsLongerPrefix(const AtomURLRequestJobFactory::Route& a,
+                    const AtomURLRequestJobFactory::Route& b) {
+  return a.prefix.size() > b.prefix.size();
+}
+
+}  // namespace
+
+AtomURLRequestJobFactory::Route::Route() {}
+
+AtomURLRequestJobFactory::Route::~Route() {}
+
+AtomURLRequestJobFactory::AtomURLRequestJobFactory()
+    : response_cache_(new ProtocolResponseCache),
+      base_(nullptr) {
+}
 
 AtomURLRequestJobFactory::~AtomURLRequestJobFactory() {
   STLDeleteValues(&protocol_handler_map_);
@@ -31,6 +89,8 @@ bool AtomURLRequestJobFactory::SetProtocolHandler(
 
     delete it->second;
     protocol_handler_map_.erase(it);
+    routes_map_.erase(scheme);
+    response_cache_->RemoveScheme(scheme);
     return true;
   }
 
@@ -46,6 +106,7 @@ scoped_ptr<ProtocolHandler> AtomURLRequestJobFactory::ReplaceProtocol(
     return nullptr;
   ProtocolHandler* original_protocol_handler = protocol_handler_map_[scheme];
   protocol_handler_map_[scheme] = protocol_handler.release();
+  response_cache_->RemoveScheme(scheme);
   return make_scoped_ptr(original_protocol_handler);
 }
 
@@ -64,18 +125,97 @@ bool AtomURLRequestJobFactory::HasProtocolHandler(
   return ContainsKey(protocol_handler_map_, scheme);
 }
 
+void AtomURLRequestJobFactory::SetRoutes(const std::string& scheme,
+                                         const Routes& routes) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+
+  if (routes.empty()) {
+    routes_map_.erase(scheme);
+    return;
+  }
+
+  Routes& sorted = routes_map_[scheme];
+  sorted = routes;
+  std::stable_sort(sorted.begin(), sorted.end(), IsLongerPrefix);
+}
+
 net::URLRequestJob* AtomURLRequestJobFactory::MaybeCreateJobWithProtocolHandler(
     const std::string& scheme,
     net::URLRequest* request,
     net::NetworkDelegate* network_delegate) const {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
 
+  net::URLRequestJob* route_job =
+      MaybeCreateRouteJob(scheme, request, network_delegate);
+  if (route_job) {
+    ProtocolStats::GetInstance()->RecordRequest(
+        scheme, ProtocolStats::SOURCE_ROUTE);
+    return route_job;
+  }
+
   ProtocolHandlerMap::const_iterator it = protocol_handler_map_.find(scheme);
-  if (it == protocol_handler_map_.end())
+  if (it == protocol_handler_map_.end()) {
+    if (base_)
+      return base_->MaybeCreateJobWithProtocolHandler(
+          scheme, request, network_delegate);
     return nullptr;
+  }
+
+  net::URLRequestJob* cached_job =
+      response_cache_->MaybeCreateJob(request, network_delegate);
+  if (cached_job) {
+    ProtocolStats::GetInstance()->RecordRequest(
+        scheme, ProtocolStats::SOURCE_CACHE);
+    return cached_job;
+  }
+
+  ProtocolStats::GetInstance()->RecordRequest(
+      scheme, ProtocolStats::SOURCE_HANDLER);
   return it->second->MaybeCreateJob(request, network_delegate);
 }
 
+net::URLRequestJob* AtomURLRequestJobFactory::MaybeCreateRouteJob(
+    const std::string& scheme,
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate) const {
+  auto routes = routes_map_.find(scheme);
+  if (routes == routes_map_.end() ||
+      !ContainsKey(protocol_handler_map_, scheme))
+    return nullptr;
+
+  GURL::Replacements replacements;
+  replacements.ClearQuery();
+  replacements.ClearRef();
+  std::string url = request->url().ReplaceComponents(replacements).spec();
+  for (const Route& route : routes->second) {
+    if (!base::StartsWith(url, route.prefix, base::CompareCase::SENSITIVE))
+      continue;
+
+    if (route.data.get())
+      return new URLRequestRouteDataJob(request, network_delegate, route);
+
+    // Map the rest of the URL to a file under the directory.
+    std::string relative_path = net::UnescapeURLComponent(
+        url.substr(route.prefix.size()),
+        net::UnescapeRule::SPACES | net::UnescapeRule::URL_SPECIAL_CHARS);
+    if (relative_path.empty() || relative_path.back() == '/')
+      relative_path.append("index.html");
+    base::FilePath path = base::FilePath::FromUTF8Unsafe(relative_path);
+    if (path.IsAbsolute() || path.ReferencesParent())
+      return new net::URLRequestErrorJob(
+          request, network_delegate, net::ERR_ACCESS_DENIED);
+
+    asar::URLRequestAsarJob* job =
+        new asar::URLRequestAsarJob(request, network_delegate);
+    job->Initialize(
+        BrowserThread::GetBlockingPool()->GetTaskRunnerWithShutdownBehavior(
+            base::SequencedWorkerPool::SKIP_ON_SHUTDOWN),
+        route.directory.Append(path));
+    return job;
+  }
+  return nullptr;
+}
+
 net::URLRequestJob* AtomURLRequestJobFactory::MaybeInterceptRedirect(
     net::URLRequest* request,
     net::NetworkDelegate* network_delegate,
@@ -94,6 +234,7 @@ bool AtomURLRequestJobFactory::IsHandledProtocol(
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
 
   return HasProtocolHandler(scheme) ||
+      (base_ && base_->HasProtocolHandler(scheme)) ||
       net::URLRequest::IsHandledProtocol(scheme);
 }
 
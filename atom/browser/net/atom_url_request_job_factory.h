@@ -10,6 +10,9 @@
 #include <string>
 #include <vector>
 
+#include "atom/browser/net/protocol_response_cache.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/synchronization/lock.h"
 #include "net/url_request/url_request_job_factory.h"
@@ -18,6 +21,23 @@ namespace atom {
 
 class AtomURLRequestJobFactory : public net::URLRequestJobFactory {
  public:
+  // The URLs starting with |prefix| are served on the IO thread, without
+  // asking the protocol handler of the scheme.
+  struct Route {
+    Route();
+    ~Route();
+
+    std::string prefix;
+    // Serves the files under the prefix from |directory|, which can be in an
+    // asar archive.
+    base::FilePath directory;
+    // Otherwise serves |data| for all URLs under the prefix.
+    scoped_refptr<base::RefCountedMemory> data;
+    std::string mime_type;
+    std::string charset;
+  };
+  using Routes = std::vector<Route>;
+
   AtomURLRequestJobFactory();
   virtual ~AtomURLRequestJobFactory();
 
@@ -38,6 +58,20 @@ class AtomURLRequestJobFactory : public net::URLRequestJobFactory {
   // Whether the protocol handler is registered by the job factory.
   bool HasProtocolHandler(const std::string& scheme) const;
 
+  // The responses of the protocol handlers kept for repeated requests.
+  ProtocolResponseCache* response_cache() const {
+    return response_cache_.get();
+  }
+
+  // Replaces the routes of |scheme|, which are removed together with its
+  // protocol handler.
+  void SetRoutes(const std::string& scheme, const Routes& routes);
+
+  // The schemes without a protocol handler of this job factory are served by
+  // |base|, which must outlive this job factory. Must be set before the job
+  // factory is used.
+  void set_base(const AtomURLRequestJobFactory* base) { base_ = base; }
+
   // URLRequestJobFactory implementation
   net::URLRequestJob* MaybeCreateJobWithProtocolHandler(
       const std::string& scheme,
@@ -57,8 +91,21 @@ class AtomURLRequestJobFactory : public net::URLRequestJobFactory {
  private:
   using ProtocolHandlerMap = std::map<std::string, ProtocolHandler*>;
 
+  // Returns the job of the route matching |request|, or nullptr.
+  net::URLRequestJob* MaybeCreateRouteJob(
+      const std::string& scheme,
+      net::URLRequest* request,
+      net::NetworkDelegate* network_delegate) const;
+
   ProtocolHandlerMap protocol_handler_map_;
 
+  // The routes of each scheme, longest prefix first.
+  std::map<std::string, Routes> routes_map_;
+
+  scoped_ptr<ProtocolResponseCache> response_cache_;
+
+  const AtomURLRequestJobFactory* base_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomURLRequestJobFactory);
 };
 
@@ -0,0 +1,115 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/auth_cache.h"
+
+#include "content/public/browser/resource_context.h"
+#include "content/public/browser/resource_request_info.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+namespace {
+
+const size_t kMaxEntries = 100;
+
+// The key of the AuthCache in the ResourceContext.
+const char kAuthCacheKey[] = "atom-auth-cache";
+
+// Marks the requests that were given credentials by the cache or a handler.
+const char kAnsweredKey[] = "atom-auth-answered";
+
+// Keeps a reference to the cache for the ResourceContext.
+struct AuthCacheHolder : public base::SupportsUserData::Data {
+  explicit AuthCacheHolder(scoped_refptr<AuthCache> cache) : cache(cache) {}
+  scoped_refptr<AuthCache> cache;
+};
+
+}  // namespace
+
+AuthCache::AuthCache()
+    : scope_(SCOPE_NONE),
+      entries_(kMaxEntries) {
+}
+
+AuthCache::~AuthCache() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+}
+
+// static
+void AuthCache::AttachToResourceContext(scoped_refptr<AuthCache> cache,
+                                        content::ResourceContext* context) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  context->SetUserData(kAuthCacheKey, new AuthCacheHolder(cache));
+}
+
+// static
+AuthCache* AuthCache::ForRequest(net::URLRequest* request) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  auto info = content::ResourceRequestInfo::ForRequest(request);
+  if (!info || !info->GetContext())
+    return nullptr;
+  auto holder = static_cast<AuthCacheHolder*>(
+      info->GetContext()->GetUserData(kAuthCacheKey));
+  return holder ? holder->cache.get() : nullptr;
+}
+
+bool AuthCache::Get(net::URLRequest* request,
+                    const net::AuthChallengeInfo& auth_info,
+                    net::AuthCredentials* credentials) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  if (scope_ == SCOPE_NONE)
+    return false;
+
+  auto it = entries_.Get(GetKey(auth_info));
+  if (it == entries_.end())
+    return false;
+
+  // The server asks again after it got the credentials, which means it did
+  // not accept them.
+  if (request->GetUserData(kAnsweredKey)) {
+    entries_.Erase(it);
+    return false;
+  }
+
+  *credentials = it->second;
+  request->SetUserData(kAnsweredKey, new base::SupportsUserData::Data);
+  return true;
+}
+
+void AuthCache::Put(net::URLRequest* request,
+                    const net::AuthChallengeInfo& auth_info,
+                    const net::AuthCredentials& credentials) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  if (scope_ == SCOPE_NONE)
+    return;
+
+  entries_.Put(GetKey(auth_info), credentials);
+  request->SetUserData(kAnsweredKey, new base::SupportsUserData::Data);
+}
+
+void AuthCache::SetScope(Scope scope) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  if (scope == scope_)
+    return;
+  scope_ = scope;
+  Clear();
+}
+
+void AuthCache::Clear() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  entries_.Clear();
+}
+
+std::string AuthCache::GetKey(const net::AuthChallengeInfo& auth_info) const {
+  // The proxy and the server can ask for different credentials on the same
+  // host.
+  std::string key = auth_info.is_proxy ? "proxy " : "server ";
+  key += auth_info.challenger.ToString();
+  if (scope_ == SCOPE_REALM)
+    key += " " + auth_info.scheme + " " + auth_info.realm;
+  return key;
+}
+
+}  // namespace atom
@@ -0,0 +1,86 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_AUTH_CACHE_H_
+#define ATOM_BROWSER_NET_AUTH_CACHE_H_
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/memory/ref_counted.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/auth.h"
+
+namespace content {
+class ResourceContext;
+}
+
+namespace net {
+class URLRequest;
+}
+
+namespace atom {
+
+// Remembers the credentials given to the auth challenges of a session, so the
+// challenges that come again are answered on the IO thread instead of asking
+// the "login" handlers each time. Nothing is remembered until a scope is set.
+//
+// Created on any thread, but only used and deleted on the IO thread.
+class AuthCache
+    : public base::RefCountedThreadSafe<
+          AuthCache, content::BrowserThread::DeleteOnIOThread> {
+ public:
+  enum Scope {
+    SCOPE_NONE,
+    // The credentials are reused for the same scheme and realm of a server.
+    SCOPE_REALM,
+    // The credentials are reused for all the realms of a server.
+    SCOPE_HOST,
+  };
+
+  AuthCache();
+
+  // Makes the cache the one ForRequest returns for the requests of
+  // |resource_context|.
+  static void AttachToResourceContext(scoped_refptr<AuthCache> cache,
+                                      content::ResourceContext* context);
+
+  // Returns the cache of the session that started |request|, or null.
+  static AuthCache* ForRequest(net::URLRequest* request);
+
+  // Returns false when there are no credentials for |auth_info|. Credentials
+  // that were already given to |request| are rejected ones, so they are
+  // forgotten instead of being given again.
+  bool Get(net::URLRequest* request,
+           const net::AuthChallengeInfo& auth_info,
+           net::AuthCredentials* credentials);
+
+  // Records that |credentials| were given to |request| for |auth_info|.
+  void Put(net::URLRequest* request,
+           const net::AuthChallengeInfo& auth_info,
+           const net::AuthCredentials& credentials);
+
+  // Changing the scope forgets the credentials.
+  void SetScope(Scope scope);
+
+  void Clear();
+
+ private:
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::IO>;
+  friend class base::DeleteHelper<AuthCache>;
+
+  ~AuthCache();
+
+  std::string GetKey(const net::AuthChallengeInfo& auth_info) const;
+
+  Scope scope_;
+  base::MRUCache<std::string, net::AuthCredentials> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(AuthCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_AUTH_CACHE_H_
@@ -0,0 +1,48 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/byte_range_headers.h"
+
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+
+namespace atom {
+
+net::HttpResponseHeaders* CreateResponseHeaders(
+    net::HttpStatusCode status_code,
+    const std::vector<net::HttpByteRange>& ranges,
+    int64 size) {
+  // URLRequestSimpleJob only sends a single range.
+  net::HttpByteRange range;
+  bool partial = status_code == net::HTTP_OK && ranges.size() == 1;
+  if (partial) {
+    range = ranges.front();
+    partial = range.ComputeBounds(size);
+  }
+  if (partial)
+    status_code = net::HTTP_PARTIAL_CONTENT;
+
+  std::string status("HTTP/1.1 ");
+  status.append(base::IntToString(status_code));
+  status.append(" ");
+  status.append(net::GetHttpReasonPhrase(status_code));
+  status.append("\0\0", 2);
+  net::HttpResponseHeaders* headers = new net::HttpResponseHeaders(status);
+
+  if (status_code == net::HTTP_OK || partial)
+    headers->AddHeader("Accept-Ranges: bytes");
+  if (partial) {
+    headers->AddHeader(base::StringPrintf(
+        "Content-Range: bytes %" PRId64 "-%" PRId64 "/%" PRId64,
+        range.first_byte_position(), range.last_byte_position(), size));
+    headers->AddHeader(base::StringPrintf(
+        "Content-Length: %" PRId64,
+        range.last_byte_position() - range.first_byte_position() + 1));
+  }
+  return headers;
+}
+
+}  // namespace atom
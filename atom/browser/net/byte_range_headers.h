@@ -0,0 +1,26 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_BYTE_RANGE_HEADERS_H_
+#define ATOM_BROWSER_NET_BYTE_RANGE_HEADERS_H_
+
+#include <vector>
+
+#include "net/http/http_byte_range.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
+
+namespace atom {
+
+// Creates the headers of a response with |size| bytes of body. When the
+// request asked for one range of a successful response, the response becomes
+// a "206 Partial Content" of that range.
+net::HttpResponseHeaders* CreateResponseHeaders(
+    net::HttpStatusCode status_code,
+    const std::vector<net::HttpByteRange>& ranges,
+    int64 size);
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_BYTE_RANGE_HEADERS_H_
@@ -0,0 +1,159 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/http_cache_backend.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/disk_cache.h"
+
+namespace atom {
+
+namespace {
+
+// Forwards everything to |backend_| and counts whether the opened entries
+// exist.
+class CountingBackend : public disk_cache::Backend {
+ public:
+  CountingBackend(scoped_ptr<disk_cache::Backend> backend,
+                  HttpCacheStats* stats)
+      : backend_(backend.Pass()), stats_(stats) {}
+
+  // disk_cache::Backend:
+  net::CacheType GetCacheType() const override {
+    return backend_->GetCacheType();
+  }
+  int32 GetEntryCount() const override {
+    return backend_->GetEntryCount();
+  }
+  int OpenEntry(const std::string& key,
+                disk_cache::Entry** entry,
+                const net::CompletionCallback& callback) override {
+    int rv = backend_->OpenEntry(
+        key, entry, base::Bind(&CountingBackend::OnOpenEntry, stats_,
+                               callback));
+    if (rv != net::ERR_IO_PENDING)
+      stats_->RecordOpen(rv == net::OK);
+    return rv;
+  }
+  int CreateEntry(const std::string& key,
+                  disk_cache::Entry** entry,
+                  const net::CompletionCallback& callback) override {
+    return backend_->CreateEntry(key, entry, callback);
+  }
+  int DoomEntry(const std::string& key,
+                const net::CompletionCallback& callback) override {
+    return backend_->DoomEntry(key, callback);
+  }
+  int DoomAllEntries(const net::CompletionCallback& callback) override {
+    return backend_->DoomAllEntries(callback);
+  }
+  int DoomEntriesBetween(base::Time initial_time,
+                         base::Time end_time,
+                         const net::CompletionCallback& callback) override {
+    return backend_->DoomEntriesBetween(initial_time, end_time, callback);
+  }
+  int DoomEntriesSince(base::Time initial_time,
+                       const net::CompletionCallback& callback) override {
+    return backend_->DoomEntriesSince(initial_time, callback);
+  }
+  scoped_ptr<Iterator> CreateIterator() override {
+    return backend_->CreateIterator();
+  }
+  void GetStats(
+      std::vector<std::pair<std::string, std::string>>* stats) override {
+    backend_->GetStats(stats);
+  }
+  void OnExternalCacheHit(const std::string& key) override {
+    backend_->OnExternalCacheHit(key);
+  }
+
+ private:
+  static void OnOpenEntry(scoped_refptr<HttpCacheStats> stats,
+                          const net::CompletionCallback& callback,
+                          int rv) {
+    stats->RecordOpen(rv == net::OK);
+    callback.Run(rv);
+  }
+
+  scoped_ptr<disk_cache::Backend> backend_;
+  scoped_refptr<HttpCacheStats> stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingBackend);
+};
+
+void WrapBackend(scoped_ptr<disk_cache::Backend>* created,
+                 scoped_ptr<disk_cache::Backend>* backend,
+                 HttpCacheStats* stats,
+                 int rv) {
+  if (rv == net::OK && *created)
+    backend->reset(new CountingBackend(created->Pass(), stats));
+}
+
+void OnBackendCreated(scoped_ptr<disk_cache::Backend>* created,
+                      scoped_ptr<disk_cache::Backend>* backend,
+                      scoped_refptr<HttpCacheStats> stats,
+                      const net::CompletionCallback& callback,
+                      int rv) {
+  WrapBackend(created, backend, stats.get(), rv);
+  callback.Run(rv);
+}
+
+}  // namespace
+
+HttpCacheStats::HttpCacheStats() : hits_(0), misses_(0) {
+}
+
+HttpCacheStats::~HttpCacheStats() {
+}
+
+void HttpCacheStats::RecordOpen(bool hit) {
+  base::AutoLock auto_lock(lock_);
+  if (hit)
+    ++hits_;
+  else
+    ++misses_;
+}
+
+void HttpCacheStats::Get(int64* hits, int64* misses) const {
+  base::AutoLock auto_lock(lock_);
+  *hits = hits_;
+  *misses = misses_;
+}
+
+void HttpCacheStats::Reset() {
+  base::AutoLock auto_lock(lock_);
+  hits_ = 0;
+  misses_ = 0;
+}
+
+CountingBackendFactory::CountingBackendFactory(
+    net::HttpCache::BackendFactory* factory, HttpCacheStats* stats)
+    : factory_(factory), stats_(stats) {
+}
+
+CountingBackendFactory::~CountingBackendFactory() {
+}
+
+int CountingBackendFactory::CreateBackend(
+    net::NetLog* net_log,
+    scoped_ptr<disk_cache::Backend>* backend,
+    const net::CompletionCallback& callback) {
+  // The backend is created into |created| and only handed to the cache once
+  // it is wrapped, the callback keeps it alive until then.
+  scoped_ptr<disk_cache::Backend>* created =
+      new scoped_ptr<disk_cache::Backend>;
+  net::CompletionCallback on_created = base::Bind(
+      &OnBackendCreated, base::Owned(created), backend, stats_, callback);
+  int rv = factory_->CreateBackend(net_log, created, on_created);
+  if (rv != net::ERR_IO_PENDING)
+    WrapBackend(created, backend, stats_.get(), rv);
+  return rv;
+}
+
+}  // namespace atom
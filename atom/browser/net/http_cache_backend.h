@@ -0,0 +1,59 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_HTTP_CACHE_BACKEND_H_
+#define ATOM_BROWSER_NET_HTTP_CACHE_BACKEND_H_
+
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "net/http/http_cache.h"
+
+namespace atom {
+
+// How often the HTTP cache found the entries of the requests. The backend
+// records on the IO thread and the counters are read on the UI thread.
+class HttpCacheStats : public base::RefCountedThreadSafe<HttpCacheStats> {
+ public:
+  HttpCacheStats();
+
+  void RecordOpen(bool hit);
+
+  void Get(int64* hits, int64* misses) const;
+  void Reset();
+
+ private:
+  friend class base::RefCountedThreadSafe<HttpCacheStats>;
+
+  ~HttpCacheStats();
+
+  mutable base::Lock lock_;
+  int64 hits_;
+  int64 misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpCacheStats);
+};
+
+// Creates the backend of |factory| and records the entries it opens in
+// |stats|.
+class CountingBackendFactory : public net::HttpCache::BackendFactory {
+ public:
+  CountingBackendFactory(net::HttpCache::BackendFactory* factory,
+                         HttpCacheStats* stats);
+  ~CountingBackendFactory() override;
+
+  // net::HttpCache::BackendFactory:
+  int CreateBackend(net::NetLog* net_log,
+                    scoped_ptr<disk_cache::Backend>* backend,
+                    const net::CompletionCallback& callback) override;
+
+ private:
+  scoped_ptr<net::HttpCache::BackendFactory> factory_;
+  scoped_refptr<HttpCacheStats> stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingBackendFactory);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_HTTP_CACHE_BACKEND_H_
@@ -4,12 +4,87 @@
 
 #include "atom/browser/net/http_protocol_handler.h"
 
+#include <string>
+
+#include "atom/browser/net/network_emulation_rules.h"
+#include "base/memory/weak_ptr.h"
+#include "base/rand_util.h"
+#include "base/thread_task_runner_handle.h"
+#include "brightray/browser/net/devtools_network_transaction.h"
+#include "net/base/net_errors.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_context.h"
 #include "net/url_request/url_request_http_job.h"
+#include "net/url_request/url_request_status.h"
 
 namespace atom {
 
-HttpProtocolHandler::HttpProtocolHandler(const std::string& scheme)
-    : scheme_(scheme) {
+namespace {
+
+// Applies the packet loss and jitter of an emulation rule, which the
+// DevToolsNetworkController does not know about.
+class EmulatedHttpJob : public net::URLRequestHttpJob {
+ public:
+  EmulatedHttpJob(net::URLRequest* request,
+                  net::NetworkDelegate* network_delegate,
+                  base::TimeDelta delay,
+                  bool dropped)
+      : net::URLRequestHttpJob(
+            request, network_delegate,
+            request->context()->http_user_agent_settings()),
+        delay_(delay),
+        dropped_(dropped),
+        weak_factory_(this) {
+  }
+
+  // net::URLRequestJob:
+  void Start() override {
+    if (dropped_) {
+      base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+          FROM_HERE,
+          base::Bind(&EmulatedHttpJob::Drop, weak_factory_.GetWeakPtr()),
+          delay_);
+    } else if (delay_ > base::TimeDelta()) {
+      base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+          FROM_HERE,
+          base::Bind(&EmulatedHttpJob::StartNow, weak_factory_.GetWeakPtr()),
+          delay_);
+    } else {
+      net::URLRequestHttpJob::Start();
+    }
+  }
+
+  void Kill() override {
+    weak_factory_.InvalidateWeakPtrs();
+    net::URLRequestHttpJob::Kill();
+  }
+
+ private:
+  ~EmulatedHttpJob() override {}
+
+  void StartNow() {
+    net::URLRequestHttpJob::Start();
+  }
+
+  void Drop() {
+    NotifyStartError(net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                                           net::ERR_CONNECTION_RESET));
+  }
+
+  base::TimeDelta delay_;
+  bool dropped_;
+
+  base::WeakPtrFactory<EmulatedHttpJob> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(EmulatedHttpJob);
+};
+
+}  // namespace
+
+HttpProtocolHandler::HttpProtocolHandler(
+    const std::string& scheme, NetworkEmulationRules* emulation_rules)
+    : scheme_(scheme),
+      emulation_rules_(emulation_rules) {
 }
 
 HttpProtocolHandler::~HttpProtocolHandler() {
@@ -18,9 +93,32 @@ HttpProtocolHandler::~HttpProtocolHandler() {
 net::URLRequestJob* HttpProtocolHandler::MaybeCreateJob(
     net::URLRequest* request,
     net::NetworkDelegate* network_delegate) const {
-  return net::URLRequestHttpJob::Factory(request,
-                                         network_delegate,
-                                         scheme_);
+  std::string client_id;
+  NetworkEmulationRules::Rule rule;
+  GURL hsts_redirect;
+  // The HSTS redirects are left to the factory, the redirected request is
+  // matched again.
+  if (!emulation_rules_->Match(request, &client_id, &rule) ||
+      !request->context()->http_transaction_factory() ||
+      request->GetHSTSRedirect(&hsts_redirect))
+    return net::URLRequestHttpJob::Factory(request,
+                                           network_delegate,
+                                           scheme_);
+
+  // Let the DevToolsNetworkController throttle the request with the
+  // conditions of the rule.
+  if (!client_id.empty())
+    request->SetExtraRequestHeaderByName(
+        brightray::DevToolsNetworkTransaction::
+            kDevToolsEmulateNetworkConditionsClientId,
+        client_id,
+        true);
+
+  bool dropped = base::RandDouble() < rule.packet_loss;
+  emulation_rules_->RecordRequest(dropped);
+  base::TimeDelta delay = base::TimeDelta::FromMicroseconds(
+      rule.jitter.InMicroseconds() * base::RandDouble());
+  return new EmulatedHttpJob(request, network_delegate, delay, dropped);
 }
 
 }  // namespace atom
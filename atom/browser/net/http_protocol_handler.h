@@ -7,13 +7,17 @@
 
 #include <string>
 
+#include "base/memory/ref_counted.h"
 #include "net/url_request/url_request_job_factory.h"
 
 namespace atom {
 
+class NetworkEmulationRules;
+
 class HttpProtocolHandler : public net::URLRequestJobFactory::ProtocolHandler {
  public:
-  explicit HttpProtocolHandler(const std::string&);
+  HttpProtocolHandler(const std::string& scheme,
+                      NetworkEmulationRules* emulation_rules);
   virtual ~HttpProtocolHandler();
 
   // net::URLRequestJobFactory::ProtocolHandler:
@@ -23,6 +27,7 @@ class HttpProtocolHandler : public net::URLRequestJobFactory::ProtocolHandler {
 
  private:
   std::string scheme_;
+  scoped_refptr<NetworkEmulationRules> emulation_rules_;
 };
 
 }  // namespace atom
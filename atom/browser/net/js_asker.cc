@@ -8,6 +8,8 @@
 
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/v8_value_converter.h"
+#include "atom/common/node_includes.h"
+#include "native_mate/dictionary.h"
 
 namespace atom {
 
@@ -15,24 +17,87 @@ namespace internal {
 
 namespace {
 
+// Makes the memory of a Buffer readable on the IO thread, the Buffer is kept
+// alive until the memory is released, which can happen on any thread.
+class BufferMemory : public base::RefCountedMemory {
+ public:
+  BufferMemory(v8::Isolate* isolate, v8::Local<v8::Value> buffer)
+      : buffer_(new v8::Global<v8::Value>(isolate, buffer)),
+        data_(reinterpret_cast<unsigned char*>(node::Buffer::Data(buffer))),
+        size_(node::Buffer::Length(buffer)) {}
+
+  // base::RefCountedMemory:
+  const unsigned char* front() const override { return data_; }
+  size_t size() const override { return size_; }
+
+ private:
+  ~BufferMemory() override {
+    // The handle can only be released on the thread the JavaScript runs on.
+    content::BrowserThread::DeleteSoon(
+        content::BrowserThread::UI, FROM_HERE, buffer_.release());
+  }
+
+  scoped_ptr<v8::Global<v8::Value>> buffer_;
+  unsigned char* data_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferMemory);
+};
+
+// Takes the Buffer out of |value|, which is either the Buffer or an object
+// with the Buffer in its |data| property.
+scoped_refptr<base::RefCountedMemory> TakeBuffer(
+    v8::Isolate* isolate, v8::Local<v8::Value>* value) {
+  if (node::Buffer::HasInstance(*value)) {
+    scoped_refptr<base::RefCountedMemory> buffer(
+        new BufferMemory(isolate, *value));
+    *value = v8::Object::New(isolate);
+    return buffer;
+  }
+
+  v8::Local<v8::Value> data;
+  mate::Dictionary dict;
+  if (!mate::ConvertFromV8(isolate, *value, &dict) ||
+      !dict.Get("data", &data) || !node::Buffer::HasInstance(data))
+    return nullptr;
+
+  // Convert the other properties without copying the Buffer.
+  v8::Local<v8::Object> options = dict.GetHandle()->Clone();
+  options->Delete(mate::StringToV8(isolate, "data"));
+  *value = options;
+  return new BufferMemory(isolate, data);
+}
+
 // The callback which is passed to |handler|.
-void HandlerCallback(const ResponseCallback& callback, mate::Arguments* args) {
+void HandlerCallback(const ResponseCallback& callback,
+                     const std::string& scheme,
+                     base::TimeDelta queue_time,
+                     base::TimeTicks handler_start_time,
+                     bool reference_buffer,
+                     mate::Arguments* args) {
+  ProtocolStats::GetInstance()->RecordHandler(
+      scheme, queue_time, base::TimeTicks::Now() - handler_start_time);
+
   // If there is no argument passed then we failed.
   v8::Local<v8::Value> value;
   if (!args->GetNext(&value)) {
     content::BrowserThread::PostTask(
         content::BrowserThread::IO, FROM_HERE,
-        base::Bind(callback, false, nullptr));
+        base::Bind(callback, false, nullptr, nullptr));
     return;
   }
 
+  scoped_refptr<base::RefCountedMemory> buffer;
+  if (reference_buffer)
+    buffer = TakeBuffer(args->isolate(), &value);
+
   // Pass whatever user passed to the actaul request job.
   V8ValueConverter converter;
   v8::Local<v8::Context> context = args->isolate()->GetCurrentContext();
   scoped_ptr<base::Value> options(converter.FromV8Value(value, context));
   content::BrowserThread::PostTask(
       content::BrowserThread::IO, FROM_HERE,
-      base::Bind(callback, true, base::Passed(&options)));
+      base::Bind(callback, true, base::Passed(&options), buffer));
 }
 
 }  // namespace
@@ -40,15 +105,22 @@ void HandlerCallback(const ResponseCallback& callback, mate::Arguments* args) {
 void AskForOptions(v8::Isolate* isolate,
                    const JavaScriptHandler& handler,
                    net::URLRequest* request,
+                   const std::string& scheme,
+                   base::TimeTicks start_time,
+                   bool reference_buffer,
                    const ResponseCallback& callback) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  TRACE_EVENT1("electron.protocol", "AskForOptions", "scheme", scheme);
+  base::TimeTicks now = base::TimeTicks::Now();
   v8::Locker locker(isolate);
   v8::HandleScope handle_scope(isolate);
   v8::Local<v8::Context> context = isolate->GetCurrentContext();
   v8::Context::Scope context_scope(context);
   handler.Run(request,
               mate::ConvertToV8(isolate,
-                                base::Bind(&HandlerCallback, callback)));
+                                base::Bind(&HandlerCallback, callback,
+                                           scheme, now - start_time, now,
+                                           reference_buffer)));
 }
 
 bool IsErrorOptions(base::Value* value, int* error) {
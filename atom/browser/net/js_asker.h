@@ -5,9 +5,14 @@
 #ifndef ATOM_BROWSER_NET_JS_ASKER_H_
 #define ATOM_BROWSER_NET_JS_ASKER_H_
 
+#include "atom/browser/net/protocol_response_cache.h"
+#include "atom/browser/net/protocol_stats.h"
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/net_errors.h"
@@ -24,12 +29,20 @@ using JavaScriptHandler =
 namespace internal {
 
 using ResponseCallback =
-    base::Callback<void(bool, scoped_ptr<base::Value> options)>;
-
-// Ask handler for options in UI thread.
+    base::Callback<void(bool,
+                        scoped_ptr<base::Value> options,
+                        scoped_refptr<base::RefCountedMemory> buffer)>;
+
+// Ask handler for options in UI thread. When |reference_buffer| is true the
+// Buffer of the response, or of its |data| property, is passed by reference
+// as |buffer| instead of being copied into |options|. The time since
+// |start_time| and the time the handler takes are recorded for |scheme|.
 void AskForOptions(v8::Isolate* isolate,
                    const JavaScriptHandler& handler,
                    net::URLRequest* request,
+                   const std::string& scheme,
+                   base::TimeTicks start_time,
+                   bool reference_buffer,
                    const ResponseCallback& callback);
 
 // Test whether the |options| means an error.
@@ -41,15 +54,19 @@ template<typename RequestJob>
 class JsAsker : public RequestJob {
  public:
   JsAsker(net::URLRequest* request, net::NetworkDelegate* network_delegate)
-      : RequestJob(request, network_delegate), weak_factory_(this) {}
+      : RequestJob(request, network_delegate),
+        reference_buffer_(false),
+        weak_factory_(this) {}
 
   // Called by |CustomProtocolHandler| to store handler related information.
   void SetHandlerInfo(
       v8::Isolate* isolate,
       net::URLRequestContextGetter* request_context_getter,
+      ProtocolResponseCache* response_cache,
       const JavaScriptHandler& handler) {
     isolate_ = isolate;
     request_context_getter_ = request_context_getter;
+    response_cache_ = response_cache;
     handler_ = handler;
   }
 
@@ -60,27 +77,54 @@ class JsAsker : public RequestJob {
     return request_context_getter_;
   }
 
+  // Subclass should store the responses that have cache metadata here.
+  ProtocolResponseCache* response_cache() const { return response_cache_; }
+
+ protected:
+  // Receive the Buffer of the response in buffer() instead of |options|.
+  void set_reference_buffer(bool reference_buffer) {
+    reference_buffer_ = reference_buffer;
+  }
+
+  // The memory of the Buffer of the response, it keeps the Buffer alive.
+  scoped_refptr<base::RefCountedMemory> buffer() const { return buffer_; }
+
  private:
   // RequestJob:
   void Start() override {
+    TRACE_EVENT_ASYNC_BEGIN1("electron.protocol", "JsAsker", this,
+                             "url", RequestJob::request()->url().spec());
     content::BrowserThread::PostTask(
         content::BrowserThread::UI, FROM_HERE,
         base::Bind(&internal::AskForOptions,
                    isolate_,
                    handler_,
                    RequestJob::request(),
+                   RequestJob::request()->url().scheme(),
+                   base::TimeTicks::Now(),
+                   reference_buffer_,
                    base::Bind(&JsAsker::OnResponse,
                               weak_factory_.GetWeakPtr())));
   }
   void GetResponseInfo(net::HttpResponseInfo* info) override {
     info->headers = new net::HttpResponseHeaders("");
   }
+  void DoneReading() override {
+    RequestJob::DoneReading();
+    ProtocolStats::GetInstance()->RecordResponse(
+        RequestJob::request(), RequestJob::prefilter_bytes_read());
+  }
 
   // Called when the JS handler has sent the response, we need to decide whether
   // to start, or fail the job.
-  void OnResponse(bool success, scoped_ptr<base::Value> value) {
+  void OnResponse(bool success,
+                  scoped_ptr<base::Value> value,
+                  scoped_refptr<base::RefCountedMemory> buffer) {
+    TRACE_EVENT_ASYNC_END1("electron.protocol", "JsAsker", this,
+                           "success", success);
     int error = net::ERR_NOT_IMPLEMENTED;
     if (success && value && !internal::IsErrorOptions(value.get(), &error)) {
+      buffer_ = buffer;
       StartAsync(value.Pass());
     } else {
       RequestJob::NotifyStartError(
@@ -90,8 +134,12 @@ class JsAsker : public RequestJob {
 
   v8::Isolate* isolate_;
   net::URLRequestContextGetter* request_context_getter_;
+  ProtocolResponseCache* response_cache_;
   JavaScriptHandler handler_;
 
+  bool reference_buffer_;
+  scoped_refptr<base::RefCountedMemory> buffer_;
+
   base::WeakPtrFactory<JsAsker> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(JsAsker);
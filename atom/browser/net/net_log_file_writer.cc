@@ -0,0 +1,164 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/net_log_file_writer.h"
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/values.h"
+#include "net/log/net_log_util.h"
+#include "net/url_request/url_request_context.h"
+#include "net/url_request/url_request_context_getter.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+const char kEventsHeader[] = ",\n\"events\": [\n";
+const char kEventSeparator[] = ",\n";
+const char kFooter[] = "\n]}\n";
+
+}  // namespace
+
+NetLogFileWriter::NetLogFileWriter(const base::FilePath& path,
+                                   net::NetLogCaptureMode capture_mode,
+                                   int64 max_file_size)
+    : path_(path),
+      capture_mode_(capture_mode),
+      max_file_size_(max_file_size),
+      write_scheduled_(false),
+      file_size_(0),
+      has_events_(false) {
+  scoped_ptr<base::DictionaryValue> constants(net::GetNetConstants());
+  base::JSONWriter::Write(*constants, &constants_);
+  constants_ = "{\"constants\": " + constants_ + kEventsHeader;
+}
+
+NetLogFileWriter::~NetLogFileWriter() {
+  if (file_.IsValid())
+    BrowserThread::DeleteSoon(BrowserThread::FILE, FROM_HERE,
+                              new base::File(file_.Pass()));
+}
+
+void NetLogFileWriter::Start(
+    net::URLRequestContextGetter* request_context_getter) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  // The FILE thread runs the tasks in order, so the file is open before the
+  // first events are written.
+  BrowserThread::PostTask(BrowserThread::FILE, FROM_HERE,
+      base::Bind(&NetLogFileWriter::OpenFile, this));
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&NetLogFileWriter::StartObserving, this,
+                 make_scoped_refptr(request_context_getter)));
+}
+
+void NetLogFileWriter::Stop(const base::Closure& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  BrowserThread::PostTaskAndReply(BrowserThread::IO, FROM_HERE,
+      base::Bind(&NetLogFileWriter::StopObserving, this),
+      base::Bind(&NetLogFileWriter::OnStoppedObserving, this, callback));
+}
+
+void NetLogFileWriter::OnAddEntry(const net::NetLog::Entry& entry) {
+  scoped_ptr<base::Value> value(entry.ToValue());
+  std::string json;
+  base::JSONWriter::Write(*value, &json);
+
+  // Events come in much faster than they can be written one task each, so
+  // they are queued and written together by one task.
+  base::AutoLock auto_lock(lock_);
+  pending_.push_back(json);
+  if (write_scheduled_)
+    return;
+  write_scheduled_ = true;
+  BrowserThread::PostTask(BrowserThread::FILE, FROM_HERE,
+      base::Bind(&NetLogFileWriter::WriteEntries, this));
+}
+
+void NetLogFileWriter::StartObserving(
+    scoped_refptr<net::URLRequestContextGetter> request_context_getter) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  net::NetLog* net_log =
+      request_context_getter->GetURLRequestContext()->net_log();
+  if (net_log)
+    net_log->DeprecatedAddObserver(this, capture_mode_);
+}
+
+void NetLogFileWriter::StopObserving() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  // No event is added after this returns, the pending ones are written by
+  // CloseFile.
+  if (net_log())
+    net_log()->DeprecatedRemoveObserver(this);
+}
+
+void NetLogFileWriter::OnStoppedObserving(const base::Closure& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  BrowserThread::PostTaskAndReply(BrowserThread::FILE, FROM_HERE,
+      base::Bind(&NetLogFileWriter::CloseFile, this),
+      callback);
+}
+
+void NetLogFileWriter::OpenFile() {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  file_.Initialize(path_, base::File::FLAG_CREATE_ALWAYS |
+                          base::File::FLAG_WRITE);
+  if (!file_.IsValid()) {
+    LOG(ERROR) << "Unable to write the net log to " << path_.value();
+    return;
+  }
+  file_size_ = file_.WriteAtCurrentPos(constants_.data(), constants_.size());
+  has_events_ = false;
+}
+
+void NetLogFileWriter::WriteEntries() {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  std::vector<std::string> entries;
+  {
+    base::AutoLock auto_lock(lock_);
+    entries.swap(pending_);
+    write_scheduled_ = false;
+  }
+
+  if (!file_.IsValid())
+    return;
+
+  for (const std::string& entry : entries) {
+    if (has_events_ && max_file_size_ > 0 &&
+        file_size_ + static_cast<int64>(entry.size()) > max_file_size_)
+      Rotate();
+    if (!file_.IsValid())
+      return;
+
+    if (has_events_)
+      file_size_ += file_.WriteAtCurrentPos(kEventSeparator,
+                                            arraysize(kEventSeparator) - 1);
+    file_size_ += file_.WriteAtCurrentPos(entry.data(), entry.size());
+    has_events_ = true;
+  }
+}
+
+void NetLogFileWriter::CloseFile() {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  WriteEntries();
+  if (!file_.IsValid())
+    return;
+
+  file_.WriteAtCurrentPos(kFooter, arraysize(kFooter) - 1);
+  file_.Close();
+}
+
+void NetLogFileWriter::Rotate() {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  file_.WriteAtCurrentPos(kFooter, arraysize(kFooter) - 1);
+  file_.Close();
+  base::ReplaceFile(path_, path_.AddExtension(FILE_PATH_LITERAL("1")),
+                    nullptr);
+  OpenFile();
+}
+
+}  // namespace atom
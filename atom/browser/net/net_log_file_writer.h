@@ -0,0 +1,94 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_NET_LOG_FILE_WRITER_H_
+#define ATOM_BROWSER_NET_NET_LOG_FILE_WRITER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/log/net_log.h"
+
+namespace net {
+class URLRequestContextGetter;
+}
+
+namespace atom {
+
+// Streams the events of a NetLog into |path| while it is observing, in the
+// format of chrome://net-internals.
+//
+// When the file grows past |max_file_size| it is moved to |path| with a ".1"
+// suffix, replacing the one moved before, and a new file is started. Every
+// file starts with the constants, so each of them can be loaded alone.
+//
+// Start and Stop are called on the UI thread, the events are serialized on
+// the thread that adds them and written on the FILE thread.
+class NetLogFileWriter
+    : public base::RefCountedThreadSafe<NetLogFileWriter>,
+      public net::NetLog::ThreadSafeObserver {
+ public:
+  NetLogFileWriter(const base::FilePath& path,
+                   net::NetLogCaptureMode capture_mode,
+                   int64 max_file_size);
+
+  // Observes the NetLog of |request_context_getter|.
+  void Start(net::URLRequestContextGetter* request_context_getter);
+
+  // Stops observing and calls |callback| once the file is complete.
+  void Stop(const base::Closure& callback);
+
+  const base::FilePath& path() const { return path_; }
+
+  // net::NetLog::ThreadSafeObserver:
+  void OnAddEntry(const net::NetLog::Entry& entry) override;
+
+ private:
+  friend class base::RefCountedThreadSafe<NetLogFileWriter>;
+
+  ~NetLogFileWriter() override;
+
+  // IO thread:
+  void StartObserving(
+      scoped_refptr<net::URLRequestContextGetter> request_context_getter);
+  void StopObserving();
+
+  // UI thread:
+  void OnStoppedObserving(const base::Closure& callback);
+
+  // FILE thread:
+  void OpenFile();
+  void WriteEntries();
+  void CloseFile();
+  void Rotate();
+
+  base::FilePath path_;
+  net::NetLogCaptureMode capture_mode_;
+  int64 max_file_size_;
+
+  // The constants written at the start of every file.
+  std::string constants_;
+
+  // The serialized events waiting for the FILE thread.
+  base::Lock lock_;
+  std::vector<std::string> pending_;
+  bool write_scheduled_;
+
+  // Only accessed on the FILE thread.
+  base::File file_;
+  int64 file_size_;
+  bool has_events_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetLogFileWriter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_NET_LOG_FILE_WRITER_H_
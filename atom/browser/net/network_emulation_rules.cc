@@ -0,0 +1,148 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/network_emulation_rules.h"
+
+#include "base/strings/string_util.h"
+#include "content/public/browser/resource_request_info.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+namespace {
+
+bool MatchesHost(const std::vector<std::string>& hosts,
+                 const std::string& host) {
+  for (const auto& pattern : hosts) {
+    if (pattern == host)
+      return true;
+    if (StartsWithASCII(pattern, ".", true) &&
+        (EndsWith(host, pattern, false) || host == pattern.substr(1)))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+NetworkEmulationRules::Rule::Rule() : packet_loss(0) {
+}
+
+NetworkEmulationRules::Rule::~Rule() {
+}
+
+NetworkEmulationRules::Entry::Entry() : pinned(false) {
+}
+
+NetworkEmulationRules::Entry::~Entry() {
+}
+
+NetworkEmulationRules::NetworkEmulationRules() : throttled_(0), dropped_(0) {
+}
+
+NetworkEmulationRules::~NetworkEmulationRules() {
+}
+
+void NetworkEmulationRules::SetRule(const std::string& client_id,
+                                    const Rule& rule,
+                                    bool pinned) {
+  base::AutoLock auto_lock(lock_);
+  Entry& entry = entries_[client_id];
+  entry.rule = rule;
+  entry.pinned = pinned;
+}
+
+std::vector<std::string> NetworkEmulationRules::RemoveUnpinnedRules() {
+  base::AutoLock auto_lock(lock_);
+  std::vector<std::string> removed;
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (!it->second.pinned) {
+      removed.push_back(it->first);
+      entries_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  return removed;
+}
+
+void NetworkEmulationRules::RemoveRule(const std::string& client_id) {
+  base::AutoLock auto_lock(lock_);
+  entries_.erase(client_id);
+}
+
+void NetworkEmulationRules::AddRenderView(const std::string& client_id,
+                                          int render_process_id,
+                                          int render_view_id) {
+  base::AutoLock auto_lock(lock_);
+  auto it = entries_.find(client_id);
+  if (it != entries_.end())
+    it->second.render_views.insert(
+        RenderViewId(render_process_id, render_view_id));
+}
+
+void NetworkEmulationRules::RemoveRenderView(const std::string& client_id,
+                                             int render_process_id,
+                                             int render_view_id) {
+  base::AutoLock auto_lock(lock_);
+  auto it = entries_.find(client_id);
+  if (it != entries_.end())
+    it->second.render_views.erase(
+        RenderViewId(render_process_id, render_view_id));
+}
+
+bool NetworkEmulationRules::Match(const net::URLRequest* request,
+                                  std::string* client_id,
+                                  Rule* rule) const {
+  base::AutoLock auto_lock(lock_);
+  if (entries_.empty())
+    return false;
+
+  RenderViewId render_view(-1, -1);
+  auto info = content::ResourceRequestInfo::ForRequest(request);
+  if (info)
+    render_view = RenderViewId(info->GetChildID(), info->GetRouteID());
+  const std::string& host = request->url().host();
+
+  // The lower the score the more specific the rule.
+  int best_score = 4;
+  for (const auto& it : entries_) {
+    const Entry& entry = it.second;
+    bool pinned = entry.pinned;
+    if (pinned && !entry.render_views.count(render_view))
+      continue;
+    bool all_hosts = entry.rule.hosts.empty();
+    if (!all_hosts && !MatchesHost(entry.rule.hosts, host))
+      continue;
+
+    int score = (pinned ? 0 : 2) + (all_hosts ? 1 : 0);
+    if (score < best_score) {
+      best_score = score;
+      *client_id = it.first;
+      *rule = entry.rule;
+    }
+  }
+  return best_score < 4;
+}
+
+void NetworkEmulationRules::RecordRequest(bool dropped) {
+  base::AutoLock auto_lock(lock_);
+  ++throttled_;
+  if (dropped)
+    ++dropped_;
+}
+
+void NetworkEmulationRules::GetStats(int64* throttled, int64* dropped) const {
+  base::AutoLock auto_lock(lock_);
+  *throttled = throttled_;
+  *dropped = dropped_;
+}
+
+void NetworkEmulationRules::ResetStats() {
+  base::AutoLock auto_lock(lock_);
+  throttled_ = 0;
+  dropped_ = 0;
+}
+
+}  // namespace atom
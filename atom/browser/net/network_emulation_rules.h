@@ -0,0 +1,107 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_NETWORK_EMULATION_RULES_H_
+#define ATOM_BROWSER_NET_NETWORK_EMULATION_RULES_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace net {
+class URLRequest;
+}
+
+namespace atom {
+
+// Decides which requests of a session are emulated with which conditions.
+// The latency and throughput of a rule are applied by brightray's
+// DevToolsNetworkController to the requests that carry the rule's client id,
+// the packet loss and jitter are applied by the HTTP jobs.
+//
+// The rules are changed on the UI thread and matched on the IO thread.
+class NetworkEmulationRules
+    : public base::RefCountedThreadSafe<NetworkEmulationRules> {
+ public:
+  struct Rule {
+    Rule();
+    ~Rule();
+
+    // The hosts the rule applies to, all hosts when empty. A host starting
+    // with "." also matches its subdomains.
+    std::vector<std::string> hosts;
+
+    // The chance of a request failing as if its connection was lost, from 0
+    // to 1.
+    double packet_loss;
+
+    // The longest random delay added before a request starts.
+    base::TimeDelta jitter;
+  };
+
+  NetworkEmulationRules();
+
+  // Adds or replaces the rule of |client_id|. The rule of the empty client id
+  // is the one that DevToolsNetworkController applies to all requests. A
+  // |pinned| rule only applies to the render views added to it.
+  void SetRule(const std::string& client_id, const Rule& rule, bool pinned);
+
+  // Removes the rules that are not pinned to render views, and returns their
+  // client ids.
+  std::vector<std::string> RemoveUnpinnedRules();
+  void RemoveRule(const std::string& client_id);
+
+  // Pins the rule of |client_id| to the requests of a render view.
+  void AddRenderView(const std::string& client_id,
+                     int render_process_id,
+                     int render_view_id);
+  void RemoveRenderView(const std::string& client_id,
+                        int render_process_id,
+                        int render_view_id);
+
+  // Finds the rule of |request|. The rules pinned to its render view come
+  // before the others, and the rules of some hosts before the rules of all
+  // hosts.
+  bool Match(const net::URLRequest* request,
+             std::string* client_id,
+             Rule* rule) const;
+
+  // How many requests were emulated, and how many of them were dropped.
+  void RecordRequest(bool dropped);
+  void GetStats(int64* throttled, int64* dropped) const;
+  void ResetStats();
+
+ private:
+  friend class base::RefCountedThreadSafe<NetworkEmulationRules>;
+
+  typedef std::pair<int, int> RenderViewId;
+
+  struct Entry {
+    Entry();
+    ~Entry();
+
+    Rule rule;
+    bool pinned;
+    std::set<RenderViewId> render_views;
+  };
+
+  ~NetworkEmulationRules();
+
+  mutable base::Lock lock_;
+  std::map<std::string, Entry> entries_;
+  int64 throttled_;
+  int64 dropped_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetworkEmulationRules);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_NETWORK_EMULATION_RULES_H_
@@ -0,0 +1,400 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/parallel_download_job.h"
+
+#include <algorithm>
+
+#include "base/files/file_util.h"
+#include "base/format_macros.h"
+#include "base/strings/stringprintf.h"
+#include "base/task_runner_util.h"
+#include "net/base/io_buffer.h"
+#include "net/base/load_flags.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
+#include "net/url_request/url_fetcher.h"
+#include "net/url_request/url_fetcher_response_writer.h"
+#include "net/url_request/url_request_context_getter.h"
+#include "net/url_request/url_request_status.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// Segments are not made smaller than this.
+const int64 kMinSegmentSize = 1024 * 1024;
+
+const size_t kMaxSegments = 16;
+
+// The shortest time between two progress updates.
+const int kUpdateIntervalMs = 100;
+
+// Passes the body of a segment to the job.
+class SegmentWriter : public net::URLFetcherResponseWriter {
+ public:
+  SegmentWriter(ParallelDownloadJob* job, size_t index)
+      : job_(job), index_(index) {}
+
+  // net::URLFetcherResponseWriter:
+  int Initialize(const net::CompletionCallback& callback) override {
+    return net::OK;
+  }
+  int Write(net::IOBuffer* buffer,
+            int num_bytes,
+            const net::CompletionCallback& callback) override {
+    return job_->WriteSegment(index_, buffer, num_bytes, callback);
+  }
+  int Finish(const net::CompletionCallback& callback) override {
+    return net::OK;
+  }
+
+ private:
+  // The job owns the fetcher that owns the writer.
+  ParallelDownloadJob* job_;
+  size_t index_;
+
+  DISALLOW_COPY_AND_ASSIGN(SegmentWriter);
+};
+
+}  // namespace
+
+ParallelDownloadJob::Segment::Segment(int64 offset, int64 length)
+    : offset(offset),
+      length(length),
+      received(0),
+      started(false),
+      done(false),
+      generation(0) {
+}
+
+ParallelDownloadJob::Segment::~Segment() {
+}
+
+ParallelDownloadJob::ParallelDownloadJob(
+    net::URLRequestContextGetter* request_context_getter,
+    const GURL& url,
+    const base::FilePath& path,
+    int max_segments,
+    const base::WeakPtr<Delegate>& delegate)
+    : request_context_getter_(request_context_getter),
+      url_(url),
+      path_(path),
+      max_segments_(std::min(static_cast<size_t>(std::max(max_segments, 1)),
+                             kMaxSegments)),
+      delegate_(delegate),
+      state_(STATE_IN_PROGRESS),
+      ranges_supported_(false),
+      total_bytes_(-1),
+      received_bytes_(0) {
+}
+
+ParallelDownloadJob::~ParallelDownloadJob() {
+  // The file of an interrupted download that was not resumed.
+  if (file_.IsValid())
+    BrowserThread::DeleteSoon(BrowserThread::FILE, FROM_HERE,
+                              new base::File(file_.Pass()));
+}
+
+void ParallelDownloadJob::Start() {
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&ParallelDownloadJob::StartOnIO, this));
+}
+
+void ParallelDownloadJob::Pause() {
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&ParallelDownloadJob::PauseOnIO, this));
+}
+
+void ParallelDownloadJob::Resume() {
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&ParallelDownloadJob::ResumeOnIO, this));
+}
+
+void ParallelDownloadJob::Cancel() {
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&ParallelDownloadJob::CancelOnIO, this));
+}
+
+int ParallelDownloadJob::WriteSegment(size_t index,
+                                      net::IOBuffer* buffer,
+                                      int num_bytes,
+                                      const net::CompletionCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  Segment* segment = segments_[index].get();
+  if (!segment->started) {
+    segment->started = true;
+    if (!OnSegmentStarted(segment))
+      return net::ERR_FAILED;
+  }
+
+  base::PostTaskAndReplyWithResult(
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get(),
+      FROM_HERE,
+      base::Bind(&ParallelDownloadJob::WriteFile, this,
+                 segment->offset + segment->received,
+                 make_scoped_refptr(buffer), num_bytes),
+      base::Bind(&ParallelDownloadJob::OnSegmentWritten, this, index,
+                 segment->generation, callback));
+  return net::ERR_IO_PENDING;
+}
+
+void ParallelDownloadJob::OnURLFetchComplete(const net::URLFetcher* source) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  size_t index = 0;
+  while (index < segments_.size() &&
+         segments_[index]->fetcher.get() != source)
+    ++index;
+  if (index == segments_.size())
+    return;
+
+  Segment* segment = segments_[index].get();
+  int response_code = source->GetResponseCode();
+  bool success = source->GetStatus().is_success() &&
+                 (response_code == net::HTTP_OK ||
+                  response_code == net::HTTP_PARTIAL_CONTENT) &&
+                 (segment->length < 0 ||
+                  segment->received == segment->length);
+  segment->fetcher.reset();
+  if (!success) {
+    Finish(STATE_INTERRUPTED);
+    return;
+  }
+
+  segment->done = true;
+  OnSegmentsDone();
+}
+
+void ParallelDownloadJob::StartOnIO() {
+  base::PostTaskAndReplyWithResult(
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get(),
+      FROM_HERE,
+      base::Bind(&ParallelDownloadJob::OpenFile, this),
+      base::Bind(&ParallelDownloadJob::OnFileOpened, this));
+}
+
+void ParallelDownloadJob::PauseOnIO() {
+  if (state_ != STATE_IN_PROGRESS)
+    return;
+
+  StopSegments();
+  state_ = STATE_PAUSED;
+  NotifyUpdated(true);
+}
+
+void ParallelDownloadJob::ResumeOnIO() {
+  if (state_ != STATE_PAUSED && state_ != STATE_INTERRUPTED)
+    return;
+
+  state_ = STATE_IN_PROGRESS;
+  // The file was not opened yet.
+  if (segments_.empty()) {
+    StartOnIO();
+    return;
+  }
+
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    Segment* segment = segments_[i].get();
+    if (segment->done)
+      continue;
+
+    // The request may have stopped after the last byte of its range was
+    // written, asking for the range after it would fail with 416.
+    if (segment->length >= 0 && segment->received == segment->length) {
+      segment->done = true;
+      continue;
+    }
+
+    // Without ranges the download can only start again.
+    if (!ranges_supported_ && segment->received > 0) {
+      received_bytes_ -= segment->received;
+      segment->received = 0;
+    }
+    StartSegment(i);
+  }
+  NotifyUpdated(true);
+  OnSegmentsDone();
+}
+
+void ParallelDownloadJob::CancelOnIO() {
+  if (state_ == STATE_COMPLETED || state_ == STATE_CANCELLED)
+    return;
+
+  Finish(STATE_CANCELLED);
+}
+
+void ParallelDownloadJob::OnFileOpened(bool success) {
+  if (state_ != STATE_IN_PROGRESS)
+    return;
+
+  if (!success) {
+    Finish(STATE_INTERRUPTED);
+    return;
+  }
+
+  // Ask for the first byte to find out whether ranges are supported, when the
+  // server ignores the range this request downloads the whole file.
+  segments_.push_back(make_linked_ptr(new Segment(0, 1)));
+  StartSegment(0);
+}
+
+bool ParallelDownloadJob::OnSegmentStarted(Segment* segment) {
+  const net::URLFetcher* fetcher = segment->fetcher.get();
+  net::HttpResponseHeaders* headers = fetcher->GetResponseHeaders();
+  if (!headers)
+    return false;
+
+  // The later responses must be the ranges of the same file.
+  if (segments_.size() > 1 || segment->received > 0) {
+    return ranges_supported_ &&
+           fetcher->GetResponseCode() == net::HTTP_PARTIAL_CONTENT;
+  }
+
+  int64 first, last, length;
+  if (fetcher->GetResponseCode() == net::HTTP_PARTIAL_CONTENT &&
+      headers->GetContentRange(&first, &last, &length) && first == 0 &&
+      length > 0) {
+    ranges_supported_ = true;
+    total_bytes_ = length;
+    if (!headers->EnumerateHeader(nullptr, "ETag", &validator_))
+      headers->EnumerateHeader(nullptr, "Last-Modified", &validator_);
+  } else {
+    ranges_supported_ = false;
+    segment->length = -1;
+    total_bytes_ = headers->GetContentLength();
+  }
+  NotifyUpdated(true);
+  return true;
+}
+
+void ParallelDownloadJob::CreateSegments() {
+  int64 offset = 1;
+  int64 remaining = total_bytes_ - offset;
+  size_t count = static_cast<size_t>(std::max<int64>(std::min<int64>(
+      max_segments_, (remaining + kMinSegmentSize - 1) / kMinSegmentSize), 1));
+  int64 size = remaining / count;
+  for (size_t i = 0; i < count; ++i) {
+    int64 length = i == count - 1 ? total_bytes_ - offset : size;
+    segments_.push_back(make_linked_ptr(new Segment(offset, length)));
+    offset += length;
+  }
+
+  for (size_t i = 1; i < segments_.size(); ++i)
+    StartSegment(i);
+}
+
+void ParallelDownloadJob::OnSegmentsDone() {
+  for (const auto& segment : segments_)
+    if (!segment->done)
+      return;
+
+  // The first request only fetched the first byte.
+  if (ranges_supported_ && segments_.size() == 1 && total_bytes_ > 1) {
+    CreateSegments();
+    return;
+  }
+
+  Finish(STATE_COMPLETED);
+}
+
+void ParallelDownloadJob::StartSegment(size_t index) {
+  Segment* segment = segments_[index].get();
+  segment->started = false;
+  ++segment->generation;
+  segment->fetcher = net::URLFetcher::Create(url_, net::URLFetcher::GET, this);
+  segment->fetcher->SetRequestContext(request_context_getter_.get());
+  segment->fetcher->SetLoadFlags(net::LOAD_DISABLE_CACHE);
+  segment->fetcher->SaveResponseWithWriter(
+      make_scoped_ptr(new SegmentWriter(this, index)));
+
+  int64 first = segment->offset + segment->received;
+  if (segment->length >= 0) {
+    segment->fetcher->AddExtraRequestHeader(base::StringPrintf(
+        "Range: bytes=%" PRId64 "-%" PRId64, first,
+        segment->offset + segment->length - 1));
+  } else if (first > 0) {
+    segment->fetcher->AddExtraRequestHeader(
+        base::StringPrintf("Range: bytes=%" PRId64 "-", first));
+  }
+  if (!validator_.empty())
+    segment->fetcher->AddExtraRequestHeader("If-Range: " + validator_);
+  segment->fetcher->Start();
+}
+
+void ParallelDownloadJob::StopSegments() {
+  for (const auto& segment : segments_)
+    segment->fetcher.reset();
+}
+
+void ParallelDownloadJob::OnSegmentWritten(
+    size_t index,
+    int generation,
+    const net::CompletionCallback& callback,
+    int result) {
+  // The writes of a stopped request are dropped, the segment continues from
+  // the bytes that were counted before.
+  Segment* segment = segments_[index].get();
+  if (!segment->fetcher || segment->generation != generation)
+    return;
+
+  if (result > 0) {
+    segment->received += result;
+    received_bytes_ += result;
+    NotifyUpdated(false);
+  }
+  callback.Run(result < 0 ? net::ERR_FAILED : result);
+}
+
+void ParallelDownloadJob::Finish(State state) {
+  StopSegments();
+  state_ = state;
+  // An interrupted download keeps its file open to be resumed.
+  if (state != STATE_INTERRUPTED)
+    BrowserThread::PostTask(BrowserThread::FILE, FROM_HERE,
+        base::Bind(&ParallelDownloadJob::CloseFile, this,
+                   state == STATE_CANCELLED));
+  NotifyUpdated(true);
+}
+
+void ParallelDownloadJob::NotifyUpdated(bool force) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (!force && now - last_update_time_ <
+                    base::TimeDelta::FromMilliseconds(kUpdateIntervalMs))
+    return;
+
+  last_update_time_ = now;
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(&Delegate::OnDownloadUpdated, delegate_, state_,
+                 received_bytes_, total_bytes_));
+}
+
+bool ParallelDownloadJob::OpenFile() {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  if (file_.IsValid())
+    return true;
+  file_.Initialize(path_, base::File::FLAG_CREATE_ALWAYS |
+                          base::File::FLAG_WRITE);
+  return file_.IsValid();
+}
+
+int ParallelDownloadJob::WriteFile(int64 offset,
+                                   scoped_refptr<net::IOBuffer> buffer,
+                                   int size) {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  if (!file_.IsValid())
+    return -1;
+  return file_.Write(offset, buffer->data(), size);
+}
+
+void ParallelDownloadJob::CloseFile(bool remove) {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  file_.Close();
+  if (remove)
+    base::DeleteFile(path_, false);
+}
+
+}  // namespace atom
@@ -0,0 +1,166 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_PARALLEL_DOWNLOAD_JOB_H_
+#define ATOM_BROWSER_NET_PARALLEL_DOWNLOAD_JOB_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/completion_callback.h"
+#include "net/url_request/url_fetcher_delegate.h"
+#include "url/gurl.h"
+
+namespace net {
+class IOBuffer;
+class URLFetcher;
+class URLRequestContextGetter;
+}
+
+namespace atom {
+
+// Downloads |url| into |path| over several connections, each of them fetching
+// a byte range of the file. The first request finds out whether the server
+// supports ranges, when it does not the file is downloaded by that request
+// alone.
+//
+// The methods are called on the UI thread, the requests run on the IO thread
+// and the file is written on the FILE thread. The delegate is notified on the
+// UI thread.
+class ParallelDownloadJob
+    : public base::RefCountedThreadSafe<
+          ParallelDownloadJob, content::BrowserThread::DeleteOnIOThread>,
+      public net::URLFetcherDelegate {
+ public:
+  enum State {
+    STATE_IN_PROGRESS,
+    STATE_PAUSED,
+    STATE_COMPLETED,
+    STATE_CANCELLED,
+    STATE_INTERRUPTED,
+  };
+
+  class Delegate {
+   public:
+    virtual void OnDownloadUpdated(State state,
+                                   int64 received_bytes,
+                                   int64 total_bytes) = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
+  ParallelDownloadJob(net::URLRequestContextGetter* request_context_getter,
+                      const GURL& url,
+                      const base::FilePath& path,
+                      int max_segments,
+                      const base::WeakPtr<Delegate>& delegate);
+
+  void Start();
+  void Pause();
+  // Continues a paused or interrupted download from the received bytes.
+  void Resume();
+  void Cancel();
+
+  // Called by the response writer of the segment |index|.
+  int WriteSegment(size_t index,
+                   net::IOBuffer* buffer,
+                   int num_bytes,
+                   const net::CompletionCallback& callback);
+
+  // net::URLFetcherDelegate:
+  void OnURLFetchComplete(const net::URLFetcher* source) override;
+
+ private:
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::IO>;
+  friend class base::DeleteHelper<ParallelDownloadJob>;
+
+  struct Segment {
+    Segment(int64 offset, int64 length);
+    ~Segment();
+
+    int64 offset;
+    // -1 when the segment lasts until the end of the response.
+    int64 length;
+    int64 received;
+    bool started;
+    bool done;
+    // Changes whenever the segment is started again.
+    int generation;
+    scoped_ptr<net::URLFetcher> fetcher;
+  };
+
+  ~ParallelDownloadJob() override;
+
+  void StartOnIO();
+  void PauseOnIO();
+  void ResumeOnIO();
+  void CancelOnIO();
+
+  // Called when the file has been opened.
+  void OnFileOpened(bool success);
+
+  // Checks the response of the segment when its first data arrives, returns
+  // false when it can not be used.
+  bool OnSegmentStarted(Segment* segment);
+
+  // Splits the rest of the file after the first request.
+  void CreateSegments();
+
+  // Continues with the rest of the file or completes the download once every
+  // segment is done.
+  void OnSegmentsDone();
+
+  void StartSegment(size_t index);
+  void StopSegments();
+
+  void OnSegmentWritten(size_t index,
+                        int generation,
+                        const net::CompletionCallback& callback,
+                        int result);
+
+  // Stops the download in |state| and tells the delegate.
+  void Finish(State state);
+
+  void NotifyUpdated(bool force);
+
+  // FILE thread:
+  bool OpenFile();
+  int WriteFile(int64 offset, scoped_refptr<net::IOBuffer> buffer, int size);
+  void CloseFile(bool remove);
+
+  scoped_refptr<net::URLRequestContextGetter> request_context_getter_;
+  GURL url_;
+  base::FilePath path_;
+  size_t max_segments_;
+  base::WeakPtr<Delegate> delegate_;
+
+  // Only accessed on the FILE thread.
+  base::File file_;
+
+  // The rest is only accessed on the IO thread.
+  State state_;
+  std::vector<linked_ptr<Segment>> segments_;
+  bool ranges_supported_;
+  // The ETag or Last-Modified of the first response, later responses must
+  // match it.
+  std::string validator_;
+  int64 total_bytes_;
+  int64 received_bytes_;
+  base::TimeTicks last_update_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelDownloadJob);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_PARALLEL_DOWNLOAD_JOB_H_
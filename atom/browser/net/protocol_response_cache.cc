@@ -0,0 +1,210 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/protocol_response_cache.h"
+
+#include <vector>
+
+#include "atom/browser/net/byte_range_headers.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_response_info.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_simple_job.h"
+
+namespace atom {
+
+namespace {
+
+// Responses bigger than this are never stored.
+const size_t kMaxEntrySize = 4 * 1024 * 1024;
+
+// The least recently used responses are removed above this.
+const size_t kMaxTotalSize = 32 * 1024 * 1024;
+
+// The URL is the key of the response, without its fragment.
+std::string GetCacheKey(const net::URLRequest* request) {
+  GURL::Replacements replacements;
+  replacements.ClearRef();
+  return request->url().ReplaceComponents(replacements).spec();
+}
+
+// Whether one of the ETags in |if_none_match| is |etag|.
+bool MatchesETag(const std::string& if_none_match, const std::string& etag) {
+  std::vector<std::string> etags;
+  base::SplitString(if_none_match, ',', &etags);
+  for (const std::string& value : etags) {
+    std::string trimmed;
+    base::TrimWhitespaceASCII(value, base::TRIM_ALL, &trimmed);
+    if (trimmed == "*" || trimmed == etag)
+      return true;
+  }
+  return false;
+}
+
+// Sends a stored response.
+class URLRequestCachedJob : public net::URLRequestSimpleJob {
+ public:
+  URLRequestCachedJob(net::URLRequest* request,
+                      net::NetworkDelegate* network_delegate,
+                      const ProtocolResponseCache::Entry& entry,
+                      bool not_modified)
+      : net::URLRequestSimpleJob(request, network_delegate),
+        entry_(entry),
+        not_modified_(not_modified) {}
+
+  // URLRequestJob:
+  void GetResponseInfo(net::HttpResponseInfo* info) override {
+    net::HttpResponseHeaders* headers = not_modified_ ?
+        CreateResponseHeaders(net::HTTP_NOT_MODIFIED, ranges(), 0) :
+        CreateResponseHeaders(net::HTTP_OK, ranges(), entry_.data->size());
+
+    if (!entry_.mime_type.empty()) {
+      std::string content_type_header(net::HttpRequestHeaders::kContentType);
+      content_type_header.append(": ");
+      content_type_header.append(entry_.mime_type);
+      headers->AddHeader(content_type_header);
+    }
+    ProtocolResponseCache::AddCacheHeaders(entry_, headers);
+
+    info->headers = headers;
+  }
+
+  // URLRequestSimpleJob:
+  int GetRefCountedData(
+      std::string* mime_type,
+      std::string* charset,
+      scoped_refptr<base::RefCountedMemory>* data,
+      const net::CompletionCallback& callback) const override {
+    *mime_type = entry_.mime_type;
+    *charset = entry_.charset;
+    if (not_modified_)
+      *data = new base::RefCountedString;
+    else
+      *data = entry_.data;
+    return net::OK;
+  }
+
+ private:
+  ~URLRequestCachedJob() override {}
+
+  ProtocolResponseCache::Entry entry_;
+  bool not_modified_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestCachedJob);
+};
+
+}  // namespace
+
+ProtocolResponseCache::Entry::Entry() : immutable(false) {}
+
+ProtocolResponseCache::Entry::~Entry() {}
+
+ProtocolResponseCache::ProtocolResponseCache()
+    : entries_(EntryMap::NO_AUTO_EVICT),
+      total_size_(0) {
+}
+
+ProtocolResponseCache::~ProtocolResponseCache() {
+}
+
+// static
+bool ProtocolResponseCache::ParseCacheOptions(
+    const base::DictionaryValue* options, Entry* entry) {
+  const base::DictionaryValue* cache = nullptr;
+  if (!options->GetDictionary("cache", &cache))
+    return false;
+
+  double max_age = 0;
+  cache->GetDouble("maxAge", &max_age);
+  cache->GetString("etag", &entry->etag);
+  cache->GetBoolean("immutable", &entry->immutable);
+  if (max_age <= 0 && !entry->immutable)
+    return false;
+
+  entry->max_age = base::TimeDelta::FromSecondsD(max_age);
+  entry->expires = base::TimeTicks::Now() + entry->max_age;
+  return true;
+}
+
+// static
+void ProtocolResponseCache::AddCacheHeaders(
+    const Entry& entry, net::HttpResponseHeaders* headers) {
+  if (!entry.etag.empty())
+    headers->AddHeader("ETag: " + entry.etag);
+
+  std::string cache_control("Cache-Control: max-age=");
+  cache_control.append(base::Int64ToString(entry.max_age.InSeconds()));
+  if (entry.immutable)
+    cache_control.append(", immutable");
+  headers->AddHeader(cache_control);
+}
+
+void ProtocolResponseCache::Put(const net::URLRequest* request,
+                                const Entry& entry) {
+  if (request->method() != "GET" || !entry.data.get() ||
+      entry.data->size() > kMaxEntrySize)
+    return;
+
+  std::string key = GetCacheKey(request);
+  auto it = entries_.Peek(key);
+  if (it != entries_.end()) {
+    total_size_ -= it->second.data->size();
+    entries_.Erase(it);
+  }
+
+  entries_.Put(key, entry);
+  total_size_ += entry.data->size();
+  while (total_size_ > kMaxTotalSize) {
+    auto last = entries_.rbegin();
+    total_size_ -= last->second.data->size();
+    entries_.Erase(last);
+  }
+}
+
+net::URLRequestJob* ProtocolResponseCache::MaybeCreateJob(
+    net::URLRequest* request, net::NetworkDelegate* network_delegate) {
+  if (request->method() != "GET")
+    return nullptr;
+
+  auto it = entries_.Get(GetCacheKey(request));
+  if (it == entries_.end())
+    return nullptr;
+
+  const Entry& entry = it->second;
+  if (!entry.immutable && entry.expires <= base::TimeTicks::Now()) {
+    total_size_ -= entry.data->size();
+    entries_.Erase(it);
+    return nullptr;
+  }
+
+  std::string if_none_match;
+  bool not_modified =
+      !entry.etag.empty() &&
+      request->extra_request_headers().GetHeader(
+          net::HttpRequestHeaders::kIfNoneMatch, &if_none_match) &&
+      MatchesETag(if_none_match, entry.etag);
+  return new URLRequestCachedJob(request, network_delegate, entry,
+                                 not_modified);
+}
+
+void ProtocolResponseCache::RemoveScheme(const std::string& scheme) {
+  std::string prefix = scheme + ":";
+  auto it = entries_.begin();
+  while (it != entries_.end()) {
+    if (base::StartsWith(it->first, prefix, base::CompareCase::SENSITIVE)) {
+      total_size_ -= it->second.data->size();
+      it = entries_.Erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace atom
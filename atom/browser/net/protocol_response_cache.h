@@ -0,0 +1,82 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+#define ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/time/time.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace net {
+class HttpResponseHeaders;
+class NetworkDelegate;
+class URLRequest;
+class URLRequestJob;
+}
+
+namespace atom {
+
+// Keeps the responses that the protocol handlers sent with cache metadata, so
+// the same requests are served on the IO thread without asking JavaScript
+// again. Only accessed on the IO thread.
+class ProtocolResponseCache {
+ public:
+  struct Entry {
+    Entry();
+    ~Entry();
+
+    scoped_refptr<base::RefCountedMemory> data;
+    std::string mime_type;
+    std::string charset;
+    std::string etag;
+    // When the response becomes stale, unless it is immutable.
+    base::TimeTicks expires;
+    base::TimeDelta max_age;
+    bool immutable;
+  };
+
+  ProtocolResponseCache();
+  ~ProtocolResponseCache();
+
+  // Reads the |cache| property of the handler's |options| into |entry|,
+  // returns false when the response should not be cached.
+  static bool ParseCacheOptions(const base::DictionaryValue* options,
+                                Entry* entry);
+
+  // Adds the ETag and Cache-Control headers of |entry| to |headers|.
+  static void AddCacheHeaders(const Entry& entry,
+                              net::HttpResponseHeaders* headers);
+
+  // Stores the response of |request|, only GET requests are stored.
+  void Put(const net::URLRequest* request, const Entry& entry);
+
+  // Returns a job that sends the fresh response stored for |request|, or a
+  // "304 Not Modified" when it is revalidated with the stored ETag. Returns
+  // nullptr when there is no fresh response.
+  net::URLRequestJob* MaybeCreateJob(net::URLRequest* request,
+                                     net::NetworkDelegate* network_delegate);
+
+  // Removes the responses of |scheme|.
+  void RemoveScheme(const std::string& scheme);
+
+ private:
+  using EntryMap = base::MRUCache<std::string, Entry>;
+  EntryMap entries_;
+
+  // The bytes of all responses.
+  size_t total_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolResponseCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
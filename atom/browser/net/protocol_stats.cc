@@ -0,0 +1,115 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/protocol_stats.h"
+
+#include <algorithm>
+
+#include "base/lazy_instance.h"
+#include "base/values.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<ProtocolStats>::Leaky g_protocol_stats =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+ProtocolStats::Counters::Counters()
+    : requests(0),
+      routed_requests(0),
+      cached_requests(0),
+      handler_calls(0),
+      responses(0),
+      bytes(0) {
+}
+
+// static
+ProtocolStats* ProtocolStats::GetInstance() {
+  return g_protocol_stats.Pointer();
+}
+
+ProtocolStats::ProtocolStats() {
+}
+
+ProtocolStats::~ProtocolStats() {
+}
+
+void ProtocolStats::RecordRequest(const std::string& scheme, Source source) {
+  base::AutoLock auto_lock(lock_);
+  Counters& counters = schemes_[scheme];
+  ++counters.requests;
+  if (source == SOURCE_ROUTE)
+    ++counters.routed_requests;
+  else if (source == SOURCE_CACHE)
+    ++counters.cached_requests;
+}
+
+void ProtocolStats::RecordHandler(const std::string& scheme,
+                                  base::TimeDelta queue_time,
+                                  base::TimeDelta handler_time) {
+  base::AutoLock auto_lock(lock_);
+  Counters& counters = schemes_[scheme];
+  ++counters.handler_calls;
+  counters.queue_time += queue_time;
+  counters.max_queue_time = std::max(counters.max_queue_time, queue_time);
+  counters.handler_time += handler_time;
+  counters.max_handler_time = std::max(counters.max_handler_time,
+                                       handler_time);
+}
+
+void ProtocolStats::RecordResponse(const net::URLRequest* request,
+                                   int64 bytes) {
+  base::TimeDelta time_to_first_byte;
+  if (!request->response_time().is_null())
+    time_to_first_byte = request->response_time() - request->request_time();
+
+  base::AutoLock auto_lock(lock_);
+  Counters& counters = schemes_[request->url().scheme()];
+  ++counters.responses;
+  counters.bytes += bytes;
+  counters.time_to_first_byte += time_to_first_byte;
+  counters.max_time_to_first_byte = std::max(counters.max_time_to_first_byte,
+                                             time_to_first_byte);
+}
+
+scoped_ptr<base::DictionaryValue> ProtocolStats::ToValue() const {
+  base::AutoLock auto_lock(lock_);
+  scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue);
+  for (const auto& it : schemes_) {
+    const Counters& counters = it.second;
+    scoped_ptr<base::DictionaryValue> scheme(new base::DictionaryValue);
+    scheme->SetDouble("requests", static_cast<double>(counters.requests));
+    scheme->SetDouble("routedRequests",
+                      static_cast<double>(counters.routed_requests));
+    scheme->SetDouble("cachedRequests",
+                      static_cast<double>(counters.cached_requests));
+    scheme->SetDouble("handlerCalls",
+                      static_cast<double>(counters.handler_calls));
+    scheme->SetDouble("queueTime", counters.queue_time.InMillisecondsF());
+    scheme->SetDouble("maxQueueTime",
+                      counters.max_queue_time.InMillisecondsF());
+    scheme->SetDouble("handlerTime", counters.handler_time.InMillisecondsF());
+    scheme->SetDouble("maxHandlerTime",
+                      counters.max_handler_time.InMillisecondsF());
+    scheme->SetDouble("responses", static_cast<double>(counters.responses));
+    scheme->SetDouble("bytes", static_cast<double>(counters.bytes));
+    scheme->SetDouble("timeToFirstByte",
+                      counters.time_to_first_byte.InMillisecondsF());
+    scheme->SetDouble("maxTimeToFirstByte",
+                      counters.max_time_to_first_byte.InMillisecondsF());
+    value->SetWithoutPathExpansion(it.first, scheme.release());
+  }
+  return value.Pass();
+}
+
+void ProtocolStats::Reset() {
+  base::AutoLock auto_lock(lock_);
+  schemes_.clear();
+}
+
+}  // namespace atom
@@ -0,0 +1,86 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_PROTOCOL_STATS_H_
+#define ATOM_BROWSER_NET_PROTOCOL_STATS_H_
+
+#include <map>
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace net {
+class URLRequest;
+}
+
+namespace atom {
+
+// Counters of the requests of each scheme handled by the job factory. The
+// requests and responses are recorded on the IO thread and the JavaScript
+// handlers on the UI thread, so all methods can be called on any thread.
+class ProtocolStats {
+ public:
+  // How a request was served.
+  enum Source {
+    SOURCE_HANDLER,
+    SOURCE_ROUTE,
+    SOURCE_CACHE,
+  };
+
+  static ProtocolStats* GetInstance();
+
+  ProtocolStats();
+  ~ProtocolStats();
+
+  void RecordRequest(const std::string& scheme, Source source);
+
+  // |queue_time| is the time the request waited for the UI thread, and
+  // |handler_time| the time until the handler called its callback.
+  void RecordHandler(const std::string& scheme,
+                     base::TimeDelta queue_time,
+                     base::TimeDelta handler_time);
+
+  // Called when the response of |request| has been read completely, the
+  // time to first byte is the time until its headers were received.
+  void RecordResponse(const net::URLRequest* request, int64 bytes);
+
+  // Returns the counters keyed by scheme, the times are totals in
+  // milliseconds.
+  scoped_ptr<base::DictionaryValue> ToValue() const;
+
+  void Reset();
+
+ private:
+  struct Counters {
+    Counters();
+
+    int64 requests;
+    int64 routed_requests;
+    int64 cached_requests;
+    int64 handler_calls;
+    base::TimeDelta queue_time;
+    base::TimeDelta max_queue_time;
+    base::TimeDelta handler_time;
+    base::TimeDelta max_handler_time;
+    int64 responses;
+    int64 bytes;
+    base::TimeDelta time_to_first_byte;
+    base::TimeDelta max_time_to_first_byte;
+  };
+
+  mutable base::Lock lock_;
+  std::map<std::string, Counters> schemes_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolStats);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_PROTOCOL_STATS_H_
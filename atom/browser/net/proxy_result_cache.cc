@@ -0,0 +1,86 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/proxy_result_cache.h"
+
+#include "url/gurl.h"
+
+namespace atom {
+
+namespace {
+
+// How long a resolved proxy is used.
+const int kResultLifetimeSeconds = 60;
+
+const size_t kMaxEntries = 1000;
+
+// PAC scripts can match on the path and the query, so the key is the URL as
+// the script gets it, without the credentials and the fragment.
+std::string GetKey(const GURL& url) {
+  GURL::Replacements replacements;
+  replacements.ClearUsername();
+  replacements.ClearPassword();
+  replacements.ClearRef();
+  return url.ReplaceComponents(replacements).spec();
+}
+
+}  // namespace
+
+ProxyResultCache::ProxyResultCache()
+    : entries_(kMaxEntries),
+      observing_(false) {
+}
+
+ProxyResultCache::~ProxyResultCache() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  if (observing_)
+    net::NetworkChangeNotifier::RemoveNetworkChangeObserver(this);
+}
+
+bool ProxyResultCache::Get(const GURL& url, std::string* proxy) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  EnsureObserving();
+
+  auto it = entries_.Get(GetKey(url));
+  if (it == entries_.end())
+    return false;
+
+  if (it->second.expires <= base::TimeTicks::Now()) {
+    entries_.Erase(it);
+    return false;
+  }
+
+  *proxy = it->second.proxy;
+  return true;
+}
+
+void ProxyResultCache::Put(const GURL& url, const std::string& proxy) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  EnsureObserving();
+
+  Entry entry;
+  entry.proxy = proxy;
+  entry.expires = base::TimeTicks::Now() +
+                  base::TimeDelta::FromSeconds(kResultLifetimeSeconds);
+  entries_.Put(GetKey(url), entry);
+}
+
+void ProxyResultCache::Clear() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  entries_.Clear();
+}
+
+void ProxyResultCache::OnNetworkChanged(
+    net::NetworkChangeNotifier::ConnectionType type) {
+  Clear();
+}
+
+void ProxyResultCache::EnsureObserving() {
+  if (observing_)
+    return;
+  net::NetworkChangeNotifier::AddNetworkChangeObserver(this);
+  observing_ = true;
+}
+
+}  // namespace atom
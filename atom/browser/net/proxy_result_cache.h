@@ -0,0 +1,65 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_PROXY_RESULT_CACHE_H_
+#define ATOM_BROWSER_NET_PROXY_RESULT_CACHE_H_
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/memory/ref_counted.h"
+#include "base/time/time.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/network_change_notifier.h"
+
+class GURL;
+
+namespace atom {
+
+// Remembers the resolved proxies of URLs for a short time, so resolving the
+// same URLs again does not run the PAC script for each of them. It is cleared
+// when the proxy settings or the network change.
+//
+// Created on any thread, but only used and deleted on the IO thread.
+class ProxyResultCache
+    : public base::RefCountedThreadSafe<
+          ProxyResultCache, content::BrowserThread::DeleteOnIOThread>,
+      public net::NetworkChangeNotifier::NetworkChangeObserver {
+ public:
+  ProxyResultCache();
+
+  // Returns false when there is no fresh result for |url|.
+  bool Get(const GURL& url, std::string* proxy);
+  void Put(const GURL& url, const std::string& proxy);
+
+  void Clear();
+
+  // net::NetworkChangeNotifier::NetworkChangeObserver:
+  void OnNetworkChanged(
+      net::NetworkChangeNotifier::ConnectionType type) override;
+
+ private:
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::IO>;
+  friend class base::DeleteHelper<ProxyResultCache>;
+
+  struct Entry {
+    std::string proxy;
+    base::TimeTicks expires;
+  };
+
+  ~ProxyResultCache() override;
+
+  // Starts observing the network on first use.
+  void EnsureObserving();
+
+  base::MRUCache<std::string, Entry> entries_;
+  bool observing_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProxyResultCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_PROXY_RESULT_CACHE_H_
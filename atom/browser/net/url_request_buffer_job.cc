@@ -6,7 +6,7 @@
 
 #include <string>
 
-#include "base/strings/string_number_conversions.h"
+#include "atom/browser/net/byte_range_headers.h"
 #include "net/base/net_errors.h"
 
 namespace atom {
@@ -14,41 +14,43 @@ namespace atom {
 URLRequestBufferJob::URLRequestBufferJob(
     net::URLRequest* request, net::NetworkDelegate* network_delegate)
     : JsAsker<net::URLRequestSimpleJob>(request, network_delegate),
-      status_code_(net::HTTP_NOT_IMPLEMENTED) {
+      status_code_(net::HTTP_NOT_IMPLEMENTED),
+      cached_(false) {
+  // The Buffer is served from its own memory instead of being copied.
+  set_reference_buffer(true);
 }
 
 void URLRequestBufferJob::StartAsync(scoped_ptr<base::Value> options) {
-  const base::BinaryValue* binary = nullptr;
+  base::DictionaryValue* dict = nullptr;
   if (options->IsType(base::Value::TYPE_DICTIONARY)) {
-    base::DictionaryValue* dict =
-        static_cast<base::DictionaryValue*>(options.get());
+    dict = static_cast<base::DictionaryValue*>(options.get());
     dict->GetString("mimeType", &mime_type_);
     dict->GetString("charset", &charset_);
-    dict->GetBinary("data", &binary);
-  } else if (options->IsType(base::Value::TYPE_BINARY)) {
-    options->GetAsBinary(&binary);
   }
 
-  if (!binary) {
+  data_ = buffer();
+  if (!data_.get()) {
     NotifyStartError(net::URLRequestStatus(
           net::URLRequestStatus::FAILED, net::ERR_NOT_IMPLEMENTED));
     return;
   }
 
-  data_ = new base::RefCountedBytes(
-      reinterpret_cast<const unsigned char*>(binary->GetBuffer()),
-      binary->GetSize());
+  // Keep the response for the next requests.
+  if (dict && ProtocolResponseCache::ParseCacheOptions(dict, &cache_entry_)) {
+    cached_ = true;
+    cache_entry_.data = data_;
+    cache_entry_.mime_type = mime_type_;
+    cache_entry_.charset = charset_;
+    response_cache()->Put(request(), cache_entry_);
+  }
+
   status_code_ = net::HTTP_OK;
   net::URLRequestSimpleJob::Start();
 }
 
 void URLRequestBufferJob::GetResponseInfo(net::HttpResponseInfo* info) {
-  std::string status("HTTP/1.1 ");
-  status.append(base::IntToString(status_code_));
-  status.append(" ");
-  status.append(net::GetHttpReasonPhrase(status_code_));
-  status.append("\0\0", 2);
-  net::HttpResponseHeaders* headers = new net::HttpResponseHeaders(status);
+  net::HttpResponseHeaders* headers = CreateResponseHeaders(
+      status_code_, ranges(), data_.get() ? data_->size() : 0);
 
   if (!mime_type_.empty()) {
     std::string content_type_header(net::HttpRequestHeaders::kContentType);
@@ -57,6 +59,9 @@ void URLRequestBufferJob::GetResponseInfo(net::HttpResponseInfo* info) {
     headers->AddHeader(content_type_header);
   }
 
+  if (cached_)
+    ProtocolResponseCache::AddCacheHeaders(cache_entry_, headers);
+
   info->headers = headers;
 }
 
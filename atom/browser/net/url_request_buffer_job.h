@@ -33,8 +33,10 @@ class URLRequestBufferJob : public JsAsker<net::URLRequestSimpleJob> {
  private:
   std::string mime_type_;
   std::string charset_;
-  scoped_refptr<base::RefCountedBytes> data_;
+  scoped_refptr<base::RefCountedMemory> data_;
   net::HttpStatusCode status_code_;
+  bool cached_;
+  ProtocolResponseCache::Entry cache_entry_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestBufferJob);
 };
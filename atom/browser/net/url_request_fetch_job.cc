@@ -7,10 +7,15 @@
 #include <algorithm>
 #include <string>
 
+#include "base/memory/scoped_vector.h"
 #include "base/strings/string_util.h"
 #include "base/thread_task_runner_handle.h"
+#include "net/base/elements_upload_data_stream.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
+#include "net/base/upload_bytes_element_reader.h"
+#include "net/base/upload_file_element_reader.h"
+#include "net/http/http_request_headers.h"
 #include "net/http/http_response_headers.h"
 #include "net/url_request/url_fetcher.h"
 #include "net/url_request/url_fetcher_response_writer.h"
@@ -59,7 +64,7 @@ class ResponsePiper : public net::URLFetcherResponseWriter {
       job_->HeadersCompleted();
       first_write_ = false;
     }
-    return job_->DataAvailable(buffer, num_bytes);
+    return job_->DataAvailable(buffer, num_bytes, callback);
   }
   int Finish(const net::CompletionCallback& callback) override {
     return net::OK;
@@ -72,12 +77,41 @@ class ResponsePiper : public net::URLFetcherResponseWriter {
   DISALLOW_COPY_AND_ASSIGN(ResponsePiper);
 };
 
+// Creates a new stream of the body of |upload|, the files are read while
+// uploading instead of being loaded into memory.
+scoped_ptr<net::UploadDataStream> CreateUploadStream(
+    const net::UploadDataStream* upload) {
+  ScopedVector<net::UploadElementReader> readers;
+  for (const net::UploadElementReader* reader :
+       *upload->GetElementReaders()) {
+    if (reader->AsBytesReader()) {
+      // The bytes belong to the original request, which outlives the job.
+      const net::UploadBytesElementReader* bytes = reader->AsBytesReader();
+      readers.push_back(
+          new net::UploadBytesElementReader(bytes->bytes(), bytes->length()));
+    } else if (reader->AsFileReader()) {
+      const net::UploadFileElementReader* file = reader->AsFileReader();
+      readers.push_back(new net::UploadFileElementReader(
+          content::BrowserThread::GetBlockingPool()->
+              GetTaskRunnerWithShutdownBehavior(
+                  base::SequencedWorkerPool::SKIP_ON_SHUTDOWN).get(),
+          file->path(),
+          file->range_offset(),
+          file->range_length(),
+          file->expected_modification_time()));
+    }
+  }
+  return make_scoped_ptr(
+      new net::ElementsUploadDataStream(readers.Pass(), upload->identifier()));
+}
+
 }  // namespace
 
 URLRequestFetchJob::URLRequestFetchJob(
     net::URLRequest* request, net::NetworkDelegate* network_delegate)
     : JsAsker<net::URLRequestJob>(request, network_delegate),
-      pending_buffer_size_(0) {
+      pending_buffer_size_(0),
+      weak_factory_(this) {
 }
 
 void URLRequestFetchJob::StartAsync(scoped_ptr<base::Value> options) {
@@ -130,6 +164,16 @@ void URLRequestFetchJob::StartAsync(scoped_ptr<base::Value> options) {
   fetcher_->SetExtraRequestHeaders(
       request()->extra_request_headers().ToString());
 
+  // Stream |request|'s body.
+  const net::UploadDataStream* upload = request()->get_upload();
+  if (upload && upload->GetElementReaders()) {
+    std::string content_type;
+    request()->extra_request_headers().GetHeader(
+        net::HttpRequestHeaders::kContentType, &content_type);
+    fetcher_->SetUploadStreamFactory(
+        content_type, base::Bind(&CreateUploadStream, upload));
+  }
+
   fetcher_->Start();
 }
 
@@ -150,13 +194,19 @@ void URLRequestFetchJob::HeadersCompleted() {
   NotifyHeadersComplete();
 }
 
-int URLRequestFetchJob::DataAvailable(net::IOBuffer* buffer, int num_bytes) {
+int URLRequestFetchJob::DataAvailable(net::IOBuffer* buffer,
+                                      int num_bytes,
+                                      const net::CompletionCallback& callback) {
+  // Keep the data if there's no ReadRawData() operation waiting for IO
+  // completion, the fetcher stops reading until the write is completed.
+  if (!pending_buffer_.get()) {
+    write_buffer_ = new net::DrainableIOBuffer(buffer, num_bytes);
+    write_callback_ = callback;
+    return net::ERR_IO_PENDING;
+  }
+
   // Clear the IO_PENDING status.
   SetStatus(net::URLRequestStatus());
-  // Do nothing if pending_buffer_ is empty, i.e. there's no ReadRawData()
-  // operation waiting for IO completion.
-  if (!pending_buffer_.get())
-    return net::ERR_IO_PENDING;
 
   // pending_buffer_ is set to the IOBuffer instance provided to ReadRawData()
   // by URLRequestJob.
@@ -173,14 +223,40 @@ int URLRequestFetchJob::DataAvailable(net::IOBuffer* buffer, int num_bytes) {
   return bytes_read;
 }
 
+void URLRequestFetchJob::OnWriteBufferRead(int num_bytes) {
+  net::CompletionCallback callback = write_callback_;
+  write_callback_.Reset();
+  if (fetcher_ && !callback.is_null())
+    callback.Run(num_bytes);
+}
+
 void URLRequestFetchJob::Kill() {
   JsAsker<URLRequestJob>::Kill();
+  weak_factory_.InvalidateWeakPtrs();
+  write_buffer_ = nullptr;
+  write_callback_.Reset();
   fetcher_.reset();
 }
 
 bool URLRequestFetchJob::ReadRawData(net::IOBuffer* dest,
                                      int dest_size,
                                      int* bytes_read) {
+  // Read the data the fetcher has written.
+  if (write_buffer_.get()) {
+    *bytes_read = std::min(write_buffer_->BytesRemaining(), dest_size);
+    memcpy(dest->data(), write_buffer_->data(), *bytes_read);
+    write_buffer_->DidConsume(*bytes_read);
+    if (write_buffer_->BytesRemaining() == 0) {
+      // Complete the write later, it makes the fetcher write again.
+      base::ThreadTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE,
+          base::Bind(&URLRequestFetchJob::OnWriteBufferRead,
+                     weak_factory_.GetWeakPtr(), write_buffer_->size()));
+      write_buffer_ = nullptr;
+    }
+    return true;
+  }
+
   pending_buffer_ = dest;
   pending_buffer_size_ = dest_size;
   SetStatus(net::URLRequestStatus(net::URLRequestStatus::IO_PENDING, 0));
@@ -195,8 +271,9 @@ bool URLRequestFetchJob::GetMimeType(std::string* mime_type) const {
 }
 
 void URLRequestFetchJob::GetResponseInfo(net::HttpResponseInfo* info) {
+  // Only the headers, URLRequest keeps its own request and response times.
   if (response_info_)
-    *info = *response_info_;
+    info->headers = response_info_->headers;
 }
 
 int URLRequestFetchJob::GetResponseCode() const {
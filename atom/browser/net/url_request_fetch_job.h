@@ -8,6 +8,7 @@
 #include <string>
 
 #include "atom/browser/net/js_asker.h"
+#include "net/base/completion_callback.h"
 #include "net/url_request/url_request_context_getter.h"
 #include "net/url_request/url_fetcher_delegate.h"
 #include "net/url_request/url_request_job.h"
@@ -23,7 +24,9 @@ class URLRequestFetchJob : public JsAsker<net::URLRequestJob>,
 
   // Called by response writer.
   void HeadersCompleted();
-  int DataAvailable(net::IOBuffer* buffer, int num_bytes);
+  int DataAvailable(net::IOBuffer* buffer,
+                    int num_bytes,
+                    const net::CompletionCallback& callback);
 
  protected:
   // JsAsker:
@@ -45,12 +48,22 @@ class URLRequestFetchJob : public JsAsker<net::URLRequestJob>,
   // Create a independent request context.
   net::URLRequestContextGetter* CreateRequestContext();
 
+  // Tells the fetcher that the data it wrote has been read.
+  void OnWriteBufferRead(int num_bytes);
+
   scoped_refptr<net::URLRequestContextGetter> url_request_context_getter_;
   scoped_ptr<net::URLFetcher> fetcher_;
   scoped_refptr<net::IOBuffer> pending_buffer_;
   int pending_buffer_size_;
   scoped_ptr<net::HttpResponseInfo> response_info_;
 
+  // The data the fetcher wrote while there was no pending read, the fetcher
+  // does not read more until it has been read.
+  scoped_refptr<net::DrainableIOBuffer> write_buffer_;
+  net::CompletionCallback write_callback_;
+
+  base::WeakPtrFactory<URLRequestFetchJob> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(URLRequestFetchJob);
 };
 
@@ -0,0 +1,392 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_request_stream_job.h"
+
+#include <algorithm>
+#include <string>
+
+#include "atom/browser/net/protocol_stats.h"
+#include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/v8_value_converter.h"
+#include "atom/common/node_includes.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/trace_event/trace_event.h"
+#include "native_mate/dictionary.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
+#include "net/url_request/url_request_status.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace internal {
+
+// The sink the JavaScript stream is written into, it lives on the UI thread
+// and forwards everything to the job on the IO thread.
+class StreamWriter
+    : public base::RefCountedThreadSafe<StreamWriter,
+                                        BrowserThread::DeleteOnUIThread> {
+ public:
+  StreamWriter(const base::WeakPtr<URLRequestStreamJob>& job,
+               const std::string& scheme)
+      : job_(job), scheme_(scheme), responded_(false), aborted_(false) {}
+
+  // Called before the handler runs for a request started at |start_time|.
+  void WillRunHandler(base::TimeTicks start_time) {
+    handler_start_time_ = base::TimeTicks::Now();
+    queue_time_ = handler_start_time_ - start_time;
+  }
+
+  // respond(options[, onRead, onAbort])
+  void Respond(mate::Arguments* args) {
+    if (!responded_) {
+      responded_ = true;
+      ProtocolStats::GetInstance()->RecordHandler(
+          scheme_, queue_time_, base::TimeTicks::Now() - handler_start_time_);
+    }
+
+    scoped_ptr<base::Value> options;
+    v8::Local<v8::Value> value;
+    if (args->GetNext(&value)) {
+      V8ValueConverter converter;
+      v8::Local<v8::Context> context = args->isolate()->GetCurrentContext();
+      options.reset(converter.FromV8Value(value, context));
+    }
+    args->GetNext(&read_callback_);
+    args->GetNext(&abort_callback_);
+
+    // The request may have been cancelled before the handler responded.
+    if (aborted_) {
+      OnAbort();
+      return;
+    }
+
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&URLRequestStreamJob::OnResponse, job_,
+                   base::Passed(&options)));
+  }
+
+  // write(buffer)
+  void Write(mate::Arguments* args) {
+    v8::Local<v8::Value> buffer;
+    if (!args->GetNext(&buffer) || !node::Buffer::HasInstance(buffer)) {
+      args->ThrowError("Must pass a Buffer");
+      return;
+    }
+
+    size_t length = node::Buffer::Length(buffer);
+    if (length == 0)
+      return;
+    scoped_refptr<net::IOBufferWithSize> data(
+        new net::IOBufferWithSize(length));
+    memcpy(data->data(), node::Buffer::Data(buffer), length);
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&URLRequestStreamJob::OnData, job_, data));
+  }
+
+  // end([error])
+  void End(mate::Arguments* args) {
+    int error = net::OK;
+    args->GetNext(&error);
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&URLRequestStreamJob::OnEnd, job_, error));
+  }
+
+  // Called after the job has read |bytes| of the written data.
+  void OnRead(int bytes) {
+    if (!read_callback_.is_null())
+      read_callback_.Run(bytes);
+  }
+
+  // Called when the request has been cancelled.
+  void OnAbort() {
+    aborted_ = true;
+    base::Closure abort_callback = abort_callback_;
+    read_callback_.Reset();
+    abort_callback_.Reset();
+    if (!abort_callback.is_null())
+      abort_callback.Run();
+  }
+
+ private:
+  friend struct BrowserThread::DeleteOnThread<BrowserThread::UI>;
+  friend class base::DeleteHelper<StreamWriter>;
+
+  ~StreamWriter() {}
+
+  // Only dereferenced on the IO thread.
+  base::WeakPtr<URLRequestStreamJob> job_;
+
+  std::string scheme_;
+  base::TimeDelta queue_time_;
+  base::TimeTicks handler_start_time_;
+  bool responded_;
+
+  base::Callback<void(int)> read_callback_;
+  base::Closure abort_callback_;
+  bool aborted_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamWriter);
+};
+
+namespace {
+
+// Call the handler with the sink of |writer| in UI thread.
+void AskForStream(v8::Isolate* isolate,
+                  const JavaScriptHandler& handler,
+                  net::URLRequest* request,
+                  base::TimeTicks start_time,
+                  scoped_refptr<StreamWriter> writer) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  TRACE_EVENT1("electron.protocol", "AskForStream",
+               "url", request->url().spec());
+  writer->WillRunHandler(start_time);
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Context::Scope context_scope(context);
+  mate::Dictionary sink = mate::Dictionary::CreateEmpty(isolate);
+  sink.Set("respond", base::Bind(&StreamWriter::Respond, writer));
+  sink.Set("write", base::Bind(&StreamWriter::Write, writer));
+  sink.Set("end", base::Bind(&StreamWriter::End, writer));
+  handler.Run(request, sink.GetHandle());
+}
+
+}  // namespace
+
+}  // namespace internal
+
+URLRequestStreamJob::URLRequestStreamJob(
+    net::URLRequest* request, net::NetworkDelegate* network_delegate)
+    : net::URLRequestJob(request, network_delegate),
+      isolate_(nullptr),
+      pending_buffer_size_(0),
+      ended_(false),
+      end_error_(net::OK),
+      weak_factory_(this) {
+}
+
+URLRequestStreamJob::~URLRequestStreamJob() {
+}
+
+void URLRequestStreamJob::SetHandlerInfo(
+    v8::Isolate* isolate,
+    net::URLRequestContextGetter* request_context_getter,
+    ProtocolResponseCache* response_cache,
+    const JavaScriptHandler& handler) {
+  isolate_ = isolate;
+  handler_ = handler;
+}
+
+void URLRequestStreamJob::OnResponse(scoped_ptr<base::Value> options) {
+  int error = net::ERR_NOT_IMPLEMENTED;
+  if (!options || internal::IsErrorOptions(options.get(), &error) ||
+      !options->IsType(base::Value::TYPE_DICTIONARY)) {
+    NotifyStartError(
+        net::URLRequestStatus(net::URLRequestStatus::FAILED, error));
+    return;
+  }
+
+  base::DictionaryValue* dict =
+      static_cast<base::DictionaryValue*>(options.get());
+  int status_code = net::HTTP_OK;
+  dict->GetInteger("statusCode", &status_code);
+
+  std::string status("HTTP/1.1 ");
+  status.append(base::IntToString(status_code));
+  status.append(" ");
+  status.append(net::GetHttpReasonPhrase(
+      static_cast<net::HttpStatusCode>(status_code)));
+  status.append("\0\0", 2);
+  net::HttpResponseHeaders* headers = new net::HttpResponseHeaders(status);
+
+  std::string mime_type;
+  if (dict->GetString("mimeType", &mime_type)) {
+    std::string content_type_header(net::HttpRequestHeaders::kContentType);
+    content_type_header.append(": ");
+    content_type_header.append(mime_type);
+    headers->AddHeader(content_type_header);
+  }
+  dict->GetString("charset", &charset_);
+
+  // A header can have a string value or a list of them.
+  base::DictionaryValue* extra_headers = nullptr;
+  if (dict->GetDictionaryWithoutPathExpansion("headers", &extra_headers)) {
+    for (base::DictionaryValue::Iterator it(*extra_headers); !it.IsAtEnd();
+         it.Advance()) {
+      std::string value;
+      const base::ListValue* values = nullptr;
+      if (it.value().GetAsString(&value)) {
+        headers->AddHeader(it.key() + ": " + value);
+      } else if (it.value().GetAsList(&values)) {
+        for (const base::Value* item : *values)
+          if (item->GetAsString(&value))
+            headers->AddHeader(it.key() + ": " + value);
+      }
+    }
+  }
+
+  response_info_.reset(new net::HttpResponseInfo);
+  response_info_->headers = headers;
+  NotifyHeadersComplete();
+}
+
+void URLRequestStreamJob::OnData(scoped_refptr<net::IOBufferWithSize> data) {
+  chunks_.push_back(new net::DrainableIOBuffer(data.get(), data->size()));
+
+  // Do nothing if there's no ReadRawData() operation waiting for IO
+  // completion.
+  if (!pending_buffer_.get())
+    return;
+
+  // Clear the IO_PENDING status.
+  SetStatus(net::URLRequestStatus());
+  int bytes_read = ReadChunks(pending_buffer_.get(), pending_buffer_size_);
+
+  // Clear the buffers before notifying the read is complete, so that it is
+  // safe for the observer to read.
+  pending_buffer_ = nullptr;
+  pending_buffer_size_ = 0;
+
+  NotifyReadComplete(bytes_read);
+}
+
+void URLRequestStreamJob::OnEnd(int error) {
+  ended_ = true;
+  end_error_ = error;
+
+  // The stream ended without the handler responding.
+  if (!response_info_) {
+    NotifyStartError(net::URLRequestStatus(
+        net::URLRequestStatus::FAILED,
+        error == net::OK ? net::ERR_EMPTY_RESPONSE : error));
+    return;
+  }
+
+  if (!pending_buffer_.get())
+    return;
+
+  pending_buffer_ = nullptr;
+  pending_buffer_size_ = 0;
+  if (error == net::OK) {
+    SetStatus(net::URLRequestStatus());
+    NotifyReadComplete(0);
+  } else {
+    NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED, error));
+  }
+}
+
+void URLRequestStreamJob::Start() {
+  writer_ = new internal::StreamWriter(weak_factory_.GetWeakPtr(),
+                                       request()->url().scheme());
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&internal::AskForStream,
+                 isolate_, handler_, request(), base::TimeTicks::Now(),
+                 writer_));
+}
+
+void URLRequestStreamJob::Kill() {
+  // Stop the writes that are still on their way and the stream.
+  weak_factory_.InvalidateWeakPtrs();
+  if (writer_.get()) {
+    BrowserThread::PostTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(&internal::StreamWriter::OnAbort, writer_));
+    writer_ = nullptr;
+  }
+  chunks_.clear();
+  net::URLRequestJob::Kill();
+}
+
+bool URLRequestStreamJob::ReadRawData(net::IOBuffer* dest,
+                                      int dest_size,
+                                      int* bytes_read) {
+  if (!chunks_.empty()) {
+    *bytes_read = ReadChunks(dest, dest_size);
+    return true;
+  }
+
+  if (ended_) {
+    if (end_error_ != net::OK) {
+      NotifyDone(
+          net::URLRequestStatus(net::URLRequestStatus::FAILED, end_error_));
+      return false;
+    }
+    *bytes_read = 0;
+    return true;
+  }
+
+  // Wait for the next chunk.
+  pending_buffer_ = dest;
+  pending_buffer_size_ = dest_size;
+  SetStatus(net::URLRequestStatus(net::URLRequestStatus::IO_PENDING, 0));
+  return false;
+}
+
+bool URLRequestStreamJob::GetMimeType(std::string* mime_type) const {
+  if (!response_info_)
+    return false;
+
+  return response_info_->headers->GetMimeType(mime_type);
+}
+
+bool URLRequestStreamJob::GetCharset(std::string* charset) {
+  if (!charset_.empty()) {
+    *charset = charset_;
+    return true;
+  }
+
+  if (!response_info_)
+    return false;
+
+  return response_info_->headers->GetCharset(charset);
+}
+
+void URLRequestStreamJob::GetResponseInfo(net::HttpResponseInfo* info) {
+  // Only the headers, URLRequest keeps its own request and response times.
+  if (response_info_)
+    info->headers = response_info_->headers;
+}
+
+int URLRequestStreamJob::GetResponseCode() const {
+  if (!response_info_)
+    return -1;
+
+  return response_info_->headers->response_code();
+}
+
+void URLRequestStreamJob::DoneReading() {
+  net::URLRequestJob::DoneReading();
+  ProtocolStats::GetInstance()->RecordResponse(request(),
+                                             prefilter_bytes_read());
+}
+
+int URLRequestStreamJob::ReadChunks(net::IOBuffer* buf, int buf_size) {
+  int bytes_read = 0;
+  while (bytes_read < buf_size && !chunks_.empty()) {
+    net::DrainableIOBuffer* chunk = chunks_.front().get();
+    int size = std::min(chunk->BytesRemaining(), buf_size - bytes_read);
+    memcpy(buf->data() + bytes_read, chunk->data(), size);
+    chunk->DidConsume(size);
+    bytes_read += size;
+    if (chunk->BytesRemaining() == 0)
+      chunks_.pop_front();
+  }
+
+  if (writer_.get())
+    BrowserThread::PostTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(&internal::StreamWriter::OnRead, writer_, bytes_read));
+  return bytes_read;
+}
+
+}  // namespace atom
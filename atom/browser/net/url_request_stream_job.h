@@ -0,0 +1,88 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+#define ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+
+#include <deque>
+#include <string>
+
+#include "atom/browser/net/js_asker.h"
+#include "base/memory/weak_ptr.h"
+#include "net/base/io_buffer.h"
+#include "net/url_request/url_request_job.h"
+
+namespace atom {
+
+namespace internal {
+class StreamWriter;
+}
+
+// Sends the response of a JavaScript stream, the status and headers are sent
+// as soon as the handler responds and the body follows in chunks as they are
+// written on the UI thread.
+//
+// The writer is told how many bytes have been read after each read, so the
+// JavaScript side can stop the stream while too much data is queued here.
+class URLRequestStreamJob : public net::URLRequestJob {
+ public:
+  URLRequestStreamJob(net::URLRequest*, net::NetworkDelegate*);
+
+  // Called by |CustomProtocolHandler| to store handler related information.
+  void SetHandlerInfo(
+      v8::Isolate* isolate,
+      net::URLRequestContextGetter* request_context_getter,
+      ProtocolResponseCache* response_cache,
+      const JavaScriptHandler& handler);
+
+  // Called by the writer on the IO thread.
+  void OnResponse(scoped_ptr<base::Value> options);
+  void OnData(scoped_refptr<net::IOBufferWithSize> data);
+  void OnEnd(int error);
+
+ protected:
+  ~URLRequestStreamJob() override;
+
+  // net::URLRequestJob:
+  void Start() override;
+  void Kill() override;
+  bool ReadRawData(net::IOBuffer* buf,
+                   int buf_size,
+                   int* bytes_read) override;
+  bool GetMimeType(std::string* mime_type) const override;
+  bool GetCharset(std::string* charset) override;
+  void GetResponseInfo(net::HttpResponseInfo* info) override;
+  int GetResponseCode() const override;
+  void DoneReading() override;
+
+ private:
+  // Copies the queued chunks into |buf| and tells the writer about it.
+  int ReadChunks(net::IOBuffer* buf, int buf_size);
+
+  v8::Isolate* isolate_;
+  JavaScriptHandler handler_;
+
+  scoped_refptr<internal::StreamWriter> writer_;
+
+  scoped_ptr<net::HttpResponseInfo> response_info_;
+  std::string charset_;
+
+  // The chunks that have been written but not read yet.
+  std::deque<scoped_refptr<net::DrainableIOBuffer>> chunks_;
+
+  // The buffer of the read that is waiting for data.
+  scoped_refptr<net::IOBuffer> pending_buffer_;
+  int pending_buffer_size_;
+
+  bool ended_;
+  int end_error_;
+
+  base::WeakPtrFactory<URLRequestStreamJob> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestStreamJob);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
@@ -6,13 +6,15 @@
 
 #include <string>
 
+#include "atom/browser/net/byte_range_headers.h"
 #include "net/base/net_errors.h"
 
 namespace atom {
 
 URLRequestStringJob::URLRequestStringJob(
     net::URLRequest* request, net::NetworkDelegate* network_delegate)
-    : JsAsker<net::URLRequestSimpleJob>(request, network_delegate) {
+    : JsAsker<net::URLRequestSimpleJob>(request, network_delegate),
+      cached_(false) {
 }
 
 void URLRequestStringJob::StartAsync(scoped_ptr<base::Value> options) {
@@ -22,6 +24,16 @@ void URLRequestStringJob::StartAsync(scoped_ptr<base::Value> options) {
     dict->GetString("mimeType", &mime_type_);
     dict->GetString("charset", &charset_);
     dict->GetString("data", &data_);
+
+    // Keep the response for the next requests.
+    if (ProtocolResponseCache::ParseCacheOptions(dict, &cache_entry_)) {
+      cached_ = true;
+      std::string data(data_);
+      cache_entry_.data = base::RefCountedString::TakeString(&data);
+      cache_entry_.mime_type = mime_type_;
+      cache_entry_.charset = charset_;
+      response_cache()->Put(request(), cache_entry_);
+    }
   } else if (options->IsType(base::Value::TYPE_STRING)) {
     options->GetAsString(&data_);
   }
@@ -29,8 +41,8 @@ void URLRequestStringJob::StartAsync(scoped_ptr<base::Value> options) {
 }
 
 void URLRequestStringJob::GetResponseInfo(net::HttpResponseInfo* info) {
-  std::string status("HTTP/1.1 200 OK");
-  net::HttpResponseHeaders* headers = new net::HttpResponseHeaders(status);
+  net::HttpResponseHeaders* headers =
+      CreateResponseHeaders(net::HTTP_OK, ranges(), data_.size());
 
   if (!mime_type_.empty()) {
     std::string content_type_header(net::HttpRequestHeaders::kContentType);
@@ -39,6 +51,9 @@ void URLRequestStringJob::GetResponseInfo(net::HttpResponseInfo* info) {
     headers->AddHeader(content_type_header);
   }
 
+  if (cached_)
+    ProtocolResponseCache::AddCacheHeaders(cache_entry_, headers);
+
   info->headers = headers;
 }
 
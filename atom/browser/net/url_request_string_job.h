@@ -32,6 +32,8 @@ class URLRequestStringJob : public JsAsker<net::URLRequestSimpleJob> {
   std::string mime_type_;
   std::string charset_;
   std::string data_;
+  bool cached_;
+  ProtocolResponseCache::Entry cache_entry_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestStringJob);
 };
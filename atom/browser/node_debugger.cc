@@ -9,10 +9,16 @@
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
-#include "content/public/browser/browser_thread.h"
-#include "net/test/embedded_test_server/tcp_listen_socket.h"
+#include "base/time/time.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "net/socket/stream_socket.h"
+#include "net/socket/tcp_server_socket.h"
 
 #include "atom/common/node_includes.h"
 
@@ -26,13 +32,20 @@ const int kIsolateSlot = 2;
 
 const char* kContentLength = "Content-Length";
 
+const int kReadBufferSize = 64 * 1024;
+
+// A failed accept is retried after 100ms, doubled for each error in a row,
+// and the server stops listening after 8 errors in a row.
+const int kAcceptRetryDelayMs = 100;
+const int kMaxAcceptErrors = 8;
+
 }  // namespace
 
 NodeDebugger::NodeDebugger(v8::Isolate* isolate)
     : isolate_(isolate),
       thread_("NodeDebugger"),
-      content_length_(-1),
-      weak_factory_(this) {
+      accept_errors_(0),
+      content_length_(-1) {
   bool use_debug_agent = false;
   int port = 5858;
 
@@ -63,16 +76,22 @@ NodeDebugger::NodeDebugger(v8::Isolate* isolate)
       return;
     }
 
-    // Start the server in new IO thread.
+    // Start the server in new IO thread. The thread is stopped before this
+    // object goes away, so it is safe to post unretained tasks to it.
     thread_.message_loop()->PostTask(
         FROM_HERE,
-        base::Bind(&NodeDebugger::StartServer, weak_factory_.GetWeakPtr(),
-                   port));
+        base::Bind(&NodeDebugger::StartServer, base::Unretained(this), port));
   }
 }
 
 NodeDebugger::~NodeDebugger() {
-  thread_.Stop();
+  if (thread_.IsRunning()) {
+    // The sockets have to be closed on the thread they were used on.
+    thread_.message_loop()->PostTask(
+        FROM_HERE,
+        base::Bind(&NodeDebugger::StopServer, base::Unretained(this)));
+    thread_.Stop();
+  }
 }
 
 bool NodeDebugger::IsRunning() const {
@@ -80,16 +99,191 @@ bool NodeDebugger::IsRunning() const {
 }
 
 void NodeDebugger::StartServer(int port) {
-  server_ = net::test_server::TCPListenSocket::CreateAndListen(
-      "127.0.0.1", port, this);
-  if (!server_) {
+  net::IPAddressNumber address;
+  if (!net::ParseIPLiteralToNumber("127.0.0.1", &address))
+    return;
+
+  server_.reset(new net::TCPServerSocket(nullptr, net::NetLog::Source()));
+  if (server_->Listen(net::IPEndPoint(address, port), 1) != net::OK) {
     LOG(ERROR) << "Cannot start debugger server";
+    server_.reset();
     return;
   }
+
+  read_buffer_ = new net::IOBuffer(kReadBufferSize);
+  DoAccept();
+}
+
+void NodeDebugger::StopServer() {
+  CloseSession();
+  pending_socket_.reset();
+  server_.reset();
+}
+
+void NodeDebugger::DoAccept() {
+  while (server_) {
+    int result = server_->Accept(
+        &pending_socket_,
+        base::Bind(&NodeDebugger::OnAccepted, base::Unretained(this)));
+    if (result == net::ERR_IO_PENDING || !HandleAccept(result))
+      return;
+  }
+}
+
+void NodeDebugger::OnAccepted(int result) {
+  if (HandleAccept(result))
+    DoAccept();
+}
+
+bool NodeDebugger::HandleAccept(int result) {
+  if (result != net::OK) {
+    pending_socket_.reset();
+    if (++accept_errors_ >= kMaxAcceptErrors) {
+      LOG(ERROR) << "Debugger server stopped after accept errors: "
+                 << net::ErrorToString(result);
+      server_.reset();
+      return false;
+    }
+
+    // The thread is stopped before this object goes away, which drops the
+    // delayed task.
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&NodeDebugger::DoAccept, base::Unretained(this)),
+        base::TimeDelta::FromMilliseconds(
+            kAcceptRetryDelayMs << (accept_errors_ - 1)));
+    return false;
+  }
+  accept_errors_ = 0;
+
+  // Only accept one session.
+  if (accepted_socket_) {
+    pending_socket_.reset();
+    return true;
+  }
+
+  accepted_socket_ = pending_socket_.Pass();
+  SendConnectMessage();
+  DoRead();
+  return true;
+}
+
+void NodeDebugger::DoRead() {
+  while (accepted_socket_) {
+    int result = accepted_socket_->Read(
+        read_buffer_.get(), kReadBufferSize,
+        base::Bind(&NodeDebugger::OnRead, base::Unretained(this)));
+    if (result == net::ERR_IO_PENDING || !HandleRead(result))
+      return;
+  }
+}
+
+void NodeDebugger::OnRead(int result) {
+  if (HandleRead(result))
+    DoRead();
+}
+
+bool NodeDebugger::HandleRead(int result) {
+  if (result <= 0) {
+    OnConnectionLost();
+    return false;
+  }
+
+  buffer_.append(read_buffer_->data(), result);
+  ParseMessages();
+  return accepted_socket_ != nullptr;
+}
+
+void NodeDebugger::DoWrite() {
+  while (accepted_socket_) {
+    if (!write_buffer_) {
+      if (pending_write_.empty())
+        return;
+      scoped_refptr<net::StringIOBuffer> data =
+          new net::StringIOBuffer(pending_write_);
+      pending_write_.clear();
+      write_buffer_ = new net::DrainableIOBuffer(data.get(), data->size());
+    }
+
+    int result = accepted_socket_->Write(
+        write_buffer_.get(), write_buffer_->BytesRemaining(),
+        base::Bind(&NodeDebugger::OnWritten, base::Unretained(this)));
+    if (result == net::ERR_IO_PENDING || !HandleWrite(result))
+      return;
+  }
+}
+
+void NodeDebugger::OnWritten(int result) {
+  if (HandleWrite(result))
+    DoWrite();
+}
+
+bool NodeDebugger::HandleWrite(int result) {
+  if (result < 0) {
+    OnConnectionLost();
+    return false;
+  }
+
+  write_buffer_->DidConsume(result);
+  if (write_buffer_->BytesRemaining() == 0)
+    write_buffer_ = nullptr;
+  return true;
+}
+
+void NodeDebugger::ParseMessages() {
+  size_t offset = 0;
+  while (true) {
+    // Read the "Content-Length: xxx" header.
+    if (content_length_ < 0) {
+      size_t end = buffer_.find("\r\n\r\n", offset);
+      if (end == std::string::npos)
+        break;
+
+      size_t start = buffer_.find(kContentLength, offset);
+      if (start == std::string::npos || start > end) {
+        OnConnectionLost();
+        return;
+      }
+      start += strlen(kContentLength) + 1;
+      std::string content_length;
+      base::TrimWhitespaceASCII(buffer_.substr(start, end - start),
+                                base::TRIM_ALL, &content_length);
+      if (!base::StringToInt(content_length, &content_length_) ||
+          content_length_ < 0) {
+        OnConnectionLost();
+        return;
+      }
+      offset = end + 4;
+    }
+
+    // Read the message.
+    if (buffer_.size() - offset < static_cast<size_t>(content_length_))
+      break;
+    std::string message = buffer_.substr(offset, content_length_);
+    offset += content_length_;
+    content_length_ = -1;
+
+    OnMessage(message);
+    // The session ended with the message.
+    if (!accepted_socket_)
+      return;
+  }
+
+  buffer_.erase(0, offset);
 }
 
 void NodeDebugger::CloseSession() {
   accepted_socket_.reset();
+  write_buffer_ = nullptr;
+  pending_write_.clear();
+  buffer_.clear();
+  content_length_ = -1;
+}
+
+void NodeDebugger::OnConnectionLost() {
+  // If we lost the connection, then simulate a disconnect msg:
+  OnMessage("{\"seq\":1,\"type\":\"request\",\"command\":\"disconnect\"}");
+  CloseSession();
 }
 
 void NodeDebugger::OnMessage(const std::string& message) {
@@ -97,6 +291,8 @@ void NodeDebugger::OnMessage(const std::string& message) {
           std::string::npos)
     CloseSession();
 
+  // V8 breaks into running JavaScript to process the command, and the async
+  // handle makes the main thread process it when no JavaScript is running.
   base::string16 message16 = base::UTF8ToUTF16(message);
   v8::Debug::SendCommand(
       isolate_,
@@ -105,23 +301,27 @@ void NodeDebugger::OnMessage(const std::string& message) {
   uv_async_send(&weak_up_ui_handle_);
 }
 
+void NodeDebugger::Send(const std::string& data) {
+  if (!accepted_socket_)
+    return;
+  pending_write_.append(data);
+  if (!write_buffer_)
+    DoWrite();
+}
+
 void NodeDebugger::SendMessage(const std::string& message) {
-  if (accepted_socket_) {
-    std::string header = base::StringPrintf(
-        "%s: %d\r\n\r\n", kContentLength, static_cast<int>(message.size()));
-    accepted_socket_->Send(header);
-    accepted_socket_->Send(message);
-  }
+  Send(base::StringPrintf("%s: %d\r\n\r\n%s", kContentLength,
+                          static_cast<int>(message.size()), message.c_str()));
 }
 
 void NodeDebugger::SendConnectMessage() {
-  accepted_socket_->Send(base::StringPrintf(
+  Send(base::StringPrintf(
       "Type: connect\r\n"
       "V8-Version: %s\r\n"
       "Protocol-Version: 1\r\n"
       "Embedding-Host: %s\r\n"
-      "%s: 0\r\n",
-      v8::V8::GetVersion(), ATOM_PRODUCT_NAME, kContentLength), true);
+      "%s: 0\r\n\r\n",
+      v8::V8::GetVersion(), ATOM_PRODUCT_NAME, kContentLength));
 }
 
 // static
@@ -134,70 +334,13 @@ void NodeDebugger::DebugMessageHandler(const v8::Debug::Message& message) {
   NodeDebugger* self = static_cast<NodeDebugger*>(
       message.GetIsolate()->GetData(kIsolateSlot));
 
-  if (self) {
+  if (self && self->thread_.IsRunning()) {
     std::string message8(*v8::String::Utf8Value(message.GetJSON()));
     self->thread_.message_loop()->PostTask(
         FROM_HERE,
-        base::Bind(&NodeDebugger::SendMessage, self->weak_factory_.GetWeakPtr(),
+        base::Bind(&NodeDebugger::SendMessage, base::Unretained(self),
                    message8));
   }
 }
 
-void NodeDebugger::DidAccept(
-    net::test_server::StreamListenSocket* server,
-    scoped_ptr<net::test_server::StreamListenSocket> socket) {
-  // Only accept one session.
-  if (accepted_socket_) {
-    socket->Send(std::string("Remote debugging session already active"), true);
-    return;
-  }
-
-  accepted_socket_ = socket.Pass();
-  SendConnectMessage();
-}
-
-void NodeDebugger::DidRead(net::test_server::StreamListenSocket* socket,
-                           const char* data,
-                           int len) {
-  buffer_.append(data, len);
-
-  do {
-    if (buffer_.size() == 0)
-      return;
-
-    // Read the "Content-Length" header.
-    if (content_length_ < 0) {
-      size_t pos = buffer_.find("\r\n\r\n");
-      if (pos == std::string::npos)
-        return;
-
-      // We can be sure that the header is "Content-Length: xxx\r\n".
-      std::string content_length = buffer_.substr(16, pos - 16);
-      if (!base::StringToInt(content_length, &content_length_)) {
-        DidClose(accepted_socket_.get());
-        return;
-      }
-
-      // Strip header from buffer.
-      buffer_ = buffer_.substr(pos + 4);
-    }
-
-    // Read the message.
-    if (buffer_.size() >= static_cast<size_t>(content_length_)) {
-      std::string message = buffer_.substr(0, content_length_);
-      buffer_ = buffer_.substr(content_length_);
-
-      OnMessage(message);
-
-      // Get ready for next message.
-      content_length_ = -1;
-    }
-  } while (true);
-}
-
-void NodeDebugger::DidClose(net::test_server::StreamListenSocket* socket) {
-  // If we lost the connection, then simulate a disconnect msg:
-  OnMessage("{\"seq\":1,\"type\":\"request\",\"command\":\"disconnect\"}");
-}
-
 }  // namespace atom
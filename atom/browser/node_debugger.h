@@ -7,17 +7,27 @@
 
 #include <string>
 
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
-#include "base/memory/weak_ptr.h"
 #include "base/threading/thread.h"
-#include "net/test/embedded_test_server/stream_listen_socket.h"
 #include "v8/include/v8-debug.h"
 #include "vendor/node/deps/uv/include/uv.h"
 
+namespace net {
+class DrainableIOBuffer;
+class IOBuffer;
+class ServerSocket;
+class StreamSocket;
+}
+
 namespace atom {
 
 // Add support for node's "--debug" switch.
-class NodeDebugger : public net::test_server::StreamListenSocket::Delegate {
+//
+// The sockets live on the debugger's own IO thread, which only hands the
+// commands to V8. V8 interrupts running JavaScript to process them, and the
+// uv async handle wakes the main thread when it is idle.
+class NodeDebugger {
  public:
   explicit NodeDebugger(v8::Isolate* isolate);
   virtual ~NodeDebugger();
@@ -25,9 +35,23 @@ class NodeDebugger : public net::test_server::StreamListenSocket::Delegate {
   bool IsRunning() const;
 
  private:
+  // All of these run on the IO thread.
   void StartServer(int port);
+  void StopServer();
+  void DoAccept();
+  void OnAccepted(int result);
+  bool HandleAccept(int result);
+  void DoRead();
+  void OnRead(int result);
+  bool HandleRead(int result);
+  void DoWrite();
+  void OnWritten(int result);
+  bool HandleWrite(int result);
+  void ParseMessages();
   void CloseSession();
+  void OnConnectionLost();
   void OnMessage(const std::string& message);
+  void Send(const std::string& data);
   void SendMessage(const std::string& message);
   void SendConnectMessage();
 
@@ -35,27 +59,25 @@ class NodeDebugger : public net::test_server::StreamListenSocket::Delegate {
 
   static void DebugMessageHandler(const v8::Debug::Message& message);
 
-  // net::test_server::StreamListenSocket::Delegate:
-  void DidAccept(
-      net::test_server::StreamListenSocket* server,
-      scoped_ptr<net::test_server::StreamListenSocket> socket) override;
-  void DidRead(net::test_server::StreamListenSocket* socket,
-               const char* data,
-               int len) override;
-  void DidClose(net::test_server::StreamListenSocket* socket) override;
-
   v8::Isolate* isolate_;
 
   uv_async_t weak_up_ui_handle_;
 
   base::Thread thread_;
-  scoped_ptr<net::test_server::StreamListenSocket> server_;
-  scoped_ptr<net::test_server::StreamListenSocket> accepted_socket_;
+  scoped_ptr<net::ServerSocket> server_;
+  scoped_ptr<net::StreamSocket> pending_socket_;
+  scoped_ptr<net::StreamSocket> accepted_socket_;
+
+  // The accept errors in a row, which delay the next accept.
+  int accept_errors_;
 
+  scoped_refptr<net::IOBuffer> read_buffer_;
   std::string buffer_;
   int content_length_;
 
-  base::WeakPtrFactory<NodeDebugger> weak_factory_;
+  // The data being written, and what has been sent meanwhile.
+  scoped_refptr<net::DrainableIOBuffer> write_buffer_;
+  std::string pending_write_;
 
   DISALLOW_COPY_AND_ASSIGN(NodeDebugger);
 };
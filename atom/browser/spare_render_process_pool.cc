@@ -0,0 +1,172 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/spare_render_process_pool.h"
+
+#include "atom/browser/web_contents_preferences.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/site_instance.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// The spare processes are launched again a while after one is used, so the
+// launch does not compete with the page that got it.
+const int kRefillDelayMs = 2000;
+
+// The switches that the default web preferences give.
+void AppendDefaultSwitches(base::CommandLine* command_line) {
+  WebContentsPreferences::AppendExtraCommandLineSwitches(
+      base::DictionaryValue(), command_line);
+}
+
+}  // namespace
+
+// static
+SpareRenderProcessPool* SpareRenderProcessPool::instance_ = nullptr;
+
+// static
+SpareRenderProcessPool* SpareRenderProcessPool::GetInstance() {
+  if (!instance_)
+    instance_ = new SpareRenderProcessPool;
+  return instance_;
+}
+
+SpareRenderProcessPool::SpareRenderProcessPool()
+    : browser_context_(nullptr),
+      count_(0),
+      refill_scheduled_(false),
+      weak_factory_(this) {
+}
+
+SpareRenderProcessPool::~SpareRenderProcessPool() {
+}
+
+void SpareRenderProcessPool::SetCount(content::BrowserContext* browser_context,
+                                      int count) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (browser_context != browser_context_)
+    Clear();
+
+  browser_context_ = browser_context;
+  count_ = count > 0 ? count : 0;
+  while (spares_.size() > count_)
+    Remove(spares_.size() - 1, true);
+  Refill();
+}
+
+void SpareRenderProcessPool::Relaunch() {
+  if (spares_.empty())
+    return;
+
+  while (!spares_.empty())
+    Remove(spares_.size() - 1, true);
+  Refill();
+}
+
+void SpareRenderProcessPool::Clear() {
+  count_ = 0;
+  while (!spares_.empty())
+    Remove(spares_.size() - 1, true);
+}
+
+content::SiteInstance* SpareRenderProcessPool::Take(
+    content::BrowserContext* browser_context,
+    content::WebContents* web_contents) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (spares_.empty() || browser_context != browser_context_ || !web_contents)
+    return nullptr;
+
+  base::CommandLine switches(base::CommandLine::NO_PROGRAM);
+  WebContentsPreferences::AppendExtraCommandLineSwitches(web_contents,
+                                                         &switches);
+  base::CommandLine default_switches(base::CommandLine::NO_PROGRAM);
+  AppendDefaultSwitches(&default_switches);
+  if (switches.GetSwitches() != default_switches.GetSwitches())
+    return nullptr;
+
+  // The reference of the pool is handed to a task, so the SiteInstance lives
+  // until the navigation has taken its own.
+  content::SiteInstance* instance = spares_.back().instance.get();
+  instance->AddRef();
+  BrowserThread::ReleaseSoon(BrowserThread::UI, FROM_HERE, instance);
+  Remove(spares_.size() - 1, false);
+
+  ScheduleRefill();
+  return instance;
+}
+
+bool SpareRenderProcessPool::AppendExtraCommandLineSwitches(
+    int process_id, base::CommandLine* command_line) {
+  for (const Spare& spare : spares_) {
+    if (spare.host->GetID() == process_id) {
+      AppendDefaultSwitches(command_line);
+      return true;
+    }
+  }
+  return false;
+}
+
+void SpareRenderProcessPool::RenderProcessExited(
+    content::RenderProcessHost* host,
+    base::TerminationStatus status,
+    int exit_code) {
+  RenderProcessHostDestroyed(host);
+}
+
+void SpareRenderProcessPool::RenderProcessHostDestroyed(
+    content::RenderProcessHost* host) {
+  for (size_t i = 0; i < spares_.size(); ++i) {
+    if (spares_[i].host == host) {
+      Remove(i, false);
+      ScheduleRefill();
+      return;
+    }
+  }
+}
+
+void SpareRenderProcessPool::Refill() {
+  refill_scheduled_ = false;
+  while (browser_context_ && spares_.size() < count_) {
+    Spare spare;
+    spare.instance = content::SiteInstance::Create(browser_context_);
+    spare.host = spare.instance->GetProcess();
+    spare.host->AddObserver(this);
+    // The process must be in the pool when it is launched, to get the
+    // switches of the spare processes.
+    spares_.push_back(spare);
+    if (!spare.host->Init()) {
+      Remove(spares_.size() - 1, false);
+      return;
+    }
+  }
+}
+
+void SpareRenderProcessPool::ScheduleRefill() {
+  if (refill_scheduled_ || spares_.size() >= count_)
+    return;
+
+  refill_scheduled_ = true;
+  BrowserThread::PostDelayedTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&SpareRenderProcessPool::Refill, weak_factory_.GetWeakPtr()),
+      base::TimeDelta::FromMilliseconds(kRefillDelayMs));
+}
+
+void SpareRenderProcessPool::Remove(size_t index, bool cleanup) {
+  content::RenderProcessHost* host = spares_[index].host;
+  host->RemoveObserver(this);
+  spares_.erase(spares_.begin() + index);
+  if (cleanup)
+    host->Cleanup();
+}
+
+}  // namespace atom
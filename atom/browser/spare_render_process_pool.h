@@ -0,0 +1,98 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_SPARE_RENDER_PROCESS_POOL_H_
+#define ATOM_BROWSER_SPARE_RENDER_PROCESS_POOL_H_
+
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "content/public/browser/render_process_host_observer.h"
+
+namespace base {
+class CommandLine;
+}
+
+namespace content {
+class BrowserContext;
+class SiteInstance;
+class WebContents;
+}
+
+namespace atom {
+
+// Keeps renderer processes launched ahead of time, so the next WebContents
+// that navigates does not wait for a renderer to start.
+//
+// A spare process is launched with the switches of the default web
+// preferences, only the WebContents whose preferences give the same switches
+// can use it.
+class SpareRenderProcessPool : public content::RenderProcessHostObserver {
+ public:
+  static SpareRenderProcessPool* GetInstance();
+
+  // Keeps |count| spare processes for |browser_context|.
+  void SetCount(content::BrowserContext* browser_context, int count);
+
+  // Relaunches the spare processes, when the switches they should have are
+  // changed.
+  void Relaunch();
+
+  // Removes all the spare processes.
+  void Clear();
+
+  // Returns a SiteInstance whose process is a spare process that can be used
+  // by the navigation of |web_contents|, returns null when there is none.
+  //
+  // The returned SiteInstance is not referenced, the reference of the pool is
+  // released soon after.
+  content::SiteInstance* Take(content::BrowserContext* browser_context,
+                              content::WebContents* web_contents);
+
+  // Appends the switches of |process_id| if it is a spare process, returns
+  // false when it is not.
+  bool AppendExtraCommandLineSwitches(int process_id,
+                                      base::CommandLine* command_line);
+
+  // content::RenderProcessHostObserver:
+  void RenderProcessExited(content::RenderProcessHost* host,
+                           base::TerminationStatus status,
+                           int exit_code) override;
+  void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
+
+ private:
+  SpareRenderProcessPool();
+  ~SpareRenderProcessPool() override;
+
+  // Launches the missing spare processes.
+  void Refill();
+  void ScheduleRefill();
+
+  // Stops observing the process of |spares_[index]| and removes it, the
+  // unused process is shut down when |cleanup| is true.
+  void Remove(size_t index, bool cleanup);
+
+  struct Spare {
+    scoped_refptr<content::SiteInstance> instance;
+    // The SiteInstance forgets its process when it is destroyed, so it is
+    // remembered here.
+    content::RenderProcessHost* host;
+  };
+
+  content::BrowserContext* browser_context_;
+  size_t count_;
+  std::vector<Spare> spares_;
+  bool refill_scheduled_;
+
+  base::WeakPtrFactory<SpareRenderProcessPool> weak_factory_;
+
+  static SpareRenderProcessPool* instance_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpareRenderProcessPool);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_SPARE_RENDER_PROCESS_POOL_H_
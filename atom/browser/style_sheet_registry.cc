@@ -0,0 +1,49 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/style_sheet_registry.h"
+
+#include "atom/common/api/api_messages.h"
+#include "base/stl_util.h"
+#include "content/public/browser/render_process_host.h"
+
+namespace atom {
+
+// static
+StyleSheetRegistry* StyleSheetRegistry::instance_ = nullptr;
+
+// static
+StyleSheetRegistry* StyleSheetRegistry::GetInstance() {
+  if (!instance_)
+    instance_ = new StyleSheetRegistry;
+  return instance_;
+}
+
+StyleSheetRegistry::StyleSheetRegistry() {
+}
+
+StyleSheetRegistry::~StyleSheetRegistry() {
+}
+
+void StyleSheetRegistry::Register(const std::string& id,
+                                  const std::string& css) {
+  style_sheets_[id] = css;
+  for (auto it = content::RenderProcessHost::AllHostsIterator();
+       !it.IsAtEnd(); it.Advance())
+    it.GetCurrentValue()->Send(new AtomMsg_RegisterStyleSheet(id, css));
+}
+
+bool StyleSheetRegistry::IsRegistered(const std::string& id) const {
+  return ContainsKey(style_sheets_, id);
+}
+
+void StyleSheetRegistry::RenderProcessWillLaunch(
+    content::RenderProcessHost* host) {
+  // The messages are queued until the channel is connected.
+  for (const auto& style_sheet : style_sheets_)
+    host->Send(new AtomMsg_RegisterStyleSheet(style_sheet.first,
+                                              style_sheet.second));
+}
+
+}  // namespace atom
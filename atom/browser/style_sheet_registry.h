@@ -0,0 +1,46 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_STYLE_SHEET_REGISTRY_H_
+#define ATOM_BROWSER_STYLE_SHEET_REGISTRY_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+
+namespace content {
+class RenderProcessHost;
+}
+
+namespace atom {
+
+// The style sheets of WebContents.registerStyleSheet. Each renderer process
+// gets the text of a sheet once, the pages then insert it by its id.
+class StyleSheetRegistry {
+ public:
+  static StyleSheetRegistry* GetInstance();
+
+  // Adds or replaces the sheet of |id| in all the renderers.
+  void Register(const std::string& id, const std::string& css);
+
+  bool IsRegistered(const std::string& id) const;
+
+  // Sends the registered sheets to a new renderer.
+  void RenderProcessWillLaunch(content::RenderProcessHost* host);
+
+ private:
+  StyleSheetRegistry();
+  ~StyleSheetRegistry();
+
+  static StyleSheetRegistry* instance_;
+
+  std::map<std::string, std::string> style_sheets_;
+
+  DISALLOW_COPY_AND_ASSIGN(StyleSheetRegistry);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_STYLE_SHEET_REGISTRY_H_
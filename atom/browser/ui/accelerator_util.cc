@@ -10,7 +10,8 @@
 #include <vector>
 
 #include "atom/common/keyboad_util.h"
-#include "base/stl_util.h"
+#include "base/containers/hash_tables.h"
+#include "base/lazy_instance.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
@@ -18,8 +19,19 @@
 
 namespace accelerator_util {
 
-bool StringToAccelerator(const std::string& description,
-                         ui::Accelerator* accelerator) {
+namespace {
+
+// The accelerators parsed before, keyed by their strings. Menus are rebuilt
+// with the same few accelerators over and over, so the cache is only cleared
+// when an app keeps inventing new ones.
+typedef base::hash_map<std::string, ui::Accelerator> AcceleratorCache;
+base::LazyInstance<AcceleratorCache> g_accelerator_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+const size_t kMaxCachedAccelerators = 1024;
+
+bool ParseAccelerator(const std::string& description,
+                      ui::Accelerator* accelerator) {
   if (!base::IsStringASCII(description)) {
     LOG(ERROR) << "The accelerator string can only contain ASCII characters";
     return false;
@@ -130,6 +142,26 @@ bool StringToAccelerator(const std::string& description,
   return true;
 }
 
+}  // namespace
+
+bool StringToAccelerator(const std::string& description,
+                         ui::Accelerator* accelerator) {
+  AcceleratorCache& cache = g_accelerator_cache.Get();
+  AcceleratorCache::const_iterator iter = cache.find(description);
+  if (iter != cache.end()) {
+    *accelerator = iter->second;
+    return true;
+  }
+
+  if (!ParseAccelerator(description, accelerator))
+    return false;
+
+  if (cache.size() >= kMaxCachedAccelerators)
+    cache.clear();
+  cache[description] = *accelerator;
+  return true;
+}
+
 void GenerateAcceleratorTable(AcceleratorTable* table, ui::MenuModel* model) {
   int count = model->GetItemCount();
   for (int i = 0; i < count; ++i) {
@@ -149,13 +181,12 @@ void GenerateAcceleratorTable(AcceleratorTable* table, ui::MenuModel* model) {
 
 bool TriggerAcceleratorTableCommand(AcceleratorTable* table,
                                     const ui::Accelerator& accelerator) {
-  if (ContainsKey(*table, accelerator)) {
-    const accelerator_util::MenuItem& item = (*table)[accelerator];
-    item.model->ActivatedAt(item.position);
-    return true;
-  } else {
+  AcceleratorTable::const_iterator iter = table->find(accelerator);
+  if (iter == table->end())
     return false;
-  }
+
+  iter->second.model->ActivatedAt(iter->second.position);
+  return true;
 }
 
 }  // namespace accelerator_util
@@ -36,12 +36,18 @@ class AtomMenuModel : public ui::SimpleMenuModel {
   void SetRole(int index, const base::string16& role);
   base::string16 GetRoleAt(int index);
 
+  // Removes the role of the item too. ui::SimpleMenuModel::RemoveItemAt is
+  // not virtual, so this has to be called on an AtomMenuModel.
+  void RemoveItemAt(int index);
+
   // ui::SimpleMenuModel:
   void MenuClosed() override;
 
  private:
   Delegate* delegate_;  // weak ref.
 
+  // Keyed by command id, since the indexes change when items are inserted or
+  // removed.
   std::map<int, base::string16> roles_;
   base::ObserverList<Observer> observers_;
 
@@ -97,6 +97,18 @@ int RunModalDialog(NSSavePanel* dialog, atom::NativeWindow* parent_window) {
   return chosen;
 }
 
+// Shows the dialog without running a nested loop: as a sheet of the parent
+// window, or as a normal window when there is no parent.
+void BeginDialog(NSSavePanel* dialog,
+                 atom::NativeWindow* parent_window,
+                 void (^handler)(NSInteger)) {
+  NSWindow* window = parent_window ? parent_window->GetNativeWindow() : nil;
+  if (window)
+    [dialog beginSheetModalForWindow:window completionHandler:handler];
+  else
+    [dialog beginWithCompletionHandler:handler];
+}
+
 void ReadDialogPaths(NSOpenPanel* dialog, std::vector<base::FilePath>* paths) {
   NSArray* urls = [dialog URLs];
   for (NSURL* url in urls)
@@ -141,9 +153,7 @@ void ShowOpenDialog(atom::NativeWindow* parent_window,
   // only store the pointer, by duplication we can force gcd to store a copy.
   __block OpenDialogCallback callback = c;
 
-  NSWindow* window = parent_window ? parent_window->GetNativeWindow() : NULL;
-  [dialog beginSheetModalForWindow:window
-                 completionHandler:^(NSInteger chosen) {
+  BeginDialog(dialog, parent_window, ^(NSInteger chosen) {
     if (chosen == NSFileHandlingPanelCancelButton) {
       callback.Run(false, std::vector<base::FilePath>());
     } else {
@@ -151,7 +161,7 @@ void ShowOpenDialog(atom::NativeWindow* parent_window,
       ReadDialogPaths(dialog, &paths);
       callback.Run(true, paths);
     }
-  }];
+  });
 }
 
 bool ShowSaveDialog(atom::NativeWindow* parent_window,
@@ -183,16 +193,14 @@ void ShowSaveDialog(atom::NativeWindow* parent_window,
 
   __block SaveDialogCallback callback = c;
 
-  NSWindow* window = parent_window ? parent_window->GetNativeWindow() : NULL;
-  [dialog beginSheetModalForWindow:window
-                 completionHandler:^(NSInteger chosen) {
+  BeginDialog(dialog, parent_window, ^(NSInteger chosen) {
     if (chosen == NSFileHandlingPanelCancelButton) {
       callback.Run(false, base::FilePath());
     } else {
       std::string path = base::SysNSStringToUTF8([[dialog URL] path]);
       callback.Run(true, base::FilePath(path));
     }
-  }];
+  });
 }
 
 }  // namespace file_dialog
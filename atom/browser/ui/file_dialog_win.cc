@@ -15,6 +15,7 @@
 #include "base/strings/string_util.h"
 #include "base/strings/string_split.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/thread_task_runner_handle.h"
 #include "base/threading/thread.h"
 #include "base/win/registry.h"
 #include "third_party/wtl/include/atlapp.h"
@@ -102,12 +103,8 @@ class FileDialog {
     SetDefaultFolder(default_path);
   }
 
-  bool Show(atom::NativeWindow* parent_window) {
-    atom::NativeWindow::DialogScope dialog_scope(parent_window);
-    HWND window = parent_window ? static_cast<atom::NativeWindowViews*>(
-        parent_window)->GetAcceleratedWidget() :
-        NULL;
-    return dialog_->DoModal(window) == IDOK;
+  bool Show(HWND parent) {
+    return dialog_->DoModal(parent) == IDOK;
   }
 
   T* GetDialog() { return dialog_.get(); }
@@ -134,59 +131,17 @@ class FileDialog {
   DISALLOW_COPY_AND_ASSIGN(FileDialog);
 };
 
-struct RunState {
-  base::Thread* dialog_thread;
-  base::MessageLoop* ui_message_loop;
-};
-
-bool CreateDialogThread(RunState* run_state) {
-  scoped_ptr<base::Thread> thread(
-      new base::Thread(ATOM_PRODUCT_NAME "FileDialogThread"));
-  thread->init_com_with_mta(false);
-  if (!thread->Start())
-    return false;
-
-  run_state->dialog_thread = thread.release();
-  run_state->ui_message_loop = base::MessageLoop::current();
-  return true;
-}
-
-void RunOpenDialogInNewThread(const RunState& run_state,
-                              atom::NativeWindow* parent,
-                              const std::string& title,
-                              const base::FilePath& default_path,
-                              const Filters& filters,
-                              int properties,
-                              const OpenDialogCallback& callback) {
-  std::vector<base::FilePath> paths;
-  bool result = ShowOpenDialog(parent, title, default_path, filters, properties,
-                               &paths);
-  run_state.ui_message_loop->PostTask(FROM_HERE,
-                                      base::Bind(callback, result, paths));
-  run_state.ui_message_loop->DeleteSoon(FROM_HERE, run_state.dialog_thread);
-}
-
-void RunSaveDialogInNewThread(const RunState& run_state,
-                              atom::NativeWindow* parent,
-                              const std::string& title,
-                              const base::FilePath& default_path,
-                              const Filters& filters,
-                              const SaveDialogCallback& callback) {
-  base::FilePath path;
-  bool result = ShowSaveDialog(parent, title, default_path, filters, &path);
-  run_state.ui_message_loop->PostTask(FROM_HERE,
-                                      base::Bind(callback, result, path));
-  run_state.ui_message_loop->DeleteSoon(FROM_HERE, run_state.dialog_thread);
+HWND GetParentHWND(atom::NativeWindow* parent_window) {
+  return parent_window ? static_cast<atom::NativeWindowViews*>(
+      parent_window)->GetAcceleratedWidget() : NULL;
 }
 
-}  // namespace
-
-bool ShowOpenDialog(atom::NativeWindow* parent_window,
-                    const std::string& title,
-                    const base::FilePath& default_path,
-                    const Filters& filters,
-                    int properties,
-                    std::vector<base::FilePath>* paths) {
+bool ShowOpenDialogForHWND(HWND parent,
+                           const std::string& title,
+                           const base::FilePath& default_path,
+                           const Filters& filters,
+                           int properties,
+                           std::vector<base::FilePath>* paths) {
   int options = FOS_FORCEFILESYSTEM | FOS_FILEMUSTEXIST;
   if (properties & FILE_DIALOG_OPEN_DIRECTORY)
     options |= FOS_PICKFOLDERS;
@@ -195,7 +150,7 @@ bool ShowOpenDialog(atom::NativeWindow* parent_window,
 
   FileDialog<CShellFileOpenDialog> open_dialog(
       default_path, title, filters, options);
-  if (!open_dialog.Show(parent_window))
+  if (!open_dialog.Show(parent))
     return false;
 
   ATL::CComPtr<IShellItemArray> items;
@@ -228,33 +183,15 @@ bool ShowOpenDialog(atom::NativeWindow* parent_window,
   return true;
 }
 
-void ShowOpenDialog(atom::NativeWindow* parent,
-                    const std::string& title,
-                    const base::FilePath& default_path,
-                    const Filters& filters,
-                    int properties,
-                    const OpenDialogCallback& callback) {
-  RunState run_state;
-  if (!CreateDialogThread(&run_state)) {
-    callback.Run(false, std::vector<base::FilePath>());
-    return;
-  }
-
-  run_state.dialog_thread->message_loop()->PostTask(
-      FROM_HERE,
-      base::Bind(&RunOpenDialogInNewThread, run_state, parent, title,
-                 default_path, filters, properties, callback));
-}
-
-bool ShowSaveDialog(atom::NativeWindow* parent_window,
-                    const std::string& title,
-                    const base::FilePath& default_path,
-                    const Filters& filters,
-                    base::FilePath* path) {
+bool ShowSaveDialogForHWND(HWND parent,
+                           const std::string& title,
+                           const base::FilePath& default_path,
+                           const Filters& filters,
+                           base::FilePath* path) {
   FileDialog<CShellFileSaveDialog> save_dialog(
       default_path, title, filters,
       FOS_FORCEFILESYSTEM | FOS_PATHMUSTEXIST | FOS_OVERWRITEPROMPT);
-  if (!save_dialog.Show(parent_window))
+  if (!save_dialog.Show(parent))
     return false;
 
   wchar_t buffer[MAX_PATH];
@@ -287,20 +224,127 @@ bool ShowSaveDialog(atom::NativeWindow* parent_window,
   return true;
 }
 
+// The asynchronous dialogs run on a thread of their own, which is a COM STA
+// as the shell dialogs require, so the UI thread and its Node loop keep
+// running. Everything about the parent NativeWindow is done on the UI thread,
+// the dialog thread only sees its HWND.
+struct RunState {
+  base::Thread* dialog_thread;
+  scoped_refptr<base::SingleThreadTaskRunner> ui_task_runner;
+  base::WeakPtr<atom::NativeWindow> parent;
+  HWND parent_hwnd;
+};
+
+bool CreateDialogThread(atom::NativeWindow* parent, RunState* run_state) {
+  scoped_ptr<base::Thread> thread(
+      new base::Thread(ATOM_PRODUCT_NAME "FileDialogThread"));
+  thread->init_com_with_mta(false);
+  if (!thread->Start())
+    return false;
+
+  run_state->dialog_thread = thread.release();
+  run_state->ui_task_runner = base::ThreadTaskRunnerHandle::Get();
+  if (parent) {
+    parent->set_has_dialog_attached(true);
+    run_state->parent = parent->GetWeakPtr();
+  }
+  run_state->parent_hwnd = GetParentHWND(parent);
+  return true;
+}
+
+// Runs on the UI thread once the dialog is closed.
+void OnDialogClosed(const RunState& run_state, const base::Closure& reply) {
+  delete run_state.dialog_thread;
+  if (run_state.parent)
+    run_state.parent->set_has_dialog_attached(false);
+  reply.Run();
+}
+
+void RunOpenDialogInNewThread(const RunState& run_state,
+                              const std::string& title,
+                              const base::FilePath& default_path,
+                              const Filters& filters,
+                              int properties,
+                              const OpenDialogCallback& callback) {
+  std::vector<base::FilePath> paths;
+  bool result = ShowOpenDialogForHWND(run_state.parent_hwnd, title,
+                                      default_path, filters, properties,
+                                      &paths);
+  run_state.ui_task_runner->PostTask(
+      FROM_HERE,
+      base::Bind(&OnDialogClosed, run_state,
+                 base::Bind(callback, result, paths)));
+}
+
+void RunSaveDialogInNewThread(const RunState& run_state,
+                              const std::string& title,
+                              const base::FilePath& default_path,
+                              const Filters& filters,
+                              const SaveDialogCallback& callback) {
+  base::FilePath path;
+  bool result = ShowSaveDialogForHWND(run_state.parent_hwnd, title,
+                                      default_path, filters, &path);
+  run_state.ui_task_runner->PostTask(
+      FROM_HERE,
+      base::Bind(&OnDialogClosed, run_state,
+                 base::Bind(callback, result, path)));
+}
+
+}  // namespace
+
+bool ShowOpenDialog(atom::NativeWindow* parent_window,
+                    const std::string& title,
+                    const base::FilePath& default_path,
+                    const Filters& filters,
+                    int properties,
+                    std::vector<base::FilePath>* paths) {
+  atom::NativeWindow::DialogScope dialog_scope(parent_window);
+  return ShowOpenDialogForHWND(GetParentHWND(parent_window), title,
+                               default_path, filters, properties, paths);
+}
+
+void ShowOpenDialog(atom::NativeWindow* parent,
+                    const std::string& title,
+                    const base::FilePath& default_path,
+                    const Filters& filters,
+                    int properties,
+                    const OpenDialogCallback& callback) {
+  RunState run_state;
+  if (!CreateDialogThread(parent, &run_state)) {
+    callback.Run(false, std::vector<base::FilePath>());
+    return;
+  }
+
+  run_state.dialog_thread->message_loop()->PostTask(
+      FROM_HERE,
+      base::Bind(&RunOpenDialogInNewThread, run_state, title,
+                 default_path, filters, properties, callback));
+}
+
+bool ShowSaveDialog(atom::NativeWindow* parent_window,
+                    const std::string& title,
+                    const base::FilePath& default_path,
+                    const Filters& filters,
+                    base::FilePath* path) {
+  atom::NativeWindow::DialogScope dialog_scope(parent_window);
+  return ShowSaveDialogForHWND(GetParentHWND(parent_window), title,
+                               default_path, filters, path);
+}
+
 void ShowSaveDialog(atom::NativeWindow* parent,
                     const std::string& title,
                     const base::FilePath& default_path,
                     const Filters& filters,
                     const SaveDialogCallback& callback) {
   RunState run_state;
-  if (!CreateDialogThread(&run_state)) {
+  if (!CreateDialogThread(parent, &run_state)) {
     callback.Run(false, base::FilePath());
     return;
   }
 
   run_state.dialog_thread->message_loop()->PostTask(
       FROM_HERE,
-      base::Bind(&RunSaveDialogInNewThread, run_state, parent, title,
+      base::Bind(&RunSaveDialogInNewThread, run_state, title,
                  default_path, filters, callback));
 }
 
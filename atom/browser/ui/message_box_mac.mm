@@ -19,6 +19,7 @@
 - (id)initWithCallback:(const atom::MessageBoxCallback&)callback
               andAlert:(NSAlert*)alert
           callEndModal:(bool)flag;
+- (void)buttonPressed:(id)sender;
 @end
 
 @implementation ModalDelegate
@@ -45,6 +46,12 @@
     [NSApp stopModal];
 }
 
+// The action of the buttons when the alert's window is shown on its own.
+- (void)buttonPressed:(id)sender {
+  [[alert_ window] orderOut:nil];
+  [self alertDidEnd:alert_ returnCode:[sender tag] contextInfo:nil];
+}
+
 @end
 
 namespace atom {
@@ -141,6 +148,21 @@ void ShowMessageBox(NativeWindow* parent_window,
                                                        callEndModal:false];
 
   NSWindow* window = parent_window ? parent_window->GetNativeWindow() : nil;
+  if (!window) {
+    // Without a window to attach a sheet to NSAlert would run a modal loop,
+    // so its window is shown like a panel and the buttons answer directly.
+    [alert layout];
+    for (NSButton* button in [alert buttons]) {
+      [button setTarget:delegate];
+      [button setAction:@selector(buttonPressed:)];
+    }
+    NSWindow* alert_window = [alert window];
+    [alert_window setLevel:NSModalPanelWindowLevel];
+    [alert_window center];
+    [alert_window makeKeyAndOrderFront:nil];
+    return;
+  }
+
   [alert beginSheetModalForWindow:window
                     modalDelegate:delegate
                    didEndSelector:@selector(alertDidEnd:returnCode:contextInfo:)
@@ -8,11 +8,13 @@
 #include <commctrl.h>
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include "atom/browser/browser.h"
 #include "atom/browser/native_window_views.h"
 #include "base/callback.h"
+#include "base/memory/weak_ptr.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/thread.h"
@@ -152,23 +154,50 @@ int ShowMessageBoxUTF16(HWND parent,
     return cancel_id;
 }
 
+std::vector<base::string16> ButtonsToUTF16(
+    const std::vector<std::string>& buttons) {
+  std::vector<base::string16> utf16_buttons;
+  for (const auto& button : buttons)
+    utf16_buttons.push_back(base::UTF8ToUTF16(button));
+  return utf16_buttons;
+}
+
+HWND GetParentHWND(NativeWindow* parent) {
+  return parent ?
+      static_cast<atom::NativeWindowViews*>(parent)->GetAcceleratedWidget() :
+      NULL;
+}
+
+// Runs on the UI thread once the message box is closed.
+void OnMessageBoxClosed(base::Thread* thread,
+                        const base::WeakPtr<NativeWindow>& parent,
+                        const MessageBoxCallback& callback,
+                        int result) {
+  delete thread;
+  if (parent)
+    parent->set_has_dialog_attached(false);
+  callback.Run(result);
+}
+
+// Runs on the message box's thread, which only sees the HWND of the parent.
 void RunMessageBoxInNewThread(base::Thread* thread,
-                              NativeWindow* parent,
+                              HWND parent_hwnd,
+                              const base::WeakPtr<NativeWindow>& parent,
                               MessageBoxType type,
-                              const std::vector<std::string>& buttons,
+                              const std::vector<base::string16>& buttons,
                               int cancel_id,
                               int options,
-                              const std::string& title,
-                              const std::string& message,
-                              const std::string& detail,
+                              const base::string16& title,
+                              const base::string16& message,
+                              const base::string16& detail,
                               const gfx::ImageSkia& icon,
                               const MessageBoxCallback& callback) {
-  int result = ShowMessageBox(parent, type, buttons, cancel_id, options, title,
-                              message, detail, icon);
+  int result = ShowMessageBoxUTF16(parent_hwnd, type, buttons, cancel_id,
+                                   options, title, message, detail, icon);
   content::BrowserThread::PostTask(
-      content::BrowserThread::UI, FROM_HERE, base::Bind(callback, result));
-  content::BrowserThread::DeleteSoon(
-      content::BrowserThread::UI, FROM_HERE, thread);
+      content::BrowserThread::UI, FROM_HERE,
+      base::Bind(&OnMessageBoxClosed, base::Unretained(thread), parent,
+                 callback, result));
 }
 
 }  // namespace
@@ -182,18 +211,10 @@ int ShowMessageBox(NativeWindow* parent,
                    const std::string& message,
                    const std::string& detail,
                    const gfx::ImageSkia& icon) {
-  std::vector<base::string16> utf16_buttons;
-  for (const auto& button : buttons)
-    utf16_buttons.push_back(base::UTF8ToUTF16(button));
-
-  HWND hwnd_parent = parent ?
-      static_cast<atom::NativeWindowViews*>(parent)->GetAcceleratedWidget() :
-      NULL;
-
   NativeWindow::DialogScope dialog_scope(parent);
-  return ShowMessageBoxUTF16(hwnd_parent,
+  return ShowMessageBoxUTF16(GetParentHWND(parent),
                              type,
-                             utf16_buttons,
+                             ButtonsToUTF16(buttons),
                              cancel_id,
                              options,
                              base::UTF8ToUTF16(title),
@@ -220,12 +241,25 @@ void ShowMessageBox(NativeWindow* parent,
     return;
   }
 
+  // The message box runs on a COM STA thread of its own so the UI thread and
+  // its Node loop keep running, everything about the parent NativeWindow and
+  // the app is done here on the UI thread.
+  base::WeakPtr<NativeWindow> weak_parent;
+  if (parent) {
+    parent->set_has_dialog_attached(true);
+    weak_parent = parent->GetWeakPtr();
+  }
+  // ShowMessageBoxUTF16 would read the app's name on the other thread.
+  std::string window_title = title.empty() ? Browser::Get()->GetName() : title;
+
   base::Thread* unretained = thread.release();
   unretained->message_loop()->PostTask(
       FROM_HERE,
       base::Bind(&RunMessageBoxInNewThread, base::Unretained(unretained),
-                 parent, type, buttons, cancel_id, options, title, message,
-                 detail, icon, callback));
+                 GetParentHWND(parent), weak_parent, type,
+                 ButtonsToUTF16(buttons), cancel_id, options,
+                 base::UTF8ToUTF16(window_title), base::UTF8ToUTF16(message),
+                 base::UTF8ToUTF16(detail), icon, callback));
 }
 
 void ShowErrorBox(const base::string16& title, const base::string16& content) {
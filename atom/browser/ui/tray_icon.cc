@@ -6,12 +6,46 @@
 
 namespace atom {
 
-TrayIcon::TrayIcon() {
+TrayIcon::TrayIcon() : current_frame_(0) {
 }
 
 TrayIcon::~TrayIcon() {
 }
 
+void TrayIcon::SetImageSequence(const std::vector<gfx::Image>& frames,
+                                base::TimeDelta interval) {
+  StopImageSequence();
+  if (frames.empty())
+    return;
+
+  frames_ = frames;
+  current_frame_ = 0;
+  SetImageFrames(frames_);
+  ShowImageFrame(current_frame_);
+  frame_timer_.Start(FROM_HERE, interval, this, &TrayIcon::OnFrameTimer);
+}
+
+void TrayIcon::StopImageSequence() {
+  if (frames_.empty())
+    return;
+
+  frame_timer_.Stop();
+  frames_.clear();
+  SetImageFrames(frames_);
+}
+
+void TrayIcon::SetImageFrames(const std::vector<gfx::Image>& frames) {
+}
+
+void TrayIcon::ShowImageFrame(size_t index) {
+  SetImage(frames_[index]);
+}
+
+void TrayIcon::OnFrameTimer() {
+  current_frame_ = (current_frame_ + 1) % frames_.size();
+  ShowImageFrame(current_frame_);
+}
+
 void TrayIcon::SetPressedImage(const gfx::Image& image) {
 }
 
@@ -10,8 +10,11 @@
 
 #include "atom/browser/ui/tray_icon_observer.h"
 #include "base/observer_list.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "ui/base/models/simple_menu_model.h"
 #include "ui/gfx/geometry/rect.h"
+#include "ui/gfx/image/image.h"
 
 namespace atom {
 
@@ -24,6 +27,13 @@ class TrayIcon {
   // Sets the image associated with this status icon.
   virtual void SetImage(const gfx::Image& image) = 0;
 
+  // Shows |frames| one after another every |interval|, until it is called
+  // again or StopImageSequence is called. The frames are prepared for the
+  // platform once, so showing one of them is cheap.
+  void SetImageSequence(const std::vector<gfx::Image>& frames,
+                        base::TimeDelta interval);
+  void StopImageSequence();
+
   // Sets the image associated with this status icon when pressed.
   virtual void SetPressedImage(const gfx::Image& image);
 
@@ -66,9 +76,23 @@ class TrayIcon {
  protected:
   TrayIcon();
 
+  // Prepares the frames of an image sequence, they are released when
+  // |frames| is empty.
+  virtual void SetImageFrames(const std::vector<gfx::Image>& frames);
+
+  // Shows the frame at |index| of the prepared frames, by default the frame is
+  // set as the image.
+  virtual void ShowImageFrame(size_t index);
+
  private:
+  void OnFrameTimer();
+
   base::ObserverList<TrayIconObserver> observers_;
 
+  std::vector<gfx::Image> frames_;
+  size_t current_frame_;
+  base::RepeatingTimer<TrayIcon> frame_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(TrayIcon);
 };
 
@@ -8,6 +8,7 @@
 #import <Cocoa/Cocoa.h>
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/ui/atom_menu_model.h"
 #include "atom/browser/ui/tray_icon.h"
@@ -33,6 +34,9 @@ class TrayIconCocoa : public TrayIcon,
   void SetContextMenu(ui::SimpleMenuModel* menu_model) override;
 
  protected:
+  // TrayIcon:
+  void SetImageFrames(const std::vector<gfx::Image>& frames) override;
+
   // AtomMenuModel::Observer:
   void MenuClosed() override;
 
@@ -306,6 +306,12 @@ void TrayIconCocoa::SetImage(const gfx::Image& image) {
   }
 }
 
+void TrayIconCocoa::SetImageFrames(const std::vector<gfx::Image>& frames) {
+  // Converts the frames once, the converted images are shared by the copies.
+  for (const gfx::Image& frame : frames)
+    frame.AsNSImage();
+}
+
 void TrayIconCocoa::SetPressedImage(const gfx::Image& image) {
   [status_item_view_ setAlternateImage:image.AsNSImage()];
 }
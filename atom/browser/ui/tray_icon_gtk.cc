@@ -33,6 +33,12 @@ void TrayIconGtk::SetImage(const gfx::Image& image) {
   icon_->set_delegate(this);
 }
 
+void TrayIconGtk::SetImageFrames(const std::vector<gfx::Image>& frames) {
+  // Converts the frames once, the converted images are shared by the copies.
+  for (const gfx::Image& frame : frames)
+    frame.AsImageSkia();
+}
+
 void TrayIconGtk::SetToolTip(const std::string& tool_tip) {
   icon_->SetToolTip(base::UTF8ToUTF16(tool_tip));
 }
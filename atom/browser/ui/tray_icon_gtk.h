@@ -6,6 +6,7 @@
 #define ATOM_BROWSER_UI_TRAY_ICON_GTK_H_
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/ui/tray_icon.h"
 #include "ui/views/linux_ui/status_icon_linux.h"
@@ -27,6 +28,10 @@ class TrayIconGtk : public TrayIcon,
   void SetToolTip(const std::string& tool_tip) override;
   void SetContextMenu(ui::SimpleMenuModel* menu_model) override;
 
+ protected:
+  // TrayIcon:
+  void SetImageFrames(const std::vector<gfx::Image>& frames) override;
+
  private:
   // views::StatusIconLinux::Delegate:
   void OnClick() override;
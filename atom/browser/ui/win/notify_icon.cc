@@ -43,6 +43,7 @@ NotifyIcon::~NotifyIcon() {
   NOTIFYICONDATA icon_data;
   InitIconData(&icon_data);
   Shell_NotifyIcon(NIM_DELETE, &icon_data);
+  DestroyFrameIcons();
 }
 
 void NotifyIcon::HandleClickEvent(const gfx::Point& cursor_pos,
@@ -93,14 +94,8 @@ void NotifyIcon::ResetIcon() {
 
 void NotifyIcon::SetImage(const gfx::Image& image) {
   // Create the icon.
-  NOTIFYICONDATA icon_data;
-  InitIconData(&icon_data);
-  icon_data.uFlags |= NIF_ICON;
   icon_.Set(IconUtil::CreateHICONFromSkBitmap(image.AsBitmap()));
-  icon_data.hIcon = icon_.Get();
-  BOOL result = Shell_NotifyIcon(NIM_MODIFY, &icon_data);
-  if (!result)
-    LOG(WARNING) << "Error setting status tray icon image";
+  SetIconHandle(icon_.Get());
 }
 
 void NotifyIcon::SetPressedImage(const gfx::Image& image) {
@@ -166,6 +161,33 @@ void NotifyIcon::SetContextMenu(ui::SimpleMenuModel* menu_model) {
   menu_model_ = menu_model;
 }
 
+void NotifyIcon::SetImageFrames(const std::vector<gfx::Image>& frames) {
+  DestroyFrameIcons();
+  for (const gfx::Image& frame : frames)
+    frame_icons_.push_back(IconUtil::CreateHICONFromSkBitmap(frame.AsBitmap()));
+}
+
+void NotifyIcon::ShowImageFrame(size_t index) {
+  SetIconHandle(frame_icons_[index]);
+}
+
+void NotifyIcon::SetIconHandle(HICON icon) {
+  NOTIFYICONDATA icon_data;
+  InitIconData(&icon_data);
+  icon_data.uFlags |= NIF_ICON;
+  icon_data.hIcon = icon;
+  BOOL result = Shell_NotifyIcon(NIM_MODIFY, &icon_data);
+  if (!result)
+    LOG(WARNING) << "Error setting status tray icon image";
+}
+
+void NotifyIcon::DestroyFrameIcons() {
+  // The shell keeps a copy of the icon it shows, so the handles can go.
+  for (HICON icon : frame_icons_)
+    ::DestroyIcon(icon);
+  frame_icons_.clear();
+}
+
 void NotifyIcon::InitIconData(NOTIFYICONDATA* icon_data) {
   memset(icon_data, 0, sizeof(NOTIFYICONDATA));
   icon_data->cbSize = sizeof(NOTIFYICONDATA);
@@ -9,6 +9,7 @@
 #include <shellapi.h>
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/ui/tray_icon.h"
 #include "base/basictypes.h"
@@ -55,8 +56,15 @@ class NotifyIcon : public TrayIcon {
   void PopUpContextMenu(const gfx::Point& pos) override;
   void SetContextMenu(ui::SimpleMenuModel* menu_model) override;
 
+ protected:
+  // Overridden from TrayIcon:
+  void SetImageFrames(const std::vector<gfx::Image>& frames) override;
+  void ShowImageFrame(size_t index) override;
+
  private:
   void InitIconData(NOTIFYICONDATA* icon_data);
+  void SetIconHandle(HICON icon);
+  void DestroyFrameIcons();
 
   // The tray that owns us.  Weak.
   NotifyIconHost* host_;
@@ -73,6 +81,9 @@ class NotifyIcon : public TrayIcon {
   // The currently-displayed icon for the window.
   base::win::ScopedHICON icon_;
 
+  // The icons of the image sequence, owned by us.
+  std::vector<HICON> frame_icons_;
+
   // The currently-displayed icon for the notification balloon.
   base::win::ScopedHICON balloon_icon_;
 
@@ -0,0 +1,102 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/v8_heap_settings.h"
+
+#include "atom/common/asar/asar_util.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/path_service.h"
+#include "base/strings/stringprintf.h"
+#include "base/values.h"
+#include "content/public/common/content_switches.h"
+
+namespace atom {
+
+namespace {
+
+void AppendFlags(const std::string& flags, std::string* result) {
+  if (flags.empty())
+    return;
+  if (!result->empty())
+    result->append(" ");
+  result->append(flags);
+}
+
+// Returns the "v8" settings of the package.json in resources/app or
+// resources/app.asar, the same places init.coffee looks for the app.
+scoped_ptr<base::DictionaryValue> ReadAppV8Settings() {
+  base::FilePath exec_path;
+  if (!PathService::Get(base::FILE_EXE, &exec_path))
+    return nullptr;
+#if defined(OS_MACOSX)
+  base::FilePath resources_path =
+      exec_path.DirName().DirName().Append("Resources");
+#else
+  base::FilePath resources_path =
+      exec_path.DirName().Append(FILE_PATH_LITERAL("resources"));
+#endif
+
+  const char* kSearchPaths[] = { "app", "app.asar" };
+  for (const char* search_path : kSearchPaths) {
+    std::string content;
+    base::FilePath path =
+        resources_path.Append(search_path).Append("package.json");
+    if (!asar::ReadFileToString(path, &content))
+      continue;
+
+    scoped_ptr<base::Value> value(base::JSONReader::Read(content));
+    base::DictionaryValue* package = nullptr;
+    base::DictionaryValue* settings = nullptr;
+    if (!value || !value->GetAsDictionary(&package) ||
+        !package->GetDictionary("v8", &settings))
+      return nullptr;
+    return make_scoped_ptr(settings->DeepCopy());
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+std::string GetV8FlagsFromSettings(const base::DictionaryValue& settings) {
+  std::string flags;
+  int size;
+  if (settings.GetInteger("max-old-space-size", &size) && size > 0)
+    AppendFlags(base::StringPrintf("--max_old_space_size=%d", size), &flags);
+  if (settings.GetInteger("max-semi-space-size", &size) && size > 0)
+    AppendFlags(base::StringPrintf("--max_semi_space_size=%d", size), &flags);
+  bool flush_code;
+  if (settings.GetBoolean("flush-code", &flush_code))
+    AppendFlags(flush_code ? "--flush_code" : "--noflush_code", &flags);
+  std::string js_flags;
+  if (settings.GetString("js-flags", &js_flags))
+    AppendFlags(js_flags, &flags);
+  return flags;
+}
+
+const std::string& GetBrowserV8Flags() {
+  static std::string* flags = nullptr;
+  if (!flags) {
+    flags = new std::string;
+    scoped_ptr<base::DictionaryValue> settings = ReadAppV8Settings();
+    if (settings)
+      AppendFlags(GetV8FlagsFromSettings(*settings), flags);
+    AppendFlags(base::CommandLine::ForCurrentProcess()->GetSwitchValueASCII(
+                    ::switches::kJavaScriptFlags),
+                flags);
+  }
+  return *flags;
+}
+
+std::string GetRendererV8Flags(const base::DictionaryValue& web_preferences) {
+  std::string flags = GetV8FlagsFromSettings(web_preferences);
+  AppendFlags(base::CommandLine::ForCurrentProcess()->GetSwitchValueASCII(
+                  ::switches::kJavaScriptFlags),
+              &flags);
+  return flags;
+}
+
+}  // namespace atom
@@ -0,0 +1,32 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_V8_HEAP_SETTINGS_H_
+#define ATOM_BROWSER_V8_HEAP_SETTINGS_H_
+
+#include <string>
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace atom {
+
+// Returns the V8 flags that apply the "max-old-space-size" and
+// "max-semi-space-size" (in megabytes), "flush-code" and "js-flags" entries
+// of |settings|.
+std::string GetV8FlagsFromSettings(const base::DictionaryValue& settings);
+
+// Returns the flags of the browser process's isolate: the "v8" settings in
+// the package.json of the app, followed by the --js-flags switch. They are
+// computed once, and have to be set before the isolate is created.
+const std::string& GetBrowserV8Flags();
+
+// Returns the flags a renderer with |web_preferences| is started with: its
+// settings followed by the --js-flags switch of the browser process.
+std::string GetRendererV8Flags(const base::DictionaryValue& web_preferences);
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_V8_HEAP_SETTINGS_H_
@@ -6,10 +6,10 @@
 
 #include <string>
 
+#include "atom/browser/v8_heap_settings.h"
 #include "atom/common/options_switches.h"
-#include "base/command_line.h"
 #include "base/strings/string_number_conversions.h"
-#include "content/public/common/web_preferences.h"
+#include "content/public/common/content_switches.h"
 #include "net/base/filename_util.h"
 
 #if defined(OS_WIN)
@@ -36,12 +36,15 @@ const char* kWebRuntimeFeatures[] = {
 
 WebContentsPreferences::WebContentsPreferences(
     content::WebContents* web_contents,
-    base::DictionaryValue* web_preferences) {
+    base::DictionaryValue* web_preferences)
+    : switches_(base::CommandLine::NO_PROGRAM),
+      share_renderer_process_(false) {
   web_preferences_.Swap(web_preferences);
   web_contents->SetUserData(UserDataKey(), this);
 
   // The "isGuest" is not a preferences field.
   web_preferences_.Remove("isGuest", nullptr);
+  Parse();
 }
 
 WebContentsPreferences::~WebContentsPreferences() {
@@ -49,6 +52,7 @@ WebContentsPreferences::~WebContentsPreferences() {
 
 void WebContentsPreferences::Merge(const base::DictionaryValue& extend) {
   web_preferences_.MergeDictionary(&extend);
+  Parse();
 }
 
 // static
@@ -58,8 +62,13 @@ void WebContentsPreferences::AppendExtraCommandLineSwitches(
   if (!self)
     return;
 
-  base::DictionaryValue& web_preferences = self->web_preferences_;
+  command_line->AppendArguments(self->switches_, false);
+}
 
+// static
+void WebContentsPreferences::AppendExtraCommandLineSwitches(
+    const base::DictionaryValue& web_preferences,
+    base::CommandLine* command_line) {
   bool b;
 #if defined(OS_WIN)
   // Check if DirectWrite is disabled.
@@ -113,12 +122,34 @@ void WebContentsPreferences::AppendExtraCommandLineSwitches(
     command_line->AppendSwitchASCII(switches::kZoomFactor,
                                     base::DoubleToString(zoom_factor));
 
+  // The scheduling of Node's events in the renderer.
+  std::string node_scheduling;
+  if (web_preferences.GetString(switches::kNodeScheduling, &node_scheduling))
+    command_line->AppendSwitchASCII(switches::kNodeScheduling,
+                                    node_scheduling);
+
   // --guest-instance-id, which is used to identify guest WebContents.
   int guest_instance_id;
   if (web_preferences.GetInteger(switches::kGuestInstanceID,
                                  &guest_instance_id))
       command_line->AppendSwitchASCII(switches::kGuestInstanceID,
                                       base::IntToString(guest_instance_id));
+
+  // The heap settings of the renderer's isolate, replacing the --js-flags
+  // copied from the browser process which are included in them.
+  std::string js_flags = GetRendererV8Flags(web_preferences);
+  if (!js_flags.empty())
+    command_line->AppendSwitchASCII(::switches::kJavaScriptFlags, js_flags);
+}
+
+// static
+bool WebContentsPreferences::ShouldShareRendererProcess(
+    content::WebContents* web_contents) {
+  if (!web_contents)
+    return false;
+
+  WebContentsPreferences* self = FromWebContents(web_contents);
+  return self && self->share_renderer_process_;
 }
 
 // static
@@ -128,29 +159,52 @@ void WebContentsPreferences::OverrideWebkitPrefs(
   if (!self)
     return;
 
+  for (const auto& pref : self->webkit_prefs_)
+    prefs->*pref.first = pref.second;
+}
+
+void WebContentsPreferences::Parse() {
+  switches_ = base::CommandLine(base::CommandLine::NO_PROGRAM);
+  AppendExtraCommandLineSwitches(web_preferences_, &switches_);
+
+  share_renderer_process_ = false;
+  web_preferences_.GetBoolean(switches::kShareRendererProcess,
+                              &share_renderer_process_);
+
+  webkit_prefs_.clear();
   bool b;
-  if (self->web_preferences_.GetBoolean("javascript", &b))
-    prefs->javascript_enabled = b;
-  if (self->web_preferences_.GetBoolean("images", &b))
-    prefs->images_enabled = b;
-  if (self->web_preferences_.GetBoolean("java", &b))
-    prefs->java_enabled = b;
-  if (self->web_preferences_.GetBoolean("text-areas-are-resizable", &b))
-    prefs->text_areas_are_resizable = b;
-  if (self->web_preferences_.GetBoolean("webgl", &b))
-    prefs->experimental_webgl_enabled = b;
-  if (self->web_preferences_.GetBoolean("webaudio", &b))
-    prefs->webaudio_enabled = b;
-  if (self->web_preferences_.GetBoolean("web-security", &b)) {
-    prefs->web_security_enabled = b;
-    prefs->allow_displaying_insecure_content = !b;
-    prefs->allow_running_insecure_content = !b;
+  if (web_preferences_.GetBoolean("javascript", &b))
+    webkit_prefs_.push_back(
+        std::make_pair(&content::WebPreferences::javascript_enabled, b));
+  if (web_preferences_.GetBoolean("images", &b))
+    webkit_prefs_.push_back(
+        std::make_pair(&content::WebPreferences::images_enabled, b));
+  if (web_preferences_.GetBoolean("java", &b))
+    webkit_prefs_.push_back(
+        std::make_pair(&content::WebPreferences::java_enabled, b));
+  if (web_preferences_.GetBoolean("text-areas-are-resizable", &b))
+    webkit_prefs_.push_back(std::make_pair(
+        &content::WebPreferences::text_areas_are_resizable, b));
+  if (web_preferences_.GetBoolean("webgl", &b))
+    webkit_prefs_.push_back(std::make_pair(
+        &content::WebPreferences::experimental_webgl_enabled, b));
+  if (web_preferences_.GetBoolean("webaudio", &b))
+    webkit_prefs_.push_back(
+        std::make_pair(&content::WebPreferences::webaudio_enabled, b));
+  if (web_preferences_.GetBoolean("web-security", &b)) {
+    webkit_prefs_.push_back(
+        std::make_pair(&content::WebPreferences::web_security_enabled, b));
+    webkit_prefs_.push_back(std::make_pair(
+        &content::WebPreferences::allow_displaying_insecure_content, !b));
+    webkit_prefs_.push_back(std::make_pair(
+        &content::WebPreferences::allow_running_insecure_content, !b));
   }
-  if (self->web_preferences_.GetBoolean("allow-displaying-insecure-content",
-                                        &b))
-    prefs->allow_displaying_insecure_content = b;
-  if (self->web_preferences_.GetBoolean("allow-running-insecure-content", &b))
-    prefs->allow_running_insecure_content = b;
+  if (web_preferences_.GetBoolean("allow-displaying-insecure-content", &b))
+    webkit_prefs_.push_back(std::make_pair(
+        &content::WebPreferences::allow_displaying_insecure_content, b));
+  if (web_preferences_.GetBoolean("allow-running-insecure-content", &b))
+    webkit_prefs_.push_back(std::make_pair(
+        &content::WebPreferences::allow_running_insecure_content, b));
 }
 
 }  // namespace atom
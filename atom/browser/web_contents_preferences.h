@@ -5,20 +5,19 @@
 #ifndef ATOM_BROWSER_WEB_CONTENTS_PREFERENCES_H_
 #define ATOM_BROWSER_WEB_CONTENTS_PREFERENCES_H_
 
+#include <utility>
+#include <vector>
+
+#include "base/command_line.h"
 #include "base/values.h"
 #include "content/public/browser/web_contents_user_data.h"
-
-namespace base {
-class CommandLine;
-}
-
-namespace content {
-struct WebPreferences;
-}
+#include "content/public/common/web_preferences.h"
 
 namespace atom {
 
-// Stores and applies the preferences of WebContents.
+// Stores and applies the preferences of WebContents. What they give is parsed
+// once when they are set, so applying them for each navigation and renderer
+// launch does not read the dictionary again.
 class WebContentsPreferences
     : public content::WebContentsUserData<WebContentsPreferences> {
  public:
@@ -26,6 +25,15 @@ class WebContentsPreferences
   static void AppendExtraCommandLineSwitches(
       content::WebContents* web_contents, base::CommandLine* command_line);
 
+  // Append command paramters according to |web_preferences|.
+  static void AppendExtraCommandLineSwitches(
+      const base::DictionaryValue& web_preferences,
+      base::CommandLine* command_line);
+
+  // Whether |web_contents| can share its renderer process with the other
+  // WebContents of the same site that have the same preferences.
+  static bool ShouldShareRendererProcess(content::WebContents* web_contents);
+
   // Modify the WebPreferences according to |web_contents|'s preferences.
   static void OverrideWebkitPrefs(
       content::WebContents* web_contents, content::WebPreferences* prefs);
@@ -37,14 +45,28 @@ class WebContentsPreferences
   // $.extend(|web_preferences_|, |new_web_preferences|).
   void Merge(const base::DictionaryValue& new_web_preferences);
 
-  // Returns the web preferences.
-  base::DictionaryValue* web_preferences() { return &web_preferences_; }
+  // Returns the web preferences, which can only be changed with Merge.
+  const base::DictionaryValue* web_preferences() const {
+    return &web_preferences_;
+  }
 
  private:
   friend class content::WebContentsUserData<WebContentsPreferences>;
 
+  typedef bool content::WebPreferences::*WebkitPref;
+
+  // Parses |web_preferences_| into the fields below.
+  void Parse();
+
   base::DictionaryValue web_preferences_;
 
+  // The switches given to the renderer process.
+  base::CommandLine switches_;
+  bool share_renderer_process_;
+  // The fields of WebPreferences that are overridden, in the order they are
+  // set.
+  std::vector<std::pair<WebkitPref, bool>> webkit_prefs_;
+
   DISALLOW_COPY_AND_ASSIGN(WebContentsPreferences);
 };
 
@@ -5,6 +5,7 @@
 #include "atom/browser/web_view_guest_delegate.h"
 
 #include "atom/browser/api/atom_api_web_contents.h"
+#include "atom/common/api/api_messages.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "content/public/browser/guest_host.h"
 #include "content/public/browser/render_frame_host.h"
@@ -25,6 +26,7 @@ WebViewGuestDelegate::WebViewGuestDelegate()
       guest_host_(nullptr),
       auto_size_enabled_(false),
       is_full_page_plugin_(false),
+      zoom_level_(0),
       api_web_contents_(nullptr) {
 }
 
@@ -111,6 +113,17 @@ void WebViewGuestDelegate::SetAllowTransparency(bool allow) {
   }
 }
 
+void WebViewGuestDelegate::SetZoomLevel(double level) {
+  if (level == zoom_level_)
+    return;
+  zoom_level_ = level;
+  SendZoomLevel();
+}
+
+void WebViewGuestDelegate::OnZoomLevelChanged(double level) {
+  zoom_level_ = level;
+}
+
 void WebViewGuestDelegate::HandleKeyboardEvent(
     content::WebContents* source,
     const content::NativeWebKeyboardEvent& event) {
@@ -128,6 +141,10 @@ void WebViewGuestDelegate::RenderViewReady() {
     render_view_host_view->SetBackgroundColorToDefault();
   else
     render_view_host_view->SetBackgroundColor(SK_ColorTRANSPARENT);
+
+  // A new renderer starts with the default zoom level.
+  if (zoom_level_ != 0)
+    SendZoomLevel();
 }
 
 void WebViewGuestDelegate::DidCommitProvisionalLoadForFrame(
@@ -162,6 +179,14 @@ void WebViewGuestDelegate::WillAttach(
     const base::Closure& completion_callback) {
   embedder_web_contents_ = embedder_web_contents;
   is_full_page_plugin_ = is_full_page_plugin;
+
+  // Start with the zoom level of the embedder's page.
+  v8::Isolate* isolate = api_web_contents_->isolate();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  auto api_embedder =
+      api::WebContents::FromWrappedClass(isolate, embedder_web_contents);
+  SetZoomLevel(api_embedder ? api_embedder->zoom_level() : 0);
   completion_callback.Run();
 }
 
@@ -182,4 +207,11 @@ gfx::Size WebViewGuestDelegate::GetDefaultSize() const {
   }
 }
 
+void WebViewGuestDelegate::SendZoomLevel() {
+  content::RenderFrameHost* frame = web_contents()->GetMainFrame();
+  if (frame && frame->IsRenderFrameLive())
+    frame->Send(new AtomViewMsg_SetZoomLevel(frame->GetRoutingID(),
+                                             zoom_level_));
+}
+
 }  // namespace atom
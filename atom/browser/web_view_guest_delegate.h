@@ -52,6 +52,13 @@ class WebViewGuestDelegate : public content::BrowserPluginGuestDelegate,
   // Sets the transparency of the guest.
   void SetAllowTransparency(bool allow);
 
+  // Makes the guest follow the zoom level of its embedder, nothing is sent
+  // when the guest already has the level.
+  void SetZoomLevel(double level);
+
+  // Called when the guest's page has changed its own zoom level.
+  void OnZoomLevelChanged(double level);
+
   // Transfer the keyboard event to embedder.
   void HandleKeyboardEvent(content::WebContents* source,
                            const content::NativeWebKeyboardEvent& event);
@@ -85,6 +92,10 @@ class WebViewGuestDelegate : public content::BrowserPluginGuestDelegate,
   // Returns the default size of the guestview.
   gfx::Size GetDefaultSize() const;
 
+  // Sends |zoom_level_| to the main frame of the guest, which applies it to
+  // the whole page.
+  void SendZoomLevel();
+
   // Stores whether the contents of the guest can be transparent.
   bool guest_opaque_;
 
@@ -116,6 +127,9 @@ class WebViewGuestDelegate : public content::BrowserPluginGuestDelegate,
   // Whether the guest view is inside a plugin document.
   bool is_full_page_plugin_;
 
+  // The zoom level the guest's page has.
+  double zoom_level_;
+
   api::WebContents* api_web_contents_;
 
   DISALLOW_COPY_AND_ASSIGN(WebViewGuestDelegate);
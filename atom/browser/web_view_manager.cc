@@ -4,10 +4,15 @@
 
 #include "atom/browser/web_view_manager.h"
 
+#include <vector>
+
 #include "atom/browser/atom_browser_context.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/web_contents.h"
 
+using content::BrowserThread;
+
 namespace atom {
 
 WebViewManager::WebViewManager() {
@@ -20,49 +25,67 @@ void WebViewManager::AddGuest(int guest_instance_id,
                               int element_instance_id,
                               content::WebContents* embedder,
                               content::WebContents* web_contents) {
-  web_contents_embedder_map_[guest_instance_id] = { web_contents, embedder };
-
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
   // Map the element in embedder to guest.
   int owner_process_id = embedder->GetRenderProcessHost()->GetID();
-  ElementInstanceKey key(owner_process_id, element_instance_id);
+  ElementInstanceKey key =
+      GetElementInstanceKey(owner_process_id, element_instance_id);
+  guests_[guest_instance_id] = { web_contents, embedder, key };
   element_instance_id_to_guest_map_[key] = guest_instance_id;
 }
 
 void WebViewManager::RemoveGuest(int guest_instance_id) {
-  if (!ContainsKey(web_contents_embedder_map_, guest_instance_id))
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = guests_.find(guest_instance_id);
+  if (it == guests_.end())
     return;
 
-  web_contents_embedder_map_.erase(guest_instance_id);
+  // Remove the record of element in embedder too, unless the element has been
+  // attached to another guest.
+  ElementInstanceKey key = it->second.element_instance_key;
+  guests_.erase(it);
 
-  // Remove the record of element in embedder too.
-  for (const auto& element : element_instance_id_to_guest_map_)
-    if (element.second == guest_instance_id) {
-      element_instance_id_to_guest_map_.erase(element.first);
-      break;
-    }
+  auto element = element_instance_id_to_guest_map_.find(key);
+  if (element != element_instance_id_to_guest_map_.end() &&
+      element->second == guest_instance_id)
+    element_instance_id_to_guest_map_.erase(element);
 }
 
 content::WebContents* WebViewManager::GetGuestByInstanceID(
     int owner_process_id,
     int element_instance_id) {
-  ElementInstanceKey key(owner_process_id, element_instance_id);
-  if (!ContainsKey(element_instance_id_to_guest_map_, key))
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto element = element_instance_id_to_guest_map_.find(
+      GetElementInstanceKey(owner_process_id, element_instance_id));
+  if (element == element_instance_id_to_guest_map_.end())
     return nullptr;
 
-  int guest_instance_id = element_instance_id_to_guest_map_[key];
-  if (ContainsKey(web_contents_embedder_map_, guest_instance_id))
-    return web_contents_embedder_map_[guest_instance_id].web_contents;
-  else
-    return nullptr;
+  auto it = guests_.find(element->second);
+  return it == guests_.end() ? nullptr : it->second.web_contents;
 }
 
 bool WebViewManager::ForEachGuest(content::WebContents* embedder_web_contents,
                                   const GuestCallback& callback) {
-  for (auto& item : web_contents_embedder_map_)
-    if (item.second.embedder == embedder_web_contents &&
-        callback.Run(item.second.web_contents))
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  // The callback may remove guests, so they are looked up again.
+  std::vector<int> guest_instance_ids;
+  for (const auto& item : guests_)
+    if (item.second.embedder == embedder_web_contents)
+      guest_instance_ids.push_back(item.first);
+
+  for (int guest_instance_id : guest_instance_ids) {
+    auto it = guests_.find(guest_instance_id);
+    if (it != guests_.end() && callback.Run(it->second.web_contents))
       return true;
+  }
   return false;
 }
 
+// static
+WebViewManager::ElementInstanceKey WebViewManager::GetElementInstanceKey(
+    int embedder_process_id, int element_instance_id) {
+  return (static_cast<int64>(embedder_process_id) << 32) |
+         static_cast<uint32>(element_instance_id);
+}
+
 }  // namespace atom
@@ -5,8 +5,7 @@
 #ifndef ATOM_BROWSER_WEB_VIEW_MANAGER_H_
 #define ATOM_BROWSER_WEB_VIEW_MANAGER_H_
 
-#include <map>
-
+#include "base/containers/hash_tables.h"
 #include "content/public/browser/browser_plugin_guest_manager.h"
 
 namespace atom {
@@ -30,34 +29,24 @@ class WebViewManager : public content::BrowserPluginGuestManager {
                     const GuestCallback& callback) override;
 
  private:
-  struct WebContentsWithEmbedder {
+  // (embedder_process_id, element_instance_id) packed in one integer.
+  using ElementInstanceKey = int64;
+
+  static ElementInstanceKey GetElementInstanceKey(int embedder_process_id,
+                                                  int element_instance_id);
+
+  struct GuestInfo {
     content::WebContents* web_contents;
     content::WebContents* embedder;
+    ElementInstanceKey element_instance_key;
   };
-  // guest_instance_id => (web_contents, embedder)
-  std::map<int, WebContentsWithEmbedder> web_contents_embedder_map_;
-
-  struct ElementInstanceKey {
-    int embedder_process_id;
-    int element_instance_id;
+  // guest_instance_id => (web_contents, embedder, element), only accessed on
+  // the UI thread.
+  base::hash_map<int, GuestInfo> guests_;
 
-    ElementInstanceKey(int embedder_process_id, int element_instance_id)
-        : embedder_process_id(embedder_process_id),
-          element_instance_id(element_instance_id) {}
-
-    bool operator<(const ElementInstanceKey& other) const {
-      if (embedder_process_id != other.embedder_process_id)
-        return embedder_process_id < other.embedder_process_id;
-      return element_instance_id < other.element_instance_id;
-    }
-
-    bool operator==(const ElementInstanceKey& other) const {
-      return (embedder_process_id == other.embedder_process_id) &&
-          (element_instance_id == other.element_instance_id);
-    }
-  };
-  // (embedder_process_id, element_instance_id) => guest_instance_id
-  std::map<ElementInstanceKey, int> element_instance_id_to_guest_map_;
+  // (embedder_process_id, element_instance_id) => guest_instance_id, only
+  // accessed on the UI thread.
+  base::hash_map<ElementInstanceKey, int> element_instance_id_to_guest_map_;
 
   DISALLOW_COPY_AND_ASSIGN(WebViewManager);
 };
@@ -5,6 +5,7 @@
 // Multiply-included file, no traditional include guard.
 
 #include "atom/common/draggable_region.h"
+#include "base/memory/shared_memory.h"
 #include "base/strings/string16.h"
 #include "base/values.h"
 #include "content/public/common/common_param_traits.h"
@@ -21,29 +22,124 @@ IPC_STRUCT_TRAITS_BEGIN(atom::DraggableRegion)
   IPC_STRUCT_TRAITS_MEMBER(bounds)
 IPC_STRUCT_TRAITS_END()
 
-IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message,
+// The arguments of ipc messages are serialized by atom::V8ValueSerializer,
+// large Buffers are passed in shared memory, the handle is invalid when there
+// are none.
+IPC_MESSAGE_ROUTED4(AtomViewHostMsg_Message,
                     base::string16 /* channel */,
-                    base::ListValue /* arguments */)
+                    std::string /* arguments */,
+                    base::SharedMemoryHandle /* buffers */,
+                    uint32 /* buffers size */)
+
+// Gives |channel| an id for AtomViewHostMsg_MessageById, the ids are unique in
+// the renderer process.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_RegisterChannel,
+                    int32 /* channel id */,
+                    base::string16 /* channel */)
+
+IPC_MESSAGE_ROUTED4(AtomViewHostMsg_MessageById,
+                    int32 /* channel id */,
+                    std::string /* arguments */,
+                    base::SharedMemoryHandle /* buffers */,
+                    uint32 /* buffers size */)
 
 IPC_SYNC_MESSAGE_ROUTED2_1(AtomViewHostMsg_Message_Sync,
                            base::string16 /* channel */,
-                           base::ListValue /* arguments */,
+                           std::string /* arguments */,
                            base::string16 /* result (in JSON) */)
 
 IPC_MESSAGE_ROUTED1(AtomViewHostMsg_ZoomLevelChanged,
                     double /* level */)
 
+// The <webview> element of the guest has been resized, the guest is resized
+// without going through JavaScript.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_GuestElementResized,
+                    int /* element instance id */,
+                    gfx::Size /* new size */)
+
 IPC_MESSAGE_ROUTED1(AtomViewMsg_SetZoomLevel,
                     double /* level */)
 
-IPC_MESSAGE_ROUTED2(AtomViewMsg_Message,
+IPC_MESSAGE_ROUTED4(AtomViewMsg_Message,
                     base::string16 /* channel */,
-                    base::ListValue /* arguments */)
+                    std::string /* arguments */,
+                    base::SharedMemoryHandle /* buffers */,
+                    uint32 /* buffers size */)
 
 IPC_MESSAGE_ROUTED2(AtomViewMsg_ExecuteJavaScript,
                     base::string16 /* code */,
                     bool /* has user gesture */)
 
-// Sent by the renderer when the draggable regions are updated.
-IPC_MESSAGE_ROUTED1(AtomViewHostMsg_UpdateDraggableRegions,
-                    std::vector<atom::DraggableRegion> /* regions */)
+// Sent by the renderer when the draggable regions are updated, the |removed|
+// regions from |start| are replaced with |inserted|. Every full update starts
+// a new |generation| with |sequence| 0 and |inserted| holding all the regions,
+// the changes after it have the next sequence numbers.
+IPC_MESSAGE_ROUTED5(AtomViewHostMsg_UpdateDraggableRegions,
+                    uint32 /* generation */,
+                    uint32 /* sequence */,
+                    uint32 /* start */,
+                    uint32 /* removed */,
+                    std::vector<atom::DraggableRegion> /* inserted */)
+
+// Asks the renderer for a full update of the draggable regions, when the
+// browser could not apply a change to the regions it knows.
+IPC_MESSAGE_ROUTED0(AtomViewMsg_ResyncDraggableRegions)
+
+// Messages of the ports created by ipc.createMessageChannel, they are relayed
+// by atom::MessagePortFilter on the IO thread of the browser.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_PortMessage,
+                    int32 /* port id */,
+                    std::string /* arguments */)
+
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_PortClose,
+                    int32 /* port id */)
+
+IPC_MESSAGE_ROUTED2(AtomViewMsg_PortMessage,
+                    int32 /* port id */,
+                    std::string /* arguments */)
+
+IPC_MESSAGE_ROUTED1(AtomViewMsg_PortClosed,
+                    int32 /* port id */)
+
+// Sent to every renderer when the browser is told that the system is low on
+// memory, since renderers are not told by the system on all platforms.
+IPC_MESSAGE_CONTROL1(AtomMsg_MemoryPressure,
+                     int /* base::MemoryPressureListener::MemoryPressureLevel */)
+
+// Sent by the renderer when its first Node environment is loaded, with the
+// time it was loaded.
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_NodeEnvironmentLoaded,
+                    int64 /* base::TimeTicks::ToInternalValue() */)
+
+// Maps a region created by the shared-memory module into the renderer, the
+// renderer keeps it under |name| until AtomViewMsg_SharedMemoryReleased.
+IPC_MESSAGE_ROUTED3(AtomViewMsg_SharedMemoryRegion,
+                    std::string /* name */,
+                    base::SharedMemoryHandle /* region */,
+                    uint32 /* region size */)
+
+IPC_MESSAGE_ROUTED1(AtomViewMsg_SharedMemoryReleased,
+                    std::string /* name */)
+
+// Asks the renderer to send an AtomViewHostMsg_JankReport every |interval|,
+// 0 stops the reports.
+IPC_MESSAGE_ROUTED1(AtomViewMsg_SetJankReportInterval,
+                    int32 /* interval in milliseconds */)
+
+// The summary of the page's responsiveness since the last report, see
+// atom::JankReporter.
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_JankReport,
+                    base::DictionaryValue /* report */)
+
+// Gives the renderer the text of a style sheet of
+// WebContents.registerStyleSheet, which the pages then insert by |id|.
+IPC_MESSAGE_CONTROL2(AtomMsg_RegisterStyleSheet,
+                     std::string /* id */,
+                     std::string /* css */)
+
+IPC_MESSAGE_ROUTED1(AtomViewMsg_InsertStyleSheet,
+                    std::string /* id */)
+
+// The registered style sheets inserted in each new document of the page.
+IPC_MESSAGE_ROUTED1(AtomViewMsg_SetStyleSheets,
+                    std::vector<std::string> /* ids */)
@@ -3,34 +3,389 @@
 // found in the LICENSE file.
 
 #include <stddef.h>
+#include <stdlib.h>
 
+#include <algorithm>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "atom_natives.h"  // NOLINT: This file is generated with coffee2c.
 #include "atom/common/asar/archive.h"
+#include "atom/common/asar/asar_util.h"
+#include "atom/common/asar/code_cache.h"
+#include "atom/common/api/locker.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/node_includes.h"
+#include "base/bind.h"
+#include "base/json/json_reader.h"
+#include "base/strings/string_split.h"
+#include "base/threading/worker_pool.h"
+#include "base/values.h"
 #include "native_mate/arguments.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "native_mate/wrappable.h"
+#include "third_party/WebKit/public/web/WebScopedMicrotaskSuppression.h"
 
 namespace {
 
+// Drops the reference to archive held by a Buffer returned by getFileView.
+void ReleaseArchive(char* data, void* hint) {
+  delete static_cast<std::shared_ptr<asar::Archive>*>(hint);
+}
+
+// Flags of each path in the result of statBatch.
+enum StatFlags {
+  STAT_FILE       = 1 << 0,
+  STAT_DIRECTORY  = 1 << 1,
+  STAT_LINK       = 1 << 2,
+  STAT_UNPACKED   = 1 << 3,
+  STAT_COMPRESSED = 1 << 4,
+};
+
+// Number of numbers per path in the result of statBatch.
+const size_t kStatBatchStride = 3;
+
+// Joins |path| to |dir| and normalizes the result, both are "/" separated
+// paths relative to the root of archive. Fails when the result is outside
+// the archive.
+bool JoinArchivePath(const std::string& dir,
+                     const std::string& path,
+                     std::string* result) {
+  if (!path.empty() && (path[0] == '/' || path[0] == '\\'))
+    return false;
+
+  std::vector<std::string> components;
+  for (const std::string& part : {dir, path}) {
+    std::vector<std::string> pieces;
+    base::SplitString(part, '/', &pieces);
+    for (const std::string& piece : pieces) {
+      if (piece.empty() || piece == ".")
+        continue;
+      if (piece == "..") {
+        if (components.empty())
+          return false;
+        components.pop_back();
+      } else {
+        components.push_back(piece);
+      }
+    }
+  }
+
+  result->clear();
+  for (const std::string& component : components) {
+    if (!result->empty())
+      result->push_back('/');
+    result->append(component);
+  }
+  return true;
+}
+
+// Resolves a module in archive the same way as Module._findPath of Node, but
+// with all the probing done in native code.
+class ModuleResolver {
+ public:
+  enum Result {
+    RESULT_FOUND,
+    RESULT_NOT_FOUND,
+    // The JS resolver has to be used, e.g. for a broken package.json so the
+    // error is reported the same way as Node.
+    RESULT_UNHANDLED,
+  };
+
+  ModuleResolver(asar::Archive* archive,
+                 const std::vector<std::string>& extensions)
+      : archive_(archive), extensions_(extensions) {}
+
+  Result Resolve(const std::string& request_path,
+                 bool trailing_slash,
+                 base::FilePath* real_path) {
+    Result result = RESULT_NOT_FOUND;
+    if (!trailing_slash) {
+      int rc = Stat(request_path);
+      if (rc == 0)
+        result = Realpath(request_path, real_path);
+      else if (rc == 1)
+        result = TryPackage(request_path, real_path);
+      if (result == RESULT_NOT_FOUND)
+        result = TryExtensions(request_path, real_path);
+    }
+    if (result == RESULT_NOT_FOUND)
+      result = TryPackage(request_path, real_path);
+    if (result == RESULT_NOT_FOUND)
+      result = TryExtensions(Join(request_path, "index"), real_path);
+    return result;
+  }
+
+ private:
+  // Like internalModuleStat: 0 for file, 1 for directory, -1 for not found.
+  int Stat(const std::string& path) {
+    asar::Archive::Stats stats;
+    if (!archive_->Stat(base::FilePath::FromUTF8Unsafe(path), &stats))
+      return -1;
+    return stats.is_directory ? 1 : 0;
+  }
+
+  Result Realpath(const std::string& path, base::FilePath* real_path) {
+    return archive_->Realpath(base::FilePath::FromUTF8Unsafe(path), real_path) ?
+        RESULT_FOUND : RESULT_NOT_FOUND;
+  }
+
+  Result TryFile(const std::string& path, base::FilePath* real_path) {
+    if (Stat(path) != 0)
+      return RESULT_NOT_FOUND;
+    return Realpath(path, real_path);
+  }
+
+  Result TryExtensions(const std::string& path, base::FilePath* real_path) {
+    for (const std::string& extension : extensions_) {
+      Result result = TryFile(path + extension, real_path);
+      if (result != RESULT_NOT_FOUND)
+        return result;
+    }
+    return RESULT_NOT_FOUND;
+  }
+
+  Result TryPackage(const std::string& path, base::FilePath* real_path) {
+    asar::Archive::FileInfo info;
+    if (!archive_->GetFileInfo(
+            base::FilePath::FromUTF8Unsafe(Join(path, "package.json")),
+            &info))
+      return RESULT_NOT_FOUND;
+    if (info.unpacked)
+      return RESULT_UNHANDLED;
+
+    std::string content(info.size, 0);
+    if (info.size > 0 &&
+        archive_->ReadFile(info, 0, info.size, &content[0]) !=
+            static_cast<int>(info.size))
+      return RESULT_UNHANDLED;
+    scoped_ptr<base::Value> value(base::JSONReader::Read(content));
+    base::DictionaryValue* package;
+    if (!value || !value->GetAsDictionary(&package))
+      return RESULT_UNHANDLED;
+
+    std::string main;
+    if (!package->GetString("main", &main))
+      return RESULT_NOT_FOUND;
+    std::string filename;
+    if (!JoinArchivePath(path, main, &filename))
+      return RESULT_UNHANDLED;
+
+    Result result = TryFile(filename, real_path);
+    if (result == RESULT_NOT_FOUND)
+      result = TryExtensions(filename, real_path);
+    if (result == RESULT_NOT_FOUND)
+      result = TryExtensions(Join(filename, "index"), real_path);
+    return result;
+  }
+
+  static std::string Join(const std::string& dir, const std::string& name) {
+    return dir.empty() ? name : dir + "/" + name;
+  }
+
+  asar::Archive* archive_;
+  const std::vector<std::string>& extensions_;
+
+  DISALLOW_COPY_AND_ASSIGN(ModuleResolver);
+};
+
+v8::Local<v8::Value> StatsToV8(v8::Isolate* isolate,
+                               const asar::Archive::Stats& stats) {
+  mate::Dictionary dict(isolate, v8::Object::New(isolate));
+  dict.Set("size", stats.size);
+  dict.Set("offset", stats.offset);
+  dict.Set("isFile", stats.is_file);
+  dict.Set("isDirectory", stats.is_directory);
+  dict.Set("isLink", stats.is_link);
+  return dict.GetHandle();
+}
+
+// An operation on archive that does its work on a worker thread, and calls
+// |callback| with the result once done. The work does not go to libuv's
+// threadpool, so loading modules from archives never waits behind the slow fs
+// operations of the app.
+class AsyncRequest {
+ public:
+  AsyncRequest(v8::Isolate* isolate,
+               std::shared_ptr<asar::Archive> archive,
+               const base::FilePath& path,
+               v8::Local<v8::Function> callback)
+      : isolate_(isolate),
+        archive_(archive),
+        path_(path),
+        callback_(isolate, callback),
+        success_(false) {
+  }
+  virtual ~AsyncRequest() {}
+
+  // Starts the work, this object deletes itself after calling the callback.
+  void Queue() {
+    // The result is delivered through the uv loop of the caller, which also
+    // works in the threads of workers that have no MessageLoop.
+    uv_async_init(node::Environment::GetCurrent(isolate_)->event_loop(),
+                  &async_, &AsyncRequest::OnAfterWork);
+    async_.data = this;
+    base::WorkerPool::PostTask(
+        FROM_HERE, base::Bind(&AsyncRequest::OnWork, base::Unretained(this)),
+        false);
+  }
+
+ protected:
+  // Called on a worker thread, returns whether the operation succeeded.
+  virtual bool Work() = 0;
+
+  // Called on the main thread to convert the result when Work() succeeded.
+  virtual v8::Local<v8::Value> GetResult() = 0;
+
+  v8::Isolate* isolate() const { return isolate_; }
+  asar::Archive* archive() const { return archive_.get(); }
+  const base::FilePath& path() const { return path_; }
+
+ private:
+  static void OnWork(AsyncRequest* self) {
+    // The wrapper may have been destroyed before the request is queued.
+    self->success_ = self->archive_ && self->Work();
+    uv_async_send(&self->async_);
+  }
+
+  static void OnAfterWork(uv_async_t* handle) {
+    AsyncRequest* self = static_cast<AsyncRequest*>(handle->data);
+    // The request is deleted once the handle is closed.
+    uv_close(reinterpret_cast<uv_handle_t*>(handle), &AsyncRequest::OnClosed);
+
+    v8::Isolate* isolate = self->isolate_;
+    mate::Locker locker(isolate);
+    v8::HandleScope handle_scope(isolate);
+    scoped_ptr<blink::WebScopedRunV8Script> script_scope(
+        mate::Locker::IsBrowserProcess() ?
+        nullptr : new blink::WebScopedRunV8Script(isolate));
+    v8::Local<v8::Function> callback =
+        v8::Local<v8::Function>::New(isolate, self->callback_);
+    v8::Local<v8::Context> context = callback->CreationContext();
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::Value> result = self->success_ ?
+        self->GetResult() : v8::False(isolate).As<v8::Value>();
+    // Use node::MakeCallback so pending tasks in Node.js are also run.
+    node::MakeCallback(isolate, context->Global(), callback, 1, &result);
+  }
+
+  static void OnClosed(uv_handle_t* handle) {
+    delete static_cast<AsyncRequest*>(handle->data);
+  }
+
+  uv_async_t async_;
+  v8::Isolate* isolate_;
+  std::shared_ptr<asar::Archive> archive_;
+  base::FilePath path_;
+  v8::Global<v8::Function> callback_;
+  bool success_;
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncRequest);
+};
+
+// Finds and reads a packed file into a new Buffer.
+class ReadFileRequest : public AsyncRequest {
+ public:
+  // Reads at most |length| bytes starting at |offset| of the file.
+  ReadFileRequest(v8::Isolate* isolate,
+                  std::shared_ptr<asar::Archive> archive,
+                  const base::FilePath& path,
+                  uint64 offset,
+                  uint32 length,
+                  v8::Local<v8::Function> callback)
+      : AsyncRequest(isolate, archive, path, callback),
+        offset_(offset),
+        length_(length),
+        data_(nullptr),
+        size_(0) {}
+  ~ReadFileRequest() override {
+    free(data_);
+  }
+
+ protected:
+  bool Work() override {
+    asar::Archive::FileInfo info;
+    if (!archive()->GetFileInfo(path(), &info) || info.unpacked)
+      return false;
+    if (offset_ >= info.size)
+      return true;
+
+    // The size is bounded by |length_|, so reading chunks of a large file
+    // only ever holds one chunk in memory.
+    uint32 size = static_cast<uint32>(
+        std::min<uint64>(length_, info.size - offset_));
+    if (size == 0)
+      return true;
+    data_ = static_cast<char*>(malloc(size));
+    if (!data_)
+      return false;
+    size_ = size;
+    return archive()->ReadFile(info, offset_, size_, data_) ==
+        static_cast<int>(size_);
+  }
+
+  v8::Local<v8::Value> GetResult() override {
+    if (size_ == 0)
+      return node::Buffer::New(isolate(), 0).ToLocalChecked();
+
+    // The Buffer takes the ownership of |data_|.
+    v8::Local<v8::Object> buffer;
+    if (!node::Buffer::New(isolate(), data_, size_).ToLocal(&buffer))
+      return v8::False(isolate());
+    data_ = nullptr;
+    return buffer;
+  }
+
+ private:
+  uint64 offset_;
+  uint32 length_;
+  char* data_;
+  uint32 size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReadFileRequest);
+};
+
+// Returns a fake result of fs.stat(path).
+class StatRequest : public AsyncRequest {
+ public:
+  StatRequest(v8::Isolate* isolate,
+              std::shared_ptr<asar::Archive> archive,
+              const base::FilePath& path,
+              v8::Local<v8::Function> callback)
+      : AsyncRequest(isolate, archive, path, callback) {}
+
+ protected:
+  bool Work() override {
+    return archive()->Stat(path(), &stats_);
+  }
+
+  v8::Local<v8::Value> GetResult() override {
+    return StatsToV8(isolate(), stats_);
+  }
+
+ private:
+  asar::Archive::Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(StatRequest);
+};
+
 class Archive : public mate::Wrappable {
  public:
   static v8::Local<v8::Value> Create(v8::Isolate* isolate,
                                       const base::FilePath& path) {
-    scoped_ptr<asar::Archive> archive(new asar::Archive(path));
-    if (!archive->Init())
+    std::shared_ptr<asar::Archive> archive = asar::GetOrCreateAsarArchive(path);
+    if (!archive)
       return v8::False(isolate);
-    return (new Archive(archive.Pass()))->GetWrapper(isolate);
+    return (new Archive(archive))->GetWrapper(isolate);
   }
 
  protected:
-  explicit Archive(scoped_ptr<asar::Archive> archive)
-      : archive_(archive.Pass()) {}
+  explicit Archive(std::shared_ptr<asar::Archive> archive)
+      : archive_(archive) {}
 
   // Reads the offset and size of file.
   v8::Local<v8::Value> GetFileInfo(v8::Isolate* isolate,
@@ -42,6 +397,7 @@ class Archive : public mate::Wrappable {
     dict.Set("size", info.size);
     dict.Set("unpacked", info.unpacked);
     dict.Set("offset", info.offset);
+    dict.Set("compressed", info.compressed);
     return dict.GetHandle();
   }
 
@@ -51,13 +407,98 @@ class Archive : public mate::Wrappable {
     asar::Archive::Stats stats;
     if (!archive_ || !archive_->Stat(path, &stats))
       return v8::False(isolate);
-    mate::Dictionary dict(isolate, v8::Object::New(isolate));
-    dict.Set("size", stats.size);
-    dict.Set("offset", stats.offset);
-    dict.Set("isFile", stats.is_file);
-    dict.Set("isDirectory", stats.is_directory);
-    dict.Set("isLink", stats.is_link);
-    return dict.GetHandle();
+    return StatsToV8(isolate, stats);
+  }
+
+  // Stats all |paths| in one call, returns a Float64Array holding the flags,
+  // size and offset of each path, the flags are 0 for paths not found.
+  v8::Local<v8::Value> StatBatch(v8::Isolate* isolate,
+                                 const std::vector<base::FilePath>& paths) {
+    if (!archive_)
+      return v8::False(isolate);
+
+    size_t length = paths.size() * kStatBatchStride;
+    v8::Local<v8::ArrayBuffer> buffer =
+        v8::ArrayBuffer::New(isolate, length * sizeof(double));
+    double* results = static_cast<double*>(buffer->GetContents().Data());
+    for (size_t i = 0; i < paths.size(); ++i) {
+      double* result = results + i * kStatBatchStride;
+      asar::Archive::Stats stats;
+      if (!archive_->Stat(paths[i], &stats)) {
+        result[0] = result[1] = result[2] = 0;
+        continue;
+      }
+      int flags = 0;
+      if (stats.is_file)
+        flags |= STAT_FILE;
+      if (stats.is_directory)
+        flags |= STAT_DIRECTORY;
+      if (stats.is_link)
+        flags |= STAT_LINK;
+      if (stats.unpacked)
+        flags |= STAT_UNPACKED;
+      if (stats.compressed)
+        flags |= STAT_COMPRESSED;
+      result[0] = flags;
+      result[1] = stats.size;
+      result[2] = static_cast<double>(stats.offset);
+    }
+    return v8::Float64Array::New(buffer, 0, length);
+  }
+
+  // Resolves |request_path| as a module like Module._findPath does, returns
+  // the real path of the module, false when it is not found, or null when the
+  // JS resolver has to be used instead.
+  v8::Local<v8::Value> ResolveModule(
+      v8::Isolate* isolate,
+      const base::FilePath& request_path,
+      const std::vector<std::string>& extensions,
+      bool trailing_slash) {
+    if (!archive_)
+      return v8::Null(isolate);
+
+    std::string key = request_path.AsUTF8Unsafe();
+#if defined(OS_WIN)
+    std::replace(key.begin(), key.end(), '\\', '/');
+#endif
+    base::FilePath real_path;
+    ModuleResolver resolver(archive_.get(), extensions);
+    switch (resolver.Resolve(key, trailing_slash, &real_path)) {
+      case ModuleResolver::RESULT_FOUND:
+        return mate::ConvertToV8(isolate, real_path);
+      case ModuleResolver::RESULT_NOT_FOUND:
+        return v8::False(isolate);
+      default:
+        return v8::Null(isolate);
+    }
+  }
+
+  // Reads the whole packed file on a worker thread, and calls |callback| with
+  // a new Buffer, or false when the file is not found or is unpacked.
+  void ReadFileAsync(v8::Isolate* isolate,
+                     const base::FilePath& path,
+                     v8::Local<v8::Function> callback) {
+    (new ReadFileRequest(isolate, archive_, path, 0, kuint32max, callback))
+        ->Queue();
+  }
+
+  // Reads at most |length| bytes from |offset| of a packed file on a worker
+  // thread, and calls |callback| with a new Buffer, which is empty past the
+  // end of file, or false when the file is not found or is unpacked.
+  void ReadAsync(v8::Isolate* isolate,
+                 const base::FilePath& path,
+                 uint32 offset,
+                 uint32 length,
+                 v8::Local<v8::Function> callback) {
+    (new ReadFileRequest(isolate, archive_, path, offset, length, callback))
+        ->Queue();
+  }
+
+  // Like Stat but does the lookup on a worker thread.
+  void StatAsync(v8::Isolate* isolate,
+                 const base::FilePath& path,
+                 v8::Local<v8::Function> callback) {
+    (new StatRequest(isolate, archive_, path, callback))->Queue();
   }
 
   // Returns all files under a directory.
@@ -78,6 +519,110 @@ class Archive : public mate::Wrappable {
     return mate::ConvertToV8(isolate, realpath);
   }
 
+  // Returns a Buffer sharing memory with the mapped archive. The memory is
+  // read-only, so the Buffer must not be written to or handed out to users.
+  v8::Local<v8::Value> GetFileView(v8::Isolate* isolate,
+                                   const base::FilePath& path) {
+    asar::Archive::FileInfo info;
+    base::StringPiece contents;
+    if (!archive_ || !archive_->GetFileInfo(path, &info) ||
+        !archive_->GetFileContents(info, &contents))
+      return v8::False(isolate);
+
+    if (contents.empty())
+      return node::Buffer::New(isolate, 0).ToLocalChecked();
+
+    // The Buffer keeps the archive, and thus the mapping, alive.
+    auto holder = new std::shared_ptr<asar::Archive>(archive_);
+    auto buffer = node::Buffer::New(isolate,
+                                    const_cast<char*>(contents.data()),
+                                    contents.size(),
+                                    &ReleaseArchive,
+                                    holder);
+    if (buffer.IsEmpty()) {
+      delete holder;
+      return v8::False(isolate);
+    }
+    return buffer.ToLocalChecked();
+  }
+
+  // Reads |length| bytes from |offset| of a packed file into a new Buffer,
+  // decompressing the file when needed.
+  v8::Local<v8::Value> Read(v8::Isolate* isolate,
+                            const base::FilePath& path,
+                            uint32 offset,
+                            uint32 length) {
+    asar::Archive::FileInfo info;
+    if (!archive_ || !archive_->GetFileInfo(path, &info) || info.unpacked)
+      return v8::False(isolate);
+
+    if (offset >= info.size)
+      length = 0;
+    else if (length > info.size - offset)
+      length = info.size - offset;
+
+    auto buffer = node::Buffer::New(isolate, length);
+    if (buffer.IsEmpty())
+      return v8::False(isolate);
+    v8::Local<v8::Object> result = buffer.ToLocalChecked();
+    if (length > 0 &&
+        archive_->ReadFile(info, offset, length, node::Buffer::Data(result)) !=
+            static_cast<int>(length))
+      return v8::False(isolate);
+    return result;
+  }
+
+  // Verifies all files in archive in background, and calls |callback| with
+  // whether they are all intact.
+  void VerifyIntegrity(const base::Callback<void(bool)>& callback) {
+    if (archive_)
+      asar::VerifyAsarArchive(archive_, callback);
+  }
+
+  // Compiles and runs |source| as the script of |filename|, consuming the
+  // code cache the archive has for the source.
+  // Returns the result of the script, exceptions thrown while compiling or
+  // running are passed on to the caller.
+  void CompileWithCache(mate::Arguments* args) {
+    v8::Isolate* isolate = args->isolate();
+    v8::Local<v8::String> source;
+    v8::Local<v8::Value> filename;
+    if (!args->GetNext(&source) || !args->GetNext(&filename)) {
+      args->ThrowError();
+      return;
+    }
+
+    v8::String::Utf8Value utf8_source(source);
+    std::string key = asar::GetCodeCacheKey(
+        base::StringPiece(*utf8_source, utf8_source.length()),
+        v8::V8::GetVersion());
+    std::string cache;
+    bool has_cache = asar::ReadCodeCache(archive_.get(), key, &cache);
+
+    // The source takes the ownership of |cached_data|, the buffer itself is
+    // still owned by |cache|.
+    v8::ScriptCompiler::CachedData* cached_data = nullptr;
+    if (has_cache)
+      cached_data = new v8::ScriptCompiler::CachedData(
+          reinterpret_cast<const uint8_t*>(cache.data()),
+          static_cast<int>(cache.size()));
+    v8::ScriptCompiler::Source script_source(
+        source, v8::ScriptOrigin(filename), cached_data);
+
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Script> script;
+    if (!v8::ScriptCompiler::Compile(
+            context, &script_source,
+            has_cache ? v8::ScriptCompiler::kConsumeCodeCache :
+                        v8::ScriptCompiler::kNoCompileOptions)
+            .ToLocal(&script))
+      return;
+
+    v8::Local<v8::Value> result;
+    if (script->Run(context).ToLocal(&result))
+      args->Return(result);
+  }
+
   // Copy the file out into a temporary file and returns the new path.
   v8::Local<v8::Value> CopyFileOut(v8::Isolate* isolate,
                                     const base::FilePath& path) {
@@ -87,6 +632,15 @@ class Archive : public mate::Wrappable {
     return mate::ConvertToV8(isolate, new_path);
   }
 
+  // Like CopyFileOut, but the path can be passed to child processes.
+  v8::Local<v8::Value> CopyFileOutForChildProcess(v8::Isolate* isolate,
+                                                  const base::FilePath& path) {
+    base::FilePath new_path;
+    if (!archive_ || !archive_->CopyFileOutForChildProcess(path, &new_path))
+      return v8::False(isolate);
+    return mate::ConvertToV8(isolate, new_path);
+  }
+
   // Return the file descriptor.
   int GetFD() const {
     if (!archive_)
@@ -105,19 +659,65 @@ class Archive : public mate::Wrappable {
         .SetValue("path", archive_->path())
         .SetMethod("getFileInfo", &Archive::GetFileInfo)
         .SetMethod("stat", &Archive::Stat)
+        .SetMethod("statAsync", &Archive::StatAsync)
+        .SetMethod("statBatch", &Archive::StatBatch)
+        .SetMethod("resolveModule", &Archive::ResolveModule)
         .SetMethod("readdir", &Archive::Readdir)
         .SetMethod("realpath", &Archive::Realpath)
+        .SetMethod("getFileView", &Archive::GetFileView)
+        .SetMethod("read", &Archive::Read)
+        .SetMethod("readFileAsync", &Archive::ReadFileAsync)
+        .SetMethod("readAsync", &Archive::ReadAsync)
+        .SetMethod("verifyIntegrity", &Archive::VerifyIntegrity)
+        .SetMethod("compileWithCache", &Archive::CompileWithCache)
         .SetMethod("copyFileOut", &Archive::CopyFileOut)
+        .SetMethod("copyFileOutForChildProcess",
+                   &Archive::CopyFileOutForChildProcess)
         .SetMethod("getFd", &Archive::GetFD)
         .SetMethod("destroy", &Archive::Destroy);
   }
 
  private:
-  scoped_ptr<asar::Archive> archive_;
+  std::shared_ptr<asar::Archive> archive_;
 
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
 
+// Compiles |source| without running it, and returns the key and the data of
+// its code cache, which is used at build time to put the code caches into
+// archives.
+v8::Local<v8::Value> CreateCodeCache(mate::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  v8::Local<v8::String> source;
+  v8::Local<v8::Value> filename;
+  if (!args->GetNext(&source) || !args->GetNext(&filename)) {
+    args->ThrowError();
+    return v8::Null(isolate);
+  }
+
+  v8::ScriptCompiler::Source script_source(source, v8::ScriptOrigin(filename));
+  v8::Local<v8::Script> script;
+  if (!v8::ScriptCompiler::Compile(isolate->GetCurrentContext(),
+                                   &script_source,
+                                   v8::ScriptCompiler::kProduceCodeCache)
+           .ToLocal(&script))
+    return v8::Null(isolate);
+
+  const v8::ScriptCompiler::CachedData* data = script_source.GetCachedData();
+  if (!data || data->length == 0)
+    return v8::Null(isolate);
+
+  v8::String::Utf8Value utf8_source(source);
+  mate::Dictionary result = mate::Dictionary::CreateEmpty(isolate);
+  result.Set("key", asar::GetCodeCacheKey(
+      base::StringPiece(*utf8_source, utf8_source.length()),
+      v8::V8::GetVersion()));
+  result.Set("data", node::Buffer::Copy(
+      isolate, reinterpret_cast<const char*>(data->data), data->length)
+          .ToLocalChecked());
+  return result.GetHandle();
+}
+
 void InitAsarSupport(v8::Isolate* isolate,
                      v8::Local<v8::Value> process,
                      v8::Local<v8::Value> require) {
@@ -144,6 +744,14 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("createArchive", &Archive::Create);
+  dict.Set("maxCachedArchives",
+           static_cast<uint32>(asar::kMaxCachedArchives));
+  dict.Set("STAT_FILE", static_cast<int>(STAT_FILE));
+  dict.Set("STAT_DIRECTORY", static_cast<int>(STAT_DIRECTORY));
+  dict.Set("STAT_LINK", static_cast<int>(STAT_LINK));
+  dict.Set("STAT_UNPACKED", static_cast<int>(STAT_UNPACKED));
+  dict.Set("STAT_COMPRESSED", static_cast<int>(STAT_COMPRESSED));
+  dict.SetMethod("createCodeCache", &CreateCodeCache);
   dict.SetMethod("initAsarSupport", &InitAsarSupport);
 }
 
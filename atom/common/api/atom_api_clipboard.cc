@@ -5,9 +5,17 @@
 #include <string>
 #include <vector>
 
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/image_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/lazy_instance.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task_runner_util.h"
+#include "base/thread_task_runner_handle.h"
+#include "base/threading/thread.h"
+#include "content/public/common/content_switches.h"
 #include "native_mate/arguments.h"
 #include "native_mate/dictionary.h"
 #include "third_party/skia/include/core/SkBitmap.h"
@@ -19,6 +27,45 @@
 
 namespace {
 
+using ReadCallback = base::Callback<void(v8::Local<v8::Value>)>;
+
+// The thread the asynchronous methods use the clipboard on.
+struct ClipboardThread {
+  scoped_ptr<base::Thread> thread;
+};
+
+base::LazyInstance<ClipboardThread> g_clipboard_thread =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Renderers on Windows and OS X use the clipboard on their own thread. The
+// browser process only allows the clipboard on its UI thread, and on Linux the
+// X11 selections are served by the UI thread's event loop, so there the work
+// is only moved out of the caller's task.
+scoped_refptr<base::SingleThreadTaskRunner> GetClipboardTaskRunner() {
+#if !defined(OS_LINUX)
+  const base::CommandLine* command_line =
+      base::CommandLine::ForCurrentProcess();
+  if (command_line->GetSwitchValueASCII(switches::kProcessType) ==
+      switches::kRendererProcess) {
+    scoped_ptr<base::Thread>& thread = g_clipboard_thread.Get().thread;
+    if (!thread) {
+      thread.reset(new base::Thread("Clipboard"));
+#if defined(OS_WIN)
+      // The clipboard window needs its messages pumped.
+      base::Thread::Options options(base::MessageLoop::TYPE_UI, 0);
+#else
+      base::Thread::Options options;
+#endif
+      if (!thread->StartWithOptions(options))
+        thread.reset();
+    }
+    if (thread)
+      return thread->task_runner();
+  }
+#endif
+  return base::ThreadTaskRunnerHandle::Get();
+}
+
 ui::ClipboardType GetClipboardType(mate::Arguments* args) {
   std::string type;
   if (args->GetNext(&type) && type == "selection")
@@ -41,8 +88,7 @@ bool Has(const std::string& format_string, mate::Arguments* args) {
   return clipboard->IsFormatAvailable(format, GetClipboardType(args));
 }
 
-std::string Read(const std::string& format_string,
-                 mate::Arguments* args) {
+std::string ReadData(const std::string& format_string) {
   ui::Clipboard* clipboard = ui::Clipboard::GetForCurrentThread();
   ui::Clipboard::FormatType format(ui::Clipboard::GetFormatType(format_string));
 
@@ -51,6 +97,18 @@ std::string Read(const std::string& format_string,
   return data;
 }
 
+std::string Read(const std::string& format_string,
+                 mate::Arguments* args) {
+  return ReadData(format_string);
+}
+
+v8::Local<v8::Value> ReadBuffer(const std::string& format_string,
+                                mate::Arguments* args) {
+  std::string data = ReadData(format_string);
+  return node::Buffer::Copy(args->isolate(), data.data(),
+                            data.size()).ToLocalChecked();
+}
+
 void Write(const mate::Dictionary& data,
            mate::Arguments* args) {
   ui::ScopedClipboardWriter writer(GetClipboardType(args));
@@ -67,10 +125,9 @@ void Write(const mate::Dictionary& data,
     writer.WriteImage(image.AsBitmap());
 }
 
-base::string16 ReadText(mate::Arguments* args) {
+base::string16 ReadTextOfType(ui::ClipboardType type) {
   base::string16 data;
   ui::Clipboard* clipboard = ui::Clipboard::GetForCurrentThread();
-  auto type = GetClipboardType(args);
   if (clipboard->IsFormatAvailable(
       ui::Clipboard::GetPlainTextWFormatType(), type)) {
     clipboard->ReadText(type, &data);
@@ -83,32 +140,43 @@ base::string16 ReadText(mate::Arguments* args) {
   return data;
 }
 
+base::string16 ReadText(mate::Arguments* args) {
+  return ReadTextOfType(GetClipboardType(args));
+}
+
 void WriteText(const base::string16& text, mate::Arguments* args) {
   ui::ScopedClipboardWriter writer(GetClipboardType(args));
   writer.WriteText(text);
 }
 
-base::string16 ReadHtml(mate::Arguments* args) {
+base::string16 ReadHtmlOfType(ui::ClipboardType type) {
   base::string16 data;
   base::string16 html;
   std::string url;
   uint32 start;
   uint32 end;
   ui::Clipboard* clipboard = ui::Clipboard::GetForCurrentThread();
-  clipboard->ReadHTML(GetClipboardType(args), &html, &url, &start, &end);
+  clipboard->ReadHTML(type, &html, &url, &start, &end);
   data = html.substr(start, end - start);
   return data;
 }
 
+base::string16 ReadHtml(mate::Arguments* args) {
+  return ReadHtmlOfType(GetClipboardType(args));
+}
+
 void WriteHtml(const base::string16& html, mate::Arguments* args) {
   ui::ScopedClipboardWriter writer(GetClipboardType(args));
   writer.WriteHTML(html, std::string());
 }
 
+SkBitmap ReadImageOfType(ui::ClipboardType type) {
+  return ui::Clipboard::GetForCurrentThread()->ReadImage(type);
+}
+
 gfx::Image ReadImage(mate::Arguments* args) {
-  ui::Clipboard* clipboard = ui::Clipboard::GetForCurrentThread();
-  SkBitmap bitmap = clipboard->ReadImage(GetClipboardType(args));
-  return gfx::Image::CreateFrom1xBitmap(bitmap);
+  return gfx::Image::CreateFrom1xBitmap(
+      ReadImageOfType(GetClipboardType(args)));
 }
 
 void WriteImage(const gfx::Image& image, mate::Arguments* args) {
@@ -120,12 +188,100 @@ void Clear(mate::Arguments* args) {
   ui::Clipboard::GetForCurrentThread()->Clear(GetClipboardType(args));
 }
 
+void OnStringRead(v8::Isolate* isolate,
+                  const ReadCallback& callback,
+                  const base::string16& data) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(mate::ConvertToV8(isolate, data));
+}
+
+void OnDataRead(v8::Isolate* isolate,
+                const ReadCallback& callback,
+                const std::string& data) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(node::Buffer::Copy(isolate, data.data(),
+                                  data.size()).ToLocalChecked());
+}
+
+void OnImageRead(v8::Isolate* isolate,
+                 const ReadCallback& callback,
+                 const SkBitmap& bitmap) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(mate::ConvertToV8(isolate,
+                                 gfx::Image::CreateFrom1xBitmap(bitmap)));
+}
+
+void ReadTextAsync(const ReadCallback& callback, mate::Arguments* args) {
+  base::PostTaskAndReplyWithResult(
+      GetClipboardTaskRunner().get(), FROM_HERE,
+      base::Bind(&ReadTextOfType, GetClipboardType(args)),
+      base::Bind(&OnStringRead, args->isolate(), callback));
+}
+
+void ReadHtmlAsync(const ReadCallback& callback, mate::Arguments* args) {
+  base::PostTaskAndReplyWithResult(
+      GetClipboardTaskRunner().get(), FROM_HERE,
+      base::Bind(&ReadHtmlOfType, GetClipboardType(args)),
+      base::Bind(&OnStringRead, args->isolate(), callback));
+}
+
+void ReadImageAsync(const ReadCallback& callback, mate::Arguments* args) {
+  base::PostTaskAndReplyWithResult(
+      GetClipboardTaskRunner().get(), FROM_HERE,
+      base::Bind(&ReadImageOfType, GetClipboardType(args)),
+      base::Bind(&OnImageRead, args->isolate(), callback));
+}
+
+void ReadBufferAsync(const std::string& format_string,
+                     const ReadCallback& callback,
+                     mate::Arguments* args) {
+  base::PostTaskAndReplyWithResult(
+      GetClipboardTaskRunner().get(), FROM_HERE,
+      base::Bind(&ReadData, format_string),
+      base::Bind(&OnDataRead, args->isolate(), callback));
+}
+
+void WriteOnThread(ui::ClipboardType type,
+                   const base::string16& text, bool has_text,
+                   const base::string16& html, bool has_html,
+                   const SkBitmap& bitmap) {
+  ui::ScopedClipboardWriter writer(type);
+  if (has_text)
+    writer.WriteText(text);
+  if (has_html)
+    writer.WriteHTML(html, std::string());
+  if (!bitmap.isNull())
+    writer.WriteImage(bitmap);
+}
+
+void WriteAsync(const mate::Dictionary& data,
+                const base::Closure& callback,
+                mate::Arguments* args) {
+  // The values are converted on this thread, only the writing is moved.
+  base::string16 text, html;
+  gfx::Image image;
+  bool has_text = data.Get("text", &text);
+  bool has_html = data.Get("html", &html);
+  SkBitmap bitmap;
+  if (data.Get("image", &image))
+    bitmap = image.AsBitmap();
+  GetClipboardTaskRunner()->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&WriteOnThread, GetClipboardType(args),
+                 text, has_text, html, has_html, bitmap),
+      callback);
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("availableFormats", &AvailableFormats);
   dict.SetMethod("has", &Has);
   dict.SetMethod("read", &Read);
+  dict.SetMethod("readBuffer", &ReadBuffer);
   dict.SetMethod("write", &Write);
   dict.SetMethod("readText", &ReadText);
   dict.SetMethod("writeText", &WriteText);
@@ -134,6 +290,11 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("readImage", &ReadImage);
   dict.SetMethod("writeImage", &WriteImage);
   dict.SetMethod("clear", &Clear);
+  dict.SetMethod("_readTextAsync", &ReadTextAsync);
+  dict.SetMethod("_readHtmlAsync", &ReadHtmlAsync);
+  dict.SetMethod("_readImageAsync", &ReadImageAsync);
+  dict.SetMethod("_readBufferAsync", &ReadBufferAsync);
+  dict.SetMethod("_writeAsync", &WriteAsync);
 }
 
 }  // namespace
@@ -33,6 +33,26 @@ struct Converter<std::map<std::string, std::string> > {
   }
 };
 
+template<>
+struct Converter<CrashReporter::DumpMode> {
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     CrashReporter::DumpMode* out) {
+    std::string mode;
+    if (!ConvertFromV8(isolate, val, &mode))
+      return false;
+    if (mode == "stacks")
+      *out = CrashReporter::DUMP_MODE_STACKS;
+    else if (mode == "normal")
+      *out = CrashReporter::DUMP_MODE_NORMAL;
+    else if (mode == "full")
+      *out = CrashReporter::DUMP_MODE_FULL;
+    else
+      return false;
+    return true;
+  }
+};
+
 template<>
 struct Converter<CrashReporter::UploadReportResult> {
   static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
@@ -55,6 +75,8 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   auto report = base::Unretained(CrashReporter::GetInstance());
   dict.SetMethod("start",
                  base::Bind(&CrashReporter::Start, report));
+  dict.SetMethod("_setDumpMode",
+                 base::Bind(&CrashReporter::SetDumpMode, report));
   dict.SetMethod("_getUploadedReports",
                  base::Bind(&CrashReporter::GetUploadedReports, report));
 }
@@ -4,29 +4,48 @@
 
 #include "atom/common/api/atom_api_native_image.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "atom/common/asar/archive.h"
 #include "atom/common/asar/asar_util.h"
+#include "atom/common/image_encoder.h"
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/node_includes.h"
 #include "base/base64.h"
+#include "base/bind.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file_util.h"
+#include "base/lazy_instance.h"
 #include "base/strings/string_util.h"
 #include "base/strings/pattern.h"
+#include "base/synchronization/lock.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
+#include "base/trace_event/trace_event.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "net/base/data_url.h"
+#include "skia/ext/image_operations.h"
 #include "ui/base/layout.h"
 #include "ui/gfx/codec/jpeg_codec.h"
 #include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/geometry/size.h"
 #include "ui/gfx/image/image_skia.h"
+#include "ui/gfx/image/image_skia_operations.h"
+#include "ui/gfx/image/image_skia_source.h"
 #include "ui/gfx/image/image_util.h"
 
 #if defined(OS_WIN)
-#include "atom/common/asar/archive.h"
 #include "base/win/scoped_gdi_object.h"
 #include "ui/gfx/icon_util.h"
 #endif
@@ -70,10 +89,48 @@ float GetScaleFactorFromPath(const base::FilePath& path) {
   return 1.0f;
 }
 
-bool AddImageSkiaRep(gfx::ImageSkia* image,
-                     const unsigned char* data,
-                     size_t size,
-                     double scale_factor) {
+// The decoded bitmaps of image files, shared by all threads. An entry is only
+// used while the file has the same modification time, so menus and tray icons
+// that load the same files again skip decoding them.
+struct DecodedImage {
+  base::Time last_modified;
+  SkBitmap bitmap;
+};
+
+using DecodedImageKey = std::pair<base::FilePath, float>;
+
+// The most images kept in the cache, larger bitmaps are not cached.
+const size_t kMaxCachedImages = 64;
+const size_t kMaxCachedImageBytes = 1024 * 1024;
+
+struct DecodedImageCache {
+  DecodedImageCache() : images(kMaxCachedImages) {}
+
+  base::Lock lock;
+  base::MRUCache<DecodedImageKey, DecodedImage> images;
+};
+
+base::LazyInstance<DecodedImageCache>::Leaky g_decoded_images =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Files in an asar archive have the modification time of the archive.
+bool GetLastModified(const base::FilePath& path, base::Time* last_modified) {
+  base::FilePath asar_path, relative_path;
+  base::File::Info info;
+  if (!base::GetFileInfo(
+          asar::GetAsarArchivePath(path, &asar_path, &relative_path) ?
+              asar_path : path,
+          &info))
+    return false;
+  *last_modified = info.last_modified;
+  return true;
+}
+
+bool AddImageRep(NativeImage::ImageReps* reps,
+                 const unsigned char* data,
+                 size_t size,
+                 double scale_factor) {
+  TRACE_EVENT1("electron.image", "NativeImage::Decode", "bytes", size);
   scoped_ptr<SkBitmap> decoded(new SkBitmap());
 
   // Try PNG first.
@@ -84,13 +141,29 @@ bool AddImageSkiaRep(gfx::ImageSkia* image,
   if (!decoded)
     return false;
 
-  image->AddRepresentation(gfx::ImageSkiaRep(*decoded, scale_factor));
+  reps->push_back(gfx::ImageSkiaRep(*decoded, scale_factor));
   return true;
 }
 
-bool AddImageSkiaRep(gfx::ImageSkia* image,
-                     const base::FilePath& path,
-                     double scale_factor) {
+bool AddImageRep(NativeImage::ImageReps* reps,
+                 const base::FilePath& path,
+                 double scale_factor) {
+  base::Time last_modified;
+  if (!GetLastModified(path, &last_modified))
+    return false;
+
+  DecodedImageCache& cache = g_decoded_images.Get();
+  DecodedImageKey key(path, static_cast<float>(scale_factor));
+  {
+    base::AutoLock auto_lock(cache.lock);
+    auto it = cache.images.Get(key);
+    if (it != cache.images.end() &&
+        it->second.last_modified == last_modified) {
+      reps->push_back(gfx::ImageSkiaRep(it->second.bitmap, scale_factor));
+      return true;
+    }
+  }
+
   std::string file_contents;
   if (!asar::ReadFileToString(path, &file_contents))
     return false;
@@ -98,26 +171,98 @@ bool AddImageSkiaRep(gfx::ImageSkia* image,
   const unsigned char* data =
       reinterpret_cast<const unsigned char*>(file_contents.data());
   size_t size = file_contents.size();
-  return AddImageSkiaRep(image, data, size, scale_factor);
+  if (!AddImageRep(reps, data, size, scale_factor))
+    return false;
+
+  SkBitmap bitmap = reps->back().sk_bitmap();
+  if (bitmap.getSize() <= kMaxCachedImageBytes) {
+    bitmap.setImmutable();
+    DecodedImage decoded = { last_modified, bitmap };
+    base::AutoLock auto_lock(cache.lock);
+    cache.images.Put(key, decoded);
+  }
+  return true;
 }
 
-bool PopulateImageSkiaRepsFromPath(gfx::ImageSkia* image,
-                                   const base::FilePath& path) {
-  bool succeed = false;
+bool ImageFileExists(const base::FilePath& path) {
+  base::FilePath asar_path, relative_path;
+  if (!asar::GetAsarArchivePath(path, &asar_path, &relative_path))
+    return base::PathExists(path);
+
+  std::shared_ptr<asar::Archive> archive =
+      asar::GetOrCreateAsarArchive(asar_path);
+  asar::Archive::Stats stats;
+  return archive && archive->Stat(relative_path, &stats);
+}
+
+// Finds the scale variants of |path| that exist, ordered by scale.
+void FindScaledPaths(const base::FilePath& path,
+                     NativeImage::ScaledPaths* paths) {
   std::string filename(path.BaseName().RemoveExtension().AsUTF8Unsafe());
-  if (base::MatchPattern(filename, "*@*x"))
+  if (base::MatchPattern(filename, "*@*x")) {
     // Don't search for other representations if the DPI has been specified.
-    return AddImageSkiaRep(image, path, GetScaleFactorFromPath(path));
-  else
-    succeed |= AddImageSkiaRep(image, path, 1.0f);
+    paths->push_back(std::make_pair(GetScaleFactorFromPath(path), path));
+    return;
+  }
 
-  for (const ScaleFactorPair& pair : kScaleFactorPairs)
-    succeed |= AddImageSkiaRep(image,
-                               path.InsertBeforeExtensionASCII(pair.name),
-                               pair.scale);
-  return succeed;
+  if (ImageFileExists(path))
+    paths->push_back(std::make_pair(1.0f, path));
+  for (const ScaleFactorPair& pair : kScaleFactorPairs) {
+    base::FilePath scaled_path = path.InsertBeforeExtensionASCII(pair.name);
+    if (ImageFileExists(scaled_path))
+      paths->push_back(std::make_pair(pair.scale, scaled_path));
+  }
+  std::sort(paths->begin(), paths->end());
+}
+
+// Decodes the variant closest to 1x, the others are left in |file| to be
+// decoded when they are first drawn.
+void PopulateImageFileFromPath(NativeImage::ImageFile* file,
+                               const base::FilePath& path) {
+  NativeImage::ScaledPaths paths;
+  FindScaledPaths(path, &paths);
+  std::stable_sort(paths.begin(), paths.end(),
+                   [](const std::pair<float, base::FilePath>& a,
+                      const std::pair<float, base::FilePath>& b) {
+                     return std::abs(a.first - 1) < std::abs(b.first - 1);
+                   });
+  for (size_t i = 0; i < paths.size(); ++i) {
+    if (AddImageRep(&file->reps, paths[i].second, paths[i].first)) {
+      file->lazy_paths.assign(paths.begin() + i + 1, paths.end());
+      std::sort(file->lazy_paths.begin(), file->lazy_paths.end());
+      return;
+    }
+  }
 }
 
+// Decodes the scale variants of an image file on demand.
+class ImageFileSource : public gfx::ImageSkiaSource {
+ public:
+  explicit ImageFileSource(const NativeImage::ScaledPaths& paths)
+      : paths_(paths) {}
+
+  // gfx::ImageSkiaSource:
+  gfx::ImageSkiaRep GetImageForScale(float scale) override {
+    // Use the smallest variant that is not smaller than |scale|.
+    const std::pair<float, base::FilePath>* best = &paths_.back();
+    for (const auto& path : paths_) {
+      if (path.first >= scale) {
+        best = &path;
+        break;
+      }
+    }
+    NativeImage::ImageReps reps;
+    if (!AddImageRep(&reps, best->second, best->first))
+      return gfx::ImageSkiaRep();
+    return reps.front();
+  }
+
+ private:
+  NativeImage::ScaledPaths paths_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImageFileSource);
+};
+
 #if defined(OS_MACOSX)
 bool IsTemplateFilename(const base::FilePath& path) {
   return (base::MatchPattern(path.value(), "*Template.*") ||
@@ -126,7 +271,8 @@ bool IsTemplateFilename(const base::FilePath& path) {
 #endif
 
 #if defined(OS_WIN)
-bool ReadImageSkiaFromICO(gfx::ImageSkia* image, const base::FilePath& path) {
+bool ReadImageRepsFromICO(NativeImage::ImageReps* reps,
+                          const base::FilePath& path) {
   // If file is in asar archive, we extract it to a temp file so LoadImage can
   // load it.
   base::FilePath asar_path, relative_path;
@@ -147,18 +293,86 @@ bool ReadImageSkiaFromICO(gfx::ImageSkia* image, const base::FilePath& path) {
 
   // Convert the icon from the Windows specific HICON to gfx::ImageSkia.
   scoped_ptr<SkBitmap> bitmap(IconUtil::CreateSkBitmapFromHICON(icon));
-  image->AddRepresentation(gfx::ImageSkiaRep(*bitmap, 1.0f));
+  reps->push_back(gfx::ImageSkiaRep(*bitmap, 1.0f));
   return true;
 }
 #endif
 
+// Reads the image at |path|, can be called on any thread.
+NativeImage::ImageFile ReadImageFile(const base::FilePath& path) {
+  NativeImage::ImageFile file;
+  if (path.MatchesExtension(FILE_PATH_LITERAL(".ico"))) {
+#if defined(OS_WIN)
+    ReadImageRepsFromICO(&file.reps, path);
+#endif
+  } else {
+    PopulateImageFileFromPath(&file, path);
+  }
+  return file;
+}
+
+NativeImage::ImageFile DecodeImageFile(const std::string& data,
+                                       double scale_factor) {
+  NativeImage::ImageFile file;
+  AddImageRep(&file.reps, reinterpret_cast<const unsigned char*>(data.data()),
+              data.size(), scale_factor);
+  return file;
+}
+
+void ClearDecodedImages() {
+  DecodedImageCache& cache = g_decoded_images.Get();
+  base::AutoLock auto_lock(cache.lock);
+  cache.images.Clear();
+}
+
+gfx::ImageSkia CreateImageSkia(const NativeImage::ImageReps& reps) {
+  gfx::ImageSkia image_skia;
+  for (const gfx::ImageSkiaRep& rep : reps)
+    image_skia.AddRepresentation(rep);
+  return image_skia;
+}
+
+using EncodeCallback =
+    base::Callback<void(v8::Local<v8::Value>, v8::Local<v8::Value>)>;
+
+void OnImageEncoded(v8::Isolate* isolate,
+                    const EncodeCallback& callback,
+                    scoped_refptr<base::RefCountedBytes> data) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  if (!data.get()) {
+    callback.Run(v8::Exception::Error(mate::StringToV8(
+                     isolate, "Failed to encode image")),
+                 v8::Null(isolate));
+    return;
+  }
+  callback.Run(v8::Null(isolate),
+               node::Buffer::Copy(isolate, data->front_as<char>(),
+                                  data->size()).ToLocalChecked());
+}
+
+// Reads the callback from |args| and encodes |image| on a worker thread.
+void EncodeAsync(mate::Arguments* args,
+                 const gfx::Image& image,
+                 const atom::ImageEncodeOptions& options) {
+  EncodeCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+  atom::EncodeBitmapAsync(image.AsBitmap(), options,
+                          base::Bind(&OnImageEncoded, args->isolate(),
+                                     callback));
+}
+
 v8::Persistent<v8::ObjectTemplate> template_;
 
 }  // namespace
 
-NativeImage::NativeImage() {}
+NativeImage::NativeImage() : base_scale_(1.0f) {}
 
-NativeImage::NativeImage(const gfx::Image& image) : image_(image) {}
+NativeImage::NativeImage(const gfx::Image& image)
+    : image_(image), base_scale_(1.0f) {}
 
 NativeImage::~NativeImage() {}
 
@@ -168,7 +382,12 @@ mate::ObjectTemplateBuilder NativeImage::GetObjectTemplateBuilder(
     template_.Reset(isolate, mate::ObjectTemplateBuilder(isolate)
         .SetMethod("toPng", &NativeImage::ToPNG)
         .SetMethod("toJpeg", &NativeImage::ToJPEG)
+        .SetMethod("toPngAsync", &NativeImage::ToPNGAsync)
+        .SetMethod("toJpegAsync", &NativeImage::ToJPEGAsync)
         .SetMethod("toDataUrl", &NativeImage::ToDataURL)
+        .SetMethod("getBitmap", &NativeImage::GetBitmap)
+        .SetMethod("resize", &NativeImage::Resize)
+        .SetMethod("crop", &NativeImage::Crop)
         .SetMethod("isEmpty", &NativeImage::IsEmpty)
         .SetMethod("getSize", &NativeImage::GetSize)
         .SetMethod("setTemplateImage", &NativeImage::SetTemplateImage)
@@ -180,6 +399,7 @@ mate::ObjectTemplateBuilder NativeImage::GetObjectTemplateBuilder(
 }
 
 v8::Local<v8::Value> NativeImage::ToPNG(v8::Isolate* isolate) {
+  TRACE_EVENT0("electron.image", "NativeImage::ToPNG");
   scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
   return node::Buffer::Copy(isolate,
                             reinterpret_cast<const char*>(png->front()),
@@ -187,6 +407,7 @@ v8::Local<v8::Value> NativeImage::ToPNG(v8::Isolate* isolate) {
 }
 
 v8::Local<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
+  TRACE_EVENT0("electron.image", "NativeImage::ToJPEG");
   std::vector<unsigned char> output;
   gfx::JPEG1xEncodedDataFromImage(image_, quality, &output);
   return node::Buffer::Copy(
@@ -195,6 +416,20 @@ v8::Local<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
       static_cast<size_t>(output.size())).ToLocalChecked();
 }
 
+void NativeImage::ToPNGAsync(mate::Arguments* args) {
+  EncodeAsync(args, image_, ImageEncodeOptions());
+}
+
+void NativeImage::ToJPEGAsync(mate::Arguments* args) {
+  ImageEncodeOptions options;
+  options.format = ImageEncodeOptions::FORMAT_JPEG;
+  if (!args->GetNext(&options.quality)) {
+    args->ThrowError();
+    return;
+  }
+  EncodeAsync(args, image_, options);
+}
+
 std::string NativeImage::ToDataURL() {
   scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
   std::string data_url;
@@ -204,6 +439,59 @@ std::string NativeImage::ToDataURL() {
   return data_url;
 }
 
+v8::Local<v8::Value> NativeImage::GetBitmap(mate::Arguments* args) {
+  float scale_factor = 1.0f;
+  args->GetNext(&scale_factor);
+  if (image_.IsEmpty())
+    return node::Buffer::New(args->isolate(), 0).ToLocalChecked();
+
+  // The pixels are shared with the image and with the other images decoded
+  // from the same file, so the Buffer gets a copy that can be changed freely.
+  gfx::ImageSkiaRep rep = image_.AsImageSkia().GetRepresentation(scale_factor);
+  const SkBitmap& bitmap = rep.sk_bitmap();
+  SkAutoLockPixels lock(bitmap);
+  if (!bitmap.getPixels())
+    return node::Buffer::New(args->isolate(), 0).ToLocalChecked();
+  return node::Buffer::Copy(args->isolate(),
+                            static_cast<const char*>(bitmap.getPixels()),
+                            bitmap.getSize()).ToLocalChecked();
+}
+
+mate::Handle<NativeImage> NativeImage::Resize(mate::Arguments* args,
+                                              int width,
+                                              int height) {
+  std::string quality = "good";
+  args->GetNext(&quality);
+  skia::ImageOperations::ResizeMethod method =
+      skia::ImageOperations::RESIZE_GOOD;
+  if (quality == "better") {
+    method = skia::ImageOperations::RESIZE_BETTER;
+  } else if (quality == "best") {
+    method = skia::ImageOperations::RESIZE_BEST;
+  } else if (quality != "good") {
+    args->ThrowError("Unknown resize quality: " + quality);
+    return CreateEmpty(args->isolate());
+  }
+
+  if (image_.IsEmpty() || width <= 0 || height <= 0)
+    return CreateEmpty(args->isolate());
+
+  gfx::ImageSkia resized = gfx::ImageSkiaOperations::CreateResizedImage(
+      image_.AsImageSkia(), method, gfx::Size(width, height));
+  return Create(args->isolate(), gfx::Image(resized));
+}
+
+mate::Handle<NativeImage> NativeImage::Crop(v8::Isolate* isolate,
+                                            const gfx::Rect& rect) {
+  gfx::Rect bounds = gfx::IntersectRects(rect, gfx::Rect(image_.Size()));
+  if (image_.IsEmpty() || bounds.IsEmpty())
+    return CreateEmpty(isolate);
+
+  gfx::ImageSkia cropped = gfx::ImageSkiaOperations::ExtractSubset(
+      image_.AsImageSkia(), bounds);
+  return Create(isolate, gfx::Image(cropped));
+}
+
 bool NativeImage::IsEmpty() {
   return image_.IsEmpty();
 }
@@ -251,34 +539,147 @@ mate::Handle<NativeImage> NativeImage::CreateFromJPEG(
 // static
 mate::Handle<NativeImage> NativeImage::CreateFromPath(
     v8::Isolate* isolate, const base::FilePath& path) {
+  return CreateFromImageFile(isolate, path, ReadImageFile(path));
+}
+
+// static
+mate::Handle<NativeImage> NativeImage::CreateFromBuffer(
+    mate::Arguments* args, v8::Local<v8::Value> buffer) {
+  double scale_factor = 1.;
+  args->GetNext(&scale_factor);
+
+  ImageReps reps;
+  AddImageRep(&reps,
+              reinterpret_cast<unsigned char*>(node::Buffer::Data(buffer)),
+              node::Buffer::Length(buffer),
+              scale_factor);
+  return Create(args->isolate(), gfx::Image(CreateImageSkia(reps)));
+}
+
+// static
+void NativeImage::CreateFromPathAsync(mate::Arguments* args,
+                                      const base::FilePath& path) {
+  DecodeCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+  base::PostTaskAndReplyWithResult(
+      base::WorkerPool::GetTaskRunner(true).get(),
+      FROM_HERE,
+      base::Bind(&ReadImageFile, path),
+      base::Bind(&NativeImage::OnImageFileDecoded, args->isolate(), path,
+                 callback));
+}
+
+// static
+void NativeImage::CreateFromBufferAsync(mate::Arguments* args,
+                                        v8::Local<v8::Value> buffer) {
+  double scale_factor = 1.;
+  DecodeCallback callback;
+  if (!node::Buffer::HasInstance(buffer) ||
+      (!args->GetNext(&callback) &&
+       !(args->GetNext(&scale_factor) && args->GetNext(&callback)))) {
+    args->ThrowError();
+    return;
+  }
+
+  // The Buffer may be changed while it is decoded, so it is copied.
+  std::string data(node::Buffer::Data(buffer), node::Buffer::Length(buffer));
+  base::PostTaskAndReplyWithResult(
+      base::WorkerPool::GetTaskRunner(true).get(),
+      FROM_HERE,
+      base::Bind(&DecodeImageFile, data, scale_factor),
+      base::Bind(&NativeImage::OnImageFileDecoded, args->isolate(),
+                 base::FilePath(), callback));
+}
+
+// static
+mate::Handle<NativeImage> NativeImage::CreateFromImageFile(
+    v8::Isolate* isolate, const base::FilePath& path, const ImageFile& file) {
+  bool lazy = !file.reps.empty() && !file.lazy_paths.empty();
   gfx::ImageSkia image_skia;
-  if (path.MatchesExtension(FILE_PATH_LITERAL(".ico"))) {
-#if defined(OS_WIN)
-    ReadImageSkiaFromICO(&image_skia, path);
-#endif
+  if (lazy) {
+    // The other variants are decoded when they are drawn at their scale.
+    const gfx::ImageSkiaRep& base_rep = file.reps.front();
+    image_skia = gfx::ImageSkia(
+        new ImageFileSource(file.lazy_paths),
+        gfx::Size(base_rep.GetWidth(), base_rep.GetHeight()));
+    image_skia.AddRepresentation(base_rep);
   } else {
-    PopulateImageSkiaRepsFromPath(&image_skia, path);
+    image_skia = CreateImageSkia(file.reps);
   }
-  gfx::Image image(image_skia);
-  mate::Handle<NativeImage> handle = Create(isolate, image);
+
+  mate::Handle<NativeImage> handle = Create(isolate, gfx::Image(image_skia));
 #if defined(OS_MACOSX)
   if (IsTemplateFilename(path))
     handle->SetTemplateImage(true);
 #endif
+  if (lazy) {
+    handle->base_scale_ = file.reps.front().scale();
+    handle->memory_pressure_listener_.reset(new base::MemoryPressureListener(
+        base::Bind(&NativeImage::OnMemoryPressure,
+                   base::Unretained(handle.get()))));
+  }
   return handle;
 }
 
 // static
-mate::Handle<NativeImage> NativeImage::CreateFromBuffer(
+void NativeImage::OnImageFileDecoded(v8::Isolate* isolate,
+                                     const base::FilePath& path,
+                                     const DecodeCallback& callback,
+                                     const ImageFile& file) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(CreateFromImageFile(isolate, path, file).ToV8());
+}
+
+void NativeImage::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  ClearDecodedImages();
+
+  // Drop the variants decoded on demand, they are decoded again the next
+  // time they are drawn.
+  gfx::ImageSkia image_skia = image_.AsImageSkia();
+  std::vector<float> scales;
+  for (const gfx::ImageSkiaRep& rep : image_skia.image_reps()) {
+    if (rep.scale() != base_scale_)
+      scales.push_back(rep.scale());
+  }
+  for (float scale : scales)
+    image_skia.RemoveRepresentation(scale);
+}
+
+// static
+mate::Handle<NativeImage> NativeImage::CreateFromBitmap(
     mate::Arguments* args, v8::Local<v8::Value> buffer) {
+  mate::Dictionary options;
+  int width = 0, height = 0;
   double scale_factor = 1.;
-  args->GetNext(&scale_factor);
+  if (!node::Buffer::HasInstance(buffer) || !args->GetNext(&options) ||
+      !options.Get("width", &width) || !options.Get("height", &height)) {
+    args->ThrowError();
+    return CreateEmpty(args->isolate());
+  }
+  options.Get("scaleFactor", &scale_factor);
 
-  gfx::ImageSkia image_skia;
-  AddImageSkiaRep(&image_skia,
-                  reinterpret_cast<unsigned char*>(node::Buffer::Data(buffer)),
-                  node::Buffer::Length(buffer),
-                  scale_factor);
+  size_t row_bytes = static_cast<size_t>(width) * 4;
+  if (width <= 0 || height <= 0 ||
+      node::Buffer::Length(buffer) < row_bytes * height) {
+    args->ThrowError("Buffer is smaller than the bitmap");
+    return CreateEmpty(args->isolate());
+  }
+
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocN32Pixels(width, height, false))
+    return CreateEmpty(args->isolate());
+  SkAutoLockPixels lock(bitmap);
+  const char* source = node::Buffer::Data(buffer);
+  char* dest = static_cast<char*>(bitmap.getPixels());
+  for (int y = 0; y < height; ++y)
+    memcpy(dest + y * bitmap.rowBytes(), source + y * row_bytes, row_bytes);
+
+  gfx::ImageSkia image_skia(gfx::ImageSkiaRep(bitmap, scale_factor));
   return Create(args->isolate(), gfx::Image(image_skia));
 }
 
@@ -309,8 +710,14 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("createEmpty", &atom::api::NativeImage::CreateEmpty);
   dict.SetMethod("createFromPath", &atom::api::NativeImage::CreateFromPath);
   dict.SetMethod("createFromBuffer", &atom::api::NativeImage::CreateFromBuffer);
+  dict.SetMethod("createFromPathAsync",
+                 &atom::api::NativeImage::CreateFromPathAsync);
+  dict.SetMethod("createFromBufferAsync",
+                 &atom::api::NativeImage::CreateFromBufferAsync);
   dict.SetMethod("createFromDataUrl",
                  &atom::api::NativeImage::CreateFromDataURL);
+  dict.SetMethod("createFromBitmap",
+                 &atom::api::NativeImage::CreateFromBitmap);
 }
 
 }  // namespace
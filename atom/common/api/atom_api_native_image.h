@@ -6,18 +6,22 @@
 #define ATOM_COMMON_API_ATOM_API_NATIVE_IMAGE_H_
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "native_mate/handle.h"
 #include "native_mate/wrappable.h"
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/scoped_ptr.h"
 #include "ui/gfx/image/image.h"
+#include "ui/gfx/image/image_skia_rep.h"
 
 class GURL;
 
-namespace base {
-class FilePath;
-}
-
 namespace gfx {
+class Rect;
 class Size;
 }
 
@@ -31,6 +35,18 @@ namespace api {
 
 class NativeImage : public mate::Wrappable {
  public:
+  using ImageReps = std::vector<gfx::ImageSkiaRep>;
+  using ScaledPaths = std::vector<std::pair<float, base::FilePath>>;
+
+  // The representations read from an image file, the variants in
+  // |lazy_paths| are only decoded when they are first drawn.
+  struct ImageFile {
+    ImageReps reps;
+    ScaledPaths lazy_paths;
+  };
+
+  using DecodeCallback = base::Callback<void(v8::Local<v8::Value>)>;
+
   static mate::Handle<NativeImage> CreateEmpty(v8::Isolate* isolate);
   static mate::Handle<NativeImage> Create(
       v8::Isolate* isolate, const gfx::Image& image);
@@ -44,6 +60,14 @@ class NativeImage : public mate::Wrappable {
       mate::Arguments* args, v8::Local<v8::Value> buffer);
   static mate::Handle<NativeImage> CreateFromDataURL(
       v8::Isolate* isolate, const GURL& url);
+  static mate::Handle<NativeImage> CreateFromBitmap(
+      mate::Arguments* args, v8::Local<v8::Value> buffer);
+
+  // Decode the image on a worker thread and pass it to the callback.
+  static void CreateFromPathAsync(mate::Arguments* args,
+                                  const base::FilePath& path);
+  static void CreateFromBufferAsync(mate::Arguments* args,
+                                    v8::Local<v8::Value> buffer);
 
   // The default constructor should only be used by image_converter.cc.
   NativeImage();
@@ -61,7 +85,17 @@ class NativeImage : public mate::Wrappable {
  private:
   v8::Local<v8::Value> ToPNG(v8::Isolate* isolate);
   v8::Local<v8::Value> ToJPEG(v8::Isolate* isolate, int quality);
+  // Encode the image on a worker thread.
+  void ToPNGAsync(mate::Arguments* args);
+  void ToJPEGAsync(mate::Arguments* args);
   std::string ToDataURL();
+  // Returns a Buffer with a copy of the pixels of the bitmap.
+  v8::Local<v8::Value> GetBitmap(mate::Arguments* args);
+  // Return new images without encoding the pixels.
+  mate::Handle<NativeImage> Resize(mate::Arguments* args,
+                                   int width,
+                                   int height);
+  mate::Handle<NativeImage> Crop(v8::Isolate* isolate, const gfx::Rect& rect);
   bool IsEmpty();
   gfx::Size GetSize();
 
@@ -70,8 +104,23 @@ class NativeImage : public mate::Wrappable {
   // Determine if the image is a template image.
   bool IsTemplateImage();
 
+  static mate::Handle<NativeImage> CreateFromImageFile(
+      v8::Isolate* isolate, const base::FilePath& path, const ImageFile& file);
+  static void OnImageFileDecoded(v8::Isolate* isolate,
+                                 const base::FilePath& path,
+                                 const DecodeCallback& callback,
+                                 const ImageFile& file);
+
+  // Drops the representations that were decoded on demand.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
   gfx::Image image_;
 
+  // The scale of the representation that is always kept.
+  float base_scale_;
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
   DISALLOW_COPY_AND_ASSIGN(NativeImage);
 };
 
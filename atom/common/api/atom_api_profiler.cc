@@ -0,0 +1,162 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
+#include "base/values.h"
+#include "native_mate/arguments.h"
+#include "native_mate/dictionary.h"
+#include "v8/include/v8-profiler.h"
+
+#include "atom/common/node_includes.h"
+
+namespace {
+
+const char kProfileTitle[] = "electron";
+
+// The sampling interval used when none is passed, same with DevTools.
+const int kDefaultSamplingIntervalUs = 1000;
+
+// Whether a profile is being recorded, the profiler is not shared with
+// DevTools.
+bool g_profiling = false;
+
+v8::Local<v8::String> ProfileTitle(v8::Isolate* isolate) {
+  return v8::String::NewFromUtf8(isolate, kProfileTitle);
+}
+
+std::string ToUTF8(v8::Local<v8::String> string) {
+  v8::String::Utf8Value utf8(string);
+  return std::string(*utf8, utf8.length());
+}
+
+// Converts the call tree to the nodes of .cpuprofile files.
+scoped_ptr<base::DictionaryValue> ProfileNodeToValue(
+    const v8::CpuProfileNode* node) {
+  scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue);
+  value->SetString("functionName", ToUTF8(node->GetFunctionName()));
+  value->SetString("scriptId", base::IntToString(node->GetScriptId()));
+  value->SetString("url", ToUTF8(node->GetScriptResourceName()));
+  value->SetInteger("lineNumber", node->GetLineNumber());
+  value->SetInteger("columnNumber", node->GetColumnNumber());
+  value->SetInteger("hitCount", node->GetHitCount());
+  value->SetInteger("callUID", node->GetCallUid());
+  value->SetInteger("id", node->GetNodeId());
+  value->SetString("deoptReason", node->GetBailoutReason());
+
+  scoped_ptr<base::ListValue> children(new base::ListValue);
+  for (int i = 0; i < node->GetChildrenCount(); ++i)
+    children->Append(ProfileNodeToValue(node->GetChild(i)).release());
+  value->Set("children", children.release());
+  return value.Pass();
+}
+
+scoped_ptr<base::DictionaryValue> ProfileToValue(
+    const v8::CpuProfile* profile) {
+  scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue);
+  value->Set("head", ProfileNodeToValue(profile->GetTopDownRoot()).release());
+  // The times of the profile are in seconds, the ones of samples in
+  // microseconds.
+  value->SetDouble("startTime", profile->GetStartTime() / 1e6);
+  value->SetDouble("endTime", profile->GetEndTime() / 1e6);
+
+  scoped_ptr<base::ListValue> samples(new base::ListValue);
+  scoped_ptr<base::ListValue> timestamps(new base::ListValue);
+  for (int i = 0; i < profile->GetSamplesCount(); ++i) {
+    samples->AppendInteger(profile->GetSample(i)->GetNodeId());
+    timestamps->AppendDouble(
+        static_cast<double>(profile->GetSampleTimestamp(i)));
+  }
+  value->Set("samples", samples.release());
+  value->Set("timestamps", timestamps.release());
+  return value.Pass();
+}
+
+bool WriteProfile(const base::FilePath& path,
+                  scoped_ptr<base::DictionaryValue> profile) {
+  std::string json;
+  if (!base::JSONWriter::Write(*profile, &json))
+    return false;
+  return base::WriteFile(path, json.data(), json.size()) ==
+      static_cast<int>(json.size());
+}
+
+void StartProfiling(mate::Arguments* args) {
+  if (g_profiling) {
+    args->ThrowError("The profiler is already running");
+    return;
+  }
+
+  int sampling_interval = kDefaultSamplingIntervalUs;
+  mate::Dictionary options;
+  if (args->GetNext(&options))
+    options.Get("samplingIntervalUs", &sampling_interval);
+  if (sampling_interval <= 0) {
+    args->ThrowError("samplingIntervalUs must be positive");
+    return;
+  }
+
+  v8::Isolate* isolate = args->isolate();
+  v8::CpuProfiler* profiler = isolate->GetCpuProfiler();
+  profiler->SetSamplingInterval(sampling_interval);
+  profiler->StartProfiling(ProfileTitle(isolate), true);
+  g_profiling = true;
+}
+
+// The profile is converted on current thread, since it belongs to V8, and
+// serialized and written on a worker thread.
+void StopProfiling(mate::Arguments* args) {
+  base::FilePath path;
+  base::Callback<void(bool)> callback;
+  if (!args->GetNext(&path) || !args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+  if (!g_profiling) {
+    args->ThrowError("The profiler is not running");
+    return;
+  }
+
+  v8::Isolate* isolate = args->isolate();
+  v8::CpuProfile* profile =
+      isolate->GetCpuProfiler()->StopProfiling(ProfileTitle(isolate));
+  g_profiling = false;
+  if (!profile) {
+    callback.Run(false);
+    return;
+  }
+
+  scoped_ptr<base::DictionaryValue> value = ProfileToValue(profile);
+  profile->Delete();
+
+  base::PostTaskAndReplyWithResult(
+      base::WorkerPool::GetTaskRunner(true).get(),
+      FROM_HERE,
+      base::Bind(&WriteProfile, path, base::Passed(&value)),
+      callback);
+}
+
+bool IsProfiling() {
+  return g_profiling;
+}
+
+void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
+                v8::Local<v8::Context> context, void* priv) {
+  mate::Dictionary dict(context->GetIsolate(), exports);
+  dict.SetMethod("startProfiling", &StartProfiling);
+  dict.SetMethod("stopProfiling", &StopProfiling);
+  dict.SetMethod("isProfiling", &IsProfiling);
+}
+
+}  // namespace
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(atom_common_profiler, Initialize)
@@ -3,15 +3,87 @@
 // found in the LICENSE file.
 
 #include <string>
+#include <vector>
 
 #include "atom/common/platform_util.h"
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/node_includes.h"
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/task_runner_util.h"
+#include "base/thread_task_runner_handle.h"
+#include "base/threading/worker_pool.h"
 #include "native_mate/dictionary.h"
+#include "url/gurl.h"
+
+#if defined(OS_WIN)
+#include "base/win/scoped_com_initializer.h"
+#endif
 
 namespace {
 
+using ResultCallback = base::Callback<void(bool)>;
+
+// The operations can block for long, e.g. waiting for xdg-open on Linux or
+// for shell calls on network shares on Windows, so the asynchronous methods
+// run them on the worker pool. NSWorkspace is only used on the main thread,
+// so on OS X the operations using it are only moved out of the caller's task.
+scoped_refptr<base::TaskRunner> GetTaskRunner(bool uses_workspace) {
+#if defined(OS_MACOSX)
+  if (uses_workspace)
+    return base::ThreadTaskRunnerHandle::Get();
+#endif
+  return base::WorkerPool::GetTaskRunner(true);
+}
+
+bool RunOperation(const base::Callback<bool()>& operation) {
+#if defined(OS_WIN)
+  // The shell functions need COM on the calling thread.
+  base::win::ScopedCOMInitializer com_initializer;
+#endif
+  return operation.Run();
+}
+
+void PostOperation(bool uses_workspace,
+                   const base::Callback<bool()>& operation,
+                   const ResultCallback& callback) {
+  base::PostTaskAndReplyWithResult(
+      GetTaskRunner(uses_workspace).get(), FROM_HERE,
+      base::Bind(&RunOperation, operation), callback);
+}
+
+bool ShowItemInFolder(const base::FilePath& full_path) {
+  platform_util::ShowItemInFolder(full_path);
+  return true;
+}
+
+bool OpenItem(const base::FilePath& full_path) {
+  platform_util::OpenItem(full_path);
+  return true;
+}
+
+void ShowItemInFolderAsync(const base::FilePath& full_path,
+                           const ResultCallback& callback) {
+  PostOperation(true, base::Bind(&ShowItemInFolder, full_path), callback);
+}
+
+void OpenItemAsync(const base::FilePath& full_path,
+                   const ResultCallback& callback) {
+  PostOperation(true, base::Bind(&OpenItem, full_path), callback);
+}
+
+void OpenExternalAsync(const GURL& url, const ResultCallback& callback) {
+  PostOperation(true, base::Bind(&platform_util::OpenExternal, url), callback);
+}
+
+void MoveItemsToTrashAsync(const std::vector<base::FilePath>& full_paths,
+                           const ResultCallback& callback) {
+  PostOperation(false, base::Bind(&platform_util::MoveItemsToTrash, full_paths),
+                callback);
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
@@ -19,7 +91,12 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("openItem", &platform_util::OpenItem);
   dict.SetMethod("openExternal", &platform_util::OpenExternal);
   dict.SetMethod("moveItemToTrash", &platform_util::MoveItemToTrash);
+  dict.SetMethod("moveItemsToTrash", &platform_util::MoveItemsToTrash);
   dict.SetMethod("beep", &platform_util::Beep);
+  dict.SetMethod("_showItemInFolderAsync", &ShowItemInFolderAsync);
+  dict.SetMethod("_openItemAsync", &OpenItemAsync);
+  dict.SetMethod("_openExternalAsync", &OpenExternalAsync);
+  dict.SetMethod("_moveItemsToTrashAsync", &MoveItemsToTrashAsync);
 }
 
 }  // namespace
@@ -3,12 +3,49 @@
 // found in the LICENSE file.
 
 #include "atom/common/api/object_life_monitor.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/node_includes.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/threading/thread_restrictions.h"
+#include "native_mate/arguments.h"
 #include "native_mate/dictionary.h"
 #include "v8/include/v8-profiler.h"
 
 namespace {
 
+const int kSnapshotChunkSize = 64 * 1024;
+
+// Writes a heap snapshot to a file while V8 serializes it, so its JSON is
+// never held in memory as a whole.
+class FileOutputStream : public v8::OutputStream {
+ public:
+  explicit FileOutputStream(base::File* file)
+      : file_(file), size_(0), failed_(false) {}
+
+  // v8::OutputStream:
+  int GetChunkSize() override { return kSnapshotChunkSize; }
+  void EndOfStream() override {}
+  WriteResult WriteAsciiChunk(char* data, int size) override {
+    if (file_->WriteAtCurrentPos(data, size) != size) {
+      failed_ = true;
+      return kAbort;
+    }
+    size_ += size;
+    return kContinue;
+  }
+
+  int64 size() const { return size_; }
+  bool failed() const { return failed_; }
+
+ private:
+  base::File* file_;
+  int64 size_;
+  bool failed_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileOutputStream);
+};
+
 v8::Local<v8::Object> CreateObjectWithName(v8::Isolate* isolate,
                                             v8::Local<v8::String> name) {
   v8::Local<v8::FunctionTemplate> t = v8::FunctionTemplate::New(isolate);
@@ -42,8 +79,50 @@ void SetDestructor(v8::Isolate* isolate,
   atom::ObjectLifeMonitor::BindTo(isolate, object, callback);
 }
 
-void TakeHeapSnapshot(v8::Isolate* isolate) {
-  isolate->GetHeapProfiler()->TakeHeapSnapshot();
+// Takes a heap snapshot and writes it to the path passed, if any, in the
+// format of DevTools. Returns the stats of the snapshot.
+v8::Local<v8::Value> TakeHeapSnapshot(mate::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  // Snapshots are written on the calling thread, which is usually busy taking
+  // the snapshot anyway.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+
+  base::FilePath path;
+  base::File file;
+  if (args->GetNext(&path)) {
+    file.Initialize(path, base::File::FLAG_CREATE_ALWAYS |
+                          base::File::FLAG_WRITE);
+    if (!file.IsValid()) {
+      args->ThrowError("Unable to open " + path.AsUTF8Unsafe());
+      return v8::Undefined(isolate);
+    }
+  }
+
+  const v8::HeapSnapshot* snapshot =
+      isolate->GetHeapProfiler()->TakeHeapSnapshot();
+  mate::Dictionary stats = mate::Dictionary::CreateEmpty(isolate);
+  stats.Set("nodeCount", snapshot->GetNodesCount());
+  stats.Set("maxObjectId", snapshot->GetMaxSnapshotJSObjectId());
+
+  bool failed = false;
+  if (file.IsValid()) {
+    FileOutputStream stream(&file);
+    snapshot->Serialize(&stream, v8::HeapSnapshot::kJSON);
+    file.Close();
+    failed = stream.failed();
+    stats.Set("size", static_cast<double>(stream.size()));
+  }
+
+  // The snapshot itself takes a lot of memory, it is not kept for DevTools.
+  const_cast<v8::HeapSnapshot*>(snapshot)->Delete();
+
+  if (failed) {
+    base::DeleteFile(path, false);
+    args->ThrowError("Unable to write the heap snapshot to " +
+                     path.AsUTF8Unsafe());
+    return v8::Undefined(isolate);
+  }
+  return stats.GetHandle();
 }
 
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
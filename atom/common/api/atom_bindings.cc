@@ -10,9 +10,13 @@
 
 #include "atom/common/atom_version.h"
 #include "atom/common/chrome_version.h"
+#include "atom/common/event_loop_stats.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "atom/common/native_mate_converters/value_converter.h"
 #include "base/logging.h"
 #include "base/process/process_metrics.h"
+#include "base/values.h"
+#include "native_mate/arguments.h"
 #include "native_mate/dictionary.h"
 
 #include "atom/common/node_includes.h"
@@ -44,6 +48,19 @@ void Log(const base::string16& message) {
   std::cout << message << std::flush;
 }
 
+// Returns the stats of the uv loop, and optionally resets them so each call
+// covers the period since the last one.
+v8::Local<v8::Value> GetEventLoopStats(mate::Arguments* args) {
+  bool reset = false;
+  args->GetNext(&reset);
+
+  EventLoopStats* stats = EventLoopStats::GetInstance();
+  scoped_ptr<base::DictionaryValue> value = stats->ToValue();
+  if (reset)
+    stats->Reset();
+  return mate::ConvertToV8(args->isolate(), *value);
+}
+
 }  // namespace
 
 
@@ -63,6 +80,7 @@ void AtomBindings::BindTo(v8::Isolate* isolate,
   dict.SetMethod("crash", &Crash);
   dict.SetMethod("hang", &Hang);
   dict.SetMethod("log", &Log);
+  dict.SetMethod("getEventLoopStats", &GetEventLoopStats);
 #if defined(OS_POSIX)
   dict.SetMethod("setFdLimit", &base::SetFdLimit);
 #endif
@@ -26,6 +26,30 @@ v8::Local<v8::Value> CallEmitWithArgs(v8::Isolate* isolate,
       isolate, obj, "emit", args->size(), &args->front());
 }
 
+v8::Local<v8::Value> CallEmitWithArgs(v8::Isolate* isolate,
+                                      v8::Local<v8::Object> obj,
+                                      v8::Local<v8::Function> emit,
+                                      ValueVector* args) {
+  scoped_ptr<blink::WebScopedRunV8Script> script_scope(
+      Locker::IsBrowserProcess() ?
+      nullptr : new blink::WebScopedRunV8Script(isolate));
+  return node::MakeCallback(
+      isolate, obj, emit, args->size(), &args->front());
+}
+
 }  // namespace internal
 
+bool HasListeners(v8::Isolate* isolate,
+                  v8::Local<v8::Object> obj,
+                  const base::StringPiece& name) {
+  if (name == "error")
+    return true;
+  // EventEmitter keeps the listeners in this._events, keyed by event name,
+  // and deletes the key once its last listener is removed.
+  v8::Local<v8::Value> events = obj->Get(StringToV8(isolate, "_events"));
+  if (!events->IsObject())
+    return false;
+  return events->ToObject()->HasOwnProperty(StringToV8(isolate, name));
+}
+
 }  // namespace mate
@@ -7,6 +7,7 @@
 
 #include <vector>
 
+#include "base/strings/string_piece.h"
 #include "native_mate/converter.h"
 
 namespace mate {
@@ -19,8 +20,21 @@ v8::Local<v8::Value> CallEmitWithArgs(v8::Isolate* isolate,
                                       v8::Local<v8::Object> obj,
                                       ValueVector* args);
 
+// Same with above but calls |emit| instead of looking up obj.emit.
+v8::Local<v8::Value> CallEmitWithArgs(v8::Isolate* isolate,
+                                      v8::Local<v8::Object> obj,
+                                      v8::Local<v8::Function> emit,
+                                      ValueVector* args);
+
 }  // namespace internal
 
+// Whether obj.emit(name) would call any listener of the node EventEmitter
+// |obj|. Emitting "error" is always counted, since it throws when there is no
+// listener. The caller is responsible of allocating a HandleScope.
+bool HasListeners(v8::Isolate* isolate,
+                  v8::Local<v8::Object> obj,
+                  const base::StringPiece& name);
+
 // obj.emit.apply(obj, name, args...);
 // The caller is responsible of allocating a HandleScope.
 template<typename StringType, typename... Args>
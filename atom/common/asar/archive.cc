@@ -8,84 +8,105 @@
 #include <io.h>
 #endif
 
+#include <string.h>
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
+#include "atom/common/asar/binary_header.h"
+#include "atom/common/asar/readahead.h"
 #include "atom/common/asar/scoped_temporary_file.h"
 #include "base/files/file.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/logging.h"
 #include "base/pickle.h"
 #include "base/json/json_reader.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
+#include "crypto/secure_hash.h"
+#include "crypto/sha2.h"
+#include "vendor/node/deps/zlib/zlib.h"
 
 namespace asar {
 
 namespace {
 
-#if defined(OS_WIN)
-const char kSeparators[] = "\\/";
-#else
-const char kSeparators[] = "/";
-#endif
+// Links are followed at most this many times, which also breaks cycles.
+const int kMaxLinkDepth = 32;
 
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out);
-
-// Gets the "files" from "dir".
-bool GetFilesNode(const base::DictionaryValue* root,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  // Test for symbol linked directory.
-  std::string link;
-  if (dir->GetStringWithoutPathExpansion("link", &link)) {
-    const base::DictionaryValue* linked_node = NULL;
-    if (!GetNodeFromPath(link, root, &linked_node))
-      return false;
-    dir = linked_node;
-  }
+// Versions of the header format, see binary_header.h for version 2.
+const uint32 kJSONHeaderVersion = 1;
+const uint32 kBinaryHeaderVersion = 2;
+
+// Payload size of the pickle holding header size and version.
+const uint32 kBinaryHeaderPayloadSize = 8;
+
+// Size of chunks when hashing a whole file that is not mapped.
+const uint32 kHashChunkSize = 1024 * 1024;
 
-  return dir->GetDictionaryWithoutPathExpansion("files", out);
+// Converts |path| to the key used in the index, which always uses "/" as
+// separator and has no trailing separator.
+std::string PathToKey(const base::FilePath& path) {
+  std::string key = path.AsUTF8Unsafe();
+#if defined(OS_WIN)
+  std::replace(key.begin(), key.end(), '\\', '/');
+#endif
+  while (!key.empty() && key[key.size() - 1] == '/')
+    key.resize(key.size() - 1);
+  return key;
 }
 
-// Gets sub-file "name" from "dir".
-bool GetChildNode(const base::DictionaryValue* root,
-                  const std::string& name,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  if (name == "") {
-    *out = root;
-    return true;
-  }
+// Returns the number of bytes stored in archive for |info|.
+uint64 GetStoredSize(const Archive::FileInfo& info) {
+  if (!info.compressed)
+    return info.size;
+  uint64 size = 0;
+  for (uint32 block : info.blocks)
+    size += block;
+  return size;
+}
 
-  const base::DictionaryValue* files = NULL;
-  return GetFilesNode(root, dir, &files) &&
-         files->GetDictionaryWithoutPathExpansion(name, out);
+bool HexToDigest(const std::string& hex, std::string* digest) {
+  std::vector<uint8> bytes;
+  if (!base::HexStringToBytes(hex, &bytes) ||
+      bytes.size() != crypto::kSHA256Length)
+    return false;
+  digest->append(bytes.begin(), bytes.end());
+  return true;
 }
 
-// Gets the node of "path" from "root".
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out) {
-  if (path == "") {
-    *out = root;
+// "integrity": {"algorithm": "SHA256", "hash": hex, "blockSize": n,
+//               "blocks": [hex, ...]}
+bool FillIntegrityWithNode(Archive::FileInfo* info,
+                           const base::DictionaryValue* node) {
+  const base::DictionaryValue* integrity;
+  if (!node->GetDictionary("integrity", &integrity))
     return true;
-  }
 
-  const base::DictionaryValue* dir = root;
-  for (size_t delimiter_position = path.find_first_of(kSeparators);
-       delimiter_position != std::string::npos;
-       delimiter_position = path.find_first_of(kSeparators)) {
-    const base::DictionaryValue* child = NULL;
-    if (!GetChildNode(root, path.substr(0, delimiter_position), dir, &child))
-      return false;
+  std::string algorithm, hash;
+  int block_size;
+  const base::ListValue* blocks;
+  if (!integrity->GetString("algorithm", &algorithm) ||
+      algorithm != "SHA256" ||
+      !integrity->GetString("hash", &hash) ||
+      !HexToDigest(hash, &info->hash) ||
+      !integrity->GetInteger("blockSize", &block_size) || block_size <= 0 ||
+      !integrity->GetList("blocks", &blocks))
+    return false;
+  uint64 stored_size = GetStoredSize(*info);
+  if (blocks->GetSize() != (stored_size + block_size - 1) / block_size)
+    return false;
 
-    dir = child;
-    path.erase(0, delimiter_position + 1);
+  info->integrity_block_size = static_cast<uint32>(block_size);
+  for (size_t i = 0; i < blocks->GetSize(); ++i) {
+    std::string block;
+    if (!blocks->GetString(i, &block) ||
+        !HexToDigest(block, &info->block_hashes))
+      return false;
   }
-
-  return GetChildNode(root, path, dir, out);
+  return true;
 }
 
 bool FillFileInfoWithNode(Archive::FileInfo* info,
@@ -107,7 +128,42 @@ bool FillFileInfoWithNode(Archive::FileInfo* info,
     return false;
   info->offset += header_size;
 
-  return true;
+  // "compression": {"algorithm": "deflate", "blockSize": n, "blocks": [...]}
+  const base::DictionaryValue* compression;
+  if (!node->GetDictionary("compression", &compression))
+    return FillIntegrityWithNode(info, node);
+
+  std::string algorithm;
+  int block_size;
+  const base::ListValue* blocks;
+  if (!compression->GetString("algorithm", &algorithm) ||
+      algorithm != "deflate" ||
+      !compression->GetInteger("blockSize", &block_size) || block_size <= 0 ||
+      !compression->GetList("blocks", &blocks))
+    return false;
+  if (blocks->GetSize() !=
+      (info->size + static_cast<uint32>(block_size) - 1) / block_size)
+    return false;
+
+  info->compressed = true;
+  info->block_size = static_cast<uint32>(block_size);
+  info->blocks.resize(blocks->GetSize());
+  for (size_t i = 0; i < blocks->GetSize(); ++i) {
+    int block;
+    if (!blocks->GetInteger(i, &block) || block <= 0)
+      return false;
+    info->blocks[i] = static_cast<uint32>(block);
+  }
+  return FillIntegrityWithNode(info, node);
+}
+
+// Inflates |length| bytes of |source| into |dest| of |dest_length| bytes.
+bool InflateBlock(const char* source, uint32 length,
+                  char* dest, uint32 dest_length) {
+  uLongf size = dest_length;
+  return uncompress(reinterpret_cast<Bytef*>(dest), &size,
+                    reinterpret_cast<const Bytef*>(source), length) == Z_OK &&
+         size == dest_length;
 }
 
 }  // namespace
@@ -129,10 +185,27 @@ Archive::Archive(const base::FilePath& path)
 Archive::~Archive() {
 }
 
+void Archive::FinishReadaheadRecording() {
+  if (readahead_recorder_)
+    readahead_recorder_->Finish();
+}
+
 bool Archive::Init() {
+  TRACE_EVENT1("electron.asar", "Archive::Init",
+               "path", path_.AsUTF8Unsafe());
   if (!file_.IsValid())
     return false;
 
+  readahead_recorder_ = ReadaheadRecorder::CreateIfEnabled(path_);
+
+  // Map the whole archive so packed files can be read without copying, on
+  // failure (e.g. running out of address space) reads go through the fd.
+  mapped_file_.reset(new base::MemoryMappedFile);
+  if (!mapped_file_->Initialize(path_)) {
+    LOG(WARNING) << "Failed to map " << path_.value();
+    mapped_file_.reset();
+  }
+
   std::vector<char> buf;
   int len;
 
@@ -143,13 +216,38 @@ bool Archive::Init() {
     return false;
   }
 
+  // The binary header stores its version after the size, which makes the
+  // size pickle 4 bytes longer.
+  uint32 payload_size;
+  memcpy(&payload_size, buf.data(), sizeof(payload_size));
+  if (payload_size == kBinaryHeaderPayloadSize) {
+    buf.resize(12);
+    len = file_.ReadAtCurrentPos(buf.data() + 8, 4);
+    if (len != 4) {
+      PLOG(ERROR) << "Failed to read header version from " << path_.value();
+      return false;
+    }
+  }
+
   uint32 size;
-  if (!base::PickleIterator(base::Pickle(buf.data(), buf.size())).ReadUInt32(
-          &size)) {
+  uint32 version = kJSONHeaderVersion;
+  base::PickleIterator size_iter(base::Pickle(buf.data(), buf.size()));
+  if (!size_iter.ReadUInt32(&size) ||
+      (payload_size == kBinaryHeaderPayloadSize &&
+       !size_iter.ReadUInt32(&version))) {
     LOG(ERROR) << "Failed to parse header size from " << path_.value();
     return false;
   }
 
+  header_size_ = buf.size() + size;
+  if (version == kBinaryHeaderVersion)
+    return InitBinaryHeader(size);
+  if (version != kJSONHeaderVersion) {
+    LOG(ERROR) << "Unsupported header version " << version << " of "
+               << path_.value();
+    return false;
+  }
+
   buf.resize(size);
   len = file_.ReadAtCurrentPos(buf.data(), buf.size());
   if (len != static_cast<int>(buf.size())) {
@@ -164,99 +262,537 @@ bool Archive::Init() {
     return false;
   }
 
-  std::string error;
   base::JSONReader reader;
   scoped_ptr<base::Value> value(reader.ReadToValue(header));
   if (!value || !value->IsType(base::Value::TYPE_DICTIONARY)) {
-    LOG(ERROR) << "Failed to parse header: " << error;
+    LOG(ERROR) << "Failed to parse header: " << reader.GetErrorMessage();
+    return false;
+  }
+
+  // Flatten the header into |entries_|, the parsed tree is not kept.
+  const base::DictionaryValue* root =
+      static_cast<base::DictionaryValue*>(value.get());
+  entries_[std::string()].flags = Entry::FLAG_DIRECTORY;
+  if (!BuildIndex(std::string(), root)) {
+    LOG(ERROR) << "Failed to index header of " << path_.value();
+    entries_.clear();
+    directories_.clear();
     return false;
   }
 
-  header_size_ = 8 + size;
-  header_.reset(static_cast<base::DictionaryValue*>(value.release()));
+  std::vector<std::string> links;
+  for (const auto& iter : entries_)
+    if (iter.second.flags & Entry::FLAG_LINK)
+      links.push_back(iter.first);
+  for (const std::string& key : links)
+    ResolveLink(key, 0);
+
   return true;
 }
 
-bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
-  if (!header_)
+bool Archive::InitBinaryHeader(uint32 size) {
+  // The binary header is used in place, only when the archive can not be
+  // mapped it is read into memory.
+  base::StringPiece data;
+  if (mapped_file_) {
+    if (header_size_ > mapped_file_->length()) {
+      LOG(ERROR) << "Truncated header in " << path_.value();
+      return false;
+    }
+    data = base::StringPiece(reinterpret_cast<const char*>(
+        mapped_file_->data()) + header_size_ - size, size);
+  } else {
+    header_storage_.resize(size);
+    int len = file_.ReadAtCurrentPos(
+        const_cast<char*>(header_storage_.data()), size);
+    if (len != static_cast<int>(size)) {
+      PLOG(ERROR) << "Failed to read header from " << path_.value();
+      return false;
+    }
+    data = header_storage_;
+  }
+
+  binary_header_.reset(new BinaryHeader(data));
+  if (!binary_header_->Init()) {
+    LOG(ERROR) << "Failed to parse binary header of " << path_.value();
+    binary_header_.reset();
     return false;
+  }
+  return true;
+}
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+bool Archive::BuildIndex(const std::string& prefix,
+                         const base::DictionaryValue* dir) {
+  const base::DictionaryValue* files;
+  if (!dir->GetDictionaryWithoutPathExpansion("files", &files))
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link))
-    return GetFileInfo(base::FilePath::FromUTF8Unsafe(link), info);
+  std::vector<base::FilePath>& children = directories_[prefix];
+  for (base::DictionaryValue::Iterator iter(*files); !iter.IsAtEnd();
+       iter.Advance()) {
+    const base::DictionaryValue* node;
+    if (!iter.value().GetAsDictionary(&node))
+      return false;
 
-  return FillFileInfoWithNode(info, header_size_, node);
+    children.push_back(base::FilePath::FromUTF8Unsafe(iter.key()));
+    std::string key = prefix.empty() ? iter.key() : prefix + "/" + iter.key();
+
+    Entry entry;
+    std::string link;
+    if (node->GetStringWithoutPathExpansion("link", &link)) {
+      entry.flags = Entry::FLAG_LINK;
+      entry.link = PathToKey(base::FilePath::FromUTF8Unsafe(link));
+    } else if (node->HasKey("files")) {
+      entry.flags = Entry::FLAG_DIRECTORY;
+      if (!BuildIndex(key, node))
+        return false;
+    } else {
+      FileInfo info;
+      if (!FillFileInfoWithNode(&info, header_size_, node))
+        continue;
+      entry.size = info.size;
+      entry.offset = info.offset;
+      if (info.unpacked)
+        entry.flags = Entry::FLAG_UNPACKED;
+      if (info.compressed) {
+        entry.flags = Entry::FLAG_COMPRESSED;
+        entry.block_size = info.block_size;
+        entry.blocks.swap(info.blocks);
+      }
+      entry.hash.swap(info.hash);
+      entry.integrity_block_size = info.integrity_block_size;
+      entry.block_hashes.swap(info.block_hashes);
+    }
+    entries_[key] = entry;
+  }
+  return true;
 }
 
-bool Archive::Stat(const base::FilePath& path, Stats* stats) {
-  if (!header_)
+bool Archive::ResolveLink(const std::string& key, int depth) {
+  EntryMap::iterator iter = entries_.find(key);
+  if (iter == entries_.end())
+    return false;
+
+  Entry& entry = iter->second;
+  if (!(entry.flags & Entry::FLAG_LINK) || (entry.flags & Entry::FLAG_RESOLVED))
+    return true;
+  if (depth > kMaxLinkDepth)
+    return false;
+
+  std::string target;
+  const Entry* target_entry = FindEntry(entry.link, &target);
+  if (!target_entry)
+    return false;
+
+  // Link to link, follow the chain first, it is resolved in place.
+  if (target_entry->flags & Entry::FLAG_LINK) {
+    if (!ResolveLink(target, depth + 1))
+      return false;
+    target = target_entry->link;
+  }
+
+  entry.link = target;
+  entry.size = target_entry->size;
+  entry.offset = target_entry->offset;
+  entry.block_size = target_entry->block_size;
+  entry.blocks = target_entry->blocks;
+  entry.hash = target_entry->hash;
+  entry.integrity_block_size = target_entry->integrity_block_size;
+  entry.block_hashes = target_entry->block_hashes;
+  entry.flags = Entry::FLAG_LINK | Entry::FLAG_RESOLVED |
+      (target_entry->flags & (Entry::FLAG_DIRECTORY | Entry::FLAG_UNPACKED |
+                              Entry::FLAG_COMPRESSED));
+  return true;
+}
+
+// static
+void Archive::EntryToFileInfo(const Entry& entry, FileInfo* info) {
+  info->unpacked = (entry.flags & Entry::FLAG_UNPACKED) != 0;
+  info->size = entry.size;
+  info->offset = entry.offset;
+  info->compressed = (entry.flags & Entry::FLAG_COMPRESSED) != 0;
+  info->block_size = entry.block_size;
+  info->blocks = entry.blocks;
+  info->hash = entry.hash;
+  info->integrity_block_size = entry.integrity_block_size;
+  info->block_hashes = entry.block_hashes;
+}
+
+const Archive::Entry* Archive::LookupEntry(const std::string& key) const {
+  static_assert(Entry::FLAG_DIRECTORY == BinaryHeader::FLAG_DIRECTORY &&
+                Entry::FLAG_LINK == BinaryHeader::FLAG_LINK &&
+                Entry::FLAG_UNPACKED == BinaryHeader::FLAG_UNPACKED &&
+                Entry::FLAG_RESOLVED == BinaryHeader::FLAG_RESOLVED &&
+                Entry::FLAG_COMPRESSED == BinaryHeader::FLAG_COMPRESSED,
+                "Entry flags must match the binary header format");
+
+  if (!binary_header_) {
+    EntryMap::const_iterator iter = entries_.find(key);
+    return iter == entries_.end() ? nullptr : &iter->second;
+  }
+
+  // Entries are never removed from |decoded_entries_|, and the elements of an
+  // unordered_map do not move, so the returned entry stays valid.
+  base::AutoLock auto_lock(decoded_entries_lock_);
+  EntryMap::const_iterator iter = decoded_entries_.find(key);
+  if (iter != decoded_entries_.end())
+    return &iter->second;
+
+  BinaryHeader::Record record;
+  if (!binary_header_->Find(key, &record))
+    return nullptr;
+
+  Entry& entry = decoded_entries_[key];
+  entry.flags = record.flags;
+  entry.size = record.size;
+  entry.offset = record.offset;
+  if (!(entry.flags & Entry::FLAG_DIRECTORY))
+    entry.offset += header_size_;
+  if (entry.flags & Entry::FLAG_LINK)
+    record.link.CopyToString(&entry.link);
+  entry.block_size = record.block_size;
+  entry.blocks.swap(record.blocks);
+  record.hash.CopyToString(&entry.hash);
+  entry.integrity_block_size = record.integrity_block_size;
+  record.block_hashes.CopyToString(&entry.block_hashes);
+
+  // A link to a compressed file only stores its realpath, the blocks are
+  // taken from the record of the target.
+  if ((entry.flags & Entry::FLAG_LINK) &&
+      !(entry.flags & Entry::FLAG_RESOLVED)) {
+    BinaryHeader::Record target;
+    if (binary_header_->Find(entry.link, &target) &&
+        !(target.flags & (Entry::FLAG_LINK | Entry::FLAG_DIRECTORY))) {
+      entry.flags = Entry::FLAG_LINK | Entry::FLAG_RESOLVED |
+          (target.flags & (Entry::FLAG_UNPACKED | Entry::FLAG_COMPRESSED));
+      entry.size = target.size;
+      entry.offset = target.offset + header_size_;
+      entry.block_size = target.block_size;
+      entry.blocks.swap(target.blocks);
+      target.hash.CopyToString(&entry.hash);
+      entry.integrity_block_size = target.integrity_block_size;
+      target.block_hashes.CopyToString(&entry.block_hashes);
+    }
+  }
+  return &entry;
+}
+
+const Archive::Entry* Archive::FindEntry(const base::FilePath& path,
+                                         std::string* resolved_key) const {
+  return FindEntry(PathToKey(path), resolved_key);
+}
+
+const Archive::Entry* Archive::FindEntry(const std::string& key,
+                                         std::string* resolved_key) const {
+  TRACE_EVENT0("electron.asar", "Archive::FindEntry");
+  // |key| is only copied once a linked directory has to be replaced in it.
+  const std::string* current = &key;
+  std::string replaced_key;
+  for (int depth = 0; depth <= kMaxLinkDepth; ++depth) {
+    const Entry* entry = LookupEntry(*current);
+    if (entry) {
+      if (resolved_key)
+        *resolved_key = *current;
+      return entry;
+    }
+
+    // The path may go through a linked directory, find the first component
+    // that is a link and replace it with the link's target.
+    bool replaced = false;
+    for (size_t pos = current->find('/'); pos != std::string::npos;
+         pos = current->find('/', pos + 1)) {
+      const Entry* parent = LookupEntry(current->substr(0, pos));
+      if (!parent)
+        return nullptr;
+
+      if (parent->flags & Entry::FLAG_LINK) {
+        std::string next = parent->link.empty() ?
+            current->substr(pos + 1) : parent->link + current->substr(pos);
+        replaced_key.swap(next);
+        current = &replaced_key;
+        replaced = true;
+        break;
+      }
+      if (!(parent->flags & Entry::FLAG_DIRECTORY))
+        return nullptr;
+    }
+    if (!replaced)
+      return nullptr;
+  }
+  return nullptr;
+}
+
+bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
+  const Entry* entry = FindEntry(path);
+  if (!entry || (entry->flags & Entry::FLAG_DIRECTORY))
+    return false;
+  if ((entry->flags & Entry::FLAG_LINK) &&
+      !(entry->flags & Entry::FLAG_RESOLVED))
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  EntryToFileInfo(*entry, info);
+  return true;
+}
+
+bool Archive::Stat(const base::FilePath& path, Stats* stats) {
+  const Entry* entry = FindEntry(path);
+  if (!entry)
     return false;
 
-  if (node->HasKey("link")) {
+  if (entry->flags & Entry::FLAG_LINK) {
     stats->is_file = false;
     stats->is_link = true;
     return true;
   }
 
-  if (node->HasKey("files")) {
+  if (entry->flags & Entry::FLAG_DIRECTORY) {
     stats->is_file = false;
     stats->is_directory = true;
     return true;
   }
 
-  return FillFileInfoWithNode(stats, header_size_, node);
+  EntryToFileInfo(*entry, stats);
+  return true;
 }
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* list) {
-  if (!header_)
+  std::string key;
+  const Entry* entry = FindEntry(path, &key);
+  if (!entry || !(entry->flags & Entry::FLAG_DIRECTORY))
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
-    return false;
+  if (entry->flags & Entry::FLAG_LINK)
+    key = entry->link;
 
-  const base::DictionaryValue* files;
-  if (!GetFilesNode(header_.get(), node, &files))
+  // Only the touched directories are decoded from the binary header.
+  if (binary_header_)
+    return binary_header_->GetChildren(key, list);
+
+  DirectoryMap::const_iterator iter = directories_.find(key);
+  if (iter == directories_.end())
     return false;
 
-  base::DictionaryValue::Iterator iter(*files);
-  while (!iter.IsAtEnd()) {
-    list->push_back(base::FilePath::FromUTF8Unsafe(iter.key()));
-    iter.Advance();
-  }
+  list->insert(list->end(), iter->second.begin(), iter->second.end());
   return true;
 }
 
 bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
-  if (!header_)
+  const Entry* entry = FindEntry(path);
+  if (!entry)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  if (entry->flags & Entry::FLAG_LINK) {
+    *realpath = base::FilePath::FromUTF8Unsafe(entry->link);
+    return true;
+  }
+
+  *realpath = path;
+  return true;
+}
+
+bool Archive::GetFileContents(const FileInfo& info,
+                              base::StringPiece* contents) {
+  if (!mapped_file_ || info.unpacked || info.compressed)
+    return false;
+  if (!GetMappedRange(info.offset, info.size, contents) ||
+      !VerifyRange(info, 0, info.size))
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link)) {
-    *realpath = base::FilePath::FromUTF8Unsafe(link);
+  if (readahead_recorder_)
+    readahead_recorder_->Record(info.offset, info.size);
+  return true;
+}
+
+int Archive::ReadFile(const FileInfo& info,
+                      uint64 offset,
+                      int length,
+                      char* dest) {
+  TRACE_EVENT2("electron.asar", "Archive::ReadFile",
+               "length", length, "compressed", info.compressed);
+  if (info.unpacked || length < 0)
+    return -1;
+  if (offset >= info.size)
+    return 0;
+  length = static_cast<int>(std::min<uint64>(length, info.size - offset));
+
+  if (!info.compressed) {
+    if (!VerifyRange(info, offset, length))
+      return -1;
+    if (readahead_recorder_)
+      readahead_recorder_->Record(info.offset + offset, length);
+
+    base::StringPiece range;
+    if (GetMappedRange(info.offset + offset, length, &range)) {
+      memcpy(dest, range.data(), length);
+      return length;
+    }
+    return file_.Read(info.offset + offset, dest, length);
+  }
+
+  // Find the blocks covering the range, and verify them before inflating.
+  size_t index = offset / info.block_size;
+  size_t last_index = std::min<size_t>(
+      (offset + length - 1) / info.block_size, info.blocks.size() - 1);
+  if (index >= info.blocks.size())
+    return -1;
+  uint64 stored_start = 0;
+  for (size_t i = 0; i < index; ++i)
+    stored_start += info.blocks[i];
+  uint64 stored_end = stored_start;
+  for (size_t i = index; i <= last_index; ++i)
+    stored_end += info.blocks[i];
+  if (!VerifyRange(info, stored_start, stored_end - stored_start))
+    return -1;
+  if (readahead_recorder_)
+    readahead_recorder_->Record(info.offset + stored_start,
+                                stored_end - stored_start);
+
+  uint64 block_offset = info.offset + stored_start;
+  std::vector<char> compressed;
+  std::vector<char> block;
+  int written = 0;
+  for (; written < length && index <= last_index; ++index) {
+    uint64 block_start = static_cast<uint64>(index) * info.block_size;
+    uint32 block_length = static_cast<uint32>(
+        std::min<uint64>(info.block_size, info.size - block_start));
+    uint32 compressed_length = info.blocks[index];
+
+    base::StringPiece source;
+    if (!ReadRange(block_offset, compressed_length, &compressed, &source))
+      return -1;
+
+    uint32 skip = static_cast<uint32>(offset + written - block_start);
+    uint32 count = std::min<uint32>(block_length - skip, length - written);
+    if (skip == 0 && count == block_length) {
+      if (!InflateBlock(source.data(), compressed_length, dest + written,
+                        block_length))
+        return -1;
+    } else {
+      block.resize(block_length);
+      if (!InflateBlock(source.data(), compressed_length, block.data(),
+                        block_length))
+        return -1;
+      memcpy(dest + written, block.data() + skip, count);
+    }
+
+    block_offset += compressed_length;
+    written += count;
+  }
+  return written;
+}
+
+bool Archive::VerifyFile(const FileInfo& info) {
+  if (info.unpacked)
+    return true;
+  uint64 stored_size = GetStoredSize(info);
+  if (!VerifyRange(info, 0, stored_size))
+    return false;
+  if (info.hash.empty())
     return true;
+
+  scoped_ptr<crypto::SecureHash> hash(
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256));
+  std::vector<char> buffer;
+  for (uint64 offset = 0; offset < stored_size; offset += kHashChunkSize) {
+    uint32 size = static_cast<uint32>(
+        std::min<uint64>(kHashChunkSize, stored_size - offset));
+    base::StringPiece chunk;
+    if (!ReadRange(info.offset + offset, size, &buffer, &chunk))
+      return false;
+    hash->Update(chunk.data(), chunk.size());
   }
 
-  *realpath = path;
+  std::string digest(crypto::kSHA256Length, 0);
+  hash->Finish(&digest[0], digest.size());
+  if (digest != info.hash) {
+    LOG(ERROR) << "Integrity check failed for file at " << info.offset
+               << " of " << path_.value();
+    return false;
+  }
+  return true;
+}
+
+bool Archive::GetMappedRange(uint64 offset, uint64 size,
+                             base::StringPiece* range) const {
+  if (!mapped_file_ || offset > mapped_file_->length() ||
+      size > mapped_file_->length() - offset)
+    return false;
+
+  *range = base::StringPiece(
+      reinterpret_cast<const char*>(mapped_file_->data()) + offset, size);
+  return true;
+}
+
+bool Archive::ReadRange(uint64 offset, uint32 size, std::vector<char>* buffer,
+                        base::StringPiece* range) {
+  if (GetMappedRange(offset, size, range))
+    return true;
+
+  buffer->resize(size);
+  if (file_.Read(offset, buffer->data(), size) != static_cast<int>(size))
+    return false;
+  *range = base::StringPiece(buffer->data(), size);
+  return true;
+}
+
+bool Archive::VerifyRange(const FileInfo& info, uint64 offset, uint64 length) {
+  if (info.block_hashes.empty() || length == 0)
+    return true;
+
+  uint64 stored_size = GetStoredSize(info);
+  uint64 block_size = info.integrity_block_size;
+  std::vector<char> buffer;
+  for (uint64 index = offset / block_size;
+       index <= (offset + length - 1) / block_size; ++index) {
+    uint64 block_offset = info.offset + index * block_size;
+    {
+      base::AutoLock auto_lock(verified_blocks_lock_);
+      if (verified_blocks_.count(block_offset))
+        continue;
+    }
+
+    // Hash without holding the lock, at worst a block is hashed twice.
+    if ((index + 1) * crypto::kSHA256Length > info.block_hashes.size() ||
+        index * block_size >= stored_size)
+      return false;
+    uint32 size = static_cast<uint32>(
+        std::min(block_size, stored_size - index * block_size));
+    base::StringPiece data;
+    if (!ReadRange(block_offset, size, &buffer, &data))
+      return false;
+    std::string digest = crypto::SHA256HashString(data);
+    if (base::StringPiece(info.block_hashes).substr(
+            index * crypto::kSHA256Length, crypto::kSHA256Length) != digest) {
+      LOG(ERROR) << "Integrity check failed for block at " << block_offset
+                 << " of " << path_.value();
+      return false;
+    }
+
+    base::AutoLock auto_lock(verified_blocks_lock_);
+    verified_blocks_.insert(block_offset);
+  }
   return true;
 }
 
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
-  if (external_files_.contains(path)) {
-    *out = external_files_.get(path)->path();
+  return CopyFileOutTo(path, false, out);
+}
+
+bool Archive::CopyFileOutForChildProcess(const base::FilePath& path,
+                                         base::FilePath* out) {
+  return CopyFileOutTo(path, true, out);
+}
+
+bool Archive::CopyFileOutTo(const base::FilePath& path,
+                            bool for_child_process,
+                            base::FilePath* out) {
+  TRACE_EVENT0("electron.asar", "Archive::CopyFileOut");
+  base::AutoLock auto_lock(external_files_lock_);
+  ExternalFiles& files =
+      for_child_process ? child_process_files_ : external_files_;
+  if (files.contains(path)) {
+    *out = files.get(path)->path();
     return true;
   }
 
@@ -269,12 +805,34 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
     return true;
   }
 
+  // Use the mapped content directly when possible.
+  base::StringPiece contents;
+  std::vector<char> buf;
+  if (!GetFileContents(info, &contents)) {
+    buf.resize(info.size);
+    if (ReadFile(info, 0, info.size, buf.data()) != static_cast<int>(info.size))
+      return false;
+    contents = base::StringPiece(buf.data(), buf.size());
+  }
+
+  // Prefer the ways that do not write the file to disk. The extraction cache
+  // is not used on Linux, where the temp directory is usually shared by all
+  // users.
   scoped_ptr<ScopedTemporaryFile> temp_file(new ScopedTemporaryFile);
-  if (!temp_file->InitFromFile(&file_, info.offset, info.size))
+#if defined(OS_LINUX)
+  bool success = !for_child_process &&
+                 temp_file->InitInMemory(contents.data(), contents.size());
+#elif defined(OS_WIN) || defined(OS_MACOSX)
+  bool success = temp_file->InitFromCache(path.BaseName(), contents.data(),
+                                          contents.size());
+#else
+  bool success = false;
+#endif
+  if (!success && !temp_file->InitFromData(contents.data(), contents.size()))
     return false;
 
   *out = temp_file->path();
-  external_files_.set(path, temp_file.Pass());
+  files.set(path, temp_file.Pass());
   return true;
 }
 
@@ -5,30 +5,54 @@
 #ifndef ATOM_COMMON_ASAR_ARCHIVE_H_
 #define ATOM_COMMON_ASAR_ARCHIVE_H_
 
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "base/containers/scoped_ptr_hash_map.h"
 #include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
 
 namespace base {
 class DictionaryValue;
+class MemoryMappedFile;
 }
 
 namespace asar {
 
+class BinaryHeader;
+class ReadaheadRecorder;
 class ScopedTemporaryFile;
 
 // This class represents an asar package, and provides methods to read
-// information from it.
+// information from it. After Init() it can be used from multiple threads.
 class Archive {
  public:
   struct FileInfo {
-    FileInfo() : size(0), offset(0) {}
+    FileInfo() : unpacked(false), size(0), offset(0), compressed(false),
+                 block_size(0), integrity_block_size(0) {}
     bool unpacked;
     uint32 size;
     uint64 offset;
+
+    // Compressed files are stored as independently deflated blocks of
+    // |block_size| bytes each (the last one may be shorter), starting at
+    // |offset|. |blocks| records the compressed size of each block.
+    bool compressed;
+    uint32 block_size;
+    std::vector<uint32> blocks;
+
+    // Optional SHA-256 digests of the bytes stored in archive, which are the
+    // deflated blocks for compressed files. |hash| covers the whole file, and
+    // |block_hashes| is the concatenated digests of each
+    // |integrity_block_size| bytes.
+    std::string hash;
+    uint32 integrity_block_size;
+    std::string block_hashes;
   };
 
   struct Stats : public FileInfo {
@@ -56,26 +80,154 @@ class Archive {
   // Fs.realpath(path).
   bool Realpath(const base::FilePath& path, base::FilePath* realpath);
 
-  // Copy the file into a temporary file, and return the new path.
+  // Returns a read-only view of the packed file described by |info|, backed by
+  // the memory mapping of the archive. The view is valid as long as this
+  // archive is alive. Fails for unpacked or compressed files or when the
+  // archive could not be mapped, callers should then fall back to ReadFile().
+  // Also fails when the file does not match its integrity hashes.
+  bool GetFileContents(const FileInfo& info, base::StringPiece* contents);
+
+  // Reads at most |length| bytes starting at |offset| of the packed file
+  // described by |info| into |dest|, only the blocks covering the range are
+  // decompressed for compressed files. Returns the number of bytes read, or -1
+  // on error. This can be called from any thread.
+  int ReadFile(const FileInfo& info, uint64 offset, int length, char* dest);
+
+  // Verifies the whole file described by |info| against its integrity
+  // hashes, files without integrity information are always valid. The blocks
+  // touched by GetFileContents() and ReadFile() are verified the same way the
+  // first time they are read.
+  bool VerifyFile(const FileInfo& info);
+
+  // Copy the file out of the archive, and return the new path. The file is
+  // put in anonymous memory on Linux and in the extraction cache on OS X and
+  // Windows, with an ordinary temporary file as fallback. On Linux the path
+  // only opens in this process.
   // For unpacked file, this method will return its real path.
   bool CopyFileOut(const base::FilePath& path, base::FilePath* out);
 
+  // Like CopyFileOut, but the returned path can be passed to child processes,
+  // which on Linux means an ordinary temporary file.
+  bool CopyFileOutForChildProcess(const base::FilePath& path,
+                                  base::FilePath* out);
+
   // Returns the file's fd.
   int GetFD() const;
 
+  // Saves the readahead manifest now if the reads are being recorded, for
+  // processes that exit without destroying their archives.
+  void FinishReadaheadRecording();
+
   base::FilePath path() const { return path_; }
-  base::DictionaryValue* header() const { return header_.get(); }
 
  private:
+  // A node of the header, flattened and keyed by its path relative to the
+  // root of archive, e.g. "dir/file".
+  struct Entry {
+    enum Flags {
+      FLAG_DIRECTORY = 1 << 0,
+      FLAG_LINK      = 1 << 1,
+      FLAG_UNPACKED  = 1 << 2,
+      // The link has been followed to an existing file or directory.
+      FLAG_RESOLVED  = 1 << 3,
+      FLAG_COMPRESSED = 1 << 4,
+    };
+
+    Entry() : flags(0), size(0), offset(0), block_size(0),
+              integrity_block_size(0) {}
+    uint32 flags;
+    uint32 size;
+    uint64 offset;
+    // Target of link, with chains of links already followed.
+    std::string link;
+    // Block index of compressed files.
+    uint32 block_size;
+    std::vector<uint32> blocks;
+    // Integrity hashes, see FileInfo.
+    std::string hash;
+    uint32 integrity_block_size;
+    std::string block_hashes;
+  };
+
+  typedef std::unordered_map<std::string, Entry> EntryMap;
+  typedef std::unordered_map<std::string, std::vector<base::FilePath>>
+      DirectoryMap;
+  typedef base::ScopedPtrHashMap<base::FilePath,
+                                 scoped_ptr<ScopedTemporaryFile>> ExternalFiles;
+
+  // Uses the binary header of |size| bytes, which follows the size pickle.
+  bool InitBinaryHeader(uint32 size);
+
+  // Walks the parsed JSON header and fills |entries_| and |directories_|.
+  bool BuildIndex(const std::string& prefix,
+                  const base::DictionaryValue* dir);
+
+  // Follows the link at |key| and copies the info of its target into it.
+  bool ResolveLink(const std::string& key, int depth);
+
+  // Fills |info| with the file described by |entry|.
+  static void EntryToFileInfo(const Entry& entry, FileInfo* info);
+
+  // Returns the view of |size| bytes at |offset| of the mapped archive.
+  bool GetMappedRange(uint64 offset, uint64 size,
+                      base::StringPiece* range) const;
+
+  // Like GetMappedRange, but reads the range into |buffer| when the archive
+  // is not mapped.
+  bool ReadRange(uint64 offset, uint32 size, std::vector<char>* buffer,
+                 base::StringPiece* range);
+
+  // Verifies the integrity blocks covering |length| bytes at |offset| of the
+  // data stored for |info|, each block is only hashed once.
+  bool VerifyRange(const FileInfo& info, uint64 offset, uint64 length);
+
+  // Gets the entry of |key| from whichever index is used, without following
+  // links. Returns NULL when there is no such entry, the entry lives as long
+  // as the archive.
+  const Entry* LookupEntry(const std::string& key) const;
+
+  // Finds the entry of |path|, going through linked directories if needed.
+  // The key of the found entry is written to |resolved_key| when not NULL.
+  const Entry* FindEntry(const base::FilePath& path,
+                         std::string* resolved_key = nullptr) const;
+  const Entry* FindEntry(const std::string& key,
+                         std::string* resolved_key = nullptr) const;
+
+  // Implements CopyFileOut and CopyFileOutForChildProcess.
+  bool CopyFileOutTo(const base::FilePath& path,
+                     bool for_child_process,
+                     base::FilePath* out);
+
   base::FilePath path_;
   base::File file_;
   int fd_;
   uint32 header_size_;
-  scoped_ptr<base::DictionaryValue> header_;
-
-  // Cached external temporary files.
-  base::ScopedPtrHashMap<base::FilePath, scoped_ptr<ScopedTemporaryFile>>
-      external_files_;
+  scoped_ptr<base::MemoryMappedFile> mapped_file_;
+
+  // Index of archives with JSON header.
+  EntryMap entries_;
+  DirectoryMap directories_;
+
+  // Archives with binary header are looked up in place, the entries are
+  // decoded the first time they are looked up and kept in |decoded_entries_|.
+  scoped_ptr<BinaryHeader> binary_header_;
+  std::string header_storage_;
+  mutable base::Lock decoded_entries_lock_;
+  mutable EntryMap decoded_entries_;
+
+  // Offsets of integrity blocks that have been verified.
+  base::Lock verified_blocks_lock_;
+  std::unordered_set<uint64> verified_blocks_;
+
+  // Records the reads during startup when enabled.
+  scoped_ptr<ReadaheadRecorder> readahead_recorder_;
+
+  // Cached external temporary files, guarded by |external_files_lock_| since
+  // archives are shared between threads. The paths in
+  // |child_process_files_| can be opened by other processes.
+  base::Lock external_files_lock_;
+  ExternalFiles external_files_;
+  ExternalFiles child_process_files_;
 
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
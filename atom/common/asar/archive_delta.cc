@@ -0,0 +1,208 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/archive_delta.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/memory/scoped_ptr.h"
+#include "crypto/secure_hash.h"
+#include "crypto/sha2.h"
+
+namespace asar {
+
+namespace {
+
+const char kMagic[] = "ASARDIFF";
+const size_t kMagicLength = 8;
+const uint32 kVersion = 1;
+
+const uint8 kChunkCopy = 0;
+const uint8 kChunkInsert = 1;
+
+// The sizes of the head and of a chunk as stored in the delta.
+const int64 kHeadSize = kMagicLength + 4 + 8 + 8 + crypto::kSHA256Length + 4;
+const int64 kChunkRecordSize = 1 + 8 + 8;
+
+// The size of the reads and writes.
+const size_t kBufferSize = 1 << 20;
+
+struct Chunk {
+  uint8 type;
+  uint64 offset;
+  uint64 size;
+};
+
+// Reads the little-endian numbers of the delta's head.
+class Reader {
+ public:
+  explicit Reader(base::File* file) : file_(file), failed_(false) {}
+
+  bool ReadBytes(void* out, size_t size) {
+    if (!failed_ &&
+        file_->ReadAtCurrentPos(static_cast<char*>(out), size) !=
+            static_cast<int>(size))
+      failed_ = true;
+    return !failed_;
+  }
+
+  template <typename T>
+  bool ReadNumber(T* out) {
+    uint8 bytes[sizeof(T)];
+    if (!ReadBytes(bytes, sizeof(bytes)))
+      return false;
+    *out = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+      *out |= static_cast<T>(bytes[i]) << (8 * i);
+    return true;
+  }
+
+ private:
+  base::File* file_;
+  bool failed_;
+};
+
+// Copies |size| bytes from |source| at its |offset|, or at its current
+// position when |offset| is negative, to the end of |output|.
+bool CopyRange(base::File* source, int64 offset, uint64 size,
+               base::File* output, crypto::SecureHash* hash,
+               std::vector<char>* buffer) {
+  while (size > 0) {
+    int length = static_cast<int>(std::min<uint64>(size, buffer->size()));
+    int read = offset < 0 ?
+        source->ReadAtCurrentPos(buffer->data(), length) :
+        source->Read(offset, buffer->data(), length);
+    if (read != length)
+      return false;
+    if (output->WriteAtCurrentPos(buffer->data(), length) != length)
+      return false;
+    hash->Update(buffer->data(), length);
+    if (offset >= 0)
+      offset += length;
+    size -= length;
+  }
+  return true;
+}
+
+bool Apply(const base::FilePath& base_path,
+           const base::FilePath& delta_path,
+           const base::FilePath& output_path,
+           std::string* error) {
+  base::File delta(delta_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!delta.IsValid()) {
+    *error = "Unable to open the delta";
+    return false;
+  }
+
+  Reader reader(&delta);
+  char magic[kMagicLength];
+  uint32 version;
+  uint64 base_size, target_size;
+  uint8 digest[crypto::kSHA256Length];
+  uint32 chunk_count;
+  if (!reader.ReadBytes(magic, sizeof(magic)) ||
+      memcmp(magic, kMagic, kMagicLength) != 0 ||
+      !reader.ReadNumber(&version) || version != kVersion ||
+      !reader.ReadNumber(&base_size) || !reader.ReadNumber(&target_size) ||
+      !reader.ReadBytes(digest, sizeof(digest)) ||
+      !reader.ReadNumber(&chunk_count)) {
+    *error = "Invalid delta";
+    return false;
+  }
+
+  // The delta is not trusted until the output matches its digest, so the
+  // chunks must fit in the file before they are allocated, and the inserts
+  // in what follows them.
+  int64 delta_length = delta.GetLength();
+  if (delta_length < kHeadSize ||
+      chunk_count > (delta_length - kHeadSize) / kChunkRecordSize) {
+    *error = "Invalid delta";
+    return false;
+  }
+  uint64 insert_space = static_cast<uint64>(
+      delta_length - kHeadSize - chunk_count * kChunkRecordSize);
+
+  std::vector<Chunk> chunks(chunk_count);
+  uint64 total_size = 0;
+  uint64 insert_size = 0;
+  for (Chunk& chunk : chunks) {
+    if (!reader.ReadNumber(&chunk.type) || !reader.ReadNumber(&chunk.offset) ||
+        !reader.ReadNumber(&chunk.size) ||
+        (chunk.type != kChunkCopy && chunk.type != kChunkInsert) ||
+        (chunk.type == kChunkCopy &&
+         (chunk.offset > base_size || chunk.size > base_size - chunk.offset)) ||
+        (chunk.type == kChunkInsert &&
+         chunk.size > insert_space - insert_size) ||
+        chunk.size > target_size - total_size) {
+      *error = "Invalid delta";
+      return false;
+    }
+    if (chunk.type == kChunkInsert)
+      insert_size += chunk.size;
+    total_size += chunk.size;
+  }
+  if (total_size != target_size) {
+    *error = "Invalid delta";
+    return false;
+  }
+
+  base::File base(base_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!base.IsValid() || base.GetLength() != static_cast<int64>(base_size)) {
+    *error = "The delta was not made for the installed archive";
+    return false;
+  }
+
+  base::File output(output_path,
+                    base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  if (!output.IsValid()) {
+    *error = "Unable to create " + output_path.AsUTF8Unsafe();
+    return false;
+  }
+
+  scoped_ptr<crypto::SecureHash> hash(
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256));
+  std::vector<char> buffer(kBufferSize);
+  for (const Chunk& chunk : chunks) {
+    bool copied = chunk.type == kChunkCopy ?
+        CopyRange(&base, chunk.offset, chunk.size, &output, hash.get(),
+                  &buffer) :
+        CopyRange(&delta, -1, chunk.size, &output, hash.get(), &buffer);
+    if (!copied) {
+      *error = "Failed to write " + output_path.AsUTF8Unsafe();
+      return false;
+    }
+  }
+
+  uint8 output_digest[crypto::kSHA256Length];
+  hash->Finish(output_digest, sizeof(output_digest));
+  if (memcmp(digest, output_digest, sizeof(digest)) != 0) {
+    *error = "The patched archive does not match the delta's digest";
+    return false;
+  }
+  if (!output.Flush()) {
+    *error = "Failed to write " + output_path.AsUTF8Unsafe();
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool ApplyArchiveDelta(const base::FilePath& base_path,
+                       const base::FilePath& delta_path,
+                       const base::FilePath& output_path,
+                       std::string* error) {
+  if (Apply(base_path, delta_path, output_path, error))
+    return true;
+  base::DeleteFile(output_path, false);
+  return false;
+}
+
+}  // namespace asar
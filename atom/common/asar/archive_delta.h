@@ -0,0 +1,41 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_ARCHIVE_DELTA_H_
+#define ATOM_COMMON_ASAR_ARCHIVE_DELTA_H_
+
+#include <string>
+
+namespace base {
+class FilePath;
+}
+
+namespace asar {
+
+// A delta rebuilds an archive from an older one, copying the ranges that are
+// unchanged and taking the others from the delta itself. It is made by
+// script/create-asar-delta.py:
+//
+//   "ASARDIFF", uint32 version, uint64 base size, uint64 target size,
+//   32 bytes of the target's SHA-256, uint32 chunk count,
+//   chunks of (uint8 type, uint64 base offset, uint64 size),
+//   the bytes of the insert chunks one after another.
+//
+// Numbers are little-endian. A copy chunk (type 0) copies |size| bytes of the
+// base archive from |base offset|, an insert chunk (type 1) takes the next
+// |size| bytes of the delta.
+//
+// Writes the archive made from |base_path| and |delta_path| to |output_path|,
+// and checks it against the digest of the delta. Returns false and sets
+// |error| when the delta does not apply, in which case |output_path| is
+// removed. The files are read and written in blocking calls, so it has to be
+// called where blocking is allowed.
+bool ApplyArchiveDelta(const base::FilePath& base_path,
+                       const base::FilePath& delta_path,
+                       const base::FilePath& output_path,
+                       std::string* error);
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_ARCHIVE_DELTA_H_
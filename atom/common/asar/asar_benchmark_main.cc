@@ -0,0 +1,334 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+// Measures the native side of asar archives on synthetic archives:
+// parsing headers, looking up entries, reading files and copying them out.
+// The results are printed as JSON, see docs/development/asar-benchmarks.md.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "atom/common/asar/archive.h"
+#include "atom/common/asar/asar_util.h"
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/pickle.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/values.h"
+
+namespace {
+
+const char kEntriesSwitch[] = "entries";
+const char kIterationsSwitch[] = "iterations";
+const char kTimeSwitch[] = "time";
+const char kOutputSwitch[] = "output";
+
+// The default numbers of files in the generated archives.
+const char kDefaultEntries[] = "1000,10000,50000,200000";
+
+// Size of each small file, like a small script.
+const size_t kSmallFileSize = 256;
+// Files used for measuring the throughput and latency of large reads.
+const size_t kLargeFileSize = 16 * 1024 * 1024;
+const size_t kCopyFileSize = 1024 * 1024;
+const char kLargeFileName[] = "large.bin";
+const char kCopyFileName[] = "copy.node";
+
+// Files are spread over two levels of directories, e.g. "a1/b23/f45.js", so
+// the directories have the sizes of those in real node_modules trees.
+const size_t kFilesPerDirectory = 100;
+const size_t kDirectoriesPerDirectory = 100;
+
+struct Options {
+  int iterations;
+  base::TimeDelta time;
+};
+
+std::string SmallFilePath(size_t i) {
+  return base::StringPrintf(
+      "a%d/b%d/f%d.js",
+      static_cast<int>(i / (kFilesPerDirectory * kDirectoriesPerDirectory)),
+      static_cast<int>((i / kFilesPerDirectory) % kDirectoriesPerDirectory),
+      static_cast<int>(i % kFilesPerDirectory));
+}
+
+// Returns the "files" dictionary of the directory at |dir_path|, creating
+// the directories on the way.
+base::DictionaryValue* GetDirectory(base::DictionaryValue* root,
+                                    const std::vector<std::string>& dir_path) {
+  base::DictionaryValue* files = root;
+  for (const std::string& name : dir_path) {
+    base::DictionaryValue* node;
+    if (!files->GetDictionaryWithoutPathExpansion(name, &node)) {
+      node = new base::DictionaryValue;
+      node->Set("files", new base::DictionaryValue);
+      files->SetWithoutPathExpansion(name, node);
+    }
+    node->GetDictionaryWithoutPathExpansion("files", &files);
+  }
+  return files;
+}
+
+void AddFile(base::DictionaryValue* root,
+             const std::string& path,
+             size_t size,
+             uint64* offset) {
+  std::vector<std::string> components;
+  base::SplitString(path, '/', &components);
+  std::string name = components.back();
+  components.pop_back();
+
+  base::DictionaryValue* node = new base::DictionaryValue;
+  node->SetInteger("size", static_cast<int>(size));
+  node->SetString("offset", base::Uint64ToString(*offset));
+  GetDirectory(root, components)->SetWithoutPathExpansion(name, node);
+  *offset += size;
+}
+
+// Writes an archive with a JSON header, in the format of the asar module,
+// with |entries| small files plus the large files.
+bool WriteArchive(const base::FilePath& path, size_t entries) {
+  base::DictionaryValue header;
+  base::DictionaryValue* root = new base::DictionaryValue;
+  header.Set("files", root);
+  uint64 offset = 0;
+  for (size_t i = 0; i < entries; ++i)
+    AddFile(root, SmallFilePath(i), kSmallFileSize, &offset);
+  AddFile(root, kLargeFileName, kLargeFileSize, &offset);
+  AddFile(root, kCopyFileName, kCopyFileSize, &offset);
+
+  std::string json;
+  base::JSONWriter::Write(header, &json);
+  base::Pickle header_pickle;
+  header_pickle.WriteString(json);
+  base::Pickle size_pickle;
+  size_pickle.WriteUInt32(static_cast<uint32>(header_pickle.size()));
+
+  base::File file(path,
+                  base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  if (!file.IsValid())
+    return false;
+  int size_length = static_cast<int>(size_pickle.size());
+  int header_length = static_cast<int>(header_pickle.size());
+  if (file.WriteAtCurrentPos(static_cast<const char*>(size_pickle.data()),
+                             size_length) != size_length ||
+      file.WriteAtCurrentPos(static_cast<const char*>(header_pickle.data()),
+                             header_length) != header_length)
+    return false;
+
+  // The same chunk is written for all contents, only the sizes matter.
+  std::string chunk(kCopyFileSize, 'a');
+  for (uint64 written = 0; written < offset;) {
+    int length = static_cast<int>(std::min<uint64>(chunk.size(),
+                                                   offset - written));
+    if (file.WriteAtCurrentPos(chunk.data(), length) != length)
+      return false;
+    written += length;
+  }
+  return true;
+}
+
+// Runs |fn| until the iterations or the time of |options| run out, at least
+// 3 times, and returns the mean time of each run.
+template<typename Function>
+base::TimeDelta Measure(const Options& options, const Function& fn) {
+  int runs = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  base::TimeDelta elapsed;
+  do {
+    fn();
+    ++runs;
+    elapsed = base::TimeTicks::Now() - start;
+  } while (runs < 3 || (runs < options.iterations && elapsed < options.time));
+  return elapsed / runs;
+}
+
+double PerSecond(size_t operations, base::TimeDelta time) {
+  return operations / time.InSecondsF();
+}
+
+// Paths of all small files and directories in a shuffled order, so lookups
+// don't walk the header in the order it was built.
+void GetShuffledPaths(size_t entries,
+                      std::vector<base::FilePath>* files,
+                      std::vector<base::FilePath>* directories) {
+  for (size_t i = 0; i < entries; ++i) {
+    base::FilePath path = base::FilePath::FromUTF8Unsafe(SmallFilePath(i));
+    files->push_back(path);
+    if (i % kFilesPerDirectory == 0)
+      directories->push_back(path.DirName());
+  }
+  std::minstd_rand random(entries);
+  std::shuffle(files->begin(), files->end(), random);
+  std::shuffle(directories->begin(), directories->end(), random);
+}
+
+scoped_ptr<base::DictionaryValue> RunCase(const Options& options,
+                                          const base::FilePath& archive_path,
+                                          size_t entries) {
+  scoped_ptr<base::DictionaryValue> result(new base::DictionaryValue);
+  result->SetInteger("entries", static_cast<int>(entries));
+  int64 archive_size = 0;
+  base::GetFileSize(archive_path, &archive_size);
+  result->SetDouble("archiveSize", archive_size);
+
+  base::TimeDelta init = Measure(options, [&archive_path]() {
+    asar::Archive archive(archive_path);
+    CHECK(archive.Init());
+  });
+  result->SetDouble("initMs", init.InMillisecondsF());
+
+  asar::Archive archive(archive_path);
+  CHECK(archive.Init());
+  std::vector<base::FilePath> files, directories;
+  GetShuffledPaths(entries, &files, &directories);
+
+  base::TimeDelta get_file_info = Measure(options, [&]() {
+    asar::Archive::FileInfo info;
+    for (const base::FilePath& path : files)
+      CHECK(archive.GetFileInfo(path, &info));
+  });
+  result->SetDouble("getFileInfoPerSecond",
+                    PerSecond(files.size(), get_file_info));
+
+  base::TimeDelta stat = Measure(options, [&]() {
+    asar::Archive::Stats stats;
+    for (const base::FilePath& path : files)
+      CHECK(archive.Stat(path, &stats));
+  });
+  result->SetDouble("statPerSecond", PerSecond(files.size(), stat));
+
+  base::TimeDelta readdir = Measure(options, [&]() {
+    for (const base::FilePath& path : directories) {
+      std::vector<base::FilePath> children;
+      CHECK(archive.Readdir(path, &children));
+    }
+  });
+  result->SetDouble("readdirPerSecond",
+                    PerSecond(directories.size(), readdir));
+
+  // Through the archive cache, like the reads of the browser and renderers.
+  std::vector<base::FilePath> small_files(
+      files.begin(), files.begin() + std::min<size_t>(files.size(), 1000));
+  base::TimeDelta read_small = Measure(options, [&]() {
+    std::string contents;
+    for (const base::FilePath& path : small_files)
+      CHECK(asar::ReadFileToString(archive_path.Append(path), &contents));
+  });
+  result->SetDouble("readFileToStringSmallPerSecond",
+                    PerSecond(small_files.size(), read_small));
+
+  base::FilePath large_path = archive_path.AppendASCII(kLargeFileName);
+  base::TimeDelta read_large = Measure(options, [&large_path]() {
+    std::string contents;
+    CHECK(asar::ReadFileToString(large_path, &contents));
+  });
+  result->SetDouble("readFileToStringBytesPerSecond",
+                    PerSecond(kLargeFileSize, read_large));
+
+  // Copied files are cached by their archive, so each run uses a new one and
+  // only the copy is timed.
+  base::FilePath copy_path = base::FilePath::FromUTF8Unsafe(kCopyFileName);
+  base::TimeDelta copy_file_out;
+  int copies = 0;
+  Measure(options, [&]() {
+    asar::Archive fresh_archive(archive_path);
+    CHECK(fresh_archive.Init());
+    base::FilePath out;
+    base::TimeTicks start = base::TimeTicks::Now();
+    CHECK(fresh_archive.CopyFileOut(copy_path, &out));
+    copy_file_out += base::TimeTicks::Now() - start;
+    ++copies;
+  });
+  result->SetDouble("copyFileOutMs",
+                    (copy_file_out / copies).InMillisecondsF());
+
+  asar::ClearCachedArchives();
+  return result.Pass();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  base::AtExitManager at_exit;
+  base::CommandLine::Init(argc, argv);
+  const base::CommandLine* command_line =
+      base::CommandLine::ForCurrentProcess();
+
+  Options options;
+  options.iterations = 100;
+  options.time = base::TimeDelta::FromSeconds(1);
+  int value;
+  if (base::StringToInt(command_line->GetSwitchValueASCII(kIterationsSwitch),
+                        &value))
+    options.iterations = value;
+  if (base::StringToInt(command_line->GetSwitchValueASCII(kTimeSwitch),
+                        &value))
+    options.time = base::TimeDelta::FromMilliseconds(value);
+
+  std::string entries_list = command_line->HasSwitch(kEntriesSwitch) ?
+      command_line->GetSwitchValueASCII(kEntriesSwitch) : kDefaultEntries;
+  std::vector<std::string> entries_strings;
+  base::SplitString(entries_list, ',', &entries_strings);
+
+  base::ScopedTempDir temp_dir;
+  if (!temp_dir.CreateUniqueTempDir()) {
+    fprintf(stderr, "Unable to create a temporary directory\n");
+    return 1;
+  }
+
+  base::ListValue* results = new base::ListValue;
+  for (const std::string& entries_string : entries_strings) {
+    unsigned entries;
+    if (!base::StringToUint(entries_string, &entries)) {
+      fprintf(stderr, "Invalid number of entries: %s\n",
+              entries_string.c_str());
+      return 1;
+    }
+    fprintf(stderr, "%u entries\n", entries);
+
+    base::FilePath archive_path = temp_dir.path().AppendASCII(
+        base::StringPrintf("%u.asar", entries));
+    if (!WriteArchive(archive_path, entries)) {
+      fprintf(stderr, "Unable to write %s\n",
+              archive_path.AsUTF8Unsafe().c_str());
+      return 1;
+    }
+    results->Append(RunCase(options, archive_path, entries).release());
+    base::DeleteFile(archive_path, false);
+  }
+
+  base::DictionaryValue report;
+  report.SetInteger("smallFileSize", static_cast<int>(kSmallFileSize));
+  report.SetInteger("largeFileSize", static_cast<int>(kLargeFileSize));
+  report.SetInteger("copyFileSize", static_cast<int>(kCopyFileSize));
+  report.Set("results", results);
+  std::string json;
+  base::JSONWriter::WriteWithOptions(
+      report, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json);
+
+  base::FilePath output = command_line->GetSwitchValuePath(kOutputSwitch);
+  if (output.empty()) {
+    fputs(json.c_str(), stdout);
+  } else if (base::WriteFile(output, json.data(), json.size()) !=
+             static_cast<int>(json.size())) {
+    fprintf(stderr, "Unable to write %s\n", output.AsUTF8Unsafe().c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -4,36 +4,168 @@
 
 #include "atom/common/asar/asar_util.h"
 
-#include <map>
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "atom/common/asar/archive.h"
+#include "atom/common/asar/readahead.h"
+#include "base/bind.h"
+#include "base/containers/mru_cache.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/lazy_instance.h"
-#include "base/stl_util.h"
+#include "base/location.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/sys_info.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
 
 namespace asar {
 
 namespace {
 
-// The global instance of ArchiveMap, will be destroyed on exit.
-typedef std::map<base::FilePath, std::shared_ptr<Archive>> ArchiveMap;
-static base::LazyInstance<ArchiveMap> g_archive_map = LAZY_INSTANCE_INITIALIZER;
+// Archives opened in this process, shared by all threads and by the JS
+// binding. Least recently used archives are dropped when there are too many,
+// they are freed once their last user releases them.
+struct ArchiveRegistry {
+  ArchiveRegistry() : archives(kMaxCachedArchives) {}
+
+  base::Lock lock;
+  base::MRUCache<base::FilePath, std::shared_ptr<Archive>> archives;
+};
+
+// The global instance of ArchiveRegistry, will be destroyed on exit.
+static base::LazyInstance<ArchiveRegistry> g_archive_registry =
+    LAZY_INSTANCE_INITIALIZER;
 
 const base::FilePath::CharType kAsarExtension[] = FILE_PATH_LITERAL(".asar");
 
+// Collects the packed files under |dir| recursively, links are skipped since
+// their targets are collected anyway.
+void CollectFiles(Archive* archive,
+                  const base::FilePath& dir,
+                  std::vector<Archive::FileInfo>* files) {
+  std::vector<base::FilePath> children;
+  if (!archive->Readdir(dir, &children))
+    return;
+
+  for (const base::FilePath& child : children) {
+    base::FilePath path = dir.empty() ? child : dir.Append(child);
+    Archive::Stats stats;
+    if (!archive->Stat(path, &stats) || stats.is_link)
+      continue;
+    if (stats.is_directory)
+      CollectFiles(archive, path, files);
+    else if (!stats.unpacked)
+      files->push_back(stats);
+  }
+}
+
+// Verification of all files in an archive, split into stripes that are run on
+// different worker threads.
+class IntegrityCheck : public base::RefCountedThreadSafe<IntegrityCheck> {
+ public:
+  explicit IntegrityCheck(std::shared_ptr<Archive> archive)
+      : archive_(archive), all_done_(&lock_), pending_(0), intact_(true) {}
+
+  // Runs the check and waits for all stripes to finish.
+  bool Run() {
+    CollectFiles(archive_.get(), base::FilePath(), &files_);
+    size_t stripes = std::min<size_t>(
+        std::max(base::SysInfo::NumberOfProcessors(), 1), files_.size());
+    if (stripes == 0)
+      return true;
+
+    pending_ = stripes;
+    for (size_t i = 1; i < stripes; ++i)
+      base::WorkerPool::PostTask(
+          FROM_HERE,
+          base::Bind(&IntegrityCheck::VerifyStripe, this, i, stripes),
+          true);
+    VerifyStripe(0, stripes);
+
+    base::AutoLock auto_lock(lock_);
+    while (pending_ > 0)
+      all_done_.Wait();
+    return intact_;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<IntegrityCheck>;
+  ~IntegrityCheck() {}
+
+  void VerifyStripe(size_t stripe, size_t stripes) {
+    bool intact = true;
+    for (size_t i = stripe; i < files_.size() && intact; i += stripes)
+      intact = archive_->VerifyFile(files_[i]);
+
+    base::AutoLock auto_lock(lock_);
+    intact_ = intact_ && intact;
+    if (--pending_ == 0)
+      all_done_.Signal();
+  }
+
+  std::shared_ptr<Archive> archive_;
+  std::vector<Archive::FileInfo> files_;
+
+  base::Lock lock_;
+  base::ConditionVariable all_done_;
+  size_t pending_;
+  bool intact_;
+
+  DISALLOW_COPY_AND_ASSIGN(IntegrityCheck);
+};
+
+bool RunIntegrityCheck(std::shared_ptr<Archive> archive) {
+  scoped_refptr<IntegrityCheck> check(new IntegrityCheck(archive));
+  return check->Run();
+}
+
+std::shared_ptr<Archive> GetOrCreateArchive(const base::FilePath& path,
+                                            bool readahead) {
+  ArchiveRegistry& registry = g_archive_registry.Get();
+  // The lock is held while parsing, so an archive is only parsed once even
+  // when multiple threads ask for it at the same time.
+  base::AutoLock auto_lock(registry.lock);
+  auto iter = registry.archives.Get(path);
+  if (iter != registry.archives.end())
+    return iter->second;
+
+  std::shared_ptr<Archive> archive(new Archive(path));
+  if (!archive->Init())
+    return nullptr;
+  registry.archives.Put(path, archive);
+
+  // Warm up the ranges read during last startup.
+  if (readahead)
+    StartReadahead(path);
+  return archive;
+}
+
 }  // namespace
 
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
-  ArchiveMap& archive_map = *g_archive_map.Pointer();
-  if (!ContainsKey(archive_map, path)) {
-    std::shared_ptr<Archive> archive(new Archive(path));
-    if (!archive->Init())
-      return nullptr;
-    archive_map[path] = archive;
-  }
-  return archive_map[path];
+  return GetOrCreateArchive(path, true);
+}
+
+bool PreloadAsarArchive(const base::FilePath& path) {
+  return GetOrCreateArchive(path, false) != nullptr;
+}
+
+void ClearCachedArchives() {
+  ArchiveRegistry& registry = g_archive_registry.Get();
+  base::AutoLock auto_lock(registry.lock);
+  registry.archives.Clear();
+}
+
+void FinishReadaheadRecordings() {
+  ArchiveRegistry& registry = g_archive_registry.Get();
+  base::AutoLock auto_lock(registry.lock);
+  for (const auto& pair : registry.archives)
+    pair.second->FinishReadaheadRecording();
 }
 
 bool GetAsarArchivePath(const base::FilePath& full_path,
@@ -78,13 +210,19 @@ bool ReadFileToString(const base::FilePath& path, std::string* contents) {
     return base::ReadFileToString(real_path, contents);
   }
 
-  base::File src(asar_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
-  if (!src.IsValid())
-    return false;
-
   contents->resize(info.size);
-  return static_cast<int>(info.size) == src.Read(
-      info.offset, const_cast<char*>(contents->data()), contents->size());
+  return static_cast<int>(info.size) == archive->ReadFile(
+      info, 0, info.size, const_cast<char*>(contents->data()));
+}
+
+void VerifyAsarArchive(std::shared_ptr<Archive> archive,
+                       const base::Callback<void(bool)>& callback) {
+  // The reply runs on current thread, so |callback| never leaves it.
+  base::PostTaskAndReplyWithResult(
+      base::WorkerPool::GetTaskRunner(true).get(),
+      FROM_HERE,
+      base::Bind(&RunIntegrityCheck, archive),
+      callback);
 }
 
 }  // namespace asar
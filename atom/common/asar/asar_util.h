@@ -8,6 +8,8 @@
 #include <memory>
 #include <string>
 
+#include "base/callback_forward.h"
+
 namespace base {
 class FilePath;
 }
@@ -16,9 +18,26 @@ namespace asar {
 
 class Archive;
 
-// Gets or creates a new Archive from the path.
+// The maximum number of archives kept open by GetOrCreateAsarArchive.
+const size_t kMaxCachedArchives = 64;
+
+// Gets or creates a new Archive from the path, it is safe to call this from
+// any thread.
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path);
 
+// Parses the archive and keeps it open like GetOrCreateAsarArchive, without
+// starting the readahead, which runs on a worker thread. This is for the zygote
+// on Linux, which must stay single threaded to fork the renderers.
+bool PreloadAsarArchive(const base::FilePath& path);
+
+// Drops the archives kept open by GetOrCreateAsarArchive, they are freed once
+// their last user releases them.
+void ClearCachedArchives();
+
+// Saves the readahead manifests of the archives kept open by
+// GetOrCreateAsarArchive, for processes that exit without freeing them.
+void FinishReadaheadRecordings();
+
 // Separates the path to Archive out.
 bool GetAsarArchivePath(const base::FilePath& full_path,
                         base::FilePath* asar_path,
@@ -27,6 +46,12 @@ bool GetAsarArchivePath(const base::FilePath& full_path,
 // Same with base::ReadFileToString but supports asar Archive.
 bool ReadFileToString(const base::FilePath& path, std::string* contents);
 
+// Verifies all files of |archive| against their integrity hashes, spread over
+// worker threads, and calls |callback| on current thread with whether they are
+// all intact.
+void VerifyAsarArchive(std::shared_ptr<Archive> archive,
+                       const base::Callback<void(bool)>& callback);
+
 }  // namespace asar
 
 #endif  // ATOM_COMMON_ASAR_ASAR_UTIL_H_
@@ -0,0 +1,213 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/binary_header.h"
+
+#include <string.h>
+
+#include "crypto/sha2.h"
+
+namespace asar {
+
+namespace {
+
+const uint32 kMagic = 0x32525341;  // "ASR2"
+const uint32 kIntegrityMagic = 0x49525341;  // "ASRI"
+const size_t kPrefixSize = 16;
+const size_t kRecordSize = 32;
+
+uint32 ReadUInt32(const char* p) {
+  uint32 value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+struct BinaryHeader::RawRecord {
+  uint32 path_offset;
+  uint32 path_length;
+  uint32 flags;
+  uint32 size;
+  uint64 offset;
+  uint32 link_offset;
+  uint32 link_length;
+};
+
+BinaryHeader::BinaryHeader(const base::StringPiece& data)
+    : data_(data),
+      record_count_(0),
+      child_count_(0),
+      records_offset_(0),
+      children_offset_(0),
+      strings_offset_(0),
+      strings_size_(0),
+      integrity_offset_(0) {
+}
+
+BinaryHeader::~BinaryHeader() {
+}
+
+bool BinaryHeader::Init() {
+  if (data_.size() < kPrefixSize)
+    return false;
+  if (ReadUInt32(data_.data()) != kMagic)
+    return false;
+
+  record_count_ = ReadUInt32(data_.data() + 4);
+  child_count_ = ReadUInt32(data_.data() + 8);
+  strings_size_ = ReadUInt32(data_.data() + 12);
+
+  // Check the sizes in 64bit, so crafted counts can not overflow.
+  uint64 total = kPrefixSize +
+                 static_cast<uint64>(record_count_) * kRecordSize +
+                 static_cast<uint64>(child_count_) * sizeof(uint32) +
+                 strings_size_;
+  if (record_count_ == 0 || total > data_.size())
+    return false;
+
+  records_offset_ = kPrefixSize;
+  children_offset_ = records_offset_ + record_count_ * kRecordSize;
+  strings_offset_ = children_offset_ + child_count_ * sizeof(uint32);
+
+  // The integrity table is optional, but must cover all records if present.
+  size_t integrity_start = static_cast<size_t>((total + 3) / 4 * 4);
+  if (integrity_start + 2 * sizeof(uint32) <= data_.size() &&
+      ReadUInt32(data_.data() + integrity_start) == kIntegrityMagic) {
+    if (ReadUInt32(data_.data() + integrity_start + 4) != record_count_ ||
+        integrity_start + 2 * sizeof(uint32) +
+            static_cast<uint64>(record_count_) * 2 * sizeof(uint32) >
+            data_.size())
+      return false;
+    integrity_offset_ = integrity_start + 2 * sizeof(uint32);
+  }
+
+  // The root must come first.
+  RawRecord root;
+  ReadRecord(0, &root);
+  return root.path_length == 0 && (root.flags & FLAG_DIRECTORY);
+}
+
+bool BinaryHeader::Find(const base::StringPiece& path, Record* record) const {
+  int64 index = Search(path);
+  if (index < 0)
+    return false;
+
+  RawRecord raw;
+  ReadRecord(static_cast<uint32>(index), &raw);
+  record->flags = raw.flags;
+  record->size = raw.size;
+  record->offset = raw.offset;
+  record->link = GetString(raw.link_offset, raw.link_length);
+  if (!ReadIntegrity(static_cast<uint32>(index), record))
+    return false;
+  if (!(record->flags & FLAG_COMPRESSED))
+    return true;
+
+  // Parse the block table.
+  base::StringPiece table = record->link;
+  record->link = base::StringPiece();
+  if (table.size() < sizeof(uint32) || table.size() % sizeof(uint32))
+    return false;
+  record->block_size = ReadUInt32(table.data());
+  size_t count = table.size() / sizeof(uint32) - 1;
+  if (record->block_size == 0 ||
+      count != (record->size + record->block_size - 1) / record->block_size)
+    return false;
+  record->blocks.resize(count);
+  for (size_t i = 0; i < count; ++i)
+    record->blocks[i] = ReadUInt32(table.data() + (i + 1) * sizeof(uint32));
+  return true;
+}
+
+bool BinaryHeader::GetChildren(const base::StringPiece& path,
+                               std::vector<base::FilePath>* children) const {
+  int64 index = Search(path);
+  if (index < 0)
+    return false;
+
+  RawRecord dir;
+  ReadRecord(static_cast<uint32>(index), &dir);
+  if (!(dir.flags & FLAG_DIRECTORY))
+    return false;
+  if (dir.offset > child_count_ || dir.size > child_count_ - dir.offset)
+    return false;
+
+  for (uint32 i = 0; i < dir.size; ++i) {
+    uint32 child_index = ReadUInt32(
+        data_.data() + children_offset_ + (dir.offset + i) * sizeof(uint32));
+    if (child_index >= record_count_)
+      return false;
+
+    RawRecord child;
+    ReadRecord(child_index, &child);
+    base::StringPiece name = GetString(child.path_offset, child.path_length);
+    size_t separator = name.rfind('/');
+    if (separator != base::StringPiece::npos)
+      name.remove_prefix(separator + 1);
+    children->push_back(base::FilePath::FromUTF8Unsafe(name.as_string()));
+  }
+  return true;
+}
+
+bool BinaryHeader::ReadIntegrity(uint32 index, Record* record) const {
+  if (!integrity_offset_)
+    return true;
+
+  const char* p = data_.data() + integrity_offset_ + index * 2 * sizeof(uint32);
+  uint32 length = ReadUInt32(p + 4);
+  if (length == 0)
+    return true;
+
+  base::StringPiece integrity = GetString(ReadUInt32(p), length);
+  if (integrity.size() != length ||
+      length < sizeof(uint32) + crypto::kSHA256Length ||
+      (length - sizeof(uint32)) % crypto::kSHA256Length)
+    return false;
+  record->integrity_block_size = ReadUInt32(integrity.data());
+  if (record->integrity_block_size == 0)
+    return false;
+  record->hash = integrity.substr(sizeof(uint32), crypto::kSHA256Length);
+  record->block_hashes =
+      integrity.substr(sizeof(uint32) + crypto::kSHA256Length);
+  return true;
+}
+
+void BinaryHeader::ReadRecord(uint32 index, RawRecord* record) const {
+  const char* p = data_.data() + records_offset_ + index * kRecordSize;
+  record->path_offset = ReadUInt32(p);
+  record->path_length = ReadUInt32(p + 4);
+  record->flags = ReadUInt32(p + 8);
+  record->size = ReadUInt32(p + 12);
+  memcpy(&record->offset, p + 16, sizeof(record->offset));
+  record->link_offset = ReadUInt32(p + 24);
+  record->link_length = ReadUInt32(p + 28);
+}
+
+base::StringPiece BinaryHeader::GetString(uint32 offset, uint32 length) const {
+  if (offset > strings_size_ || length > strings_size_ - offset)
+    return base::StringPiece();
+  return base::StringPiece(data_.data() + strings_offset_ + offset, length);
+}
+
+int64 BinaryHeader::Search(const base::StringPiece& path) const {
+  uint32 low = 0;
+  uint32 high = record_count_;
+  while (low < high) {
+    uint32 middle = low + (high - low) / 2;
+    RawRecord record;
+    ReadRecord(middle, &record);
+    int result =
+        GetString(record.path_offset, record.path_length).compare(path);
+    if (result == 0)
+      return middle;
+    else if (result < 0)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return -1;
+}
+
+}  // namespace asar
@@ -0,0 +1,124 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_BINARY_HEADER_H_
+#define ATOM_COMMON_ASAR_BINARY_HEADER_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+#include "base/strings/string_piece.h"
+
+namespace asar {
+
+// Reader of the binary (version 2) asar header, which is designed to be used
+// in place from the mapped archive without any parsing:
+//
+//   uint32 magic              "ASR2"
+//   uint32 record_count
+//   uint32 child_count
+//   uint32 strings_size
+//   Record records[record_count]   sorted by path, records[0] is the root
+//   uint32 children[child_count]   indices of records, grouped by directory
+//   char strings[strings_size]
+//
+// Each record is 32 bytes:
+//
+//   uint32 path_offset, path_length   full path relative to the root
+//   uint32 flags
+//   uint32 size                       file size, or number of children
+//   uint64 offset                     file offset, or index of first child
+//   uint32 link_offset, link_length   target of link, already resolved, or
+//                                     block table of compressed file
+//
+// A link to a compressed file is stored without FLAG_RESOLVED, as the record
+// can not hold both its realpath and the block table; readers take the data
+// of such a link from the record of its target.
+//
+// The block table of compressed file is an uint32 block size followed by the
+// uint32 compressed size of each block.
+//
+// The header may end with an optional integrity table, starting at the first
+// 4-byte aligned offset after |strings|:
+//
+//   uint32 magic              "ASRI"
+//   uint32 record_count
+//   uint32 offset, length     string holding integrity of each record
+//
+// The integrity of a file is an uint32 block size, followed by the SHA-256
+// digest of the whole file and then the digest of each block; it is empty
+// for records without integrity.
+//
+// All integers are little-endian, and string offsets are relative to
+// |strings|.
+class BinaryHeader {
+ public:
+  enum Flags {
+    FLAG_DIRECTORY = 1 << 0,
+    FLAG_LINK      = 1 << 1,
+    FLAG_UNPACKED  = 1 << 2,
+    FLAG_RESOLVED  = 1 << 3,
+    FLAG_COMPRESSED = 1 << 4,
+  };
+
+  struct Record {
+    Record() : flags(0), size(0), offset(0), block_size(0),
+               integrity_block_size(0) {}
+    uint32 flags;
+    uint32 size;
+    uint64 offset;
+    base::StringPiece link;
+    uint32 block_size;
+    std::vector<uint32> blocks;
+    uint32 integrity_block_size;
+    base::StringPiece hash;
+    base::StringPiece block_hashes;
+  };
+
+  // The |data| must outlive this object.
+  explicit BinaryHeader(const base::StringPiece& data);
+  ~BinaryHeader();
+
+  // Validates the header, must be called before other methods.
+  bool Init();
+
+  // Binary searches the record of |path|, links are not followed.
+  bool Find(const base::StringPiece& path, Record* record) const;
+
+  // Appends the names of children of the directory at |path|.
+  bool GetChildren(const base::StringPiece& path,
+                   std::vector<base::FilePath>* children) const;
+
+ private:
+  struct RawRecord;
+
+  // Reads the |index|th record.
+  void ReadRecord(uint32 index, RawRecord* record) const;
+
+  // Fills the integrity of the |index|th record, if there is any.
+  bool ReadIntegrity(uint32 index, Record* record) const;
+
+  // Returns the string at |offset| in the string table.
+  base::StringPiece GetString(uint32 offset, uint32 length) const;
+
+  // Returns the index of record of |path|, or -1 when not found.
+  int64 Search(const base::StringPiece& path) const;
+
+  base::StringPiece data_;
+  uint32 record_count_;
+  uint32 child_count_;
+  size_t records_offset_;
+  size_t children_offset_;
+  size_t strings_offset_;
+  size_t strings_size_;
+  // Offset of the integrity table's entries, or 0 when there is none.
+  size_t integrity_offset_;
+
+  DISALLOW_COPY_AND_ASSIGN(BinaryHeader);
+};
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_BINARY_HEADER_H_
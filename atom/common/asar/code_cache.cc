@@ -0,0 +1,58 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/code_cache.h"
+
+#include "atom/common/asar/archive.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/string_number_conversions.h"
+#include "crypto/secure_hash.h"
+#include "crypto/sha2.h"
+
+namespace asar {
+
+namespace {
+
+// Directory in archives that holds the code caches made at packaging time.
+const char kArchiveCacheDir[] = ".code-cache";
+
+}  // namespace
+
+std::string GetCodeCacheKey(const base::StringPiece& source,
+                            const char* v8_version) {
+  scoped_ptr<crypto::SecureHash> hash(
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256));
+  base::StringPiece version(v8_version);
+  hash->Update(version.data(), version.size());
+  hash->Update("", 1);
+  hash->Update(source.data(), source.size());
+
+  uint8 digest[crypto::kSHA256Length];
+  hash->Finish(digest, sizeof(digest));
+  return base::HexEncode(digest, sizeof(digest));
+}
+
+bool ReadCodeCache(Archive* archive, const std::string& key,
+                   std::string* data) {
+  Archive::FileInfo info;
+  if (!archive ||
+      !archive->GetFileInfo(base::FilePath::FromUTF8Unsafe(kArchiveCacheDir)
+                               .AppendASCII(key), &info) ||
+      info.unpacked || info.size == 0)
+    return false;
+
+  base::StringPiece contents;
+  if (archive->GetFileContents(info, &contents)) {
+    contents.CopyToString(data);
+    return true;
+  }
+  data->resize(info.size);
+  if (archive->ReadFile(info, 0, static_cast<int>(info.size), &(*data)[0]) ==
+      static_cast<int>(info.size))
+    return true;
+  data->clear();
+  return false;
+}
+
+}  // namespace asar
@@ -0,0 +1,33 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_CODE_CACHE_H_
+#define ATOM_COMMON_ASAR_CODE_CACHE_H_
+
+#include <string>
+
+#include "base/strings/string_piece.h"
+
+namespace asar {
+
+class Archive;
+
+// V8 code caches of scripts in archives are kept inside the archive, as files
+// under the ".code-cache" directory, which are produced at packaging time.
+// V8 trusts the cached data it consumes, so caches are only read from the
+// archive that holds the scripts, never from a directory other programs can
+// write to. Each cache is named after its key.
+
+// Returns the key of the code cache of |source|, compiled by the V8 of
+// |v8_version|.
+std::string GetCodeCacheKey(const base::StringPiece& source,
+                            const char* v8_version);
+
+// Reads the code cache of |key| from |archive|.
+bool ReadCodeCache(Archive* archive, const std::string& key,
+                   std::string* data);
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_CODE_CACHE_H_
@@ -0,0 +1,268 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/readahead.h"
+
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#endif
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/environment.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/format_macros.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/threading/worker_pool.h"
+#include "crypto/sha2.h"
+
+namespace asar {
+
+namespace {
+
+const char kRecordEnvName[] = "ELECTRON_ASAR_RECORD_READAHEAD";
+const char kManifestSignature[] = "asar-readahead 2";
+const base::FilePath::CharType kManifestExtension[] =
+    FILE_PATH_LITERAL(".readahead");
+
+// Default recording period when the environment variable is not a number.
+const int kDefaultRecordSeconds = 10;
+
+// Stop recording new ranges after this many, to bound the manifest's size.
+const size_t kMaxRanges = 64 * 1024;
+
+// Ranges that are closer than this are read ahead together.
+const uint64 kMergeDistance = 16 * 1024;
+
+#if !defined(OS_POSIX)
+// Size of reads on platforms without readahead advice.
+const int kReadChunkSize = 1024 * 1024;
+#endif
+
+// Headers larger than this are not hashed, the archive is then treated as
+// having no version.
+const uint32 kMaxHeaderSize = 64 * 1024 * 1024;
+
+// Identifies the version of the archive by its size and the hash of its
+// header. Copies and packaging tools often keep the modification time, while
+// the header changes whenever the layout of the files does, which is what the
+// recorded ranges depend on.
+bool GetArchiveVersion(base::File* file, std::string* version) {
+  // The header size follows the uint32 size of the size pickle, the binary
+  // header has 4 more bytes before the header.
+  char prefix[8];
+  if (file->Read(0, prefix, sizeof(prefix)) != sizeof(prefix))
+    return false;
+  uint32 header_size;
+  memcpy(&header_size, prefix + 4, sizeof(header_size));
+  if (header_size > kMaxHeaderSize)
+    return false;
+
+  int64 archive_size = file->GetLength();
+  std::string header(static_cast<size_t>(
+      std::min<int64>(archive_size, header_size + 12)), '\0');
+  if (file->Read(0, &header[0], static_cast<int>(header.size())) !=
+          static_cast<int>(header.size()))
+    return false;
+
+  std::string hash = crypto::SHA256HashString(header);
+  *version = base::StringPrintf("%" PRId64 " ", archive_size) +
+             base::HexEncode(hash.data(), hash.size());
+  return true;
+}
+
+void WriteManifest(const base::FilePath& path, const std::string& content) {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  // Write to a temporary file first so readers never see a partial manifest.
+  base::FilePath temp_path = path.AddExtension(FILE_PATH_LITERAL(".tmp"));
+  if (base::WriteFile(temp_path, content.data(), content.size()) !=
+          static_cast<int>(content.size()) ||
+      !base::Move(temp_path, path)) {
+    LOG(WARNING) << "Failed to write readahead manifest " << path.value();
+    base::DeleteFile(temp_path, false);
+  }
+}
+
+bool ParseManifest(const std::string& content,
+                   const std::string& archive_version,
+                   int64 archive_size,
+                   std::vector<ReadaheadRange>* ranges) {
+  std::vector<std::string> lines;
+  base::SplitString(content, '\n', &lines);
+  if (lines.size() < 2 || lines[0] != kManifestSignature)
+    return false;
+  if (lines[1] != archive_version)
+    return false;
+
+  for (size_t i = 2; i < lines.size(); ++i) {
+    if (lines[i].empty())
+      continue;
+    std::vector<std::string> fields;
+    base::SplitString(lines[i], ' ', &fields);
+    ReadaheadRange range;
+    if (fields.size() != 2 ||
+        !base::StringToUint64(fields[0], &range.first) ||
+        !base::StringToUint64(fields[1], &range.second))
+      return false;
+    if (range.first >= static_cast<uint64>(archive_size))
+      continue;
+    range.second = std::min<uint64>(range.second, archive_size - range.first);
+
+    // Merge with the previous range when they are close.
+    if (!ranges->empty()) {
+      ReadaheadRange& last = ranges->back();
+      if (range.first >= last.first &&
+          range.first <= last.first + last.second + kMergeDistance) {
+        last.second = std::max(last.second,
+                               range.first + range.second - last.first);
+        continue;
+      }
+    }
+    ranges->push_back(range);
+  }
+  return true;
+}
+
+void ReadAhead(base::File* file, const ReadaheadRange& range) {
+#if defined(OS_MACOSX)
+  struct radvisory advice;
+  advice.ra_offset = range.first;
+  advice.ra_count = static_cast<int>(
+      std::min<uint64>(range.second, kint32max));
+  fcntl(file->GetPlatformFile(), F_RDADVISE, &advice);
+#elif defined(OS_POSIX)
+  posix_fadvise(file->GetPlatformFile(), range.first, range.second,
+                POSIX_FADV_WILLNEED);
+#else
+  // Bring the pages into the system cache by reading them.
+  std::vector<char> buffer(
+      static_cast<size_t>(std::min<uint64>(range.second, kReadChunkSize)));
+  for (uint64 offset = 0; offset < range.second; offset += buffer.size()) {
+    int size = static_cast<int>(
+        std::min<uint64>(buffer.size(), range.second - offset));
+    if (file->Read(range.first + offset, buffer.data(), size) <= 0)
+      break;
+  }
+#endif
+}
+
+void ReadAheadOnWorker(const base::FilePath& archive_path) {
+  std::string content;
+  if (!base::ReadFileToString(GetReadaheadManifestPath(archive_path),
+                              &content))
+    return;
+
+  base::File file(archive_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  std::string version;
+  std::vector<ReadaheadRange> ranges;
+  if (!file.IsValid() || !GetArchiveVersion(&file, &version) ||
+      !ParseManifest(content, version, file.GetLength(), &ranges))
+    return;
+  for (const ReadaheadRange& range : ranges)
+    ReadAhead(&file, range);
+}
+
+}  // namespace
+
+// static
+scoped_ptr<ReadaheadRecorder> ReadaheadRecorder::CreateIfEnabled(
+    const base::FilePath& archive_path) {
+  scoped_ptr<base::Environment> env(base::Environment::Create());
+  std::string value;
+  if (!env->GetVar(kRecordEnvName, &value))
+    return nullptr;
+
+  int seconds;
+  if (!base::StringToInt(value, &seconds) || seconds <= 0)
+    seconds = kDefaultRecordSeconds;
+
+  base::File file(archive_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  std::string version;
+  if (!file.IsValid() || !GetArchiveVersion(&file, &version))
+    return nullptr;
+
+  return make_scoped_ptr(new ReadaheadRecorder(
+      archive_path, version, base::TimeDelta::FromSeconds(seconds)));
+}
+
+ReadaheadRecorder::ReadaheadRecorder(const base::FilePath& archive_path,
+                                     const std::string& archive_version,
+                                     base::TimeDelta period)
+    : manifest_path_(GetReadaheadManifestPath(archive_path)),
+      archive_version_(archive_version),
+      deadline_(base::TimeTicks::Now() + period),
+      finished_(false) {
+}
+
+ReadaheadRecorder::~ReadaheadRecorder() {
+  Finish();
+}
+
+void ReadaheadRecorder::Finish() {
+  std::string content;
+  {
+    base::AutoLock auto_lock(lock_);
+    if (finished_)
+      return;
+    content = FinishLocked();
+  }
+  WriteManifest(manifest_path_, content);
+}
+
+void ReadaheadRecorder::Record(uint64 offset, uint64 size) {
+  std::string content;
+  {
+    base::AutoLock auto_lock(lock_);
+    if (finished_)
+      return;
+
+    if (base::TimeTicks::Now() < deadline_) {
+      // Only the first read of each range decides its position.
+      if (ranges_.size() < kMaxRanges &&
+          recorded_offsets_.insert(offset).second)
+        ranges_.push_back(ReadaheadRange(offset, size));
+      return;
+    }
+
+    content = FinishLocked();
+  }
+
+  // Reads can happen on the UI or IO thread, so save on a worker thread.
+  base::WorkerPool::PostTask(
+      FROM_HERE, base::Bind(&WriteManifest, manifest_path_, content), true);
+}
+
+std::string ReadaheadRecorder::FinishLocked() {
+  lock_.AssertAcquired();
+  finished_ = true;
+
+  std::string content = kManifestSignature;
+  content += "\n" + archive_version_ + "\n";
+  for (const ReadaheadRange& range : ranges_)
+    base::StringAppendF(&content, "%" PRIu64 " %" PRIu64 "\n",
+                        range.first, range.second);
+
+  ranges_.clear();
+  recorded_offsets_.clear();
+  return content;
+}
+
+base::FilePath GetReadaheadManifestPath(const base::FilePath& archive_path) {
+  return archive_path.AddExtension(kManifestExtension);
+}
+
+void StartReadahead(const base::FilePath& archive_path) {
+  base::WorkerPool::PostTask(
+      FROM_HERE, base::Bind(&ReadAheadOnWorker, archive_path), true);
+}
+
+}  // namespace asar
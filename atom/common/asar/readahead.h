@@ -0,0 +1,79 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_READAHEAD_H_
+#define ATOM_COMMON_ASAR_READAHEAD_H_
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace asar {
+
+// A range of archive file as (offset, size).
+typedef std::pair<uint64, uint64> ReadaheadRange;
+
+// Records the ranges of an archive read during startup, in the order they are
+// first read, and saves them as a readahead manifest next to the archive once
+// the recording period is over.
+//
+// The manifest is a text file, the first line is "asar-readahead 2", the
+// second line is the size and the SHA-256 of the header of the archive it was
+// recorded for, and each following line is the offset and size of a range.
+class ReadaheadRecorder {
+ public:
+  // Returns a recorder when the ELECTRON_ASAR_RECORD_READAHEAD environment
+  // variable is set, its value is the recording period in seconds.
+  static scoped_ptr<ReadaheadRecorder> CreateIfEnabled(
+      const base::FilePath& archive_path);
+
+  // Saves the manifest if the recording period has not ended yet.
+  ~ReadaheadRecorder();
+
+  // Stops recording and saves the manifest on the current thread, does
+  // nothing when the recording has already finished.
+  void Finish();
+
+  // Records a read of |size| bytes at |offset| of the archive file. This can
+  // be called from any thread.
+  void Record(uint64 offset, uint64 size);
+
+ private:
+  ReadaheadRecorder(const base::FilePath& archive_path,
+                    const std::string& archive_version,
+                    base::TimeDelta period);
+
+  // Stops recording and returns the content of the manifest.
+  std::string FinishLocked();
+
+  base::FilePath manifest_path_;
+  std::string archive_version_;
+  base::TimeTicks deadline_;
+
+  // Guards the following members.
+  base::Lock lock_;
+  bool finished_;
+  std::vector<ReadaheadRange> ranges_;
+  std::set<uint64> recorded_offsets_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReadaheadRecorder);
+};
+
+// Returns the path of the readahead manifest of |archive_path|.
+base::FilePath GetReadaheadManifestPath(const base::FilePath& archive_path);
+
+// Reads the manifest of |archive_path| on a worker thread and asks the system
+// to read the recorded ranges ahead, in order. Does nothing when there is no
+// manifest or it was recorded for a different version of the archive.
+void StartReadahead(const base::FilePath& archive_path);
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_READAHEAD_H_
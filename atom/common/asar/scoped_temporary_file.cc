@@ -4,18 +4,101 @@
 
 #include "atom/common/asar/scoped_temporary_file.h"
 
+#if defined(OS_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <string>
 #include <vector>
 
+#include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
+#include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/threading/thread_restrictions.h"
+#include "crypto/sha2.h"
+
+#if defined(OS_LINUX) && !defined(MFD_CLOEXEC)
+#define MFD_CLOEXEC 0x0001U
+#endif
 
 namespace asar {
 
-ScopedTemporaryFile::ScopedTemporaryFile() {
+namespace {
+
+// Directory under temp directory for cached extracted files.
+const base::FilePath::CharType kCacheDirName[] =
+    FILE_PATH_LITERAL("electron-asar-cache");
+
+// The extraction cache is trimmed to this size, dropping the files used
+// least recently first.
+const int64 kMaxCacheSize = 256 * 1024 * 1024;
+
+struct CacheEntry {
+  base::FilePath dir;
+  base::Time last_used;
+  int64 size;
+};
+
+bool IsUsedEarlier(const CacheEntry& a, const CacheEntry& b) {
+  return a.last_used < b.last_used;
+}
+
+// Removes the least recently used entries of |cache_dir| until it fits in
+// kMaxCacheSize, except |keep|. Entries still open elsewhere may fail to be
+// removed on Windows, they are tried again on a later trim.
+void TrimCache(const base::FilePath& cache_dir, const base::FilePath& keep) {
+  std::vector<CacheEntry> entries;
+  int64 total_size = 0;
+  base::FileEnumerator enumerator(cache_dir, false,
+                                  base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath dir = enumerator.Next(); !dir.empty();
+       dir = enumerator.Next()) {
+    CacheEntry entry = { dir, base::Time(), 0 };
+    base::FileEnumerator files(dir, false, base::FileEnumerator::FILES);
+    for (base::FilePath file = files.Next(); !file.empty();
+         file = files.Next()) {
+      entry.last_used = std::max(entry.last_used,
+                                 files.GetInfo().GetLastModifiedTime());
+      entry.size += files.GetInfo().GetSize();
+    }
+    total_size += entry.size;
+    entries.push_back(entry);
+  }
+  if (total_size <= kMaxCacheSize)
+    return;
+
+  std::sort(entries.begin(), entries.end(), &IsUsedEarlier);
+  for (const CacheEntry& entry : entries) {
+    if (total_size <= kMaxCacheSize)
+      break;
+    if (entry.dir != keep && base::DeleteFile(entry.dir, true))
+      total_size -= entry.size;
+  }
+}
+
+// Whether |path| already has the content of |data|.
+bool IsCachedCopyValid(const base::FilePath& path,
+                       const char* data, size_t size) {
+  int64 file_size;
+  if (!base::GetFileSize(path, &file_size) ||
+      file_size != static_cast<int64>(size))
+    return false;
+
+  std::string contents;
+  return base::ReadFileToString(path, &contents) &&
+         contents.compare(0, contents.size(), data, size) == 0;
+}
+
+}  // namespace
+
+ScopedTemporaryFile::ScopedTemporaryFile() : should_delete_(true) {
 }
 
 ScopedTemporaryFile::~ScopedTemporaryFile() {
-  if (!path_.empty()) {
+  if (!path_.empty() && should_delete_) {
     base::ThreadRestrictions::ScopedAllowIO allow_io;
     // On Windows it is very likely the file is already in use (because it is
     // mostly used for Node native modules), so deleting it now will halt the
@@ -57,4 +140,78 @@ bool ScopedTemporaryFile::InitFromFile(base::File* src,
       static_cast<int>(size);
 }
 
+bool ScopedTemporaryFile::InitFromData(const char* data, size_t size) {
+  if (!Init())
+    return false;
+
+  base::File dest(path_, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  if (!dest.IsValid())
+    return false;
+
+  return dest.WriteAtCurrentPos(data, size) == static_cast<int>(size);
+}
+
+bool ScopedTemporaryFile::InitInMemory(const char* data, size_t size) {
+#if defined(OS_LINUX) && defined(__NR_memfd_create)
+  if (!path_.empty())
+    return false;
+
+  // Child processes must not inherit the descriptor, so the path only opens
+  // in this process.
+  base::ScopedFD fd(static_cast<int>(
+      syscall(__NR_memfd_create, "electron-asar", MFD_CLOEXEC)));
+  if (!fd.is_valid())
+    return false;
+  if (!base::WriteFileDescriptor(fd.get(), data, size))
+    return false;
+
+  path_ = base::FilePath("/proc/self/fd").Append(base::IntToString(fd.get()));
+  memory_fd_ = fd.Pass();
+  should_delete_ = false;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool ScopedTemporaryFile::InitFromCache(const base::FilePath& name,
+                                        const char* data, size_t size) {
+  if (!path_.empty())
+    return false;
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  base::FilePath dir;
+  if (!PathService::Get(base::DIR_TEMP, &dir))
+    return false;
+
+  std::string hash = crypto::SHA256HashString(base::StringPiece(data, size));
+  base::FilePath cache_dir = dir.Append(kCacheDirName);
+  dir = cache_dir.AppendASCII(base::HexEncode(hash.data(), hash.size()));
+  base::FilePath target = dir.Append(name.BaseName());
+  if (IsCachedCopyValid(target, data, size)) {
+    // The time of the file tells the trimming when it was last used.
+    base::Time now = base::Time::Now();
+    base::TouchFile(target, now, now);
+  } else {
+    // Write to a temporary file first, so other processes never see a
+    // partially written file.
+    base::FilePath temp;
+    if (!base::CreateDirectory(dir) ||
+        !base::CreateTemporaryFileInDir(dir, &temp))
+      return false;
+    if (base::WriteFile(temp, data, size) != static_cast<int>(size) ||
+        !base::ReplaceFile(temp, target, nullptr)) {
+      base::DeleteFile(temp, false);
+      // Another process might be using and thus locking the file.
+      if (!IsCachedCopyValid(target, data, size))
+        return false;
+    }
+    TrimCache(cache_dir, dir);
+  }
+
+  path_ = target;
+  should_delete_ = false;
+  return true;
+}
+
 }  // namespace asar
@@ -6,6 +6,7 @@
 #define ATOM_COMMON_ASAR_SCOPED_TEMPORARY_FILE_H_
 
 #include "base/files/file_path.h"
+#include "base/files/scoped_file.h"
 
 namespace base {
 class File;
@@ -28,11 +29,35 @@ class ScopedTemporaryFile {
   // Init an temporary file and fill it with content of |path|.
   bool InitFromFile(base::File* src, uint64 offset, uint64 size);
 
+  // Init an temporary file and fill it with |data|.
+  bool InitFromData(const char* data, size_t size);
+
+  // Init an anonymous in-memory file filled with |data|, which is accessed by
+  // its /proc/self/fd path so nothing is written to disk. The descriptor is
+  // not inherited, so the path must not be passed to other processes. Only
+  // works on Linux kernels with memfd_create.
+  bool InitInMemory(const char* data, size_t size);
+
+  // Use a file named |name| in the extraction cache under the temp directory,
+  // which is keyed by the hash of |data| and shared across launches. The file
+  // is only written when there is no valid cached copy, and it is not deleted
+  // when this object goes away. The cache is trimmed to a fixed size after
+  // each write, dropping the files used least recently.
+  bool InitFromCache(const base::FilePath& name, const char* data, size_t size);
+
   base::FilePath path() const { return path_; }
 
  private:
   base::FilePath path_;
 
+  // Whether |path_| is a real file that should be deleted on destruction.
+  bool should_delete_;
+
+#if defined(OS_LINUX)
+  // The in-memory file created by InitInMemory.
+  base::ScopedFD memory_fd_;
+#endif
+
   DISALLOW_COPY_AND_ASSIGN(ScopedTemporaryFile);
 };
 
@@ -14,7 +14,7 @@
 
 namespace crash_reporter {
 
-CrashReporter::CrashReporter() {
+CrashReporter::CrashReporter() : dump_mode_(DUMP_MODE_NORMAL) {
   auto cmd = base::CommandLine::ForCurrentProcess();
   is_browser_ = cmd->GetSwitchValueASCII(switches::kProcessType).empty();
 }
@@ -64,6 +64,10 @@ CrashReporter::GetUploadedReports(const std::string& path) {
   return result;
 }
 
+bool CrashReporter::WriteMinidump() {
+  return false;
+}
+
 void CrashReporter::InitBreakpad(const std::string& product_name,
                                  const std::string& version,
                                  const std::string& company_name,
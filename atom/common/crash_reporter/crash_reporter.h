@@ -19,6 +19,17 @@ class CrashReporter {
   typedef std::map<std::string, std::string> StringMap;
   typedef std::pair<int, std::string> UploadReportResult;  // upload-date, id
 
+  // How much of the process a minidump holds, only used by Linux.
+  enum DumpMode {
+    // The stacks of the threads other than the crashed one are cut short.
+    DUMP_MODE_STACKS,
+    // The stacks and the memory near the instruction pointers, limited to
+    // the size the crash server accepts.
+    DUMP_MODE_NORMAL,
+    // The full stacks of all the threads.
+    DUMP_MODE_FULL,
+  };
+
   static CrashReporter* GetInstance();
 
   void Start(const std::string& product_name,
@@ -31,6 +42,13 @@ class CrashReporter {
   virtual std::vector<CrashReporter::UploadReportResult> GetUploadedReports(
       const std::string& path);
 
+  // Must be called before Start.
+  void SetDumpMode(DumpMode mode) { dump_mode_ = mode; }
+
+  // Writes a minidump of the process without crashing it, returns false when
+  // the crash reporter has not been started.
+  virtual bool WriteMinidump();
+
  protected:
   CrashReporter();
   virtual ~CrashReporter();
@@ -45,6 +63,7 @@ class CrashReporter {
 
   StringMap upload_parameters_;
   bool is_browser_;
+  DumpMode dump_mode_;
 
  private:
   void SetUploadParameters(const StringMap& parameters);
@@ -35,6 +35,22 @@ static const size_t kDistroSize = 128;
 // no limit.
 static const off_t kMaxMinidumpFileSize = 1258291;
 
+// The limit of the stacks-only dumps, breakpad keeps the stack of the crashed
+// thread and cuts the others short to stay in it.
+static const off_t kMaxStacksMinidumpFileSize = 256 * 1024;
+
+off_t GetMinidumpSizeLimit(CrashReporter::DumpMode mode) {
+  switch (mode) {
+    case CrashReporter::DUMP_MODE_STACKS:
+      return kMaxStacksMinidumpFileSize;
+    case CrashReporter::DUMP_MODE_FULL:
+      return -1;
+    case CrashReporter::DUMP_MODE_NORMAL:
+      break;
+  }
+  return kMaxMinidumpFileSize;
+}
+
 }  // namespace
 
 CrashReporterLinux::CrashReporterLinux()
@@ -77,6 +93,10 @@ void CrashReporterLinux::SetUploadParameters() {
   upload_parameters_["platform"] = "linux";
 }
 
+bool CrashReporterLinux::WriteMinidump() {
+  return breakpad_ && breakpad_->WriteMinidump();
+}
+
 void CrashReporterLinux::EnableCrashDumping(const std::string& product_name) {
   std::string dump_dir = "/tmp/" + product_name + " Crashes";
   base::FilePath dumps_path(dump_dir);
@@ -87,7 +107,7 @@ void CrashReporterLinux::EnableCrashDumping(const std::string& product_name) {
   strncpy(g_crash_log_path, log_file.c_str(), sizeof(g_crash_log_path));
 
   MinidumpDescriptor minidump_descriptor(dumps_path.value());
-  minidump_descriptor.set_size_limit(kMaxMinidumpFileSize);
+  minidump_descriptor.set_size_limit(GetMinidumpSizeLimit(dump_mode_));
 
   breakpad_.reset(new ExceptionHandler(
       minidump_descriptor,
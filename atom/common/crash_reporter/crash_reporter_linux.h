@@ -32,6 +32,7 @@ class CrashReporterLinux : public CrashReporter {
                     bool auto_submit,
                     bool skip_system_crash_handler) override;
   void SetUploadParameters() override;
+  bool WriteMinidump() override;
 
  private:
   friend struct DefaultSingletonTraits<CrashReporterLinux>;
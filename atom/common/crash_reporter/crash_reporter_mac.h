@@ -42,6 +42,7 @@ class CrashReporterMac : public CrashReporter {
 
   std::vector<UploadReportResult> GetUploadedReports(
       const std::string& path) override;
+  bool WriteMinidump() override;
 
   scoped_ptr<crashpad::SimpleStringDictionary> simple_string_dictionary_;
 
@@ -16,6 +16,7 @@
 #include "vendor/crashpad/client/crashpad_client.h"
 #include "vendor/crashpad/client/crashpad_info.h"
 #include "vendor/crashpad/client/settings.h"
+#include "vendor/crashpad/client/simulate_crash.h"
 
 namespace crash_reporter {
 
@@ -89,6 +90,13 @@ void CrashReporterMac::SetCrashKeyValue(const base::StringPiece& key,
   simple_string_dictionary_->SetKeyValue(key.data(), value.data());
 }
 
+bool CrashReporterMac::WriteMinidump() {
+  if (!simple_string_dictionary_)
+    return false;
+  CRASHPAD_SIMULATE_CRASH();
+  return true;
+}
+
 std::vector<CrashReporter::UploadReportResult>
 CrashReporterMac::GetUploadedReports(const std::string& path) {
   std::vector<CrashReporter::UploadReportResult> uploaded_reports;
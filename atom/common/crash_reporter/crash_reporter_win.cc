@@ -202,6 +202,10 @@ void CrashReporterWin::SetUploadParameters() {
   upload_parameters_["platform"] = "win32";
 }
 
+bool CrashReporterWin::WriteMinidump() {
+  return breakpad_ && breakpad_->WriteMinidump();
+}
+
 int CrashReporterWin::CrashForException(EXCEPTION_POINTERS* info) {
   if (breakpad_) {
     breakpad_->WriteMinidumpForException(info);
@@ -28,6 +28,7 @@ class CrashReporterWin : public CrashReporter {
                     bool auto_submit,
                     bool skip_system_crash_handler) override;
   void SetUploadParameters() override;
+  bool WriteMinidump() override;
 
   // Crashes the process after generating a dump for the provided exception.
   int CrashForException(EXCEPTION_POINTERS* info);
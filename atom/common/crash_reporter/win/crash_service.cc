@@ -6,15 +6,22 @@
 
 #include <windows.h>
 
+#include <psapi.h>
 #include <sddl.h>
+#include <algorithm>
 #include <fstream>  // NOLINT
 #include <map>
+#include <utility>
+#include <vector>
 
 #include "base/command_line.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
 #include "base/logging.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversions.h"
 #include "base/time/time.h"
 #include "base/win/windows_version.h"
 #include "vendor/breakpad/src/client/windows/crash_generation/client_info.h"
@@ -32,6 +39,20 @@ const wchar_t kTestPipeName[] = L"\\\\.\\pipe\\ChromeCrashServices";
 
 const wchar_t kGoogleReportURL[] = L"https://clients2.google.com/cr/report";
 const wchar_t kCheckPointFile[] = L"crash_checkpoint.txt";
+const wchar_t kSignaturesFile[] = L"crash_signatures.txt";
+
+// Uploads wait this long after the service starts, and between two dumps.
+const int kStartupDelaySeconds = 30;
+const DWORD kUploadIntervalMs = 10 * 1000;
+
+// The most dumps waiting to be sent, the oldest are dropped beyond it.
+const size_t kMaxPendingDumps = 5;
+
+// A crash of the same signature is sent again after a day.
+const int64 kSignatureLifetimeSeconds = 24 * 60 * 60;
+
+// The most disk space used by the dumps in a directory.
+const int64 kMaxDumpsDiskUsage = 100 * 1024 * 1024;
 
 typedef std::map<std::wstring, std::wstring> CrashMap;
 
@@ -72,6 +93,28 @@ bool WriteCustomInfoToFile(const std::wstring& dump_path, const CrashMap& map) {
   return true;
 }
 
+// Reads back the custom info written by WriteCustomInfoToFile.
+bool ReadCustomInfoFromFile(const std::wstring& dump_path, CrashMap* map) {
+  std::wstring file_path(dump_path);
+  size_t last_dot = file_path.rfind(L'.');
+  if (last_dot == std::wstring::npos)
+    return false;
+  file_path.resize(last_dot);
+  file_path += L".txt";
+
+  std::wifstream file(file_path.c_str(), std::ios_base::in | std::ios::binary);
+  if (!file.is_open())
+    return false;
+
+  std::wstring line;
+  while (std::getline(file, line)) {
+    size_t colon = line.find(L':');
+    if (colon != std::wstring::npos)
+      (*map)[line.substr(0, colon)] = line.substr(colon + 1);
+  }
+  return !map->empty();
+}
+
 bool WriteReportIDToFile(const std::wstring& dump_path,
                          const std::wstring& report_id) {
   std::wstring file_path(dump_path);
@@ -96,6 +139,88 @@ bool WriteReportIDToFile(const std::wstring& dump_path,
   return true;
 }
 
+int64 SecondsSinceEpoch() {
+  return (base::Time::Now() - base::Time::UnixEpoch()).InSeconds();
+}
+
+// Identifies a crash by the product, the process type, the version, the
+// exception code and the module and offset the exception happened at, which
+// stay the same across launches of the same build. Returns an empty string
+// when the exception can not be read from the client.
+std::wstring GetCrashSignature(const google_breakpad::ClientInfo* client_info,
+                               const CrashMap& map) {
+  HANDLE process = client_info->process_handle();
+  EXCEPTION_POINTERS* client_pointers = NULL;
+  EXCEPTION_POINTERS pointers;
+  EXCEPTION_RECORD record;
+  SIZE_T read = 0;
+  if (!client_info->GetClientExceptionInfo(&client_pointers) ||
+      !client_pointers ||
+      !::ReadProcessMemory(process, client_pointers, &pointers,
+                           sizeof(pointers), &read) ||
+      !::ReadProcessMemory(process, pointers.ExceptionRecord, &record,
+                           sizeof(record), &read))
+    return std::wstring();
+
+  uintptr_t address = reinterpret_cast<uintptr_t>(record.ExceptionAddress);
+  std::wstring module_name = L"?";
+  HMODULE modules[1024];
+  DWORD needed = 0;
+  if (::EnumProcessModules(process, modules, sizeof(modules), &needed)) {
+    size_t count = std::min<size_t>(needed / sizeof(HMODULE),
+                                    arraysize(modules));
+    for (size_t i = 0; i < count; ++i) {
+      MODULEINFO info;
+      if (!::GetModuleInformation(process, modules[i], &info, sizeof(info)))
+        continue;
+      uintptr_t base = reinterpret_cast<uintptr_t>(info.lpBaseOfDll);
+      if (address < base || address >= base + info.SizeOfImage)
+        continue;
+      wchar_t name[MAX_PATH];
+      if (::GetModuleBaseNameW(process, modules[i], name, MAX_PATH))
+        module_name = name;
+      address -= base;
+      break;
+    }
+  }
+
+  std::wstring signature;
+  const wchar_t* keys[] = { L"prod", L"process_type", L"ver" };
+  for (const wchar_t* key : keys) {
+    CrashMap::const_iterator it = map.find(key);
+    if (it != map.end())
+      signature += it->second + L"/";
+  }
+  signature += base::UintToString16(record.ExceptionCode);
+  signature += L"/" + module_name + L"+" +
+      base::Uint64ToString16(static_cast<uint64>(address));
+  return signature;
+}
+
+// Deletes the oldest dumps in |dir| that do not fit in the quota.
+void EnforceDiskQuota(const base::FilePath& dir) {
+  std::vector<std::pair<base::Time, base::FilePath>> dumps;
+  base::FileEnumerator enumerator(dir, false, base::FileEnumerator::FILES,
+                                  L"*.dmp");
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    dumps.push_back(std::make_pair(
+        enumerator.GetInfo().GetLastModifiedTime(), path));
+  }
+  std::sort(dumps.rbegin(), dumps.rend());
+
+  int64 total_size = 0;
+  for (const auto& dump : dumps) {
+    int64 size = 0;
+    base::GetFileSize(dump.second, &size);
+    total_size += size;
+    if (total_size > kMaxDumpsDiskUsage) {
+      base::DeleteFile(dump.second, false);
+      base::DeleteFile(dump.second.ReplaceExtension(L"txt"), false);
+    }
+  }
+}
+
 // The window procedure task is to handle when a) the user logs off.
 // b) the system shuts down or c) when the user closes the window.
 LRESULT __stdcall CrashSvcWndProc(HWND hwnd, UINT message,
@@ -163,6 +288,8 @@ class ProcessingLock {
 
 volatile LONG ProcessingLock::op_count_ = 0;
 
+}  // namespace
+
 // This structure contains the information that the worker thread needs to
 // send a crash dump to the server.
 struct DumpJobInfo {
@@ -170,15 +297,17 @@ struct DumpJobInfo {
   CrashService* self;
   CrashMap map;
   std::wstring dump_path;
+  // Empty when the crash can not be told apart from others.
+  std::wstring signature;
 
   DumpJobInfo(DWORD process_id, CrashService* service,
-              const CrashMap& crash_map, const std::wstring& path)
-      : pid(process_id), self(service), map(crash_map), dump_path(path) {
+              const CrashMap& crash_map, const std::wstring& path,
+              const std::wstring& crash_signature)
+      : pid(process_id), self(service), map(crash_map), dump_path(path),
+        signature(crash_signature) {
   }
 };
 
-}  // namespace
-
 // Command line switches:
 const char CrashService::kMaxReports[]        = "max-reports";
 const char CrashService::kNoWindow[]          = "no-window";
@@ -193,13 +322,19 @@ CrashService::CrashService()
       requests_handled_(0),
       requests_sent_(0),
       clients_connected_(0),
-      clients_terminated_(0) {
+      clients_terminated_(0),
+      start_time_(base::Time::Now()),
+      sender_running_(false) {
 }
 
 CrashService::~CrashService() {
   base::AutoLock lock(sending_);
   delete dumper_;
   delete sender_;
+  // The dumps that were not sent stay on disk.
+  base::AutoLock queue_lock(queue_lock_);
+  for (DumpJobInfo* dump_job : pending_dumps_)
+    delete dump_job;
 }
 
 bool CrashService::Initialize(const base::string16& application_name,
@@ -236,6 +371,9 @@ bool CrashService::Initialize(const base::string16& application_name,
     // Create the http sender object.
     sender_ = new CrashReportSender(checkpoint_path.value());
     sender_->set_max_reports_per_day(max_reports);
+
+    signatures_path_ = operating_dir.Append(kSignaturesFile);
+    LoadSignatures();
   }
 
   SECURITY_ATTRIBUTES security_attributes = {0};
@@ -307,6 +445,10 @@ bool CrashService::Initialize(const base::string16& application_name,
   if (security_attributes.lpSecurityDescriptor)
     LocalFree(security_attributes.lpSecurityDescriptor);
 
+  // The dumps of a service that exited before sending them are still there.
+  if (sender_)
+    QueueLeftoverDumps(dumps_path_to_use);
+
   // Create or open an event to signal the browser process that the crash
   // service is initialized.
   base::string16 wait_name = ReplaceStringPlaceholders(
@@ -397,27 +539,162 @@ void CrashService::OnClientDumpRequest(void* context,
     LOG(ERROR) << "could not write custom info file";
   }
 
+  EnforceDiskQuota(dump_location.DirName());
+
   if (!self->sender_)
     return;
 
   // Send the crash dump using a worker thread. This operation has retry
   // logic in case there is no internet connection at the time.
-  DumpJobInfo* dump_job = new DumpJobInfo(pid, self, map,
-                                          dump_location.value());
-  if (!::QueueUserWorkItem(&CrashService::AsyncSendDump,
-                           dump_job, WT_EXECUTELONGFUNCTION)) {
+  self->EnqueueDump(new DumpJobInfo(pid, self, map, dump_location.value(),
+                                    GetCrashSignature(client_info, map)));
+}
+
+void CrashService::QueueLeftoverDumps(const base::FilePath& dumps_dir) {
+  std::vector<std::pair<base::Time, base::FilePath>> dumps;
+  base::FileEnumerator enumerator(dumps_dir, false,
+                                  base::FileEnumerator::FILES, L"*.dmp");
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    dumps.push_back(std::make_pair(
+        enumerator.GetInfo().GetLastModifiedTime(), path));
+  }
+  // Oldest first, so the queue drops the oldest ones when it is full.
+  std::sort(dumps.begin(), dumps.end());
+
+  for (const auto& dump : dumps) {
+    CrashMap map;
+    if (!ReadCustomInfoFromFile(dump.second.value(), &map))
+      map[L"rept"] = reporter_tag_;
+    VLOG(1) << "found unsent dump " << dump.second.value();
+    EnqueueDump(new DumpJobInfo(0, this, map, dump.second.value(),
+                                std::wstring()));
+  }
+}
+
+bool CrashService::IsRecentCrash(const std::wstring& signature) {
+  queue_lock_.AssertAcquired();
+  if (signature.empty())
+    return false;
+
+  auto it = signatures_.find(signature);
+  if (it != signatures_.end() &&
+      SecondsSinceEpoch() - it->second < kSignatureLifetimeSeconds)
+    return true;
+
+  for (const DumpJobInfo* dump_job : pending_dumps_)
+    if (dump_job->signature == signature)
+      return true;
+  return false;
+}
+
+void CrashService::RecordSentCrash(const std::wstring& signature) {
+  if (signature.empty())
+    return;
+  base::AutoLock lock(queue_lock_);
+  signatures_[signature] = SecondsSinceEpoch();
+  SaveSignatures();
+}
+
+void CrashService::EnqueueDump(DumpJobInfo* dump_job) {
+  base::AutoLock lock(queue_lock_);
+  if (IsRecentCrash(dump_job->signature)) {
+    VLOG(1) << "dropping dump of a recent crash " << dump_job->signature;
+    ::DeleteFileW(dump_job->dump_path.c_str());
+    delete dump_job;
+    return;
+  }
+
+  pending_dumps_.push_back(dump_job);
+  if (pending_dumps_.size() > kMaxPendingDumps) {
+    DumpJobInfo* oldest = pending_dumps_.front();
+    pending_dumps_.pop_front();
+    VLOG(1) << "dropping dump " << oldest->dump_path;
+    ::DeleteFileW(oldest->dump_path.c_str());
+    delete oldest;
+  }
+
+  if (sender_running_)
+    return;
+  sender_running_ = true;
+  if (!::QueueUserWorkItem(&CrashService::AsyncSendDumps,
+                           this, WT_EXECUTELONGFUNCTION)) {
     LOG(ERROR) << "could not queue job";
+    sender_running_ = false;
   }
 }
 
-// We are going to try sending the report several times. If we can't send,
-// we sleep from one minute to several hours depending on the retry round.
-DWORD CrashService::AsyncSendDump(void* context) {
-  if (!context)
-    return 0;
+DWORD CrashService::AsyncSendDumps(void* context) {
+  CrashService* self = static_cast<CrashService*>(context);
 
-  DumpJobInfo* info = static_cast<DumpJobInfo*>(context);
+  {
+    // Hold the sending lock while waiting, so OnClientExited does not end
+    // the service before the queued dumps are sent.
+    base::AutoLock lock(self->sending_);
+    base::TimeDelta since_start = base::Time::Now() - self->start_time_;
+    base::TimeDelta startup_delay =
+        base::TimeDelta::FromSeconds(kStartupDelaySeconds);
+    if (since_start < startup_delay) {
+      ::Sleep(static_cast<DWORD>(
+          (startup_delay - since_start).InMilliseconds()));
+    }
+  }
+
+  while (true) {
+    DumpJobInfo* info;
+    {
+      base::AutoLock lock(self->queue_lock_);
+      if (self->pending_dumps_.empty()) {
+        self->sender_running_ = false;
+        return 0;
+      }
+      info = self->pending_dumps_.front();
+      self->pending_dumps_.pop_front();
+    }
+    SendDump(info);
+    // The service is kept alive between two dumps too.
+    base::AutoLock lock(self->sending_);
+    ::Sleep(kUploadIntervalMs);
+  }
+}
+
+void CrashService::LoadSignatures() {
+  std::string content;
+  if (!base::ReadFileToString(signatures_path_, &content))
+    return;
+  int64 now = SecondsSinceEpoch();
+  std::vector<std::string> lines;
+  base::SplitString(content, '\n', &lines);
+  for (const std::string& line : lines) {
+    size_t comma = line.find(',');
+    int64 time = 0;
+    if (comma == std::string::npos ||
+        !base::StringToInt64(line.substr(0, comma), &time) ||
+        now - time >= kSignatureLifetimeSeconds)
+      continue;
+    signatures_[base::UTF8ToWide(line.substr(comma + 1))] = time;
+  }
+}
+
+void CrashService::SaveSignatures() {
+  int64 now = SecondsSinceEpoch();
+  std::string content;
+  for (auto it = signatures_.begin(); it != signatures_.end();) {
+    if (now - it->second >= kSignatureLifetimeSeconds) {
+      signatures_.erase(it++);
+      continue;
+    }
+    content += base::Int64ToString(it->second) + "," +
+               base::WideToUTF8(it->first) + "\n";
+    ++it;
+  }
+  base::WriteFile(signatures_path_, content.data(),
+                  static_cast<int>(content.size()));
+}
 
+// We are going to try sending the report several times. If we can't send,
+// we sleep from one minute to several hours depending on the retry round.
+void CrashService::SendDump(DumpJobInfo* info) {
   std::wstring report_id = L"<unsent>";
 
   const DWORD kOneMinute = 60*1000;
@@ -459,6 +736,7 @@ DWORD CrashService::AsyncSendDump(void* context) {
           ++info->self->requests_handled_;
           retry_round = 0;
           WriteReportIDToFile(info->dump_path, report_id);
+          info->self->RecordSentCrash(info->signature);
           break;
         case google_breakpad::RESULT_THROTTLED:
           report_id = L"<throttled>";
@@ -477,7 +755,6 @@ DWORD CrashService::AsyncSendDump(void* context) {
     LOG(WARNING) << "could not delete " << info->dump_path;
 
   delete info;
-  return 0;
 }
 
 int CrashService::ProcessingLoop() {
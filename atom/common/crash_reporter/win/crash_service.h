@@ -5,11 +5,14 @@
 #ifndef ATOM_COMMON_CRASH_REPORTER_WIN_CRASH_SERVICE_H_
 #define ATOM_COMMON_CRASH_REPORTER_WIN_CRASH_SERVICE_H_
 
+#include <deque>
+#include <map>
 #include <string>
 
 #include "base/basictypes.h"
 #include "base/files/file_path.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
 
 namespace google_breakpad {
 
@@ -21,6 +24,8 @@ class ClientInfo;
 
 namespace breakpad {
 
+struct DumpJobInfo;
+
 // This class implements an out-of-process crash server. It uses breakpad's
 // CrashGenerationServer and CrashReportSender to generate and then send the
 // crash dumps. Internally, it uses OS specific pipe to allow applications to
@@ -28,6 +33,12 @@ namespace breakpad {
 // it will signal an event that causes this code to wake up and perform a
 // crash dump on the signaling process. The dump is then stored on disk and
 // possibly sent to the crash2 servers.
+//
+// The dumps are sent one at a time from a queue of at most a few of them,
+// starting a while after the service starts and waiting between two of them,
+// so a crash loop does not compete with the startup of the app. A crash is
+// only sent once a day, crashes are told apart by where they happened. The
+// dumps left on disk are kept under a size quota.
 class CrashService {
  public:
   CrashService();
@@ -99,9 +110,32 @@ class CrashService {
   static void OnClientExited(void* context,
                              const google_breakpad::ClientInfo* client_info);
 
+  // Queues the dump unless a crash of the same signature has been sent
+  // recently or is already queued.
+  void EnqueueDump(DumpJobInfo* dump_job);
+
+  // Queues the dumps in |dumps_dir| that were not sent before the service
+  // exited last time.
+  void QueueLeftoverDumps(const base::FilePath& dumps_dir);
+
+  // Whether a crash of |signature| has been sent recently or is queued, must
+  // be called with |queue_lock_| held.
+  bool IsRecentCrash(const std::wstring& signature);
+
+  // Remembers |signature| after its dump has been sent.
+  void RecordSentCrash(const std::wstring& signature);
+
+  // Sends the queued crash dumps to the server one after another.
+  static DWORD __stdcall AsyncSendDumps(void* context);
+
   // This routine sends the crash dump to the server. It takes the sending_
   // lock when it is performing the send.
-  static DWORD __stdcall AsyncSendDump(void* context);
+  static void SendDump(DumpJobInfo* info);
+
+  // Reads and writes the signatures of the crashes sent recently, they are
+  // kept in a file since the service exits with its last client.
+  void LoadSignatures();
+  void SaveSignatures();
 
   // Returns the security descriptor which access to low integrity processes
   // The caller is supposed to free the security descriptor by calling
@@ -124,6 +158,17 @@ class CrashService {
   volatile LONG clients_terminated_;
   base::Lock sending_;
 
+  base::Time start_time_;
+
+  // Protects the queue and the signatures.
+  base::Lock queue_lock_;
+  std::deque<DumpJobInfo*> pending_dumps_;
+  bool sender_running_;
+  base::FilePath signatures_path_;
+  // The signatures of crashes and when they were sent, in seconds since the
+  // epoch.
+  std::map<std::wstring, int64> signatures_;
+
   DISALLOW_COPY_AND_ASSIGN(CrashService);
 };
 
@@ -0,0 +1,120 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/event_loop_stats.h"
+
+#include <algorithm>
+
+#include "base/lazy_instance.h"
+#include "base/values.h"
+
+namespace atom {
+
+namespace {
+
+// Enough buckets for samples up to 2^31, i.e. half an hour in microseconds.
+const size_t kBucketCount = 32;
+
+base::LazyInstance<EventLoopStats> g_event_loop_stats =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+EventLoopStats::Histogram::Histogram()
+    : buckets_(kBucketCount, 0), count_(0), sum_(0), max_(0) {
+}
+
+EventLoopStats::Histogram::~Histogram() {
+}
+
+void EventLoopStats::Histogram::Add(int64 sample) {
+  sample = std::max<int64>(sample, 0);
+  size_t bucket = 0;
+  while (bucket < kBucketCount - 1 && (sample >> bucket) > 0)
+    ++bucket;
+  ++buckets_[bucket];
+  ++count_;
+  sum_ += sample;
+  max_ = std::max(max_, sample);
+}
+
+void EventLoopStats::Histogram::Reset() {
+  std::fill(buckets_.begin(), buckets_.end(), 0);
+  count_ = sum_ = max_ = 0;
+}
+
+int64 EventLoopStats::Histogram::Percentile(int percent) const {
+  int64 target = (count_ * percent + 99) / 100;
+  int64 seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i];
+    if (seen >= target)
+      return std::min<int64>(max_, (static_cast<int64>(1) << i) - 1);
+  }
+  return max_;
+}
+
+scoped_ptr<base::DictionaryValue> EventLoopStats::Histogram::ToValue(
+    double scale) const {
+  scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue);
+  value->SetDouble("count", static_cast<double>(count_));
+  value->SetDouble("mean", count_ > 0 ? sum_ * scale / count_ : 0);
+  value->SetDouble("max", max_ * scale);
+  value->SetDouble("p50", Percentile(50) * scale);
+  value->SetDouble("p90", Percentile(90) * scale);
+  value->SetDouble("p99", Percentile(99) * scale);
+  return value.Pass();
+}
+
+// static
+EventLoopStats* EventLoopStats::GetInstance() {
+  return g_event_loop_stats.Pointer();
+}
+
+EventLoopStats::EventLoopStats() : pre_loop_task_count_(0) {
+}
+
+EventLoopStats::~EventLoopStats() {
+}
+
+void EventLoopStats::RecordWakeupLatency(base::TimeDelta latency) {
+  wakeup_latency_.Add(latency.InMicroseconds());
+}
+
+void EventLoopStats::RecordSlice(base::TimeDelta duration, int runs) {
+  slice_duration_.Add(duration.InMicroseconds());
+  runs_per_slice_.Add(runs);
+  total_slice_time_ += duration;
+}
+
+void EventLoopStats::RecordPreLoopTasks(size_t count,
+                                        base::TimeDelta max_wait_time) {
+  pre_loop_task_count_ = count;
+  pre_loop_max_wait_time_ = max_wait_time;
+}
+
+scoped_ptr<base::DictionaryValue> EventLoopStats::ToValue() const {
+  const double kMicrosecondsToMilliseconds = 1.0 / 1000;
+  scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue);
+  value->Set("wakeupLatency",
+             wakeup_latency_.ToValue(kMicrosecondsToMilliseconds).release());
+  value->Set("sliceDuration",
+             slice_duration_.ToValue(kMicrosecondsToMilliseconds).release());
+  value->Set("runsPerSlice", runs_per_slice_.ToValue(1).release());
+
+  scoped_ptr<base::DictionaryValue> pre_loop_tasks(new base::DictionaryValue);
+  pre_loop_tasks->SetDouble("count", static_cast<double>(pre_loop_task_count_));
+  pre_loop_tasks->SetDouble("maxWaitTime",
+                            pre_loop_max_wait_time_.InMillisecondsF());
+  value->Set("preLoopTasks", pre_loop_tasks.release());
+  return value.Pass();
+}
+
+void EventLoopStats::Reset() {
+  wakeup_latency_.Reset();
+  slice_duration_.Reset();
+  runs_per_slice_.Reset();
+}
+
+}  // namespace atom
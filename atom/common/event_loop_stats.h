@@ -0,0 +1,93 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_EVENT_LOOP_STATS_H_
+#define ATOM_COMMON_EVENT_LOOP_STATS_H_
+
+#include <vector>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace atom {
+
+// Statistics of how the uv loop runs in the main thread's message loop. All
+// methods must be called on the main thread.
+class EventLoopStats {
+ public:
+  // Returns the stats of current process.
+  static EventLoopStats* GetInstance();
+
+  EventLoopStats();
+  ~EventLoopStats();
+
+  // Records the time between uv having events and the main thread starting
+  // to deal with them.
+  void RecordWakeupLatency(base::TimeDelta latency);
+
+  // Records a slice of UvRunOnce, which ran the uv loop |runs| times.
+  void RecordSlice(base::TimeDelta duration, int runs);
+
+  // The total time spent in UvRunOnce since the process started, it is not
+  // cleared by Reset.
+  base::TimeDelta total_slice_time() const { return total_slice_time_; }
+
+  // Records the tasks posted in browser process before its message loop was
+  // ready, and the longest time one of them had waited.
+  void RecordPreLoopTasks(size_t count, base::TimeDelta max_wait_time);
+
+  // Returns the histograms as a dictionary, the times are in milliseconds.
+  scoped_ptr<base::DictionaryValue> ToValue() const;
+
+  // Clears all recorded samples, the pre-loop tasks are kept since they only
+  // happen once.
+  void Reset();
+
+ private:
+  // A histogram with exponential buckets, bucket i counts the samples in
+  // [2^(i-1), 2^i).
+  class Histogram {
+   public:
+    Histogram();
+    ~Histogram();
+
+    void Add(int64 sample);
+    void Reset();
+
+    // Returns the count, mean, max and percentiles of samples, each multiplied
+    // by |scale|.
+    scoped_ptr<base::DictionaryValue> ToValue(double scale) const;
+
+   private:
+    // Returns the upper bound of the bucket holding the |percent|th
+    // percentile.
+    int64 Percentile(int percent) const;
+
+    std::vector<int64> buckets_;
+    int64 count_;
+    int64 sum_;
+    int64 max_;
+  };
+
+  // In microseconds.
+  Histogram wakeup_latency_;
+  Histogram slice_duration_;
+
+  Histogram runs_per_slice_;
+
+  base::TimeDelta total_slice_time_;
+
+  size_t pre_loop_task_count_;
+  base::TimeDelta pre_loop_max_wait_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(EventLoopStats);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_EVENT_LOOP_STATS_H_
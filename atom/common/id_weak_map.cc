@@ -4,85 +4,130 @@
 
 #include "atom/common/id_weak_map.h"
 
-#include <utility>
-
-#include "native_mate/converter.h"
+#include "base/logging.h"
 
 namespace atom {
 
 namespace {
 
-struct ObjectKey {
-  ObjectKey(int id, IDWeakMap* map) : id(id), map(map) {}
-  int id;
-  IDWeakMap* map;
-};
+// The low bits of an ID are the slot index plus one, so IDs start from 1 and
+// 0 is never a valid ID, the high bits are the generation of the slot.
+const int kIndexBits = 20;
+const int32_t kMaxSlots = (1 << kIndexBits) - 1;
+const int32_t kIndexMask = (1 << kIndexBits) - 1;
 
-void OnObjectGC(const v8::WeakCallbackInfo<ObjectKey>& data) {
-  ObjectKey* key = data.GetParameter();
-  key->map->Remove(key->id);
-  delete key;
-}
+// A slot is retired instead of being reused once it reaches this generation,
+// so IDs are never repeated and are always positive.
+const int32_t kMaxGeneration = (1 << (31 - kIndexBits)) - 1;
 
 }  // namespace
 
-IDWeakMap::IDWeakMap() : next_id_(0) {
+IDWeakMap::Slot::Slot(IDWeakMap* map, int32_t index)
+    : map(map), index(index), generation(0) {
+}
+
+IDWeakMap::Slot::~Slot() {
+}
+
+int32_t IDWeakMap::Slot::id() const {
+  return (generation << kIndexBits) | (index + 1);
+}
+
+IDWeakMap::IDWeakMap() : size_(0) {
 }
 
 IDWeakMap::~IDWeakMap() {
 }
 
 int32_t IDWeakMap::Add(v8::Isolate* isolate, v8::Local<v8::Object> object) {
-  int32_t id = GetNextID();
-  auto global = make_linked_ptr(new v8::Global<v8::Object>(isolate, object));
-  ObjectKey* key = new ObjectKey(id, this);
-  global->SetWeak(key, OnObjectGC, v8::WeakCallbackType::kParameter);
-  map_[id] = global;
-  return id;
+  Slot* slot;
+  if (!free_slots_.empty()) {
+    slot = &slots_[free_slots_.back()];
+    free_slots_.pop_back();
+  } else {
+    CHECK_LT(slots_.size(), static_cast<size_t>(kMaxSlots));
+    slots_.emplace_back(this, static_cast<int32_t>(slots_.size()));
+    slot = &slots_.back();
+  }
+
+  slot->object.Reset(isolate, object);
+  slot->object.SetWeak(slot, OnObjectGC, v8::WeakCallbackType::kParameter);
+  ++size_;
+  return slot->id();
 }
 
 v8::MaybeLocal<v8::Object> IDWeakMap::Get(v8::Isolate* isolate, int32_t id) {
-  auto iter = map_.find(id);
-  if (iter == map_.end())
+  Slot* slot = GetSlot(id);
+  if (!slot)
     return v8::MaybeLocal<v8::Object>();
   else
-    return v8::Local<v8::Object>::New(isolate, *iter->second);
+    return v8::Local<v8::Object>::New(isolate, slot->object);
 }
 
 bool IDWeakMap::Has(int32_t id) const {
-  return map_.find(id) != map_.end();
+  return GetSlot(id) != nullptr;
 }
 
 std::vector<int32_t> IDWeakMap::Keys() const {
   std::vector<int32_t> keys;
-  keys.reserve(map_.size());
-  for (const auto& iter : map_)
-    keys.emplace_back(iter.first);
+  keys.reserve(size_);
+  for (const auto& slot : slots_)
+    if (!slot.object.IsEmpty())
+      keys.push_back(slot.id());
   return keys;
 }
 
 std::vector<v8::Local<v8::Object>> IDWeakMap::Values(v8::Isolate* isolate) {
-  std::vector<v8::Local<v8::Object>> keys;
-  keys.reserve(map_.size());
-  for (const auto& iter : map_)
-    keys.emplace_back(v8::Local<v8::Object>::New(isolate, *iter.second));
-  return keys;
+  std::vector<v8::Local<v8::Object>> values;
+  values.reserve(size_);
+  for (const auto& slot : slots_)
+    if (!slot.object.IsEmpty())
+      values.push_back(v8::Local<v8::Object>::New(isolate, slot.object));
+  return values;
 }
 
 void IDWeakMap::Remove(int32_t id) {
-  auto iter = map_.find(id);
-  if (iter == map_.end())
+  Slot* slot = GetSlot(id);
+  if (!slot)
     LOG(WARNING) << "Removing unexist object with ID " << id;
   else
-    map_.erase(iter);
+    Release(slot);
 }
 
 void IDWeakMap::Clear() {
-  map_.clear();
+  for (auto& slot : slots_)
+    if (!slot.object.IsEmpty())
+      Release(&slot);
+}
+
+// static
+void IDWeakMap::OnObjectGC(const v8::WeakCallbackInfo<Slot>& data) {
+  Slot* slot = data.GetParameter();
+  slot->map->Release(slot);
+}
+
+const IDWeakMap::Slot* IDWeakMap::GetSlot(int32_t id) const {
+  int32_t index = (id & kIndexMask) - 1;
+  if (id <= 0 || index < 0 || static_cast<size_t>(index) >= slots_.size())
+    return nullptr;
+  const Slot& slot = slots_[index];
+  if (slot.object.IsEmpty() || slot.id() != id)
+    return nullptr;
+  return &slot;
+}
+
+IDWeakMap::Slot* IDWeakMap::GetSlot(int32_t id) {
+  return const_cast<Slot*>(
+      static_cast<const IDWeakMap*>(this)->GetSlot(id));
 }
 
-int32_t IDWeakMap::GetNextID() {
-  return ++next_id_;
+void IDWeakMap::Release(Slot* slot) {
+  slot->object.Reset();
+  --size_;
+  if (slot->generation < kMaxGeneration) {
+    ++slot->generation;
+    free_slots_.push_back(slot->index);
+  }
 }
 
 }  // namespace atom
@@ -5,15 +5,19 @@
 #ifndef ATOM_COMMON_ID_WEAK_MAP_H_
 #define ATOM_COMMON_ID_WEAK_MAP_H_
 
-#include <unordered_map>
+#include <deque>
 #include <vector>
 
-#include "base/memory/linked_ptr.h"
+#include "base/basictypes.h"
 #include "v8/include/v8.h"
 
 namespace atom {
 
 // Like ES6's WeakMap, but the key is Integer and the value is Weak Pointer.
+//
+// The objects are kept in slots that are reused once their objects are
+// removed. An ID is the index of its slot tagged with the slot's generation,
+// so the ID of a removed object never finds the object that reused its slot.
 class IDWeakMap {
  public:
   IDWeakMap();
@@ -41,14 +45,36 @@ class IDWeakMap {
   void Clear();
 
  private:
-  // Returns next available ID.
-  int32_t GetNextID();
+  struct Slot {
+    Slot(IDWeakMap* map, int32_t index);
+    ~Slot();
 
-  // ID of next stored object.
-  int32_t next_id_;
+    int32_t id() const;
 
-  // Map of stored objects.
-  std::unordered_map<int32_t, linked_ptr<v8::Global<v8::Object>>> map_;
+    IDWeakMap* map;
+    int32_t index;
+    int32_t generation;
+    // Empty when the slot is free.
+    v8::Global<v8::Object> object;
+  };
+
+  static void OnObjectGC(const v8::WeakCallbackInfo<Slot>& data);
+
+  // Returns the slot of |id|, or null when |id| is not in the map.
+  const Slot* GetSlot(int32_t id) const;
+  Slot* GetSlot(int32_t id);
+
+  // Empties |slot| and makes it available to Add.
+  void Release(Slot* slot);
+
+  // A deque keeps the addresses of slots stable, which are the parameters
+  // of the weak callbacks.
+  std::deque<Slot> slots_;
+
+  // The indices of the free slots, the last one is reused first.
+  std::vector<int32_t> free_slots_;
+
+  size_t size_;
 
   DISALLOW_COPY_AND_ASSIGN(IDWeakMap);
 };
@@ -0,0 +1,66 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/image_encoder.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
+#include "base/trace_event/trace_event.h"
+#include "skia/ext/image_operations.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
+
+namespace atom {
+
+ImageEncodeOptions::ImageEncodeOptions()
+    : format(FORMAT_PNG), quality(90), scale(1) {
+}
+
+scoped_refptr<base::RefCountedBytes> EncodeBitmap(
+    const SkBitmap& bitmap, const ImageEncodeOptions& options) {
+  TRACE_EVENT2("electron.image", "EncodeBitmap",
+               "width", bitmap.width(), "height", bitmap.height());
+  if (bitmap.isNull() || options.scale <= 0)
+    return nullptr;
+
+  SkBitmap scaled = bitmap;
+  if (options.scale != 1) {
+    int width = std::max(static_cast<int>(bitmap.width() * options.scale), 1);
+    int height =
+        std::max(static_cast<int>(bitmap.height() * options.scale), 1);
+    scaled = skia::ImageOperations::Resize(
+        bitmap, skia::ImageOperations::RESIZE_GOOD, width, height);
+  }
+
+  scoped_refptr<base::RefCountedBytes> output(new base::RefCountedBytes);
+  bool success = false;
+  if (options.format == ImageEncodeOptions::FORMAT_JPEG) {
+    SkAutoLockPixels lock(scaled);
+    success = gfx::JPEGCodec::Encode(
+        reinterpret_cast<const unsigned char*>(scaled.getPixels()),
+        gfx::JPEGCodec::FORMAT_SkBitmap, scaled.width(), scaled.height(),
+        static_cast<int>(scaled.rowBytes()), options.quality,
+        &output->data());
+  } else {
+    success = gfx::PNGCodec::EncodeBGRASkBitmap(scaled, false,
+                                                &output->data());
+  }
+  return success ? output : nullptr;
+}
+
+void EncodeBitmapAsync(const SkBitmap& bitmap,
+                       const ImageEncodeOptions& options,
+                       const ImageEncodeCallback& callback) {
+  base::PostTaskAndReplyWithResult(
+      base::WorkerPool::GetTaskRunner(true).get(),
+      FROM_HERE,
+      base::Bind(&EncodeBitmap, bitmap, options),
+      callback);
+}
+
+}  // namespace atom
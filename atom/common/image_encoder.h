@@ -0,0 +1,46 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_IMAGE_ENCODER_H_
+#define ATOM_COMMON_IMAGE_ENCODER_H_
+
+#include "base/callback_forward.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+
+class SkBitmap;
+
+namespace atom {
+
+struct ImageEncodeOptions {
+  enum Format {
+    FORMAT_PNG,
+    FORMAT_JPEG,
+  };
+
+  ImageEncodeOptions();
+
+  Format format;
+  // The quality of JPEG images, between 0 and 100.
+  int quality;
+  // The image is resized by |scale| before it is encoded.
+  double scale;
+};
+
+using ImageEncodeCallback =
+    base::Callback<void(scoped_refptr<base::RefCountedBytes>)>;
+
+// Encodes |bitmap|, returns null on failure. It can be called on any thread.
+scoped_refptr<base::RefCountedBytes> EncodeBitmap(
+    const SkBitmap& bitmap, const ImageEncodeOptions& options);
+
+// Encodes |bitmap| on a worker thread, and runs |callback| on the calling
+// thread with the result.
+void EncodeBitmapAsync(const SkBitmap& bitmap,
+                       const ImageEncodeOptions& options,
+                       const ImageEncodeCallback& callback);
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_IMAGE_ENCODER_H_
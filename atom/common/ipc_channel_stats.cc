@@ -0,0 +1,105 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/ipc_channel_stats.h"
+
+#include <algorithm>
+
+#include "base/basictypes.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/values.h"
+#include "native_mate/converter.h"
+
+namespace atom {
+
+namespace {
+
+// The internal channels used by ipc.send, ipc.sendSync, ipc.sendToHost and
+// ipc.invoke, and the index of the argument that has the user's channel.
+const struct {
+  const char* channel;
+  uint32 index;
+} kWrapperChannels[] = {
+  { "ipc-message", 0 },
+  { "ipc-message-sync", 0 },
+  { "ipc-message-host", 0 },
+  { "ipc-invoke", 1 },
+};
+
+}  // namespace
+
+IPCChannelStats::Sample::Sample() : sync(false), bytes(0) {
+}
+
+IPCChannelStats::Counters::Counters() : count(0), sync_count(0), bytes(0) {
+}
+
+// static
+std::string IPCChannelStats::GetChannelName(const base::string16& channel,
+                                            v8::Local<v8::Value> arguments) {
+  std::string name = base::UTF16ToUTF8(channel);
+  if (arguments.IsEmpty() || !arguments->IsArray())
+    return name;
+
+  v8::Local<v8::Array> array = arguments.As<v8::Array>();
+  for (size_t i = 0; i < arraysize(kWrapperChannels); ++i) {
+    if (name != kWrapperChannels[i].channel)
+      continue;
+    std::string user_channel;
+    uint32 index = kWrapperChannels[i].index;
+    if (index < array->Length() &&
+        mate::ConvertFromV8(v8::Isolate::GetCurrent(), array->Get(index),
+                            &user_channel))
+      return user_channel;
+    break;
+  }
+  return name;
+}
+
+IPCChannelStats::IPCChannelStats() {
+}
+
+IPCChannelStats::~IPCChannelStats() {
+}
+
+void IPCChannelStats::Record(const std::string& channel,
+                             const Sample& sample) {
+  Counters& counters = channels_[channel];
+  ++counters.count;
+  if (sample.sync)
+    ++counters.sync_count;
+  counters.bytes += sample.bytes;
+  counters.serialize_time += sample.serialize_time;
+  counters.handler_time += sample.handler_time;
+  counters.max_handler_time = std::max(counters.max_handler_time,
+                                       sample.handler_time);
+  counters.blocking_time += sample.blocking_time;
+}
+
+scoped_ptr<base::DictionaryValue> IPCChannelStats::ToValue() const {
+  scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue);
+  for (const auto& it : channels_) {
+    const Counters& counters = it.second;
+    scoped_ptr<base::DictionaryValue> channel(new base::DictionaryValue);
+    channel->SetDouble("count", static_cast<double>(counters.count));
+    channel->SetDouble("syncCount", static_cast<double>(counters.sync_count));
+    channel->SetDouble("bytes", static_cast<double>(counters.bytes));
+    channel->SetDouble("serializeTime",
+                       counters.serialize_time.InMillisecondsF());
+    channel->SetDouble("handlerTime", counters.handler_time.InMillisecondsF());
+    channel->SetDouble("maxHandlerTime",
+                       counters.max_handler_time.InMillisecondsF());
+    channel->SetDouble("blockingTime",
+                       counters.blocking_time.InMillisecondsF());
+    // Channel names can contain dots.
+    value->SetWithoutPathExpansion(it.first, channel.release());
+  }
+  return value.Pass();
+}
+
+void IPCChannelStats::Reset() {
+  channels_.clear();
+}
+
+}  // namespace atom
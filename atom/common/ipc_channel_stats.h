@@ -0,0 +1,78 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_IPC_CHANNEL_STATS_H_
+#define ATOM_COMMON_IPC_CHANNEL_STATS_H_
+
+#include <map>
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/string16.h"
+#include "base/time/time.h"
+#include "v8/include/v8.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace atom {
+
+// Counters of the ipc messages of each channel, they are kept by each
+// WebContents in the browser and once per renderer process. All methods must
+// be called on the main thread.
+class IPCChannelStats {
+ public:
+  // What is recorded for one message, the times that were not measured stay
+  // zero.
+  struct Sample {
+    Sample();
+
+    bool sync;
+    size_t bytes;
+    // Time spent serializing or deserializing the arguments.
+    base::TimeDelta serialize_time;
+    // Time spent in the JavaScript handlers of the message.
+    base::TimeDelta handler_time;
+    // Time the sender was blocked waiting for the reply of a sync message.
+    base::TimeDelta blocking_time;
+  };
+
+  // Returns the user's channel of a message sent on |channel|, for the
+  // internal channels that carry it as the first argument.
+  static std::string GetChannelName(const base::string16& channel,
+                                    v8::Local<v8::Value> arguments);
+
+  IPCChannelStats();
+  ~IPCChannelStats();
+
+  void Record(const std::string& channel, const Sample& sample);
+
+  // Returns the counters keyed by channel, the times are totals in
+  // milliseconds.
+  scoped_ptr<base::DictionaryValue> ToValue() const;
+
+  void Reset();
+
+ private:
+  struct Counters {
+    Counters();
+
+    int64 count;
+    int64 sync_count;
+    int64 bytes;
+    base::TimeDelta serialize_time;
+    base::TimeDelta handler_time;
+    base::TimeDelta max_handler_time;
+    base::TimeDelta blocking_time;
+  };
+
+  std::map<std::string, Counters> channels_;
+
+  DISALLOW_COPY_AND_ASSIGN(IPCChannelStats);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_IPC_CHANNEL_STATS_H_
@@ -10,67 +10,74 @@ namespace internal {
 
 namespace {
 
+// The state of a function created by CreateFunctionFromTranslater, it lives
+// as long as the JavaScript object that carries it.
 struct TranslaterHolder {
+  TranslaterHolder() : called(false) {}
+
   Translater translater;
+  bool called;
+  v8::Global<v8::Object> handle;
 };
 
-// Cached JavaScript version of |CallTranslater|.
-v8::Persistent<v8::FunctionTemplate> g_call_translater;
+// Cached template of the objects that carry a TranslaterHolder in their
+// internal field.
+v8::Persistent<v8::ObjectTemplate> g_holder_template;
+
+void DeleteHolder(const v8::WeakCallbackInfo<TranslaterHolder>& data) {
+  delete data.GetParameter();
+}
+
+void ResetHolder(const v8::WeakCallbackInfo<TranslaterHolder>& data) {
+  // The bound state may hold V8 handles, so it is only freed in the second
+  // pass.
+  data.GetParameter()->handle.Reset();
+  data.SetSecondPassCallback(&DeleteHolder);
+}
 
-void CallTranslater(v8::Local<v8::External> external,
-                    v8::Local<v8::Object> state,
-                    mate::Arguments* args) {
-  v8::Isolate* isolate = args->isolate();
+void CallTranslater(const v8::FunctionCallbackInfo<v8::Value>& info) {
+  mate::Arguments args(info);
+  v8::Local<v8::Object> state = v8::Local<v8::Object>::Cast(info.Data());
+  TranslaterHolder* holder = static_cast<TranslaterHolder*>(
+      state->GetAlignedPointerFromInternalField(0));
 
   // Check if the callback has already been called.
-  v8::Local<v8::String> called_symbol = mate::StringToSymbol(isolate, "called");
-  if (state->Has(called_symbol)) {
-    args->ThrowError("callback can only be called for once");
+  if (holder->called) {
+    args.ThrowError("callback can only be called for once");
     return;
-  } else {
-    state->Set(called_symbol, v8::Boolean::New(isolate, true));
   }
+  holder->called = true;
 
-  TranslaterHolder* holder = static_cast<TranslaterHolder*>(external->Value());
-  holder->translater.Run(args);
-  delete holder;
-}
-
-// func.bind(func, arg1).
-// NB(zcbenz): Using C++11 version crashes VS.
-v8::Local<v8::Value> BindFunctionWith(v8::Isolate* isolate,
-                                      v8::Local<v8::Context> context,
-                                      v8::Local<v8::Function> func,
-                                      v8::Local<v8::Value> arg1,
-                                      v8::Local<v8::Value> arg2) {
-  v8::MaybeLocal<v8::Value> bind = func->Get(mate::StringToV8(isolate, "bind"));
-  CHECK(!bind.IsEmpty());
-  v8::Local<v8::Function> bind_func =
-      v8::Local<v8::Function>::Cast(bind.ToLocalChecked());
-  v8::Local<v8::Value> converted[] = { func, arg1, arg2 };
-  return bind_func->Call(
-      context, func, arraysize(converted), converted).ToLocalChecked();
+  // Release what the translater bound as soon as it has run.
+  Translater translater = holder->translater;
+  holder->translater.Reset();
+  translater.Run(&args);
 }
 
 }  // namespace
 
 v8::Local<v8::Value> CreateFunctionFromTranslater(
     v8::Isolate* isolate, const Translater& translater) {
-  // The FunctionTemplate is cached.
-  if (g_call_translater.IsEmpty())
-    g_call_translater.Reset(
-        isolate,
-        mate::CreateFunctionTemplate(isolate, base::Bind(&CallTranslater)));
-
-  v8::Local<v8::FunctionTemplate> call_translater =
-      v8::Local<v8::FunctionTemplate>::New(isolate, g_call_translater);
+  // The ObjectTemplate is cached.
+  if (g_holder_template.IsEmpty()) {
+    v8::Local<v8::ObjectTemplate> holder_template =
+        v8::ObjectTemplate::New(isolate);
+    holder_template->SetInternalFieldCount(1);
+    g_holder_template.Reset(isolate, holder_template);
+  }
+
+  // The state is passed as the data of the function instead of binding it
+  // with func.bind, which is much slower and leaked the state of callbacks
+  // that were never called.
+  v8::Local<v8::Object> state = v8::Local<v8::ObjectTemplate>::New(
+      isolate, g_holder_template)->NewInstance();
   TranslaterHolder* holder = new TranslaterHolder;
   holder->translater = translater;
-  return BindFunctionWith(isolate,
-                          isolate->GetCurrentContext(),
-                          call_translater->GetFunction(),
-                          v8::External::New(isolate, holder),
-                          v8::Object::New(isolate));
+  holder->handle.Reset(isolate, state);
+  holder->handle.SetWeak(holder, &ResetHolder,
+                         v8::WeakCallbackType::kParameter);
+  state->SetAlignedPointerInInternalField(0, holder);
+  return v8::Function::New(isolate, &CallTranslater, state);
 }
 
 }  // namespace internal
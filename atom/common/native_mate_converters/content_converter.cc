@@ -4,7 +4,13 @@
 
 #include "atom/common/native_mate_converters/content_converter.h"
 
+#include <string>
+#include <vector>
+
 #include "native_mate/dictionary.h"
+#include "net/http/http_byte_range.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_util.h"
 #include "net/url_request/url_request.h"
 
 namespace mate {
@@ -16,6 +22,28 @@ v8::Local<v8::Value> Converter<const net::URLRequest*>::ToV8(
   dict.Set("method", val->method());
   dict.Set("url", val->url().spec());
   dict.Set("referrer", val->referrer());
+
+  // The requested range, so handlers can send only that part.
+  std::string range_header;
+  std::vector<net::HttpByteRange> ranges;
+  if (val->extra_request_headers().GetHeader(
+          net::HttpRequestHeaders::kRange, &range_header) &&
+      net::HttpUtil::ParseRangeHeader(range_header, &ranges) &&
+      ranges.size() == 1) {
+    mate::Dictionary range = mate::Dictionary::CreateEmpty(isolate);
+    const net::HttpByteRange& byte_range = ranges.front();
+    if (byte_range.IsSuffixByteRange()) {
+      range.Set("suffixLength",
+                static_cast<double>(byte_range.suffix_length()));
+    } else {
+      range.Set("start",
+                static_cast<double>(byte_range.first_byte_position()));
+      if (byte_range.HasLastBytePosition())
+        range.Set("end",
+                  static_cast<double>(byte_range.last_byte_position()));
+    }
+    dict.Set("range", range);
+  }
   return mate::ConvertToV8(isolate, dict);
 }
 
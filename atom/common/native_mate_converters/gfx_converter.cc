@@ -4,7 +4,9 @@
 
 #include "atom/common/native_mate_converters/gfx_converter.h"
 
-#include "native_mate/dictionary.h"
+#include "base/macros.h"
+#include "gin/per_isolate_data.h"
+#include "gin/public/wrapper_info.h"
 #include "ui/gfx/geometry/point.h"
 #include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/screen.h"
@@ -12,72 +14,189 @@
 
 namespace mate {
 
+namespace {
+
+const char* const kPointKeys[] = { "x", "y" };
+const char* const kSizeKeys[] = { "width", "height" };
+const char* const kRectKeys[] = { "x", "y", "width", "height" };
+const char* const kDisplayKeys[] = {
+  "id", "bounds", "workArea", "size", "workAreaSize", "scaleFactor",
+  "rotation", "touchSupport",
+};
+
+// The objects of a struct are created from a template that already has all of
+// their properties, so they share one fixed layout instead of growing one
+// property at a time. The names are internalized, so every get and set uses
+// the same strings.
+struct StructInfo {
+  gin::WrapperInfo wrapper_info;  // Identifies the template.
+  const char* const* keys;
+  size_t key_count;
+};
+
+StructInfo g_point_info = {
+  { gin::kEmbedderNativeGin }, kPointKeys, arraysize(kPointKeys)
+};
+StructInfo g_size_info = {
+  { gin::kEmbedderNativeGin }, kSizeKeys, arraysize(kSizeKeys)
+};
+StructInfo g_rect_info = {
+  { gin::kEmbedderNativeGin }, kRectKeys, arraysize(kRectKeys)
+};
+StructInfo g_display_info = {
+  { gin::kEmbedderNativeGin }, kDisplayKeys, arraysize(kDisplayKeys)
+};
+
+v8::Local<v8::String> GetKey(v8::Isolate* isolate,
+                             StructInfo* info,
+                             size_t index) {
+  return v8::String::NewFromUtf8(
+      isolate, info->keys[index], v8::String::kInternalizedString);
+}
+
+// The templates are kept in the isolate's gin::PerIsolateData, which releases
+// them when the isolate is disposed. The isolates of worker-thread have none,
+// Electron's modules do not run in them, so they get a new template each time.
+v8::Local<v8::ObjectTemplate> GetTemplate(v8::Isolate* isolate,
+                                          StructInfo* info) {
+  gin::PerIsolateData* data = gin::PerIsolateData::From(isolate);
+  v8::Local<v8::ObjectTemplate> object_template;
+  if (data)
+    object_template = data->GetObjectTemplate(&info->wrapper_info);
+  if (object_template.IsEmpty()) {
+    object_template = v8::ObjectTemplate::New(isolate);
+    for (size_t i = 0; i < info->key_count; ++i)
+      object_template->Set(GetKey(isolate, info, i),
+                           v8::Integer::New(isolate, 0));
+    if (data)
+      data->SetObjectTemplate(&info->wrapper_info, object_template);
+  }
+  return object_template;
+}
+
+v8::Local<v8::Object> NewInstance(v8::Isolate* isolate, StructInfo* info) {
+  return GetTemplate(isolate, info)->NewInstance();
+}
+
+template<typename T>
+void SetValue(v8::Isolate* isolate,
+              StructInfo* info,
+              v8::Local<v8::Object> object,
+              size_t index,
+              const T& value) {
+  object->Set(GetKey(isolate, info, index), ConvertToV8(isolate, value));
+}
+
+// Reads the integer properties of |val| in the order of the template's keys.
+bool GetInts(v8::Isolate* isolate,
+             StructInfo* info,
+             v8::Local<v8::Value> val,
+             int* out,
+             size_t count) {
+  if (!val->IsObject())
+    return false;
+  v8::Local<v8::Object> object = val.As<v8::Object>();
+  for (size_t i = 0; i < count; ++i) {
+    v8::Local<v8::Value> value = object->Get(GetKey(isolate, info, i));
+    if (!value->IsInt32())
+      return false;
+    out[i] = value->Int32Value();
+  }
+  return true;
+}
+
+// The structs can also be passed as an Int32Array of their members, e.g.
+// [x, y, width, height] for a gfx::Rect, which skips the property lookups.
+bool GetInt32Array(v8::Local<v8::Value> val, int* out, size_t count) {
+  if (!val->IsInt32Array())
+    return false;
+  v8::Local<v8::Int32Array> array = val.As<v8::Int32Array>();
+  if (array->Length() != count)
+    return false;
+  const char* data = static_cast<const char*>(
+      array->Buffer()->GetContents().Data()) + array->ByteOffset();
+  memcpy(out, data, count * sizeof(int32_t));
+  return true;
+}
+
+bool GetMembers(v8::Isolate* isolate,
+                StructInfo* info,
+                v8::Local<v8::Value> val,
+                int* out,
+                size_t count) {
+  if (val->IsInt32Array())
+    return GetInt32Array(val, out, count);
+  return GetInts(isolate, info, val, out, count);
+}
+
+}  // namespace
+
+bool RectToInt32Array(const gfx::Rect& rect, v8::Local<v8::Value> val) {
+  if (!val->IsInt32Array())
+    return false;
+  v8::Local<v8::Int32Array> array = val.As<v8::Int32Array>();
+  if (array->Length() < 4)
+    return false;
+  int32_t members[] = { rect.x(), rect.y(), rect.width(), rect.height() };
+  char* data = static_cast<char*>(
+      array->Buffer()->GetContents().Data()) + array->ByteOffset();
+  memcpy(data, members, sizeof(members));
+  return true;
+}
+
 v8::Local<v8::Value> Converter<gfx::Point>::ToV8(v8::Isolate* isolate,
                                                   const gfx::Point& val) {
-  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
-  dict.SetHidden("simple", true);
-  dict.Set("x", val.x());
-  dict.Set("y", val.y());
-  return dict.GetHandle();
+  v8::Local<v8::Object> object = NewInstance(isolate, &g_point_info);
+  SetValue(isolate, &g_point_info, object, 0, val.x());
+  SetValue(isolate, &g_point_info, object, 1, val.y());
+  return object;
 }
 
 bool Converter<gfx::Point>::FromV8(v8::Isolate* isolate,
                                    v8::Local<v8::Value> val,
                                    gfx::Point* out) {
-  mate::Dictionary dict;
-  if (!ConvertFromV8(isolate, val, &dict))
-    return false;
-  int x, y;
-  if (!dict.Get("x", &x) || !dict.Get("y", &y))
+  int members[2];
+  if (!GetMembers(isolate, &g_point_info, val, members, arraysize(members)))
     return false;
-  *out = gfx::Point(x, y);
+  *out = gfx::Point(members[0], members[1]);
   return true;
 }
 
 v8::Local<v8::Value> Converter<gfx::Size>::ToV8(v8::Isolate* isolate,
                                                   const gfx::Size& val) {
-  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
-  dict.SetHidden("simple", true);
-  dict.Set("width", val.width());
-  dict.Set("height", val.height());
-  return dict.GetHandle();
+  v8::Local<v8::Object> object = NewInstance(isolate, &g_size_info);
+  SetValue(isolate, &g_size_info, object, 0, val.width());
+  SetValue(isolate, &g_size_info, object, 1, val.height());
+  return object;
 }
 
 bool Converter<gfx::Size>::FromV8(v8::Isolate* isolate,
                                   v8::Local<v8::Value> val,
                                   gfx::Size* out) {
-  mate::Dictionary dict;
-  if (!ConvertFromV8(isolate, val, &dict))
+  int members[2];
+  if (!GetMembers(isolate, &g_size_info, val, members, arraysize(members)))
     return false;
-  int width, height;
-  if (!dict.Get("width", &width) || !dict.Get("height", &height))
-    return false;
-  *out = gfx::Size(width, height);
+  *out = gfx::Size(members[0], members[1]);
   return true;
 }
 
 v8::Local<v8::Value> Converter<gfx::Rect>::ToV8(v8::Isolate* isolate,
                                                  const gfx::Rect& val) {
-  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
-  dict.SetHidden("simple", true);
-  dict.Set("x", val.x());
-  dict.Set("y", val.y());
-  dict.Set("width", val.width());
-  dict.Set("height", val.height());
-  return dict.GetHandle();
+  v8::Local<v8::Object> object = NewInstance(isolate, &g_rect_info);
+  SetValue(isolate, &g_rect_info, object, 0, val.x());
+  SetValue(isolate, &g_rect_info, object, 1, val.y());
+  SetValue(isolate, &g_rect_info, object, 2, val.width());
+  SetValue(isolate, &g_rect_info, object, 3, val.height());
+  return object;
 }
 
 bool Converter<gfx::Rect>::FromV8(v8::Isolate* isolate,
                                   v8::Local<v8::Value> val,
                                   gfx::Rect* out) {
-  mate::Dictionary dict;
-  if (!ConvertFromV8(isolate, val, &dict))
-    return false;
-  int x, y, width, height;
-  if (!dict.Get("x", &x) || !dict.Get("y", &y) ||
-      !dict.Get("width", &width) || !dict.Get("height", &height))
+  int members[4];
+  if (!GetMembers(isolate, &g_rect_info, val, members, arraysize(members)))
     return false;
-  *out = gfx::Rect(x, y, width, height);
+  *out = gfx::Rect(members[0], members[1], members[2], members[3]);
   return true;
 }
 
@@ -98,17 +217,16 @@ struct Converter<gfx::Display::TouchSupport> {
 
 v8::Local<v8::Value> Converter<gfx::Display>::ToV8(v8::Isolate* isolate,
                                                     const gfx::Display& val) {
-  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
-  dict.SetHidden("simple", true);
-  dict.Set("id", val.id());
-  dict.Set("bounds", val.bounds());
-  dict.Set("workArea", val.work_area());
-  dict.Set("size", val.size());
-  dict.Set("workAreaSize", val.work_area_size());
-  dict.Set("scaleFactor", val.device_scale_factor());
-  dict.Set("rotation", val.RotationAsDegree());
-  dict.Set("touchSupport", val.touch_support());
-  return dict.GetHandle();
+  v8::Local<v8::Object> object = NewInstance(isolate, &g_display_info);
+  SetValue(isolate, &g_display_info, object, 0, val.id());
+  SetValue(isolate, &g_display_info, object, 1, val.bounds());
+  SetValue(isolate, &g_display_info, object, 2, val.work_area());
+  SetValue(isolate, &g_display_info, object, 3, val.size());
+  SetValue(isolate, &g_display_info, object, 4, val.work_area_size());
+  SetValue(isolate, &g_display_info, object, 5, val.device_scale_factor());
+  SetValue(isolate, &g_display_info, object, 6, val.RotationAsDegree());
+  SetValue(isolate, &g_display_info, object, 7, val.touch_support());
+  return object;
 }
 
 }  // namespace mate
@@ -52,6 +52,10 @@ struct Converter<gfx::Display> {
                      gfx::Display* out);
 };
 
+// Writes |rect| as [x, y, width, height] into |array|, which has to be an
+// Int32Array of at least 4 elements.
+bool RectToInt32Array(const gfx::Rect& rect, v8::Local<v8::Value> array);
+
 }  // namespace mate
 
 #endif  // ATOM_COMMON_NATIVE_MATE_CONVERTERS_GFX_CONVERTER_H_
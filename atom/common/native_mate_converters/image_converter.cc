@@ -4,8 +4,12 @@
 
 #include "atom/common/native_mate_converters/image_converter.h"
 
+#include <string>
+
 #include "atom/common/api/atom_api_native_image.h"
+#include "atom/common/image_encoder.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
+#include "native_mate/dictionary.h"
 #include "ui/gfx/image/image_skia.h"
 
 namespace mate {
@@ -48,4 +52,26 @@ v8::Local<v8::Value> Converter<gfx::Image>::ToV8(v8::Isolate* isolate,
   return ConvertToV8(isolate, atom::api::NativeImage::Create(isolate, val));
 }
 
+bool Converter<atom::ImageEncodeOptions>::FromV8(
+    v8::Isolate* isolate,
+    v8::Local<v8::Value> val,
+    atom::ImageEncodeOptions* out) {
+  Dictionary dict;
+  if (!ConvertFromV8(isolate, val, &dict))
+    return false;
+
+  std::string format;
+  if (dict.Get("format", &format)) {
+    if (format == "jpeg")
+      out->format = atom::ImageEncodeOptions::FORMAT_JPEG;
+    else if (format == "png")
+      out->format = atom::ImageEncodeOptions::FORMAT_PNG;
+    else
+      return false;
+  }
+  dict.Get("quality", &out->quality);
+  dict.Get("scale", &out->scale);
+  return true;
+}
+
 }  // namespace mate
@@ -7,6 +7,10 @@
 
 #include "native_mate/converter.h"
 
+namespace atom {
+struct ImageEncodeOptions;
+}
+
 namespace gfx {
 class Image;
 class ImageSkia;
@@ -30,6 +34,13 @@ struct Converter<gfx::Image> {
                                     const gfx::Image& val);
 };
 
+template<>
+struct Converter<atom::ImageEncodeOptions> {
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     atom::ImageEncodeOptions* out);
+};
+
 }  // namespace mate
 
 #endif  // ATOM_COMMON_NATIVE_MATE_CONVERTERS_IMAGE_CONVERTER_H_
@@ -4,12 +4,13 @@
 
 #include "atom/common/native_mate_converters/v8_value_converter.h"
 
-#include <map>
 #include <string>
 #include <utility>
 
+#include "base/containers/hash_tables.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/values.h"
 #include "native_mate/dictionary.h"
 #include "vendor/node/src/node_buffer.h"
@@ -20,26 +21,84 @@ namespace {
 
 const int kMaxRecursionDepth = 100;
 
+// Converts |str| to UTF-8 without the extra copy of String::Utf8Value.
+std::string V8ToUTF8(v8::Local<v8::String> str) {
+  std::string result;
+  int length = str->Utf8Length();
+  if (length > 0) {
+    result.resize(length);
+    str->WriteUtf8(&result[0], length, nullptr,
+                   v8::String::NO_NULL_TERMINATION);
+  }
+  return result;
+}
+
+// Enters the creation context of |object| if it is not the current one.
+scoped_ptr<v8::Context::Scope> EnterCreationContext(
+    v8::Isolate* isolate, v8::Local<v8::Object> object) {
+  v8::Local<v8::Context> context = object->CreationContext();
+  if (context.IsEmpty() || context == isolate->GetCurrentContext())
+    return nullptr;
+  return make_scoped_ptr(new v8::Context::Scope(context));
+}
+
 }  // namespace
 
-// The state of a call to FromV8Value.
-class V8ValueConverter::FromV8ValueState {
- public:
-  // Level scope which updates the current depth of some FromV8ValueState.
-  class Level {
-   public:
-    explicit Level(FromV8ValueState* state) : state_(state) {
-      state_->max_recursion_depth_--;
-    }
-    ~Level() {
-      state_->max_recursion_depth_++;
+// A list or dictionary whose children are being converted to V8.
+struct V8ValueConverter::ToV8Frame {
+  ToV8Frame(const base::ListValue* list, v8::Local<v8::Object> result)
+      : list(list), index(0), result(result) {}
+  ToV8Frame(const base::DictionaryValue* dictionary,
+            v8::Local<v8::Object> result)
+      : list(nullptr),
+        index(0),
+        iterator(new base::DictionaryValue::Iterator(*dictionary)),
+        result(result) {}
+
+  bool IsAtEnd() const {
+    return list ? index >= list->GetSize() : iterator->IsAtEnd();
+  }
+
+  const base::ListValue* list;
+  size_t index;
+  scoped_ptr<base::DictionaryValue::Iterator> iterator;
+  v8::Local<v8::Object> result;
+};
+
+// A JavaScript array or object whose children are being converted.
+struct V8ValueConverter::FromV8Frame {
+  FromV8Frame(v8::Isolate* isolate,
+              v8::Local<v8::Object> object,
+              base::Value* result)
+      : object(object),
+        result(result),
+        index(0),
+        length(0),
+        scope(EnterCreationContext(isolate, object)) {
+    if (object->IsArray()) {
+      length = object.As<v8::Array>()->Length();
+    } else {
+      property_names = object->GetOwnPropertyNames();
+      length = property_names->Length();
     }
+  }
+
+  bool is_array() const { return property_names.IsEmpty(); }
 
-   private:
-    FromV8ValueState* state_;
-  };
+  v8::Local<v8::Object> object;
+  // Owned by the parent frame's result, or returned to the caller.
+  base::Value* result;
+  v8::Local<v8::Array> property_names;
+  uint32 index;
+  uint32 length;
+  // Objects from other contexts are converted in their own context.
+  scoped_ptr<v8::Context::Scope> scope;
+};
 
-  FromV8ValueState() : max_recursion_depth_(kMaxRecursionDepth) {}
+// The state of a call to FromV8Value.
+class V8ValueConverter::FromV8ValueState {
+ public:
+  FromV8ValueState() {}
 
   // If |handle| is not in |unique_map_|, then add it to |unique_map_| and
   // return true.
@@ -64,15 +123,19 @@ class V8ValueConverter::FromV8ValueState {
     return true;
   }
 
-  bool HasReachedMaxRecursionDepth() {
-    return max_recursion_depth_ < 0;
-  }
+  // The level of the values that are converted next, the root is level 1.
+  int level() const { return static_cast<int>(stack_.size()) + 1; }
+
+  ScopedVector<FromV8Frame>& stack() { return stack_; }
 
  private:
-  typedef std::multimap<int, v8::Local<v8::Object> > HashToHandleMap;
+  typedef base::hash_multimap<int, v8::Local<v8::Object>> HashToHandleMap;
   HashToHandleMap unique_map_;
 
-  int max_recursion_depth_;
+  // The containers being converted, innermost last.
+  ScopedVector<FromV8Frame> stack_;
+
+  DISALLOW_COPY_AND_ASSIGN(FromV8ValueState);
 };
 
 V8ValueConverter::V8ValueConverter()
@@ -115,6 +178,54 @@ base::Value* V8ValueConverter::FromV8Value(
 
 v8::Local<v8::Value> V8ValueConverter::ToV8ValueImpl(
      v8::Isolate* isolate, const base::Value* value) const {
+  // Lists and dictionaries are converted with an explicit stack instead of
+  // recursion.
+  ScopedVector<ToV8Frame> stack;
+  v8::Local<v8::Value> root = ToV8Leaf(isolate, value, &stack);
+
+  while (!stack.empty()) {
+    ToV8Frame* frame = stack.back();
+    if (frame->IsAtEnd()) {
+      stack.pop_back();
+      continue;
+    }
+
+    if (frame->list) {
+      uint32 i = static_cast<uint32>(frame->index++);
+      const base::Value* child = NULL;
+      CHECK(frame->list->Get(i, &child));
+      v8::Local<v8::Value> child_v8 = ToV8Leaf(isolate, child, &stack);
+
+      v8::TryCatch try_catch;
+      frame->result->Set(i, child_v8);
+      if (try_catch.HasCaught())
+        LOG(ERROR) << "Setter for index " << i << " threw an exception.";
+    } else {
+      const std::string& key = frame->iterator->key();
+      v8::Local<v8::Value> child_v8 =
+          ToV8Leaf(isolate, &frame->iterator->value(), &stack);
+      frame->iterator->Advance();
+
+      v8::TryCatch try_catch;
+      frame->result->Set(v8::String::NewFromUtf8(isolate,
+                                                 key.c_str(),
+                                                 v8::String::kNormalString,
+                                                 key.length()),
+                         child_v8);
+      if (try_catch.HasCaught()) {
+        LOG(ERROR) << "Setter for property " << key.c_str() << " threw an "
+                   << "exception.";
+      }
+    }
+  }
+
+  return root;
+}
+
+v8::Local<v8::Value> V8ValueConverter::ToV8Leaf(
+    v8::Isolate* isolate,
+    const base::Value* value,
+    ScopedVector<ToV8Frame>* stack) const {
   CHECK(value);
   switch (value->GetType()) {
     case base::Value::TYPE_NULL:
@@ -139,18 +250,28 @@ v8::Local<v8::Value> V8ValueConverter::ToV8ValueImpl(
     }
 
     case base::Value::TYPE_STRING: {
-      std::string val;
-      CHECK(value->GetAsString(&val));
+      const std::string* val;
+      CHECK(static_cast<const base::StringValue*>(value)->GetAsString(&val));
       return v8::String::NewFromUtf8(
-          isolate, val.c_str(), v8::String::kNormalString, val.length());
+          isolate, val->c_str(), v8::String::kNormalString, val->length());
     }
 
-    case base::Value::TYPE_LIST:
-      return ToV8Array(isolate, static_cast<const base::ListValue*>(value));
+    case base::Value::TYPE_LIST: {
+      // The children are filled in by ToV8ValueImpl.
+      const base::ListValue* list = static_cast<const base::ListValue*>(value);
+      v8::Local<v8::Array> result(v8::Array::New(isolate, list->GetSize()));
+      stack->push_back(new ToV8Frame(list, result));
+      return result;
+    }
 
-    case base::Value::TYPE_DICTIONARY:
-      return ToV8Object(isolate,
-                        static_cast<const base::DictionaryValue*>(value));
+    case base::Value::TYPE_DICTIONARY: {
+      mate::Dictionary result = mate::Dictionary::CreateEmpty(isolate);
+      result.SetHidden("simple", true);
+      stack->push_back(new ToV8Frame(
+          static_cast<const base::DictionaryValue*>(value),
+          result.GetHandle()));
+      return result.GetHandle();
+    }
 
     case base::Value::TYPE_BINARY:
       return ToArrayBuffer(isolate,
@@ -162,63 +283,154 @@ v8::Local<v8::Value> V8ValueConverter::ToV8ValueImpl(
   }
 }
 
-v8::Local<v8::Value> V8ValueConverter::ToV8Array(
-    v8::Isolate* isolate, const base::ListValue* val) const {
-  v8::Local<v8::Array> result(v8::Array::New(isolate, val->GetSize()));
-
-  for (size_t i = 0; i < val->GetSize(); ++i) {
-    const base::Value* child = NULL;
-    CHECK(val->Get(i, &child));
+v8::Local<v8::Value> V8ValueConverter::ToArrayBuffer(
+    v8::Isolate* isolate, const base::BinaryValue* value) const {
+  return node::Buffer::Copy(isolate,
+                            value->GetBuffer(),
+                            value->GetSize()).ToLocalChecked();
+}
 
-    v8::Local<v8::Value> child_v8 = ToV8ValueImpl(isolate, child);
-    CHECK(!child_v8.IsEmpty());
+base::Value* V8ValueConverter::FromV8ValueImpl(
+    FromV8ValueState* state,
+    v8::Local<v8::Value> val,
+    v8::Isolate* isolate) const {
+  // Arrays and objects are converted with an explicit stack instead of
+  // recursion, FromV8Leaf pushes a frame for each of them.
+  ScopedVector<FromV8Frame>& stack = state->stack();
+  scoped_ptr<base::Value> root(FromV8Leaf(state, val, isolate));
+
+  while (!stack.empty()) {
+    FromV8Frame* frame = stack.back();
+    if (frame->index >= frame->length) {
+      stack.pop_back();
+      continue;
+    }
 
-    v8::TryCatch try_catch;
-    result->Set(static_cast<uint32>(i), child_v8);
-    if (try_catch.HasCaught())
-      LOG(ERROR) << "Setter for index " << i << " threw an exception.";
+    uint32 i = frame->index++;
+    if (frame->is_array())
+      FromV8ArrayElement(state, frame, i, isolate);
+    else
+      FromV8ObjectProperty(state, frame, i, isolate);
   }
 
-  return result;
+  return root.release();
 }
 
-v8::Local<v8::Value> V8ValueConverter::ToV8Object(
-    v8::Isolate* isolate, const base::DictionaryValue* val) const {
-  mate::Dictionary result = mate::Dictionary::CreateEmpty(isolate);
-  result.SetHidden("simple", true);
-
-  for (base::DictionaryValue::Iterator iter(*val);
-       !iter.IsAtEnd(); iter.Advance()) {
-    const std::string& key = iter.key();
-    v8::Local<v8::Value> child_v8 = ToV8ValueImpl(isolate, &iter.value());
-    CHECK(!child_v8.IsEmpty());
-
-    v8::TryCatch try_catch;
-    result.Set(key, child_v8);
-    if (try_catch.HasCaught()) {
-      LOG(ERROR) << "Setter for property " << key.c_str() << " threw an "
-                 << "exception.";
+void V8ValueConverter::FromV8ArrayElement(FromV8ValueState* state,
+                                          FromV8Frame* frame,
+                                          uint32 i,
+                                          v8::Isolate* isolate) const {
+  v8::Local<v8::Array> val = frame->object.As<v8::Array>();
+  base::ListValue* result = static_cast<base::ListValue*>(frame->result);
+
+  // Only fields with integer keys are carried over to the ListValue.
+  v8::TryCatch try_catch;
+  v8::Local<v8::Value> child_v8 = val->Get(i);
+  if (try_catch.HasCaught()) {
+    LOG(ERROR) << "Getter for index " << i << " threw an exception.";
+    child_v8 = v8::Null(isolate);
+  }
+
+  if (!val->HasRealIndexedProperty(i))
+    return;
+
+  // Fast paths for arrays of numbers and strings.
+  if (state->level() <= kMaxRecursionDepth) {
+    if (child_v8->IsInt32()) {
+      result->AppendInteger(child_v8->Int32Value());
+      return;
+    } else if (child_v8->IsNumber()) {
+      result->AppendDouble(child_v8->NumberValue());
+      return;
+    } else if (child_v8->IsString()) {
+      result->AppendString(V8ToUTF8(child_v8.As<v8::String>()));
+      return;
     }
   }
 
-  return result.GetHandle();
+  base::Value* child = FromV8Leaf(state, child_v8, isolate);
+  if (child)
+    result->Append(child);
+  else
+    // JSON.stringify puts null in places where values don't serialize, for
+    // example undefined and functions. Emulate that behavior.
+    result->Append(base::Value::CreateNullValue());
 }
 
-v8::Local<v8::Value> V8ValueConverter::ToArrayBuffer(
-    v8::Isolate* isolate, const base::BinaryValue* value) const {
-  return node::Buffer::Copy(isolate,
-                            value->GetBuffer(),
-                            value->GetSize()).ToLocalChecked();
+void V8ValueConverter::FromV8ObjectProperty(FromV8ValueState* state,
+                                            FromV8Frame* frame,
+                                            uint32 i,
+                                            v8::Isolate* isolate) const {
+  v8::Local<v8::Object> val = frame->object;
+  base::DictionaryValue* result =
+      static_cast<base::DictionaryValue*>(frame->result);
+
+  v8::Local<v8::Value> key(frame->property_names->Get(i));
+
+  // Extend this test to cover more types as necessary and if sensible.
+  if (!key->IsString() &&
+      !key->IsNumber()) {
+    NOTREACHED() << "Key \"" << *v8::String::Utf8Value(key) << "\" "
+                    "is neither a string nor a number";
+    return;
+  }
+
+  // Skip all callbacks: crbug.com/139933
+  v8::Local<v8::String> key_string = key->ToString();
+  if (val->HasRealNamedCallbackProperty(key_string))
+    return;
+
+  std::string name = V8ToUTF8(key_string);
+
+  v8::TryCatch try_catch;
+  v8::Local<v8::Value> child_v8 = val->Get(key);
+
+  if (try_catch.HasCaught()) {
+    LOG(ERROR) << "Getter for property " << name << " threw an exception.";
+    child_v8 = v8::Null(isolate);
+  }
+
+  base::Value* child = FromV8Leaf(state, child_v8, isolate);
+  if (!child)
+    // JSON.stringify skips properties whose values don't serialize, for
+    // example undefined and functions. Emulate that behavior.
+    return;
+
+  // Strip null if asked (and since undefined is turned into null, undefined
+  // too). The use case for supporting this is JSON-schema support,
+  // specifically for extensions, where "optional" JSON properties may be
+  // represented as null, yet due to buggy legacy code elsewhere isn't
+  // treated as such (potentially causing crashes). For example, the
+  // "tabs.create" function takes an object as its first argument with an
+  // optional "windowId" property.
+  //
+  // Given just
+  //
+  //   tabs.create({})
+  //
+  // this will work as expected on code that only checks for the existence of
+  // a "windowId" property (such as that legacy code). However given
+  //
+  //   tabs.create({windowId: null})
+  //
+  // there *is* a "windowId" property, but since it should be an int, code
+  // on the browser which doesn't additionally check for null will fail.
+  // We can avoid all bugs related to this by stripping null.
+  if (strip_null_from_objects_ && child->IsType(base::Value::TYPE_NULL)) {
+    delete child;
+    return;
+  }
+
+  result->SetWithoutPathExpansion(name, child);
 }
 
-base::Value* V8ValueConverter::FromV8ValueImpl(
+base::Value* V8ValueConverter::FromV8Leaf(
     FromV8ValueState* state,
     v8::Local<v8::Value> val,
     v8::Isolate* isolate) const {
   CHECK(!val.IsEmpty());
 
-  FromV8ValueState::Level state_level(state);
-  if (state->HasReachedMaxRecursionDepth())
+  if (state->level() > kMaxRecursionDepth)
     return NULL;
 
   if (val->IsNull())
@@ -233,10 +445,8 @@ base::Value* V8ValueConverter::FromV8ValueImpl(
   if (val->IsNumber())
     return new base::FundamentalValue(val->ToNumber()->Value());
 
-  if (val->IsString()) {
-    v8::String::Utf8Value utf8(val->ToString());
-    return new base::StringValue(std::string(*utf8, utf8.length()));
-  }
+  if (val->IsString())
+    return new base::StringValue(V8ToUTF8(val.As<v8::String>()));
 
   if (val->IsUndefined())
     // JSON.stringify ignores undefined.
@@ -246,7 +456,7 @@ base::Value* V8ValueConverter::FromV8ValueImpl(
     if (!date_allowed_)
       // JSON.stringify would convert this to a string, but an object is more
       // consistent within this class.
-      return FromV8Object(val->ToObject(), state, isolate);
+      return FromV8Container(state, val->ToObject(), isolate);
     v8::Date* date = v8::Date::Cast(*val);
     return new base::FundamentalValue(date->NumberValue() / 1000.0);
   }
@@ -254,19 +464,19 @@ base::Value* V8ValueConverter::FromV8ValueImpl(
   if (val->IsRegExp()) {
     if (!reg_exp_allowed_)
       // JSON.stringify converts to an object.
-      return FromV8Object(val->ToObject(), state, isolate);
+      return FromV8Container(state, val->ToObject(), isolate);
     return new base::StringValue(*v8::String::Utf8Value(val->ToString()));
   }
 
   // v8::Value doesn't have a ToArray() method for some reason.
   if (val->IsArray())
-    return FromV8Array(val.As<v8::Array>(), state, isolate);
+    return FromV8Container(state, val.As<v8::Array>(), isolate);
 
   if (val->IsFunction()) {
     if (!function_allowed_)
       // JSON.stringify refuses to convert function(){}.
       return NULL;
-    return FromV8Object(val->ToObject(), state, isolate);
+    return FromV8Container(state, val->ToObject(), isolate);
   }
 
   if (node::Buffer::HasInstance(val)) {
@@ -274,49 +484,28 @@ base::Value* V8ValueConverter::FromV8ValueImpl(
   }
 
   if (val->IsObject()) {
-    return FromV8Object(val->ToObject(), state, isolate);
+    return FromV8Container(state, val->ToObject(), isolate);
   }
 
   LOG(ERROR) << "Unexpected v8 value type encountered.";
   return NULL;
 }
 
-base::Value* V8ValueConverter::FromV8Array(
-    v8::Local<v8::Array> val,
+base::Value* V8ValueConverter::FromV8Container(
     FromV8ValueState* state,
+    v8::Local<v8::Object> val,
     v8::Isolate* isolate) const {
   if (!state->UpdateAndCheckUniqueness(val))
     return base::Value::CreateNullValue().release();
 
-  scoped_ptr<v8::Context::Scope> scope;
-  // If val was created in a different context than our current one, change to
-  // that context, but change back after val is converted.
-  if (!val->CreationContext().IsEmpty() &&
-      val->CreationContext() != isolate->GetCurrentContext())
-    scope.reset(new v8::Context::Scope(val->CreationContext()));
-
-  base::ListValue* result = new base::ListValue();
-
-  // Only fields with integer keys are carried over to the ListValue.
-  for (uint32 i = 0; i < val->Length(); ++i) {
-    v8::TryCatch try_catch;
-    v8::Local<v8::Value> child_v8 = val->Get(i);
-    if (try_catch.HasCaught()) {
-      LOG(ERROR) << "Getter for index " << i << " threw an exception.";
-      child_v8 = v8::Null(isolate);
-    }
-
-    if (!val->HasRealIndexedProperty(i))
-      continue;
-
-    base::Value* child = FromV8ValueImpl(state, child_v8, isolate);
-    if (child)
-      result->Append(child);
-    else
-      // JSON.stringify puts null in places where values don't serialize, for
-      // example undefined and functions. Emulate that behavior.
-      result->Append(base::Value::CreateNullValue());
-  }
+  // The children are filled in by FromV8ValueImpl.
+  base::Value* result;
+  if (val->IsArray())
+    result = new base::ListValue();
+  else
+    result = new base::DictionaryValue();
+  state->stack().push_back(
+      new FromV8Frame(isolate, val, result));
   return result;
 }
 
@@ -328,83 +517,4 @@ base::Value* V8ValueConverter::FromNodeBuffer(
       node::Buffer::Data(value), node::Buffer::Length(value));
 }
 
-base::Value* V8ValueConverter::FromV8Object(
-    v8::Local<v8::Object> val,
-    FromV8ValueState* state,
-    v8::Isolate* isolate) const {
-  if (!state->UpdateAndCheckUniqueness(val))
-    return base::Value::CreateNullValue().release();
-
-  scoped_ptr<v8::Context::Scope> scope;
-  // If val was created in a different context than our current one, change to
-  // that context, but change back after val is converted.
-  if (!val->CreationContext().IsEmpty() &&
-      val->CreationContext() != isolate->GetCurrentContext())
-    scope.reset(new v8::Context::Scope(val->CreationContext()));
-
-  scoped_ptr<base::DictionaryValue> result(new base::DictionaryValue());
-  v8::Local<v8::Array> property_names(val->GetOwnPropertyNames());
-
-  for (uint32 i = 0; i < property_names->Length(); ++i) {
-    v8::Local<v8::Value> key(property_names->Get(i));
-
-    // Extend this test to cover more types as necessary and if sensible.
-    if (!key->IsString() &&
-        !key->IsNumber()) {
-      NOTREACHED() << "Key \"" << *v8::String::Utf8Value(key) << "\" "
-                      "is neither a string nor a number";
-      continue;
-    }
-
-    // Skip all callbacks: crbug.com/139933
-    if (val->HasRealNamedCallbackProperty(key->ToString()))
-      continue;
-
-    v8::String::Utf8Value name_utf8(key->ToString());
-
-    v8::TryCatch try_catch;
-    v8::Local<v8::Value> child_v8 = val->Get(key);
-
-    if (try_catch.HasCaught()) {
-      LOG(ERROR) << "Getter for property " << *name_utf8
-                 << " threw an exception.";
-      child_v8 = v8::Null(isolate);
-    }
-
-    scoped_ptr<base::Value> child(FromV8ValueImpl(state, child_v8, isolate));
-    if (!child.get())
-      // JSON.stringify skips properties whose values don't serialize, for
-      // example undefined and functions. Emulate that behavior.
-      continue;
-
-    // Strip null if asked (and since undefined is turned into null, undefined
-    // too). The use case for supporting this is JSON-schema support,
-    // specifically for extensions, where "optional" JSON properties may be
-    // represented as null, yet due to buggy legacy code elsewhere isn't
-    // treated as such (potentially causing crashes). For example, the
-    // "tabs.create" function takes an object as its first argument with an
-    // optional "windowId" property.
-    //
-    // Given just
-    //
-    //   tabs.create({})
-    //
-    // this will work as expected on code that only checks for the existence of
-    // a "windowId" property (such as that legacy code). However given
-    //
-    //   tabs.create({windowId: null})
-    //
-    // there *is* a "windowId" property, but since it should be an int, code
-    // on the browser which doesn't additionally check for null will fail.
-    // We can avoid all bugs related to this by stripping null.
-    if (strip_null_from_objects_ && child->IsType(base::Value::TYPE_NULL))
-      continue;
-
-    result->SetWithoutPathExpansion(std::string(*name_utf8, name_utf8.length()),
-                                    child.release());
-  }
-
-  return result.release();
-}
-
 }  // namespace atom
@@ -7,6 +7,7 @@
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/memory/scoped_vector.h"
 #include "v8/include/v8.h"
 
 namespace base {
@@ -33,14 +34,17 @@ class V8ValueConverter {
 
  private:
   class FromV8ValueState;
+  struct FromV8Frame;
+  struct ToV8Frame;
 
+  // Both directions walk the values with an explicit stack of frames instead
+  // of recursion, the *Leaf methods convert one value and push a frame when
+  // the value is a container whose children still have to be converted.
   v8::Local<v8::Value> ToV8ValueImpl(v8::Isolate* isolate,
                                      const base::Value* value) const;
-  v8::Local<v8::Value> ToV8Array(v8::Isolate* isolate,
-                                 const base::ListValue* list) const;
-  v8::Local<v8::Value> ToV8Object(
-      v8::Isolate* isolate,
-      const base::DictionaryValue* dictionary) const;
+  v8::Local<v8::Value> ToV8Leaf(v8::Isolate* isolate,
+                                const base::Value* value,
+                                ScopedVector<ToV8Frame>* stack) const;
   v8::Local<v8::Value> ToArrayBuffer(
       v8::Isolate* isolate,
       const base::BinaryValue* value) const;
@@ -48,15 +52,23 @@ class V8ValueConverter {
   base::Value* FromV8ValueImpl(FromV8ValueState* state,
                                v8::Local<v8::Value> value,
                                v8::Isolate* isolate) const;
-  base::Value* FromV8Array(v8::Local<v8::Array> array,
-                           FromV8ValueState* state,
-                           v8::Isolate* isolate) const;
+  base::Value* FromV8Leaf(FromV8ValueState* state,
+                          v8::Local<v8::Value> value,
+                          v8::Isolate* isolate) const;
+  base::Value* FromV8Container(FromV8ValueState* state,
+                               v8::Local<v8::Object> object,
+                               v8::Isolate* isolate) const;
+  void FromV8ArrayElement(FromV8ValueState* state,
+                          FromV8Frame* frame,
+                          uint32 index,
+                          v8::Isolate* isolate) const;
+  void FromV8ObjectProperty(FromV8ValueState* state,
+                            FromV8Frame* frame,
+                            uint32 index,
+                            v8::Isolate* isolate) const;
   base::Value* FromNodeBuffer(v8::Local<v8::Value> value,
                               FromV8ValueState* state,
                               v8::Isolate* isolate) const;
-  base::Value* FromV8Object(v8::Local<v8::Object> object,
-                            FromV8ValueState* state,
-                            v8::Isolate* isolate) const;
 
   // If true, we will convert Date JavaScript objects to doubles.
   bool date_allowed_;
@@ -0,0 +1,553 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
+
+#include <string.h>
+
+#include <map>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "vendor/node/src/node_buffer.h"
+
+namespace atom {
+
+namespace {
+
+// Same as the limit used by V8ValueConverter.
+const int kMaxRecursionDepth = 100;
+
+// Called when a Buffer pointing into a SharedBufferRegion is collected.
+void ReleaseRegion(char* data, void* hint) {
+  static_cast<SharedBufferRegion*>(hint)->Release();
+}
+
+// Each value starts with one of the tags, arrays and objects are ended by
+// kTagEnd. Lengths are written as varints, int32 and double values are
+// written in the machine's byte order since both sides of ipc run on the
+// same machine.
+enum Tag {
+  kTagNull = 0,
+  kTagFalse,
+  kTagTrue,
+  kTagInt32,
+  kTagDouble,
+  kTagString,        // length, UTF-8 bytes
+  kTagBuffer,        // length, bytes
+  kTagSharedBuffer,  // offset in the shared region, length
+  kTagArray,         // values..., kTagEnd
+  kTagObject,        // (kTagString key, value)..., kTagEnd
+  kTagEnd,
+};
+
+class Writer {
+ public:
+  Writer(v8::Isolate* isolate,
+         std::string* data,
+         V8ValueSerializer::BufferList* shared_buffers)
+      : isolate_(isolate),
+        data_(data),
+        shared_buffers_(shared_buffers),
+        shared_size_(0),
+        max_recursion_depth_(kMaxRecursionDepth) {
+  }
+
+  bool WriteValue(v8::Local<v8::Value> val) {
+    CHECK(!val.IsEmpty());
+
+    Level level(this);
+    if (max_recursion_depth_ < 0)
+      return false;
+
+    if (val->IsNull()) {
+      WriteTag(kTagNull);
+    } else if (val->IsBoolean()) {
+      WriteTag(val->ToBoolean()->Value() ? kTagTrue : kTagFalse);
+    } else if (val->IsInt32()) {
+      WriteTag(kTagInt32);
+      int32 number = val->ToInt32()->Value();
+      data_->append(reinterpret_cast<const char*>(&number), sizeof(number));
+    } else if (val->IsNumber()) {
+      WriteTag(kTagDouble);
+      double number = val->ToNumber()->Value();
+      data_->append(reinterpret_cast<const char*>(&number), sizeof(number));
+    } else if (val->IsString()) {
+      WriteString(val.As<v8::String>());
+    } else if (val->IsUndefined() || val->IsFunction()) {
+      // JSON.stringify ignores undefined and functions.
+      return false;
+    } else if (val->IsArray()) {
+      WriteArray(val.As<v8::Array>());
+    } else if (node::Buffer::HasInstance(val)) {
+      WriteBuffer(val);
+    } else if (val->IsObject()) {
+      // Date and RegExp objects are converted like plain objects.
+      WriteObject(val->ToObject());
+    } else {
+      LOG(ERROR) << "Unexpected v8 value type encountered.";
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  // Updates the current depth of the writer.
+  class Level {
+   public:
+    explicit Level(Writer* writer) : writer_(writer) {
+      writer_->max_recursion_depth_--;
+    }
+    ~Level() {
+      writer_->max_recursion_depth_++;
+    }
+
+   private:
+    Writer* writer_;
+  };
+
+  void WriteTag(Tag tag) {
+    data_->push_back(static_cast<char>(tag));
+  }
+
+  void WriteVarint(size_t value) {
+    while (value >= 0x80) {
+      data_->push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    data_->push_back(static_cast<char>(value));
+  }
+
+  void WriteBuffer(v8::Local<v8::Value> val) {
+    const char* bytes = node::Buffer::Data(val);
+    size_t length = node::Buffer::Length(val);
+    if (shared_buffers_ &&
+        length >= V8ValueSerializer::kSharedBufferThreshold) {
+      WriteTag(kTagSharedBuffer);
+      WriteVarint(shared_size_);
+      WriteVarint(length);
+      shared_buffers_->push_back(base::StringPiece(bytes, length));
+      shared_size_ += length;
+    } else {
+      WriteTag(kTagBuffer);
+      WriteVarint(length);
+      data_->append(bytes, length);
+    }
+  }
+
+  void WriteString(v8::Local<v8::String> str) {
+    // Write the UTF-8 bytes in place instead of copying a Utf8Value.
+    int length = str->Utf8Length();
+    WriteTag(kTagString);
+    WriteVarint(length);
+    size_t offset = data_->size();
+    data_->resize(offset + length);
+    if (length > 0)
+      str->WriteUtf8(&(*data_)[offset], length, nullptr,
+                     v8::String::NO_NULL_TERMINATION);
+  }
+
+  void WriteArray(v8::Local<v8::Array> val) {
+    if (!UpdateAndCheckUniqueness(val)) {
+      WriteTag(kTagNull);
+      return;
+    }
+
+    scoped_ptr<v8::Context::Scope> scope;
+    // If val was created in a different context than our current one, change
+    // to that context, but change back after val is serialized.
+    if (!val->CreationContext().IsEmpty() &&
+        val->CreationContext() != isolate_->GetCurrentContext())
+      scope.reset(new v8::Context::Scope(val->CreationContext()));
+
+    WriteTag(kTagArray);
+    // Only fields with integer keys are carried over.
+    for (uint32 i = 0; i < val->Length(); ++i) {
+      v8::TryCatch try_catch;
+      v8::Local<v8::Value> child = val->Get(i);
+      if (try_catch.HasCaught()) {
+        LOG(ERROR) << "Getter for index " << i << " threw an exception.";
+        child = v8::Null(isolate_);
+      }
+
+      if (!val->HasRealIndexedProperty(i))
+        continue;
+
+      // JSON.stringify puts null in places where values don't serialize.
+      if (!WriteValue(child))
+        WriteTag(kTagNull);
+    }
+    WriteTag(kTagEnd);
+  }
+
+  void WriteObject(v8::Local<v8::Object> val) {
+    if (!UpdateAndCheckUniqueness(val)) {
+      WriteTag(kTagNull);
+      return;
+    }
+
+    scoped_ptr<v8::Context::Scope> scope;
+    if (!val->CreationContext().IsEmpty() &&
+        val->CreationContext() != isolate_->GetCurrentContext())
+      scope.reset(new v8::Context::Scope(val->CreationContext()));
+
+    WriteTag(kTagObject);
+    v8::Local<v8::Array> property_names(val->GetOwnPropertyNames());
+    for (uint32 i = 0; i < property_names->Length(); ++i) {
+      v8::Local<v8::Value> key(property_names->Get(i));
+      if (!key->IsString() && !key->IsNumber()) {
+        NOTREACHED() << "Key \"" << *v8::String::Utf8Value(key) << "\" "
+                        "is neither a string nor a number";
+        continue;
+      }
+
+      // Skip all callbacks: crbug.com/139933
+      v8::Local<v8::String> name = key->ToString();
+      if (val->HasRealNamedCallbackProperty(name))
+        continue;
+
+      v8::TryCatch try_catch;
+      v8::Local<v8::Value> child = val->Get(key);
+      if (try_catch.HasCaught()) {
+        LOG(ERROR) << "Getter for property " << *v8::String::Utf8Value(name)
+                   << " threw an exception.";
+        child = v8::Null(isolate_);
+      }
+
+      // Skip properties whose values don't serialize, like JSON.stringify.
+      size_t offset = data_->size();
+      WriteString(name);
+      if (!WriteValue(child))
+        data_->resize(offset);
+    }
+    WriteTag(kTagEnd);
+  }
+
+  // Returns false if |handle| has been written before.
+  bool UpdateAndCheckUniqueness(v8::Local<v8::Object> handle) {
+    typedef HashToHandleMap::const_iterator Iterator;
+    int hash = handle->GetIdentityHash();
+    std::pair<Iterator, Iterator> range = unique_map_.equal_range(hash);
+    for (Iterator it = range.first; it != range.second; ++it) {
+      if (it->second == handle)
+        return false;
+    }
+    unique_map_.insert(std::make_pair(hash, handle));
+    return true;
+  }
+
+  v8::Isolate* isolate_;
+  std::string* data_;
+  V8ValueSerializer::BufferList* shared_buffers_;
+  size_t shared_size_;
+
+  typedef std::multimap<int, v8::Local<v8::Object>> HashToHandleMap;
+  HashToHandleMap unique_map_;
+
+  int max_recursion_depth_;
+
+  DISALLOW_COPY_AND_ASSIGN(Writer);
+};
+
+class Reader {
+ public:
+  Reader(v8::Isolate* isolate,
+         const std::string& data,
+         SharedBufferRegion* region)
+      : isolate_(isolate),
+        region_(region),
+        position_(data.data()),
+        end_(data.data() + data.size()),
+        max_recursion_depth_(kMaxRecursionDepth) {
+  }
+
+  bool ReadValue(v8::Local<v8::Value>* out) {
+    Tag tag;
+    return ReadTag(&tag) && ReadValueWithTag(tag, out);
+  }
+
+  // Reads an array and appends its elements to |out|, without creating the
+  // array itself.
+  bool ReadArrayElements(std::vector<v8::Local<v8::Value>>* out) {
+    Tag tag;
+    if (!ReadTag(&tag) || tag != kTagArray)
+      return false;
+    while (true) {
+      if (!ReadTag(&tag))
+        return false;
+      if (tag == kTagEnd)
+        break;
+      v8::Local<v8::Value> child;
+      if (!ReadValueWithTag(tag, &child))
+        return false;
+      out->push_back(child);
+    }
+    return true;
+  }
+
+  bool IsAtEnd() const { return position_ == end_; }
+
+ private:
+  bool ReadValueWithTag(Tag tag, v8::Local<v8::Value>* out) {
+    // The writer never goes deeper than this, so the data is broken.
+    if (--max_recursion_depth_ < 0)
+      return false;
+
+    bool success = true;
+    switch (tag) {
+      case kTagNull:
+        *out = v8::Null(isolate_);
+        break;
+      case kTagFalse:
+        *out = v8::False(isolate_);
+        break;
+      case kTagTrue:
+        *out = v8::True(isolate_);
+        break;
+      case kTagInt32: {
+        int32 number;
+        success = ReadRaw(&number, sizeof(number));
+        if (success)
+          *out = v8::Integer::New(isolate_, number);
+        break;
+      }
+      case kTagDouble: {
+        double number;
+        success = ReadRaw(&number, sizeof(number));
+        if (success)
+          *out = v8::Number::New(isolate_, number);
+        break;
+      }
+      case kTagString: {
+        v8::Local<v8::String> str;
+        success = ReadStringContent(&str);
+        if (success)
+          *out = str;
+        break;
+      }
+      case kTagBuffer: {
+        const char* bytes;
+        size_t length;
+        success = ReadBytes(&bytes, &length);
+        if (success)
+          *out = node::Buffer::Copy(isolate_, bytes, length).ToLocalChecked();
+        break;
+      }
+      case kTagSharedBuffer:
+        success = ReadSharedBuffer(out);
+        break;
+      case kTagArray:
+        success = ReadArray(out);
+        break;
+      case kTagObject:
+        success = ReadObject(out);
+        break;
+      default:
+        success = false;
+        break;
+    }
+
+    max_recursion_depth_++;
+    return success;
+  }
+
+  bool ReadSharedBuffer(v8::Local<v8::Value>* out) {
+    size_t offset, length;
+    if (!region_ || !ReadVarint(&offset) || !ReadVarint(&length) ||
+        offset > region_->size() || length > region_->size() - offset)
+      return false;
+
+    // The Buffer points into the region and keeps it alive.
+    region_->AddRef();
+    *out = node::Buffer::New(isolate_, region_->data() + offset, length,
+                             &ReleaseRegion, region_).ToLocalChecked();
+    return true;
+  }
+
+  bool ReadArray(v8::Local<v8::Value>* out) {
+    v8::Local<v8::Array> array = v8::Array::New(isolate_);
+    for (uint32 i = 0; ; ++i) {
+      Tag tag;
+      if (!ReadTag(&tag))
+        return false;
+      if (tag == kTagEnd)
+        break;
+      v8::Local<v8::Value> child;
+      if (!ReadValueWithTag(tag, &child))
+        return false;
+      array->Set(i, child);
+    }
+    *out = array;
+    return true;
+  }
+
+  bool ReadObject(v8::Local<v8::Value>* out) {
+    v8::Local<v8::Object> object = v8::Object::New(isolate_);
+    while (true) {
+      Tag tag;
+      if (!ReadTag(&tag))
+        return false;
+      if (tag == kTagEnd)
+        break;
+      v8::Local<v8::String> key;
+      v8::Local<v8::Value> child;
+      if (tag != kTagString || !ReadStringContent(&key) || !ReadValue(&child))
+        return false;
+      object->Set(key, child);
+    }
+    *out = object;
+    return true;
+  }
+
+  bool ReadTag(Tag* tag) {
+    if (position_ == end_)
+      return false;
+    *tag = static_cast<Tag>(static_cast<uint8>(*position_++));
+    return true;
+  }
+
+  bool ReadVarint(size_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (position_ == end_)
+        return false;
+      uint8 byte = static_cast<uint8>(*position_++);
+      *value |= static_cast<size_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  bool ReadRaw(void* out, size_t size) {
+    if (static_cast<size_t>(end_ - position_) < size)
+      return false;
+    memcpy(out, position_, size);
+    position_ += size;
+    return true;
+  }
+
+  bool ReadBytes(const char** bytes, size_t* length) {
+    if (!ReadVarint(length) ||
+        static_cast<size_t>(end_ - position_) < *length)
+      return false;
+    *bytes = position_;
+    position_ += *length;
+    return true;
+  }
+
+  bool ReadStringContent(v8::Local<v8::String>* out) {
+    const char* bytes;
+    size_t length;
+    if (!ReadBytes(&bytes, &length) || length > kint32max)
+      return false;
+    *out = v8::String::NewFromUtf8(isolate_, bytes,
+                                   v8::String::kNormalString,
+                                   static_cast<int>(length));
+    return !out->IsEmpty();
+  }
+
+  v8::Isolate* isolate_;
+  SharedBufferRegion* region_;
+  const char* position_;
+  const char* end_;
+
+  int max_recursion_depth_;
+
+  DISALLOW_COPY_AND_ASSIGN(Reader);
+};
+
+}  // namespace
+
+// static
+scoped_refptr<SharedBufferRegion> SharedBufferRegion::Map(
+    scoped_ptr<base::SharedMemory> memory, size_t size) {
+  if (!memory->Map(size))
+    return nullptr;
+  return make_scoped_refptr(new SharedBufferRegion(memory.Pass(), size));
+}
+
+// static
+scoped_refptr<SharedBufferRegion> SharedBufferRegion::CreateAnonymous(
+    size_t size) {
+  scoped_ptr<base::SharedMemory> memory(new base::SharedMemory);
+  if (!memory->CreateAndMapAnonymous(size))
+    return nullptr;
+  return make_scoped_refptr(new SharedBufferRegion(memory.Pass(), size));
+}
+
+SharedBufferRegion::SharedBufferRegion(scoped_ptr<base::SharedMemory> memory,
+                                       size_t size)
+    : memory_(memory.Pass()),
+      size_(size) {
+}
+
+SharedBufferRegion::~SharedBufferRegion() {
+}
+
+v8::Local<v8::Object> SharedBufferRegion::NewBuffer(v8::Isolate* isolate) {
+  AddRef();
+  return node::Buffer::New(isolate, data(), size_, &ReleaseRegion, this)
+      .ToLocalChecked();
+}
+
+bool SharedBufferRegion::ShareToProcess(base::ProcessHandle process,
+                                        base::SharedMemoryHandle* handle) {
+  return memory_->ShareToProcess(process, handle);
+}
+
+// Below this, copying the bytes is cheaper than setting up shared memory.
+const size_t V8ValueSerializer::kSharedBufferThreshold = 64 * 1024;
+
+// static
+bool V8ValueSerializer::Serialize(v8::Isolate* isolate,
+                                  v8::Local<v8::Value> value,
+                                  std::string* data,
+                                  BufferList* shared_buffers) {
+  v8::HandleScope handle_scope(isolate);
+  Writer writer(isolate, data, shared_buffers);
+  return writer.WriteValue(value);
+}
+
+// static
+size_t V8ValueSerializer::GetBuffersSize(const BufferList& buffers) {
+  size_t size = 0;
+  for (const base::StringPiece& buffer : buffers)
+    size += buffer.size();
+  return size;
+}
+
+// static
+void V8ValueSerializer::CopyBuffers(const BufferList& buffers, char* memory) {
+  for (const base::StringPiece& buffer : buffers) {
+    memcpy(memory, buffer.data(), buffer.size());
+    memory += buffer.size();
+  }
+}
+
+// static
+v8::Local<v8::Value> V8ValueSerializer::Deserialize(
+    v8::Isolate* isolate,
+    const std::string& data,
+    SharedBufferRegion* region) {
+  v8::EscapableHandleScope handle_scope(isolate);
+  Reader reader(isolate, data, region);
+  v8::Local<v8::Value> value;
+  if (!reader.ReadValue(&value) || !reader.IsAtEnd())
+    return v8::Local<v8::Value>();
+  return handle_scope.Escape(value);
+}
+
+// static
+bool V8ValueSerializer::DeserializeArray(
+    v8::Isolate* isolate,
+    const std::string& data,
+    SharedBufferRegion* region,
+    std::vector<v8::Local<v8::Value>>* result) {
+  Reader reader(isolate, data, region);
+  return reader.ReadArrayElements(result) && reader.IsAtEnd();
+}
+
+}  // namespace atom
@@ -0,0 +1,114 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_NATIVE_MATE_CONVERTERS_V8_VALUE_SERIALIZER_H_
+#define ATOM_COMMON_NATIVE_MATE_CONVERTERS_V8_VALUE_SERIALIZER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "base/strings/string_piece.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+// A mapped shared memory region that holds the large Buffers of a message.
+// The Buffers created from the region keep it alive.
+class SharedBufferRegion
+    : public base::RefCountedThreadSafe<SharedBufferRegion> {
+ public:
+  // Maps the first |size| bytes of |memory|, returns null on failure.
+  static scoped_refptr<SharedBufferRegion> Map(
+      scoped_ptr<base::SharedMemory> memory, size_t size);
+
+  // Creates a region of |size| bytes for passing Buffers within this
+  // process, returns null on failure.
+  static scoped_refptr<SharedBufferRegion> CreateAnonymous(size_t size);
+
+  char* data() const { return static_cast<char*>(memory_->memory()); }
+  size_t size() const { return size_; }
+
+  // Returns a Buffer of the whole region, which keeps the region alive.
+  v8::Local<v8::Object> NewBuffer(v8::Isolate* isolate);
+
+  // Duplicates the handle of the region for |process|.
+  bool ShareToProcess(base::ProcessHandle process,
+                      base::SharedMemoryHandle* handle);
+
+ private:
+  friend class base::RefCountedThreadSafe<SharedBufferRegion>;
+
+  SharedBufferRegion(scoped_ptr<base::SharedMemory> memory, size_t size);
+  ~SharedBufferRegion();
+
+  scoped_ptr<base::SharedMemory> memory_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedBufferRegion);
+};
+
+// Serializes V8 values into a compact binary format and back, without going
+// through base::Value. It is used to pass the arguments of ipc messages.
+//
+// The values are converted with the same rules as V8ValueConverter with its
+// default options, so the receiver gets the same values as if they were sent
+// as base::ListValue: undefined and functions are dropped from objects and
+// become null in arrays, Date and RegExp objects become plain objects, node
+// Buffers are kept as Buffers, and objects seen twice become null.
+//
+// The format is only meant to be read by the same version of Electron, it is
+// not stable.
+//
+// Buffers of at least kSharedBufferThreshold bytes can be left out of the
+// serialized data, the caller then copies them into shared memory in order
+// and the receiver creates Buffers that point into the mapped region.
+class V8ValueSerializer {
+ public:
+  typedef std::vector<base::StringPiece> BufferList;
+
+  static const size_t kSharedBufferThreshold;
+
+  // Appends |value| to |data|, returns false if |value| can not be
+  // serialized at all, i.e. it is undefined or a function.
+  //
+  // When |shared_buffers| is not null, the contents of large Buffers are
+  // appended to it instead of |data|. They point into the Buffers and are
+  // only valid while the Buffers are alive.
+  static bool Serialize(v8::Isolate* isolate,
+                        v8::Local<v8::Value> value,
+                        std::string* data,
+                        BufferList* shared_buffers = nullptr);
+
+  // Returns the total size of |buffers|.
+  static size_t GetBuffersSize(const BufferList& buffers);
+
+  // Copies |buffers| one after another into |memory|, which must be at least
+  // GetBuffersSize(buffers) bytes.
+  static void CopyBuffers(const BufferList& buffers, char* memory);
+
+  // Returns an empty handle if |data| is malformed. The Buffers that were
+  // left out of |data| are read from |region|.
+  static v8::Local<v8::Value> Deserialize(
+      v8::Isolate* isolate,
+      const std::string& data,
+      SharedBufferRegion* region = nullptr);
+
+  // Like Deserialize, but |data| must hold an array whose elements are
+  // appended to |result|. The values are created in the caller's HandleScope.
+  static bool DeserializeArray(v8::Isolate* isolate,
+                               const std::string& data,
+                               SharedBufferRegion* region,
+                               std::vector<v8::Local<v8::Value>>* result);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(V8ValueSerializer);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_NATIVE_MATE_CONVERTERS_V8_VALUE_SERIALIZER_H_
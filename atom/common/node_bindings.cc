@@ -4,22 +4,35 @@
 
 #include "atom/common/node_bindings.h"
 
+#include <stdlib.h>
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
 #include "atom/common/api/event_emitter_caller.h"
 #include "atom/common/api/locker.h"
 #include "atom/common/atom_command_line.h"
+#include "atom/common/event_loop_stats.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/node_includes.h"
+#include "atom/common/startup_timeline.h"
 #include "base/command_line.h"
 #include "base/base_paths.h"
+#include "base/environment.h"
 #include "base/files/file_path.h"
 #include "base/message_loop/message_loop.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/sys_info.h"
+#include "base/trace_event/trace_event.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/common/content_paths.h"
 #include "native_mate/dictionary.h"
+#include "third_party/WebKit/public/platform/Platform.h"
+#include "third_party/WebKit/public/platform/WebScheduler.h"
+#include "third_party/WebKit/public/platform/WebThread.h"
+#include "third_party/WebKit/public/platform/WebTraceLocation.h"
 #include "third_party/WebKit/public/web/WebScopedMicrotaskSuppression.h"
 
 using content::BrowserThread;
@@ -41,14 +54,17 @@ REFERENCE_MODULE(atom_browser_power_save_blocker);
 REFERENCE_MODULE(atom_browser_protocol);
 REFERENCE_MODULE(atom_browser_global_shortcut);
 REFERENCE_MODULE(atom_browser_session);
+REFERENCE_MODULE(atom_browser_shared_memory);
 REFERENCE_MODULE(atom_browser_tray);
 REFERENCE_MODULE(atom_browser_web_contents);
 REFERENCE_MODULE(atom_browser_web_view_manager);
 REFERENCE_MODULE(atom_browser_window);
+REFERENCE_MODULE(atom_browser_worker);
 REFERENCE_MODULE(atom_common_asar);
 REFERENCE_MODULE(atom_common_clipboard);
 REFERENCE_MODULE(atom_common_crash_reporter);
 REFERENCE_MODULE(atom_common_native_image);
+REFERENCE_MODULE(atom_common_profiler);
 REFERENCE_MODULE(atom_common_screen);
 REFERENCE_MODULE(atom_common_shell);
 REFERENCE_MODULE(atom_common_v8_util);
@@ -68,10 +84,112 @@ namespace atom {
 
 namespace {
 
+// Sets the time budget of each UvRunOnce in milliseconds, 0 runs uv loop only
+// once per wakeup.
+const char kUvRunBudgetEnvName[] = "ELECTRON_UV_RUN_BUDGET_MS";
+
+// Default time budget, which leaves a frame enough time to handle input and
+// paint.
+const int kDefaultUvRunBudgetMs = 4;
+
+base::TimeDelta GetUvRunBudget() {
+  scoped_ptr<base::Environment> env(base::Environment::Create());
+  std::string value;
+  int milliseconds;
+  if (!env->GetVar(kUvRunBudgetEnvName, &value) ||
+      !base::StringToInt(value, &milliseconds) || milliseconds < 0)
+    milliseconds = kDefaultUvRunBudgetMs;
+  return base::TimeDelta::FromMilliseconds(milliseconds);
+}
+
+// How long uv events may wait for an idle period before they are run anyway,
+// so a page that never goes idle still gets them.
+const int kMaxIdleDelayMs = 100;
+
+// The names of the policies in the node-scheduling option.
+const char* GetSchedulingPolicyName(NodeBindings::SchedulingPolicy policy) {
+  switch (policy) {
+    case NodeBindings::SCHEDULING_YIELD_TO_INPUT:
+      return "yield-to-input";
+    case NodeBindings::SCHEDULING_IDLE:
+      return "idle";
+    default:
+      return "normal";
+  }
+}
+
+// The size of libuv's threadpool, which libuv reads when the pool is first
+// used. Setting it in the environment overrides the size Electron picks.
+const char kUvThreadpoolSizeEnvName[] = "UV_THREADPOOL_SIZE";
+
+// The browser process gets a thread for each core within these bounds, the
+// lower one is libuv's default.
+const int kMinUvThreadpoolSize = 4;
+const int kMaxUvThreadpoolSize = 16;
+
 // Empty callback for async handle.
 void UvNoOp(uv_async_t* handle) {
 }
 
+void UvNoOpWork(uv_work_t* req) {
+}
+
+void UvNoOpAfterWork(uv_work_t* req, int status) {
+}
+
+void SetProcessEnv(const char* name, const std::string& value) {
+  // The CRT keeps its own copy of the environment on Windows, which is what
+  // libuv reads.
+#if defined(OS_WIN)
+  _putenv_s(name, value.c_str());
+#else
+  setenv(name, value.c_str(), 1);
+#endif
+}
+
+void UnsetProcessEnv(const char* name) {
+#if defined(OS_WIN)
+  _putenv_s(name, "");
+#else
+  unsetenv(name);
+#endif
+}
+
+// Sizes libuv's threadpool by the number of cores, unless the app has set it.
+// The pool is started right away, so the variable can be removed again before
+// child processes inherit it.
+void InitializeUvThreadpool() {
+  scoped_ptr<base::Environment> env(base::Environment::Create());
+  if (env->HasVar(kUvThreadpoolSizeEnvName))
+    return;
+
+  int size = std::min(std::max(base::SysInfo::NumberOfProcessors(),
+                               kMinUvThreadpoolSize),
+                      kMaxUvThreadpoolSize);
+  SetProcessEnv(kUvThreadpoolSizeEnvName, base::IntToString(size));
+  static uv_work_t req;
+  uv_queue_work(uv_default_loop(), &req, UvNoOpWork, UvNoOpAfterWork);
+  UnsetProcessEnv(kUvThreadpoolSizeEnvName);
+}
+
+// Passes the deadline of Blink's idle period on as TimeTicks, both are based
+// on the same monotonic clock.
+class UvRunIdleTask : public blink::WebThread::IdleTask {
+ public:
+  explicit UvRunIdleTask(const base::Callback<void(base::TimeTicks)>& callback)
+      : callback_(callback) {}
+
+  void run(double deadline_seconds) override {
+    callback_.Run(base::TimeTicks() + base::TimeDelta::FromMicroseconds(
+        deadline_seconds * base::Time::kMicrosecondsPerSecond));
+  }
+
+ private:
+  base::Callback<void(base::TimeTicks)> callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(UvRunIdleTask);
+};
+
 // Convert the given vector to an array of C-strings. The strings in the
 // returned vector are only guaranteed valid so long as the vector of strings
 // is not modified.
@@ -108,12 +226,19 @@ NodeBindings::NodeBindings(bool is_browser)
     : is_browser_(is_browser),
       message_loop_(nullptr),
       uv_loop_(uv_default_loop()),
+      uv_run_budget_(GetUvRunBudget()),
+      scheduling_policy_(SCHEDULING_NORMAL),
+      idle_run_pending_(false),
+      embed_thread_started_(false),
       embed_closed_(false),
       uv_env_(nullptr),
       weak_factory_(this) {
 }
 
 NodeBindings::~NodeBindings() {
+  if (!embed_thread_started_)
+    return;
+
   // Quit the embed thread.
   embed_closed_ = true;
   uv_sem_post(&embed_sem_);
@@ -140,6 +265,12 @@ void NodeBindings::Initialize() {
   // Init node.
   // (we assume node::Init would not modify the parameters under embedded mode).
   node::Init(nullptr, nullptr, nullptr, nullptr);
+
+  // The renderers keep libuv's default size, there are many of them and
+  // their fs work is light.
+  if (is_browser_)
+    InitializeUvThreadpool();
+  StartupTimeline::GetInstance()->Mark("nodeInitialized");
 }
 
 node::Environment* NodeBindings::CreateEnvironment(
@@ -166,15 +297,19 @@ node::Environment* NodeBindings::CreateEnvironment(
   mate::Dictionary process(context->GetIsolate(), env->process_object());
   process.Set("type", process_type);
   process.Set("resourcesPath", resources_path);
+  if (!is_browser_)
+    process.Set("nodeScheduling", GetSchedulingPolicyName(scheduling_policy_));
   // The path to helper app.
   base::FilePath helper_exec_path;
   PathService::Get(content::CHILD_PROCESS_EXE, &helper_exec_path);
   process.Set("helperExecPath", helper_exec_path);
+  StartupTimeline::GetInstance()->Mark("nodeEnvironmentCreated");
   return env;
 }
 
 void NodeBindings::LoadEnvironment(node::Environment* env) {
   node::LoadEnvironment(env);
+  StartupTimeline::GetInstance()->Mark("nodeEnvironmentLoaded");
   mate::EmitEvent(env->isolate(), env->process_object(), "loaded");
 }
 
@@ -185,9 +320,13 @@ void NodeBindings::PrepareMessageLoop() {
   // nothing to do.
   uv_async_init(uv_loop_, &dummy_uv_handle_, UvNoOp);
 
+  if (!ShouldUseEmbedThread())
+    return;
+
   // Start worker that will interrupt main loop when having uv events.
   uv_sem_init(&embed_sem_, 0);
   uv_thread_create(&embed_thread_, EmbedThreadRunner, this);
+  embed_thread_started_ = true;
 }
 
 void NodeBindings::RunMessageLoop() {
@@ -201,8 +340,24 @@ void NodeBindings::RunMessageLoop() {
 }
 
 void NodeBindings::UvRunOnce() {
+  UvRunUntil(base::TimeTicks());
+}
+
+void NodeBindings::UvRunUntil(base::TimeTicks deadline) {
   DCHECK(!is_browser_ || BrowserThread::CurrentlyOn(BrowserThread::UI));
 
+  base::TimeTicks start = base::TimeTicks::Now();
+  EventLoopStats* stats = EventLoopStats::GetInstance();
+  int64 wakeup_latency_us = 0;
+  if (!wakeup_time_.is_null()) {
+    base::TimeDelta latency = start - wakeup_time_;
+    stats->RecordWakeupLatency(latency);
+    wakeup_latency_us = latency.InMicroseconds();
+    wakeup_time_ = base::TimeTicks();
+  }
+  TRACE_EVENT_BEGIN1("electron.node", "NodeBindings::UvRunOnce",
+                     "wakeup_latency_us", wakeup_latency_us);
+
   // By default the global env would be used unless user specified another one
   // (this happens for renderer process, which wraps the uv loop with web page
   // context).
@@ -219,19 +374,81 @@ void NodeBindings::UvRunOnce() {
   scoped_ptr<blink::WebScopedRunV8Script> script_scope(
       is_browser_ ? nullptr : new blink::WebScopedRunV8Script(env->isolate()));
 
-  // Deal with uv events.
-  int r = uv_run(uv_loop_, UV_RUN_NOWAIT);
+  // Deal with uv events, and keep dealing with the events that arrive in the
+  // meantime until the budget is used up, instead of paying for a new wakeup
+  // and the scopes above for each of them. Input and frames pending in Blink
+  // end the slice early when the policy gives them priority.
+  if (deadline.is_null())
+    deadline = start + uv_run_budget_;
+  int r;
+  int runs = 0;
+  TakePolledEvents();
+  do {
+    r = uv_run(uv_loop_, UV_RUN_NOWAIT);
+    ++runs;
+  } while (r != 0 && uv_loop_->stop_flag == 0 &&
+           base::TimeTicks::Now() < deadline && HasPendingEvents() &&
+           !ShouldYield());
   if (r == 0 || uv_loop_->stop_flag != 0)
     message_loop_->QuitWhenIdle();  // Quit from uv.
 
+  stats->RecordSlice(base::TimeTicks::Now() - start, runs);
+  TRACE_EVENT_END1("electron.node", "NodeBindings::UvRunOnce", "runs", runs);
+
   // Tell the worker thread to continue polling.
-  uv_sem_post(&embed_sem_);
+  if (embed_thread_started_)
+    uv_sem_post(&embed_sem_);
+}
+
+bool NodeBindings::HasPendingEvents() {
+  // Due timers and idle handles make the timeout zero.
+  uv_update_time(uv_loop_);
+  return uv_backend_timeout(uv_loop_) == 0 || HasPendingIOEvents();
+}
+
+bool NodeBindings::ShouldYield() {
+  if (is_browser_ || scheduling_policy_ == SCHEDULING_NORMAL)
+    return false;
+  return blink::Platform::current()->currentThread()->scheduler()->
+      shouldYieldForHighPriorityWork();
+}
+
+void NodeBindings::PostIdleUvRun() {
+  if (idle_run_pending_)
+    return;
+  idle_run_pending_ = true;
+
+  base::Callback<void(base::TimeTicks)> run = base::Bind(
+      &NodeBindings::RunIdleUvRun, weak_factory_.GetWeakPtr());
+  blink::Platform::current()->currentThread()->scheduler()->postIdleTask(
+      blink::WebTraceLocation(__FUNCTION__, __FILE__),
+      new UvRunIdleTask(run));
+  message_loop_->PostDelayedTask(
+      FROM_HERE, base::Bind(run, base::TimeTicks()),
+      base::TimeDelta::FromMilliseconds(kMaxIdleDelayMs));
+}
+
+void NodeBindings::RunIdleUvRun(base::TimeTicks deadline) {
+  // Only the first of the idle task and the fallback runs uv loop.
+  if (!idle_run_pending_)
+    return;
+  idle_run_pending_ = false;
+  UvRunUntil(deadline);
+}
+
+bool NodeBindings::ShouldUseEmbedThread() {
+  return true;
 }
 
 void NodeBindings::WakeupMainThread() {
   DCHECK(message_loop_);
-  message_loop_->PostTask(FROM_HERE, base::Bind(&NodeBindings::UvRunOnce,
-                                                weak_factory_.GetWeakPtr()));
+  wakeup_time_ = base::TimeTicks::Now();
+  if (scheduling_policy_ == SCHEDULING_IDLE && !is_browser_)
+    message_loop_->PostTask(FROM_HERE, base::Bind(&NodeBindings::PostIdleUvRun,
+                                                  weak_factory_.GetWeakPtr()));
+  else
+    message_loop_->PostTask(FROM_HERE, base::Bind(&NodeBindings::UvRunOnce,
+                                                  weak_factory_.GetWeakPtr()));
 }
 
 void NodeBindings::WakeupEmbedThread() {
@@ -7,6 +7,7 @@
 
 #include "base/basictypes.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "v8/include/v8.h"
 #include "vendor/node/deps/uv/include/uv.h"
 
@@ -22,6 +23,17 @@ namespace atom {
 
 class NodeBindings {
  public:
+  // How uv events are scheduled against the other work of the renderer.
+  enum SchedulingPolicy {
+    // Runs uv loop as soon as it has events, until the budget is used up.
+    SCHEDULING_NORMAL,
+    // Like SCHEDULING_NORMAL, but stops early when input or a frame is
+    // pending.
+    SCHEDULING_YIELD_TO_INPUT,
+    // Runs uv loop in the idle periods between frames.
+    SCHEDULING_IDLE,
+  };
+
   static NodeBindings* Create(bool is_browser);
 
   virtual ~NodeBindings();
@@ -45,12 +57,29 @@ class NodeBindings {
   void set_uv_env(node::Environment* env) { uv_env_ = env; }
   node::Environment* uv_env() const { return uv_env_; }
 
+  // Sets how uv events are scheduled, only the renderer uses the policies
+  // other than SCHEDULING_NORMAL. Must be called before PrepareMessageLoop.
+  void set_scheduling_policy(SchedulingPolicy policy) {
+    scheduling_policy_ = policy;
+  }
+
  protected:
   explicit NodeBindings(bool is_browser);
 
+  // Whether to poll uv events in the embed thread, platforms that watch uv's
+  // backend fd in the main thread's message pump return false.
+  virtual bool ShouldUseEmbedThread();
+
   // Called to poll events in new thread.
   virtual void PollEvents() = 0;
 
+  // Returns whether uv's backend has IO events ready, without waiting.
+  virtual bool HasPendingIOEvents() = 0;
+
+  // Called in the main thread before running uv loop, to hand the events
+  // that PollEvents took from uv's backend over to uv loop.
+  virtual void TakePolledEvents() {}
+
   // Run the libuv loop for once.
   void UvRunOnce();
 
@@ -69,10 +98,39 @@ class NodeBindings {
   // Main thread's libuv loop.
   uv_loop_t* uv_loop_;
 
+  // When uv was found to have events, the following UvRunOnce records how
+  // long they waited for the main thread.
+  base::TimeTicks wakeup_time_;
+
  private:
   // Thread to poll uv events.
   static void EmbedThreadRunner(void *arg);
 
+  // Runs uv loop until |deadline|, or for the budget when it is null.
+  void UvRunUntil(base::TimeTicks deadline);
+
+  // Returns whether running uv loop again would have something to do.
+  bool HasPendingEvents();
+
+  // Returns whether Blink has input or a frame waiting for the main thread.
+  bool ShouldYield();
+
+  // Schedules UvRunUntil in the next idle period.
+  void PostIdleUvRun();
+  void RunIdleUvRun(base::TimeTicks deadline);
+
+  // How long UvRunOnce may keep running uv loop while there are pending
+  // events, so event storms are dealt with in fewer and larger slices.
+  base::TimeDelta uv_run_budget_;
+
+  SchedulingPolicy scheduling_policy_;
+
+  // Whether an idle run has been posted and has not run yet.
+  bool idle_run_pending_;
+
+  // Whether the embed thread has been started.
+  bool embed_thread_started_;
+
   // Whether the libuv loop has ended.
   bool embed_closed_;
 
@@ -8,9 +8,42 @@
 
 namespace atom {
 
+namespace {
+
+struct UvSource : public GSource {
+  NodeBindingsLinux* bindings;
+};
+
+gboolean UvSourcePrepare(GSource* source, gint* timeout_ms) {
+  *timeout_ms = static_cast<UvSource*>(source)->bindings->HandlePrepare();
+  return *timeout_ms == 0;
+}
+
+gboolean UvSourceCheck(GSource* source) {
+  return static_cast<UvSource*>(source)->bindings->HandleCheck();
+}
+
+gboolean UvSourceDispatch(GSource* source,
+                          GSourceFunc unused_func,
+                          gpointer unused_data) {
+  static_cast<UvSource*>(source)->bindings->HandleDispatch();
+  return TRUE;
+}
+
+GSourceFuncs g_uv_source_funcs = {
+  UvSourcePrepare,
+  UvSourceCheck,
+  UvSourceDispatch,
+  nullptr
+};
+
+}  // namespace
+
 NodeBindingsLinux::NodeBindingsLinux(bool is_browser)
     : NodeBindings(is_browser),
-      epoll_(epoll_create(1)) {
+      epoll_(epoll_create(1)),
+      uv_source_(nullptr),
+      watcher_queue_changed_(false) {
   int backend_fd = uv_backend_fd(uv_loop_);
   struct epoll_event ev = { 0 };
   ev.events = EPOLLIN;
@@ -19,6 +52,10 @@ NodeBindingsLinux::NodeBindingsLinux(bool is_browser)
 }
 
 NodeBindingsLinux::~NodeBindingsLinux() {
+  if (uv_source_) {
+    g_source_destroy(uv_source_);
+    g_source_unref(uv_source_);
+  }
 }
 
 void NodeBindingsLinux::RunMessageLoop() {
@@ -26,18 +63,71 @@ void NodeBindingsLinux::RunMessageLoop() {
   uv_loop_->data = this;
   uv_loop_->on_watcher_queue_updated = OnWatcherQueueChanged;
 
+  if (!ShouldUseEmbedThread()) {
+    // Let the message pump poll uv's backend fd together with its own fds,
+    // this saves a thread and a thread hop for every uv event.
+    uv_source_ = g_source_new(&g_uv_source_funcs, sizeof(UvSource));
+    static_cast<UvSource*>(uv_source_)->bindings = this;
+    uv_poll_fd_.fd = uv_backend_fd(uv_loop_);
+    uv_poll_fd_.events = G_IO_IN;
+    uv_poll_fd_.revents = 0;
+    g_source_add_poll(uv_source_, &uv_poll_fd_);
+    g_source_attach(uv_source_, g_main_context_default());
+  }
+
   NodeBindings::RunMessageLoop();
 }
 
+int NodeBindingsLinux::HandlePrepare() {
+  int timeout = 0;
+  if (!watcher_queue_changed_) {
+    uv_update_time(uv_loop_);
+    timeout = uv_backend_timeout(uv_loop_);
+  }
+  if (timeout == 0)
+    wakeup_time_ = base::TimeTicks::Now();
+  return timeout;
+}
+
+bool NodeBindingsLinux::HandleCheck() {
+  bool ready = watcher_queue_changed_ || (uv_poll_fd_.revents & G_IO_IN);
+  if (!ready) {
+    // Whether a timer is due.
+    uv_update_time(uv_loop_);
+    ready = uv_backend_timeout(uv_loop_) == 0;
+  }
+  if (ready && wakeup_time_.is_null())
+    wakeup_time_ = base::TimeTicks::Now();
+  return ready;
+}
+
+void NodeBindingsLinux::HandleDispatch() {
+  // The uv_run adds the new watchers to the backend fd.
+  watcher_queue_changed_ = false;
+  UvRunOnce();
+}
+
 // static
 void NodeBindingsLinux::OnWatcherQueueChanged(uv_loop_t* loop) {
   NodeBindingsLinux* self = static_cast<NodeBindingsLinux*>(loop->data);
 
+  // Without embed thread the change always happens on the main thread, so the
+  // source would see it when the message pump prepares for next poll.
+  if (!self->ShouldUseEmbedThread()) {
+    self->watcher_queue_changed_ = true;
+    return;
+  }
+
   // We need to break the io polling in the epoll thread when loop's watcher
   // queue changes, otherwise new events cannot be notified.
   self->WakeupEmbedThread();
 }
 
+bool NodeBindingsLinux::ShouldUseEmbedThread() {
+  // The renderer's main thread does not run a GLib message pump.
+  return !is_browser_;
+}
+
 void NodeBindingsLinux::PollEvents() {
   int timeout = uv_backend_timeout(uv_loop_);
 
@@ -49,6 +139,11 @@ void NodeBindingsLinux::PollEvents() {
   } while (r == -1 && errno == EINTR);
 }
 
+bool NodeBindingsLinux::HasPendingIOEvents() {
+  struct epoll_event ev;
+  return epoll_wait(epoll_, &ev, 1, 0) > 0;
+}
+
 // static
 NodeBindings* NodeBindings::Create(bool is_browser) {
   return new NodeBindingsLinux(is_browser);
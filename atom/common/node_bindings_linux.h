@@ -5,6 +5,8 @@
 #ifndef ATOM_COMMON_NODE_BINDINGS_LINUX_H_
 #define ATOM_COMMON_NODE_BINDINGS_LINUX_H_
 
+#include <glib.h>
+
 #include "base/compiler_specific.h"
 #include "atom/common/node_bindings.h"
 
@@ -17,15 +19,34 @@ class NodeBindingsLinux : public NodeBindings {
 
   void RunMessageLoop() override;
 
+  // Internal methods used for processing the callbacks of the GSource that
+  // watches uv's backend fd. They are public for simplicity but should not be
+  // used directly.
+  int HandlePrepare();
+  bool HandleCheck();
+  void HandleDispatch();
+
  private:
   // Called when uv's watcher queue changes.
   static void OnWatcherQueueChanged(uv_loop_t* loop);
 
+  // NodeBindings:
+  bool ShouldUseEmbedThread() override;
   void PollEvents() override;
+  bool HasPendingIOEvents() override;
 
   // Epoll to poll for uv's backend fd.
   int epoll_;
 
+  // In the browser process, the GLib message pump of the main thread watches
+  // uv's backend fd with this source, and no embed thread is used.
+  GSource* uv_source_;
+  GPollFD uv_poll_fd_;
+
+  // Whether uv's watcher queue has changed since the last uv_run, the new
+  // watchers are only added to the backend fd when uv_run polls.
+  bool watcher_queue_changed_;
+
   DISALLOW_COPY_AND_ASSIGN(NodeBindingsLinux);
 };
 
@@ -13,9 +13,19 @@
 
 namespace atom {
 
+namespace {
+
+// A fire date that is never reached, the timer is only fired by setting its
+// next fire date.
+const CFTimeInterval kDistantFuture = 1.0e10;
+
+}  // namespace
+
 NodeBindingsMac::NodeBindingsMac(bool is_browser)
     : NodeBindings(is_browser),
-      kqueue_(kqueue()) {
+      kqueue_(kqueue()),
+      watcher_queue_changed_(false),
+      in_uv_run_(false) {
   // Add uv's backend fd to kqueue.
   struct kevent ev;
   EV_SET(&ev, uv_backend_fd(uv_loop_), EVFILT_READ, EV_ADD | EV_ENABLE,
@@ -24,6 +34,14 @@ NodeBindingsMac::NodeBindingsMac(bool is_browser)
 }
 
 NodeBindingsMac::~NodeBindingsMac() {
+  if (backend_fd_source_)
+    CFRunLoopSourceInvalidate(backend_fd_source_);
+  if (backend_fd_)
+    CFFileDescriptorInvalidate(backend_fd_);
+  if (timer_)
+    CFRunLoopTimerInvalidate(timer_);
+  if (observer_)
+    CFRunLoopObserverInvalidate(observer_);
 }
 
 void NodeBindingsMac::RunMessageLoop() {
@@ -31,6 +49,34 @@ void NodeBindingsMac::RunMessageLoop() {
   uv_loop_->data = this;
   uv_loop_->on_watcher_queue_updated = OnWatcherQueueChanged;
 
+  if (!ShouldUseEmbedThread()) {
+    // Let the main thread's run loop watch uv's backend fd, this saves a
+    // thread and a thread hop for every uv event. The sources are added to
+    // the common modes so uv keeps running in nested loops like menus.
+    CFRunLoopRef run_loop = CFRunLoopGetCurrent();
+
+    CFFileDescriptorContext fd_context = { 0, this, NULL, NULL, NULL };
+    backend_fd_.reset(CFFileDescriptorCreate(
+        NULL, uv_backend_fd(uv_loop_), false, OnBackendFdReady, &fd_context));
+    CFFileDescriptorEnableCallBacks(backend_fd_, kCFFileDescriptorReadCallBack);
+    backend_fd_source_.reset(
+        CFFileDescriptorCreateRunLoopSource(NULL, backend_fd_, 0));
+    CFRunLoopAddSource(run_loop, backend_fd_source_, kCFRunLoopCommonModes);
+
+    CFRunLoopTimerContext timer_context = { 0, this, NULL, NULL, NULL };
+    timer_.reset(CFRunLoopTimerCreate(NULL, kDistantFuture, kDistantFuture, 0,
+                                      0, OnTimerFired, &timer_context));
+    CFRunLoopAddTimer(run_loop, timer_, kCFRunLoopCommonModes);
+
+    // The timers of uv can be changed by any task, so the timer is updated
+    // each time before the run loop sleeps.
+    CFRunLoopObserverContext observer_context = { 0, this, NULL, NULL, NULL };
+    observer_.reset(CFRunLoopObserverCreate(NULL, kCFRunLoopBeforeWaiting,
+                                            true, 0, OnBeforeWaiting,
+                                            &observer_context));
+    CFRunLoopAddObserver(run_loop, observer_, kCFRunLoopCommonModes);
+  }
+
   NodeBindings::RunMessageLoop();
 }
 
@@ -38,11 +84,78 @@ void NodeBindingsMac::RunMessageLoop() {
 void NodeBindingsMac::OnWatcherQueueChanged(uv_loop_t* loop) {
   NodeBindingsMac* self = static_cast<NodeBindingsMac*>(loop->data);
 
+  // Without embed thread the change always happens on the main thread, so the
+  // timer would fire before the run loop sleeps next time.
+  if (!self->ShouldUseEmbedThread()) {
+    self->watcher_queue_changed_ = true;
+    return;
+  }
+
   // We need to break the io polling in the kqueue thread when loop's watcher
   // queue changes, otherwise new events cannot be notified.
   self->WakeupEmbedThread();
 }
 
+// static
+void NodeBindingsMac::OnBackendFdReady(CFFileDescriptorRef fd,
+                                       CFOptionFlags flags,
+                                       void* info) {
+  static_cast<NodeBindingsMac*>(info)->HandleUvEvents();
+}
+
+// static
+void NodeBindingsMac::OnTimerFired(CFRunLoopTimerRef timer, void* info) {
+  static_cast<NodeBindingsMac*>(info)->HandleUvEvents();
+}
+
+// static
+void NodeBindingsMac::OnBeforeWaiting(CFRunLoopObserverRef observer,
+                                      CFRunLoopActivity activity,
+                                      void* info) {
+  static_cast<NodeBindingsMac*>(info)->UpdateTimer();
+}
+
+void NodeBindingsMac::HandleUvEvents() {
+  // JavaScript can run a nested run loop, like the one of a menu, from inside
+  // uv_run, which is not reentrant. The outer call rearms the sources when it
+  // returns.
+  if (in_uv_run_)
+    return;
+
+  // The uv_run adds the new watchers to the backend fd.
+  watcher_queue_changed_ = false;
+  wakeup_time_ = base::TimeTicks::Now();
+  in_uv_run_ = true;
+  UvRunOnce();
+  in_uv_run_ = false;
+
+  // CFFileDescriptor disables its callbacks each time it calls them.
+  CFFileDescriptorEnableCallBacks(backend_fd_, kCFFileDescriptorReadCallBack);
+  UpdateTimer();
+}
+
+void NodeBindingsMac::UpdateTimer() {
+  // The timer would keep firing in a nested run loop.
+  if (in_uv_run_) {
+    CFRunLoopTimerSetNextFireDate(timer_, kDistantFuture);
+    return;
+  }
+
+  int timeout = 0;
+  if (!watcher_queue_changed_) {
+    uv_update_time(uv_loop_);
+    timeout = uv_backend_timeout(uv_loop_);
+  }
+  CFAbsoluteTime fire_date = timeout == -1 ?
+      kDistantFuture : CFAbsoluteTimeGetCurrent() + timeout / 1000.0;
+  CFRunLoopTimerSetNextFireDate(timer_, fire_date);
+}
+
+bool NodeBindingsMac::ShouldUseEmbedThread() {
+  // The renderer's main thread does not run a CFRunLoop based message pump.
+  return !is_browser_;
+}
+
 void NodeBindingsMac::PollEvents() {
   struct timespec spec;
   int timeout = uv_backend_timeout(uv_loop_);
@@ -60,6 +173,12 @@ void NodeBindingsMac::PollEvents() {
   } while (r == -1 && errno == EINTR);
 }
 
+bool NodeBindingsMac::HasPendingIOEvents() {
+  struct timespec spec = { 0, 0 };
+  struct kevent ev;
+  return ::kevent(kqueue_, NULL, 0, &ev, 1, &spec) > 0;
+}
+
 // static
 NodeBindings* NodeBindings::Create(bool is_browser) {
   return new NodeBindingsMac(is_browser);
@@ -5,8 +5,11 @@
 #ifndef ATOM_COMMON_NODE_BINDINGS_MAC_H_
 #define ATOM_COMMON_NODE_BINDINGS_MAC_H_
 
+#include <CoreFoundation/CoreFoundation.h>
+
 #include "atom/common/node_bindings.h"
 #include "base/compiler_specific.h"
+#include "base/mac/scoped_cftyperef.h"
 
 namespace atom {
 
@@ -21,11 +24,45 @@ class NodeBindingsMac : public NodeBindings {
   // Called when uv's watcher queue changes.
   static void OnWatcherQueueChanged(uv_loop_t* loop);
 
+  // Callbacks of the run loop sources that watch uv in the browser process.
+  static void OnBackendFdReady(CFFileDescriptorRef fd,
+                               CFOptionFlags flags,
+                               void* info);
+  static void OnTimerFired(CFRunLoopTimerRef timer, void* info);
+  static void OnBeforeWaiting(CFRunLoopObserverRef observer,
+                              CFRunLoopActivity activity,
+                              void* info);
+
+  // Runs uv loop and rearms the run loop sources.
+  void HandleUvEvents();
+
+  // Makes the timer fire when uv's next timer is due, or right away when uv
+  // has something to do.
+  void UpdateTimer();
+
+  // NodeBindings:
+  bool ShouldUseEmbedThread() override;
   void PollEvents() override;
+  bool HasPendingIOEvents() override;
 
   // Kqueue to poll for uv's backend fd.
   int kqueue_;
 
+  // In the browser process, the main thread's CFRunLoop watches uv's backend
+  // fd and timeout with these, and no embed thread is used.
+  base::ScopedCFTypeRef<CFFileDescriptorRef> backend_fd_;
+  base::ScopedCFTypeRef<CFRunLoopSourceRef> backend_fd_source_;
+  base::ScopedCFTypeRef<CFRunLoopTimerRef> timer_;
+  base::ScopedCFTypeRef<CFRunLoopObserverRef> observer_;
+
+  // Whether uv's watcher queue has changed since the last uv_run, the new
+  // watchers are only added to the backend fd when uv_run polls.
+  bool watcher_queue_changed_;
+
+  // Whether HandleUvEvents is running uv_run, the sources it is called by
+  // can fire again in nested run loops.
+  bool in_uv_run_;
+
   DISALLOW_COPY_AND_ASSIGN(NodeBindingsMac);
 };
 
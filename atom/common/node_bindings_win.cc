@@ -4,16 +4,22 @@
 
 #include "atom/common/node_bindings_win.h"
 
-#include <windows.h>
-
 #include "base/logging.h"
 
 extern "C" {
 #include "vendor/node/deps/uv/src/win/internal.h"
+#include "vendor/node/deps/uv/src/win/req-inl.h"
 }
 
 namespace atom {
 
+namespace {
+
+// The most completions taken at once, the same as uv's own poll.
+const ULONG kMaxCompletions = 128;
+
+}  // namespace
+
 NodeBindingsWin::NodeBindingsWin(bool is_browser)
     : NodeBindings(is_browser) {
 }
@@ -21,27 +27,72 @@ NodeBindingsWin::NodeBindingsWin(bool is_browser)
 NodeBindingsWin::~NodeBindingsWin() {
 }
 
+ULONG NodeBindingsWin::DequeueCompletions(OVERLAPPED_ENTRY* entries,
+                                          ULONG count,
+                                          DWORD timeout) {
+  // The batched version is not available on Windows XP.
+  if (pGetQueuedCompletionStatusEx) {
+    ULONG taken = 0;
+    if (!pGetQueuedCompletionStatusEx(uv_loop_->iocp, entries, count, &taken,
+                                      timeout, FALSE))
+      return 0;
+    return taken;
+  }
+
+  OVERLAPPED_ENTRY& entry = entries[0];
+  entry.lpOverlapped = NULL;
+  GetQueuedCompletionStatus(uv_loop_->iocp,
+                            &entry.dwNumberOfBytesTransferred,
+                            &entry.lpCompletionKey,
+                            &entry.lpOverlapped,
+                            timeout);
+  return entry.lpOverlapped ? 1 : 0;
+}
+
+void NodeBindingsWin::InsertPendingRequests(const OVERLAPPED_ENTRY* entries,
+                                            ULONG count) {
+  // This is what uv's poll does with the completions, the results are kept
+  // in the OVERLAPPED of the requests.
+  for (ULONG i = 0; i < count; ++i) {
+    if (entries[i].lpOverlapped)
+      uv_insert_pending_req(uv_loop_,
+                            uv_overlapped_to_req(entries[i].lpOverlapped));
+  }
+}
+
 void NodeBindingsWin::PollEvents() {
   // If there are other kinds of events pending, uv_backend_timeout will
   // instruct us not to wait.
-  DWORD bytes, timeout;
-  ULONG_PTR key;
-  OVERLAPPED* overlapped;
+  DWORD timeout = uv_backend_timeout(uv_loop_);
 
-  timeout = uv_backend_timeout(uv_loop_);
+  // Keep the completions instead of giving them back to the IOCP, the main
+  // thread hands them to uv loop directly.
+  OVERLAPPED_ENTRY entries[kMaxCompletions];
+  ULONG count = DequeueCompletions(entries, kMaxCompletions, timeout);
+  if (count == 0)
+    return;
 
-  GetQueuedCompletionStatus(uv_loop_->iocp,
-                            &bytes,
-                            &key,
-                            &overlapped,
-                            timeout);
+  base::AutoLock auto_lock(polled_lock_);
+  polled_.insert(polled_.end(), entries, entries + count);
+}
+
+bool NodeBindingsWin::HasPendingIOEvents() {
+  // Called in the main thread, so the completions can go to uv loop right
+  // away.
+  OVERLAPPED_ENTRY entries[kMaxCompletions];
+  ULONG count = DequeueCompletions(entries, kMaxCompletions, 0);
+  InsertPendingRequests(entries, count);
+  return count > 0;
+}
 
-  // Give the event back so libuv can deal with it.
-  if (overlapped != NULL)
-    PostQueuedCompletionStatus(uv_loop_->iocp,
-                               bytes,
-                               key,
-                               overlapped);
+void NodeBindingsWin::TakePolledEvents() {
+  std::vector<OVERLAPPED_ENTRY> polled;
+  {
+    base::AutoLock auto_lock(polled_lock_);
+    polled.swap(polled_);
+  }
+  if (!polled.empty())
+    InsertPendingRequests(&polled.front(), polled.size());
 }
 
 // static
@@ -5,8 +5,13 @@
 #ifndef ATOM_COMMON_NODE_BINDINGS_WIN_H_
 #define ATOM_COMMON_NODE_BINDINGS_WIN_H_
 
+#include <windows.h>
+
+#include <vector>
+
 #include "atom/common/node_bindings.h"
 #include "base/compiler_specific.h"
+#include "base/synchronization/lock.h"
 
 namespace atom {
 
@@ -16,7 +21,24 @@ class NodeBindingsWin : public NodeBindings {
   virtual ~NodeBindingsWin();
 
  private:
+  // Takes the ready completions from uv's IOCP, without waiting longer than
+  // |timeout|, and returns the number taken.
+  ULONG DequeueCompletions(OVERLAPPED_ENTRY* entries, ULONG count,
+                           DWORD timeout);
+
+  // Adds the completions to uv loop's pending requests, so uv_run deals with
+  // them without polling the IOCP again. Must be called in the main thread.
+  void InsertPendingRequests(const OVERLAPPED_ENTRY* entries, ULONG count);
+
+  // NodeBindings:
   void PollEvents() override;
+  bool HasPendingIOEvents() override;
+  void TakePolledEvents() override;
+
+  // The completions PollEvents took in the embed thread, for the main thread
+  // to hand them to uv loop.
+  base::Lock polled_lock_;
+  std::vector<OVERLAPPED_ENTRY> polled_;
 
   DISALLOW_COPY_AND_ASSIGN(NodeBindingsWin);
 };
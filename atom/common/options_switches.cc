@@ -81,6 +81,15 @@ const char kPreloadScript[] = "preload";
 // Like --preload, but the passed argument is an URL.
 const char kPreloadUrl[] = "preload-url";
 
+// Share the renderer process with the windows of the same site.
+const char kShareRendererProcess[] = "share-renderer-process";
+
+// How the renderer schedules Node's events against input and frames.
+const char kNodeScheduling[] = "node-scheduling";
+
+// Throttle the page when the window can not be seen.
+const char kBackgroundThrottling[] = "background-throttling";
+
 // Whether the window should be transparent.
 const char kTransparent[] = "transparent";
 
@@ -96,6 +105,15 @@ const char kStandardWindow[] = "standard-window";
 // Default browser window background color.
 const char kBackgroundColor[] = "background-color";
 
+// Render the page in a window that can not be seen.
+const char kOffscreen[] = "offscreen";
+
+// The frames per second an offscreen window paints.
+const char kFrameRate[] = "frame-rate";
+
+// Emits the resize and move events of the window at most once a frame.
+const char kCoalesceBoundsEvents[] = "coalesce-bounds-events";
+
 // Path to client certificate.
 const char kClientCertificate[] = "client-certificate";
 
@@ -43,11 +43,17 @@ extern const char kPpapiFlashVersion[];
 extern const char kGuestInstanceID[];
 extern const char kPreloadScript[];
 extern const char kPreloadUrl[];
+extern const char kShareRendererProcess[];
+extern const char kNodeScheduling[];
+extern const char kBackgroundThrottling[];
 extern const char kTransparent[];
 extern const char kType[];
 extern const char kDisableAutoHideCursor[];
 extern const char kStandardWindow[];
 extern const char kBackgroundColor[];
+extern const char kOffscreen[];
+extern const char kFrameRate[];
+extern const char kCoalesceBoundsEvents[];
 extern const char kClientCertificate[];
 
 extern const char kExperimentalFeatures[];
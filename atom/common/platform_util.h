@@ -5,6 +5,8 @@
 #ifndef ATOM_COMMON_PLATFORM_UTIL_H_
 #define ATOM_COMMON_PLATFORM_UTIL_H_
 
+#include <vector>
+
 class GURL;
 
 namespace base {
@@ -28,6 +30,10 @@ bool OpenExternal(const GURL& url);
 // Move a file to trash.
 bool MoveItemToTrash(const base::FilePath& full_path);
 
+// Move files to trash, in a single operation where the platform has one.
+// Returns false if any of them could not be moved.
+bool MoveItemsToTrash(const std::vector<base::FilePath>& full_paths);
+
 void Beep();
 
 }  // namespace platform_util
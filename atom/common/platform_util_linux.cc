@@ -6,6 +6,9 @@
 
 #include <stdio.h>
 
+#include <string>
+#include <vector>
+
 #include "base/files/file_util.h"
 #include "base/process/kill.h"
 #include "base/process/launch.h"
@@ -13,10 +16,10 @@
 
 namespace {
 
-bool XDGUtil(const std::string& util, const std::string& arg) {
+bool XDGUtil(const std::string& util, const std::vector<std::string>& args) {
   std::vector<std::string> argv;
   argv.push_back(util);
-  argv.push_back(arg);
+  argv.insert(argv.end(), args.begin(), args.end());
 
   base::LaunchOptions options;
   options.allow_new_privs = true;
@@ -37,6 +40,10 @@ bool XDGUtil(const std::string& util, const std::string& arg) {
   return (exit_code == 0);
 }
 
+bool XDGUtil(const std::string& util, const std::string& arg) {
+  return XDGUtil(util, std::vector<std::string>(1, arg));
+}
+
 bool XDGOpen(const std::string& path) {
   return XDGUtil("xdg-open", path);
 }
@@ -75,6 +82,16 @@ bool MoveItemToTrash(const base::FilePath& full_path) {
   return XDGUtil("gvfs-trash", full_path.value());
 }
 
+bool MoveItemsToTrash(const std::vector<base::FilePath>& full_paths) {
+  if (full_paths.empty())
+    return true;
+  // gvfs-trash takes any number of files.
+  std::vector<std::string> args;
+  for (const base::FilePath& path : full_paths)
+    args.push_back(path.value());
+  return XDGUtil("gvfs-trash", args);
+}
+
 void Beep() {
   // echo '\a' > /dev/console
   FILE* console = fopen("/dev/console", "r");
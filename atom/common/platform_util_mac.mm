@@ -151,6 +151,14 @@ bool MoveItemToTrash(const base::FilePath& full_path) {
   return status;
 }
 
+bool MoveItemsToTrash(const std::vector<base::FilePath>& full_paths) {
+  // NSFileManager moves one item at a time.
+  bool success = true;
+  for (const base::FilePath& path : full_paths)
+    success = MoveItemToTrash(path) && success;
+  return success;
+}
+
 void Beep() {
   NSBeep();
 }
@@ -10,6 +10,8 @@
 #include <shellapi.h>
 #include <shlobj.h>
 
+#include <string>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/files/file_path.h"
@@ -170,16 +172,25 @@ bool OpenExternal(const GURL& url) {
 }
 
 bool MoveItemToTrash(const base::FilePath& path) {
-  // SHFILEOPSTRUCT wants the path to be terminated with two NULLs,
-  // so we have to use wcscpy because wcscpy_s writes non-NULLs
-  // into the rest of the buffer.
-  wchar_t double_terminated_path[MAX_PATH + 1] = {0};
-#pragma warning(suppress:4996)  // don't complain about wcscpy deprecation
-  wcscpy(double_terminated_path, path.value().c_str());
+  return MoveItemsToTrash(std::vector<base::FilePath>(1, path));
+}
+
+bool MoveItemsToTrash(const std::vector<base::FilePath>& paths) {
+  if (paths.empty())
+    return true;
+
+  // SHFILEOPSTRUCT takes the paths separated by NULLs and terminated with two
+  // NULLs, so all of them are moved in one operation.
+  std::wstring from;
+  for (const base::FilePath& path : paths) {
+    from.append(path.value());
+    from.push_back(L'\0');
+  }
+  from.push_back(L'\0');
 
   SHFILEOPSTRUCT file_operation = {0};
   file_operation.wFunc = FO_DELETE;
-  file_operation.pFrom = double_terminated_path;
+  file_operation.pFrom = from.c_str();
   file_operation.fFlags = FOF_ALLOWUNDO | FOF_SILENT | FOF_NOCONFIRMATION;
   int err = SHFileOperation(&file_operation);
 
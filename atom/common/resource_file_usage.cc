@@ -0,0 +1,181 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/resource_file_usage.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/lazy_instance.h"
+#include "base/values.h"
+
+#if defined(OS_POSIX)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<base::FilePath> g_resource_pack_dir =
+    LAZY_INSTANCE_INITIALIZER;
+
+// The layout of ui::DataPack version 4: the version, the count of resources
+// and the text encoding, followed by |count + 1| entries, of which the last
+// one marks where the data of the last resource ends.
+const uint32 kPakFileVersion = 4;
+const size_t kPakHeaderSize = 2 * sizeof(uint32) + sizeof(uint8);
+
+#pragma pack(push, 2)
+struct PakEntry {
+  uint16 resource_id;
+  uint32 file_offset;
+};
+#pragma pack(pop)
+
+// Maps a file without touching it, and tells which of its pages are in the
+// page cache.
+class MappedFile {
+ public:
+  explicit MappedFile(const base::FilePath& path) : page_size_(0) {
+    if (!file_.Initialize(path))
+      return;
+#if defined(OS_POSIX)
+    // Queried before anything is read through the mapping, which would page
+    // it in.
+    page_size_ = sysconf(_SC_PAGESIZE);
+    pages_.resize((file_.length() + page_size_ - 1) / page_size_);
+    if (file_.length() == 0 ||
+        mincore(const_cast<uint8*>(file_.data()), file_.length(),
+                &pages_[0]) != 0)
+      pages_.clear();
+#endif
+  }
+
+  bool IsValid() const { return file_.IsValid(); }
+  bool HasResidency() const { return !pages_.empty(); }
+  const uint8* data() const { return file_.data(); }
+  size_t length() const { return file_.length(); }
+
+  // Returns the bytes of [offset, offset + size) that are in memory.
+  double ResidentBytes(size_t offset, size_t size) const {
+    size_t end = std::min(offset + size, file_.length());
+    double resident = 0;
+    for (size_t start = offset; start < end;) {
+      size_t page = start / page_size_;
+      size_t page_end = std::min((page + 1) * page_size_, end);
+      if (pages_[page] & 1)
+        resident += page_end - start;
+      start = page_end;
+    }
+    return resident;
+  }
+
+ private:
+  base::MemoryMappedFile file_;
+  size_t page_size_;
+#if defined(OS_MACOSX)
+  std::vector<char> pages_;
+#else
+  std::vector<unsigned char> pages_;
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+base::DictionaryValue* FileUsageToValue(const base::FilePath& path,
+                                        const char* type,
+                                        const MappedFile& file) {
+  base::DictionaryValue* value = new base::DictionaryValue;
+  value->SetString("path", path.AsUTF8Unsafe());
+  value->SetString("type", type);
+  value->SetDouble("size", file.length());
+  if (file.HasResidency())
+    value->SetDouble("residentSize", file.ResidentBytes(0, file.length()));
+  return value;
+}
+
+base::DictionaryValue* PakUsageToValue(const base::FilePath& path) {
+  MappedFile file(path);
+  if (!file.IsValid())
+    return nullptr;
+  base::DictionaryValue* value = FileUsageToValue(path, "pak", file);
+
+  const uint8* data = file.data();
+  size_t length = file.length();
+  if (length < kPakHeaderSize ||
+      reinterpret_cast<const uint32*>(data)[0] != kPakFileVersion)
+    return value;
+  uint32 count = reinterpret_cast<const uint32*>(data)[1];
+  if ((length - kPakHeaderSize) / sizeof(PakEntry) < count + 1)
+    return value;
+
+  const PakEntry* entries =
+      reinterpret_cast<const PakEntry*>(data + kPakHeaderSize);
+  base::ListValue* resources = new base::ListValue;
+  for (uint32 i = 0; i < count; ++i) {
+    size_t offset = entries[i].file_offset;
+    size_t end = entries[i + 1].file_offset;
+    if (end < offset || end > length)
+      break;
+    base::DictionaryValue* resource = new base::DictionaryValue;
+    resource->SetInteger("id", entries[i].resource_id);
+    resource->SetDouble("size", end - offset);
+    if (file.HasResidency())
+      resource->SetDouble("residentSize",
+                          file.ResidentBytes(offset, end - offset));
+    resources->Append(resource);
+  }
+  value->Set("resources", resources);
+  return value;
+}
+
+void AppendFiles(const base::FilePath& dir,
+                 const base::FilePath::StringType& pattern,
+                 std::vector<base::FilePath>* files) {
+  base::FileEnumerator enumerator(dir, false, base::FileEnumerator::FILES,
+                                  pattern);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next())
+    files->push_back(path);
+}
+
+}  // namespace
+
+void SetResourcePackDir(const base::FilePath& dir) {
+  g_resource_pack_dir.Get() = dir;
+}
+
+scoped_ptr<base::ListValue> GetResourceFileUsage(
+    const base::FilePath& resources_path) {
+  scoped_ptr<base::ListValue> list(new base::ListValue);
+
+  std::vector<base::FilePath> paks;
+  const base::FilePath& pack_dir = g_resource_pack_dir.Get();
+  if (!pack_dir.empty()) {
+    AppendFiles(pack_dir, FILE_PATH_LITERAL("*.pak"), &paks);
+    AppendFiles(pack_dir.Append(FILE_PATH_LITERAL("locales")),
+                FILE_PATH_LITERAL("*.pak"), &paks);
+  }
+  for (const base::FilePath& path : paks) {
+    base::DictionaryValue* value = PakUsageToValue(path);
+    if (value)
+      list->Append(value);
+  }
+
+  std::vector<base::FilePath> archives;
+  AppendFiles(resources_path, FILE_PATH_LITERAL("*.asar"), &archives);
+  for (const base::FilePath& path : archives) {
+    MappedFile file(path);
+    if (file.IsValid())
+      list->Append(FileUsageToValue(path, "asar", file));
+  }
+  return list.Pass();
+}
+
+}  // namespace atom
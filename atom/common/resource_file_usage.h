@@ -0,0 +1,33 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_RESOURCE_FILE_USAGE_H_
+#define ATOM_COMMON_RESOURCE_FILE_USAGE_H_
+
+#include "base/memory/scoped_ptr.h"
+
+namespace base {
+class FilePath;
+class ListValue;
+}
+
+namespace atom {
+
+// Remembers the directory of the .pak files loaded by the resource bundle.
+void SetResourcePackDir(const base::FilePath& dir);
+
+// The resource packs and archives are memory mapped read-only, so their pages
+// are shared by all processes and only read from disk when first touched.
+// This returns one entry for each .pak file in the directory of the resource
+// packs and its "locales" directory, and for each .asar archive in
+// |resources_path|, with how many of their bytes are in memory. The entries
+// of resource packs also list their resources.
+//
+// This does file IO.
+scoped_ptr<base::ListValue> GetResourceFileUsage(
+    const base::FilePath& resources_path);
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_RESOURCE_FILE_USAGE_H_
@@ -0,0 +1,72 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/startup_timeline.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/lazy_instance.h"
+#include "base/trace_event/trace_event.h"
+#include "base/values.h"
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<StartupTimeline> g_startup_timeline =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// static
+StartupTimeline* StartupTimeline::GetInstance() {
+  return g_startup_timeline.Pointer();
+}
+
+StartupTimeline::StartupTimeline() {
+}
+
+StartupTimeline::~StartupTimeline() {
+}
+
+void StartupTimeline::Mark(const char* name) {
+  MarkAt(name, base::TimeTicks::Now());
+}
+
+void StartupTimeline::MarkAt(const char* name, base::TimeTicks time) {
+  {
+    base::AutoLock auto_lock(lock_);
+    for (const Milestone& milestone : milestones_)
+      if (std::string(milestone.name) == name)
+        return;
+    Milestone milestone = { name, time };
+    milestones_.push_back(milestone);
+  }
+  TRACE_EVENT_INSTANT0("electron.startup", name, TRACE_EVENT_SCOPE_PROCESS);
+}
+
+scoped_ptr<base::ListValue> StartupTimeline::ToValue() const {
+  std::vector<Milestone> milestones;
+  {
+    base::AutoLock auto_lock(lock_);
+    milestones = milestones_;
+  }
+  std::stable_sort(milestones.begin(), milestones.end(),
+                   [](const Milestone& a, const Milestone& b) {
+                     return a.time < b.time;
+                   });
+
+  scoped_ptr<base::ListValue> list(new base::ListValue);
+  for (const Milestone& milestone : milestones) {
+    base::DictionaryValue* value = new base::DictionaryValue;
+    value->SetString("name", milestone.name);
+    value->SetDouble("time",
+                     (milestone.time - milestones[0].time).InMillisecondsF());
+    list->Append(value);
+  }
+  return list.Pass();
+}
+
+}  // namespace atom
@@ -0,0 +1,62 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_STARTUP_TIMELINE_H_
+#define ATOM_COMMON_STARTUP_TIMELINE_H_
+
+#include <vector>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace base {
+class ListValue;
+}
+
+namespace atom {
+
+// The times at which the current process reached the milestones of its
+// startup. Only the first time of each milestone is kept, so the ones that
+// happen again, like windows being created, are only recorded once.
+//
+// Each milestone is also added as an instant trace event of the
+// "electron.startup" category, which is recorded with --trace-startup.
+class StartupTimeline {
+ public:
+  // Returns the timeline of current process.
+  static StartupTimeline* GetInstance();
+
+  StartupTimeline();
+  ~StartupTimeline();
+
+  // Records that |name| has been reached now, |name| must be a string
+  // literal.
+  void Mark(const char* name);
+
+  // Records that |name| has been reached at |time|, used for the milestones
+  // reached by other processes.
+  void MarkAt(const char* name, base::TimeTicks time);
+
+  // Returns the milestones in the order they were reached, each with the
+  // milliseconds since the first one.
+  scoped_ptr<base::ListValue> ToValue() const;
+
+ private:
+  struct Milestone {
+    const char* name;
+    base::TimeTicks time;
+  };
+
+  // Milestones are recorded on the main thread and the threads of the
+  // browser main parts.
+  mutable base::Lock lock_;
+  std::vector<Milestone> milestones_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTimeline);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_STARTUP_TIMELINE_H_
@@ -2,21 +2,36 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <string>
+
 #include "atom/common/api/api_messages.h"
+#include "atom/common/ipc_channel_stats.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
+#include "atom/renderer/atom_render_view_observer.h"
+#include "base/lazy_instance.h"
+#include "base/process/process_handle.h"
+#include "base/trace_event/trace_event.h"
+#include "base/values.h"
+#include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/render_view.h"
 #include "native_mate/dictionary.h"
 #include "third_party/WebKit/public/web/WebLocalFrame.h"
 #include "third_party/WebKit/public/web/WebView.h"
 
+using atom::IPCChannelStats;
+using atom::V8ValueSerializer;
 using content::RenderView;
 using blink::WebLocalFrame;
 using blink::WebView;
 
 namespace {
 
+// The counters of the messages sent by this process.
+base::LazyInstance<IPCChannelStats> g_stats = LAZY_INSTANCE_INITIALIZER;
+
 RenderView* GetCurrentRenderView() {
   WebLocalFrame* frame = WebLocalFrame::frameForCurrentContext();
   if (!frame)
@@ -29,46 +44,244 @@ RenderView* GetCurrentRenderView() {
   return RenderView::FromWebView(view);
 }
 
+bool SerializeArguments(mate::Arguments* args,
+                        v8::Local<v8::Value> arguments,
+                        std::string* data,
+                        V8ValueSerializer::BufferList* buffers = nullptr) {
+  if (!V8ValueSerializer::Serialize(args->isolate(), arguments, data,
+                                    buffers)) {
+    args->ThrowError("Unable to serialize the arguments");
+    return false;
+  }
+  return true;
+}
+
+// Copies |buffers| into shared memory allocated by the browser, since the
+// sandboxed renderer can not always create it by itself.
+bool ShareBuffers(const V8ValueSerializer::BufferList& buffers,
+                  base::SharedMemoryHandle* handle,
+                  uint32* size) {
+  size_t total_size = V8ValueSerializer::GetBuffersSize(buffers);
+  if (total_size > kuint32max)
+    return false;
+
+  scoped_ptr<base::SharedMemory> memory(
+      content::RenderThread::Get()->HostAllocateSharedMemoryBuffer(
+          total_size));
+  if (!memory || !memory->Map(total_size))
+    return false;
+
+  V8ValueSerializer::CopyBuffers(buffers,
+                                 static_cast<char*>(memory->memory()));
+  *size = static_cast<uint32>(total_size);
+  return memory->ShareToProcess(base::GetCurrentProcessHandle(), handle);
+}
+
+// Serializes |arguments| of an async message, with the large Buffers in
+// shared memory.
+bool PackArguments(mate::Arguments* args,
+                   v8::Local<v8::Value> arguments,
+                   std::string* data,
+                   base::SharedMemoryHandle* handle,
+                   uint32* buffers_size) {
+  V8ValueSerializer::BufferList buffers;
+  if (!SerializeArguments(args, arguments, data, &buffers))
+    return false;
+
+  *handle = base::SharedMemory::NULLHandle();
+  *buffers_size = 0;
+  if (!buffers.empty() && !ShareBuffers(buffers, handle, buffers_size)) {
+    args->ThrowError("Unable to allocate shared memory for Buffers");
+    return false;
+  }
+  return true;
+}
+
 void Send(mate::Arguments* args,
           const base::string16& channel,
-          const base::ListValue& arguments) {
+          v8::Local<v8::Value> arguments) {
   RenderView* render_view = GetCurrentRenderView();
   if (render_view == NULL)
     return;
 
+  std::string name = IPCChannelStats::GetChannelName(channel, arguments);
+  TRACE_EVENT1("electron.ipc", "ipc.send",
+               "channel", TRACE_STR_COPY(name.c_str()));
+
+  std::string data;
+  base::SharedMemoryHandle handle;
+  uint32 buffers_size;
+  base::TimeTicks start = base::TimeTicks::Now();
+  if (!PackArguments(args, arguments, &data, &handle, &buffers_size))
+    return;
+
+  IPCChannelStats::Sample sample;
+  sample.bytes = data.size() + buffers_size;
+  sample.serialize_time = base::TimeTicks::Now() - start;
+  g_stats.Get().Record(name, sample);
+
   bool success = render_view->Send(new AtomViewHostMsg_Message(
-      render_view->GetRoutingID(), channel, arguments));
+      render_view->GetRoutingID(), channel, data, handle, buffers_size));
 
   if (!success)
     args->ThrowError("Unable to send AtomViewHostMsg_Message");
 }
 
+int32 RegisterChannel(mate::Arguments* args, const base::string16& channel) {
+  // The ids are unique in the process, so frames of the same view and views
+  // that share the process never get the same id for different channels.
+  static int32 next_channel_id = 0;
+
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == NULL)
+    return 0;
+
+  int32 channel_id = ++next_channel_id;
+  bool success = render_view->Send(new AtomViewHostMsg_RegisterChannel(
+      render_view->GetRoutingID(), channel_id, channel));
+
+  if (!success)
+    args->ThrowError("Unable to send AtomViewHostMsg_RegisterChannel");
+  return channel_id;
+}
+
+// The |name| of the channel is only used for the counters, the page keeps it
+// so nothing needs to be freed when the page goes away.
+void SendById(mate::Arguments* args,
+              int32 channel_id,
+              const std::string& name,
+              v8::Local<v8::Value> arguments) {
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == NULL)
+    return;
+
+  TRACE_EVENT1("electron.ipc", "ipc.sendById",
+               "channel", TRACE_STR_COPY(name.c_str()));
+
+  std::string data;
+  base::SharedMemoryHandle handle;
+  uint32 buffers_size;
+  base::TimeTicks start = base::TimeTicks::Now();
+  if (!PackArguments(args, arguments, &data, &handle, &buffers_size))
+    return;
+
+  IPCChannelStats::Sample sample;
+  sample.bytes = data.size() + buffers_size;
+  sample.serialize_time = base::TimeTicks::Now() - start;
+  g_stats.Get().Record(name, sample);
+
+  bool success = render_view->Send(new AtomViewHostMsg_MessageById(
+      render_view->GetRoutingID(), channel_id, data, handle, buffers_size));
+
+  if (!success)
+    args->ThrowError("Unable to send AtomViewHostMsg_MessageById");
+}
+
+void PostPortMessage(mate::Arguments* args,
+                     int32 port_id,
+                     v8::Local<v8::Value> arguments) {
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == NULL)
+    return;
+
+  std::string data;
+  if (!SerializeArguments(args, arguments, &data))
+    return;
+
+  bool success = render_view->Send(new AtomViewHostMsg_PortMessage(
+      render_view->GetRoutingID(), port_id, data));
+
+  if (!success)
+    args->ThrowError("Unable to send AtomViewHostMsg_PortMessage");
+}
+
+void ClosePort(int32 port_id) {
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == NULL)
+    return;
+
+  render_view->Send(new AtomViewHostMsg_PortClose(
+      render_view->GetRoutingID(), port_id));
+}
+
 base::string16 SendSync(mate::Arguments* args,
                         const base::string16& channel,
-                        const base::ListValue& arguments) {
+                        v8::Local<v8::Value> arguments) {
   base::string16 json;
 
   RenderView* render_view = GetCurrentRenderView();
   if (render_view == NULL)
     return json;
 
+  std::string name = IPCChannelStats::GetChannelName(channel, arguments);
+  TRACE_EVENT1("electron.ipc", "ipc.sendSync",
+               "channel", TRACE_STR_COPY(name.c_str()));
+
+  std::string data;
+  base::TimeTicks start = base::TimeTicks::Now();
+  if (!SerializeArguments(args, arguments, &data))
+    return json;
+
+  IPCChannelStats::Sample sample;
+  sample.sync = true;
+  sample.bytes = data.size();
+  base::TimeTicks serialized = base::TimeTicks::Now();
+  sample.serialize_time = serialized - start;
+
   IPC::SyncMessage* message = new AtomViewHostMsg_Message_Sync(
-      render_view->GetRoutingID(), channel, arguments, &json);
+      render_view->GetRoutingID(), channel, data, &json);
   // Enable the UI thread in browser to receive messages.
   message->EnableMessagePumping();
   bool success = render_view->Send(message);
 
+  sample.blocking_time = base::TimeTicks::Now() - serialized;
+  g_stats.Get().Record(name, sample);
+
   if (!success)
     args->ThrowError("Unable to send AtomViewHostMsg_Message_Sync");
 
   return json;
 }
 
+// Returns the counters of the messages sent by this process, and optionally
+// resets them.
+v8::Local<v8::Value> GetStats(mate::Arguments* args) {
+  bool reset = false;
+  args->GetNext(&reset);
+
+  scoped_ptr<base::DictionaryValue> value = g_stats.Get().ToValue();
+  if (reset)
+    g_stats.Get().Reset();
+  return mate::ConvertToV8(args->isolate(), *value);
+}
+
+// Returns a Buffer of the region the browser shared under |name|, or null.
+v8::Local<v8::Value> GetSharedMemoryRegion(v8::Isolate* isolate,
+                                           const std::string& name) {
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == NULL)
+    return v8::Null(isolate);
+
+  atom::AtomRenderViewObserver* observer =
+      atom::AtomRenderViewObserver::Get(render_view);
+  atom::SharedBufferRegion* region =
+      observer ? observer->GetSharedMemoryRegion(name) : nullptr;
+  if (!region)
+    return v8::Null(isolate);
+  return region->NewBuffer(isolate);
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("send", &Send);
   dict.SetMethod("sendSync", &SendSync);
+  dict.SetMethod("registerChannel", &RegisterChannel);
+  dict.SetMethod("sendById", &SendById);
+  dict.SetMethod("postPortMessage", &PostPortMessage);
+  dict.SetMethod("closePort", &ClosePort);
+  dict.SetMethod("getStats", &GetStats);
+  dict.SetMethod("getSharedMemoryRegion", &GetSharedMemoryRegion);
 }
 
 }  // namespace
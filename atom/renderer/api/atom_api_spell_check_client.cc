@@ -5,10 +5,13 @@
 #include "atom/renderer/api/atom_api_spell_check_client.h"
 
 #include <algorithm>
+#include <map>
 #include <vector>
 
 #include "atom/common/native_mate_converters/string16_converter.h"
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/thread_task_runner_handle.h"
 #include "native_mate/converter.h"
 #include "native_mate/dictionary.h"
 #include "third_party/icu/source/common/unicode/uscript.h"
@@ -23,6 +26,9 @@ namespace {
 
 const int kMaxAutoCorrectWordSize = 8;
 
+// The number of words whose spelling is remembered.
+const size_t kWordCacheSize = 10000;
+
 bool HasWordCharacters(const base::string16& text, int index) {
   const base::char16* data = text.data();
   int length = text.length();
@@ -44,15 +50,21 @@ SpellCheckClient::SpellCheckClient(const std::string& language,
                                    v8::Local<v8::Object> provider)
     : auto_spell_correct_turned_on_(auto_spell_correct_turned_on),
       isolate_(isolate),
-      provider_(isolate, provider) {
+      provider_(isolate, provider),
+      word_cache_(kWordCacheSize),
+      weak_factory_(this) {
   character_attributes_.SetDefaultLanguage(language);
 
   // Persistent the method.
   mate::Dictionary dict(isolate, provider);
   dict.Get("spellCheck", &spell_check_);
+  dict.Get("spellCheckWords", &spell_check_words_);
 }
 
-SpellCheckClient::~SpellCheckClient() {}
+SpellCheckClient::~SpellCheckClient() {
+  for (const PendingRequest& request : pending_requests_)
+    request.completion->didCancelCheckingText();
+}
 
 void SpellCheckClient::spellCheck(
     const blink::WebString& text,
@@ -91,9 +103,12 @@ void SpellCheckClient::requestCheckingOfText(
     return;
   }
 
-  std::vector<blink::WebTextCheckingResult> results;
-  SpellCheckText(text, false, &results);
-  completionCallback->didFinishCheckingText(results);
+  PendingRequest request = { text, completionCallback };
+  pending_requests_.push_back(request);
+  if (pending_requests_.size() == 1)
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::Bind(&SpellCheckClient::PerformPendingCheck,
+                              weak_factory_.GetWeakPtr()));
 }
 
 blink::WebString SpellCheckClient::autoCorrectWord(
@@ -115,11 +130,39 @@ void SpellCheckClient::updateSpellingUIWithMisspelledWord(
     const blink::WebString& word) {
 }
 
+void SpellCheckClient::PerformPendingCheck() {
+  if (pending_requests_.empty())
+    return;
+
+  PendingRequest request = pending_requests_.front();
+  pending_requests_.pop_front();
+  if (!pending_requests_.empty())
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::Bind(&SpellCheckClient::PerformPendingCheck,
+                              weak_factory_.GetWeakPtr()));
+
+  // The provider is called outside of a script now, in its own context.
+  v8::HandleScope handle_scope(isolate_);
+  v8::Context::Scope context_scope(provider_.NewHandle()->CreationContext());
+
+  std::vector<blink::WebTextCheckingResult> results;
+  SpellCheckText(request.text, false, &results);
+  request.completion->didFinishCheckingText(results);
+}
+
 void SpellCheckClient::SpellCheckText(
     const base::string16& text,
     bool stop_at_first_result,
     std::vector<blink::WebTextCheckingResult>* results) {
-  if (text.length() == 0 || spell_check_.IsEmpty())
+  if (text.length() == 0)
+    return;
+
+  if (!spell_check_words_.IsEmpty()) {
+    SpellCheckTextInBatch(text, stop_at_first_result, results);
+    return;
+  }
+
+  if (spell_check_.IsEmpty())
     return;
 
   base::string16 word;
@@ -155,19 +198,158 @@ void SpellCheckClient::SpellCheckText(
   }
 }
 
+void SpellCheckClient::SpellCheckTextInBatch(
+    const base::string16& text,
+    bool stop_at_first_result,
+    std::vector<blink::WebTextCheckingResult>* results) {
+  if (!text_iterator_.IsInitialized() &&
+      !text_iterator_.Initialize(&character_attributes_, true)) {
+      VLOG(1) << "Failed to initialize SpellcheckWordIterator";
+      return;
+  }
+
+  std::vector<base::string16> words;
+  std::vector<blink::WebTextCheckingResult> ranges;
+  base::string16 word;
+  int word_start;
+  int word_length;
+  base::string16 in_word(text);
+  text_iterator_.SetText(in_word.c_str(), in_word.size());
+  while (text_iterator_.GetNextWord(&word, &word_start, &word_length)) {
+    words.push_back(word);
+    blink::WebTextCheckingResult range;
+    range.location = word_start;
+    range.length = word_length;
+    ranges.push_back(range);
+  }
+  if (words.empty())
+    return;
+
+  std::vector<bool> misspelled;
+  SpellCheckWords(words, &misspelled);
+
+  // The misspelled words that are concatenated words (e.g. "hello:hello") are
+  // valid when all of their parts are, the parts of all of them are checked
+  // with a second call.
+  if (contraction_iterator_.IsInitialized() ||
+      contraction_iterator_.Initialize(&character_attributes_, false)) {
+    std::vector<base::string16> parts;
+    std::vector<size_t> owners;
+    for (size_t i = 0; i < words.size(); ++i) {
+      if (!misspelled[i])
+        continue;
+      contraction_iterator_.SetText(words[i].c_str(), words[i].length());
+      while (contraction_iterator_.GetNextWord(&word, &word_start,
+                                               &word_length)) {
+        parts.push_back(word);
+        owners.push_back(i);
+      }
+      misspelled[i] = false;
+    }
+
+    if (!parts.empty()) {
+      std::vector<bool> misspelled_parts;
+      SpellCheckWords(parts, &misspelled_parts);
+      for (size_t i = 0; i < parts.size(); ++i) {
+        if (misspelled_parts[i])
+          misspelled[owners[i]] = true;
+      }
+    }
+  } else {
+    // We failed to initialize the word iterator, contractions are treated as
+    // spelled correctly.
+    VLOG(1) << "Failed to initialize contraction_iterator_";
+    misspelled.assign(words.size(), false);
+  }
+
+  for (size_t i = 0; i < words.size(); ++i) {
+    if (!misspelled[i])
+      continue;
+    results->push_back(ranges[i]);
+    if (stop_at_first_result)
+      return;
+  }
+}
+
 bool SpellCheckClient::SpellCheckWord(const base::string16& word_to_check) {
-  if (spell_check_.IsEmpty())
-    return true;
+  if (spell_check_.IsEmpty()) {
+    if (spell_check_words_.IsEmpty())
+      return true;
+    std::vector<bool> misspelled;
+    SpellCheckWords(std::vector<base::string16>(1, word_to_check),
+                    &misspelled);
+    return !misspelled[0];
+  }
+
+  auto it = word_cache_.Get(word_to_check);
+  if (it != word_cache_.end())
+    return it->second;
 
   v8::HandleScope handle_scope(isolate_);
   v8::Local<v8::Value> word = mate::ConvertToV8(isolate_, word_to_check);
   v8::Local<v8::Value> result = spell_check_.NewHandle()->Call(
       provider_.NewHandle(), 1, &word);
 
-  if (result->IsBoolean())
-    return result->BooleanValue();
-  else
+  if (result.IsEmpty() || !result->IsBoolean())
     return true;
+
+  bool correct = result->BooleanValue();
+  word_cache_.Put(word_to_check, correct);
+  return correct;
+}
+
+void SpellCheckClient::SpellCheckWords(
+    const std::vector<base::string16>& words,
+    std::vector<bool>* misspelled) {
+  misspelled->assign(words.size(), false);
+  if (spell_check_words_.IsEmpty()) {
+    for (size_t i = 0; i < words.size(); ++i)
+      (*misspelled)[i] = !SpellCheckWord(words[i]);
+    return;
+  }
+
+  // Only the words that are not in the cache are passed to the provider,
+  // each of them once.
+  std::vector<base::string16> unknown_words;
+  std::map<base::string16, std::vector<size_t>> positions;
+  for (size_t i = 0; i < words.size(); ++i) {
+    auto it = word_cache_.Get(words[i]);
+    if (it != word_cache_.end()) {
+      (*misspelled)[i] = !it->second;
+      continue;
+    }
+    std::vector<size_t>& word_positions = positions[words[i]];
+    if (word_positions.empty())
+      unknown_words.push_back(words[i]);
+    word_positions.push_back(i);
+  }
+  if (unknown_words.empty())
+    return;
+
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Value> list = mate::ConvertToV8(isolate_, unknown_words);
+  v8::Local<v8::Value> result = spell_check_words_.NewHandle()->Call(
+      provider_.NewHandle(), 1, &list);
+
+  // The provider returns the indices of the misspelled words.
+  std::vector<int> indices;
+  if (result.IsEmpty() || !mate::ConvertFromV8(isolate_, result, &indices))
+    return;
+
+  std::vector<bool> unknown_misspelled(unknown_words.size(), false);
+  for (int index : indices) {
+    if (index >= 0 && index < static_cast<int>(unknown_words.size()))
+      unknown_misspelled[index] = true;
+  }
+  for (size_t i = 0; i < unknown_words.size(); ++i) {
+    word_cache_.Put(unknown_words[i], !unknown_misspelled[i]);
+    for (size_t position : positions[unknown_words[i]])
+      (*misspelled)[position] = unknown_misspelled[i];
+  }
+}
+
+void SpellCheckClient::ClearCache() {
+  word_cache_.Clear();
 }
 
 base::string16 SpellCheckClient::GetAutoCorrectionWord(
@@ -187,6 +369,28 @@ base::string16 SpellCheckClient::GetAutoCorrectionWord(
       misspelled_word[i] = word_char[i];
   }
 
+  // The provider that checks words in batch gets all the swapped words in one
+  // call.
+  if (!spell_check_words_.IsEmpty()) {
+    std::vector<base::string16> candidates;
+    for (int i = 0; i < word_length - 1; i++) {
+      std::swap(misspelled_word[i], misspelled_word[i + 1]);
+      candidates.push_back(base::string16(misspelled_word, word_length));
+      std::swap(misspelled_word[i], misspelled_word[i + 1]);
+    }
+
+    std::vector<bool> misspelled;
+    SpellCheckWords(candidates, &misspelled);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      if (misspelled[i])
+        continue;
+      if (!autocorrect_word.empty())
+        return base::string16();
+      autocorrect_word = candidates[i];
+    }
+    return autocorrect_word;
+  }
+
   // Swap adjacent characters and spellcheck.
   int misspelling_start, misspelling_len;
   for (int i = 0; i < word_length - 1; i++) {
@@ -5,10 +5,14 @@
 #ifndef ATOM_RENDERER_API_ATOM_API_SPELL_CHECK_CLIENT_H_
 #define ATOM_RENDERER_API_ATOM_API_SPELL_CHECK_CLIENT_H_
 
+#include <deque>
 #include <string>
 #include <vector>
 
 #include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/memory/weak_ptr.h"
+#include "base/strings/string16.h"
 #include "chrome/renderer/spellchecker/spellcheck_worditerator.h"
 #include "native_mate/scoped_persistent.h"
 #include "third_party/WebKit/public/web/WebSpellCheckClient.h"
@@ -25,6 +29,10 @@ class SpellCheckClient : public blink::WebSpellCheckClient {
                    v8::Local<v8::Object> provider);
   virtual ~SpellCheckClient();
 
+  // Forgets the spelling of the checked words, should be called when the
+  // dictionary or the language of the provider changes.
+  void ClearCache();
+
  private:
   // blink::WebSpellCheckClient:
   void spellCheck(
@@ -48,14 +56,35 @@ class SpellCheckClient : public blink::WebSpellCheckClient {
   void updateSpellingUIWithMisspelledWord(
       const blink::WebString& word) override;
 
+  // A paragraph waiting to be checked.
+  struct PendingRequest {
+    base::string16 text;
+    blink::WebTextCheckingCompletion* completion;
+  };
+
+  // Checks the oldest pending paragraph and schedules the next one.
+  void PerformPendingCheck();
+
   // Check the spelling of text.
   void SpellCheckText(const base::string16& text,
                       bool stop_at_first_result,
                       std::vector<blink::WebTextCheckingResult>* results);
 
+  // Like SpellCheckText, but checks all the words of |text| with one call to
+  // the spellCheckWords method of the provider.
+  void SpellCheckTextInBatch(
+      const base::string16& text,
+      bool stop_at_first_result,
+      std::vector<blink::WebTextCheckingResult>* results);
+
   // Call JavaScript to check spelling a word.
   bool SpellCheckWord(const base::string16& word_to_check);
 
+  // Call JavaScript to check spelling the |words|, sets the elements of
+  // |misspelled| of the misspelled words to true.
+  void SpellCheckWords(const std::vector<base::string16>& words,
+                       std::vector<bool>* misspelled);
+
   // Find a possible correctly spelled word for a misspelled word. Computes an
   // empty string if input misspelled word is too long, there is ambiguity, or
   // the correct spelling cannot be determined.
@@ -82,6 +111,17 @@ class SpellCheckClient : public blink::WebSpellCheckClient {
   v8::Isolate* isolate_;
   mate::ScopedPersistent<v8::Object> provider_;
   mate::ScopedPersistent<v8::Function> spell_check_;
+  mate::ScopedPersistent<v8::Function> spell_check_words_;
+
+  // Whether the recently checked words are spelled correctly, so typing in
+  // a paragraph does not ask the provider for its words again.
+  base::MRUCache<base::string16, bool> word_cache_;
+
+  // The paragraphs requested by requestCheckingOfText, they are checked one
+  // per task so the checking does not delay input and layout.
+  std::deque<PendingRequest> pending_requests_;
+
+  base::WeakPtrFactory<SpellCheckClient> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(SpellCheckClient);
 };
@@ -9,10 +9,15 @@
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/renderer/api/atom_api_spell_check_client.h"
+#include "atom/renderer/preload_code_cache.h"
+#include "atom/renderer/script_cache.h"
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_view.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
+#include "third_party/WebKit/public/web/WebCache.h"
 #include "third_party/WebKit/public/web/WebDocument.h"
 #include "third_party/WebKit/public/web/WebLocalFrame.h"
 #include "third_party/WebKit/public/web/WebSecurityPolicy.h"
@@ -20,12 +25,33 @@
 
 #include "atom/common/node_includes.h"
 
+namespace mate {
+
+template<>
+struct Converter<blink::WebCache::ResourceTypeStat> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate, const blink::WebCache::ResourceTypeStat& stat) {
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+    dict.Set("count", static_cast<uint32>(stat.count));
+    dict.Set("size", static_cast<double>(stat.size));
+    dict.Set("liveSize", static_cast<double>(stat.liveSize));
+    dict.Set("decodedSize", static_cast<double>(stat.decodedSize));
+    dict.Set("purgedSize", static_cast<double>(stat.purgedSize));
+    dict.Set("purgeableSize", static_cast<double>(stat.purgeableSize));
+    return dict.GetHandle();
+  }
+};
+
+}  // namespace mate
+
 namespace atom {
 
 namespace api {
 
 WebFrame::WebFrame()
-    : web_frame_(blink::WebLocalFrame::frameForCurrentContext()) {
+    : web_frame_(blink::WebLocalFrame::frameForCurrentContext()),
+      zoom_level_report_pending_(false),
+      weak_factory_(this) {
 }
 
 WebFrame::~WebFrame() {
@@ -36,10 +62,16 @@ void WebFrame::SetName(const std::string& name) {
 }
 
 double WebFrame::SetZoomLevel(double level) {
-  auto render_view = content::RenderView::FromWebView(web_frame_->view());
-  // Notify guests if any for zoom level change.
-  render_view->Send(
-      new AtomViewHostMsg_ZoomLevelChanged(MSG_ROUTING_NONE, level));
+  // Notify guests if any for zoom level change, a pinch-zoom sets the level
+  // many times in a row.
+  if (!zoom_level_report_pending_) {
+    zoom_level_report_pending_ = true;
+    auto render_view = content::RenderView::FromWebView(web_frame_->view());
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&WebFrame::ReportZoomLevel, weak_factory_.GetWeakPtr(),
+                   render_view->GetRoutingID()));
+  }
   return web_frame_->view()->setZoomLevel(level);
 }
 
@@ -60,6 +92,18 @@ void WebFrame::SetZoomLevelLimits(double min_level, double max_level) {
   web_frame_->view()->setDefaultPageScaleLimits(min_level, max_level);
 }
 
+void WebFrame::ReportZoomLevel(int routing_id) {
+  zoom_level_report_pending_ = false;
+
+  // The view may have been closed in the meantime.
+  auto render_view = content::RenderView::FromRoutingID(routing_id);
+  if (!render_view)
+    return;
+
+  render_view->Send(new AtomViewHostMsg_ZoomLevelChanged(
+      routing_id, render_view->GetWebView()->zoomLevel()));
+}
+
 v8::Local<v8::Value> WebFrame::RegisterEmbedderCustomElement(
     const base::string16& name, v8::Local<v8::Object> options) {
   blink::WebExceptionCode c = 0;
@@ -82,8 +126,10 @@ void WebFrame::SetSpellCheckProvider(mate::Arguments* args,
                                      const std::string& language,
                                      bool auto_spell_correct_turned_on,
                                      v8::Local<v8::Object> provider) {
-  if (!provider->Has(mate::StringToV8(args->isolate(), "spellCheck"))) {
-    args->ThrowError("\"spellCheck\" has to be defined");
+  if (!provider->Has(mate::StringToV8(args->isolate(), "spellCheck")) &&
+      !provider->Has(mate::StringToV8(args->isolate(), "spellCheckWords"))) {
+    args->ThrowError(
+        "\"spellCheck\" or \"spellCheckWords\" has to be defined");
     return;
   }
 
@@ -92,6 +138,38 @@ void WebFrame::SetSpellCheckProvider(mate::Arguments* args,
   web_frame_->view()->setSpellCheckClient(spell_check_client_.get());
 }
 
+void WebFrame::ClearSpellCheckCache() {
+  if (spell_check_client_)
+    spell_check_client_->ClearCache();
+}
+
+void WebFrame::RegisterScript(const std::string& name,
+                              int version,
+                              const base::string16& source) {
+  ScriptCache::GetInstance()->Register(name, version, source);
+}
+
+bool WebFrame::HasScript(const std::string& name, int version) {
+  return ScriptCache::GetInstance()->Has(name, version);
+}
+
+void WebFrame::RunScript(mate::Arguments* args, const std::string& name) {
+  // Exceptions thrown by the script are passed on to the caller.
+  v8::Local<v8::Value> result;
+  if (ScriptCache::GetInstance()->Run(args->isolate(), name).ToLocal(&result))
+    args->Return(result);
+}
+
+void WebFrame::RunPreloadScript(mate::Arguments* args,
+                                v8::Local<v8::String> source,
+                                v8::Local<v8::Value> filename,
+                                const std::string& key) {
+  v8::Local<v8::Value> result;
+  if (atom::RunPreloadScript(args->isolate(), source, filename, key)
+          .ToLocal(&result))
+    args->Return(result);
+}
+
 void WebFrame::RegisterURLSchemeAsSecure(const std::string& scheme) {
   // Register scheme to secure list (https, wss, data).
   blink::WebSecurityPolicy::registerURLSchemeAsSecure(
@@ -114,6 +192,24 @@ void WebFrame::RegisterURLSchemeAsPrivileged(const std::string& scheme) {
       privileged_scheme);
 }
 
+mate::Dictionary WebFrame::GetResourceUsage(v8::Isolate* isolate) {
+  blink::WebCache::ResourceTypeStats stats;
+  blink::WebCache::getResourceTypeStats(&stats);
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("images", stats.images);
+  dict.Set("cssStyleSheets", stats.cssStyleSheets);
+  dict.Set("scripts", stats.scripts);
+  dict.Set("xslStyleSheets", stats.xslStyleSheets);
+  dict.Set("fonts", stats.fonts);
+  dict.Set("other", stats.other);
+  return dict;
+}
+
+void WebFrame::ClearCache(v8::Isolate* isolate) {
+  isolate->LowMemoryNotification();
+  blink::WebCache::clear();
+}
+
 mate::ObjectTemplateBuilder WebFrame::GetObjectTemplateBuilder(
     v8::Isolate* isolate) {
   return mate::ObjectTemplateBuilder(isolate)
@@ -129,6 +225,13 @@ mate::ObjectTemplateBuilder WebFrame::GetObjectTemplateBuilder(
                  &WebFrame::RegisterElementResizeCallback)
       .SetMethod("attachGuest", &WebFrame::AttachGuest)
       .SetMethod("setSpellCheckProvider", &WebFrame::SetSpellCheckProvider)
+      .SetMethod("clearSpellCheckCache", &WebFrame::ClearSpellCheckCache)
+      .SetMethod("getResourceUsage", &WebFrame::GetResourceUsage)
+      .SetMethod("clearCache", &WebFrame::ClearCache)
+      .SetMethod("_registerScript", &WebFrame::RegisterScript)
+      .SetMethod("_hasScript", &WebFrame::HasScript)
+      .SetMethod("_runScript", &WebFrame::RunScript)
+      .SetMethod("_runPreloadScript", &WebFrame::RunPreloadScript)
       .SetMethod("registerUrlSchemeAsSecure",
                  &WebFrame::RegisterURLSchemeAsSecure)
       .SetMethod("registerUrlSchemeAsBypassingCsp",
@@ -9,6 +9,7 @@
 
 #include "atom/renderer/guest_view_container.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "native_mate/handle.h"
 #include "native_mate/wrappable.h"
 
@@ -18,6 +19,7 @@ class WebLocalFrame;
 
 namespace mate {
 class Arguments;
+class Dictionary;
 }
 
 namespace atom {
@@ -43,6 +45,10 @@ class WebFrame : public mate::Wrappable {
 
   void SetZoomLevelLimits(double min_level, double max_level);
 
+  // Tells the browser the zoom level of the view, several changes in one task
+  // are reported once.
+  void ReportZoomLevel(int routing_id);
+
   v8::Local<v8::Value> RegisterEmbedderCustomElement(
       const base::string16& name, v8::Local<v8::Object> options);
   void RegisterElementResizeCallback(
@@ -56,6 +62,29 @@ class WebFrame : public mate::Wrappable {
                              bool auto_spell_correct_turned_on,
                              v8::Local<v8::Object> provider);
 
+  // Forget the spelling of the words checked by the provider.
+  void ClearSpellCheckCache();
+
+  // The memory used by the resources in Blink's cache, which is shared by all
+  // the pages of the process.
+  mate::Dictionary GetResourceUsage(v8::Isolate* isolate);
+
+  // Collects the garbage of V8 and empties Blink's resource cache.
+  void ClearCache(v8::Isolate* isolate);
+
+  // The scripts of webContents.registerScript, see ScriptCache.
+  void RegisterScript(const std::string& name,
+                      int version,
+                      const base::string16& source);
+  bool HasScript(const std::string& name, int version);
+  void RunScript(mate::Arguments* args, const std::string& name);
+
+  // Runs the wrapper of the preload script with its code cache.
+  void RunPreloadScript(mate::Arguments* args,
+                        v8::Local<v8::String> source,
+                        v8::Local<v8::Value> filename,
+                        const std::string& key);
+
   void RegisterURLSchemeAsSecure(const std::string& scheme);
   void RegisterURLSchemeAsBypassingCsp(const std::string& scheme);
   void RegisterURLSchemeAsPrivileged(const std::string& scheme);
@@ -68,6 +97,10 @@ class WebFrame : public mate::Wrappable {
 
   blink::WebLocalFrame* web_frame_;
 
+  bool zoom_level_report_pending_;
+
+  base::WeakPtrFactory<WebFrame> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(WebFrame);
 };
 
@@ -4,6 +4,7 @@
 
 #include "atom/renderer/atom_render_view_observer.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -12,12 +13,17 @@
 
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/event_emitter_caller.h"
-#include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/native_mate_converters/v8_value_serializer.h"
 #include "atom/common/node_includes.h"
 #include "atom/common/options_switches.h"
 #include "atom/renderer/atom_renderer_client.h"
+#include "base/bind.h"
 #include "base/command_line.h"
+#include "base/logging.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/thread_task_runner_handle.h"
 #include "content/public/renderer/render_view.h"
 #include "ipc/ipc_message_macros.h"
 #include "net/base/net_module.h"
@@ -36,25 +42,8 @@ namespace atom {
 
 namespace {
 
-bool GetIPCObject(v8::Isolate* isolate,
-                  v8::Local<v8::Context> context,
-                  v8::Local<v8::Object>* ipc) {
-  v8::Local<v8::String> key = mate::StringToV8(isolate, "ipc");
-  v8::Local<v8::Value> value = context->Global()->GetHiddenValue(key);
-  if (value.IsEmpty() || !value->IsObject())
-    return false;
-  *ipc = value->ToObject();
-  return true;
-}
-
-std::vector<v8::Local<v8::Value>> ListValueToVector(
-    v8::Isolate* isolate,
-    const base::ListValue& list) {
-  v8::Local<v8::Value> array = mate::ConvertToV8(isolate, list);
-  std::vector<v8::Local<v8::Value>> result;
-  mate::ConvertFromV8(isolate, array, &result);
-  return result;
-}
+// The draggable regions are sent at most once in this time, about a frame.
+const int kDraggableRegionsDelayMs = 16;
 
 base::StringPiece NetResourceProvider(int key) {
   if (key == IDR_DIR_HEADER_HTML) {
@@ -72,8 +61,14 @@ AtomRenderViewObserver::AtomRenderViewObserver(
     content::RenderView* render_view,
     AtomRendererClient* renderer_client)
     : content::RenderViewObserver(render_view),
+      content::RenderViewObserverTracker<AtomRenderViewObserver>(render_view),
       renderer_client_(renderer_client),
-      document_created_(false) {
+      document_created_(false),
+      draggable_regions_scheduled_(false),
+      draggable_regions_generation_(0),
+      draggable_regions_sequence_(0),
+      draggable_regions_resync_(true),
+      weak_factory_(this) {
   // Initialise resource for directory listing.
   net::NetModule::SetResourceProvider(NetResourceProvider);
 }
@@ -81,10 +76,58 @@ AtomRenderViewObserver::AtomRenderViewObserver(
 AtomRenderViewObserver::~AtomRenderViewObserver() {
 }
 
+SharedBufferRegion* AtomRenderViewObserver::GetSharedMemoryRegion(
+    const std::string& name) const {
+  auto it = shared_regions_.find(name);
+  return it == shared_regions_.end() ? nullptr : it->second.get();
+}
+
+bool AtomRenderViewObserver::GetIPCEmitter(v8::Isolate* isolate,
+                                           v8::Local<v8::Context> context,
+                                           v8::Local<v8::Object>* ipc,
+                                           v8::Local<v8::Function>* emit) {
+  if (ipc_context_.IsEmpty() || ipc_context_ != context) {
+    ResetIPCEmitter();
+
+    // The ipc object is set as hidden value by the renderer's init script.
+    v8::Local<v8::String> key = mate::StringToV8(isolate, "ipc");
+    v8::Local<v8::Value> value = context->Global()->GetHiddenValue(key);
+    if (value.IsEmpty() || !value->IsObject())
+      return false;
+    v8::Local<v8::Object> object = value->ToObject();
+    v8::Local<v8::Value> function =
+        object->Get(mate::StringToV8(isolate, "emit"));
+    if (function.IsEmpty() || !function->IsFunction())
+      return false;
+
+    ipc_context_.Reset(isolate, context);
+    ipc_.Reset(isolate, object);
+    ipc_emit_.Reset(isolate, function.As<v8::Function>());
+  }
+
+  *ipc = v8::Local<v8::Object>::New(isolate, ipc_);
+  *emit = v8::Local<v8::Function>::New(isolate, ipc_emit_);
+  return true;
+}
+
+void AtomRenderViewObserver::ResetIPCEmitter() {
+  ipc_context_.Reset();
+  ipc_.Reset();
+  ipc_emit_.Reset();
+}
+
 void AtomRenderViewObserver::DidCreateDocumentElement(
     blink::WebLocalFrame* frame) {
   document_created_ = true;
 
+  // The new document comes with a new context and ipc object.
+  ResetIPCEmitter();
+
+  if (!frame->parent()) {
+    for (const std::string& id : style_sheets_)
+      InsertStyleSheet(id);
+  }
+
   // Read --zoom-factor from command line.
   std::string zoom_factor_str = base::CommandLine::ForCurrentProcess()->
       GetSwitchValueASCII(switches::kZoomFactor);;
@@ -100,30 +143,149 @@ void AtomRenderViewObserver::DidCreateDocumentElement(
 void AtomRenderViewObserver::DraggableRegionsChanged(blink::WebFrame* frame) {
   blink::WebVector<blink::WebDraggableRegion> webregions =
       frame->document().draggableRegions();
-  std::vector<DraggableRegion> regions;
+  pending_draggable_regions_.resize(webregions.size());
   for (size_t i = 0; i < webregions.size(); ++i) {
-    DraggableRegion region;
-    region.bounds = webregions[i].bounds;
-    region.draggable = webregions[i].draggable;
-    regions.push_back(region);
+    pending_draggable_regions_[i].bounds = webregions[i].bounds;
+    pending_draggable_regions_[i].draggable = webregions[i].draggable;
+  }
+
+  ScheduleSendDraggableRegions();
+}
+
+void AtomRenderViewObserver::ScheduleSendDraggableRegions() {
+  // The regions change on every layout during animations, only the last ones
+  // of a frame are sent.
+  if (draggable_regions_scheduled_)
+    return;
+  draggable_regions_scheduled_ = true;
+  base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&AtomRenderViewObserver::SendDraggableRegions,
+                 weak_factory_.GetWeakPtr()),
+      base::TimeDelta::FromMilliseconds(kDraggableRegionsDelayMs));
+}
+
+void AtomRenderViewObserver::SendDraggableRegions() {
+  draggable_regions_scheduled_ = false;
+
+  if (draggable_regions_resync_) {
+    draggable_regions_resync_ = false;
+    draggable_regions_ = pending_draggable_regions_;
+    draggable_regions_sequence_ = 0;
+    Send(new AtomViewHostMsg_UpdateDraggableRegions(
+        routing_id(), ++draggable_regions_generation_, 0, 0, 0,
+        draggable_regions_));
+    return;
   }
-  Send(new AtomViewHostMsg_UpdateDraggableRegions(routing_id(), regions));
+
+  // Only the regions between the unchanged head and tail are sent.
+  const std::vector<DraggableRegion>& old_regions = draggable_regions_;
+  const std::vector<DraggableRegion>& new_regions = pending_draggable_regions_;
+  size_t common = std::min(old_regions.size(), new_regions.size());
+  size_t head = 0;
+  while (head < common && old_regions[head] == new_regions[head])
+    ++head;
+  size_t tail = 0;
+  while (tail < common - head &&
+         old_regions[old_regions.size() - tail - 1] ==
+             new_regions[new_regions.size() - tail - 1])
+    ++tail;
+  if (head == old_regions.size() && head == new_regions.size())
+    return;
+
+  std::vector<DraggableRegion> inserted(
+      new_regions.begin() + head, new_regions.end() - tail);
+  Send(new AtomViewHostMsg_UpdateDraggableRegions(
+      routing_id(), draggable_regions_generation_,
+      ++draggable_regions_sequence_, head, old_regions.size() - head - tail,
+      inserted));
+  draggable_regions_ = new_regions;
+}
+
+void AtomRenderViewObserver::OnResyncDraggableRegions() {
+  if (!draggable_regions_scheduled_)
+    pending_draggable_regions_ = draggable_regions_;
+  draggable_regions_resync_ = true;
+  ScheduleSendDraggableRegions();
 }
 
 bool AtomRenderViewObserver::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(AtomRenderViewObserver, message)
     IPC_MESSAGE_HANDLER(AtomViewMsg_Message, OnBrowserMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_PortMessage, OnPortMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_PortClosed, OnPortClosed)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_SharedMemoryRegion, OnSharedMemoryRegion)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_SharedMemoryReleased,
+                        OnSharedMemoryReleased)
     IPC_MESSAGE_HANDLER(AtomViewMsg_ExecuteJavaScript,
                         OnJavaScriptExecuteRequest)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_InsertStyleSheet, OnInsertStyleSheet)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_SetStyleSheets, OnSetStyleSheets)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_ResyncDraggableRegions,
+                        OnResyncDraggableRegions)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
   return handled;
 }
 
-void AtomRenderViewObserver::OnBrowserMessage(const base::string16& channel,
-                                              const base::ListValue& args) {
+void AtomRenderViewObserver::OnBrowserMessage(
+    const base::string16& channel,
+    const std::string& args,
+    const base::SharedMemoryHandle& buffers,
+    uint32 buffers_size) {
+  // Take the shared memory first so its handle is closed on early returns.
+  scoped_refptr<SharedBufferRegion> region;
+  if (base::SharedMemory::IsHandleValid(buffers)) {
+    region = SharedBufferRegion::Map(
+        make_scoped_ptr(new base::SharedMemory(buffers, false)),
+        buffers_size);
+    if (!region) {
+      LOG(ERROR) << "Unable to map the Buffers of ipc message " << channel;
+      return;
+    }
+  }
+
+  EmitIPCEvent(channel, args, region.get());
+}
+
+void AtomRenderViewObserver::OnPortMessage(int32 port_id,
+                                           const std::string& args) {
+  EmitIPCEvent(base::ASCIIToUTF16(base::StringPrintf(
+                   "ATOM_INTERNAL_PORT_MESSAGE-%d", port_id)),
+               args, nullptr);
+}
+
+void AtomRenderViewObserver::OnPortClosed(int32 port_id) {
+  EmitIPCEvent(base::ASCIIToUTF16(base::StringPrintf(
+                   "ATOM_INTERNAL_PORT_CLOSED-%d", port_id)),
+               std::string(), nullptr);
+}
+
+void AtomRenderViewObserver::OnSharedMemoryRegion(
+    const std::string& name,
+    const base::SharedMemoryHandle& handle,
+    uint32 size) {
+  scoped_refptr<SharedBufferRegion> region = SharedBufferRegion::Map(
+      make_scoped_ptr(new base::SharedMemory(handle, false)), size);
+  if (!region) {
+    LOG(ERROR) << "Unable to map the shared memory region " << name;
+    shared_regions_.erase(name);
+    return;
+  }
+
+  // The Buffers of a region shared before keep the old mapping alive.
+  shared_regions_[name] = region;
+}
+
+void AtomRenderViewObserver::OnSharedMemoryReleased(const std::string& name) {
+  shared_regions_.erase(name);
+}
+
+void AtomRenderViewObserver::EmitIPCEvent(const base::string16& channel,
+                                          const std::string& args,
+                                          SharedBufferRegion* region) {
   if (!document_created_)
     return;
 
@@ -141,9 +303,23 @@ void AtomRenderViewObserver::OnBrowserMessage(const base::string16& channel,
   v8::Context::Scope context_scope(context);
 
   v8::Local<v8::Object> ipc;
-  if (GetIPCObject(isolate, context, &ipc)) {
-    mate::EmitEvent(isolate, ipc, channel, ListValueToVector(isolate, args));
+  v8::Local<v8::Function> emit;
+  if (!GetIPCEmitter(isolate, context, &ipc, &emit))
+    return;
+
+  // Nobody would see the arguments, so don't create them.
+  std::string channel_utf8 = base::UTF16ToUTF8(channel);
+  if (!mate::HasListeners(isolate, ipc, channel_utf8))
+    return;
+
+  std::vector<v8::Local<v8::Value>> arguments = {
+      mate::StringToV8(isolate, channel_utf8) };
+  if (!args.empty() &&
+      !V8ValueSerializer::DeserializeArray(isolate, args, region, &arguments)) {
+    LOG(ERROR) << "Received malformed ipc message " << channel;
+    return;
   }
+  mate::internal::CallEmitWithArgs(isolate, ipc, emit, &arguments);
 }
 
 void AtomRenderViewObserver::OnJavaScriptExecuteRequest(
@@ -164,4 +340,28 @@ void AtomRenderViewObserver::OnJavaScriptExecuteRequest(
   frame->executeScriptAndReturnValue(blink::WebScriptSource(code));
 }
 
+void AtomRenderViewObserver::OnInsertStyleSheet(const std::string& id) {
+  if (document_created_)
+    InsertStyleSheet(id);
+}
+
+void AtomRenderViewObserver::OnSetStyleSheets(
+    const std::vector<std::string>& ids) {
+  style_sheets_ = ids;
+}
+
+void AtomRenderViewObserver::InsertStyleSheet(const std::string& id) {
+  if (!render_view()->GetWebView())
+    return;
+
+  // The sheets are registered through the same channel before the messages
+  // that refer to them, so they have always arrived.
+  const blink::WebString* css = renderer_client_->GetStyleSheet(id);
+  if (!css)
+    return;
+
+  blink::WebFrame* frame = render_view()->GetWebView()->mainFrame();
+  frame->document().insertStyleSheet(*css);
+}
+
 }  // namespace atom
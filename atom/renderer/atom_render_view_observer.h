@@ -5,22 +5,34 @@
 #ifndef ATOM_RENDERER_ATOM_RENDER_VIEW_OBSERVER_H_
 #define ATOM_RENDERER_ATOM_RENDER_VIEW_OBSERVER_H_
 
+#include <map>
+#include <string>
+#include <vector>
+
+#include "atom/common/draggable_region.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/shared_memory.h"
+#include "base/memory/weak_ptr.h"
 #include "base/strings/string16.h"
 #include "content/public/renderer/render_view_observer.h"
-
-namespace base {
-class ListValue;
-}
+#include "content/public/renderer/render_view_observer_tracker.h"
+#include "v8/include/v8.h"
 
 namespace atom {
 
 class AtomRendererClient;
+class SharedBufferRegion;
 
-class AtomRenderViewObserver : public content::RenderViewObserver {
+class AtomRenderViewObserver
+    : public content::RenderViewObserver,
+      public content::RenderViewObserverTracker<AtomRenderViewObserver> {
  public:
   explicit AtomRenderViewObserver(content::RenderView* render_view,
                                   AtomRendererClient* renderer_client);
 
+  // Returns the region the browser shared under |name|, or null.
+  SharedBufferRegion* GetSharedMemoryRegion(const std::string& name) const;
+
  protected:
   virtual ~AtomRenderViewObserver();
 
@@ -31,9 +43,42 @@ class AtomRenderViewObserver : public content::RenderViewObserver {
   bool OnMessageReceived(const IPC::Message& message) override;
 
   void OnBrowserMessage(const base::string16& channel,
-                        const base::ListValue& args);
+                        const std::string& args,
+                        const base::SharedMemoryHandle& buffers,
+                        uint32 buffers_size);
+  void OnPortMessage(int32 port_id, const std::string& args);
+  void OnPortClosed(int32 port_id);
+  void OnSharedMemoryRegion(const std::string& name,
+                            const base::SharedMemoryHandle& handle,
+                            uint32 size);
+  void OnSharedMemoryReleased(const std::string& name);
   void OnJavaScriptExecuteRequest(const base::string16& code,
                                   bool has_user_gesture);
+  void OnInsertStyleSheet(const std::string& id);
+  void OnSetStyleSheets(const std::vector<std::string>& ids);
+  void OnResyncDraggableRegions();
+
+  // Inserts the registered style sheet of |id| in the main frame's document.
+  void InsertStyleSheet(const std::string& id);
+
+  // Sends the changes of the draggable regions since the last time, or all
+  // of them when the browser asked for a full update.
+  void ScheduleSendDraggableRegions();
+  void SendDraggableRegions();
+
+  // Returns the ipc object of |context| and its emit function, which are
+  // cached until the context changes.
+  bool GetIPCEmitter(v8::Isolate* isolate,
+                     v8::Local<v8::Context> context,
+                     v8::Local<v8::Object>* ipc,
+                     v8::Local<v8::Function>* emit);
+  void ResetIPCEmitter();
+
+  // Emits |channel| on the ipc module of the main frame, with the arguments
+  // serialized in |args|.
+  void EmitIPCEvent(const base::string16& channel,
+                    const std::string& args,
+                    SharedBufferRegion* region);
 
   // Weak reference to renderer client.
   AtomRendererClient* renderer_client_;
@@ -41,6 +86,32 @@ class AtomRenderViewObserver : public content::RenderViewObserver {
   // Whether the document object has been created.
   bool document_created_;
 
+  // The registered style sheets inserted in each new document.
+  std::vector<std::string> style_sheets_;
+
+  // The ipc object of the main frame and the context it belongs to.
+  v8::Global<v8::Context> ipc_context_;
+  v8::Global<v8::Object> ipc_;
+  v8::Global<v8::Function> ipc_emit_;
+
+  // The draggable regions the browser knows, and the latest ones that are
+  // sent at most once a frame.
+  std::vector<DraggableRegion> draggable_regions_;
+  std::vector<DraggableRegion> pending_draggable_regions_;
+  bool draggable_regions_scheduled_;
+
+  // The generation and sequence number of the last update sent, the next one
+  // is a full update when |draggable_regions_resync_| is set.
+  uint32 draggable_regions_generation_;
+  uint32 draggable_regions_sequence_;
+  bool draggable_regions_resync_;
+
+  // The regions of the shared-memory module mapped into this view, they stay
+  // mapped across navigations until the browser releases them.
+  std::map<std::string, scoped_refptr<SharedBufferRegion>> shared_regions_;
+
+  base::WeakPtrFactory<AtomRenderViewObserver> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomRenderViewObserver);
 };
 
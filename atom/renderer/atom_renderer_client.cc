@@ -8,21 +8,29 @@
 
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/atom_bindings.h"
+#include "atom/common/asar/asar_util.h"
 #include "atom/common/node_bindings.h"
 #include "atom/common/node_includes.h"
 #include "atom/common/options_switches.h"
+#include "atom/common/startup_timeline.h"
 #include "atom/renderer/atom_render_view_observer.h"
 #include "atom/renderer/guest_view_container.h"
+#include "atom/renderer/jank_reporter.h"
 #include "atom/renderer/node_array_buffer_bridge.h"
 #include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/path_service.h"
 #include "chrome/renderer/pepper/pepper_helper.h"
 #include "chrome/renderer/printing/print_web_view_helper.h"
 #include "chrome/renderer/tts_dispatcher.h"
 #include "content/public/common/content_constants.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
+#include "content/public/renderer/render_view.h"
 #include "content/public/renderer/render_thread.h"
 #include "ipc/ipc_message_macros.h"
+#include "third_party/WebKit/public/web/WebCache.h"
 #include "third_party/WebKit/public/web/WebCustomElement.h"
 #include "third_party/WebKit/public/web/WebLocalFrame.h"
 #include "third_party/WebKit/public/web/WebPluginParams.h"
@@ -43,6 +51,18 @@ bool IsSwitchEnabled(base::CommandLine* command_line,
   return command_line->GetSwitchValueASCII(switch_string) == "true";
 }
 
+// Input is given the priority over Node's events unless the page asks for
+// another policy.
+NodeBindings::SchedulingPolicy GetNodeSchedulingPolicy() {
+  std::string policy = base::CommandLine::ForCurrentProcess()->
+      GetSwitchValueASCII(switches::kNodeScheduling);
+  if (policy == "normal")
+    return NodeBindings::SCHEDULING_NORMAL;
+  if (policy == "idle")
+    return NodeBindings::SCHEDULING_IDLE;
+  return NodeBindings::SCHEDULING_YIELD_TO_INPUT;
+}
+
 // Helper class to forward the messages to the client.
 class AtomRenderFrameObserver : public content::RenderFrameObserver {
  public:
@@ -91,6 +111,36 @@ AtomRendererClient::AtomRendererClient()
 AtomRendererClient::~AtomRendererClient() {
 }
 
+#if defined(OS_LINUX)
+// static
+void AtomRendererClient::ZygoteStarting() {
+  // Node itself can not be initialized here: node::Init creates the fds of uv's
+  // default loop, which must not be shared by the forked renderers, and the
+  // real command line of a renderer is only known after the fork. What every
+  // renderer does the same is parsing the headers of the archives it loads its
+  // scripts from, so they are parsed once here and inherited by the renderers.
+  base::FilePath exec_path;
+  if (!PathService::Get(base::FILE_EXE, &exec_path))
+    return;
+  base::FilePath resources_path =
+      exec_path.DirName().Append(FILE_PATH_LITERAL("resources"));
+  asar::PreloadAsarArchive(resources_path.Append("atom.asar"));
+  asar::PreloadAsarArchive(resources_path.Append("app.asar"));
+}
+#endif
+
+bool AtomRendererClient::OnControlMessageReceived(
+    const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(AtomRendererClient, message)
+    IPC_MESSAGE_HANDLER(AtomMsg_MemoryPressure, OnMemoryPressure)
+    IPC_MESSAGE_HANDLER(AtomMsg_RegisterStyleSheet, OnRegisterStyleSheet)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+
+  return handled;
+}
+
 void AtomRendererClient::WebKitInitialized() {
   EnableWebRuntimeFeatures();
 
@@ -100,6 +150,7 @@ void AtomRendererClient::WebKitInitialized() {
   OverrideNodeArrayBuffer();
 
   node_bindings_->Initialize();
+  node_bindings_->set_scheduling_policy(GetNodeSchedulingPolicy());
   node_bindings_->PrepareMessageLoop();
 
   DCHECK(!global_env);
@@ -127,13 +178,17 @@ void AtomRendererClient::RenderThreadStarted() {
 
 void AtomRendererClient::RenderFrameCreated(
     content::RenderFrame* render_frame) {
-  new PepperHelper(render_frame);
+  // Pepper plugins can only be created when plugins are enabled.
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnablePlugins))
+    new PepperHelper(render_frame);
   new AtomRenderFrameObserver(render_frame, this);
 }
 
 void AtomRendererClient::RenderViewCreated(content::RenderView* render_view) {
   new printing::PrintWebViewHelper(render_view);
   new AtomRenderViewObserver(render_view, this);
+  new JankReporter(render_view);
 }
 
 blink::WebSpeechSynthesizer* AtomRendererClient::OverrideSpeechSynthesizer(
@@ -177,6 +232,17 @@ void AtomRendererClient::DidCreateScriptContext(
 
   // Load everything.
   node_bindings_->LoadEnvironment(env);
+
+  // The browser only records the first renderer, each process tells it once.
+  static bool node_environment_loaded = false;
+  if (!node_environment_loaded) {
+    node_environment_loaded = true;
+    content::RenderView* render_view =
+        content::RenderFrame::FromWebFrame(frame)->GetRenderView();
+    render_view->Send(new AtomViewHostMsg_NodeEnvironmentLoaded(
+        render_view->GetRoutingID(),
+        base::TimeTicks::Now().ToInternalValue()));
+  }
 }
 
 bool AtomRendererClient::ShouldFork(blink::WebLocalFrame* frame,
@@ -217,6 +283,30 @@ bool AtomRendererClient::ShouldOverridePageVisibilityState(
   return false;
 }
 
+void AtomRendererClient::OnMemoryPressure(int level) {
+  if (level != base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE &&
+      level != base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL)
+    return;
+
+  // The listener of RenderThreadImpl runs V8's low memory GC, the native
+  // images drop the variants they decoded on demand.
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      static_cast<base::MemoryPressureListener::MemoryPressureLevel>(level));
+  blink::WebCache::clear();
+  asar::ClearCachedArchives();
+}
+
+void AtomRendererClient::OnRegisterStyleSheet(const std::string& id,
+                                              const std::string& css) {
+  style_sheets_[id] = blink::WebString::fromUTF8(css);
+}
+
+const blink::WebString* AtomRendererClient::GetStyleSheet(
+    const std::string& id) const {
+  auto it = style_sheets_.find(id);
+  return it == style_sheets_.end() ? nullptr : &it->second;
+}
+
 void AtomRendererClient::EnableWebRuntimeFeatures() {
   base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
 
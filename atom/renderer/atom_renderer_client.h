@@ -5,10 +5,12 @@
 #ifndef ATOM_RENDERER_ATOM_RENDERER_CLIENT_H_
 #define ATOM_RENDERER_ATOM_RENDERER_CLIENT_H_
 
+#include <map>
 #include <string>
 
 #include "content/public/renderer/content_renderer_client.h"
 #include "content/public/renderer/render_process_observer.h"
+#include "third_party/WebKit/public/platform/WebString.h"
 
 namespace atom {
 
@@ -24,6 +26,14 @@ class AtomRendererClient : public content::ContentRendererClient,
   void DidCreateScriptContext(blink::WebFrame* frame,
                               v8::Handle<v8::Context> context);
 
+  // Returns the text of a style sheet registered by the browser, or nullptr.
+  const blink::WebString* GetStyleSheet(const std::string& id) const;
+
+#if defined(OS_LINUX)
+  // Called in the zygote before it starts forking renderers.
+  static void ZygoteStarting();
+#endif
+
  private:
   enum NodeIntegration {
     ALL,
@@ -33,6 +43,7 @@ class AtomRendererClient : public content::ContentRendererClient,
   };
 
   // content::RenderProcessObserver:
+  bool OnControlMessageReceived(const IPC::Message& message) override;
   void WebKitInitialized() override;
 
   // content::ContentRendererClient:
@@ -61,9 +72,16 @@ class AtomRendererClient : public content::ContentRendererClient,
 
   void EnableWebRuntimeFeatures();
 
+  void OnMemoryPressure(int level);
+  void OnRegisterStyleSheet(const std::string& id, const std::string& css);
+
   scoped_ptr<NodeBindings> node_bindings_;
   scoped_ptr<AtomBindings> atom_bindings_;
 
+  // The style sheets of WebContents.registerStyleSheet, kept converted for
+  // Blink so each insertion only has to parse them.
+  std::map<std::string, blink::WebString> style_sheets_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomRendererClient);
 };
 
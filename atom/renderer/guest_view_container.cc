@@ -6,10 +6,12 @@
 
 #include <map>
 
+#include "atom/common/api/api_messages.h"
 #include "base/bind.h"
 #include "base/lazy_instance.h"
 #include "base/message_loop/message_loop.h"
-#include "ui/gfx/geometry/size.h"
+#include "content/public/renderer/render_frame.h"
+#include "content/public/renderer/render_view.h"
 
 namespace atom {
 
@@ -22,7 +24,9 @@ static base::LazyInstance<GuestViewContainerMap> g_guest_view_container_map =
 }  // namespace
 
 GuestViewContainer::GuestViewContainer(content::RenderFrame* render_frame)
-    : render_frame_(render_frame),
+    : element_instance_id_(0),
+      render_frame_(render_frame),
+      element_resize_pending_(false),
       weak_ptr_factory_(this) {
 }
 
@@ -51,15 +55,31 @@ void GuestViewContainer::SetElementInstanceID(int element_instance_id) {
 }
 
 void GuestViewContainer::DidResizeElement(const gfx::Size& new_size) {
-  if (element_resize_callback_.is_null())
+  element_size_ = new_size;
+  if (element_resize_pending_)
     return;
 
+  element_resize_pending_ = true;
   base::MessageLoop::current()->PostTask(
-      FROM_HERE, base::Bind(element_resize_callback_, new_size));
+      FROM_HERE, base::Bind(&GuestViewContainer::OnElementResized,
+                            weak_ptr_factory_.GetWeakPtr()));
 }
 
 base::WeakPtr<content::BrowserPluginDelegate> GuestViewContainer::GetWeakPtr() {
   return weak_ptr_factory_.GetWeakPtr();
 }
 
+void GuestViewContainer::OnElementResized() {
+  element_resize_pending_ = false;
+
+  if (element_instance_id_ > 0) {
+    content::RenderView* render_view = render_frame_->GetRenderView();
+    render_view->Send(new AtomViewHostMsg_GuestElementResized(
+        render_view->GetRoutingID(), element_instance_id_, element_size_));
+  }
+
+  if (!element_resize_callback_.is_null())
+    element_resize_callback_.Run(element_size_);
+}
+
 }  // namespace atom
@@ -7,13 +7,12 @@
 
 #include "base/callback.h"
 #include "content/public/renderer/browser_plugin_delegate.h"
-
-namespace gfx {
-class Size;
-}
+#include "ui/gfx/geometry/size.h"
 
 namespace atom {
 
+// The resizes of the element are coalesced, the browser and the resize
+// callback are told about the latest size once per task.
 class GuestViewContainer : public content::BrowserPluginDelegate {
  public:
   typedef base::Callback<void(const gfx::Size&)> ResizeCallback;
@@ -31,11 +30,17 @@ class GuestViewContainer : public content::BrowserPluginDelegate {
   base::WeakPtr<BrowserPluginDelegate> GetWeakPtr() final;
 
  private:
+  void OnElementResized();
+
   int element_instance_id_;
   content::RenderFrame* render_frame_;
 
   ResizeCallback element_resize_callback_;
 
+  // The latest size of the element, and whether a task will report it.
+  gfx::Size element_size_;
+  bool element_resize_pending_;
+
   base::WeakPtrFactory<GuestViewContainer> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(GuestViewContainer);
@@ -0,0 +1,252 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/jank_reporter.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "atom/common/api/api_messages.h"
+#include "atom/common/event_loop_stats.h"
+#include "base/lazy_instance.h"
+#include "base/message_loop/message_loop.h"
+#include "base/pending_task.h"
+#include "base/values.h"
+#include "ipc/ipc_message_macros.h"
+#include "third_party/WebKit/public/web/WebInputEvent.h"
+
+namespace atom {
+
+namespace {
+
+// The commits that are further apart belong to different animations, the
+// time between them is not counted as dropped frames.
+const int kMaxFrameGapMs = 1000;
+
+const double kFrameIntervalMs = 1000.0 / 60;
+
+// Input events delivered later than this have a bogus time stamp.
+const int kMaxInputLatencyMs = 10000;
+
+// Times the tasks of the main thread while there are reporters.
+class TaskMonitor : public base::MessageLoop::TaskObserver {
+ public:
+  TaskMonitor() : depth_(0) {}
+
+  void AddReporter(JankReporter* reporter) {
+    if (std::find(reporters_.begin(), reporters_.end(), reporter) !=
+        reporters_.end())
+      return;
+    if (reporters_.empty())
+      base::MessageLoop::current()->AddTaskObserver(this);
+    reporters_.push_back(reporter);
+  }
+
+  void RemoveReporter(JankReporter* reporter) {
+    auto it = std::find(reporters_.begin(), reporters_.end(), reporter);
+    if (it == reporters_.end())
+      return;
+    reporters_.erase(it);
+    if (!reporters_.empty())
+      return;
+
+    // The tasks running now end unobserved, so the next reporter starts with
+    // no open task.
+    depth_ = 0;
+    if (base::MessageLoop::current())
+      base::MessageLoop::current()->RemoveTaskObserver(this);
+  }
+
+  JankReporter::TaskTotals GetTotals() const {
+    JankReporter::TaskTotals totals = totals_;
+    totals.node_time = EventLoopStats::GetInstance()->total_slice_time();
+    return totals;
+  }
+
+  // base::MessageLoop::TaskObserver:
+  void WillProcessTask(const base::PendingTask& pending_task) override {
+    // Nested tasks are part of the outer one.
+    if (depth_++ == 0)
+      task_start_ = base::TimeTicks::Now();
+  }
+
+  void DidProcessTask(const base::PendingTask& pending_task) override {
+    // The monitor was added while the task ran, so its start was not seen.
+    if (depth_ == 0)
+      return;
+    if (--depth_ > 0)
+      return;
+    base::TimeDelta duration = base::TimeTicks::Now() - task_start_;
+    ++totals_.count;
+    totals_.time += duration;
+    if (duration.InMilliseconds() < JankReporter::kLongTaskThresholdMs)
+      return;
+
+    // A reporter could stop the reports of its page.
+    std::vector<JankReporter*> reporters(reporters_);
+    for (JankReporter* reporter : reporters)
+      reporter->OnLongTask(duration);
+  }
+
+ private:
+  std::vector<JankReporter*> reporters_;
+  int depth_;
+  base::TimeTicks task_start_;
+  JankReporter::TaskTotals totals_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskMonitor);
+};
+
+base::LazyInstance<TaskMonitor> g_task_monitor = LAZY_INSTANCE_INITIALIZER;
+
+double ToMilliseconds(base::TimeDelta delta) {
+  return delta.InMillisecondsF();
+}
+
+}  // namespace
+
+const int JankReporter::kLongTaskThresholdMs = 50;
+
+JankReporter::JankReporter(content::RenderView* render_view)
+    : content::RenderViewObserver(render_view),
+      long_task_count_(0),
+      input_event_count_(0),
+      frame_count_(0),
+      dropped_frame_count_(0) {
+}
+
+JankReporter::~JankReporter() {
+  g_task_monitor.Get().RemoveReporter(this);
+}
+
+bool JankReporter::OnMessageReceived(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(JankReporter, message)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_SetJankReportInterval,
+                        OnSetJankReportInterval)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+
+  return handled;
+}
+
+void JankReporter::DidHandleMouseEvent(const blink::WebMouseEvent& event) {
+  if (timer_.IsRunning())
+    RecordInputEvent(event.timeStampSeconds);
+}
+
+void JankReporter::DidHandleTouchEvent(const blink::WebTouchEvent& event) {
+  if (timer_.IsRunning())
+    RecordInputEvent(event.timeStampSeconds);
+}
+
+void JankReporter::DidCommitCompositorFrame() {
+  if (!timer_.IsRunning())
+    return;
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (!last_frame_time_.is_null()) {
+    double gap = ToMilliseconds(now - last_frame_time_);
+    if (gap < kMaxFrameGapMs)
+      dropped_frame_count_ += std::max(
+          0, static_cast<int>(gap / kFrameIntervalMs + 0.5) - 1);
+  }
+  last_frame_time_ = now;
+  ++frame_count_;
+}
+
+void JankReporter::OnLongTask(base::TimeDelta duration) {
+  ++long_task_count_;
+  long_task_time_ += duration;
+  max_long_task_ = std::max(max_long_task_, duration);
+}
+
+void JankReporter::OnSetJankReportInterval(int32 interval_ms) {
+  timer_.Stop();
+  if (interval_ms <= 0) {
+    g_task_monitor.Get().RemoveReporter(this);
+    return;
+  }
+
+  g_task_monitor.Get().AddReporter(this);
+  StartPeriod();
+  timer_.Start(FROM_HERE, base::TimeDelta::FromMilliseconds(interval_ms),
+               this, &JankReporter::SendReport);
+}
+
+void JankReporter::RecordInputEvent(double time_stamp_seconds) {
+  // The time stamps of the input events are TimeTicks in seconds.
+  double now_seconds =
+      (base::TimeTicks::Now() - base::TimeTicks()).InSecondsF();
+  base::TimeDelta latency =
+      base::TimeDelta::FromSecondsD(now_seconds - time_stamp_seconds);
+  if (latency < base::TimeDelta() ||
+      latency.InMilliseconds() > kMaxInputLatencyMs)
+    return;
+
+  ++input_event_count_;
+  input_latency_ += latency;
+  max_input_latency_ = std::max(max_input_latency_, latency);
+}
+
+void JankReporter::SendReport() {
+  TaskTotals totals = g_task_monitor.Get().GetTotals();
+  base::TimeDelta task_time = totals.time - period_start_totals_.time;
+  base::TimeDelta node_time =
+      totals.node_time - period_start_totals_.node_time;
+
+  base::DictionaryValue report;
+  report.SetDouble("interval",
+                   ToMilliseconds(base::TimeTicks::Now() - period_start_));
+
+  scoped_ptr<base::DictionaryValue> tasks(new base::DictionaryValue);
+  tasks->SetDouble("count",
+                   static_cast<double>(totals.count -
+                                       period_start_totals_.count));
+  tasks->SetDouble("time", ToMilliseconds(task_time));
+  tasks->SetDouble("nodeTime", ToMilliseconds(node_time));
+  tasks->SetDouble("blinkTime",
+                   ToMilliseconds(std::max(base::TimeDelta(),
+                                           task_time - node_time)));
+  report.Set("tasks", tasks.release());
+
+  scoped_ptr<base::DictionaryValue> long_tasks(new base::DictionaryValue);
+  long_tasks->SetInteger("count", long_task_count_);
+  long_tasks->SetDouble("time", ToMilliseconds(long_task_time_));
+  long_tasks->SetDouble("max", ToMilliseconds(max_long_task_));
+  report.Set("longTasks", long_tasks.release());
+
+  scoped_ptr<base::DictionaryValue> input(new base::DictionaryValue);
+  input->SetInteger("count", input_event_count_);
+  input->SetDouble("meanLatency",
+                   input_event_count_ > 0 ?
+                       ToMilliseconds(input_latency_) / input_event_count_ :
+                       0);
+  input->SetDouble("maxLatency", ToMilliseconds(max_input_latency_));
+  report.Set("input", input.release());
+
+  scoped_ptr<base::DictionaryValue> frames(new base::DictionaryValue);
+  frames->SetInteger("count", frame_count_);
+  frames->SetInteger("dropped", dropped_frame_count_);
+  report.Set("frames", frames.release());
+
+  Send(new AtomViewHostMsg_JankReport(routing_id(), report));
+  StartPeriod();
+}
+
+void JankReporter::StartPeriod() {
+  period_start_ = base::TimeTicks::Now();
+  period_start_totals_ = g_task_monitor.Get().GetTotals();
+  long_task_count_ = 0;
+  long_task_time_ = base::TimeDelta();
+  max_long_task_ = base::TimeDelta();
+  input_event_count_ = 0;
+  input_latency_ = base::TimeDelta();
+  max_input_latency_ = base::TimeDelta();
+  frame_count_ = 0;
+  dropped_frame_count_ = 0;
+  last_frame_time_ = base::TimeTicks();
+}
+
+}  // namespace atom
@@ -0,0 +1,86 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_JANK_REPORTER_H_
+#define ATOM_RENDERER_JANK_REPORTER_H_
+
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "content/public/renderer/render_view_observer.h"
+
+namespace blink {
+class WebMouseEvent;
+class WebTouchEvent;
+}
+
+namespace atom {
+
+// Measures the responsiveness of a page and sends a summary to the browser
+// every interval, after the browser asked for the reports with
+// AtomViewMsg_SetJankReportInterval.
+//
+// The tasks are those of the renderer's main thread, so they are shared by
+// the pages in the same process. The input events and frames are the page's
+// own.
+class JankReporter : public content::RenderViewObserver {
+ public:
+  // The tasks that take at least this long are long tasks.
+  static const int kLongTaskThresholdMs;
+
+  // The totals of the main thread's tasks since the first report started.
+  struct TaskTotals {
+    TaskTotals() : count(0) {}
+
+    int64 count;
+    base::TimeDelta time;
+    // The part of |time| spent in the uv loop of Node.
+    base::TimeDelta node_time;
+  };
+
+  explicit JankReporter(content::RenderView* render_view);
+
+  // Called by the task observer of the main thread.
+  void OnLongTask(base::TimeDelta duration);
+
+ private:
+  ~JankReporter() override;
+
+  // content::RenderViewObserver:
+  bool OnMessageReceived(const IPC::Message& message) override;
+  void DidHandleMouseEvent(const blink::WebMouseEvent& event) override;
+  void DidHandleTouchEvent(const blink::WebTouchEvent& event) override;
+  void DidCommitCompositorFrame() override;
+
+  void OnSetJankReportInterval(int32 interval_ms);
+
+  // Records an input event of |time_stamp_seconds| that was just handled.
+  void RecordInputEvent(double time_stamp_seconds);
+
+  // Sends the summary of the period and starts a new one.
+  void SendReport();
+  void StartPeriod();
+
+  base::RepeatingTimer<JankReporter> timer_;
+
+  base::TimeTicks period_start_;
+  TaskTotals period_start_totals_;
+
+  int long_task_count_;
+  base::TimeDelta long_task_time_;
+  base::TimeDelta max_long_task_;
+
+  int input_event_count_;
+  base::TimeDelta input_latency_;
+  base::TimeDelta max_input_latency_;
+
+  int frame_count_;
+  int dropped_frame_count_;
+  base::TimeTicks last_frame_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(JankReporter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_JANK_REPORTER_H_
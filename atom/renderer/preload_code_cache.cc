@@ -0,0 +1,67 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/preload_code_cache.h"
+
+#include <map>
+
+#include "base/lazy_instance.h"
+
+namespace atom {
+
+namespace {
+
+// Most apps have one or two preload scripts, there are more caches than this
+// only when the scripts keep changing, and then all of them are dropped.
+const size_t kMaxCodeCaches = 16;
+
+// The caches are made by this renderer and never leave it, a code cache is
+// trusted by V8 so it must not come from another process. Only accessed on
+// the main thread.
+typedef std::map<std::string, std::string> CodeCacheMap;
+base::LazyInstance<CodeCacheMap> g_code_caches = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+v8::MaybeLocal<v8::Value> RunPreloadScript(v8::Isolate* isolate,
+                                           v8::Local<v8::String> source,
+                                           v8::Local<v8::Value> filename,
+                                           const std::string& key) {
+  CodeCacheMap& caches = g_code_caches.Get();
+  auto it = caches.find(key);
+
+  // The source takes the ownership of |cached_data|, the buffer itself is
+  // still owned by |caches|.
+  bool has_cache = it != caches.end();
+  v8::ScriptCompiler::CachedData* cached_data = nullptr;
+  if (has_cache)
+    cached_data = new v8::ScriptCompiler::CachedData(
+        reinterpret_cast<const uint8_t*>(it->second.data()),
+        static_cast<int>(it->second.size()));
+  v8::ScriptCompiler::Source script_source(
+      source, v8::ScriptOrigin(filename), cached_data);
+
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Script> script;
+  if (!v8::ScriptCompiler::Compile(
+          context, &script_source,
+          has_cache ? v8::ScriptCompiler::kConsumeCodeCache :
+                      v8::ScriptCompiler::kProduceCodeCache)
+          .ToLocal(&script))
+    return v8::MaybeLocal<v8::Value>();
+
+  const v8::ScriptCompiler::CachedData* data = script_source.GetCachedData();
+  if (has_cache && data && data->rejected) {
+    caches.erase(it);
+  } else if (!has_cache && data && data->length > 0) {
+    if (caches.size() >= kMaxCodeCaches)
+      caches.clear();
+    caches[key].assign(reinterpret_cast<const char*>(data->data),
+                       data->length);
+  }
+
+  return script->Run(context);
+}
+
+}  // namespace atom
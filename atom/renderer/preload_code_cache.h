@@ -0,0 +1,25 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_PRELOAD_CODE_CACHE_H_
+#define ATOM_RENDERER_PRELOAD_CODE_CACHE_H_
+
+#include <string>
+
+#include "v8/include/v8.h"
+
+namespace atom {
+
+// Compiles and runs |source| as the preload script of |filename| in the
+// current context, consuming the code cache this renderer process keeps for
+// |key| and producing it when there is none. Returns an empty handle when the
+// script throws.
+v8::MaybeLocal<v8::Value> RunPreloadScript(v8::Isolate* isolate,
+                                           v8::Local<v8::String> source,
+                                           v8::Local<v8::Value> filename,
+                                           const std::string& key);
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_PRELOAD_CODE_CACHE_H_
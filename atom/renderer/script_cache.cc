@@ -0,0 +1,77 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/script_cache.h"
+
+#include "atom/common/native_mate_converters/string16_converter.h"
+
+namespace atom {
+
+// static
+ScriptCache* ScriptCache::GetInstance() {
+  return Singleton<ScriptCache>::get();
+}
+
+ScriptCache::ScriptCache() {
+}
+
+ScriptCache::~ScriptCache() {
+}
+
+void ScriptCache::Register(const std::string& name,
+                           int version,
+                           const base::string16& source) {
+  if (Has(name, version))
+    return;
+  Script& script = scripts_[name];
+  script.version = version;
+  script.source = source;
+  script.code_cache.clear();
+}
+
+bool ScriptCache::Has(const std::string& name, int version) const {
+  auto it = scripts_.find(name);
+  return it != scripts_.end() && it->second.version == version;
+}
+
+v8::MaybeLocal<v8::Value> ScriptCache::Run(v8::Isolate* isolate,
+                                           const std::string& name) {
+  auto it = scripts_.find(name);
+  if (it == scripts_.end())
+    return v8::MaybeLocal<v8::Value>();
+  Script& script = it->second;
+
+  // The source takes the ownership of |cached_data|, the buffer itself is
+  // still owned by |script|.
+  bool has_cache = !script.code_cache.empty();
+  v8::ScriptCompiler::CachedData* cached_data = nullptr;
+  if (has_cache)
+    cached_data = new v8::ScriptCompiler::CachedData(
+        reinterpret_cast<const uint8_t*>(script.code_cache.data()),
+        static_cast<int>(script.code_cache.size()));
+  v8::ScriptCompiler::Source script_source(
+      mate::ConvertToV8(isolate, script.source).As<v8::String>(),
+      v8::ScriptOrigin(mate::ConvertToV8(isolate, name)),
+      cached_data);
+
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Script> compiled;
+  if (!v8::ScriptCompiler::Compile(
+          context, &script_source,
+          has_cache ? v8::ScriptCompiler::kConsumeCodeCache :
+                      v8::ScriptCompiler::kProduceCodeCache)
+          .ToLocal(&compiled))
+    return v8::MaybeLocal<v8::Value>();
+
+  const v8::ScriptCompiler::CachedData* data = script_source.GetCachedData();
+  if (has_cache && data && data->rejected)
+    script.code_cache.clear();
+  else if (!has_cache && data && data->length > 0)
+    script.code_cache.assign(reinterpret_cast<const char*>(data->data),
+                             data->length);
+
+  return compiled->Run(context);
+}
+
+}  // namespace atom
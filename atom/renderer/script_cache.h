@@ -0,0 +1,56 @@
+// Copyright (c) 2015 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_SCRIPT_CACHE_H_
+#define ATOM_RENDERER_SCRIPT_CACHE_H_
+
+#include <map>
+#include <string>
+
+#include "base/memory/singleton.h"
+#include "base/strings/string16.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+// The scripts registered by webContents.registerScript, kept by the renderer
+// process so they are sent to it once however many pages it loads. The first
+// compilation of a script produces its V8 code cache, which the pages
+// compiling it later consume.
+//
+// Only used on the main thread of the renderer.
+class ScriptCache {
+ public:
+  static ScriptCache* GetInstance();
+
+  // Replaces the script of |name| when |version| is different.
+  void Register(const std::string& name,
+                int version,
+                const base::string16& source);
+  bool Has(const std::string& name, int version) const;
+
+  // Compiles and runs the script of |name| in the current context, returns
+  // an empty handle when it throws.
+  v8::MaybeLocal<v8::Value> Run(v8::Isolate* isolate, const std::string& name);
+
+ private:
+  friend struct DefaultSingletonTraits<ScriptCache>;
+
+  struct Script {
+    int version;
+    base::string16 source;
+    std::string code_cache;
+  };
+
+  ScriptCache();
+  ~ScriptCache();
+
+  std::map<std::string, Script> scripts_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_SCRIPT_CACHE_H_
@@ -0,0 +1,371 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/devtools/devtools_file_system_indexer.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/files/file_enumerator.h"
+#include "content/public/browser/browser_thread.h"
+
+using base::FilePath;
+using base::FileEnumerator;
+using base::Time;
+using base::TimeDelta;
+using base::TimeTicks;
+using content::BrowserThread;
+
+namespace {
+
+typedef int TrigramChar;
+typedef int Trigram;
+
+const TrigramChar kUndefinedTrigramChar = -1;
+
+// Letters ignoring case, digits and the punctuation that is part of names.
+const int kTrigramCharCount = 26 + 10 + 4;
+const int kTrigramCount =
+    kTrigramCharCount * kTrigramCharCount * kTrigramCharCount;
+
+const size_t kReadChunkSize = 64 * 1024;
+
+// The time a task of the FILE thread spends on one job before letting the
+// other tasks, a Stop or a search, run.
+const int kMaxTaskDurationMs = 20;
+const int kMinTimeBetweenWorkedNotificationsMs = 100;
+
+TrigramChar TrigramCharForChar(char c) {
+  if (c >= 'a' && c <= 'z')
+    return c - 'a';
+  if (c >= 'A' && c <= 'Z')
+    return c - 'A';
+  if (c >= '0' && c <= '9')
+    return 26 + c - '0';
+  switch (c) {
+    case '_': return 36;
+    case '$': return 37;
+    case '-': return 38;
+    case '.': return 39;
+    default: return kUndefinedTrigramChar;
+  }
+}
+
+// Feeds the characters of a text and returns the trigram ending at each of
+// them, or -1 when the last three characters do not make one.
+class TrigramReader {
+ public:
+  TrigramReader() : first_(kUndefinedTrigramChar),
+                    second_(kUndefinedTrigramChar) {}
+
+  Trigram Next(char c) {
+    TrigramChar third = TrigramCharForChar(c);
+    Trigram trigram = -1;
+    if (first_ != kUndefinedTrigramChar && second_ != kUndefinedTrigramChar &&
+        third != kUndefinedTrigramChar)
+      trigram = (first_ * kTrigramCharCount + second_) * kTrigramCharCount +
+                third;
+    first_ = second_;
+    second_ = third;
+    return trigram;
+  }
+
+ private:
+  TrigramChar first_;
+  TrigramChar second_;
+};
+
+bool IsHidden(const FilePath& path) {
+  return path.BaseName().value()[0] == FILE_PATH_LITERAL('.');
+}
+
+}  // namespace
+
+DevToolsFileSystemIndexer::FileSystemIndexingJob::FileSystemIndexingJob(
+    DevToolsFileSystemIndexer* indexer,
+    const FilePath& file_system_path,
+    const TotalWorkCallback& total_work_callback,
+    const WorkedCallback& worked_callback,
+    const DoneCallback& done_callback)
+    : indexer_(indexer),
+      file_system_path_(file_system_path),
+      total_work_callback_(total_work_callback),
+      worked_callback_(worked_callback),
+      done_callback_(done_callback),
+      id_(0),
+      next_file_(0),
+      unreported_worked_(0),
+      stopped_(false) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+}
+
+DevToolsFileSystemIndexer::FileSystemIndexingJob::~FileSystemIndexingJob() {
+}
+
+void DevToolsFileSystemIndexer::FileSystemIndexingJob::Start() {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  id_ = ++indexer_->next_job_id_;
+  pending_directories_.push_back(file_system_path_);
+  CollectFilesToIndex();
+}
+
+void DevToolsFileSystemIndexer::FileSystemIndexingJob::Stop() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  BrowserThread::PostTask(BrowserThread::FILE, FROM_HERE,
+      base::Bind(&FileSystemIndexingJob::StopOnFileThread, this));
+}
+
+void DevToolsFileSystemIndexer::FileSystemIndexingJob::StopOnFileThread() {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  stopped_ = true;
+}
+
+void DevToolsFileSystemIndexer::FileSystemIndexingJob::CollectFilesToIndex() {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  if (stopped_)
+    return;
+
+  TimeTicks deadline =
+      TimeTicks::Now() + TimeDelta::FromMilliseconds(kMaxTaskDurationMs);
+  while (!pending_directories_.empty() && TimeTicks::Now() < deadline) {
+    FilePath directory = pending_directories_.back();
+    pending_directories_.pop_back();
+
+    FileEnumerator enumerator(
+        directory, false, FileEnumerator::FILES | FileEnumerator::DIRECTORIES);
+    for (FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      FileEnumerator::FileInfo info = enumerator.GetInfo();
+      if (info.IsDirectory()) {
+        // Skip the directories of version control and the like.
+        if (!IsHidden(path))
+          pending_directories_.push_back(path);
+      } else if (indexer_->NeedsIndexing(path, info.GetLastModifiedTime(),
+                                         id_)) {
+        pending_files_.push_back(
+            std::make_pair(path, info.GetLastModifiedTime()));
+      }
+    }
+  }
+
+  if (!pending_directories_.empty()) {
+    BrowserThread::PostTask(BrowserThread::FILE, FROM_HERE,
+        base::Bind(&FileSystemIndexingJob::CollectFilesToIndex, this));
+    return;
+  }
+
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(total_work_callback_,
+                 static_cast<int>(pending_files_.size())));
+  last_worked_notification_ = TimeTicks::Now();
+  IndexFiles();
+}
+
+void DevToolsFileSystemIndexer::FileSystemIndexingJob::IndexFiles() {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  if (stopped_)
+    return;
+
+  TimeTicks deadline =
+      TimeTicks::Now() + TimeDelta::FromMilliseconds(kMaxTaskDurationMs);
+  while (next_file_ < pending_files_.size() && TimeTicks::Now() < deadline) {
+    const auto& file = pending_files_[next_file_++];
+    indexer_->IndexFile(file.first, file.second, id_);
+    ++unreported_worked_;
+  }
+
+  if (next_file_ < pending_files_.size()) {
+    ReportWorked(false);
+    BrowserThread::PostTask(BrowserThread::FILE, FROM_HERE,
+        base::Bind(&FileSystemIndexingJob::IndexFiles, this));
+    return;
+  }
+
+  ReportWorked(true);
+  Finish();
+}
+
+void DevToolsFileSystemIndexer::FileSystemIndexingJob::ReportWorked(
+    bool force) {
+  TimeTicks now = TimeTicks::Now();
+  if (!force && now - last_worked_notification_ <
+      TimeDelta::FromMilliseconds(kMinTimeBetweenWorkedNotificationsMs))
+    return;
+  if (unreported_worked_ > 0) {
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+        base::Bind(worked_callback_, unreported_worked_));
+  }
+  unreported_worked_ = 0;
+  last_worked_notification_ = now;
+}
+
+void DevToolsFileSystemIndexer::FileSystemIndexingJob::Finish() {
+  indexer_->RemoveMissingFiles(file_system_path_, id_);
+  pending_files_.clear();
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE, done_callback_);
+}
+
+DevToolsFileSystemIndexer::DevToolsFileSystemIndexer()
+    : next_job_id_(0) {
+}
+
+DevToolsFileSystemIndexer::~DevToolsFileSystemIndexer() {
+}
+
+scoped_refptr<DevToolsFileSystemIndexer::FileSystemIndexingJob>
+DevToolsFileSystemIndexer::IndexPath(
+    const std::string& file_system_path,
+    const TotalWorkCallback& total_work_callback,
+    const WorkedCallback& worked_callback,
+    const DoneCallback& done_callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  scoped_refptr<FileSystemIndexingJob> indexing_job =
+      new FileSystemIndexingJob(this,
+                                FilePath::FromUTF8Unsafe(file_system_path),
+                                total_work_callback,
+                                worked_callback,
+                                done_callback);
+  BrowserThread::PostTask(BrowserThread::FILE, FROM_HERE,
+      base::Bind(&FileSystemIndexingJob::Start, indexing_job));
+  return indexing_job;
+}
+
+void DevToolsFileSystemIndexer::SearchInPath(
+    const std::string& file_system_path,
+    const std::string& query,
+    const SearchCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  BrowserThread::PostTask(BrowserThread::FILE, FROM_HERE,
+      base::Bind(&DevToolsFileSystemIndexer::SearchInPathOnFileThread, this,
+                 file_system_path, query, callback));
+}
+
+bool DevToolsFileSystemIndexer::NeedsIndexing(const FilePath& path,
+                                              const Time& last_modified,
+                                              int job_id) {
+  auto it = file_ids_.find(path);
+  if (it == file_ids_.end())
+    return true;
+  FileEntry& entry = files_[it->second];
+  if (entry.last_modified != last_modified)
+    return true;
+  entry.job_id = job_id;
+  return false;
+}
+
+void DevToolsFileSystemIndexer::IndexFile(const FilePath& path,
+                                          const Time& last_modified,
+                                          int job_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  if (index_.empty()) {
+    index_.resize(kTrigramCount);
+    file_trigrams_.resize(kTrigramCount);
+  }
+
+  std::vector<Trigram> trigrams;
+  bool indexable = true;
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (file.IsValid()) {
+    TrigramReader reader;
+    std::vector<char> buffer(kReadChunkSize);
+    int read = 0;
+    while (indexable &&
+           (read = file.ReadAtCurrentPos(buffer.data(), buffer.size())) > 0) {
+      for (int i = 0; i < read; ++i) {
+        // Binary files are not searched.
+        if (buffer[i] == '\0') {
+          indexable = false;
+          break;
+        }
+        Trigram trigram = reader.Next(buffer[i]);
+        if (trigram >= 0 && !file_trigrams_[trigram]) {
+          file_trigrams_[trigram] = true;
+          trigrams.push_back(trigram);
+        }
+      }
+    }
+    if (read < 0)
+      indexable = false;
+  } else {
+    indexable = false;
+  }
+
+  for (Trigram trigram : trigrams)
+    file_trigrams_[trigram] = false;
+
+  auto it = file_ids_.find(path);
+  if (it != file_ids_.end())
+    files_[it->second].stale = true;
+  if (!indexable) {
+    if (it != file_ids_.end())
+      file_ids_.erase(it);
+    return;
+  }
+
+  FileId file_id = static_cast<FileId>(files_.size());
+  FileEntry entry = { path, last_modified, job_id, false };
+  files_.push_back(entry);
+  file_ids_[path] = file_id;
+  for (Trigram trigram : trigrams)
+    index_[trigram].push_back(file_id);
+}
+
+void DevToolsFileSystemIndexer::RemoveMissingFiles(
+    const FilePath& file_system_path, int job_id) {
+  for (auto it = file_ids_.begin(); it != file_ids_.end();) {
+    FileEntry& entry = files_[it->second];
+    if (entry.job_id != job_id && file_system_path.IsParent(entry.path)) {
+      entry.stale = true;
+      file_ids_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void DevToolsFileSystemIndexer::SearchInPathOnFileThread(
+    const std::string& file_system_path,
+    const std::string& query,
+    const SearchCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  std::vector<Trigram> trigrams;
+  TrigramReader reader;
+  for (char c : query) {
+    Trigram trigram = reader.Next(c);
+    if (trigram >= 0)
+      trigrams.push_back(trigram);
+  }
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()),
+                 trigrams.end());
+
+  // Without a trigram in the query every file is a candidate.
+  std::vector<FileId> file_ids;
+  if (trigrams.empty() || index_.empty()) {
+    for (const auto& it : file_ids_)
+      file_ids.push_back(it.second);
+  } else {
+    file_ids = index_[trigrams[0]];
+    for (size_t i = 1; i < trigrams.size() && !file_ids.empty(); ++i) {
+      const std::vector<FileId>& other = index_[trigrams[i]];
+      std::vector<FileId> intersection;
+      std::set_intersection(file_ids.begin(), file_ids.end(),
+                            other.begin(), other.end(),
+                            std::back_inserter(intersection));
+      file_ids.swap(intersection);
+    }
+  }
+
+  FilePath path = FilePath::FromUTF8Unsafe(file_system_path);
+  std::vector<std::string> result;
+  for (FileId file_id : file_ids) {
+    const FileEntry& entry = files_[file_id];
+    if (!entry.stale && path.IsParent(entry.path))
+      result.push_back(entry.path.AsUTF8Unsafe());
+  }
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(callback, result));
+}
@@ -0,0 +1,135 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_DEVTOOLS_DEVTOOLS_FILE_SYSTEM_INDEXER_H_
+#define CHROME_BROWSER_DEVTOOLS_DEVTOOLS_FILE_SYSTEM_INDEXER_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/time/time.h"
+
+// Indexes the files of the file systems added to DevTools by their trigrams,
+// so that DevTools only has to search the files that can contain a query. The
+// index is built and searched on the FILE thread, the callbacks are called on
+// the UI thread.
+class DevToolsFileSystemIndexer
+    : public base::RefCountedThreadSafe<DevToolsFileSystemIndexer> {
+ public:
+  typedef base::Callback<void(int)> TotalWorkCallback;
+  typedef base::Callback<void(int)> WorkedCallback;
+  typedef base::Callback<void()> DoneCallback;
+  typedef base::Callback<void(const std::vector<std::string>&)> SearchCallback;
+
+  // The indexing of one file system, which can be stopped.
+  class FileSystemIndexingJob
+      : public base::RefCountedThreadSafe<FileSystemIndexingJob> {
+   public:
+    void Stop();
+
+   private:
+    friend class base::RefCountedThreadSafe<FileSystemIndexingJob>;
+    friend class DevToolsFileSystemIndexer;
+    FileSystemIndexingJob(DevToolsFileSystemIndexer* indexer,
+                          const base::FilePath& file_system_path,
+                          const TotalWorkCallback& total_work_callback,
+                          const WorkedCallback& worked_callback,
+                          const DoneCallback& done_callback);
+    virtual ~FileSystemIndexingJob();
+
+    void Start();
+    void StopOnFileThread();
+    void CollectFilesToIndex();
+    void IndexFiles();
+    void ReportWorked(bool force);
+    void Finish();
+
+    scoped_refptr<DevToolsFileSystemIndexer> indexer_;
+    base::FilePath file_system_path_;
+    TotalWorkCallback total_work_callback_;
+    WorkedCallback worked_callback_;
+    DoneCallback done_callback_;
+
+    // Only used on the FILE thread.
+    int id_;
+    std::vector<base::FilePath> pending_directories_;
+    std::vector<std::pair<base::FilePath, base::Time>> pending_files_;
+    size_t next_file_;
+    int unreported_worked_;
+    base::TimeTicks last_worked_notification_;
+    bool stopped_;
+
+    DISALLOW_COPY_AND_ASSIGN(FileSystemIndexingJob);
+  };
+
+  DevToolsFileSystemIndexer();
+
+  // Indexes the files under |file_system_path|, the files indexed before are
+  // only read again when they have changed.
+  scoped_refptr<FileSystemIndexingJob> IndexPath(
+      const std::string& file_system_path,
+      const TotalWorkCallback& total_work_callback,
+      const WorkedCallback& worked_callback,
+      const DoneCallback& done_callback);
+
+  // Calls |callback| with the indexed files under |file_system_path| that can
+  // contain |query|.
+  void SearchInPath(const std::string& file_system_path,
+                    const std::string& query,
+                    const SearchCallback& callback);
+
+ private:
+  friend class base::RefCountedThreadSafe<DevToolsFileSystemIndexer>;
+
+  typedef int FileId;
+
+  struct FileEntry {
+    base::FilePath path;
+    base::Time last_modified;
+    // The last indexing job that found the file.
+    int job_id;
+    // The entry of a file that changed or was removed after it was indexed is
+    // kept out of the results, a changed file is indexed again under a new id.
+    bool stale;
+  };
+
+  virtual ~DevToolsFileSystemIndexer();
+
+  // Returns whether |path| has to be read into the index, and marks the file
+  // as found by the job |job_id|.
+  bool NeedsIndexing(const base::FilePath& path,
+                     const base::Time& last_modified,
+                     int job_id);
+  void IndexFile(const base::FilePath& path,
+                 const base::Time& last_modified,
+                 int job_id);
+  // Marks the files under |file_system_path| that the job |job_id| did not
+  // find as removed.
+  void RemoveMissingFiles(const base::FilePath& file_system_path, int job_id);
+
+  void SearchInPathOnFileThread(const std::string& file_system_path,
+                                const std::string& query,
+                                const SearchCallback& callback);
+
+  int next_job_id_;
+
+  // The files, an id is the index of its file.
+  std::vector<FileEntry> files_;
+  std::map<base::FilePath, FileId> file_ids_;
+
+  // The sorted ids of the files containing each trigram.
+  std::vector<std::vector<FileId>> index_;
+
+  // Marks the trigrams found in the file being indexed.
+  std::vector<bool> file_trigrams_;
+
+  DISALLOW_COPY_AND_ASSIGN(DevToolsFileSystemIndexer);
+};
+
+#endif  // CHROME_BROWSER_DEVTOOLS_DEVTOOLS_FILE_SYSTEM_INDEXER_H_
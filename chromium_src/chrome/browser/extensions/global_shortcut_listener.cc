@@ -4,7 +4,10 @@
 
 #include "chrome/browser/extensions/global_shortcut_listener.h"
 
+#include <set>
+
 #include "base/logging.h"
+#include "base/stl_util.h"
 #include "content/public/browser/browser_thread.h"
 #include "ui/base/accelerators/accelerator.h"
 
@@ -47,6 +50,43 @@ bool GlobalShortcutListener::RegisterAccelerator(
   return true;
 }
 
+std::vector<bool> GlobalShortcutListener::RegisterAccelerators(
+    const std::vector<ui::Accelerator>& accelerators, Observer* observer) {
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  std::vector<bool> registered(accelerators.size(), false);
+  if (IsShortcutHandlingSuspended())
+    return registered;
+
+  // The accelerators that are not registered yet, each of them once, and their
+  // indexes in |accelerators|.
+  std::vector<ui::Accelerator> pending;
+  std::vector<size_t> indexes;
+  std::set<ui::Accelerator> seen;
+  for (size_t i = 0; i < accelerators.size(); ++i) {
+    if (ContainsKey(accelerator_map_, accelerators[i]) ||
+        !seen.insert(accelerators[i]).second)
+      continue;
+    pending.push_back(accelerators[i]);
+    indexes.push_back(i);
+  }
+  if (pending.empty())
+    return registered;
+
+  std::vector<bool> results;
+  RegisterAcceleratorsImpl(pending, &results);
+
+  bool was_empty = accelerator_map_.empty();
+  for (size_t i = 0; i < pending.size(); ++i) {
+    if (!results[i])
+      continue;
+    accelerator_map_[pending[i]] = observer;
+    registered[indexes[i]] = true;
+  }
+  if (was_empty && !accelerator_map_.empty())
+    StartListening();
+  return registered;
+}
+
 void GlobalShortcutListener::UnregisterAccelerator(
     const ui::Accelerator& accelerator, Observer* observer) {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
@@ -87,18 +127,25 @@ void GlobalShortcutListener::SetShortcutHandlingSuspended(bool suspended) {
     return;
 
   shortcut_handling_suspended_ = suspended;
-  for (AcceleratorMap::iterator it = accelerator_map_.begin();
-       it != accelerator_map_.end();
-       ++it) {
-    // On Linux, when shortcut handling is suspended we cannot simply early
-    // return in NotifyKeyPressed (similar to what we do for non-global
-    // shortcuts) because we'd eat the keyboard event thereby preventing the
-    // user from setting the shortcut. Therefore we must unregister while
-    // handling is suspended and register when handling resumes.
-    if (shortcut_handling_suspended_)
+
+  // On Linux, when shortcut handling is suspended we cannot simply early
+  // return in NotifyKeyPressed (similar to what we do for non-global
+  // shortcuts) because we'd eat the keyboard event thereby preventing the
+  // user from setting the shortcut. Therefore we must unregister while
+  // handling is suspended and register when handling resumes.
+  if (shortcut_handling_suspended_) {
+    for (AcceleratorMap::iterator it = accelerator_map_.begin();
+         it != accelerator_map_.end();
+         ++it)
       UnregisterAcceleratorImpl(it->first);
-    else
-      RegisterAcceleratorImpl(it->first);
+  } else {
+    std::vector<ui::Accelerator> accelerators;
+    for (AcceleratorMap::iterator it = accelerator_map_.begin();
+         it != accelerator_map_.end();
+         ++it)
+      accelerators.push_back(it->first);
+    std::vector<bool> registered;
+    RegisterAcceleratorsImpl(accelerators, &registered);
   }
 }
 
@@ -106,6 +153,17 @@ bool GlobalShortcutListener::IsShortcutHandlingSuspended() const {
   return shortcut_handling_suspended_;
 }
 
+void GlobalShortcutListener::SetGrabLockModifiers(bool grab) {
+}
+
+void GlobalShortcutListener::RegisterAcceleratorsImpl(
+    const std::vector<ui::Accelerator>& accelerators,
+    std::vector<bool>* registered) {
+  registered->clear();
+  for (const ui::Accelerator& accelerator : accelerators)
+    registered->push_back(RegisterAcceleratorImpl(accelerator));
+}
+
 void GlobalShortcutListener::NotifyKeyPressed(
     const ui::Accelerator& accelerator) {
   AcceleratorMap::iterator iter = accelerator_map_.find(accelerator);
@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_EXTENSIONS_GLOBAL_SHORTCUT_LISTENER_H_
 
 #include <map>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "ui/events/keycodes/keyboard_codes.h"
@@ -42,6 +43,13 @@ class GlobalShortcutListener {
   bool RegisterAccelerator(const ui::Accelerator& accelerator,
                            Observer* observer);
 
+  // Register |accelerators| for |observer| together, which lets the platform
+  // register them with fewer round trips. Returns whether each of them has
+  // been registered, in the same order.
+  std::vector<bool> RegisterAccelerators(
+      const std::vector<ui::Accelerator>& accelerators,
+      Observer* observer);
+
   // Stop listening for the given |accelerator|, does nothing if shortcut
   // handling is suspended.
   void UnregisterAccelerator(const ui::Accelerator& accelerator,
@@ -59,6 +67,12 @@ class GlobalShortcutListener {
   // Returns whether shortcut handling is currently suspended.
   bool IsShortcutHandlingSuspended() const;
 
+  // Sets whether the shortcuts are also registered with the lock modifiers
+  // (Num lock, Caps lock and Scroll lock) held, so they work whatever the
+  // state of the locks is. Only X11 registers them separately, the other
+  // platforms ignore it.
+  virtual void SetGrabLockModifiers(bool grab);
+
  protected:
   GlobalShortcutListener();
 
@@ -83,6 +97,12 @@ class GlobalShortcutListener {
   virtual void UnregisterAcceleratorImpl(
       const ui::Accelerator& accelerator) = 0;
 
+  // Registers |accelerators| and sets whether each of them succeeded in
+  // |registered|, by default they are registered one by one.
+  virtual void RegisterAcceleratorsImpl(
+      const std::vector<ui::Accelerator>& accelerators,
+      std::vector<bool>* registered);
+
   // The map of accelerators that have been successfully registered as global
   // shortcuts and their observer.
   typedef std::map<ui::Accelerator, Observer*> AcceleratorMap;
@@ -4,6 +4,7 @@
 
 #include "chrome/browser/extensions/global_shortcut_listener_x11.h"
 
+#include "base/stl_util.h"
 #include "content/public/browser/browser_thread.h"
 #include "ui/base/accelerators/accelerator.h"
 #include "ui/events/keycodes/keyboard_code_conversion_x.h"
@@ -30,6 +31,10 @@ const unsigned int kModifiersMasks[] = {
   Mod2Mask | LockMask | Mod5Mask
 };
 
+// The modifiers that are part of accelerators.
+const unsigned int kAcceleratorModifiersMask =
+    ShiftMask | ControlMask | Mod1Mask | Mod4Mask;
+
 int GetNativeModifiers(const ui::Accelerator& accelerator) {
   int modifiers = 0;
   modifiers |= accelerator.IsShiftDown() ? ShiftMask : 0;
@@ -55,7 +60,8 @@ GlobalShortcutListener* GlobalShortcutListener::GetInstance() {
 GlobalShortcutListenerX11::GlobalShortcutListenerX11()
     : is_listening_(false),
       x_display_(gfx::GetXDisplay()),
-      x_root_window_(DefaultRootWindow(x_display_)) {
+      x_root_window_(DefaultRootWindow(x_display_)),
+      grab_lock_modifiers_(true) {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
 }
 
@@ -86,7 +92,9 @@ void GlobalShortcutListenerX11::StopListening() {
 
 bool GlobalShortcutListenerX11::CanDispatchEvent(
     const ui::PlatformEvent& event) {
-  return event->type == KeyPress;
+  // The key events of our own windows are left alone.
+  return event->type == KeyPress &&
+         ContainsKey(registered_hot_keys_, GetNativeKey(event));
 }
 
 uint32_t GlobalShortcutListenerX11::DispatchEvent(
@@ -97,65 +105,132 @@ uint32_t GlobalShortcutListenerX11::DispatchEvent(
   return ui::POST_DISPATCH_NONE;
 }
 
+void GlobalShortcutListenerX11::SetGrabLockModifiers(bool grab) {
+  if (grab_lock_modifiers_ == grab)
+    return;
+
+  std::vector<ui::Accelerator> accelerators;
+  for (const auto& hot_key : registered_hot_keys_) {
+    UngrabKey(hot_key.first);
+    accelerators.push_back(hot_key.second);
+  }
+  registered_hot_keys_.clear();
+
+  grab_lock_modifiers_ = grab;
+  std::vector<bool> registered;
+  RegisterAcceleratorsImpl(accelerators, &registered);
+  for (size_t i = 0; i < registered.size(); ++i)
+    LOG_IF(WARNING, !registered[i]) << "Failed to grab the key "
+                                    << accelerators[i].key_code();
+}
+
 bool GlobalShortcutListenerX11::RegisterAcceleratorImpl(
     const ui::Accelerator& accelerator) {
-  DCHECK(registered_hot_keys_.find(accelerator) == registered_hot_keys_.end());
+  std::vector<bool> registered;
+  RegisterAcceleratorsImpl(std::vector<ui::Accelerator>(1, accelerator),
+                           &registered);
+  return registered[0];
+}
 
-  int modifiers = GetNativeModifiers(accelerator);
-  KeyCode keycode = XKeysymToKeycode(x_display_,
-      XKeysymForWindowsKeyCode(accelerator.key_code(), false));
-  gfx::X11ErrorTracker err_tracker;
+void GlobalShortcutListenerX11::UnregisterAcceleratorImpl(
+    const ui::Accelerator& accelerator) {
+  // The key may have been lost by grabbing it again in SetGrabLockModifiers.
+  NativeKey key = GetNativeKey(accelerator);
+  if (!ContainsKey(registered_hot_keys_, key))
+    return;
 
-  // Because XGrabKey only works on the exact modifiers mask, we should register
-  // our hot keys with modifiers that we want to ignore, including Num lock,
-  // Caps lock, Scroll lock. See comment about |kModifiersMasks|.
-  for (size_t i = 0; i < arraysize(kModifiersMasks); ++i) {
-    XGrabKey(x_display_, keycode, modifiers | kModifiersMasks[i],
-             x_root_window_, False, GrabModeAsync, GrabModeAsync);
-  }
+  UngrabKey(key);
+  registered_hot_keys_.erase(key);
+}
 
-  if (err_tracker.FoundNewError()) {
+void GlobalShortcutListenerX11::RegisterAcceleratorsImpl(
+    const std::vector<ui::Accelerator>& accelerators,
+    std::vector<bool>* registered) {
+  registered->assign(accelerators.size(), false);
+
+  // Keys without a keycode, or taken by another accelerator, are skipped.
+  std::vector<NativeKey> keys(accelerators.size());
+  std::vector<size_t> grabbed;
+  for (size_t i = 0; i < accelerators.size(); ++i) {
+    keys[i] = GetNativeKey(accelerators[i]);
+    if (keys[i].first == 0 || ContainsKey(registered_hot_keys_, keys[i]))
+      continue;
+    registered_hot_keys_[keys[i]] = accelerators[i];
+    grabbed.push_back(i);
+  }
+  if (grabbed.empty())
+    return;
+
+  // All the keys are grabbed with one round trip, and only when one of them is
+  // taken by another client they are grabbed again one by one to find it.
+  bool found_error;
+  {
+    gfx::X11ErrorTracker err_tracker;
+    for (size_t i : grabbed)
+      GrabKey(keys[i]);
+    found_error = err_tracker.FoundNewError();
+  }
+  if (found_error) {
     // We may have part of the hotkeys registered, clean up.
-    for (size_t i = 0; i < arraysize(kModifiersMasks); ++i) {
-      XUngrabKey(x_display_, keycode, modifiers | kModifiersMasks[i],
-                 x_root_window_);
+    for (size_t i : grabbed)
+      UngrabKey(keys[i]);
+
+    std::vector<size_t> all = grabbed;
+    grabbed.clear();
+    for (size_t i : all) {
+      gfx::X11ErrorTracker err_tracker;
+      GrabKey(keys[i]);
+      if (err_tracker.FoundNewError()) {
+        UngrabKey(keys[i]);
+        registered_hot_keys_.erase(keys[i]);
+      } else {
+        grabbed.push_back(i);
+      }
     }
-
-    return false;
   }
 
-  registered_hot_keys_.insert(accelerator);
-  return true;
+  for (size_t i : grabbed)
+    (*registered)[i] = true;
 }
 
-void GlobalShortcutListenerX11::UnregisterAcceleratorImpl(
+GlobalShortcutListenerX11::NativeKey GlobalShortcutListenerX11::GetNativeKey(
     const ui::Accelerator& accelerator) {
-  DCHECK(registered_hot_keys_.find(accelerator) != registered_hot_keys_.end());
-
-  int modifiers = GetNativeModifiers(accelerator);
   KeyCode keycode = XKeysymToKeycode(x_display_,
       XKeysymForWindowsKeyCode(accelerator.key_code(), false));
+  return NativeKey(keycode, GetNativeModifiers(accelerator));
+}
+
+GlobalShortcutListenerX11::NativeKey GlobalShortcutListenerX11::GetNativeKey(
+    const ::XEvent* x_event) const {
+  return NativeKey(x_event->xkey.keycode,
+                   x_event->xkey.state & kAcceleratorModifiersMask);
+}
 
-  for (size_t i = 0; i < arraysize(kModifiersMasks); ++i) {
-    XUngrabKey(x_display_, keycode, modifiers | kModifiersMasks[i],
+void GlobalShortcutListenerX11::GrabKey(const NativeKey& key) {
+  // Because XGrabKey only works on the exact modifiers mask, we should register
+  // our hot keys with modifiers that we want to ignore, including Num lock,
+  // Caps lock, Scroll lock. See comment about |kModifiersMasks|.
+  size_t count = grab_lock_modifiers_ ? arraysize(kModifiersMasks) : 1;
+  for (size_t i = 0; i < count; ++i) {
+    XGrabKey(x_display_, key.first, key.second | kModifiersMasks[i],
+             x_root_window_, False, GrabModeAsync, GrabModeAsync);
+  }
+}
+
+void GlobalShortcutListenerX11::UngrabKey(const NativeKey& key) {
+  size_t count = grab_lock_modifiers_ ? arraysize(kModifiersMasks) : 1;
+  for (size_t i = 0; i < count; ++i) {
+    XUngrabKey(x_display_, key.first, key.second | kModifiersMasks[i],
                x_root_window_);
   }
-  registered_hot_keys_.erase(accelerator);
 }
 
 void GlobalShortcutListenerX11::OnXKeyPressEvent(::XEvent* x_event) {
   DCHECK(x_event->type == KeyPress);
-  int modifiers = 0;
-  modifiers |= (x_event->xkey.state & ShiftMask) ? ui::EF_SHIFT_DOWN : 0;
-  modifiers |= (x_event->xkey.state & ControlMask) ? ui::EF_CONTROL_DOWN : 0;
-  modifiers |= (x_event->xkey.state & Mod1Mask) ? ui::EF_ALT_DOWN : 0;
-  // For Windows key
-  modifiers |= (x_event->xkey.state & Mod4Mask) ? ui::EF_COMMAND_DOWN: 0;
-
-  ui::Accelerator accelerator(
-      ui::KeyboardCodeFromXKeyEvent(x_event), modifiers);
-  if (registered_hot_keys_.find(accelerator) != registered_hot_keys_.end())
-    NotifyKeyPressed(accelerator);
+  RegisteredHotKeys::const_iterator it =
+      registered_hot_keys_.find(GetNativeKey(x_event));
+  if (it != registered_hot_keys_.end())
+    NotifyKeyPressed(it->second);
 }
 
 }  // namespace extensions
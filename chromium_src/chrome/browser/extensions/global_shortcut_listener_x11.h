@@ -6,7 +6,9 @@
 #define CHROME_BROWSER_EXTENSIONS_GLOBAL_SHORTCUT_LISTENER_X11_H_
 
 #include <X11/Xlib.h>
-#include <set>
+#include <map>
+#include <utility>
+#include <vector>
 
 #include "chrome/browser/extensions/global_shortcut_listener.h"
 #include "ui/events/platform/platform_event_dispatcher.h"
@@ -26,7 +28,14 @@ class GlobalShortcutListenerX11 : public GlobalShortcutListener,
   virtual bool CanDispatchEvent(const ui::PlatformEvent& event) override;
   virtual uint32_t DispatchEvent(const ui::PlatformEvent& event) override;
 
+  // GlobalShortcutListener implementation.
+  void SetGrabLockModifiers(bool grab) override;
+
  private:
+  // The keycode and X modifiers of an accelerator, which is what key events
+  // carry.
+  typedef std::pair<KeyCode, unsigned int> NativeKey;
+
   // GlobalShortcutListener implementation.
   virtual void StartListening() override;
   virtual void StopListening() override;
@@ -34,6 +43,16 @@ class GlobalShortcutListenerX11 : public GlobalShortcutListener,
       const ui::Accelerator& accelerator) override;
   virtual void UnregisterAcceleratorImpl(
       const ui::Accelerator& accelerator) override;
+  void RegisterAcceleratorsImpl(
+      const std::vector<ui::Accelerator>& accelerators,
+      std::vector<bool>* registered) override;
+
+  NativeKey GetNativeKey(const ui::Accelerator& accelerator);
+  NativeKey GetNativeKey(const ::XEvent* x_event) const;
+
+  // Grab or ungrab |key| with each of the lock modifiers masks.
+  void GrabKey(const NativeKey& key);
+  void UngrabKey(const NativeKey& key);
 
   // Invoked when a global shortcut is pressed.
   void OnXKeyPressEvent(::XEvent* x_event);
@@ -45,8 +64,11 @@ class GlobalShortcutListenerX11 : public GlobalShortcutListener,
   ::Display* x_display_;
   ::Window x_root_window_;
 
-  // A set of registered accelerators.
-  typedef std::set<ui::Accelerator> RegisteredHotKeys;
+  // Whether the keys are also grabbed with the lock modifiers held.
+  bool grab_lock_modifiers_;
+
+  // The registered accelerators, indexed the way key events find them.
+  typedef std::map<NativeKey, ui::Accelerator> RegisteredHotKeys;
   RegisteredHotKeys registered_hot_keys_;
 
   DISALLOW_COPY_AND_ASSIGN(GlobalShortcutListenerX11);
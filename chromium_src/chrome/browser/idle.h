@@ -0,0 +1,31 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_IDLE_H_
+#define CHROME_BROWSER_IDLE_H_
+
+enum IdleState {
+  IDLE_STATE_ACTIVE = 0,
+  IDLE_STATE_IDLE = 1,    // No activity within threshold.
+  IDLE_STATE_LOCKED = 2,  // Only available on supported systems.
+  IDLE_STATE_UNKNOWN = 3  // Used when waiting for the Idle state or in error
+                          // conditions
+};
+
+#if defined(OS_MACOSX)
+// Starts observing the screen saver and the screen lock, must be called once
+// on the UI thread before the idle state is calculated.
+void InitIdleMonitor();
+#endif
+
+// Calculates the idle state, |idle_threshold| is in seconds.
+IdleState CalculateIdleState(int idle_threshold);
+
+// Returns the seconds since the last user input.
+int CalculateIdleTime();
+
+// Checks synchronously if the screen is locked or the screen saver runs.
+bool CheckIdleStateIsLocked();
+
+#endif  // CHROME_BROWSER_IDLE_H_
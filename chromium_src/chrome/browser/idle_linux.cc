@@ -0,0 +1,36 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/idle.h"
+
+#include <X11/Xlib.h>
+#include <X11/extensions/scrnsaver.h>
+
+#include "ui/gfx/x/x11_types.h"
+
+int CalculateIdleTime() {
+  XDisplay* display = gfx::GetXDisplay();
+  if (!display)
+    return 0;
+
+  int event_base, error_base;
+  if (!XScreenSaverQueryExtension(display, &event_base, &error_base))
+    return 0;
+
+  XScreenSaverInfo* info = XScreenSaverAllocInfo();
+  if (!info)
+    return 0;
+
+  int idle_time = 0;
+  if (XScreenSaverQueryInfo(display, DefaultRootWindow(display), info))
+    idle_time = info->idle / 1000;
+  XFree(info);
+  return idle_time;
+}
+
+bool CheckIdleStateIsLocked() {
+  // Screen lockers are separate programs on Linux, there is no common way to
+  // ask whether one of them is active.
+  return false;
+}
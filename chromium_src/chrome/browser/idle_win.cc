@@ -0,0 +1,54 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/idle.h"
+
+#include <limits.h>
+#include <windows.h>
+
+namespace {
+
+bool IsScreensaverRunning() {
+  DWORD result = 0;
+  if (::SystemParametersInfo(SPI_GETSCREENSAVERRUNNING, 0, &result, 0))
+    return result != FALSE;
+  return false;
+}
+
+bool IsWorkstationLocked() {
+  bool is_locked = true;
+  HDESK input_desk = ::OpenInputDesktop(0, 0, GENERIC_READ);
+  if (input_desk) {
+    wchar_t name[256] = {0};
+    DWORD needed = 0;
+    if (::GetUserObjectInformation(input_desk,
+                                   UOI_NAME,
+                                   name,
+                                   sizeof(name),
+                                   &needed)) {
+      is_locked = lstrcmpi(name, L"default") != 0;
+    }
+    ::CloseDesktop(input_desk);
+  }
+  return is_locked;
+}
+
+}  // namespace
+
+int CalculateIdleTime() {
+  LASTINPUTINFO last_input_info = {0};
+  last_input_info.cbSize = sizeof(LASTINPUTINFO);
+  DWORD now = ::GetTickCount();
+  if (!::GetLastInputInfo(&last_input_info))
+    return 0;
+
+  // The tick count wraps around after 49.7 days, the unsigned subtraction
+  // still gives the right interval.
+  DWORD idle_time = (now - last_input_info.dwTime) / 1000;
+  return idle_time > INT_MAX ? INT_MAX : static_cast<int>(idle_time);
+}
+
+bool CheckIdleStateIsLocked() {
+  return IsWorkstationLocked() || IsScreensaverRunning();
+}
@@ -4,12 +4,17 @@
 
 #include "chrome/browser/printing/pdf_to_emf_converter.h"
 
+#include <algorithm>
+#include <deque>
 #include <queue>
+#include <vector>
 
 #include "base/files/file.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/logging.h"
+#include "base/memory/linked_ptr.h"
+#include "base/sys_info.h"
 #include "chrome/common/chrome_utility_messages.h"
 #include "chrome/common/print_messages.h"
 #include "content/public/browser/browser_thread.h"
@@ -175,6 +180,11 @@ class PdfToEmfUtilityProcessHostClient
   DISALLOW_COPY_AND_ASSIGN(PdfToEmfUtilityProcessHostClient);
 };
 
+// Spreads the pages over several utility processes, each of them loading the
+// whole PDF. The first process finds out the page count, the others are only
+// started when the document has more than one page. Every process converts at
+// most kPagesPerProcess pages at a time, the pages that are done early wait
+// until the ones requested before them are done.
 class PdfToEmfConverterImpl : public PdfToEmfConverter {
  public:
   PdfToEmfConverterImpl();
@@ -192,7 +202,51 @@ class PdfToEmfConverterImpl : public PdfToEmfConverter {
   void RunCallback(const base::Closure& callback);
 
  private:
-  scoped_refptr<PdfToEmfUtilityProcessHostClient> utility_client_;
+  struct Worker {
+    explicit Worker(PdfToEmfUtilityProcessHostClient* client);
+    ~Worker();
+
+    scoped_refptr<PdfToEmfUtilityProcessHostClient> client;
+    // Whether the process has loaded the PDF.
+    bool ready;
+    int pages_in_progress;
+  };
+
+  struct PageRequest {
+    PageRequest(int page_number, const GetPageCallback& callback);
+    ~PageRequest();
+
+    int page_number;
+    GetPageCallback callback;
+    bool done;
+    float scale_factor;
+    scoped_ptr<MetafilePlayer> emf;
+  };
+
+  void StartWorker(size_t index);
+  void OnWorkerStarted(size_t index, int page_count);
+
+  // Hands the waiting pages to the least busy processes.
+  void AssignPages();
+  void OnPageConverted(PageRequest* request,
+                       size_t worker,
+                       int page_number,
+                       float scale_factor,
+                       scoped_ptr<MetafilePlayer> emf);
+
+  // Only kept until all processes have been started.
+  scoped_refptr<base::RefCountedMemory> data_;
+  PdfRenderSettings settings_;
+  StartCallback start_callback_;
+  int page_count_;
+
+  std::vector<Worker> workers_;
+
+  // All pages that are not passed to their callbacks yet, in the order they
+  // were requested, and the ones of them no process is converting yet.
+  std::deque<linked_ptr<PageRequest>> requests_;
+  std::queue<PageRequest*> waiting_requests_;
+
   base::WeakPtrFactory<PdfToEmfConverterImpl> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(PdfToEmfConverterImpl);
@@ -453,27 +507,137 @@ void PdfToEmfUtilityProcessHostClient::OnFailed() {
   utility_process_host_.reset();
 }
 
-PdfToEmfConverterImpl::PdfToEmfConverterImpl() : weak_ptr_factory_(this) {
+// Pages queued in a process beyond the one it is converting keep it busy
+// while the result of the previous one is sent back.
+const int kPagesPerProcess = 2;
+
+PdfToEmfConverterImpl::Worker::Worker(PdfToEmfUtilityProcessHostClient* client)
+    : client(client), ready(false), pages_in_progress(0) {
+}
+
+PdfToEmfConverterImpl::Worker::~Worker() {
+}
+
+PdfToEmfConverterImpl::PageRequest::PageRequest(
+    int page_number, const GetPageCallback& callback)
+    : page_number(page_number),
+      callback(callback),
+      done(false),
+      scale_factor(0.0f) {
+}
+
+PdfToEmfConverterImpl::PageRequest::~PageRequest() {
+}
+
+PdfToEmfConverterImpl::PdfToEmfConverterImpl()
+    : page_count_(0), weak_ptr_factory_(this) {
 }
 
 PdfToEmfConverterImpl::~PdfToEmfConverterImpl() {
-  if (utility_client_.get())
-    utility_client_->Stop();
+  for (const Worker& worker : workers_)
+    worker.client->Stop();
 }
 
 void PdfToEmfConverterImpl::Start(
     const scoped_refptr<base::RefCountedMemory>& data,
     const PdfRenderSettings& conversion_settings,
     const StartCallback& start_callback) {
-  DCHECK(!utility_client_.get());
-  utility_client_ = new PdfToEmfUtilityProcessHostClient(
-      weak_ptr_factory_.GetWeakPtr(), conversion_settings);
-  utility_client_->Start(data, start_callback);
+  DCHECK(workers_.empty());
+  data_ = data;
+  settings_ = conversion_settings;
+  start_callback_ = start_callback;
+  StartWorker(0);
 }
 
 void PdfToEmfConverterImpl::GetPage(int page_number,
                                     const GetPageCallback& get_page_callback) {
-  utility_client_->GetPage(page_number, get_page_callback);
+  PageRequest* request = new PageRequest(page_number, get_page_callback);
+  requests_.push_back(make_linked_ptr(request));
+  waiting_requests_.push(request);
+  AssignPages();
+}
+
+void PdfToEmfConverterImpl::StartWorker(size_t index) {
+  DCHECK_EQ(index, workers_.size());
+  workers_.push_back(Worker(new PdfToEmfUtilityProcessHostClient(
+      weak_ptr_factory_.GetWeakPtr(), settings_)));
+  workers_[index].client->Start(
+      data_,
+      base::Bind(&PdfToEmfConverterImpl::OnWorkerStarted,
+                 weak_ptr_factory_.GetWeakPtr(), index));
+}
+
+void PdfToEmfConverterImpl::OnWorkerStarted(size_t index, int page_count) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (index > 0) {
+    // Every process loads the same PDF, any other result means it failed.
+    workers_[index].ready = page_count == page_count_;
+    AssignPages();
+    return;
+  }
+
+  page_count_ = page_count;
+  workers_[index].ready = page_count > 0;
+  if (page_count > 0) {
+    int max_processes = kMaxUtilityProcesses;
+    int processes = std::min(std::min(max_processes, page_count),
+                             base::SysInfo::NumberOfProcessors());
+    for (int i = 1; i < processes; ++i)
+      StartWorker(i);
+  }
+  data_ = NULL;
+
+  // May delete this.
+  StartCallback start_callback = start_callback_;
+  start_callback_.Reset();
+  start_callback.Run(page_count);
+}
+
+void PdfToEmfConverterImpl::AssignPages() {
+  while (!waiting_requests_.empty()) {
+    Worker* worker = nullptr;
+    for (Worker& candidate : workers_) {
+      if (candidate.ready && candidate.pages_in_progress < kPagesPerProcess &&
+          (!worker ||
+           candidate.pages_in_progress < worker->pages_in_progress))
+        worker = &candidate;
+    }
+    if (!worker)
+      return;
+
+    PageRequest* request = waiting_requests_.front();
+    waiting_requests_.pop();
+    ++worker->pages_in_progress;
+    worker->client->GetPage(
+        request->page_number,
+        base::Bind(&PdfToEmfConverterImpl::OnPageConverted,
+                   weak_ptr_factory_.GetWeakPtr(), request,
+                   static_cast<size_t>(worker - &workers_[0])));
+  }
+}
+
+void PdfToEmfConverterImpl::OnPageConverted(PageRequest* request,
+                                            size_t worker,
+                                            int page_number,
+                                            float scale_factor,
+                                            scoped_ptr<MetafilePlayer> emf) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  --workers_[worker].pages_in_progress;
+  request->done = true;
+  request->scale_factor = scale_factor;
+  request->emf = emf.Pass();
+
+  // The callbacks may request more pages, or delete this.
+  base::WeakPtr<PdfToEmfConverterImpl> self = weak_ptr_factory_.GetWeakPtr();
+  while (!requests_.empty() && requests_.front()->done) {
+    linked_ptr<PageRequest> front = requests_.front();
+    requests_.pop_front();
+    front->callback.Run(front->page_number, front->scale_factor,
+                        front->emf.Pass());
+    if (!self)
+      return;
+  }
+  AssignPages();
 }
 
 void PdfToEmfConverterImpl::RunCallback(const base::Closure& callback) {
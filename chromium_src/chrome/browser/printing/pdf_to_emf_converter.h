@@ -25,6 +25,9 @@ class PdfToEmfConverter {
                               float scale_factor,
                               scoped_ptr<MetafilePlayer> emf)> GetPageCallback;
 
+  // The pages are converted in up to this many utility processes at once.
+  static const int kMaxUtilityProcesses = 4;
+
   virtual ~PdfToEmfConverter();
 
   static scoped_ptr<PdfToEmfConverter> CreateDefault();
@@ -38,7 +41,8 @@ class PdfToEmfConverter {
   // Requests conversion of the page. |page_number| is 0-base page number in
   // PDF provided in Start() call.
   // Calls |get_page_callback| after conversion. |emf| of callback in not NULL
-  // if conversion succeeded.
+  // if conversion succeeded. The callbacks are called in the order the pages
+  // were requested, even when later pages are converted first.
   virtual void GetPage(int page_number,
                        const GetPageCallback& get_page_callback) = 0;
 };
@@ -240,7 +240,10 @@ class PrintJob::PdfToEmfState {
 
   void GetMorePages(
       const PdfToEmfConverter::GetPageCallback& get_page_callback) {
-    const int kMaxNumberOfTempFilesPerDocument = 3;
+    // Bounds the converted pages waiting on disk for the printer, while
+    // keeping every utility process of the converter busy.
+    const int kMaxNumberOfTempFilesPerDocument =
+        2 * PdfToEmfConverter::kMaxUtilityProcesses;
     while (pages_in_progress_ < kMaxNumberOfTempFilesPerDocument &&
            current_page_ < page_count_) {
       ++pages_in_progress_;
@@ -5,6 +5,7 @@
 #include "chrome/browser/printing/print_preview_message_handler.h"
 
 #include "base/bind.h"
+#include "base/files/file_util.h"
 #include "base/memory/shared_memory.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/printing/print_job_manager.h"
@@ -40,17 +41,21 @@ void StopWorker(int document_cookie) {
   }
 }
 
-char* CopyPDFDataOnIOThread(
-    const PrintHostMsg_DidPreviewDocument_Params& params) {
-  DCHECK_CURRENTLY_ON(BrowserThread::IO);
-  scoped_ptr<base::SharedMemory> shared_buf(
-      new base::SharedMemory(params.metafile_data_handle, true));
-  if (!shared_buf->Map(params.data_size))
-    return nullptr;
-  char* memory_pdf_data = static_cast<char*>(shared_buf->memory());
-  char* pdf_data = new char[params.data_size];
-  memcpy(pdf_data, memory_pdf_data, params.data_size);
-  return pdf_data;
+// Writes the PDF straight from the shared memory to |path|.
+bool WritePDFDataOnFileThread(scoped_ptr<base::SharedMemory> shared_buf,
+                              uint32 data_size,
+                              const base::FilePath& path) {
+  DCHECK_CURRENTLY_ON(BrowserThread::FILE);
+  if (!shared_buf->Map(data_size))
+    return false;
+  int size = static_cast<int>(data_size);
+  return base::WriteFile(
+      path, static_cast<const char*>(shared_buf->memory()), size) == size;
+}
+
+// Unmaps the memory of a Buffer created from the shared memory.
+void FreeSharedMemory(char* data, void* hint) {
+  delete static_cast<base::SharedMemory*>(hint);
 }
 
 }  // namespace
@@ -60,7 +65,8 @@ namespace printing {
 
 PrintPreviewMessageHandler::PrintPreviewMessageHandler(
     WebContents* web_contents)
-    : content::WebContentsObserver(web_contents) {
+    : content::WebContentsObserver(web_contents),
+      weak_factory_(this) {
   DCHECK(web_contents);
 }
 
@@ -77,14 +83,26 @@ void PrintPreviewMessageHandler::OnMetafileReadyForPrinting(
     return;
   }
 
-  BrowserThread::PostTaskAndReplyWithResult(
-      BrowserThread::IO,
-      FROM_HERE,
-      base::Bind(&CopyPDFDataOnIOThread, params),
-      base::Bind(&PrintPreviewMessageHandler::RunPrintToPDFCallback,
-                 base::Unretained(this),
-                 params.preview_request_id,
-                 params.data_size));
+  int request_id = params.preview_request_id;
+  // The memory is mapped writable since it is handed to JavaScript as Buffer.
+  scoped_ptr<base::SharedMemory> shared_buf(
+      new base::SharedMemory(params.metafile_data_handle, false));
+  auto it = print_to_pdf_callback_map_.find(request_id);
+  if (it != print_to_pdf_callback_map_.end() && !it->second.path.empty()) {
+    BrowserThread::PostTaskAndReplyWithResult(
+        BrowserThread::FILE,
+        FROM_HERE,
+        base::Bind(&WritePDFDataOnFileThread,
+                   base::Passed(&shared_buf),
+                   params.data_size,
+                   it->second.path),
+        base::Bind(&PrintPreviewMessageHandler::RunPrintToPDFFileCallback,
+                   weak_factory_.GetWeakPtr(),
+                   request_id));
+    return;
+  }
+
+  RunPrintToPDFCallback(request_id, params.data_size, shared_buf.Pass());
 }
 
 void PrintPreviewMessageHandler::OnPrintPreviewFailed(int document_cookie,
@@ -93,6 +111,15 @@ void PrintPreviewMessageHandler::OnPrintPreviewFailed(int document_cookie,
   RunPrintToPDFCallback(request_id, 0, nullptr);
 }
 
+void PrintPreviewMessageHandler::OnDidPreviewPages(int request_id,
+                                                   int rendered_pages,
+                                                   int total_pages) {
+  auto it = print_to_pdf_callback_map_.find(request_id);
+  if (it != print_to_pdf_callback_map_.end() &&
+      !it->second.progress_callback.is_null())
+    it->second.progress_callback.Run(rendered_pages, total_pages);
+}
+
 bool PrintPreviewMessageHandler::OnMessageReceived(
     const IPC::Message& message) {
   bool handled = true;
@@ -101,6 +128,7 @@ bool PrintPreviewMessageHandler::OnMessageReceived(
                         OnMetafileReadyForPrinting)
     IPC_MESSAGE_HANDLER(PrintHostMsg_PrintPreviewFailed,
                         OnPrintPreviewFailed)
+    IPC_MESSAGE_HANDLER(PrintHostMsg_DidPreviewPages, OnDidPreviewPages)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
   return handled;
@@ -108,31 +136,64 @@ bool PrintPreviewMessageHandler::OnMessageReceived(
 
 void PrintPreviewMessageHandler::PrintToPDF(
     const base::DictionaryValue& options,
-    const atom::api::WebContents::PrintToPDFCallback& callback) {
+    const atom::api::WebContents::PrintToPDFCallback& callback,
+    const atom::api::WebContents::PrintToPDFProgressCallback&
+        progress_callback) {
   int request_id;
   options.GetInteger(printing::kPreviewRequestID, &request_id);
-  print_to_pdf_callback_map_[request_id] = callback;
+  PrintToPDFRequest& request = print_to_pdf_callback_map_[request_id];
+  request.callback = callback;
+  request.progress_callback = progress_callback;
+  std::string path;
+  if (options.GetString("path", &path))
+    request.path = base::FilePath::FromUTF8Unsafe(path);
 
   content::RenderViewHost* rvh = web_contents()->GetRenderViewHost();
   rvh->Send(new PrintMsg_PrintPreview(rvh->GetRoutingID(), options));
 }
 
 void PrintPreviewMessageHandler::RunPrintToPDFCallback(
-     int request_id, uint32 data_size, char* data) {
+     int request_id,
+     uint32 data_size,
+     scoped_ptr<base::SharedMemory> shared_buf) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
 
   v8::Isolate* isolate = v8::Isolate::GetCurrent();
   v8::Locker locker(isolate);
   v8::HandleScope handle_scope(isolate);
-  if (data) {
-    v8::Local<v8::Value> buffer = node::Buffer::New(isolate,
-        data, static_cast<size_t>(data_size)).ToLocalChecked();
-    print_to_pdf_callback_map_[request_id].Run(v8::Null(isolate), buffer);
+  v8::MaybeLocal<v8::Object> buffer;
+  if (shared_buf && shared_buf->Map(data_size)) {
+    // The Buffer uses the mapped memory and unmaps it when it is collected.
+    char* data = static_cast<char*>(shared_buf->memory());
+    buffer = node::Buffer::New(isolate, data, data_size, &FreeSharedMemory,
+                               shared_buf.release());
+  }
+
+  const auto& callback = print_to_pdf_callback_map_[request_id].callback;
+  if (!buffer.IsEmpty()) {
+    callback.Run(v8::Null(isolate), buffer.ToLocalChecked());
   } else {
     v8::Local<v8::String> error_message = v8::String::NewFromUtf8(isolate,
         "Fail to generate PDF");
-    print_to_pdf_callback_map_[request_id].Run(
-        v8::Exception::Error(error_message), v8::Null(isolate));
+    callback.Run(v8::Exception::Error(error_message), v8::Null(isolate));
+  }
+  print_to_pdf_callback_map_.erase(request_id);
+}
+
+void PrintPreviewMessageHandler::RunPrintToPDFFileCallback(int request_id,
+                                                           bool success) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  const auto& callback = print_to_pdf_callback_map_[request_id].callback;
+  if (success) {
+    callback.Run(v8::Null(isolate), v8::Null(isolate));
+  } else {
+    v8::Local<v8::String> error_message = v8::String::NewFromUtf8(isolate,
+        "Fail to write PDF");
+    callback.Run(v8::Exception::Error(error_message), v8::Null(isolate));
   }
   print_to_pdf_callback_map_.erase(request_id);
 }
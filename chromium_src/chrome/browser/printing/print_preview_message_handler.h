@@ -9,11 +9,18 @@
 
 #include "atom/browser/api/atom_api_web_contents.h"
 #include "base/compiler_specific.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
 
 struct PrintHostMsg_DidPreviewDocument_Params;
 
+namespace base {
+class SharedMemory;
+}
+
 namespace content {
 class WebContents;
 }
@@ -32,12 +39,20 @@ class PrintPreviewMessageHandler
   // content::WebContentsObserver implementation.
   bool OnMessageReceived(const IPC::Message& message) override;
 
-  void PrintToPDF(const base::DictionaryValue& options,
-                  const atom::api::WebContents::PrintToPDFCallback& callback);
+  void PrintToPDF(
+      const base::DictionaryValue& options,
+      const atom::api::WebContents::PrintToPDFCallback& callback,
+      const atom::api::WebContents::PrintToPDFProgressCallback&
+          progress_callback);
 
  private:
-  typedef std::map<int, atom::api::WebContents::PrintToPDFCallback>
-      PrintToPDFCallbackMap;
+  struct PrintToPDFRequest {
+    atom::api::WebContents::PrintToPDFCallback callback;
+    atom::api::WebContents::PrintToPDFProgressCallback progress_callback;
+    // The file the PDF is written to instead of being passed to |callback|.
+    base::FilePath path;
+  };
+  typedef std::map<int, PrintToPDFRequest> PrintToPDFCallbackMap;
 
   explicit PrintPreviewMessageHandler(content::WebContents* web_contents);
   friend class content::WebContentsUserData<PrintPreviewMessageHandler>;
@@ -46,11 +61,21 @@ class PrintPreviewMessageHandler
   void OnMetafileReadyForPrinting(
       const PrintHostMsg_DidPreviewDocument_Params& params);
   void OnPrintPreviewFailed(int document_cookie, int request_id);
+  void OnDidPreviewPages(int request_id, int rendered_pages, int total_pages);
 
-  void RunPrintToPDFCallback(int request_id, uint32 data_size, char* data);
+  // Passes the PDF in |shared_buf| to the callback without copying it when
+  // possible, |shared_buf| is null when printing has failed.
+  void RunPrintToPDFCallback(int request_id,
+                             uint32 data_size,
+                             scoped_ptr<base::SharedMemory> shared_buf);
+  void RunPrintToPDFFileCallback(int request_id, bool success);
 
   PrintToPDFCallbackMap print_to_pdf_callback_map_;
 
+  // The WebContents may be destroyed while the PDF is written on the FILE
+  // thread.
+  base::WeakPtrFactory<PrintPreviewMessageHandler> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(PrintPreviewMessageHandler);
 };
 
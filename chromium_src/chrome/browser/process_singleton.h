@@ -170,6 +170,11 @@ class ProcessSingleton : public base::NonThreadSafe {
   // Temporary directory to hold the socket.
   base::ScopedTempDir socket_dir_;
 
+#if defined(OS_LINUX)
+  // Link to the socket for second instances that hand off from main().
+  base::FilePath handoff_path_;
+#endif
+
   // Helper class for linux specific messages.  LinuxWatcher is ref counted
   // because it posts messages between threads.
   class LinuxWatcher;
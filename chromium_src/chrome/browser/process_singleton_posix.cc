@@ -86,6 +86,10 @@
 #include "ui/views/linux_ui/linux_ui.h"
 #endif
 
+#if defined(OS_LINUX)
+#include "atom/app/singleton_handoff_linux.h"
+#endif
+
 using content::BrowserThread;
 
 namespace {
@@ -987,6 +991,15 @@ bool ProcessSingleton::Create() {
   if (listen(sock, 5) < 0)
     NOTREACHED() << "listen failed: " << base::safe_strerror(errno);
 
+#if defined(OS_LINUX)
+  // Let second instances find the socket before they know the user data
+  // directory, failing to do so only makes them hand off later.
+  handoff_path_ = atom::GetSingletonHandoffPath(socket_path_.DirName());
+  UnlinkPath(handoff_path_);
+  if (!SymlinkPath(socket_target_path, handoff_path_))
+    handoff_path_.clear();
+#endif
+
   // In Electron the ProcessSingleton is created earlier than the IO
   // thread gets created, so we have to postpone the call until message
   // loop is up an running.
@@ -1004,6 +1017,13 @@ void ProcessSingleton::Cleanup() {
   UnlinkPath(socket_path_);
   UnlinkPath(cookie_path_);
   UnlinkPath(lock_path_);
+#if defined(OS_LINUX)
+  // Another primary instance may have replaced the link since.
+  if (!handoff_path_.empty() &&
+      ReadLink(handoff_path_) == socket_dir_.path().Append(
+          kSingletonSocketFilename))
+    UnlinkPath(handoff_path_);
+#endif
 }
 
 void ProcessSingleton::StartListening(int sock) {
@@ -294,6 +294,13 @@ IPC_MESSAGE_ROUTED2(PrintHostMsg_PrintPreviewFailed,
                     int /* document cookie */,
                     int /* request_id */);
 
+// Tells the browser how many pages of the document requested by a
+// PrintMsg_PrintPreview message have been rendered.
+IPC_MESSAGE_ROUTED3(PrintHostMsg_DidPreviewPages,
+                    int /* request_id */,
+                    int /* rendered pages */,
+                    int /* total pages */)
+
 #if defined(OS_WIN)
 // Tell the utility process to start rendering the given PDF into a metafile.
 // Utility process would be alive until
@@ -4,9 +4,12 @@
 
 #include "chrome/renderer/pepper/pepper_shared_memory_message_filter.h"
 
-#include "base/memory/scoped_ptr.h"
+#include "base/bind.h"
+#include "base/location.h"
 #include "base/memory/shared_memory.h"
 #include "base/process/process_handle.h"
+#include "base/single_thread_task_runner.h"
+#include "base/thread_task_runner_handle.h"
 #include "content/public/common/content_client.h"
 #include "content/public/renderer/pepper_plugin_instance.h"
 #include "content/public/renderer/render_thread.h"
@@ -15,9 +18,34 @@
 #include "ppapi/proxy/ppapi_messages.h"
 #include "ppapi/shared_impl/var_tracker.h"
 
+namespace {
+
+// Plugins only send the ArrayBuffers of 256KB or more in shared memory, the
+// requests are rounded up to a power of two so the regions fit requests of
+// near sizes.
+const uint32_t kMinPooledSize = 256 * 1024;
+
+// How many regions of each size are kept ready.
+const size_t kMaxPooledRegions = 2;
+
+// The memory the pool of a plugin can hold.
+const size_t kMaxPooledBytes = 32 * 1024 * 1024;
+
+uint32_t GetPooledSize(size_t index) {
+  return kMinPooledSize << index;
+}
+
+}  // namespace
+
 PepperSharedMemoryMessageFilter::PepperSharedMemoryMessageFilter(
     content::RendererPpapiHost* host)
-    : InstanceMessageFilter(host->GetPpapiHost()), host_(host) {}
+    : InstanceMessageFilter(host->GetPpapiHost()),
+      host_(host),
+      pooled_bytes_(0),
+      weak_factory_(this) {
+  for (size_t i = 0; i < kPooledSizeCount; ++i)
+    refill_pending_[i] = false;
+}
 
 PepperSharedMemoryMessageFilter::~PepperSharedMemoryMessageFilter() {}
 
@@ -43,9 +71,7 @@ void PepperSharedMemoryMessageFilter::OnHostMsgCreateSharedMemory(
     ppapi::proxy::SerializedHandle* plugin_handle) {
   plugin_handle->set_null_shmem();
   *host_handle_id = -1;
-  scoped_ptr<base::SharedMemory> shm(content::RenderThread::Get()
-                                         ->HostAllocateSharedMemoryBuffer(size)
-                                         .Pass());
+  scoped_ptr<base::SharedMemory> shm(CreateRegion(size));
   if (!shm.get())
     return;
 
@@ -62,3 +88,58 @@ void PepperSharedMemoryMessageFilter::OnHostMsgCreateSharedMemory(
   plugin_handle->set_shmem(
       host_->ShareSharedMemoryHandleWithRemote(host_shm_handle), size);
 }
+
+scoped_ptr<base::SharedMemory> PepperSharedMemoryMessageFilter::CreateRegion(
+    uint32_t size) {
+  size_t index = 0;
+  while (index < kPooledSizeCount && size > GetPooledSize(index))
+    ++index;
+  if (index == kPooledSizeCount)
+    return content::RenderThread::Get()->HostAllocateSharedMemoryBuffer(size);
+
+  // The plugin only maps the |size| bytes it asked for of the larger region.
+  scoped_ptr<base::SharedMemory> shm;
+  ScopedVector<base::SharedMemory>& regions = pool_[index];
+  if (!regions.empty()) {
+    shm.reset(regions.back());
+    regions.weak_erase(regions.end() - 1);
+    pooled_bytes_ -= GetPooledSize(index);
+  } else {
+    shm = content::RenderThread::Get()->HostAllocateSharedMemoryBuffer(
+        GetPooledSize(index));
+  }
+
+  // A plugin asking for a size usually asks for it again soon.
+  ScheduleRefill(index);
+  return shm.Pass();
+}
+
+void PepperSharedMemoryMessageFilter::ScheduleRefill(size_t index) {
+  if (refill_pending_[index])
+    return;
+  refill_pending_[index] = true;
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::Bind(&PepperSharedMemoryMessageFilter::RefillPool,
+                 weak_factory_.GetWeakPtr(), index));
+}
+
+void PepperSharedMemoryMessageFilter::RefillPool(size_t index) {
+  refill_pending_[index] = false;
+  uint32_t pooled_size = GetPooledSize(index);
+  if (pool_[index].size() >= kMaxPooledRegions ||
+      pooled_bytes_ + pooled_size > kMaxPooledBytes)
+    return;
+
+  scoped_ptr<base::SharedMemory> shm(
+      content::RenderThread::Get()->HostAllocateSharedMemoryBuffer(
+          pooled_size));
+  if (!shm.get())
+    return;
+  pool_[index].push_back(shm.release());
+  pooled_bytes_ += pooled_size;
+
+  // Allocates one region per task, so the messages of the plugin are handled
+  // between the round trips.
+  ScheduleRefill(index);
+}
@@ -7,9 +7,16 @@
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/memory/weak_ptr.h"
 #include "ppapi/c/pp_instance.h"
 #include "ppapi/host/instance_message_filter.h"
 
+namespace base {
+class SharedMemory;
+}
+
 namespace content {
 class RendererPpapiHost;
 }
@@ -21,6 +28,10 @@ class SerializedHandle;
 }
 
 // Implements the backend for shared memory messages from a plugin process.
+//
+// The renderer has to ask the browser for shared memory with a sync message,
+// so regions of the sizes the plugin asks for are allocated ahead of time and
+// handed to the plugin without the round trip.
 class PepperSharedMemoryMessageFilter
     : public ppapi::host::InstanceMessageFilter {
  public:
@@ -40,8 +51,25 @@ class PepperSharedMemoryMessageFilter
       int* host_shm_handle_id,
       ppapi::proxy::SerializedHandle* plugin_shm_handle);
 
+  // The pooled sizes are the powers of two from 256KB to 16MB.
+  static const size_t kPooledSizeCount = 7;
+
+  // Returns a region of at least |size| bytes, from the pool when it can.
+  scoped_ptr<base::SharedMemory> CreateRegion(uint32_t size);
+
+  // Allocates a region for the pooled size |index| after the current task.
+  void ScheduleRefill(size_t index);
+  void RefillPool(size_t index);
+
   content::RendererPpapiHost* host_;
 
+  // The regions allocated ahead of time, by the index of their pooled size.
+  ScopedVector<base::SharedMemory> pool_[kPooledSizeCount];
+  size_t pooled_bytes_;
+  bool refill_pending_[kPooledSizeCount];
+
+  base::WeakPtrFactory<PepperSharedMemoryMessageFilter> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(PepperSharedMemoryMessageFilter);
 };
 
@@ -782,11 +782,15 @@ bool PrintWebViewHelper::CreatePreviewDocument() {
     return false;
   }
 
+  int rendered_pages = 0;
   while (!print_preview_context_.IsFinalPageRendered()) {
     int page_number = print_preview_context_.GetNextPageNumber();
     DCHECK_GE(page_number, 0);
     if (!RenderPreviewPage(page_number, print_params))
       return false;
+    Send(new PrintHostMsg_DidPreviewPages(
+        routing_id(), print_params.preview_request_id, ++rendered_pages,
+        print_preview_context_.total_page_count()));
 
     // We must call PrepareFrameAndViewForPrint::FinishPrinting() (by way of
     // print_preview_context_.AllPagesRendered()) before calling
@@ -0,0 +1,47 @@
+#!/usr/bin/env python
+
+import os
+import subprocess
+import sys
+
+from lib.util import atom_gyp
+
+
+SOURCE_ROOT = os.path.abspath(os.path.dirname(os.path.dirname(__file__)))
+
+PROJECT_NAME = atom_gyp()['project_name%']
+PRODUCT_NAME = atom_gyp()['product_name%']
+
+
+def main():
+  os.chdir(SOURCE_ROOT)
+
+  args = sys.argv[1:]
+  config = 'R'
+  if '-D' in args:
+    config = 'D'
+    args.remove('-D')
+  benchmark = os.path.join(SOURCE_ROOT, 'spec', 'benchmark')
+  # The suites share one app, which runs the ipc benchmarks by default.
+  for suite in ['asar', 'capture', 'leak', 'protocol', 'remote']:
+    if '--' + suite in args:
+      args.remove('--' + suite)
+      args.append('--suite=' + suite)
+      break
+
+  if sys.platform == 'darwin':
+    atom_shell = os.path.join(SOURCE_ROOT, 'out', config,
+                              '{0}.app'.format(PRODUCT_NAME), 'Contents',
+                              'MacOS', PRODUCT_NAME)
+  elif sys.platform == 'win32':
+    atom_shell = os.path.join(SOURCE_ROOT, 'out', config,
+                              '{0}.exe'.format(PROJECT_NAME))
+  else:
+    atom_shell = os.path.join(SOURCE_ROOT, 'out', config, PROJECT_NAME)
+
+  # The leak tests exit with 1 when a case leaks.
+  return subprocess.call([atom_shell, benchmark] + args)
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,112 @@
+#!/usr/bin/env python
+
+# Creates the delta that rebuilds the new app.asar from the old one, see
+# atom/common/asar/archive_delta.h for the format. Usage:
+#
+#   create-asar-delta.py old/app.asar new/app.asar app.asar.delta
+
+import hashlib
+import json
+import struct
+import sys
+
+
+MAGIC = b'ASARDIFF'
+VERSION = 1
+
+CHUNK_COPY = 0
+CHUNK_INSERT = 1
+
+
+def main():
+  if len(sys.argv) != 4:
+    print('Usage: create-asar-delta.py <base> <target> <output>')
+    return 1
+
+  base_path, target_path, output_path = sys.argv[1:]
+  with open(base_path, 'rb') as f:
+    base = f.read()
+  with open(target_path, 'rb') as f:
+    target = f.read()
+
+  chunks = diff_archives(base, target)
+  with open(output_path, 'wb') as f:
+    f.write(MAGIC)
+    f.write(struct.pack('<IQQ', VERSION, len(base), len(target)))
+    f.write(hashlib.sha256(target).digest())
+    f.write(struct.pack('<I', len(chunks)))
+    for kind, offset, size in chunks:
+      f.write(struct.pack('<BQQ', kind, offset, size))
+    for kind, offset, size in chunks:
+      if kind == CHUNK_INSERT:
+        f.write(target[offset:offset + size])
+
+  copied = sum(size for kind, _, size in chunks if kind == CHUNK_COPY)
+  print('{0} of {1} bytes are copied from the base archive'.format(
+      copied, len(target)))
+
+
+def diff_archives(base, target):
+  # The chunks as (kind, offset, size), the offset of an insert chunk is the
+  # one in |target| its bytes are taken from.
+  chunks = []
+
+  def append(kind, offset, size):
+    if size == 0:
+      return
+    if chunks:
+      last_kind, last_offset, last_size = chunks[-1]
+      contiguous = (kind == CHUNK_INSERT or
+                    last_offset + last_size == offset)
+      if last_kind == kind and contiguous:
+        chunks[-1] = (kind, last_offset, last_size + size)
+        return
+    chunks.append((kind, offset, size))
+
+  base_files = {}
+  for offset, size in read_file_ranges(base):
+    key = (size, hashlib.sha1(base[offset:offset + size]).digest())
+    base_files.setdefault(key, offset)
+
+  position = 0
+  for offset, size in sorted(read_file_ranges(target)):
+    if offset < position:
+      continue
+    key = (size, hashlib.sha1(target[offset:offset + size]).digest())
+    if key not in base_files:
+      continue
+    append(CHUNK_INSERT, position, offset - position)
+    append(CHUNK_COPY, base_files[key], size)
+    position = offset + size
+  append(CHUNK_INSERT, position, len(target) - position)
+  return chunks
+
+
+def read_file_ranges(archive):
+  # Returns the (offset, size) of the files stored in a JSON header archive.
+  # The archives with a binary header are only ever inserted as a whole.
+  if len(archive) < 16:
+    return []
+  payload_size, header_size = struct.unpack('<II', archive[:8])
+  if payload_size != 4:
+    return []
+  json_size = struct.unpack('<I', archive[12:16])[0]
+  header = json.loads(archive[16:16 + json_size].decode('utf-8'))
+  content_offset = 8 + header_size
+
+  ranges = []
+  def walk(node):
+    for entry in node.get('files', {}).values():
+      if 'files' in entry:
+        walk(entry)
+      elif 'offset' in entry and not entry.get('unpacked'):
+        size = entry['size']
+        if 'compression' in entry:
+          size = sum(entry['compression']['blocks'])
+        ranges.append((content_offset + int(entry['offset']), size))
+  walk(header)
+  return ranges
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,194 @@
+#!/usr/bin/env python
+
+import argparse
+import datetime
+import json
+import os
+import platform
+import shutil
+import subprocess
+import sys
+import time
+
+from lib.util import atom_gyp, get_atom_shell_version, rm_rf, safe_mkdir, \
+                     tempdir
+
+
+SOURCE_ROOT = os.path.abspath(os.path.dirname(os.path.dirname(__file__)))
+
+PROJECT_NAME = atom_gyp()['project_name%']
+PRODUCT_NAME = atom_gyp()['product_name%']
+
+BENCHMARK_APP = os.path.join(SOURCE_ROOT, 'spec', 'benchmark', 'startup')
+
+# The measured milestones, in milliseconds since the launch.
+MILESTONES = ['nativeModulesLoaded', 'ready', 'firstWindowLoaded',
+              'lastWindowLoaded']
+
+
+def main():
+  args = parse_args()
+  config = 'D' if args.debug else 'R'
+  out_dir = os.path.join(SOURCE_ROOT, 'out', config)
+
+  if sys.platform == 'darwin':
+    app_bundle = os.path.join(out_dir, '{0}.app'.format(PRODUCT_NAME))
+    atom_shell = os.path.join(app_bundle, 'Contents', 'MacOS', PRODUCT_NAME)
+    resources_dir = os.path.join(app_bundle, 'Contents', 'Resources')
+  elif sys.platform == 'win32':
+    atom_shell = os.path.join(out_dir, '{0}.exe'.format(PROJECT_NAME))
+    resources_dir = os.path.join(out_dir, 'resources')
+  else:
+    atom_shell = os.path.join(out_dir, PROJECT_NAME)
+    resources_dir = os.path.join(out_dir, 'resources')
+
+  for name in ['app', 'app.asar']:
+    if os.path.exists(os.path.join(resources_dir, name)):
+      print >> sys.stderr, 'Remove {0} from {1} first.'.format(name,
+                                                               resources_dir)
+      return 1
+
+  results = []
+  for layout in args.layouts:
+    for native_modules in args.native_module_counts:
+      if native_modules > 0 and not args.native_module:
+        continue
+      results.append(run_variant(args, atom_shell, resources_dir, layout,
+                                 native_modules))
+
+  report = {
+    'version': get_atom_shell_version(),
+    'platform': sys.platform,
+    'arch': platform.machine(),
+    'date': datetime.datetime.utcnow().isoformat() + 'Z',
+    'runs': args.runs,
+    'windows': args.windows,
+    'results': results,
+  }
+  output = json.dumps(report, indent=2, sort_keys=True) + '\n'
+  if args.output:
+    with open(args.output, 'w') as f:
+      f.write(output)
+  else:
+    sys.stdout.write(output)
+
+
+def parse_args():
+  parser = argparse.ArgumentParser(
+      description='Measure the startup and window creation of Electron')
+  parser.add_argument('-D', '--debug', action='store_true',
+                      help='Use the debug build')
+  parser.add_argument('--runs', type=int, default=10,
+                      help='Number of warm launches of each variant')
+  parser.add_argument('--windows', type=int, default=10,
+                      help='Number of windows opened by each launch')
+  parser.add_argument('--layouts', default='directory,asar',
+                      type=lambda value: value.split(','),
+                      help='How the app is packaged: directory, asar or both')
+  parser.add_argument('--native-module',
+                      help='Path to a built native module, which is copied '
+                           'into the app and required at startup')
+  parser.add_argument('--native-module-counts', default='0,20',
+                      type=lambda value: [int(n) for n in value.split(',')],
+                      help='Numbers of copies of --native-module to load')
+  parser.add_argument('--drop-caches', action='store_true',
+                      help='Drop the page cache before each cold launch, '
+                           'needs root on Linux')
+  parser.add_argument('--output', help='Write the results to this file')
+  return parser.parse_args()
+
+
+def run_variant(args, atom_shell, resources_dir, layout, native_modules):
+  name = '{0} {1} native modules'.format(layout, native_modules)
+  print >> sys.stderr, name
+
+  staging_dir = tempdir('electron-startup-benchmark-')
+  app_dir = os.path.join(staging_dir, 'app')
+  shutil.copytree(BENCHMARK_APP, app_dir)
+  if native_modules > 0:
+    modules_dir = os.path.join(app_dir, 'native_modules')
+    safe_mkdir(modules_dir)
+    for i in range(native_modules):
+      shutil.copy2(args.native_module,
+                   os.path.join(modules_dir, 'module{0}.node'.format(i)))
+
+  if layout == 'asar':
+    installed = os.path.join(resources_dir, 'app.asar')
+    pack_asar(app_dir, installed)
+  else:
+    installed = os.path.join(resources_dir, 'app')
+    shutil.copytree(app_dir, installed)
+
+  try:
+    # The first launch with a new profile counts as cold, with the page cache
+    # dropped too when asked.
+    user_data = os.path.join(staging_dir, 'user-data')
+    if args.drop_caches:
+      drop_caches()
+    cold = launch(args, atom_shell, user_data, staging_dir)
+    warm = [launch(args, atom_shell, user_data, staging_dir)
+            for i in range(args.runs)]
+  finally:
+    rm_rf(installed)
+    rm_rf(installed + '.unpacked')
+
+  return {
+    'name': name,
+    'layout': layout,
+    'nativeModules': native_modules,
+    'cold': cold,
+    'warm': summarize(warm),
+  }
+
+
+def pack_asar(app_dir, archive):
+  asar = os.path.join(SOURCE_ROOT, 'node_modules', '.bin', 'asar')
+  if sys.platform in ['win32', 'cygwin']:
+    asar += '.cmd'
+  # Native modules can not be loaded from inside archives.
+  subprocess.check_call([asar, 'pack', app_dir, archive,
+                         '--unpack', '*.node'])
+
+
+def drop_caches():
+  if sys.platform == 'linux2':
+    subprocess.check_call(['sync'])
+    with open('/proc/sys/vm/drop_caches', 'w') as f:
+      f.write('3\n')
+  elif sys.platform == 'darwin':
+    subprocess.check_call(['purge'])
+  else:
+    print >> sys.stderr, 'Dropping the page cache is not supported.'
+
+
+def launch(args, atom_shell, user_data, staging_dir):
+  output = os.path.join(staging_dir, 'result.json')
+  rm_rf(output)
+  launch_time = int(time.time() * 1000)
+  subprocess.check_call([atom_shell,
+                         '--bench-launch-time={0}'.format(launch_time),
+                         '--bench-windows={0}'.format(args.windows),
+                         '--bench-user-data={0}'.format(user_data),
+                         '--bench-output={0}'.format(output)])
+  with open(output) as f:
+    return json.load(f)
+
+
+# Reduces the results of warm launches to the statistics of each metric.
+def summarize(runs):
+  summary = {}
+  if not runs:
+    return summary
+  for metric in MILESTONES + ['peakWorkingSetSize']:
+    samples = sorted(run[metric] for run in runs)
+    summary[metric] = {
+      'mean': float(sum(samples)) / len(samples),
+      'median': samples[len(samples) / 2],
+      'min': samples[0],
+      'max': samples[-1],
+    }
+  return summary
+
+
+if __name__ == '__main__':
+  sys.exit(main())
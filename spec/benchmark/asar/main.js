@@ -0,0 +1,4 @@
+var path = require('path');
+var runner = require('../runner');
+
+runner.run(path.join(__dirname, 'asar-benchmark.coffee'));
@@ -0,0 +1,8 @@
+var app = require('app');
+var path = require('path');
+var runner = require('../runner');
+
+// The benchmark closes its windows between the sizes.
+app.on('window-all-closed', function() {});
+
+runner.run(path.join(__dirname, 'capture-benchmark.coffee'));
@@ -0,0 +1,4 @@
+// Used by the remote module benchmark.
+exports.echo = function(value) {
+  return value;
+};
@@ -0,0 +1,36 @@
+var ipc = require('ipc');
+var runner = require('../runner');
+
+// Round trip of ipc.send and webContents.send.
+ipc.on('bench-echo', function(event, payload) {
+  event.sender.send('bench-echo', payload);
+});
+
+// Renderer to browser throughput, the flush message is received after all the
+// messages sent before it.
+var received = 0;
+ipc.on('bench-sink', function(event, payload) {
+  received++;
+});
+ipc.on('bench-sink-flush', function(event) {
+  event.sender.send('bench-sink-done', received);
+  received = 0;
+});
+
+ipc.on('bench-echo-sync', function(event, payload) {
+  event.returnValue = true;
+});
+
+// Browser to renderer throughput, the payload is only built once.
+var pushPayload = null;
+ipc.on('bench-push-payload', function(event, payload) {
+  pushPayload = payload;
+  event.returnValue = true;
+});
+ipc.on('bench-push', function(event, count) {
+  for (var i = 0; i < count; ++i)
+    event.sender.send('bench-push', pushPayload);
+  event.sender.send('bench-push-done', count);
+});
+
+runner.runInPage('Electron Benchmark', 'file://' + __dirname + '/index.html');
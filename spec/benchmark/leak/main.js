@@ -0,0 +1,17 @@
+var app = require('app');
+var path = require('path');
+var runner = require('../runner');
+
+// The cases collect the garbage before they measure the heap, the main
+// process has parsed its flags already so gc is taken from a new context.
+app.commandLine.appendSwitch('js-flags', '--expose_gc');
+require('v8').setFlagsFromString('--expose_gc');
+global.gc = require('vm').runInNewContext('gc');
+
+// The cases create and close windows on their own.
+app.on('window-all-closed', function() {});
+
+// Exits with 1 when a case leaks.
+runner.run(path.join(__dirname, 'leak-cases.coffee'), function(report) {
+  process.exit(report.leaks.length > 0 ? 1 : 0);
+});
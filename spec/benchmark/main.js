@@ -0,0 +1,5 @@
+// The suites share this app, --suite=name runs the one in the directory of
+// that name, the ipc benchmarks by default.
+var runner = require('./runner');
+
+require('./' + (runner.options.suite || 'ipc') + '/main.js');
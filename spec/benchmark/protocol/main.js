@@ -0,0 +1,8 @@
+var app = require('app');
+var path = require('path');
+var runner = require('../runner');
+
+// The window is only closed when the benchmark is done.
+app.on('window-all-closed', function() {});
+
+runner.run(path.join(__dirname, 'protocol-benchmark.coffee'));
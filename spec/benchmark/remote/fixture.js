@@ -0,0 +1,19 @@
+// The module the remote benchmark uses through remote.require.
+var nextId = 0;
+
+exports.counter = {value: 0};
+
+exports.echo = function(value) {
+  return value;
+};
+
+// Each call returns a new object, which the renderer has to release.
+exports.createObject = function() {
+  return {id: nextId++, method: function() {}};
+};
+
+// Calls the callback of the renderer |count| times.
+exports.callBack = function(count, callback) {
+  for (var i = 0; i < count; ++i)
+    callback(i);
+};
@@ -0,0 +1,20 @@
+var ipc = require('ipc');
+var runner = require('../runner');
+
+// Measures the Emit of WebContents, the sync messages are emitted on it as
+// "ipc-message-sync".
+ipc.on('bench-emit-sync', function(event) {
+  event.returnValue = null;
+});
+
+// The renderer's results are completed by the cases of the main process.
+runner.runInPage('Electron remote Benchmark',
+                 'file://' + __dirname + '/index.html',
+                 function(results, window) {
+  require('coffee-script/register');
+  var emit = require('./emit-benchmark.coffee');
+  emit.run(runner.options, window).then(function(emitResults) {
+    results.results = results.results.concat(emitResults);
+    runner.finish(results);
+  }).catch(runner.fail);
+});
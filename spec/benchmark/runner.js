@@ -0,0 +1,92 @@
+// The main process side that the suites share: the options of the command
+// line, and writing the results.
+var app = require('app');
+var fs = require('fs');
+var ipc = require('ipc');
+var BrowserWindow = require('browser-window');
+
+// Parse "--name=value" and "--name" switches.
+var options = {};
+process.argv.slice(2).forEach(function(arg) {
+  var match = /^--([^=]+)(?:=(.*))?$/.exec(arg);
+  if (match)
+    options[match[1]] = match[2] === undefined ? true : match[2];
+});
+exports.options = options;
+
+// Writes |results| as JSON to the file of --output, or to stdout.
+var writeResults = exports.writeResults = function(results) {
+  var json = JSON.stringify(results, null, 2) + '\n';
+  if (typeof options.output === 'string')
+    fs.writeFileSync(options.output, json);
+  else
+    process.stdout.write(json);
+};
+
+var fail = exports.fail = function(error) {
+  console.error(error.stack || String(error));
+  process.exit(1);
+};
+
+var finish = function(results) {
+  writeResults(results);
+  app.quit();
+};
+
+// Runs the suite in |modulePath| in the main process when the app is ready.
+// Its run(options) returns a Promise of the results, which are written before
+// |done| is called with them. By default the app quits.
+exports.run = function(modulePath, done) {
+  app.on('ready', function() {
+    require('coffee-script/register');
+    require(modulePath).run(options).then(function(results) {
+      writeResults(results);
+      (done || app.quit.bind(app))(results);
+    }).catch(fail);
+  });
+};
+
+// Runs the suite of the page at |url| in a hidden window. The page gets the
+// options with the sync "bench-options" message, reports the cases with
+// "bench-progress" and its failure with "bench-error", and sends its results
+// with the sync "bench-results" message. |done| is called with the results
+// and the window, by default the results are written and the app quits.
+exports.runInPage = function(title, url, done) {
+  var window = null;
+
+  app.commandLine.appendSwitch('js-flags', '--expose_gc');
+
+  ipc.on('bench-options', function(event) {
+    event.returnValue = options;
+  });
+
+  ipc.on('bench-progress', function(event, name) {
+    if (!options.quiet)
+      console.error(name);
+  });
+
+  ipc.on('bench-error', function(event, message) {
+    fail(message);
+  });
+
+  ipc.on('bench-results', function(event, results) {
+    event.returnValue = true;
+    (done || finish)(results, window);
+  });
+
+  app.on('window-all-closed', function() {
+    app.quit();
+  });
+
+  app.on('ready', function() {
+    window = new BrowserWindow({
+      title: title,
+      show: false,
+      width: 800,
+      height: 600,
+    });
+    window.loadUrl(url);
+  });
+};
+
+exports.finish = finish;
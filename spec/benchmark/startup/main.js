@@ -0,0 +1,92 @@
+// Launched by script/startup-benchmark.py, which installs this app into the
+// resources of the build so it starts like a packaged app.
+var app = require('app');
+var fs = require('fs');
+var path = require('path');
+var BrowserWindow = require('browser-window');
+
+// Parse "--bench-name=value" switches.
+var options = {};
+process.argv.forEach(function(arg) {
+  var match = /^--bench-([^=]+)=(.*)$/.exec(arg);
+  if (match)
+    options[match[1]] = match[2];
+});
+
+var launchTime = Number(options['launch-time']);
+var windowCount = Number(options.windows || 10);
+var marks = {};
+var peakMemory = 0;
+var windows = [];
+
+if (options['user-data'])
+  app.setPath('userData', options['user-data']);
+
+var mark = function(name) {
+  marks[name] = Date.now() - launchTime;
+};
+
+// Sums the working sets of all processes, in kilobytes.
+var sampleMemory = function(callback) {
+  app.getAppMetrics(function(metrics) {
+    var total = 0;
+    metrics.forEach(function(process) {
+      total += process.memory.workingSetSize;
+    });
+    peakMemory = Math.max(peakMemory, total);
+    callback();
+  });
+};
+
+// Requires every native module the benchmark copied into the app.
+var nativeModules = 0;
+var nativeModulesDir = path.join(__dirname, 'native_modules');
+if (fs.existsSync(nativeModulesDir)) {
+  fs.readdirSync(nativeModulesDir).forEach(function(name) {
+    if (path.extname(name) === '.node') {
+      require(path.join(nativeModulesDir, name));
+      nativeModules++;
+    }
+  });
+}
+mark('nativeModulesLoaded');
+
+var finish = function() {
+  var results = {
+    nativeModulesLoaded: marks.nativeModulesLoaded,
+    ready: marks.ready,
+    firstWindowLoaded: marks.firstWindowLoaded,
+    lastWindowLoaded: marks.lastWindowLoaded,
+    windows: windowCount,
+    nativeModules: nativeModules,
+    peakWorkingSetSize: peakMemory,
+    startupTimeline: app.getStartupTimeline(),
+  };
+  fs.writeFileSync(options.output, JSON.stringify(results));
+  app.quit();
+};
+
+var openWindow = function() {
+  var window = new BrowserWindow({show: false, width: 800, height: 600});
+  windows.push(window);
+  window.webContents.once('did-finish-load', function() {
+    if (windows.length === 1)
+      mark('firstWindowLoaded');
+    sampleMemory(function() {
+      if (windows.length < windowCount)
+        return openWindow();
+      mark('lastWindowLoaded');
+      finish();
+    });
+  });
+  window.loadUrl('file://' + __dirname + '/index.html');
+};
+
+app.on('window-all-closed', function() {
+  app.quit();
+});
+
+app.on('ready', function() {
+  mark('ready');
+  openWindow();
+});
@@ -0,0 +1,6 @@
+// Applies an archive delta in the main process, where the binding lives.
+var autoUpdater = process.atomBinding('auto_updater').autoUpdater;
+
+exports.apply = function(base, delta, output, callback) {
+  autoUpdater._applyAppDelta(base, delta, output, callback);
+};
@@ -0,0 +1,5 @@
+// Keeps the main process busy for |ms| milliseconds.
+exports.block = function(ms) {
+  var end = Date.now() + ms;
+  while (Date.now() < end);
+};
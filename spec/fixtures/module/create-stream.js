@@ -0,0 +1,10 @@
+var stream = require('stream');
+
+// Creates a stream in the browser that pushes |chunks| one by one.
+exports.create = function(chunks) {
+  var readable = new stream.Readable();
+  readable._read = function() {
+    this.push(chunks.length ? new Buffer(chunks.shift()) : null);
+  };
+  return readable;
+};
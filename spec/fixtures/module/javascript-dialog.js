@@ -0,0 +1,25 @@
+// The dialog listeners run in the main process, because calling
+// event.preventDefault() through remote would be too late.
+exports.answerPrompt = function(webContents, text) {
+  webContents.once('javascript-dialog', function(event, type, message, defaultPromptText, url, callback) {
+    event.preventDefault();
+    setTimeout(function() {
+      callback(type == 'prompt' && defaultPromptText == 'nobody', text);
+    }, 0);
+  });
+};
+
+exports.ignoreDialog = function(webContents) {
+  webContents.once('javascript-dialog', function(event) {
+    event.preventDefault();
+  });
+};
+
+exports.allowUnload = function(webContents) {
+  webContents.once('before-unload-dialog', function(event, message, isReload, callback) {
+    event.preventDefault();
+    setTimeout(function() {
+      callback(true);
+    }, 0);
+  });
+};
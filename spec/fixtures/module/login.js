@@ -0,0 +1,21 @@
+// The login listener runs in the main process, because calling
+// event.preventDefault() through remote would be too late.
+var app = require('app');
+
+var listener = null;
+
+exports.answer = function(username, password, onLogin) {
+  exports.stop();
+  listener = function(event, webContents, request, authInfo, callback) {
+    event.preventDefault();
+    onLogin(authInfo.realm);
+    callback(username, password);
+  };
+  app.on('login', listener);
+};
+
+exports.stop = function() {
+  if (listener)
+    app.removeListener('login', listener);
+  listener = null;
+};
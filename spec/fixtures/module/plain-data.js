@@ -0,0 +1,35 @@
+var config = {
+  name: 'config',
+  nested: {list: [1, 'two', {three: 3}], empty: {}},
+  flag: true,
+  nothing: null
+};
+
+function Counter() {
+  this.count = 1;
+}
+
+exports.getConfig = function() {
+  return config;
+};
+
+exports.readConfigName = function() {
+  return config.name;
+};
+
+exports.getCounter = function() {
+  return new Counter;
+};
+
+exports.getWithGetter = function() {
+  return Object.defineProperty({}, 'value', {
+    enumerable: true,
+    get: function() { return 1; }
+  });
+};
+
+exports.getCycle = function() {
+  var cycle = {};
+  cycle.self = cycle;
+  return cycle;
+};
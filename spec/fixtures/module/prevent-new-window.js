@@ -0,0 +1,7 @@
+// Prevents the next window opened by |webContents|, which has to be done in
+// the main process since remote listeners are called asynchronously.
+exports.preventNext = function(webContents) {
+  webContents.once('new-window', function(event) {
+    event.preventDefault();
+  });
+};
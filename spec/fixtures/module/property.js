@@ -1 +1,5 @@
 exports.property = 1127
+
+exports.getProperty = function() {
+  return exports.property;
+}
@@ -0,0 +1,15 @@
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+
+Point.prototype.sum = function() {
+  return this.x + this.y;
+};
+
+exports.create = function(x, y, extra) {
+  var point = new Point(x, y);
+  if (extra)
+    point.extra = extra;
+  return point;
+};
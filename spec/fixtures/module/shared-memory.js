@@ -0,0 +1,14 @@
+// Accesses the Buffer of a region in the main process, the remote module
+// would copy it.
+exports.fill = function(region, value) {
+  region.buffer.fill(value);
+};
+
+exports.read = function(region, index) {
+  return region.buffer[index];
+};
+
+// Rings in one tick of the main process.
+exports.ring = function(region, values) {
+  values.forEach(function(value) { region.ring(value); });
+};
@@ -0,0 +1,13 @@
+var EventEmitter = require('events').EventEmitter;
+
+var counter = new EventEmitter;
+counter.value = 0;
+counter.getValue = function() {
+  return this.value;
+};
+counter.increase = function() {
+  this.value++;
+  this.emit('changed');
+};
+
+module.exports = counter;
@@ -0,0 +1,35 @@
+// The module of the utility processes started by the specs.
+var port = process.parentPort;
+
+port.handle('echo', function() {
+  return Array.prototype.slice.call(arguments);
+});
+
+port.handle('pid', function(delay) {
+  return new Promise(function(resolve) {
+    setTimeout(function() { resolve(process.pid); }, delay);
+  });
+});
+
+port.handle('fail', function(message) {
+  throw new Error(message);
+});
+
+port.handle('hang', function() {
+  return new Promise(function() {});
+});
+
+port.on('message', function(channel) {
+  var args = Array.prototype.slice.call(arguments, 1);
+  port.send.apply(port, ['re-' + channel].concat(args));
+});
+
+port.handle('set-env', function(name, value) {
+  process.env[name] = value;
+  return process.env[name];
+});
+
+port.handle('chdir', function(directory) {
+  process.chdir(directory);
+  return process.cwd();
+});
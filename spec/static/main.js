@@ -39,6 +39,20 @@ ipc.on('echo', function(event, msg) {
   event.returnValue = msg;
 });
 
+ipc.handle('echo', function(event, msg) {
+  return msg;
+});
+
+ipc.handle('echo-later', function(event, msg, delay) {
+  return new Promise(function(resolve) {
+    setTimeout(function() { resolve(msg); }, delay);
+  });
+});
+
+ipc.handle('throw', function(event, message) {
+  throw new Error(message);
+});
+
 if (process.argv[2] == '--ci') {
   process.removeAllListeners('uncaughtException');
   process.on('uncaughtException', function(error) {
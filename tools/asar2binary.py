@@ -0,0 +1,315 @@
+#!/usr/bin/env python
+
+"""Converts an asar archive with JSON header to the binary header format.
+
+The binary header (version 2) is described in atom/common/asar/binary_header.h.
+The file contents are copied unchanged, unless --compress is passed, in which
+case files are stored as independently deflated blocks so they can be read
+randomly.
+
+With --integrity, or when the input archive already has integrity in its
+header, the SHA-256 digests of the bytes stored for each file and of each of
+their blocks are written too, so tampered files are rejected when read.
+"""
+
+import hashlib
+import json
+import optparse
+import os
+import struct
+import sys
+import zlib
+
+
+JSON_HEADER_PAYLOAD_SIZE = 4
+BINARY_HEADER_PAYLOAD_SIZE = 8
+BINARY_HEADER_VERSION = 2
+BINARY_HEADER_MAGIC = 0x32525341  # "ASR2"
+INTEGRITY_MAGIC = 0x49525341  # "ASRI"
+
+FLAG_DIRECTORY = 1 << 0
+FLAG_LINK = 1 << 1
+FLAG_UNPACKED = 1 << 2
+FLAG_RESOLVED = 1 << 3
+
+FLAG_COMPRESSED = 1 << 4
+
+MAX_LINK_DEPTH = 32
+
+BLOCK_SIZE = 64 * 1024
+INTEGRITY_BLOCK_SIZE = 1024 * 1024
+# Files smaller than this, or in formats that are already compressed, are not
+# worth the cost of inflating.
+MIN_COMPRESS_SIZE = 4 * 1024
+COMPRESSED_EXTENSIONS = [
+  '.gif', '.gz', '.jpeg', '.jpg', '.mp3', '.mp4', '.ogg', '.png', '.webm',
+  '.webp', '.woff', '.woff2', '.zip',
+]
+
+
+def main():
+  parser = optparse.OptionParser(
+      usage='usage: %prog [--compress] input.asar [output.asar]')
+  parser.add_option('--compress', action='store_true', default=False,
+                    help='store files as deflated blocks')
+  parser.add_option('--integrity', action='store_true', default=False,
+                    help='store SHA-256 digests of files and their blocks')
+  options, args = parser.parse_args()
+  if len(args) not in [1, 2]:
+    parser.print_usage()
+    return 1
+
+  source = args[0]
+  dest = args[1] if len(args) == 2 else source
+  root, data = read_archive(source)
+  integrity = options.integrity or has_integrity(root)
+  header, data = build_header(root, data, options.compress, integrity)
+  write_archive(dest, header, data)
+
+
+def read_archive(path):
+  with open(path, 'rb') as f:
+    content = f.read()
+
+  payload_size, size = struct.unpack('<II', content[:8])
+  if payload_size == BINARY_HEADER_PAYLOAD_SIZE:
+    raise Exception('{0} already has binary header'.format(path))
+  if payload_size != JSON_HEADER_PAYLOAD_SIZE:
+    raise Exception('{0} is not an asar archive'.format(path))
+
+  length = struct.unpack('<I', content[12:16])[0]
+  header = json.loads(content[16:16 + length].decode('utf-8'))
+  return header, content[8 + size:]
+
+
+def has_integrity(node):
+  if 'integrity' in node:
+    return True
+  return any(has_integrity(child) for child in node.get('files', {}).values())
+
+
+def build_header(root, data, compress, integrity):
+  entries = {'': {'flags': FLAG_DIRECTORY, 'size': 0, 'offset': 0,
+                  'link': '', 'children': [], 'blocks': None,
+                  'integrity': None}}
+  flatten(entries, '', root)
+
+  keys = sorted(entries.keys(), key=lambda k: k.encode('utf-8'))
+  index = dict((key, i) for i, key in enumerate(keys))
+
+  for key in keys:
+    resolve_link(entries, key, 0)
+
+  if compress:
+    data = compress_files(entries, keys, data)
+  if integrity:
+    hash_files(entries, keys, data)
+
+  # Give directories their ranges in the children table.
+  children = []
+  for key in keys:
+    entry = entries[key]
+    if entry['flags'] & FLAG_DIRECTORY and not entry['flags'] & FLAG_LINK:
+      entry['offset'] = len(children)
+      entry['size'] = len(entry['children'])
+      children += [index[child] for child in entry['children']]
+  for key in keys:
+    entry = entries[key]
+    if entry['flags'] & FLAG_LINK and entry['flags'] & FLAG_RESOLVED:
+      target = entries[entry['link']]
+      if target['flags'] & FLAG_COMPRESSED:
+        # The record has room for either the realpath or the block table, so
+        # a link to a compressed file keeps its realpath and the reader takes
+        # the blocks from the target's record.
+        entry['flags'] = FLAG_LINK
+        entry['size'] = target['size']
+        entry['offset'] = 0
+        entry['blocks'] = None
+        entry['integrity'] = None
+        continue
+      entry['size'] = target['size']
+      entry['offset'] = target['offset']
+      entry['blocks'] = target['blocks']
+      entry['integrity'] = target['integrity']
+
+  strings = bytearray()
+  records = bytearray()
+  integrity_table = []
+  for key in keys:
+    entry = entries[key]
+    path = add_string(strings, key)
+    if entry['integrity']:
+      integrity_table.append(add_raw(strings, entry['integrity']))
+    else:
+      integrity_table.append((0, 0))
+    if entry['flags'] & FLAG_COMPRESSED:
+      link = add_blocks(strings, entry['blocks'])
+    else:
+      link = add_string(strings, entry['link'])
+    records += struct.pack('<IIIIQII', path[0], path[1], entry['flags'],
+                           entry['size'], entry['offset'], link[0], link[1])
+
+  block = bytearray(struct.pack('<IIII', BINARY_HEADER_MAGIC, len(keys),
+                                len(children), len(strings)))
+  block += records
+  block += struct.pack('<{0}I'.format(len(children)), *children)
+  block += strings
+  while len(block) % 4:
+    block.append(0)
+
+  # The integrity table follows the aligned strings.
+  if integrity:
+    block += struct.pack('<II', INTEGRITY_MAGIC, len(keys))
+    for offset, length in integrity_table:
+      block += struct.pack('<II', offset, length)
+  return bytes(block), data
+
+
+def compress_files(entries, keys, data):
+  output = bytearray()
+  for key in keys:
+    entry = entries[key]
+    if entry['flags'] != 0:
+      continue
+    content = data[entry['offset']:entry['offset'] + entry['size']]
+    entry['offset'] = len(output)
+
+    blocks = []
+    if should_compress(key, entry['size']):
+      blocks = [zlib.compress(content[i:i + BLOCK_SIZE], 9)
+                for i in range(0, len(content), BLOCK_SIZE)]
+    if blocks and sum(len(b) for b in blocks) < len(content) * 0.9:
+      entry['flags'] = FLAG_COMPRESSED
+      entry['blocks'] = [len(b) for b in blocks]
+      for b in blocks:
+        output += b
+    else:
+      output += content
+  return bytes(output)
+
+
+def hash_files(entries, keys, data):
+  for key in keys:
+    entry = entries[key]
+    if entry['flags'] & ~FLAG_COMPRESSED:
+      continue
+    stored_size = sum(entry['blocks']) if entry['blocks'] else entry['size']
+    content = data[entry['offset']:entry['offset'] + stored_size]
+    integrity = bytearray(struct.pack('<I', INTEGRITY_BLOCK_SIZE))
+    integrity += hashlib.sha256(content).digest()
+    for i in range(0, len(content), INTEGRITY_BLOCK_SIZE):
+      integrity += hashlib.sha256(content[i:i + INTEGRITY_BLOCK_SIZE]).digest()
+    entry['integrity'] = bytes(integrity)
+
+
+def should_compress(key, size):
+  extension = os.path.splitext(key)[1].lower()
+  return size >= MIN_COMPRESS_SIZE and extension not in COMPRESSED_EXTENSIONS
+
+
+def flatten(entries, prefix, node):
+  for name in sorted(node['files'].keys(), key=lambda k: k.encode('utf-8')):
+    child = node['files'][name]
+    key = name if prefix == '' else prefix + '/' + name
+    entry = {'flags': 0, 'size': 0, 'offset': 0, 'link': '', 'children': [],
+             'blocks': None, 'integrity': None}
+    if 'link' in child:
+      entry['flags'] = FLAG_LINK
+      entry['link'] = child['link'].replace('\\', '/').rstrip('/')
+    elif 'files' in child:
+      entry['flags'] = FLAG_DIRECTORY
+    elif 'size' in child:
+      entry['size'] = child['size']
+      if child.get('unpacked', False):
+        entry['flags'] = FLAG_UNPACKED
+      else:
+        entry['offset'] = int(child['offset'])
+    else:
+      continue
+    entries[key] = entry
+    entries[prefix]['children'].append(key)
+    if entry['flags'] == FLAG_DIRECTORY:
+      flatten(entries, key, child)
+
+
+def find_entry(entries, key):
+  for _ in range(MAX_LINK_DEPTH + 1):
+    if key in entries:
+      return key
+    # Replace the first linked directory in path with its target.
+    parts = key.split('/')
+    replaced = False
+    for i in range(1, len(parts)):
+      parent = '/'.join(parts[:i])
+      if parent not in entries:
+        return None
+      entry = entries[parent]
+      if entry['flags'] & FLAG_LINK:
+        rest = '/'.join(parts[i:])
+        key = rest if entry['link'] == '' else entry['link'] + '/' + rest
+        replaced = True
+        break
+      if not entry['flags'] & FLAG_DIRECTORY:
+        return None
+    if not replaced:
+      return None
+  return None
+
+
+def resolve_link(entries, key, depth):
+  entry = entries[key]
+  if not entry['flags'] & FLAG_LINK or entry['flags'] & FLAG_RESOLVED:
+    return True
+  if depth > MAX_LINK_DEPTH:
+    return False
+
+  target = find_entry(entries, entry['link'])
+  if target is None:
+    return False
+  if entries[target]['flags'] & FLAG_LINK:
+    if not resolve_link(entries, target, depth + 1):
+      return False
+    target = entries[target]['link']
+
+  target_entry = entries[target]
+  entry['link'] = target
+  entry['size'] = target_entry['size']
+  entry['offset'] = target_entry['offset']
+  entry['blocks'] = target_entry['blocks']
+  entry['integrity'] = target_entry['integrity']
+  entry['flags'] = (FLAG_LINK | FLAG_RESOLVED |
+                    target_entry['flags'] & (FLAG_DIRECTORY | FLAG_UNPACKED |
+                                             FLAG_COMPRESSED))
+  return True
+
+
+def add_string(strings, value):
+  encoded = value.encode('utf-8')
+  offset = len(strings)
+  strings += encoded
+  return offset, len(encoded)
+
+
+def add_raw(strings, value):
+  offset = len(strings)
+  strings += value
+  return offset, len(value)
+
+
+def add_blocks(strings, blocks):
+  table = struct.pack('<{0}I'.format(len(blocks) + 1), BLOCK_SIZE, *blocks)
+  offset = len(strings)
+  strings += table
+  return offset, len(table)
+
+
+def write_archive(path, header, data):
+  with open(path, 'wb') as f:
+    f.write(struct.pack('<III', BINARY_HEADER_PAYLOAD_SIZE, len(header),
+                        BINARY_HEADER_VERSION))
+    f.write(header)
+    f.write(data)
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -1,5 +1,6 @@
 #!/usr/bin/env python
 
+import json
 import os
 import shutil
 import subprocess
@@ -9,6 +10,48 @@ import tempfile
 
 SOURCE_ROOT = os.path.dirname(os.path.dirname(__file__))
 
+# The scripts of each process type that are bundled into its init.js.
+BUNDLED_DIRS = {
+  'browser': ['common', 'browser'],
+  'renderer': ['common', 'renderer'],
+}
+
+# Put in front of init.js, it makes the module loader take the bundled modules
+# from |bundled| instead of reading them from the archive.
+BUNDLE_PRELUDE = """\
+// Generated by tools/coffee2asar.py.
+(function() {
+  var path = require('path');
+  var Module = require('module');
+  var root = path.resolve(__dirname, '..', '..');
+  var bundled = {
+%s
+  };
+  var jsExtension = Module._extensions['.js'];
+  Module._extensions['.js'] = function(module, filename) {
+    var relative = path.relative(root, filename).split(path.sep).join('/');
+    if (!bundled.hasOwnProperty(relative))
+      return jsExtension(module, filename);
+
+    // Same with what Module.prototype._compile passes to the module.
+    var require = function(request) { return module.require(request); };
+    require.resolve = function(request) {
+      return Module._resolveFilename(request, module);
+    };
+    require.main = process.mainModule;
+    require.extensions = Module._extensions;
+    require.cache = Module._cache;
+    bundled[relative].call(module.exports, module.exports, require, module,
+                           filename, path.dirname(filename));
+  };
+})();
+"""
+
+BUNDLED_MODULE = """\
+    %s: function (exports, require, module, __filename, __dirname) {
+%s
+    },"""
+
 
 def main():
   archive = sys.argv[1]
@@ -16,7 +59,9 @@ def main():
 
   output_dir = tempfile.mkdtemp()
   compile_coffee(coffee_source_files, output_dir)
+  bundle_init_scripts(os.path.join(output_dir, 'atom'))
   call_asar(archive, output_dir)
+  call_asar2binary(archive)
   shutil.rmtree(output_dir)
 
 
@@ -33,12 +78,44 @@ def call_compile_coffee(source_file, output_filename):
                          output_filename])
 
 
+def bundle_init_scripts(js_dir):
+  # The modules stay in the archive, so they are still found by the module
+  # loader and can be loaded by their paths.
+  for process_type, dirs in BUNDLED_DIRS.items():
+    init = os.path.join(js_dir, process_type, 'lib', 'init.js')
+    modules = []
+    for script in sorted(list_scripts(js_dir, dirs)):
+      if script == init:
+        continue
+      name = os.path.relpath(script, js_dir).replace(os.sep, '/')
+      with open(script) as f:
+        modules.append(BUNDLED_MODULE % (json.dumps(name), f.read()))
+    with open(init) as f:
+      init_source = f.read()
+    with open(init, 'w') as f:
+      f.write(BUNDLE_PRELUDE % '\n'.join(modules))
+      f.write(init_source)
+
+
+def list_scripts(js_dir, dirs):
+  for directory in dirs:
+    for root, _, files in os.walk(os.path.join(js_dir, directory)):
+      for name in files:
+        if name.endswith('.js'):
+          yield os.path.join(root, name)
+
+
 def call_asar(archive, output_dir):
   js_dir = os.path.join(output_dir, 'atom')
   asar = os.path.join(SOURCE_ROOT, 'node_modules', 'asar', 'bin', 'asar')
   subprocess.check_call([find_node(), asar, 'pack', js_dir, archive])
 
 
+def call_asar2binary(archive):
+  asar2binary = os.path.join(SOURCE_ROOT, 'tools', 'asar2binary.py')
+  subprocess.check_call([sys.executable, asar2binary, archive])
+
+
 def find_node():
   WINDOWS_NODE_PATHs = [
     'C:/Program Files (x86)/nodejs',
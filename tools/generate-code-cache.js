@@ -0,0 +1,33 @@
+// Writes the V8 code cache of every JavaScript file under a directory into
+// its ".code-cache" subdirectory, this script must be run by Electron in node
+// mode so the caches match the V8 that is going to consume them.
+var fs = require('fs');
+var path = require('path');
+var Module = require('module');
+
+var asar = process.binding('atom_common_asar');
+
+function listScripts(dir) {
+  var scripts = [];
+  fs.readdirSync(dir).forEach(function(name) {
+    var file = path.join(dir, name);
+    if (fs.statSync(file).isDirectory())
+      scripts = scripts.concat(listScripts(file));
+    else if (path.extname(name) === '.js')
+      scripts.push(file);
+  });
+  return scripts;
+}
+
+var root = process.argv[2];
+var cacheDir = path.join(root, '.code-cache');
+if (!fs.existsSync(cacheDir))
+  fs.mkdirSync(cacheDir);
+
+listScripts(root).forEach(function(file) {
+  // Wrap the script the same way the module loader does.
+  var content = fs.readFileSync(file, 'utf8').replace(/^\#\!.*/, '');
+  var cache = asar.createCodeCache(Module.wrap(content), file);
+  if (cache)
+    fs.writeFileSync(path.join(cacheDir, cache.key), cache.data);
+});
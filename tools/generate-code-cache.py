@@ -0,0 +1,42 @@
+#!/usr/bin/env python
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+from coffee2asar import bundle_init_scripts, call_asar, call_asar2binary, \
+                        compile_coffee
+
+
+SOURCE_ROOT = os.path.dirname(os.path.dirname(__file__))
+
+
+def main():
+  electron = sys.argv[1]
+  archive = sys.argv[2]
+  stamp = sys.argv[3]
+  coffee_source_files = sys.argv[4:]
+
+  output_dir = tempfile.mkdtemp()
+  compile_coffee(coffee_source_files, output_dir)
+  bundle_init_scripts(os.path.join(output_dir, 'atom'))
+  call_generate_code_cache(electron, os.path.join(output_dir, 'atom'))
+  call_asar(archive, output_dir)
+  call_asar2binary(archive)
+  shutil.rmtree(output_dir)
+
+  with open(stamp, 'w'):
+    pass
+
+
+def call_generate_code_cache(electron, js_dir):
+  script = os.path.join(SOURCE_ROOT, 'tools', 'generate-code-cache.js')
+  env = os.environ.copy()
+  env['ATOM_SHELL_INTERNAL_RUN_AS_NODE'] = '1'
+  subprocess.check_call([electron, script, js_dir], env=env)
+
+
+if __name__ == '__main__':
+  sys.exit(main())